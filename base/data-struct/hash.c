@@ -208,6 +208,39 @@ void dm_hash_destroy(struct dm_hash_table *t)
 	free(t);
 }
 
+/*
+ * Tables start at the size hint and grow 4x once they hold more entries
+ * than slots, so callers passing a small hint still get short chains.
+ * Nodes keep their full hash, so moving them does not rehash keys, and
+ * each chain is appended in order so entries with the same key (from
+ * dm_hash_insert_allow_multiple) keep their relative order.
+ * If the bigger slot array cannot be allocated the table stays as is.
+ */
+static void _grow_slots(struct dm_hash_table *t)
+{
+	unsigned i, new_mask = ((t->mask_slots + 1) << 2) - 1;
+	struct dm_hash_node **slots, **p, *c, *n;
+
+	if (new_mask < t->mask_slots)
+		return; /* overflow */
+
+	if (!(slots = zalloc(sizeof(*slots) * (new_mask + 1))))
+		return;
+
+	for (i = 0; i <= t->mask_slots; i++)
+		for (c = t->slots[i]; c; c = n) {
+			n = c->next;
+			c->next = NULL;
+			for (p = &slots[c->hash & new_mask]; *p; p = &((*p)->next))
+				;
+			*p = c;
+		}
+
+	free(t->slots);
+	t->slots = slots;
+	t->mask_slots = new_mask;
+}
+
 static struct dm_hash_node **_findh(struct dm_hash_table *t, const void *key,
 				    uint32_t len, unsigned hash)
 {
@@ -260,7 +293,8 @@ int dm_hash_insert_binary(struct dm_hash_table *t, const void *key,
 		n->hash = hash;
 		n->next = 0;
 		*c = n;
-		t->num_nodes++;
+		if (++t->num_nodes > t->mask_slots + 1)
+			_grow_slots(t);
 	}
 
 	return 1;
@@ -331,8 +365,9 @@ int dm_hash_insert_allow_multiple(struct dm_hash_table *t, const char *key,
 
 	n->data = (void *)val;
 	n->data_len = val_len;
+	n->hash = _hash(key, len);
 
-	h = _hash(key, len) & t->mask_slots;
+	h = n->hash & t->mask_slots;
 
 	first = t->slots[h];
 
@@ -342,7 +377,9 @@ int dm_hash_insert_allow_multiple(struct dm_hash_table *t, const char *key,
 		n->next = 0;
 	t->slots[h] = n;
 
-	t->num_nodes++;
+	if (++t->num_nodes > t->mask_slots + 1)
+		_grow_slots(t);
+
 	return 1;
 }
 
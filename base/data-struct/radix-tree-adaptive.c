@@ -21,6 +21,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 //----------------------------------------------------------------
 
 enum node_type {
@@ -63,6 +67,26 @@ struct node16 {
 	struct value values[16];
 };
 
+// Returns the index of key in n16, or nr_entries if it's not there.
+static inline unsigned _node16_find(const struct node16 *n16, uint8_t key)
+{
+#ifdef __SSE2__
+	__m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char) key),
+				     _mm_loadu_si128((const __m128i *) n16->keys));
+	unsigned mask = _mm_movemask_epi8(cmp) & ((1u << n16->nr_entries) - 1);
+
+	return mask ? (unsigned) __builtin_ctz(mask) : n16->nr_entries;
+#else
+	unsigned i;
+
+	for (i = 0; i < n16->nr_entries; i++)
+		if (n16->keys[i] == key)
+			break;
+
+	return i;
+#endif
+}
+
 struct node48 {
 	uint32_t nr_entries;
 	uint8_t keys[256];
@@ -532,11 +556,10 @@ static struct lookup_result _lookup_prefix(struct value *v, const uint8_t *kb, c
 		break;
 
 	case NODE16:
-		// FIXME: use binary search or simd?
 		n16 = v->value.ptr;
-		for (i = 0; i < n16->nr_entries; i++)
-			if (n16->keys[i] == *kb)
-				return _lookup_prefix(n16->values + i, kb + 1, ke);
+		i = _node16_find(n16, *kb);
+		if (i < n16->nr_entries)
+			return _lookup_prefix(n16->values + i, kb + 1, ke);
 		break;
 
 	case NODE48:
@@ -726,22 +749,19 @@ static bool _remove(struct radix_tree *rt, struct value *root, const uint8_t *kb
 
 	case NODE16:
 		n16 = root->value.ptr;
-		for (i = 0; i < n16->nr_entries; i++) {
-			if (n16->keys[i] == *kb) {
-				r = _remove(rt, n16->values + i, kb + 1, ke);
-				if (r && n16->values[i].type == UNSET) {
-					if (i < n16->nr_entries) {
-						_erase_elt(n16->keys, sizeof(*n16->keys), n16->nr_entries, i);
-						_erase_elt(n16->values, sizeof(*n16->values), n16->nr_entries, i);
-					}
-
-					n16->nr_entries--;
-					if (n16->nr_entries <= 4) {
-						_degrade_to_n4(n16, root);
-					}
+		i = _node16_find(n16, *kb);
+		if (i < n16->nr_entries) {
+			r = _remove(rt, n16->values + i, kb + 1, ke);
+			if (r && n16->values[i].type == UNSET) {
+				_erase_elt(n16->keys, sizeof(*n16->keys), n16->nr_entries, i);
+				_erase_elt(n16->values, sizeof(*n16->values), n16->nr_entries, i);
+
+				n16->nr_entries--;
+				if (n16->nr_entries <= 4) {
+					_degrade_to_n4(n16, root);
 				}
-				return r;
 			}
+			return r;
 		}
 		return false;
 
@@ -634,9 +634,110 @@ rr_create_retry:
 }
 
 #else
+/*
+ * Checkpoint bitmaps of large mirrors are mostly long runs of clean or
+ * in-sync regions, so when it is smaller they are sent run-length
+ * encoded as pairs of 32-bit (count, word) after a ckpt_rle_header
+ * and the recovering region.  All fields are little-endian.
+ */
+#define CKPT_RLE_MAGIC 0x31454c52 /* "RLE1" */
+
+struct ckpt_rle_header {
+	uint32_t magic;
+	uint32_t bitmap_size;	/* decoded size of each bitmap in bytes */
+	uint32_t sync_size;	/* encoded sizes in bytes */
+	uint32_t clean_size;
+};
+
+/* Returns number of words stored in out, 0 if they do not fit in max */
+static uint32_t _rle_encode(const char *bits, int size,
+			    uint32_t *out, uint32_t max)
+{
+	const uint32_t *in = (const uint32_t *)bits;
+	uint32_t n = (uint32_t)size / sizeof(uint32_t);
+	uint32_t i, run, w = 0;
+
+	for (i = 0; i < n; i += run) {
+		for (run = 1; (i + run < n) && (in[i + run] == in[i]); run++)
+			;
+		if (w + 2 > max)
+			return 0;
+		out[w++] = xlate32(run);
+		out[w++] = xlate32(in[i]);
+	}
+
+	return w;
+}
+
+static int _rle_decode(const uint32_t *in, uint32_t words,
+		       char *bits, int size)
+{
+	uint32_t *out = (uint32_t *)bits;
+	uint32_t n = (uint32_t)size / sizeof(uint32_t);
+	uint32_t i = 0, w, run, word;
+
+	for (w = 0; w + 1 < words; w += 2) {
+		run = xlate32(in[w]);
+		word = xlate32(in[w + 1]);
+		if (run > n - i)
+			return -EINVAL;
+		while (run--)
+			out[i++] = word;
+	}
+
+	return ((w == words) && (i == n)) ? 0 : -EINVAL;
+}
+
+/*
+ * Fill in the run-length encoded payload of rq, which has room for
+ * the raw one.  Returns the payload size, or 0 when it would not be
+ * smaller than the raw bitmaps.
+ */
+static int _export_checkpoint_rle(struct checkpoint_data *cp,
+				  struct clog_request *rq, int raw_size)
+{
+	struct ckpt_rle_header *hdr = (struct ckpt_rle_header *)rq->u_rq.data;
+	uint32_t *words = (uint32_t *)(rq->u_rq.data + sizeof(*hdr) +
+				       RECOVERING_REGION_SECTION_SIZE);
+	uint32_t max, sync_words, clean_words;
+
+	if (raw_size <= (int)sizeof(*hdr) + RECOVERING_REGION_SECTION_SIZE)
+		return 0;
+
+	max = (raw_size - sizeof(*hdr) - RECOVERING_REGION_SECTION_SIZE) /
+		sizeof(uint32_t);
+
+	/* Each bitmap needs at least one (count, word) pair */
+	if (max < 4)
+		return 0;
+
+	if (!(sync_words = _rle_encode(cp->sync_bits, cp->bitmap_size,
+				       words, max - 2)) ||
+	    !(clean_words = _rle_encode(cp->clean_bits, cp->bitmap_size,
+					words + sync_words, max - sync_words)))
+		return 0;
+
+	hdr->magic = xlate32(CKPT_RLE_MAGIC);
+	hdr->bitmap_size = xlate32((uint32_t)cp->bitmap_size);
+	hdr->sync_size = xlate32(sync_words * sizeof(uint32_t));
+	hdr->clean_size = xlate32(clean_words * sizeof(uint32_t));
+
+	/* Recovering region */
+	memcpy(rq->u_rq.data + sizeof(*hdr), cp->recovering_region,
+	       strlen(cp->recovering_region));
+
+	LOG_DBG("[%s] Checkpoint bitmaps encoded to %u of %d bytes",
+		SHORT_UUID(cp->uuid),
+		(unsigned)((sync_words + clean_words) * sizeof(uint32_t)),
+		cp->bitmap_size * 2);
+
+	return (int)(sizeof(*hdr) + RECOVERING_REGION_SECTION_SIZE +
+		     (sync_words + clean_words) * sizeof(uint32_t));
+}
+
 static int export_checkpoint(struct checkpoint_data *cp)
 {
-	int r, rq_size;
+	int r, rq_size, data_size;
 	struct clog_request *rq;
 
 	rq_size = sizeof(*rq);
@@ -655,17 +756,23 @@ static int export_checkpoint(struct checkpoint_data *cp)
 	rq->originator = cp->requester;
 	strncpy(rq->u_rq.uuid, cp->uuid, CPG_MAX_NAME_LENGTH);
 	rq->u_rq.seq = my_cluster_id;
-	rq->u_rq.data_size = rq_size - sizeof(*rq);
 
-	/* Sync bits */
-	memcpy(rq->u_rq.data, cp->sync_bits, cp->bitmap_size);
+	if ((data_size = _export_checkpoint_rle(cp, rq, rq_size - sizeof(*rq))))
+		rq->u_rq.data_size = data_size;
+	else {
+		memset(rq->u_rq.data, 0, rq_size - sizeof(*rq));
+		rq->u_rq.data_size = rq_size - sizeof(*rq);
 
-	/* Clean bits */
-	memcpy(rq->u_rq.data + cp->bitmap_size, cp->clean_bits, cp->bitmap_size);
+		/* Sync bits */
+		memcpy(rq->u_rq.data, cp->sync_bits, cp->bitmap_size);
 
-	/* Recovering region */
-	memcpy(rq->u_rq.data + (cp->bitmap_size * 2), cp->recovering_region,
-	       strlen(cp->recovering_region));
+		/* Clean bits */
+		memcpy(rq->u_rq.data + cp->bitmap_size, cp->clean_bits, cp->bitmap_size);
+
+		/* Recovering region */
+		memcpy(rq->u_rq.data + (cp->bitmap_size * 2), cp->recovering_region,
+		       strlen(cp->recovering_region));
+	}
 
 	r = cluster_send(rq);
 	if (r)
@@ -835,6 +942,73 @@ no_read:
 }
 
 #else
+static int _is_checkpoint_rle(struct clog_request *rq)
+{
+	struct ckpt_rle_header *hdr = (struct ckpt_rle_header *)rq->u_rq.data;
+	uint32_t sync_size, clean_size;
+
+	if (rq->u_rq.data_size < sizeof(*hdr) + RECOVERING_REGION_SECTION_SIZE)
+		return 0;
+
+	if (xlate32(hdr->magic) != CKPT_RLE_MAGIC)
+		return 0;
+
+	sync_size = xlate32(hdr->sync_size);
+	clean_size = xlate32(hdr->clean_size);
+
+	return ((sync_size < rq->u_rq.data_size) &&
+		(clean_size < rq->u_rq.data_size) &&
+		(rq->u_rq.data_size == sizeof(*hdr) + RECOVERING_REGION_SECTION_SIZE +
+		 sync_size + clean_size)) ? 1 : 0;
+}
+
+static int _import_checkpoint_rle(struct clog_cpg *entry,
+				  struct clog_request *rq)
+{
+	struct ckpt_rle_header *hdr = (struct ckpt_rle_header *)rq->u_rq.data;
+	const uint32_t *words = (const uint32_t *)(rq->u_rq.data + sizeof(*hdr) +
+						   RECOVERING_REGION_SECTION_SIZE);
+	uint32_t bitmap_size = xlate32(hdr->bitmap_size);
+	uint32_t sync_words = xlate32(hdr->sync_size) / sizeof(uint32_t);
+	uint32_t clean_words = xlate32(hdr->clean_size) / sizeof(uint32_t);
+	char *bitmap;
+	int r = -EIO;
+
+	if (!bitmap_size || (bitmap_size % sizeof(uint32_t)) ||
+	    (bitmap_size > INT32_MAX / 2)) {
+		LOG_ERROR("Checkpoint has invalid bitmap size %u.", bitmap_size);
+		return -EINVAL;
+	}
+
+	if (!(bitmap = malloc(bitmap_size * 2))) {
+		LOG_ERROR("Unable to allocate memory for checkpoint bitmaps.");
+		return -ENOMEM;
+	}
+
+	if (_rle_decode(words, sync_words, bitmap, bitmap_size) ||
+	    _rle_decode(words + sync_words, clean_words,
+			bitmap + bitmap_size, bitmap_size)) {
+		LOG_ERROR("Checkpoint has invalid encoded bitmaps.");
+		r = -EINVAL;
+		goto out;
+	}
+
+	if (pull_state(entry->name.value, entry->luid, "sync_bits",
+		       bitmap, bitmap_size) ||
+	    pull_state(entry->name.value, entry->luid, "clean_bits",
+		       bitmap + bitmap_size, bitmap_size) ||
+	    pull_state(entry->name.value, entry->luid, "recovering_region",
+		       rq->u_rq.data + sizeof(*hdr),
+		       RECOVERING_REGION_SECTION_SIZE)) {
+		LOG_ERROR("Error loading bitmap state from checkpoint.");
+		goto out;
+	}
+	r = 0;
+out:
+	free(bitmap);
+	return r;
+}
+
 static int import_checkpoint(struct clog_cpg *entry, int no_read,
 			     struct clog_request *rq)
 {
@@ -845,6 +1019,9 @@ static int import_checkpoint(struct clog_cpg *entry, int no_read,
 		return 0;
 	}
 
+	if (_is_checkpoint_rle(rq))
+		return _import_checkpoint_rle(entry, rq);
+
 	bitmap_size = (rq->u_rq.data_size - RECOVERING_REGION_SECTION_SIZE) / 2;
 	if (bitmap_size < 0) {
 		LOG_ERROR("Checkpoint has invalid payload size.");
@@ -125,13 +125,28 @@ static void log_clear_bit(struct log_c *lc, dm_bitset_t bs, int bit)
 	lc->touched = 1;
 }
 
+/* Scan a word at a time; bs[0] holds the number of bits */
 static uint64_t find_next_zero_bit(dm_bitset_t bs, unsigned start)
 {
-	for (; dm_bit(bs, start); start++)
-		if (start >= *bs)
+	unsigned word, last_word;
+	uint32_t test;
+
+	if (start >= *bs)
+		return (uint64_t)-1;
+
+	word = start / DM_BITS_PER_INT;
+	last_word = (*bs - 1) / DM_BITS_PER_INT;
+	test = ~bs[word + 1] & (~0U << (start % DM_BITS_PER_INT));
+
+	while (!test) {
+		if (++word > last_word)
 			return (uint64_t)-1;
+		test = ~bs[word + 1];
+	}
+
+	start = word * DM_BITS_PER_INT + ffs(test) - 1;
 
-	return start;
+	return (start < *bs) ? start : (uint64_t)-1;
 }
 
 static uint64_t count_bits32(dm_bitset_t bs)
@@ -286,6 +286,15 @@ static int do_local_work(void *data __attribute__((unused)))
 
 		break;
 	case DM_ULOG_CLEAR_REGION:
+		/*
+		 * Marks and clears are already batched by the kernel:
+		 * dm-log-userspace queues them until the next flush and
+		 * sends each group as one request carrying a list of
+		 * regions, which goes out here as one CPG message.
+		 * Merging further (e.g. range-encoding across requests)
+		 * would change the clog_request format that every node
+		 * in the CPG must understand.
+		 */
 		r = kernel_ack(u_rq->seq, 0);
 
 		r = cluster_send(rq);
@@ -755,13 +755,31 @@ static void _exit_timeout(void *unused __attribute__((unused)))
 	pthread_mutex_unlock(&_timeout_mutex);
 }
 
+/*
+ * Keep _timeout_registry ordered by next_time.  Most devices use the same
+ * timeout, so searching from the tail finds the slot almost immediately.
+ */
+static void _insert_timeout(struct thread_status *thread)
+{
+	struct thread_status *t;
+
+	dm_list_iterate_back_items_gen(t, &_timeout_registry, timeout_list)
+		if (t->next_time <= thread->next_time) {
+			dm_list_add_h(&t->timeout_list, &thread->timeout_list);
+			return;
+		}
+
+	dm_list_add_h(&_timeout_registry, &thread->timeout_list);
+}
+
 /* Wake up monitor threads every so often. */
 static void *_timeout_thread(void *unused __attribute__((unused)))
 {
-	struct thread_status *thread;
+	struct thread_status *thread, *tmp;
 	struct timespec timeout, real_time;
 	time_t curr_time;
-	int ret;
+	int ret, locked;
+	DM_LIST_INIT(expired);
 
 	DEBUGLOG("Timeout thread starting.");
 	pthread_cleanup_push(_exit_timeout, NULL);
@@ -781,29 +799,46 @@ static void *_timeout_thread(void *unused __attribute__((unused)))
 		curr_time = real_time.tv_sec + ((real_time.tv_nsec > (1000000000 - 10000000)) ? 1 : 0);
 #endif
 
-		dm_list_iterate_items_gen(thread, &_timeout_registry, timeout_list) {
-			if (thread->next_time <= curr_time) {
-				thread->next_time = curr_time + thread->timeout;
+		/* Only the expired head of the ordered registry is visited */
+		locked = 0;
+		dm_list_iterate_items_gen_safe(thread, tmp, &_timeout_registry, timeout_list) {
+			if (thread->next_time > curr_time)
+				break;
+
+			thread->next_time = curr_time + thread->timeout;
+			dm_list_move(&expired, &thread->timeout_list);
+
+			/* Take the global lock once per pass, not per expired thread */
+			if (!locked) {
 				_lock_mutex();
-				if (thread->processing) {
-					/* Cannot signal processing monitoring thread */
-					log_debug("Skipping SIGALRM to processing Thr %x for timeout.",
-						  (int) thread->thread);
-				} else {
-					DEBUGLOG("Sending SIGALRM to Thr %x for timeout.",
-						 (int) thread->thread);
-					ret = pthread_kill(thread->thread, SIGALRM);
-					if (ret && (ret != ESRCH))
-						log_error("Unable to wakeup Thr %x for timeout: %s.",
-							  (int) thread->thread, strerror(ret));
-				}
-				_unlock_mutex();
+				locked = 1;
+			}
+			if (thread->processing) {
+				/* Cannot signal processing monitoring thread */
+				log_debug("Skipping SIGALRM to processing Thr %x for timeout.",
+					  (int) thread->thread);
+			} else {
+				DEBUGLOG("Sending SIGALRM to Thr %x for timeout.",
+					 (int) thread->thread);
+				ret = pthread_kill(thread->thread, SIGALRM);
+				if (ret && (ret != ESRCH))
+					log_error("Unable to wakeup Thr %x for timeout: %s.",
+						  (int) thread->thread, strerror(ret));
 			}
+		}
+
+		if (locked)
+			_unlock_mutex();
 
-			if (thread->next_time < timeout.tv_sec || !timeout.tv_sec)
-				timeout.tv_sec = thread->next_time;
+		dm_list_iterate_items_gen_safe(thread, tmp, &expired, timeout_list) {
+			dm_list_del(&thread->timeout_list);
+			_insert_timeout(thread);
 		}
 
+		if (!dm_list_empty(&_timeout_registry))
+			timeout.tv_sec = dm_list_struct_base(dm_list_first(&_timeout_registry),
+							     struct thread_status, timeout_list)->next_time;
+
 		pthread_cond_timedwait(&_timeout_cond, &_timeout_mutex,
 				       &timeout);
 	}
@@ -822,7 +857,7 @@ static int _register_for_timeout(struct thread_status *thread)
 
 	if (dm_list_empty(&thread->timeout_list)) {
 		thread->next_time = time(NULL) + thread->timeout;
-		dm_list_add(&_timeout_registry, &thread->timeout_list);
+		_insert_timeout(thread);
 		if (_timeout_running)
 			pthread_cond_signal(&_timeout_cond);
 	}
@@ -1739,39 +1774,47 @@ static void _process_initial_registrations(void)
 
 static void _cleanup_unused_threads(void)
 {
-	struct dm_list *l;
-	struct thread_status *thread;
+	struct thread_status *thread, *tmp;
+	struct dm_list done;
 	int ret;
 
+	dm_list_init(&done);
+
 	_lock_mutex();
 
-	while ((l = dm_list_first(&_thread_registry_unused))) {
-		thread = dm_list_item(l, struct thread_status);
+	/*
+	 * Threads get here in the order they start unregistering, but finish
+	 * in any order.  Collect all finished ones, so a slow unregistering
+	 * thread does not hold back the cleanup of the others (when stopping
+	 * dmeventd with many monitored devices, e.g. for restart) to later
+	 * rounds, each possibly waiting for the next request.
+	 */
+	dm_list_iterate_items_safe(thread, tmp, &_thread_registry_unused) {
 		if (thread->status != DM_THREAD_DONE) {
 			if (thread->processing)
-				break; /* cleanup on the next round */
+				continue; /* cleanup on the next round */
 
 			/* Signal possibly sleeping thread */
 			ret = pthread_kill(thread->thread, SIGALRM);
 			if (!ret || (ret != ESRCH))
-				break; /* check again on the next round */
+				continue; /* check again on the next round */
 
 			/* thread is likely gone */
 		}
 
-		dm_list_del(l);
-		_unlock_mutex();
+		dm_list_move(&done, &thread->list);
+	}
+
+	_unlock_mutex();
 
+	dm_list_iterate_items_safe(thread, tmp, &done) {
 		DEBUGLOG("Destroying Thr %x.", (int)thread->thread);
 
 		if (pthread_join(thread->thread, NULL))
 			log_sys_debug("pthread_join", "");
 
 		_free_thread_status(thread);
-		_lock_mutex();
 	}
-
-	_unlock_mutex();
 }
 
 static void _sig_alarm(int signum __attribute__((unused)))
@@ -642,35 +642,99 @@ static struct dm_task *_get_device_info(const struct dm_event_handler *dmevh)
 	return NULL;
 }
 
+/*
+ * The fifos of the last call are kept open, so a command registering
+ * (or checking) many devices starts and greets the daemon only once
+ * and then just takes the lock on the server fifo for each message.
+ */
+static pthread_mutex_t _fifos_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pid_t _fifos_pid = 0;
+static struct dm_event_fifos _fifos = {
+	.client = -1,
+	.server = -1,
+	/* FIXME Make these either configurable or depend directly on dmeventd_path */
+	.client_path = DM_EVENT_FIFO_CLIENT,
+	.server_path = DM_EVENT_FIFO_SERVER
+};
+
+/* Is the client fifo kept open still the one the daemon reads? */
+static int _kept_fifos_usable(void)
+{
+	struct stat st, fst;
+
+	if (_fifos.client < 0)
+		return 0;
+
+	/* Inherited from the parent process, leave them to it. */
+	if (_fifos_pid != getpid()) {
+		fini_fifos(&_fifos);
+		return 0;
+	}
+
+	/* A restarted or stopped daemon replaces or removes the fifo. */
+	if (lstat(_fifos.client_path, &st) || fstat(_fifos.client, &fst) ||
+	    (st.st_dev != fst.st_dev) || (st.st_ino != fst.st_ino)) {
+		fini_fifos(&_fifos);
+		return 0;
+	}
+
+	return 1;
+}
+
+static void _release_fifos(struct dm_event_fifos *fifos)
+{
+	if (flock(fifos->server, LOCK_UN)) {
+		log_sys_debug("flock unlock", fifos->server_path);
+		fini_fifos(fifos);
+	}
+}
+
 /* Handle the event (de)registration call and return negative error codes. */
 static int _do_event(int cmd, char *dmeventd_path, struct dm_event_daemon_message *msg,
 		     const char *dso_name, const char *dev_name,
 		     enum dm_event_mask evmask, uint32_t timeout)
 {
 	int ret;
-	struct dm_event_fifos fifos = {
-		.client = -1,
-		.server = -1,
-		/* FIXME Make these either configurable or depend directly on dmeventd_path */
-		.client_path = DM_EVENT_FIFO_CLIENT,
-		.server_path = DM_EVENT_FIFO_SERVER
-	};
-
-	if (!_init_client(dmeventd_path, &fifos)) {
+
+	pthread_mutex_lock(&_fifos_mutex);
+
+	if (_kept_fifos_usable()) {
+		if (flock(_fifos.server, LOCK_EX) < 0) {
+			log_sys_debug("flock", _fifos.server_path);
+			fini_fifos(&_fifos);
+		} else if (((ret = daemon_talk(&_fifos, msg, cmd, dso_name, dev_name,
+					       evmask, timeout)) != -EIO) || msg->data) {
+			_release_fifos(&_fifos);
+			goto out;
+		} else
+			/* No reply, daemon went away, start over. */
+			fini_fifos(&_fifos);
+	}
+
+	if (!_init_client(dmeventd_path, &_fifos)) {
 		ret = -ESRCH;
-		goto_out;
+		goto_bad;
 	}
 
-	ret = daemon_talk(&fifos, msg, DM_EVENT_CMD_HELLO, NULL, NULL, 0, 0);
+	_fifos_pid = getpid();
+
+	ret = daemon_talk(&_fifos, msg, DM_EVENT_CMD_HELLO, NULL, NULL, 0, 0);
 
 	free(msg->data);
 	msg->data = 0;
 
 	if (!ret)
-		ret = daemon_talk(&fifos, msg, cmd, dso_name, dev_name, evmask, timeout);
-out:
+		ret = daemon_talk(&_fifos, msg, cmd, dso_name, dev_name, evmask, timeout);
+
+	if ((ret != -EIO) || msg->data) {
+		_release_fifos(&_fifos);
+		goto out;
+	}
+bad:
 	/* what is the opposite of init? */
-	fini_fifos(&fifos);
+	fini_fifos(&_fifos);
+out:
+	pthread_mutex_unlock(&_fifos_mutex);
 
 	return ret;
 }
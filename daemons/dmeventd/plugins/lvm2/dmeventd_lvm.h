@@ -18,6 +18,15 @@
  * liblvm2cmd is not thread-safe so the locking in this library helps dmeventd
  * threads to co-operate in sharing a single instance.
  *
+ * A second lvm2_init_threaded() handle would not help: the command code keeps
+ * process-wide state (logging, config, lvmcache, device and label caches,
+ * memlock) outside struct cmd_context, so two commands cannot run in one
+ * process at the same time even on separate handles.  Plugins wanting
+ * concurrent actions across pools fork a handler instead (thin and vdo
+ * do so for commands given with a full path); each forked command takes
+ * only its own VG lock and a pool's thread waits for its child before
+ * running another, so repeated events for one pool are not queued.
+ *
  * FIXME Either support this properly as a generic liblvm2cmd wrapper or make
  * liblvm2cmd thread-safe so this can go away.
  */
@@ -32,7 +32,55 @@ DM_EVENT_LOG_FN("raid")
 
 /* FIXME Reformat to 80 char lines. */
 
-static int _process_raid_event(struct dso_state *state, char *params, const char *device)
+/*
+ * Events of many RAID LVs failing together (e.g. on one PV) queue up
+ * on the lock shared by all plugins, with each repair taking a while.
+ * Read the current status again once holding the lock, so a repair
+ * is skipped when the array has no failed devices anymore, e.g. when
+ * it was repaired or reloaded while this event was waiting.
+ *
+ * Each LV is still repaired by its own lvconvert, which takes a single
+ * LV and replaces its failed images in one allocation and commit.
+ */
+static int _raid_still_failed(struct dso_state *state, const char *uuid)
+{
+	struct dm_task *dmt;
+	struct dm_status_raid *status;
+	void *next = NULL;
+	uint64_t start, length;
+	char *target_type = NULL;
+	char *params;
+	int r = 1; /* Run the repair if unsure. */
+
+	if (!uuid || !*uuid || !(dmt = dm_task_create(DM_DEVICE_STATUS)))
+		return 1;
+
+	/* Non-blocking status read */
+	if (!dm_task_set_uuid(dmt, uuid) ||
+	    !dm_task_no_flush(dmt) ||
+	    !dm_task_run(dmt))
+		goto_out;
+
+	dm_get_next_target(dmt, next, &start, &length, &target_type, &params);
+
+	if (!target_type || strcmp(target_type, "raid") || next ||
+	    !dm_get_status_raid(state->mem, params, &status))
+		goto out;
+
+	r = strchr(status->dev_health, 'D') ||
+		(!strcmp(status->sync_action, "idle") &&
+		 (status->dev_health[0] == 'a') &&
+		 (status->insync_regions < status->total_regions));
+
+	dm_pool_free(state->mem, status);
+out:
+	dm_task_destroy(dmt);
+
+	return r;
+}
+
+static int _process_raid_event(struct dso_state *state, char *params,
+			       const char *device, const char *uuid)
 {
 	struct dm_status_raid *status;
 	const char *d;
@@ -94,11 +142,17 @@ static int _process_raid_event(struct dso_state *state, char *params, const char
 
 		state->failed = 1;
 
+		dmeventd_lvm2_lock();
+		if (!_raid_still_failed(state, uuid)) {
+			log_info("RAID device %s has no failed devices anymore, "
+				 "skipping repair.", device);
+			state->failed = 0;
 		/* if repair goes OK, report success even if lvscan has failed */
-		if (!dmeventd_lvm2_run_with_lock(state->cmd_lvconvert)) {
+		} else if (!dmeventd_lvm2_run(state->cmd_lvconvert)) {
 			log_error("Repair of RAID device %s failed.", device);
 			r = 0;
 		}
+		dmeventd_lvm2_unlock();
 	} else {
 		state->failed = 0;
 		if (status->insync_regions == status->total_regions)
@@ -138,7 +192,7 @@ void process_event(struct dm_task *dmt,
 			continue;
 		}
 
-		if (!_process_raid_event(state, params, device))
+		if (!_process_raid_event(state, params, device, dm_task_get_uuid(dmt)))
 			log_error("Failed to process event for %s.",
 				  device);
 	} while (next);
@@ -51,6 +51,8 @@ struct dso_state {
 	int data_percent;
 	uint64_t known_metadata_size;
 	uint64_t known_data_size;
+	uint64_t last_used_metadata_blocks;
+	uint64_t last_used_data_blocks;
 	unsigned fails;
 	unsigned max_fails;
 	int restore_sigset;
@@ -125,6 +127,21 @@ static int _use_policy(struct dm_task *dmt, struct dso_state *state)
 	return 1;
 }
 
+/*
+ * Polls come at a fixed interval, so growth since the previous poll is
+ * the best guess for growth until the next one.  Returns 1 when that
+ * would fill the volume before the next poll.
+ */
+static int _fills_before_next_check(uint64_t used, uint64_t *last_used,
+				    uint64_t total)
+{
+	uint64_t last = *last_used;
+
+	*last_used = used;
+
+	return (last && (used > last) && ((used - last) >= (total - used)));
+}
+
 /* Check if executed command has finished
  * Only 1 command may run */
 static int _wait_for_pid(struct dso_state *state)
@@ -233,12 +250,14 @@ void process_event(struct dm_task *dmt,
 	if (state->known_metadata_size != tps->total_metadata_blocks) {
 		state->metadata_percent_check = CHECK_MINIMUM;
 		state->known_metadata_size = tps->total_metadata_blocks;
+		state->last_used_metadata_blocks = 0;
 		state->fails = 0;
 	}
 
 	if (state->known_data_size != tps->total_data_blocks) {
 		state->data_percent_check = CHECK_MINIMUM;
 		state->known_data_size = tps->total_data_blocks;
+		state->last_used_data_blocks = 0;
 		state->fails = 0;
 	}
 
@@ -263,6 +282,14 @@ void process_event(struct dm_task *dmt,
 	} else
 		state->metadata_percent_check = CHECK_MINIMUM;
 
+	/* Do not wait for the next threshold when the next poll may be too late */
+	if (_fills_before_next_check(tps->used_metadata_blocks, &state->last_used_metadata_blocks,
+				     tps->total_metadata_blocks) &&
+	    (state->metadata_percent > CHECK_MINIMUM)) {
+		log_warn("WARNING: Thin pool %s metadata may fill up before the next check.", device);
+		needs_policy = 1;
+	}
+
 	state->data_percent = dm_make_percent(tps->used_data_blocks, tps->total_data_blocks);
 	if ((state->data_percent > WARNING_THRESH) &&
 	    (state->data_percent > state->data_percent_check))
@@ -278,6 +305,13 @@ void process_event(struct dm_task *dmt,
 	} else
 		state->data_percent_check = CHECK_MINIMUM;
 
+	if (_fills_before_next_check(tps->used_data_blocks, &state->last_used_data_blocks,
+				     tps->total_data_blocks) &&
+	    (state->data_percent > CHECK_MINIMUM)) {
+		log_warn("WARNING: Thin pool %s data may fill up before the next check.", device);
+		needs_policy = 1;
+	}
+
 	/* Reduce number of _use_policy() calls by power-of-2 factor till frequency of MAX_FAILS is reached.
 	 * Avoids too high number of error retries, yet shows some status messages in log regularly.
 	 * i.e. PV could have been pvmoved and VG/LV was locked for a while...
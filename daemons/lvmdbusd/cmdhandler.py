@@ -29,8 +29,8 @@ except ImportError:
 total_time = 0.0
 total_count = 0
 
-# We need to prevent different threads from using the same lvm shell
-# at the same time.
+# Protects switching the way lvm is called and the time accounting,
+# each lvm shell is used by one thread only, see LvmShellPool.
 cmd_lock = threading.RLock()
 
 
@@ -189,6 +189,52 @@ def call_lvm(command, debug=False, line_cb=None,
 		return -errno.EINTR, "", "operation interrupted"
 
 
+class LvmShellPool(object):
+	"""
+	Every thread calling lvm gets its own lvm shell, so the threads
+	processing requests and the thread updating the state do not wait
+	for each other.  A shell is started the first time a thread uses it.
+	"""
+
+	def __init__(self):
+		self.lock = threading.RLock()
+		self.shells = {}
+		self.exited = False
+		# Start a shell for the caller right away, so we know it works
+		self._shell()
+
+	def _shell(self):
+		name = threading.current_thread().name
+		with self.lock:
+			if self.exited:
+				return None
+			shell = self.shells.get(name)
+		if shell is None:
+			shell = LVMShellProxy()
+			with self.lock:
+				if self.exited:
+					shell.exit_shell()
+					return None
+				self.shells[name] = shell
+		return shell
+
+	def call_lvm(self, command, debug=False):
+		shell = self._shell()
+		if shell is not None:
+			with shell.shell_lock:
+				# The shell may have been told to exit while we waited for it
+				if shell.lvm_shell is not None:
+					return shell.call_lvm(command, debug)
+		return call_lvm(command, debug)
+
+	def exit_shell(self):
+		with self.lock:
+			self.exited = True
+			for shell in self.shells.values():
+				shell.exit_shell()
+			self.shells.clear()
+
+
 # The actual method which gets called to invoke the lvm command, can vary
 # from forking a new process to using lvm shell
 _t_call = call_lvm
@@ -198,7 +244,7 @@ def _shell_cfg():
 	global _t_call
 	# noinspection PyBroadException
 	try:
-		lvm_shell = LVMShellProxy()
+		lvm_shell = LvmShellPool()
 		_t_call = lvm_shell.call_lvm
 		cfg.SHELL_IN_USE = lvm_shell
 		return True
@@ -235,17 +281,17 @@ def time_wrapper(command, debug=False):
 	global total_time
 	global total_count
 
+	start = time.time()
+	meta = LvmExecutionMeta(start, 0, command)
+	# Add the partial metadata to flight recorder, so if the command hangs
+	# we will see what it was.
+	cfg.flightrecorder.add(meta)
+	results = _t_call(command, debug)
+	ended = time.time()
 	with cmd_lock:
-		start = time.time()
-		meta = LvmExecutionMeta(start, 0, command)
-		# Add the partial metadata to flight recorder, so if the command hangs
-		# we will see what it was.
-		cfg.flightrecorder.add(meta)
-		results = _t_call(command, debug)
-		ended = time.time()
 		total_time += (ended - start)
 		total_count += 1
-		meta.completed(ended, *results)
+	meta.completed(ended, *results)
 	return results
 
 
@@ -574,7 +620,7 @@ def supports_vdo():
 	return False
 
 
-def lvm_full_report_json():
+def lvm_full_report_json(vg_names=None):
 	pv_columns = ['pv_name', 'pv_uuid', 'pv_fmt', 'pv_size', 'pv_free',
 					'pv_used', 'dev_size', 'pv_mda_size', 'pv_mda_free',
 					'pv_ba_start', 'pv_ba_size', 'pe_start', 'pv_pe_count',
@@ -599,7 +645,7 @@ def lvm_full_report_json():
 				'snap_percent', 'metadata_percent', 'copy_percent',
 				'sync_percent', 'lv_metadata_size', 'move_pv', 'move_pv_uuid']
 
-	lv_seg_columns = ['seg_pe_ranges', 'segtype', 'lv_uuid']
+	lv_seg_columns = ['segtype', 'lv_uuid']
 
 	if cfg.vdo_support:
 		lv_columns.extend(
@@ -626,6 +672,10 @@ def lvm_full_report_json():
 		'--configreport', 'pvseg', '-o', ','.join(pv_seg_columns)
 	])
 
+	# Limit the report to the listed VGs when only those changed
+	if vg_names:
+		cmd.extend(vg_names)
+
 	# We are running the fullreport command, we will ask lvm to output the debug
 	# data, so we can have the required information for lvm to debug the fullreport failures.
 	# Note: this is disabled by default and can be enabled with env. var.
@@ -16,31 +16,50 @@ from .utils import MThreadRunner, log_debug, log_error, LvmBug, extract_stack_tr
 import threading
 import queue
 import time
+from itertools import chain
 
 
-def _main_thread_load(refresh=True, emit_signal=True):
+def _main_thread_load(refresh=True, emit_signal=True, vg_uuids=None):
 	num_total_changes = 0
 	to_remove = []
+	pv_names = vg_names = lv_names = None
+
+	# Only look at the objects of these VGs, the others are unchanged
+	if vg_uuids:
+		pv_names = []
+		vg_names = []
+		lv_names = []
+		for vg_uuid in vg_uuids:
+			pvs, vg, lvs = cfg.db.vg_search_keys(vg_uuid)
+			pv_names.extend(pvs)
+			vg_names.append(vg)
+			lv_names.extend(lvs)
 
 	(changes, remove) = load_pvs(
+		device=pv_names,
 		refresh=refresh,
 		emit_signal=emit_signal,
-		cache_refresh=False)[1:]
+		cache_refresh=False,
+		vg_uuids=vg_uuids)[1:]
 	num_total_changes += changes
 	to_remove.extend(remove)
 
 	(changes, remove) = load_vgs(
+		vg_specific=vg_names,
 		refresh=refresh,
 		emit_signal=emit_signal,
-		cache_refresh=False)[1:]
+		cache_refresh=False,
+		vg_uuids=vg_uuids)[1:]
 
 	num_total_changes += changes
 	to_remove.extend(remove)
 
 	(lv_changes, remove) = load_lvs(
+		lv_name=lv_names,
 		refresh=refresh,
 		emit_signal=emit_signal,
-		cache_refresh=False)[1:]
+		cache_refresh=False,
+		vg_uuids=vg_uuids)[1:]
 
 	num_total_changes += lv_changes
 	to_remove.extend(remove)
@@ -53,9 +72,11 @@ def _main_thread_load(refresh=True, emit_signal=True):
 	# recreated.
 	if refresh and lv_changes > 0:
 		(changes, remove) = load_vgs(
+			vg_specific=vg_names,
 			refresh=refresh,
 			emit_signal=emit_signal,
-			cache_refresh=False)[1:]
+			cache_refresh=False,
+			vg_uuids=vg_uuids)[1:]
 
 	num_total_changes += changes
 	to_remove.extend(remove)
@@ -74,15 +95,20 @@ def _main_thread_load(refresh=True, emit_signal=True):
 
 
 def load(refresh=True, emit_signal=True, cache_refresh=True, log=True,
-			need_main_thread=True):
-	# Go through and load all the PVs, VGs and LVs
-	if cache_refresh:
+			need_main_thread=True, vgs=None):
+	# Go through and load all the PVs, VGs and LVs, or when we are told
+	# which VGs alone changed (vg_name, vg_uuid, vg_seqno), only theirs.
+	vg_uuids = None
+	if vgs and refresh and cache_refresh and cfg.db.refresh_vgs(vgs, log):
+		vg_uuids = set([v[1] for v in vgs])
+	elif cache_refresh:
 		cfg.db.refresh(log)
 
 	if need_main_thread:
-		rc = MThreadRunner(_main_thread_load, refresh, emit_signal).done()
+		rc = MThreadRunner(_main_thread_load, refresh, emit_signal,
+							vg_uuids).done()
 	else:
-		rc = _main_thread_load(refresh, emit_signal)
+		rc = _main_thread_load(refresh, emit_signal, vg_uuids)
 
 	return rc
 
@@ -95,13 +121,14 @@ class StateUpdate(object):
 	class UpdateRequest(object):
 
 		def __init__(self, refresh, emit_signal, cache_refresh, log,
-						need_main_thread):
+						need_main_thread, vgs=None):
 			self.is_done = False
 			self.refresh = refresh
 			self.emit_signal = emit_signal
 			self.cache_refresh = cache_refresh
 			self.log = log
 			self.need_main_thread = need_main_thread
+			self.vgs = vgs
 			self.result = None
 			self.cond = threading.Condition(threading.Lock())
 
@@ -151,7 +178,18 @@ class StateUpdate(object):
 			log = any([r.log for r in requests])
 			need_main_thread = any([r.need_main_thread for r in requests])
 
-			return refresh, emit_signal, cache_refresh, log, need_main_thread
+			# We can limit the update to the VGs named, only when every request
+			# names some.  For each VG we only need the newest seqno.
+			vgs = None
+			if all([r.vgs for r in requests]):
+				newest = {}
+				for (vg_name, vg_uuid, vg_seqno) in chain.from_iterable(
+						[r.vgs for r in requests]):
+					if vg_uuid not in newest or newest[vg_uuid][2] < vg_seqno:
+						newest[vg_uuid] = (vg_name, vg_uuid, vg_seqno)
+				vgs = list(newest.values())
+
+			return refresh, emit_signal, cache_refresh, log, need_main_thread, vgs
 
 		def _drain_queue(queued, incoming):
 			try:
@@ -245,10 +283,13 @@ class StateUpdate(object):
 										name="StateUpdate.update_thread")
 
 	def load(self, refresh=True, emit_signal=True, cache_refresh=True,
-					log=True, need_main_thread=True):
-		# Place this request on the queue and wait for it to be completed
+					log=True, need_main_thread=True, vg=None, vgs=None):
+		# Place this request on the queue and wait for it to be completed,
+		# vg or vgs limit it to the (vg_name, vg_uuid, vg_seqno) given
+		if vg:
+			vgs = [vg]
 		req = StateUpdate.UpdateRequest(refresh, emit_signal, cache_refresh,
-										log, need_main_thread)
+										log, need_main_thread, vgs)
 		self.queue.put(req)
 		return req.done()
 
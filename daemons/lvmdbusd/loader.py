@@ -23,7 +23,7 @@ def _compare_construction(o_state, new_state):
 
 
 def common(retrieve, o_type, search_keys,
-			object_path, refresh, emit_signal, cache_refresh):
+			object_path, refresh, emit_signal, cache_refresh, in_scope=None):
 	num_changes = 0
 	existing_paths = []
 	rc = []
@@ -34,12 +34,17 @@ def common(retrieve, o_type, search_keys,
 	if cache_refresh:
 		cfg.db.refresh()
 
-	objects = retrieve(search_keys, cache_refresh=False)
+	# When refreshing only the objects in_scope, an empty selection means
+	# none of them are left, rather than all objects.
+	if in_scope and not search_keys:
+		objects = []
+	else:
+		objects = retrieve(search_keys, cache_refresh=False)
 
 	# If we are doing a refresh we need to know what we have in memory, what's
 	# in lvm and add those that are new and remove those that are gone!
 	if refresh:
-		existing_paths = cfg.om.object_paths_by_type(o_type)
+		existing_paths = cfg.om.object_paths_by_type(o_type, in_scope)
 
 	for o in objects:
 		# Assume we need to add this one to dbus, unless we are refreshing,
@@ -52,7 +57,7 @@ def common(retrieve, o_type, search_keys,
 			dbus_object = cfg.om.get_object_by_uuid_lvm_id(*o.identifiers())
 
 			if dbus_object:
-				del existing_paths[dbus_object.dbus_object_path()]
+				existing_paths.pop(dbus_object.dbus_object_path(), None)
 
 				# If the old object state and new object state wouldn't be
 				# created with the same path and same object constructor we
@@ -143,12 +143,13 @@ def lvs_state_retrieve(selection, cache_refresh=True):
 
 
 def load_lvs(lv_name=None, object_path=None, refresh=False, emit_signal=False,
-				cache_refresh=True):
+				cache_refresh=True, vg_uuids=None):
+	in_scope = (lambda s: s.vg_uuid in vg_uuids) if vg_uuids else None
 	# noinspection PyUnresolvedReferences
 	return common(
 		lvs_state_retrieve,
 		(LvCommon, Lv, LvThinPool, LvSnapShot),
-		lv_name, object_path, refresh, emit_signal, cache_refresh)
+		lv_name, object_path, refresh, emit_signal, cache_refresh, in_scope)
 
 
 # noinspection PyPep8Naming,PyUnresolvedReferences,PyUnusedLocal
@@ -29,7 +29,7 @@ import argparse
 import os
 import sys
 from .cmdhandler import LvmFlightRecorder, supports_vdo, supports_json
-from .request import RequestEntry
+from .request import RequestEntry, RequestQueues
 
 
 class Lvm(objectmanager.ObjectManager):
@@ -37,11 +37,11 @@ class Lvm(objectmanager.ObjectManager):
 		super(Lvm, self).__init__(object_path, BASE_INTERFACE)
 
 
-def process_request():
+def process_request(request_queue):
 	while cfg.run.value != 0:
 		# noinspection PyBroadException
 		try:
-			req = cfg.worker_q.get(True, cfg.G_LOOP_TMO)
+			req = request_queue.get(True, cfg.G_LOOP_TMO)
 			log_debug(
 				"Method start: %s with args %s (callback = %s)" %
 				(str(req.method), str(req.arguments), str(req.cb)))
@@ -65,6 +65,22 @@ def check_fr_size(value):
 	return v
 
 
+def check_udev_delay(value):
+	v = float(value)
+	if v < 0:
+		raise argparse.ArgumentTypeError(
+			"positive numbers only ('%s' invalid)" % value)
+	return v
+
+
+def check_workers(value):
+	v = int(value)
+	if v < 1:
+		raise argparse.ArgumentTypeError(
+			"integers greater than 0 only ('%s' invalid)" % value)
+	return v
+
+
 def install_signal_handlers():
 	# Because of the glib main loop stuff the python signal handler code is
 	# apparently not usable, and we need to use the glib calls instead
@@ -105,6 +121,20 @@ def process_args():
 		help="Use the lvm shell, not fork & exec lvm",
 		default=False,
 		dest='use_lvm_shell')
+	parser.add_argument(
+		"--udevdelay",
+		help="Seconds to collect udev events for before refreshing the "
+			"state for them (default 1)",
+		default=1.0,
+		type=check_udev_delay,
+		dest='udev_delay')
+	parser.add_argument(
+		"--workers",
+		help="Number of threads processing requests, requests for different "
+			"VGs run in parallel when more than 1 (default 4)",
+		default=4,
+		type=check_workers,
+		dest='workers')
 	parser.add_argument(
 		"--frsize",
 		help="Size of the flight recorder (num. entries), 0 to disable (signal 12 to dump)",
@@ -199,10 +229,13 @@ def main():
 
 		cfg.db = lvmdb.DataStore(vdo_support=cfg.vdo_support)
 
-		# Using a thread to process requests, we cannot hang the dbus library
+		# Using threads to process requests, we cannot hang the dbus library
 		# thread that is handling the dbus interface
-		thread_list.append(
-			threading.Thread(target=process_request, name='process_request'))
+		cfg.worker_q = RequestQueues(cfg.args.workers)
+		for i, q in enumerate(cfg.worker_q.queues):
+			thread_list.append(
+				threading.Thread(target=process_request, args=(q,),
+								name='process_request_%d' % i))
 
 		# Have a single thread handling updating lvm and the dbus model, so we
 		# don't have multiple threads doing this as the same time
@@ -208,6 +208,62 @@ class Manager(AutomatedProperties):
 		cfg.worker_q.put(r)
 		return dbus.Int32(0)
 
+	@staticmethod
+	def _external_event_vg(command, vg_name, vg_uuid, vg_seqno):
+		utils.log_debug("Processing _external_event_vg= %s %s %s %d" %
+						(command, vg_name, vg_uuid, vg_seqno),
+						'bg_black', 'fg_orange')
+		cfg.got_external_event = True
+		cfg.load(vg=(vg_name, vg_uuid, vg_seqno))
+
+	@dbus.service.method(
+		dbus_interface=MANAGER_INTERFACE,
+		in_signature='sssu', out_signature='i')
+	def ExternalEventVg(self, command, vg_name, vg_uuid, vg_seqno):
+		"""
+		Like ExternalEvent, for a command which changed only the one VG,
+		so we only need to refresh the objects of that VG.
+
+		:param command  The lvm command which made the change
+		:param vg_name  Name of the changed VG
+		:param vg_uuid  UUID of the changed VG
+		:param vg_seqno Metadata sequence number of the VG after the change
+		"""
+		utils.log_debug("ExternalEventVg %s %s" % (command, vg_name))
+		r = RequestEntry(
+			-1, Manager._external_event_vg,
+			(command, str(vg_name), str(vg_uuid), int(vg_seqno)), None, None,
+			False)
+		cfg.worker_q.put(r)
+		return dbus.Int32(0)
+
+	@staticmethod
+	def _external_event_vgs(command, vgs):
+		utils.log_debug("Processing _external_event_vgs= %s %s" %
+						(command, ' '.join(v[0] for v in vgs)),
+						'bg_black', 'fg_orange')
+		cfg.got_external_event = True
+		cfg.load(vgs=vgs)
+
+	@dbus.service.method(
+		dbus_interface=MANAGER_INTERFACE,
+		in_signature='sa(ssu)', out_signature='i')
+	def ExternalEventVgs(self, command, vgs):
+		"""
+		Like ExternalEventVg, for a command or a batch of commands which
+		changed several VGs, so we only need to refresh the objects of those.
+
+		:param command  The lvm command which made the change
+		:param vgs      Array of (name, uuid, seqno) of the changed VGs
+		"""
+		utils.log_debug("ExternalEventVgs %s %d VGs" % (command, len(vgs)))
+		r = RequestEntry(
+			-1, Manager._external_event_vgs,
+			(command, [(str(n), str(u), int(s)) for n, u, s in vgs]),
+			None, None, False)
+		cfg.worker_q.put(r)
+		return dbus.Int32(0)
+
 	@staticmethod
 	def _pv_scan(activate, cache, device_path, major_minor, scan_options):
 
@@ -138,12 +138,13 @@ class ObjectManager(AutomatedProperties):
 				dbus_obj, obj_path,
 				new_lvm_id, new_uuid)
 
-	def object_paths_by_type(self, o_type):
+	def object_paths_by_type(self, o_type, in_scope=None):
 		with self.rlock:
 			rc = {}
 
 			for k, v in list(self._objects.items()):
-				if isinstance(v[0], o_type):
+				if isinstance(v[0], o_type) and \
+						(in_scope is None or in_scope(v[0].state)):
 					rc[k] = True
 			return rc
 
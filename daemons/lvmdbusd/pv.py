@@ -49,10 +49,11 @@ def pvs_state_retrieve(selection, cache_refresh=True):
 
 
 def load_pvs(device=None, object_path=None, refresh=False, emit_signal=False,
-		cache_refresh=True):
+		cache_refresh=True, vg_uuids=None):
+	in_scope = (lambda s: s.vg_uuid in vg_uuids) if vg_uuids else None
 	return common(
 		pvs_state_retrieve, (Pv,), device, object_path, refresh,
-		emit_signal, cache_refresh)
+		emit_signal, cache_refresh, in_scope)
 
 
 # noinspection PyUnresolvedReferences
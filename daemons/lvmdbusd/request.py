@@ -8,6 +8,7 @@
 # along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 import dbus
+import queue
 import threading
 # noinspection PyUnresolvedReferences
 from gi.repository import GLib
@@ -67,6 +68,18 @@ class RequestEntry(object):
 		else:
 			self.cb(self._job.dbus_object_path())
 
+	def vg_name(self):
+		"""
+		Name of the VG the request is about, None when it is not about
+		a single VG.  Methods of VG and LV objects all take the object
+		uuid and lvm_id as their first arguments.
+		"""
+		name = getattr(self.method, '__qualname__', '')
+		if (name.startswith('Vg') or name.startswith('Lv')) and \
+				len(self.arguments) > 1 and isinstance(self.arguments[1], str):
+			return self.arguments[1].split('/')[0]
+		return None
+
 	def run_cmd(self):
 		try:
 			result = self.method(*self.arguments)
@@ -164,3 +177,23 @@ class RequestEntry(object):
 				pass
 
 		return False
+
+
+class RequestQueues(object):
+	"""
+	Requests are processed by several threads, each taking them in order
+	from its own queue.  Requests for one VG always go to the same queue,
+	so they stay ordered, while requests for different VGs can run at the
+	same time.  Requests that are not about a single VG use the first queue.
+	"""
+
+	def __init__(self, count):
+		self.queues = [queue.Queue() for _ in range(max(count, 1))]
+
+	def _index(self, vg_name):
+		if vg_name is None or len(self.queues) == 1:
+			return 0
+		return 1 + hash(vg_name) % (len(self.queues) - 1)
+
+	def put(self, r):
+		self.queues[self._index(r.vg_name())].put(r)
@@ -17,33 +17,71 @@ observer = None
 observer_lock = threading.RLock()
 
 _udev_lock = threading.RLock()
-_udev_count = 0
-
-
-def udev_add():
-	global _udev_count
+_udev_timer = None
+# VGs to refresh for the events seen since the timer was started,
+# None when an event needs everything refreshed
+_udev_vgs = set()
+
+
+def udev_add(vg=None):
+	"""
+	Events are collected for cfg.args.udev_delay seconds before a single
+	refresh is queued for them, so a burst of events, e.g. from path
+	failovers, costs one refresh limited to the VGs they are about.
+	:param vg: (vg_name, vg_uuid, vg_seqno) of the VG the event is about,
+				None if it is about more than a VG we know
+	"""
+	global _udev_timer
+	global _udev_vgs
 	with _udev_lock:
-		if _udev_count == 0:
-			_udev_count += 1
+		if vg is None:
+			_udev_vgs = None
+		elif _udev_vgs is not None:
+			_udev_vgs.add(vg)
 
-			# Place this on the queue so any other operations will sequence
-			# behind it
-			r = RequestEntry(
-				-1, _udev_event, (), None, None, False)
-			cfg.worker_q.put(r)
+		if _udev_timer is None:
+			_udev_timer = threading.Timer(cfg.args.udev_delay, _udev_queue)
+			_udev_timer.daemon = True
+			_udev_timer.start()
 
 
-def udev_complete():
-	global _udev_count
+def _udev_queue():
+	global _udev_timer
+	global _udev_vgs
 	with _udev_lock:
-		if _udev_count > 0:
-			_udev_count -= 1
+		vgs = _udev_vgs
+		_udev_vgs = set()
+		_udev_timer = None
+
+	# Place this on the queue so any other operations will sequence
+	# behind it
+	r = RequestEntry(
+		-1, _udev_event, (vgs,), None, None, False)
+	cfg.worker_q.put(r)
+
+
+def _udev_event(vgs):
+	if vgs:
+		utils.log_debug("Processing udev events for VG %s" %
+						", ".join(sorted([v[0] for v in vgs])))
+		cfg.load(vgs=list(vgs))
+	else:
+		utils.log_debug("Processing udev event")
+		cfg.load()
 
 
-def _udev_event():
-	utils.log_debug("Processing udev event")
-	udev_complete()
-	cfg.load()
+def _device_vg(dev_name):
+	"""
+	The VG of the PV on the device, so a change of the device only needs
+	that VG refreshed.  None when the device is not a PV of a VG we know.
+	"""
+	state = getattr(cfg.om.get_object_by_lvm_id(dev_name), 'state', None)
+	vg_name = getattr(state, 'vg_name', None)
+	vg_uuid = getattr(state, 'vg_uuid', None)
+	if not vg_name or not vg_uuid:
+		return None
+	# Any seqno, the event does not tell us about a metadata change
+	return vg_name, vg_uuid, 0
 
 
 # noinspection PyUnusedLocal
@@ -51,6 +89,7 @@ def filter_event(action, device):
 	# Filter for events of interest and add a request object to be processed
 	# when appropriate.
 	refresh = False
+	vg = None
 
 	# Ignore everything but change
 	if action != 'change':
@@ -71,14 +110,16 @@ def filter_event(action, device):
 			if 'DEVNAME' in device:
 				if cfg.om.get_object_by_lvm_id(device['DEVNAME']):
 					refresh = True
+					vg = _device_vg(device['DEVNAME'])
 	else:
 		# This handles the wipefs -a path
 		if not refresh and 'DEVNAME' in device:
 			if cfg.om.get_object_by_lvm_id(device['DEVNAME']):
 				refresh = True
+				vg = _device_vg(device['DEVNAME'])
 
 	if refresh:
-		udev_add()
+		udev_add(vg)
 
 
 def add():
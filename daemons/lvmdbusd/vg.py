@@ -53,9 +53,10 @@ def vgs_state_retrieve(selection, cache_refresh=True):
 
 
 def load_vgs(vg_specific=None, object_path=None, refresh=False,
-		emit_signal=False, cache_refresh=True):
+		emit_signal=False, cache_refresh=True, vg_uuids=None):
+	in_scope = (lambda s: s.Uuid in vg_uuids) if vg_uuids else None
 	return common(vgs_state_retrieve, (Vg, VgVdo, ), vg_specific, object_path, refresh,
-					emit_signal, cache_refresh)
+					emit_signal, cache_refresh, in_scope)
 
 
 # noinspection PyPep8Naming,PyUnresolvedReferences,PyUnusedLocal
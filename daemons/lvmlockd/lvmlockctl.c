@@ -26,6 +26,7 @@
 
 static int quit = 0;
 static int info = 0;
+static int stats = 0;
 static int dump = 0;
 static int wait_opt = 1;
 static int force_opt = 0;
@@ -129,17 +130,27 @@ static void format_info_ls(char *line)
 	char vg_sysid[MAX_NAME+1] = { 0 };
 	char lock_args[MAX_ARGS+1] = { 0 };
 	char lock_type[MAX_NAME+1] = { 0 };
+	unsigned start_sec = 0;
+	char *p;
 
 	(void) sscanf(line, "info=ls ls_name=%s vg_name=%s vg_uuid=%s vg_sysid=%s vg_args=%s lm_type=%s",
 	       ls_name, vg_name, vg_uuid, vg_sysid, lock_args, lock_type);
 
+	if ((p = strstr(line, "start_sec=")))
+		(void) sscanf(p, "start_sec=%u", &start_sec);
+
 	if (!first_ls)
 		printf("\n");
 	first_ls = 0;
 
 	printf("VG %s lock_type=%s %s\n", vg_name, lock_type, vg_uuid);
 
-	printf("LS %s %s\n", lock_type, ls_name);
+	if (strstr(line, "create_fail=1"))
+		printf("LS %s %s start failed after %us\n", lock_type, ls_name, start_sec);
+	else if (strstr(line, "create_done=0"))
+		printf("LS %s %s starting for %us\n", lock_type, ls_name, start_sec);
+	else
+		printf("LS %s %s\n", lock_type, ls_name);
 }
 
 static void format_info_ls_action(char *line)
@@ -293,6 +304,10 @@ static void format_info_line(char *line, char *r_name, char *r_type)
 	} else if (!strncmp(line, "info=r_action ", sizeof("info=r_action ") - 1)) {
 		/* will use info from previous r */
 		format_info_r_action(line, r_name, r_type);
+
+	} else if (!strncmp(line, "info=ls_stats ", sizeof("info=ls_stats ") - 1) ||
+		   !strncmp(line, "info=r_stats ", sizeof("info=r_stats ") - 1)) {
+		/* only printed by --stats */
 	} else {
 		printf("UN %s\n", line);
 	}
@@ -310,7 +325,7 @@ static void format_info(void)
 	for (i = 0; i < dump_len; i++) {
 		line[j++] = dump_buf[i];
 
-		if ((line[j-1] == '\n') || (line[j-1] == '\0')) {
+		if ((line[j-1] == '\n') || (line[j-1] == '\0') || (j == MAX_LINE - 1)) {
 			format_info_line(line, r_name, r_type);
 			j = 0;
 			memset(line, 0, sizeof(line));
@@ -318,6 +333,86 @@ static void format_info(void)
 	}
 }
 
+struct time_stat {
+	unsigned long long count;
+	unsigned long long total_us;
+	unsigned long long max_us;
+	unsigned hist[6];
+};
+
+/* The values of key (e.g. "wait=") are count/total_us/max_us/hist. */
+static void format_stats_time(const char *line, const char *key)
+{
+	struct time_stat st = { 0 };
+	const char *p;
+
+	if (!(p = strstr(line, key)))
+		return;
+
+	if (sscanf(p + strlen(key), "%llu/%llu/%llu/%u,%u,%u,%u,%u,%u",
+		   &st.count, &st.total_us, &st.max_us,
+		   &st.hist[0], &st.hist[1], &st.hist[2],
+		   &st.hist[3], &st.hist[4], &st.hist[5]) != 9)
+		return;
+
+	printf("    %-5.*s count %llu avg_us %llu max_us %llu hist %u %u %u %u %u %u\n",
+	       (int)strlen(key) - 2, key + 1,
+	       st.count, st.count ? st.total_us / st.count : 0, st.max_us,
+	       st.hist[0], st.hist[1], st.hist[2],
+	       st.hist[3], st.hist[4], st.hist[5]);
+}
+
+static void format_stats_line(char *line)
+{
+	char ls_name[MAX_NAME+1] = { 0 };
+	char vg_name[MAX_NAME+1] = { 0 };
+	char r_name[MAX_NAME+1] = { 0 };
+	char r_type[4] = { 0 };
+	unsigned long long retries = 0;
+	const char *p;
+
+	if ((p = strstr(line, " retries=")))
+		(void) sscanf(p, " retries=%llu", &retries);
+
+	if (!strncmp(line, "info=ls_stats ", sizeof("info=ls_stats ") - 1)) {
+		(void) sscanf(line, "info=ls_stats ls_name=%64s vg_name=%64s", ls_name, vg_name);
+		printf("VG %s %s retries %llu\n", vg_name, ls_name, retries);
+
+	} else if (!strncmp(line, "info=r_stats ", sizeof("info=r_stats ") - 1)) {
+		(void) sscanf(line, "info=r_stats name=%64s type=%3s", r_name, r_type);
+		if (!strcmp(r_type, "lv"))
+			printf("  LV %s retries %llu\n", r_name, retries);
+		else
+			printf("  %s retries %llu\n", !strcmp(r_type, "gl") ? "GL" : "VG", retries);
+	} else
+		return;
+
+	/* the leading space keeps a key from matching the end of another */
+	format_stats_time(line, " wait=");
+	format_stats_time(line, " hold=");
+	format_stats_time(line, " lm=");
+}
+
+static void format_stats(void)
+{
+	char line[MAX_LINE] = { 0 };
+	int i, j;
+
+	printf("lock times in usec, hist buckets <1ms <10ms <100ms <1s <10s >=10s\n");
+
+	j = 0;
+
+	for (i = 0; i < dump_len; i++) {
+		line[j++] = dump_buf[i];
+
+		if ((line[j-1] == '\n') || (line[j-1] == '\0') || (j == MAX_LINE - 1)) {
+			format_stats_line(line);
+			j = 0;
+			memset(line, 0, sizeof(line));
+		}
+	}
+}
+
 
 static daemon_reply _lvmlockd_send(const char *req_name, ...)
 {
@@ -459,8 +554,10 @@ retry:
 
 	dump_buf[count] = 0;
 	rv = 0;
-	if ((info && dump) || !strcmp(req_name, "dump"))
+	if (((info || stats) && dump) || !strcmp(req_name, "dump"))
 		printf("%s\n", dump_buf);
+	else if (stats)
+		format_stats();
 	else
 		format_info();
 out:
@@ -917,6 +1014,8 @@ static void print_usage(void)
 	printf("      Print lock state information from lvmlockd.\n");
 	printf("--dump | -d\n");
 	printf("      Print log buffer from lvmlockd.\n");
+	printf("--stats | -s\n");
+	printf("      Print lock wait, hold and lock manager times from lvmlockd.\n");
 	printf("--wait | -w 0|1\n");
 	printf("      Wait option for other commands.\n");
 	printf("--force | -f 0|1>\n");
@@ -945,6 +1044,7 @@ static int read_options(int argc, char *argv[])
 		{"quit",            no_argument,       0,  'q' },
 		{"info",            no_argument,       0,  'i' },
 		{"dump",            no_argument,       0,  'd' },
+		{"stats",           no_argument,       0,  's' },
 		{"wait",            required_argument, 0,  'w' },
 		{"force",           required_argument, 0,  'f' },
 		{"kill",            required_argument, 0,  'k' },
@@ -962,7 +1062,7 @@ static int read_options(int argc, char *argv[])
 	}
 
 	while (1) {
-		c = getopt_long(argc, argv, "hqidE:D:w:k:r:Se", _long_options, &option_index);
+		c = getopt_long(argc, argv, "hqidsE:D:w:k:r:Se", _long_options, &option_index);
 		if (c == -1)
 			break;
 
@@ -983,6 +1083,10 @@ static int read_options(int argc, char *argv[])
 			/* --dump */
 			dump = 1;
 			break;
+		case 's':
+			/* --stats */
+			stats = 1;
+			break;
 		case 'w':
 			wait_opt = atoi(optarg);
 			break;
@@ -1046,7 +1150,7 @@ int main(int argc, char **argv)
 		goto out;
 	}
 
-	if (info) {
+	if (info || stats) {
 		rv = do_dump("info");
 		goto out;
 	}
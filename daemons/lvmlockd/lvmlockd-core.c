@@ -212,6 +212,7 @@ static pthread_cond_t worker_cond;
 static struct list_head worker_list;    /* actions for worker_thread */
 static int worker_stop;                 /* stop the thread */
 static int worker_wake;                 /* wake the thread without adding work */
+static int worker_start_done;           /* a lockspace finished starting */
 
 /*
  * The content of every log_foo() statement is saved in the
@@ -221,9 +222,7 @@ static int worker_wake;                 /* wake the thread without adding work *
 #define LOG_DUMP_SIZE DUMP_BUF_SIZE
 #define LOG_SYSLOG_PRIO LOG_WARNING
 static char log_dump[LOG_DUMP_SIZE];
-static unsigned int log_point;
-static unsigned int log_wrap;
-static pthread_mutex_t log_mutex;
+static uint64_t log_total;	/* bytes ever saved, reserved atomically */
 static int syslog_priority = LOG_SYSLOG_PRIO;
 
 /*
@@ -316,35 +315,73 @@ static uint64_t monotime(void)
 	return ts.tv_sec;
 }
 
-static void log_save_line(int len, char *line,
-			  char *log_buf, unsigned int *point, unsigned int *wrap)
+static uint64_t monotime_us(void)
 {
-	unsigned int p = *point;
-	unsigned int w = *wrap;
-	int i;
+	struct timespec ts;
 
-	if (len < (int) (LOG_DUMP_SIZE - p)) {
-		memcpy(log_buf + p, line, len);
-		p += len;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
 
-		if (p == LOG_DUMP_SIZE) {
-			p = 0;
-			w = 1;
-		}
-		goto out;
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void time_stat_add(struct lock_time_stat *st, uint64_t us)
+{
+	uint64_t limit = 1000;
+	int i = 0;
+
+	st->count++;
+	st->total_us += us;
+	if (st->max_us < us)
+		st->max_us = us;
+
+	while ((i < LOCK_STAT_BUCKETS - 1) && (us >= limit)) {
+		limit *= 10;
+		i++;
 	}
+	st->hist[i]++;
+}
 
-	for (i = 0; i < len; i++) {
-		log_buf[p++] = line[i];
+/*
+ * Only the lockspace thread changes the stats of its resources
+ * and of the lockspace itself.
+ */
+static void lm_time_add(struct lockspace *ls, struct resource *r,
+			struct action *act, uint64_t start_us, int rv)
+{
+	uint64_t us = monotime_us() - start_us;
 
-		if (p == LOG_DUMP_SIZE) {
-			p = 0;
-			w = 1;
-		}
+	time_stat_add(&r->stats.lm, us);
+	time_stat_add(&ls->stats.lm, us);
+
+	if (rv == -EAGAIN) {
+		r->stats.retries++;
+		ls->stats.retries++;
+	}
+
+	if (act)
+		act->lm_us += us;
+}
+
+/*
+ * Writers reserve their range of the buffer with a single atomic add
+ * and copy into it without a lock, so threads logging at the same time
+ * do not serialize on each other.  A dump taken while a line is being
+ * copied, or while the oldest data is being overwritten, may show that
+ * line partially; the log is for debugging, so that is accepted.
+ */
+static void log_save_line(int len, char *line)
+{
+	uint64_t start = __atomic_fetch_add(&log_total, len, __ATOMIC_RELAXED);
+	unsigned int p = start % LOG_DUMP_SIZE;
+	unsigned int tail_len = LOG_DUMP_SIZE - p;
+
+	if ((unsigned int) len <= tail_len)
+		memcpy(log_dump + p, line, len);
+	else {
+		memcpy(log_dump + p, line, tail_len);
+		memcpy(log_dump, line + tail_len, len - tail_len);
 	}
- out:
-	*point = p;
-	*wrap = w;
 }
 
 void log_level(int level, const char *fmt, ...)
@@ -354,8 +391,6 @@ void log_level(int level, const char *fmt, ...)
 	int len = LOG_LINE_SIZE - 1;
 	int ret, pos = 0;
 
-	memset(line, 0, sizeof(line));
-
 	ret = snprintf(line, len, "%llu ", (unsigned long long)time(NULL));
 	pos += ret;
 
@@ -371,9 +406,7 @@ void log_level(int level, const char *fmt, ...)
 	line[pos++] = '\n';
 	line[pos++] = '\0';
 
-	pthread_mutex_lock(&log_mutex);
-	log_save_line(pos - 1, line, log_dump, &log_point, &log_wrap);
-	pthread_mutex_unlock(&log_mutex);
+	log_save_line(pos - 1, line);
 
 	if (level <= syslog_priority)
 		syslog(level, "%s", line);
@@ -384,10 +417,11 @@ void log_level(int level, const char *fmt, ...)
 
 static int dump_log(int *dump_len)
 {
+	uint64_t total = __atomic_load_n(&log_total, __ATOMIC_RELAXED);
+	unsigned int log_point = total % LOG_DUMP_SIZE;
+	int log_wrap = (total >= LOG_DUMP_SIZE);
 	int tail_len;
 
-	pthread_mutex_lock(&log_mutex);
-
 	if (!log_wrap && !log_point) {
 		*dump_len = 0;
 	} else if (log_wrap) {
@@ -400,7 +434,6 @@ static int dump_log(int *dump_len)
 		memcpy(dump_buf, log_dump, log_point-1);
 		*dump_len = log_point-1;
 	}
-	pthread_mutex_unlock(&log_mutex);
 
 	return 0;
 }
@@ -1101,6 +1134,7 @@ static int lm_rem_lockspace(struct lockspace *ls, struct action *act, int free_v
 static int lm_lock(struct lockspace *ls, struct resource *r, int mode, struct action *act,
 		   struct val_blk *vb_out, int *retry, int adopt_only, int adopt_ok)
 {
+	uint64_t start_us = monotime_us();
 	int rv;
 
 	if (ls->lm_type == LD_LM_DLM)
@@ -1113,6 +1147,8 @@ static int lm_lock(struct lockspace *ls, struct resource *r, int mode, struct ac
 	else
 		return -1;
 
+	lm_time_add(ls, r, act, start_us, rv);
+
 	if (act)
 		act->lm_rv = rv;
 	return rv;
@@ -1121,6 +1157,7 @@ static int lm_lock(struct lockspace *ls, struct resource *r, int mode, struct ac
 static int lm_convert(struct lockspace *ls, struct resource *r,
 		      int mode, struct action *act, uint32_t r_version)
 {
+	uint64_t start_us = monotime_us();
 	int rv;
 
 	if (ls->lm_type == LD_LM_DLM)
@@ -1132,6 +1169,8 @@ static int lm_convert(struct lockspace *ls, struct resource *r,
 	else
 		return -1;
 
+	lm_time_add(ls, r, act, start_us, rv);
+
 	if (act)
 		act->lm_rv = rv;
 	return rv;
@@ -1140,6 +1179,7 @@ static int lm_convert(struct lockspace *ls, struct resource *r,
 static int lm_unlock(struct lockspace *ls, struct resource *r, struct action *act,
 		     uint32_t r_version, uint32_t lmu_flags)
 {
+	uint64_t start_us = monotime_us();
 	int rv;
 
 	if (ls->lm_type == LD_LM_DLM)
@@ -1151,6 +1191,8 @@ static int lm_unlock(struct lockspace *ls, struct resource *r, struct action *ac
 	else
 		return -1;
 
+	lm_time_add(ls, r, act, start_us, rv);
+
 	if (act)
 		act->lm_rv = rv;
 	return rv;
@@ -1512,6 +1554,8 @@ static int res_lock(struct lockspace *ls, struct resource *r, struct action *act
 	 */
 
 	r->mode = act->mode;
+	if (!r->hold_start_us)
+		r->hold_start_us = monotime_us();
 
 add_lk:
 	if (r->mode == LD_LK_SH)
@@ -1550,6 +1594,13 @@ add_lk:
 
 	list_add_tail(&lk->list, &r->locks);
 
+	if (act->start_us) {
+		uint64_t us = monotime_us() - act->start_us;
+
+		time_stat_add(&r->stats.wait, us);
+		time_stat_add(&ls->stats.wait, us);
+	}
+
 	return rv;
 }
 
@@ -1710,7 +1761,12 @@ do_unlock:
 	else
 		log_debug("%s:%s res_unlock cl %u", ls->name, r->name, act->client_id);
 
-	/* send unlock to lm when last sh lock is unlocked */
+	/*
+	 * send unlock to lm when last sh lock is unlocked
+	 * (the lm lock is not kept cached past the last holder: r->mode
+	 * must track what lm holds, and a cached sh lock would block ex
+	 * requests from other hosts with no way to recall it.)
+	 */
 	if (lk->mode == LD_LK_SH) {
 		r->sh_count--;
 		if (r->sh_count > 0) {
@@ -1751,9 +1807,18 @@ rem_lk:
 	list_del(&lk->list);
 	free_lock(lk);
 
-	if (list_empty(&r->locks))
+	if (list_empty(&r->locks)) {
 		r->mode = LD_LK_UN;
 
+		if (r->hold_start_us) {
+			uint64_t us = monotime_us() - r->hold_start_us;
+
+			time_stat_add(&r->stats.hold, us);
+			time_stat_add(&ls->stats.hold, us);
+			r->hold_start_us = 0;
+		}
+	}
+
 	return 0;
 }
 
@@ -2568,8 +2633,19 @@ static void *lockspace_thread_main(void *arg_in)
 	} else {
 		ls->create_done = 1;
 	}
+	ls->create_time = monotime();
 	pthread_mutex_unlock(&ls->mutex);
 
+	log_debug("S %s start took %llu sec", ls->name,
+		  (unsigned long long)(ls->create_time - ls->start_time));
+
+	/* let a pending START_WAIT see this right away */
+	pthread_mutex_lock(&worker_mutex);
+	worker_wake = 1;
+	worker_start_done = 1;
+	pthread_cond_signal(&worker_cond);
+	pthread_mutex_unlock(&worker_mutex);
+
 	if (error)
 		goto out_act;
 
@@ -2763,6 +2839,12 @@ static void *lockspace_thread_main(void *arg_in)
 		/*
 		 * Process the lock operations that have been queued for each
 		 * resource.
+		 *
+		 * This is serial per lockspace: lm_lock() for one resource
+		 * blocks the others.  Spreading resources over worker threads
+		 * would need ls->resources, act_close handling and the lm_*
+		 * per-lockspace state (sanlock host/lease, dlm lockspace) to
+		 * be made safe for concurrent callers first.
 		 */
 
 		retry = 0;
@@ -3037,6 +3119,7 @@ static int add_lockspace_thread(const char *ls_name,
 
 	strncpy(ls->name, ls_name, MAX_NAME);
 	ls->lm_type = lm_type;
+	ls->start_time = monotime();
 
 	if (act) {
 		ls->start_client_id = act->client_id;
@@ -3623,6 +3706,7 @@ static int work_init_lv(struct action *act)
 	char vg_args[MAX_ARGS+1];
 	char lv_args[MAX_ARGS+1];
 	uint64_t free_offset = 0;
+	uint64_t init_offset = 0;
 	int sector_size = 0;
 	int align_size = 0;
 	int lm_type = 0;
@@ -3658,7 +3742,21 @@ static int work_init_lv(struct action *act)
 
 	if (lm_type == LD_LM_SANLOCK) {
 		rv = lm_init_lv_sanlock(ls_name, act->vg_name, act->lv_uuid,
-					vg_args, lv_args, sector_size, align_size, free_offset);
+					vg_args, lv_args, sector_size, align_size, free_offset,
+					&init_offset);
+
+		/*
+		 * The slot just written is no longer free; point the next
+		 * find_free_lock search at the following slot instead of
+		 * having it read this one again.
+		 */
+		if (!rv && init_offset && align_size) {
+			pthread_mutex_lock(&lockspaces_mutex);
+			if ((ls = find_lockspace_name(ls_name)) &&
+			    (ls->free_lock_offset == init_offset))
+				ls->free_lock_offset = init_offset + align_size;
+			pthread_mutex_unlock(&lockspaces_mutex);
+		}
 
 		memcpy(act->lv_args, lv_args, MAX_ARGS);
 		return rv;
@@ -3690,6 +3788,7 @@ static void *worker_thread_main(void *arg_in)
 	struct action *act, *safe;
 	uint64_t last_delayed_time = 0;
 	int delay_sec = LONG_DELAY_PERIOD;
+	int start_done;
 	int rv;
 
 	INIT_LIST_HEAD(&delayed_list);
@@ -3708,6 +3807,8 @@ static void *worker_thread_main(void *arg_in)
 			rv = pthread_cond_timedwait(&worker_cond, &worker_mutex, &ts);
 		}
 		worker_wake = 0;
+		start_done = worker_start_done;
+		worker_start_done = 0;
 
 		if (worker_stop) {
 			pthread_mutex_unlock(&worker_mutex);
@@ -3818,8 +3919,24 @@ static void *worker_thread_main(void *arg_in)
 		/*
 		 * We may want to track retry times per action so that
 		 * we can delay different actions by different amounts.
+		 *
+		 * A START_WAIT is checked as soon as a lockspace finishes
+		 * starting, so waiting for many lockspaces started together
+		 * returns when the last one is done, not up to a delay later.
 		 */
 
+		if (start_done) {
+			list_for_each_entry_safe(act, safe, &delayed_list, list) {
+				if (act->op != LD_OP_START_WAIT)
+					continue;
+				act->result = count_lockspace_starting(0);
+				if (!act->result) {
+					list_del(&act->list);
+					add_client_result(act);
+				}
+			}
+		}
+
 		if (monotime() - last_delayed_time < SHORT_DELAY_PERIOD) {
 			delay_sec = 1;
 			continue;
@@ -4140,7 +4257,10 @@ static int client_send_result(struct client *cl, struct action *act)
 	} else {
 		/*
 		 * A normal reply.
+		 * wait_us/lm_us let the command add the time the request
+		 * spent in lvmlockd and in the lock manager to LVM_TIMING.
 		 */
+		uint64_t wait_us = act->start_us ? monotime_us() - act->start_us : 0;
 
 		log_debug("send %s[%d] cl %u %s %s rv %d %s %s",
 			  cl->name[0] ? cl->name : "client", cl->pid, cl->id,
@@ -4153,6 +4273,8 @@ static int client_send_result(struct client *cl, struct action *act)
 					  "op_result = " FMTd64, (int64_t) act->result,
 					  "lm_result = " FMTd64, (int64_t) act->lm_rv,
 					  "result_flags = %s", result_flags[0] ? result_flags : "none",
+					  "wait_us = " FMTd64, (int64_t) wait_us,
+					  "lm_us = " FMTd64, (int64_t) act->lm_us,
 					  NULL);
 	}
 
@@ -4678,7 +4800,8 @@ static int print_lockspace(struct lockspace *ls, const char *prefix, int pos, in
 			"thread_done=%d "
 			"kill_vg=%d "
 			"drop_vg=%d "
-			"sanlock_gl_enabled=%d\n",
+			"sanlock_gl_enabled=%d "
+			"start_sec=%llu\n",
 			prefix,
 			ls->name,
 			ls->vg_name,
@@ -4694,7 +4817,8 @@ static int print_lockspace(struct lockspace *ls, const char *prefix, int pos, in
 			ls->thread_done ? 1 : 0,
 			ls->kill_vg,
 			ls->drop_vg,
-			ls->sanlock_gl_enabled ? 1 : 0);
+			ls->sanlock_gl_enabled ? 1 : 0,
+			(unsigned long long)((ls->create_time ? ls->create_time : monotime()) - ls->start_time));
 }
 
 static int print_action(struct action *act, const char *prefix, int pos, int len)
@@ -4754,6 +4878,53 @@ static int print_lock(struct lock *lk, const char *prefix, int pos, int len)
 			lk->client_id);
 }
 
+/* count/total_us/max_us/hist */
+#define TIME_STAT_FMT "%llu/%llu/%llu/%u,%u,%u,%u,%u,%u"
+#define TIME_STAT_ARGS(st) \
+	(unsigned long long)(st).count, \
+	(unsigned long long)(st).total_us, \
+	(unsigned long long)(st).max_us, \
+	(st).hist[0], (st).hist[1], (st).hist[2], \
+	(st).hist[3], (st).hist[4], (st).hist[5]
+
+static int print_lockspace_stats(struct lockspace *ls, const char *prefix, int pos, int len)
+{
+	return snprintf(dump_buf + pos, len - pos,
+			"info=%s "
+			"ls_name=%s "
+			"vg_name=%s "
+			"wait=" TIME_STAT_FMT " "
+			"hold=" TIME_STAT_FMT " "
+			"lm=" TIME_STAT_FMT " "
+			"retries=%llu\n",
+			prefix,
+			ls->name,
+			ls->vg_name,
+			TIME_STAT_ARGS(ls->stats.wait),
+			TIME_STAT_ARGS(ls->stats.hold),
+			TIME_STAT_ARGS(ls->stats.lm),
+			(unsigned long long)ls->stats.retries);
+}
+
+static int print_resource_stats(struct resource *r, const char *prefix, int pos, int len)
+{
+	return snprintf(dump_buf + pos, len - pos,
+			"info=%s "
+			"name=%s "
+			"type=%s "
+			"wait=" TIME_STAT_FMT " "
+			"hold=" TIME_STAT_FMT " "
+			"lm=" TIME_STAT_FMT " "
+			"retries=%llu\n",
+			prefix,
+			r->name,
+			rt_str(r->type),
+			TIME_STAT_ARGS(r->stats.wait),
+			TIME_STAT_ARGS(r->stats.hold),
+			TIME_STAT_ARGS(r->stats.lm),
+			(unsigned long long)r->stats.retries);
+}
+
 static int dump_info(int *dump_len)
 {
 	struct client *cl;
@@ -4764,7 +4935,6 @@ static int dump_info(int *dump_len)
 	int len, pos, ret;
 	int rv = 0;
 
-	memset(dump_buf, 0, sizeof(dump_buf));
 	len = sizeof(dump_buf);
 	pos = 0;
 
@@ -4817,6 +4987,13 @@ static int dump_info(int *dump_len)
 		}
 		pos += ret;
 
+		ret = print_lockspace_stats(ls, "ls_stats", pos, len);
+		if (ret >= len - pos) {
+			 rv = -ENOSPC;
+			 goto out;
+		}
+		pos += ret;
+
 		list_for_each_entry(act, &ls->actions, list) {
 			ret = print_action(act, "ls_action", pos, len);
 			if (ret >= len - pos) {
@@ -4834,6 +5011,16 @@ static int dump_info(int *dump_len)
 			}
 			pos += ret;
 
+			/* skip resources that were never locked */
+			if (r->stats.wait.count || r->stats.lm.count) {
+				ret = print_resource_stats(r, "r_stats", pos, len);
+				if (ret >= len - pos) {
+					rv = -ENOSPC;
+					goto out;
+				}
+				pos += ret;
+			}
+
 			list_for_each_entry(lk, &r->locks, list) {
 				ret = print_lock(lk, "lk", pos, len);
 				if (ret >= len - pos) {
@@ -4989,6 +5176,7 @@ static void client_recv_action(struct client *cl)
 	}
 
 	act->client_id = cl->id;
+	act->start_us = monotime_us();
 	act->op = op;
 	act->rt = rt;
 	act->mode = mode;
@@ -6193,7 +6381,6 @@ static int main_loop(daemon_state *ds_arg)
 	INIT_LIST_HEAD(&lockspaces);
 	pthread_mutex_init(&lockspaces_mutex, NULL);
 	pthread_mutex_init(&pollfd_mutex, NULL);
-	pthread_mutex_init(&log_mutex, NULL);
 
 	openlog("lvmlockd", LOG_CONS | LOG_PID, LOG_DAEMON);
 	log_warn("lvmlockd started");
@@ -126,6 +126,27 @@ struct pvs {
 	int num;
 };
 
+/*
+ * Lock timing kept per resource and per lockspace, printed by
+ * lvmlockctl --stats.  hist[] buckets are <1ms, <10ms, <100ms,
+ * <1s, <10s and longer.
+ */
+#define LOCK_STAT_BUCKETS 6
+
+struct lock_time_stat {
+	uint64_t count;
+	uint64_t total_us;
+	uint64_t max_us;
+	uint32_t hist[LOCK_STAT_BUCKETS];
+};
+
+struct lock_stats {
+	struct lock_time_stat wait;	/* request received until granted */
+	struct lock_time_stat hold;	/* first lock until last unlock */
+	struct lock_time_stat lm;	/* lock manager lock/convert/unlock calls */
+	uint64_t retries;		/* lock conflicts (-EAGAIN) from lm */
+};
+
 struct action {
 	struct list_head list;
 	uint32_t client_id;
@@ -140,6 +161,8 @@ struct action {
 	int max_retries;
 	int result;
 	int lm_rv;			/* return value from lm_ function */
+	uint64_t start_us;		/* monotime_us when received from client */
+	uint64_t lm_us;			/* time spent in lm_ functions */
 	char *path;
 	char vg_uuid[64];
 	char vg_name[MAX_NAME+1];
@@ -166,6 +189,8 @@ struct resource {
 	unsigned int use_vb : 1;
 	struct list_head locks;
 	struct list_head actions;
+	uint64_t hold_start_us;		/* monotime_us when mode left un */
+	struct lock_stats stats;
 	char lv_args[MAX_ARGS+1];
 	char lm_data[];			/* lock manager specific data */
 };
@@ -196,6 +221,8 @@ struct lockspace {
 	struct pvs pvs;			/* for idm: PV list */
 
 	uint32_t start_client_id;	/* client_id that started the lockspace */
+	uint64_t start_time;		/* monotime when start was requested */
+	uint64_t create_time;		/* monotime when start finished or failed */
 	pthread_t thread;		/* makes synchronous lock requests */
 	pthread_cond_t cond;
 	pthread_mutex_t mutex;
@@ -212,6 +239,7 @@ struct lockspace {
 
 	struct list_head actions;	/* new client actions */
 	struct list_head resources;	/* resource/lock state for gl/vg/lv */
+	struct lock_stats stats;	/* all resources, including freed ones */
 };
 
 /* val_blk version */
@@ -506,7 +534,7 @@ static inline int lm_refresh_lv_check_dlm(struct action *act)
 #ifdef LOCKDSANLOCK_SUPPORT
 
 int lm_init_vg_sanlock(char *ls_name, char *vg_name, uint32_t flags, char *vg_args);
-int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name, char *vg_args, char *lv_args, int sector_size, int align_size, uint64_t free_offset);
+int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name, char *vg_args, char *lv_args, int sector_size, int align_size, uint64_t free_offset, uint64_t *init_offset);
 int lm_free_lv_sanlock(struct lockspace *ls, struct resource *r);
 int lm_rename_vg_sanlock(char *ls_name, char *vg_name, uint32_t flags, char *vg_args);
 int lm_prepare_lockspace_sanlock(struct lockspace *ls);
@@ -541,7 +569,7 @@ static inline int lm_init_vg_sanlock(char *ls_name, char *vg_name, uint32_t flag
 	return -1;
 }
 
-static inline int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name, char *vg_args, char *lv_args, int sector_size, int align_size, uint64_t free_offset)
+static inline int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name, char *vg_args, char *lv_args, int sector_size, int align_size, uint64_t free_offset, uint64_t *init_offset)
 {
 	return -1;
 }
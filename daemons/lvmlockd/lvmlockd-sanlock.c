@@ -688,7 +688,8 @@ int lm_init_vg_sanlock(char *ls_name, char *vg_name, uint32_t flags, char *vg_ar
 
 int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name,
 		       char *vg_args, char *lv_args,
-		       int sector_size, int align_size, uint64_t free_offset)
+		       int sector_size, int align_size, uint64_t free_offset,
+		       uint64_t *init_offset)
 {
 	struct sanlk_resourced rd;
 	char lock_lv_name[MAX_ARGS+1];
@@ -802,6 +803,7 @@ int lm_init_lv_sanlock(char *ls_name, char *vg_name, char *lv_name,
 			if (!rv) {
 				snprintf(lv_args, MAX_ARGS, "%s:%llu",
 				         lock_args_version, (unsigned long long)offset);
+				*init_offset = offset;
 			} else {
 				log_error("S %s init_lv_san write error %d offset %llu",
 					  ls_name, rv, (unsigned long long)rv);
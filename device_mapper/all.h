@@ -419,6 +419,7 @@ struct dm_status_integrity {
 	uint64_t number_of_mismatches;
 	uint64_t provided_data_sectors;
 	uint64_t recalc_sector;
+	unsigned recalculating:1;	/* recalc_sector is valid */
 };
 
 int dm_get_status_integrity(struct dm_pool *mem, const char *params,
@@ -610,6 +611,9 @@ void dm_lib_exit(void) __attribute__((destructor));
 /* An optimisation for clients making repeated calls involving dm ioctls */
 void dm_hold_control_dev(int hold_open);
 
+/* Number of dm ioctls issued so far, for cost reporting (LVM_TIMING). */
+unsigned dm_ioctl_count(void);
+
 /*
  * Use NULL for all devices.
  */
@@ -648,6 +652,17 @@ int dm_tree_add_dev(struct dm_tree *tree, uint32_t major, uint32_t minor);
 int dm_tree_add_dev_with_udev_flags(struct dm_tree *tree, uint32_t major,
 				    uint32_t minor, uint16_t udev_flags);
 
+/*
+ * Cache the info and dependencies of the devices found by dm_tree_add_dev()
+ * so that further trees reuse them instead of querying the kernel again.
+ * Cached devices are dropped when a task loads, resumes, suspends, renames,
+ * clears or removes them. Changes made by other processes are not seen, so
+ * the cache should only be used while those devices are locked.
+ * dm_tree_node_cache_use(0) disables the cache and drops its content.
+ */
+void dm_tree_node_cache_use(int use);
+void dm_tree_node_cache_destroy(void);
+
 /*
  * Add a new node to the tree if it doesn't already exist.
  */
@@ -1281,6 +1296,34 @@ int dm_pool_lock(struct dm_pool *p, int crc)
 int dm_pool_unlock(struct dm_pool *p, int crc)
 	__attribute__((__warn_unused_result__));
 
+/*
+ * Memory usage accounting.
+ * Each pool counts what was handed out of it and how much memory
+ * it holds in chunks.  Usage of destroyed pools is summed up by
+ * pool name, so short lived pools (e.g. per-VG) are accounted too.
+ */
+struct dm_pool_stats {
+	uint64_t alloc_bytes;		/* Bytes allocated including objects */
+	uint64_t objects;		/* Number of allocations and objects */
+	uint64_t chunks;		/* Number of chunks obtained by malloc */
+	uint64_t chunk_bytes;		/* Bytes currently held in chunks */
+	uint64_t chunk_bytes_max;	/* High-water mark of chunk_bytes */
+};
+
+void dm_pool_get_stats(const struct dm_pool *p, struct dm_pool_stats *stats);
+/* Log usage of existing pools and of destroyed pools by name */
+void dm_pools_dump_stats(void);
+
+/*
+ * Keep up to max_bytes of chunks released by dm_pool_free/dm_pool_empty
+ * in the pool for reuse instead of returning them to malloc, preferring
+ * the largest ones.  Useful for pools emptied repeatedly in long lived
+ * processes.  With DM_POOL_CACHE_HUGEPAGE chunks of 2MiB and more are
+ * backed by transparent huge pages where supported.
+ */
+#define DM_POOL_CACHE_HUGEPAGE	0x00000001
+void dm_pool_set_chunk_cache(struct dm_pool *p, size_t max_bytes, uint32_t flags);
+
 /*
  * Object building routines:
  *
@@ -1928,6 +1971,28 @@ void dm_report_destroy_rows(struct dm_report *rh);
 
 int dm_report_output(struct dm_report *rh);
 
+/*
+ * Instead of printing the report, call row_fn for each row to display,
+ * in sort order, with one value per displayed field in column order.
+ * number holds the raw value of NUMBER (and PERCENT, in DM_PERCENT_1
+ * units), SIZE (truncated) and TIME fields, otherwise 0.
+ * The values point into the report and are valid only until row_fn
+ * returns.  If row_fn returns 0, no further rows are passed.
+ */
+struct dm_report_field_value {
+	const char *id;		/* Field id */
+	const char *value;	/* Value as it would be displayed */
+	uint32_t type;		/* DM_REPORT_FIELD_TYPE_* */
+	uint64_t number;
+};
+
+typedef int (*dm_report_row_fn_t) (void *private,
+				   const struct dm_report_field_value *values,
+				   unsigned count);
+
+int dm_report_output_rows(struct dm_report *rh, dm_report_row_fn_t row_fn,
+			  void *private);
+
 /*
  * Output the report headings for a columns-based report, even if they
  * have already been shown. Useful for repeating reports that wish to
@@ -1945,6 +2010,13 @@ int dm_report_set_output_field_name_prefix(struct dm_report *rh,
 
 int dm_report_set_selection(struct dm_report *rh, const char *selection);
 
+/*
+ * If the selection only passes rows with the string field 'field_id'
+ * equal to some value, return that value, otherwise NULL.
+ * Lets callers skip objects which cannot be selected.
+ */
+const char *dm_report_selection_required_string(struct dm_report *rh, const char *field_id);
+
 /*
  * Report functions are provided for simple data types.
  * They take care of allocating copies of the data.
@@ -2034,6 +2106,7 @@ struct dm_config_tree *dm_config_create(void);
 struct dm_config_tree *dm_config_from_string(const char *config_settings);
 int dm_config_parse(struct dm_config_tree *cft, const char *start, const char *end);
 int dm_config_parse_without_dup_node_check(struct dm_config_tree *cft, const char *start, const char *end);
+int dm_config_parse_in_place(struct dm_config_tree *cft, char *start, char *end, int no_dup_node_check);
 
 void *dm_config_get_custom(struct dm_config_tree *cft);
 void dm_config_set_custom(struct dm_config_tree *cft, void *custom);
@@ -80,12 +80,14 @@ static struct dm_timestamp *_dm_ioctl_timestamp = NULL;
 static unsigned _dm_multiple_major_support = 1;
 static dm_bitset_t _dm_bitset = NULL;
 static uint32_t _dm_device_major = 0;
+/* Set when dm was not in PROC_DEVICES, until the control node is opened. */
+static int _dm_device_major_missing = 0;
 
 static int _control_fd = -1;
+static unsigned _ioctl_count = 0;
 static int _hold_control_fd_open = 0;
 static int _version_checked = 0;
 static int _version_ok = 1;
-static unsigned _ioctl_buffer_double_factor = 0;
 
 /* *INDENT-OFF* */
 static const struct cmd_data _cmd_data_v4[] = {
@@ -123,6 +125,12 @@ static const struct cmd_data _cmd_data_v4[] = {
 };
 /* *INDENT-ON* */
 
+/*
+ * Buffer growth remembered per task type.  A large DM_DEVICE_LIST must not
+ * make every following small INFO or DEPS ioctl allocate and copy its size.
+ */
+static unsigned _ioctl_buffer_double_factor[DM_ARRAY_SIZE(_cmd_data_v4)];
+
 #define ALIGNMENT 8
 
 /* FIXME Rejig library to record & use errno instead */
@@ -348,6 +356,10 @@ static int _create_dm_bitset(int require_module_loaded)
 	if (_dm_bitset || _dm_device_major)
 		return 1;
 
+	/* Don't reparse PROC_DEVICES for each device checked without dm-mod. */
+	if (!require_module_loaded && _dm_device_major_missing)
+		return 1;
+
 	if (!_uname())
 		return 0;
 
@@ -361,9 +373,10 @@ static int _create_dm_bitset(int require_module_loaded)
 		_dm_multiple_major_support = 0;
 
 	if (!_dm_multiple_major_support) {
-		if (!_get_proc_number(PROC_DEVICES, DM_NAME, &_dm_device_major,
-				      require_module_loaded))
+		if (!(r = _get_proc_number(PROC_DEVICES, DM_NAME, &_dm_device_major,
+					   require_module_loaded)))
 			return 0;
+		_dm_device_major_missing = (r == 2);
 		return 1;
 	}
 
@@ -375,6 +388,7 @@ static int _create_dm_bitset(int require_module_loaded)
 	if (!r || r == 2) {
 		dm_bitset_destroy(_dm_bitset);
 		_dm_bitset = NULL;
+		_dm_device_major_missing = (r == 2);
 		/*
 		 * It's not an error if we didn't find anything and we
 		 * didn't require module to be loaded at the same time.
@@ -2087,6 +2101,7 @@ static struct dm_ioctl *_do_dm_ioctl(struct dm_task *dmt, unsigned command,
 			     dmt->sector, _sanitise_message(dmt->message),
 			     dmi->data_size, retry_repeat_count);
 #ifdef DM_IOCTLS
+	_ioctl_count++;
 	r = ioctl(_control_fd, command, dmi);
 
 	if (dmt->record_timestamp)
@@ -2212,6 +2227,24 @@ int dm_task_run(struct dm_task *dmt)
 		return_0;
 	}
 
+	/* Cached dtree nodes of a changed device are no longer valid. */
+	switch (dmt->type) {
+	case DM_DEVICE_REMOVE_ALL:
+		tree_node_cache_invalidate(NULL, NULL, 0, 0);
+		break;
+	case DM_DEVICE_CREATE:
+	case DM_DEVICE_RELOAD:
+	case DM_DEVICE_REMOVE:
+	case DM_DEVICE_SUSPEND:
+	case DM_DEVICE_RESUME:
+	case DM_DEVICE_RENAME:
+	case DM_DEVICE_CLEAR:
+		tree_node_cache_invalidate(dev_name, dev_uuid, dmt->major, dmt->minor);
+		break;
+	default:
+		break;
+	}
+
 	if ((suspended_counter = dm_get_suspended_counter()) &&
 	    dmt->type == DM_DEVICE_RELOAD)
 		log_error(INTERNAL_ERROR "Performing unsafe table load while %d device(s) "
@@ -2230,7 +2263,7 @@ int dm_task_run(struct dm_task *dmt)
 
 	/* FIXME Detect and warn if cookie set but should not be. */
 repeat_ioctl:
-	if (!(dmi = _do_dm_ioctl(dmt, command, _ioctl_buffer_double_factor,
+	if (!(dmi = _do_dm_ioctl(dmt, command, _ioctl_buffer_double_factor[dmt->type],
 				 ioctl_retry, &retryable))) {
 		/*
 		 * Async udev rules that scan devices commonly cause transient
@@ -2257,7 +2290,7 @@ repeat_ioctl:
 		case DM_DEVICE_TABLE:
 		case DM_DEVICE_WAITEVENT:
 		case DM_DEVICE_TARGET_MSG:
-			_ioctl_buffer_double_factor++;
+			_ioctl_buffer_double_factor[dmt->type]++;
 			_dm_zfree_dmi(dmi);
 			goto repeat_ioctl;
 		default:
@@ -2343,6 +2376,11 @@ void dm_hold_control_dev(int hold_open)
 		  _hold_control_fd_open ? "" : "un");
 }
 
+unsigned dm_ioctl_count(void)
+{
+	return _ioctl_count;
+}
+
 void dm_lib_release(void)
 {
 	if (!_hold_control_fd_open)
@@ -2370,6 +2408,7 @@ void dm_lib_exit(void)
 	if (_dm_bitset)
 		dm_bitset_destroy(_dm_bitset);
 	_dm_bitset = NULL;
+	_dm_device_major_missing = 0;
 	dm_pools_check_leaks();
 	_version_ok = 1;
 	_version_checked = 0;
@@ -51,6 +51,10 @@ void selinux_release(void);
 void inc_suspended(void);
 void dec_suspended(void);
 
+/* Drop cached dtree nodes of a device about to be changed. */
+void tree_node_cache_invalidate(const char *name, const char *uuid,
+				int major, int minor);
+
 int parse_thin_pool_status(const char *params, struct dm_status_thin_pool *s);
 
 int get_uname_version(unsigned *major, unsigned *minor, unsigned *release);
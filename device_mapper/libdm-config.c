@@ -51,8 +51,11 @@ struct parser {
 
 	struct dm_pool *mem;
 	int no_dup_node_check;	/* whether to disable dup node checking */
+	int in_place;		/* strings are terminated in the parsed buffer */
+	char *nul;		/* in place: terminate the last token here */
 	const char *key;        /* last obtained key */
 	unsigned ignored_creation_time;
+	struct dm_hash_table *children;	/* key indexes of wide sections */
 };
 
 struct config_output {
@@ -171,7 +174,8 @@ static struct dm_config_node *_config_reverse(struct dm_config_node *head)
 	return middle;
 }
 
-static int _do_dm_config_parse(struct dm_config_tree *cft, const char *start, const char *end, int no_dup_node_check)
+static int _do_dm_config_parse(struct dm_config_tree *cft, const char *start, const char *end,
+			       int no_dup_node_check, int in_place)
 {
 	/* TODO? if (start == end) return 1; */
 
@@ -182,26 +186,48 @@ static int _do_dm_config_parse(struct dm_config_tree *cft, const char *start, co
 		.fb = start,
 		.fe = end,
 		.line = 1,
-		.no_dup_node_check = no_dup_node_check
+		.no_dup_node_check = no_dup_node_check,
+		.in_place = in_place
 	};
 
+	struct dm_hash_node *hn;
+	int r = 0;
+
 	_get_token(&p, TOK_SECTION_E);
 	if (!(cft->root = _file(&p)))
-		return_0;
+		goto_out;
 
 	cft->root = _config_reverse(cft->root);
+	r = 1;
+out:
+	if (p.children) {
+		dm_hash_iterate(hn, p.children)
+			dm_hash_destroy(dm_hash_get_data(p.children, hn));
+		dm_hash_destroy(p.children);
+	}
 
-	return 1;
+	return r;
 }
 
 int dm_config_parse(struct dm_config_tree *cft, const char *start, const char *end)
 {
-	return _do_dm_config_parse(cft, start, end, 0);
+	return _do_dm_config_parse(cft, start, end, 0, 0);
 }
 
 int dm_config_parse_without_dup_node_check(struct dm_config_tree *cft, const char *start, const char *end)
 {
-	return _do_dm_config_parse(cft, start, end, 1);
+	return _do_dm_config_parse(cft, start, end, 1, 0);
+}
+
+/*
+ * Node keys and string values point into the buffer, which is modified
+ * to terminate them, so it must stay unchanged for the lifetime of cft.
+ * *end must be writable.
+ */
+int dm_config_parse_in_place(struct dm_config_tree *cft, char *start, char *end,
+			     int no_dup_node_check)
+{
+	return _do_dm_config_parse(cft, start, end, no_dup_node_check, 1);
 }
 
 struct dm_config_tree *dm_config_from_string(const char *config_settings)
@@ -467,6 +493,21 @@ int dm_config_write_node_out(const struct dm_config_node *cn,
 /*
  * parser
  */
+
+/*
+ * An in place token is terminated after the tokenizer has moved past
+ * the character following it.  _dup_tok only leaves tokens followed by
+ * a character that is consumed with the token, whitespace, a comment
+ * or a single character token, which the parser does not read again.
+ */
+static void _terminate_in_place_tok(struct parser *p)
+{
+	if (p->nul) {
+		*p->nul = '\0';
+		p->nul = NULL;
+	}
+}
+
 static char *_dup_string_tok(struct parser *p)
 {
 	char *str;
@@ -483,6 +524,9 @@ static char *_dup_string_tok(struct parser *p)
 	if (!(str = _dup_tok(p)))
 		return_NULL;
 
+	/* The closing quote is already consumed, so it can be replaced now. */
+	_terminate_in_place_tok(p);
+
 	p->te++;
 
 	return str;
@@ -499,6 +543,23 @@ static struct dm_config_node *_file(struct parser *p)
 	return root.child;
 }
 
+static struct dm_config_node *_make_node_with_key(struct dm_pool *mem, const char *key,
+						  struct dm_config_node *parent)
+{
+	struct dm_config_node *n;
+
+	if (!(n = _create_node(mem)))
+		return_NULL;
+
+	n->key = key;
+	if (parent) {
+		n->parent = parent;
+		n->sib = parent->child;
+		parent->child = n;
+	}
+	return n;
+}
+
 static struct dm_config_node *_make_node(struct dm_pool *mem,
 					 const char *key_b, const char *key_e,
 					 struct dm_config_node *parent)
@@ -571,6 +632,113 @@ static struct dm_config_node *_find_or_make_node(struct dm_pool *mem,
 	return NULL;
 }
 
+/*
+ * Sections are parsed one child after another, so checking each new key
+ * against its siblings goes quadratic on wide sections, e.g. a few
+ * thousand LVs.  Once a section has CHILD_INDEX_MIN children, its keys
+ * get indexed for the rest of the parse.  Only the parser links nodes
+ * until it returns, so the index stays complete, and with the duplicate
+ * check each key is there at most once.
+ */
+#define CHILD_INDEX_MIN 32
+
+static int _index_children(struct parser *p, struct dm_config_node *parent)
+{
+	struct dm_hash_table *index;
+	struct dm_config_node *cn;
+
+	if (!p->children && !(p->children = dm_hash_create(32)))
+		return_0;
+
+	if (!(index = dm_hash_create(4 * CHILD_INDEX_MIN)))
+		return_0;
+
+	for (cn = parent->child; cn; cn = cn->sib)
+		if (!dm_hash_insert_binary(index, cn->key, strlen(cn->key), cn))
+			goto_bad;
+
+	if (!dm_hash_insert_binary(p->children, &parent, sizeof(parent), index))
+		goto_bad;
+
+	return 1;
+bad:
+	dm_hash_destroy(index);
+
+	return 0;
+}
+
+static struct dm_config_node *_find_child(struct parser *p,
+					  struct dm_config_node *parent,
+					  const char *b, const char *e)
+{
+	struct dm_hash_table *index;
+	struct dm_config_node *cn;
+	unsigned count = 0;
+
+	if (p->children &&
+	    (index = dm_hash_lookup_binary(p->children, &parent, sizeof(parent))))
+		return dm_hash_lookup_binary(index, b, e - b);
+
+	for (cn = parent->child; cn; cn = cn->sib, count++)
+		if (_tok_match(cn->key, b, e))
+			return cn;
+
+	/* Without the index the siblings are just searched again. */
+	if (count >= CHILD_INDEX_MIN && !_index_children(p, parent))
+		stack;
+
+	return NULL;
+}
+
+static struct dm_config_node *_add_child(struct parser *p,
+					 struct dm_config_node *parent,
+					 const char *b, const char *e)
+{
+	struct dm_hash_table *index;
+	struct dm_config_node *cn;
+
+	/* The last path segment is terminated, use it as the key. */
+	if (!(cn = *e ? _make_node(p->mem, b, e, parent) :
+	      _make_node_with_key(p->mem, b, parent)))
+		return_NULL;
+
+	if (p->children &&
+	    (index = dm_hash_lookup_binary(p->children, &parent, sizeof(parent))) &&
+	    !dm_hash_insert_binary(index, cn->key, strlen(cn->key), cn))
+		return_NULL;
+
+	return cn;
+}
+
+/* _find_or_make_node() for the parser with the duplicate node check */
+static struct dm_config_node *_find_or_make_section(struct parser *p,
+						    struct dm_config_node *parent,
+						    const char *path)
+{
+	const int sep = '/';
+	struct dm_config_node *cn;
+	const char *e;
+
+	for (;;) {
+		/* trim any leading slashes */
+		while (*path && (*path == sep))
+			path++;
+
+		/* find the end of this segment */
+		for (e = path; *e && (*e != sep); e++) ;
+
+		if (!(cn = _find_child(p, parent, path, e)) &&
+		    !(cn = _add_child(p, parent, path, e)))
+			return_NULL;
+
+		if (!*e)
+			return cn;
+
+		parent = cn;
+		path = e;
+	}
+}
+
 static struct dm_config_node *_section(struct parser *p, struct dm_config_node *parent)
 {
 	/* IDENTIFIER SECTION_B_CHAR VALUE* SECTION_E_CHAR */
@@ -603,7 +771,14 @@ static struct dm_config_node *_section(struct parser *p, struct dm_config_node *
 		return NULL;
 	}
 
-	if (!(root = _find_or_make_node(p->mem, parent, str, p->no_dup_node_check)))
+	if (!p->no_dup_node_check) {
+		if (!(root = _find_or_make_section(p, parent, str)))
+			return_NULL;
+	} else if (p->in_place && !strchr(str, '/')) {
+		/* Use the key in the buffer for a new node. */
+		if (!(root = _make_node_with_key(p->mem, str, parent)))
+			return_NULL;
+	} else if (!(root = _find_or_make_node(p->mem, parent, str, 1)))
 		return_NULL;
 
 	if (p->t == TOK_SECTION_B) {
@@ -767,6 +942,7 @@ static void _get_token(struct parser *p, int tok_prev)
 	_eat_space(p);
 	if (p->tb == p->fe || !*p->tb) {
 		p->t = TOK_EOF;
+		_terminate_in_place_tok(p);
 		return;
 	}
 
@@ -878,6 +1054,8 @@ static void _get_token(struct parser *p, int tok_prev)
 	}
 
 	p->te = te;
+
+	_terminate_in_place_tok(p);
 }
 
 static void _eat_space(struct parser *p)
@@ -928,7 +1106,34 @@ static char *_dup_token(struct dm_pool *mem, const char *b, const char *e)
 
 static char *_dup_tok(struct parser *p)
 {
+	if (p->in_place && !p->nul) {
+		if (p->te == p->fe)
+			goto in_place;
+
+		switch (*p->te) {
+		case '\0':
+		case '\'':
+		case '"':
+		case '#':
+		case SECTION_B_CHAR:
+		case SECTION_E_CHAR:
+		case '[':
+		case ']':
+		case ',':
+		case '=':
+			goto in_place;
+		default:
+			if (isspace(*p->te))
+				goto in_place;
+		}
+	}
+
 	return _dup_token(p->mem, p->tb, p->te);
+
+in_place:
+	p->nul = (char *) p->te;
+
+	return (char *) p->tb;
 }
 
 /*
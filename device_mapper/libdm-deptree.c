@@ -1211,6 +1211,173 @@ struct dm_tree_node *dm_tree_add_new_dev(struct dm_tree *dtree, const char *name
 						   read_only, clear_inactive, context, 0);
 }
 
+/*
+ * Cache of the info and dependencies of the devices discovered by
+ * _add_dev(), shared by all trees while enabled with
+ * dm_tree_node_cache_use(). An entry is dropped before any ioctl that
+ * may change the device together with the entries of the devices it
+ * uses, whose open_count is changed by it.
+ */
+struct node_cache_entry {
+	struct dm_info info;
+	const char *name;
+	const char *uuid;
+	struct dm_deps *deps;
+};
+
+static struct {
+	int use;
+	struct dm_hash_table *devs;
+	struct dm_hash_table *names;
+	struct dm_hash_table *uuids;
+} _node_cache;
+
+static void _node_cache_drop(struct node_cache_entry *entry)
+{
+	dev_t dev = MKDEV(entry->info.major, entry->info.minor);
+
+	dm_hash_remove_binary(_node_cache.devs, &dev, sizeof(dev));
+	dm_hash_remove(_node_cache.names, entry->name);
+	if (*entry->uuid)
+		dm_hash_remove(_node_cache.uuids, entry->uuid);
+	free(entry);
+}
+
+static void _node_cache_drop_with_deps(struct node_cache_entry *entry)
+{
+	struct node_cache_entry *dep;
+	uint32_t i;
+	dev_t dev;
+
+	for (i = 0; i < entry->deps->count; i++) {
+		dev = MKDEV(MAJOR(entry->deps->device[i]),
+			    MINOR(entry->deps->device[i]));
+		if ((dep = dm_hash_lookup_binary(_node_cache.devs, &dev, sizeof(dev))))
+			_node_cache_drop(dep);
+	}
+
+	_node_cache_drop(entry);
+}
+
+static struct node_cache_entry *_node_cache_get(uint32_t major, uint32_t minor)
+{
+	dev_t dev = MKDEV(major, minor);
+
+	if (!_node_cache.devs)
+		return NULL;
+
+	return dm_hash_lookup_binary(_node_cache.devs, &dev, sizeof(dev));
+}
+
+static void _node_cache_add(const struct dm_info *info, const char *name,
+			    const char *uuid, const struct dm_deps *deps)
+{
+	struct node_cache_entry *entry;
+	uint32_t count = deps ? deps->count : 0;
+	size_t name_len = strlen(name) + 1;
+	size_t uuid_len = strlen(uuid) + 1;
+	size_t deps_size = sizeof(*deps) + count * sizeof(deps->device[0]);
+	dev_t dev = MKDEV(info->major, info->minor);
+	char *buf;
+
+	if (!_node_cache.use || !info->exists)
+		return;
+
+	if (!_node_cache.devs) {
+		if (!(_node_cache.devs = dm_hash_create(1021)) ||
+		    !(_node_cache.names = dm_hash_create(1021)) ||
+		    !(_node_cache.uuids = dm_hash_create(1021))) {
+			log_debug("Failed to create dtree node cache.");
+			dm_tree_node_cache_destroy();
+			return;
+		}
+	} else {
+		/* Drop any stale entry with the same identifiers. */
+		if ((entry = dm_hash_lookup_binary(_node_cache.devs, &dev, sizeof(dev))))
+			_node_cache_drop(entry);
+		if ((entry = dm_hash_lookup(_node_cache.names, name)))
+			_node_cache_drop(entry);
+		if (*uuid && (entry = dm_hash_lookup(_node_cache.uuids, uuid)))
+			_node_cache_drop(entry);
+	}
+
+	if (!(entry = malloc(sizeof(*entry) + deps_size + name_len + uuid_len))) {
+		log_debug("Failed to allocate dtree node cache entry.");
+		return;
+	}
+
+	entry->info = *info;
+	entry->deps = (struct dm_deps *)(entry + 1);
+	entry->deps->count = count;
+	entry->deps->filler = 0;
+	if (count)
+		memcpy(entry->deps->device, deps->device,
+		       count * sizeof(deps->device[0]));
+	buf = (char *) entry->deps + deps_size;
+	entry->name = memcpy(buf, name, name_len);
+	entry->uuid = memcpy(buf + name_len, uuid, uuid_len);
+
+	if (!dm_hash_insert_binary(_node_cache.devs, &dev, sizeof(dev), entry)) {
+		free(entry);
+		return;
+	}
+
+	if (!dm_hash_insert(_node_cache.names, entry->name, entry) ||
+	    (*entry->uuid && !dm_hash_insert(_node_cache.uuids, entry->uuid, entry))) {
+		log_debug("Failed to insert dtree node cache entry.");
+		_node_cache_drop(entry);
+	}
+}
+
+void tree_node_cache_invalidate(const char *name, const char *uuid,
+				   int major, int minor)
+{
+	struct node_cache_entry *entry;
+
+	if (!_node_cache.devs)
+		return;
+
+	if (!name && !uuid && (major <= 0)) {
+		dm_tree_node_cache_destroy();
+		return;
+	}
+
+	if ((major > 0) && (minor >= 0) &&
+	    (entry = _node_cache_get((uint32_t) major, (uint32_t) minor)))
+		_node_cache_drop_with_deps(entry);
+
+	if (name && *name && (entry = dm_hash_lookup(_node_cache.names, name)))
+		_node_cache_drop_with_deps(entry);
+
+	if (uuid && *uuid && (entry = dm_hash_lookup(_node_cache.uuids, uuid)))
+		_node_cache_drop_with_deps(entry);
+}
+
+void dm_tree_node_cache_destroy(void)
+{
+	struct dm_hash_node *n;
+
+	if (_node_cache.devs) {
+		dm_hash_iterate(n, _node_cache.devs)
+			free(dm_hash_get_data(_node_cache.devs, n));
+		dm_hash_destroy(_node_cache.devs);
+	}
+
+	if (_node_cache.names)
+		dm_hash_destroy(_node_cache.names);
+
+	if (_node_cache.uuids)
+		dm_hash_destroy(_node_cache.uuids);
+
+	_node_cache.devs = _node_cache.names = _node_cache.uuids = NULL;
+}
+
+void dm_tree_node_cache_use(int use)
+{
+	if (!(_node_cache.use = use ? 1 : 0))
+		dm_tree_node_cache_destroy();
+}
+
 static struct dm_tree_node *_add_dev(struct dm_tree *dtree,
 				     struct dm_tree_node *parent,
 				     uint32_t major, uint32_t minor,
@@ -1223,13 +1390,22 @@ static struct dm_tree_node *_add_dev(struct dm_tree *dtree,
 	const char *name = NULL;
 	const char *uuid = NULL;
 	struct dm_tree_node *node = NULL;
+	struct node_cache_entry *cached;
 	uint32_t i;
 	int new = 0;
 
 	/* Already in tree? */
 	if (!(node = _find_dm_tree_node(dtree, major, minor))) {
-		if (!_deps(&dmt, dtree->mem, major, minor, &name, &uuid, 0, &info, &deps))
-			return_NULL;
+		if ((cached = _node_cache_get(major, minor))) {
+			info = cached->info;
+			name = cached->name;
+			uuid = cached->uuid;
+			deps = cached->deps;
+		} else {
+			if (!_deps(&dmt, dtree->mem, major, minor, &name, &uuid, 0, &info, &deps))
+				return_NULL;
+			_node_cache_add(&info, name, uuid, deps);
+		}
 
 		if (!(node = _create_dm_tree_node(dtree, name, uuid, &info,
 						  NULL, udev_flags)))
@@ -2124,6 +2300,13 @@ int dm_tree_activate_children(struct dm_tree_node *dnode,
 				return_0;
 	}
 
+	/*
+	 * Siblings are resumed one after another.  Resuming independent
+	 * siblings from worker threads is not done: dm_task_run(), the udev
+	 * cookie, the suspended counter and the logging callbacks all use
+	 * unlocked library globals, and callers run this inside an mlocked
+	 * critical section where new thread stacks are not wanted.
+	 */
 	handle = NULL;
 	for (priority = 0; priority < 3; priority++) {
 		awaiting_peer_rename = 0;
@@ -28,6 +28,7 @@
 #define RH_HEADINGS_PRINTED	0x00000200
 #define RH_FIELD_CALC_NEEDED	0x00000400
 #define RH_ALREADY_REPORTED	0x00000800
+#define RH_JSON_STREAM		0x00001000
 
 struct selection {
 	struct dm_pool *mem;
@@ -78,6 +79,12 @@ struct dm_report {
 	struct dm_hash_table *value_cache;
 
 	struct report_group_item *group_item;
+
+	/*
+	 * Unbuffered JSON output prints each row as it is reported, one
+	 * row behind, so a separator can be added when the next one comes.
+	 */
+	char *json_stream_line;
 };
 
 struct dm_report_group {
@@ -1416,6 +1423,7 @@ void dm_report_free(struct dm_report *rh)
 	if (rh->value_cache)
 		dm_hash_destroy(rh->value_cache);
 	dm_pool_destroy(rh->mem);
+	free(rh->json_stream_line);
 	free(rh);
 }
 
@@ -4153,6 +4161,57 @@ static void _reset_field_props(struct dm_report *rh)
 	rh->flags |= RH_FIELD_CALC_NEEDED;
 }
 
+static const char *_selection_required_string(struct dm_report *rh,
+					      struct selection_node *sn,
+					      const char *field_id)
+{
+	struct selection_node *iter_n;
+	struct field_selection *fs;
+	const char *s;
+
+	if (sn->type & SEL_MODIFIER_NOT)
+		return NULL;
+
+	switch (sn->type & SEL_MASK) {
+		case SEL_ITEM:
+			fs = sn->selection.item;
+			if (fs->fp->implicit ||
+			    ((fs->flags & FLD_CMP_MASK) != FLD_CMP_EQUAL) ||
+			    ((fs->flags & DM_REPORT_FIELD_TYPE_MASK) != DM_REPORT_FIELD_TYPE_STRING) ||
+			    fs->value->next ||
+			    strcmp(rh->fields[fs->fp->field_num].id, field_id))
+				return NULL;
+			return fs->value->v.s;
+		case SEL_OR:
+			/* Parser wraps each (sub)expression, look through single item ORs. */
+			if (dm_list_size(&sn->selection.set) != 1)
+				return NULL;
+			/* fall through */
+		case SEL_AND:
+			dm_list_iterate_items(iter_n, &sn->selection.set)
+				if ((s = _selection_required_string(rh, iter_n, field_id)))
+					return s;
+	}
+
+	return NULL;
+}
+
+const char *dm_report_selection_required_string(struct dm_report *rh, const char *field_id)
+{
+	struct field_properties *fp;
+
+	if (!rh->selection || !rh->selection->selection_root)
+		return NULL;
+
+	/* With the selected field, unselected rows are reported too. */
+	dm_list_iterate_items(fp, &rh->field_props)
+		if (fp->implicit &&
+		    !strcmp(_implicit_report_fields[fp->field_num].id, SPECIAL_FIELD_SELECTED_ID))
+			return NULL;
+
+	return _selection_required_string(rh, rh->selection->selection_root, field_id);
+}
+
 int dm_report_set_selection(struct dm_report *rh, const char *selection)
 {
 	struct row *row;
@@ -4360,49 +4419,47 @@ int dm_report_column_headings(struct dm_report *rh)
 
 /*
  * Sort rows of data
+ *
+ * Rows are sorted through an array of entries holding the row and a copy
+ * of its sort values, so comparisons don't go through the row, field and
+ * field properties for every key.
  */
-static int _row_compare(const void *a, const void *b)
+#define SORT_KEY_NUMBER		0x00000001
+#define SORT_KEY_ASCENDING	0x00000002
+
+union sort_value {
+	uint64_t num;
+	const char *str;
+};
+
+struct sort_entry {
+	const uint32_t *key_flags;	/* SORT_KEY_*, shared by all entries */
+	uint32_t keys_count;
+	struct row *row;
+	union sort_value values[];	/* keys_count values */
+};
+
+static int _sort_entry_compare(const void *a, const void *b)
 {
-	const struct row *rowa = *(const struct row * const *) a;
-	const struct row *rowb = *(const struct row * const *) b;
-	const struct dm_report_field *sfa, *sfb;
+	const struct sort_entry *ea = (const struct sort_entry *) a;
+	const struct sort_entry *eb = (const struct sort_entry *) b;
 	uint32_t cnt;
+	int cmp;
 
-	for (cnt = 0; cnt < rowa->rh->keys_count; cnt++) {
-		sfa = (*rowa->sort_fields)[cnt];
-		sfb = (*rowb->sort_fields)[cnt];
-		if ((sfa->props->flags & DM_REPORT_FIELD_TYPE_NUMBER) ||
-		    (sfa->props->flags & DM_REPORT_FIELD_TYPE_SIZE) ||
-		    (sfa->props->flags & DM_REPORT_FIELD_TYPE_TIME)) {
-			const uint64_t numa =
-			    *(const uint64_t *) sfa->sort_value;
-			const uint64_t numb =
-			    *(const uint64_t *) sfb->sort_value;
-
-			if (numa == numb)
+	for (cnt = 0; cnt < ea->keys_count; cnt++) {
+		if (ea->key_flags[cnt] & SORT_KEY_NUMBER) {
+			if (ea->values[cnt].num == eb->values[cnt].num)
 				continue;
-
-			if (sfa->props->flags & FLD_ASCENDING) {
-				return (numa > numb) ? 1 : -1;
-			} else {	/* FLD_DESCENDING */
-				return (numa < numb) ? 1 : -1;
-			}
+			cmp = (ea->values[cnt].num > eb->values[cnt].num) ? 1 : -1;
 		} else {
 			/* DM_REPORT_FIELD_TYPE_STRING
 			 * DM_REPORT_FIELD_TYPE_STRING_LIST */
-			const char *stra = (const char *) sfa->sort_value;
-			const char *strb = (const char *) sfb->sort_value;
-			int cmp = strcmp(stra, strb);
-
-			if (!cmp)
+			if (!(cmp = strcmp(ea->values[cnt].str, eb->values[cnt].str)))
 				continue;
-
-			if (sfa->props->flags & FLD_ASCENDING) {
-				return (cmp > 0) ? 1 : -1;
-			} else {	/* FLD_DESCENDING */
-				return (cmp < 0) ? 1 : -1;
-			}
+			cmp = (cmp > 0) ? 1 : -1;
 		}
+
+		return (ea->key_flags[cnt] & SORT_KEY_ASCENDING) ? cmp : -cmp;	/* FLD_DESCENDING */
 	}
 
 	return 0;		/* Identical */
@@ -4410,25 +4467,59 @@ static int _row_compare(const void *a, const void *b)
 
 static int _sort_rows(struct dm_report *rh)
 {
-	struct row *(*rows)[];
-	uint32_t count = 0;
+	const size_t entry_size = sizeof(struct sort_entry) +
+				  rh->keys_count * sizeof(union sort_value);
+	const struct dm_report_field *sf;
+	struct sort_entry *entry;
+	uint32_t *key_flags;
+	uint32_t count, cnt, i;
+	char *entries;
 	struct row *row;
 
-	if (!(rows = dm_pool_alloc(rh->mem, sizeof(**rows) *
-				dm_list_size(&rh->rows)))) {
+	if (!(count = dm_list_size(&rh->rows)))
+		return 1;
+
+	if (!(key_flags = dm_pool_alloc(rh->mem, sizeof(*key_flags) * rh->keys_count)) ||
+	    !(entries = dm_pool_alloc(rh->mem, entry_size * count))) {
 		log_error("dm_report: sort array allocation failed");
 		return 0;
 	}
 
-	dm_list_iterate_items(row, &rh->rows)
-		(*rows)[count++] = row;
+	row = dm_list_item(dm_list_first(&rh->rows), struct row);
+	for (cnt = 0; cnt < rh->keys_count; cnt++) {
+		sf = (*row->sort_fields)[cnt];
+		key_flags[cnt] = 0;
+		if ((sf->props->flags & DM_REPORT_FIELD_TYPE_NUMBER) ||
+		    (sf->props->flags & DM_REPORT_FIELD_TYPE_SIZE) ||
+		    (sf->props->flags & DM_REPORT_FIELD_TYPE_TIME))
+			key_flags[cnt] |= SORT_KEY_NUMBER;
+		if (sf->props->flags & FLD_ASCENDING)
+			key_flags[cnt] |= SORT_KEY_ASCENDING;
+	}
+
+	i = 0;
+	dm_list_iterate_items(row, &rh->rows) {
+		entry = (struct sort_entry *) (entries + entry_size * i++);
+		entry->key_flags = key_flags;
+		entry->keys_count = rh->keys_count;
+		entry->row = row;
+		for (cnt = 0; cnt < rh->keys_count; cnt++) {
+			sf = (*row->sort_fields)[cnt];
+			if (key_flags[cnt] & SORT_KEY_NUMBER)
+				entry->values[cnt].num = *(const uint64_t *) sf->sort_value;
+			else
+				entry->values[cnt].str = (const char *) sf->sort_value;
+		}
+	}
 
-	qsort(rows, count, sizeof(**rows), _row_compare);
+	qsort(entries, count, entry_size, _sort_entry_compare);
 
 	dm_list_init(&rh->rows);
 
-	while (count > 0)
-		dm_list_add_h(&rh->rows, &(*rows)[--count]->list);
+	for (i = 0; i < count; i++)
+		dm_list_add(&rh->rows, &((struct sort_entry *) (entries + entry_size * i))->row->list);
+
+	dm_pool_free(rh->mem, key_flags);
 
 	return 1;
 }
@@ -4746,6 +4837,25 @@ static void _destroy_rows(struct dm_report *rh)
 	_reset_field_props(rh);
 }
 
+static int _json_stream_line(struct dm_report *rh, const char *line)
+{
+	int indent = rh->group_item->group->indent;
+
+	if (rh->json_stream_line) {
+		log_print("%*s%s", indent + (int) strlen(rh->json_stream_line),
+			  rh->json_stream_line, line ? JSON_SEPARATOR : "");
+		free(rh->json_stream_line);
+		rh->json_stream_line = NULL;
+	}
+
+	if (line && !(rh->json_stream_line = strdup(line))) {
+		log_error("dm_report: failed to store JSON output line");
+		return 0;
+	}
+
+	return 1;
+}
+
 static int _output_as_rows(struct dm_report *rh)
 {
 	const struct dm_report_field_type *fields;
@@ -4921,7 +5031,11 @@ static int _output_as_columns(struct dm_report *rh)
 		}
 
 		line = (char *) dm_pool_end_object(rh->mem);
-		log_print("%*s", rh->group_item ? rh->group_item->group->indent + (int) strlen(line) : 0, line);
+		if (rh->flags & RH_JSON_STREAM) {
+			if (!_json_stream_line(rh, line))
+				return_0;
+		} else
+			log_print("%*s", rh->group_item ? rh->group_item->group->indent + (int) strlen(line) : 0, line);
 		if (!(rh->flags & DM_REPORT_OUTPUT_MULTIPLE_TIMES))
 			dm_list_del(&row->list);
 	}
@@ -5005,6 +5119,10 @@ static int _prepare_json_report_output(struct dm_report *rh)
 	if (rh->group_item->output_done && dm_list_empty(&rh->rows))
 		return 1;
 
+	/* Streamed output already started the array with its first row. */
+	if ((rh->flags & RH_JSON_STREAM) && rh->group_item->needs_closing)
+		return 1;
+
 	/*
 	 * If this report is in JSON group, it must be at the
 	 * top of the stack of reports so the output from
@@ -5079,6 +5197,86 @@ out:
 	return r;
 }
 
+static uint64_t _field_number(const struct dm_report_field *field)
+{
+	if (!field->sort_value)
+		return 0;
+
+	switch (field->props->flags & DM_REPORT_FIELD_TYPE_MASK) {
+	case DM_REPORT_FIELD_TYPE_NUMBER:
+	case DM_REPORT_FIELD_TYPE_PERCENT:
+	case DM_REPORT_FIELD_TYPE_TIME:
+		return *(const uint64_t *) field->sort_value;
+	case DM_REPORT_FIELD_TYPE_SIZE:
+		return (uint64_t) *(const double *) field->sort_value;
+	}
+
+	return 0;
+}
+
+int dm_report_output_rows(struct dm_report *rh, dm_report_row_fn_t row_fn,
+			  void *private)
+{
+	const struct dm_report_field_type *fields;
+	struct dm_report_field_value *values;
+	struct field_properties *fp;
+	struct dm_report_field *field;
+	struct row *row;
+	unsigned count = 0;
+	int r = 1;
+
+	if (dm_list_empty(&rh->rows))
+		goto out;
+
+	/* Also collects sort fields. */
+	if (rh->flags & RH_FIELD_CALC_NEEDED)
+		_recalculate_fields(rh);
+
+	if ((rh->flags & RH_SORT_REQUIRED))
+		_sort_rows(rh);
+
+	/* Each row has one field per field_props entry. */
+	dm_list_iterate_items(fp, &rh->field_props)
+		count++;
+
+	if (!(values = dm_pool_alloc(rh->mem, count * sizeof(*values)))) {
+		log_error("dm_report: Unable to allocate row values.");
+		return 0;
+	}
+
+	dm_list_iterate_items(row, &rh->rows) {
+		if (!_should_display_row(row))
+			continue;
+
+		count = 0;
+		dm_list_iterate_items(field, &row->fields) {
+			if (field->props->flags & FLD_HIDDEN)
+				continue;
+
+			fields = field->props->implicit ? _implicit_report_fields : rh->fields;
+			values[count].id = fields[field->props->field_num].id;
+			values[count].value = field->report_string;
+			values[count].type = field->props->flags & DM_REPORT_FIELD_TYPE_MASK;
+			values[count].number = _field_number(field);
+			count++;
+		}
+
+		if (!row_fn(private, values, count)) {
+			r = 0;
+			break;
+		}
+	}
+
+	dm_pool_free(rh->mem, values);
+
+	if (!(rh->flags & DM_REPORT_OUTPUT_MULTIPLE_TIMES))
+		_destroy_rows(rh);
+out:
+	if (r && rh->group_item)
+		rh->group_item->output_done = 1;
+	return r;
+}
+
 void dm_report_destroy_rows(struct dm_report *rh)
 {
 	_destroy_rows(rh);
@@ -5160,7 +5358,13 @@ static int _report_group_push_json(struct report_group_item *item, const char *n
 		item->report->flags &= ~(DM_REPORT_OUTPUT_ALIGNED |
 					 DM_REPORT_OUTPUT_HEADINGS |
 					 DM_REPORT_OUTPUT_COLUMNS_AS_ROWS);
-		item->report->flags |= DM_REPORT_OUTPUT_BUFFERED;
+		/*
+		 * JSON needs no column widths, so an unbuffered report
+		 * streams its rows instead of being switched to buffered.
+		 */
+		if (!(item->report->flags & DM_REPORT_OUTPUT_BUFFERED))
+			item->report->flags = (item->report->flags & ~DM_REPORT_OUTPUT_MULTIPLE_TIMES) |
+					      RH_JSON_STREAM;
 	} else {
 		_json_output_start(item->group);
 		if (name) {
@@ -5250,6 +5454,9 @@ static int _report_group_pop_basic(struct report_group_item *item)
 
 static int _report_group_pop_json(struct report_group_item *item)
 {
+	if (item->report && !_json_stream_line(item->report, NULL))
+		return_0;
+
 	if (item->output_done && item->needs_closing) {
 		if (item->data) {
 			item->group->indent -= JSON_INDENT_UNIT;
@@ -27,6 +27,7 @@ typedef struct {
 	unsigned blocks_allocated;	/* Current number of blocks allocated */
 	unsigned blocks_max;	/* Max no of concurrently-allocated blocks */
 	unsigned int bytes, maxbytes;
+	uint64_t total_bytes;	/* Bytes allocated over pool lifetime */
 } pool_stats;
 
 struct dm_pool {
@@ -102,12 +103,34 @@ static void _pool_stats(struct dm_pool *p, const char *action)
 
 void dm_pool_destroy(struct dm_pool *p)
 {
+	struct dm_pool_stats stats;
+
 	_pool_stats(p, "Destroying");
 	_free_blocks(p, p->blocks);
+	dm_pool_get_stats(p, &stats);
+	pthread_mutex_lock(&_dm_pools_mutex);
+	_dm_pools_stats_add(p->name, &stats);
+	pthread_mutex_unlock(&_dm_pools_mutex);
 	dm_list_del(&p->list);
 	free(p);
 }
 
+void dm_pool_set_chunk_cache(struct dm_pool *p __attribute__((unused)),
+			     size_t max_bytes __attribute__((unused)),
+			     uint32_t flags __attribute__((unused)))
+{
+	/* Every block is released at once here */
+}
+
+void dm_pool_get_stats(const struct dm_pool *p, struct dm_pool_stats *stats)
+{
+	/* Every allocation is a separate block here */
+	stats->alloc_bytes = p->stats.total_bytes;
+	stats->objects = stats->chunks = p->stats.block_serialno;
+	stats->chunk_bytes = p->stats.bytes;
+	stats->chunk_bytes_max = p->stats.maxbytes;
+}
+
 void *dm_pool_alloc(struct dm_pool *p, size_t s)
 {
 	return dm_pool_alloc_aligned(p, s, DEFAULT_ALIGNMENT);
@@ -131,6 +154,7 @@ static void _append_block(struct dm_pool *p, struct block *b)
 		p->stats.blocks_max = p->stats.blocks_allocated;
 
 	p->stats.bytes += b->size;
+	p->stats.total_bytes += b->size;
 	if (p->stats.bytes > p->stats.maxbytes)
 		p->stats.maxbytes = p->stats.bytes;
 }
@@ -21,6 +21,7 @@
 #include "device_mapper/misc/dmlib.h"
 #include <stddef.h>	/* For musl libc */
 #include <malloc.h>
+#include <sys/mman.h>
 
 struct chunk {
 	char *begin, *end;
@@ -37,11 +38,21 @@ struct dm_pool {
 	unsigned object_alignment;
 	int locked;
 	long crc;
+	struct dm_pool_stats stats;
+	struct chunk *cached;	/* Released chunks, largest first */
+	size_t cached_bytes;
+	size_t cache_max;
+	uint32_t cache_flags;
 };
 
 static void _align_chunk(struct chunk *c, unsigned alignment);
 static struct chunk *_new_chunk(struct dm_pool *p, size_t s);
-static void _free_chunk(struct chunk *c);
+static void _free_chunk(struct dm_pool *p, struct chunk *c);
+static void _cache_chunk(struct dm_pool *p, struct chunk *c);
+static struct chunk *_uncache_chunk(struct dm_pool *p, size_t s);
+
+/* Chunks of this size get transparent huge pages with DM_POOL_CACHE_HUGEPAGE */
+#define HUGEPAGE_SIZE (2 * 1024 * 1024)
 
 /* by default things come out aligned for doubles */
 #define DEFAULT_ALIGNMENT __alignof__ (double)
@@ -72,15 +83,22 @@ struct dm_pool *dm_pool_create(const char *name, size_t chunk_hint)
 void dm_pool_destroy(struct dm_pool *p)
 {
 	struct chunk *c, *pr;
-	_free_chunk(p->spare_chunk);
+	_free_chunk(p, p->spare_chunk);
 	c = p->chunk;
 	while (c) {
 		pr = c->prev;
-		_free_chunk(c);
+		_free_chunk(p, c);
+		c = pr;
+	}
+	c = p->cached;
+	while (c) {
+		pr = c->prev;
+		_free_chunk(p, c);
 		c = pr;
 	}
 
 	pthread_mutex_lock(&_dm_pools_mutex);
+	_dm_pools_stats_add(p->name, &p->stats);
 	dm_list_del(&p->list);
 	pthread_mutex_unlock(&_dm_pools_mutex);
 	free(p);
@@ -115,6 +133,8 @@ void *dm_pool_alloc_aligned(struct dm_pool *p, size_t s, unsigned alignment)
 
 	r = c->begin;
 	c->begin += s;
+	p->stats.alloc_bytes += s;
+	p->stats.objects++;
 
 #ifdef VALGRIND_POOL
 	VALGRIND_MAKE_MEM_UNDEFINED(r, s);
@@ -149,7 +169,7 @@ void dm_pool_free(struct dm_pool *p, void *ptr)
 		}
 
 		if (p->spare_chunk)
-			_free_chunk(p->spare_chunk);
+			_cache_chunk(p, p->spare_chunk);
 
 		c->begin = (char *) (c + 1);
 #ifdef VALGRIND_POOL
@@ -240,6 +260,8 @@ void *dm_pool_end_object(struct dm_pool *p)
 	struct chunk *c = p->chunk;
 	void *r = c->begin;
 	c->begin += p->object_len;
+	p->stats.alloc_bytes += p->object_len;
+	p->stats.objects++;
 	p->object_len = 0u;
 	p->object_alignment = DEFAULT_ALIGNMENT;
 	return r;
@@ -259,6 +281,91 @@ static void _align_chunk(struct chunk *c, unsigned alignment)
 	c->begin += alignment - ((unsigned long) c->begin & (alignment - 1));
 }
 
+#define CHUNK_SIZE(c) ((size_t) ((c)->end - (char *) (c)))
+
+/*
+ * Drop the smallest cached chunks until there is room for 'size' bytes,
+ * but never for the sake of a chunk which is not larger than them.
+ */
+static int _trim_chunk_cache(struct dm_pool *p, size_t size)
+{
+	struct chunk **cp;
+	size_t csize;
+
+	while (p->cached_bytes + size > p->cache_max) {
+		for (cp = &p->cached; *cp && (*cp)->prev; cp = &(*cp)->prev)
+			;
+
+		if (!*cp)
+			return 0;
+
+		csize = CHUNK_SIZE(*cp);
+		if (size && (csize >= size))
+			return 0;
+
+		p->cached_bytes -= csize;
+		_free_chunk(p, *cp);
+		*cp = NULL;
+	}
+
+	return 1;
+}
+
+static void _cache_chunk(struct dm_pool *p, struct chunk *c)
+{
+	struct chunk **cp;
+	size_t size = CHUNK_SIZE(c);
+
+	if (!_trim_chunk_cache(p, size)) {
+		_free_chunk(p, c);
+		return;
+	}
+
+	for (cp = &p->cached; *cp && (CHUNK_SIZE(*cp) > size); cp = &(*cp)->prev)
+		;
+
+	c->prev = *cp;
+	*cp = c;
+	p->cached_bytes += size;
+}
+
+/* Take the smallest cached chunk of at least 's' bytes */
+static struct chunk *_uncache_chunk(struct dm_pool *p, size_t s)
+{
+	struct chunk *c, **cp, **fit = NULL;
+
+	for (cp = &p->cached; *cp && (CHUNK_SIZE(*cp) >= s); cp = &(*cp)->prev)
+		fit = cp;
+
+	if (!fit)
+		return NULL;
+
+	c = *fit;
+	*fit = c->prev;
+	p->cached_bytes -= CHUNK_SIZE(c);
+
+	return c;
+}
+
+#ifndef DEBUG_ENFORCE_POOL_LOCKING
+static struct chunk *_malloc_chunk(struct dm_pool *p, size_t *s)
+{
+#ifdef MADV_HUGEPAGE
+	void *c;
+
+	if ((p->cache_flags & DM_POOL_CACHE_HUGEPAGE) && (*s >= HUGEPAGE_SIZE)) {
+		*s = (*s + HUGEPAGE_SIZE - 1) & ~((size_t) HUGEPAGE_SIZE - 1);
+		if (posix_memalign(&c, HUGEPAGE_SIZE, *s))
+			return NULL;
+		/* Just a hint, transparent huge pages may be disabled */
+		(void) madvise(c, *s, MADV_HUGEPAGE);
+		return c;
+	}
+#endif
+	return malloc(*s);
+}
+#endif
+
 static struct chunk *_new_chunk(struct dm_pool *p, size_t s)
 {
 	struct chunk *c;
@@ -268,6 +375,8 @@ static struct chunk *_new_chunk(struct dm_pool *p, size_t s)
 		/* reuse old chunk */
 		c = p->spare_chunk;
 		p->spare_chunk = 0;
+	} else if ((c = _uncache_chunk(p, s))) {
+		c->begin = (char *) (c + 1);
 	} else {
 #ifdef DEBUG_ENFORCE_POOL_LOCKING
 		if (!_pagesize) {
@@ -282,7 +391,7 @@ static struct chunk *_new_chunk(struct dm_pool *p, size_t s)
 #  define aligned_malloc(s)	(posix_memalign((void**)&c, _pagesize, \
 						ALIGN_ON_PAGE(s)) == 0)
 #else
-#  define aligned_malloc(s)	(c = malloc(s))
+#  define aligned_malloc(s)	(c = _malloc_chunk(p, &(s)))
 #endif /* DEBUG_ENFORCE_POOL_LOCKING */
 		if (!aligned_malloc(s)) {
 #undef aligned_malloc
@@ -294,6 +403,11 @@ static struct chunk *_new_chunk(struct dm_pool *p, size_t s)
 		c->begin = (char *) (c + 1);
 		c->end = (char *) c + s;
 
+		p->stats.chunks++;
+		p->stats.chunk_bytes += s;
+		if (p->stats.chunk_bytes > p->stats.chunk_bytes_max)
+			p->stats.chunk_bytes_max = p->stats.chunk_bytes;
+
 #ifdef VALGRIND_POOL
 		VALGRIND_MAKE_MEM_NOACCESS(c->begin, c->end - c->begin);
 #endif
@@ -304,8 +418,11 @@ static struct chunk *_new_chunk(struct dm_pool *p, size_t s)
 	return c;
 }
 
-static void _free_chunk(struct chunk *c)
+static void _free_chunk(struct dm_pool *p, struct chunk *c)
 {
+	if (c)
+		p->stats.chunk_bytes -= c->end - (char *) c;
+
 #ifdef VALGRIND_POOL
 #  ifdef DEBUG_MEM
 	if (c)
@@ -320,6 +437,18 @@ static void _free_chunk(struct chunk *c)
 #endif
 }
 
+void dm_pool_get_stats(const struct dm_pool *p, struct dm_pool_stats *stats)
+{
+	*stats = p->stats;
+}
+
+void dm_pool_set_chunk_cache(struct dm_pool *p, size_t max_bytes, uint32_t flags)
+{
+	p->cache_max = max_bytes;
+	p->cache_flags = flags;
+	(void) _trim_chunk_cache(p, 0);
+}
+
 
 /**
  * Calc crc/hash from pool's memory chunks with internal pointers
@@ -40,6 +40,38 @@ static size_t _pagesize_mask = 0;
 #define ALIGN_ON_PAGE(size) (((size) + (_pagesize_mask)) & ~(_pagesize_mask))
 #endif
 
+/* Usage of destroyed pools summed up by pool name */
+#define DM_POOLS_STATS_NAMES 64
+static struct {
+	char name[32];
+	unsigned pools;
+	struct dm_pool_stats stats;
+} _dm_pools_stats[DM_POOLS_STATS_NAMES];
+
+/* Called with _dm_pools_mutex held */
+static void _dm_pools_stats_add(const char *name, const struct dm_pool_stats *stats)
+{
+	unsigned i;
+
+	for (i = 0; i < DM_POOLS_STATS_NAMES; ++i) {
+		if (!_dm_pools_stats[i].name[0])
+			(void) dm_strncpy(_dm_pools_stats[i].name, name,
+					  sizeof(_dm_pools_stats[i].name));
+		else if (strncmp(_dm_pools_stats[i].name, name,
+				 sizeof(_dm_pools_stats[i].name) - 1))
+			continue;
+
+		_dm_pools_stats[i].pools++;
+		_dm_pools_stats[i].stats.alloc_bytes += stats->alloc_bytes;
+		_dm_pools_stats[i].stats.objects += stats->objects;
+		_dm_pools_stats[i].stats.chunks += stats->chunks;
+		if (_dm_pools_stats[i].stats.chunk_bytes_max < stats->chunk_bytes_max)
+			_dm_pools_stats[i].stats.chunk_bytes_max = stats->chunk_bytes_max;
+		return;
+	}
+	/* Table full, such pool stays unaccounted. */
+}
+
 #ifdef DEBUG_POOL
 #include "pool-debug.c"
 #else
@@ -105,6 +137,33 @@ void dm_pools_check_leaks(void)
 	log_error(INTERNAL_ERROR "Unreleased memory pool(s) found.");
 }
 
+void dm_pools_dump_stats(void)
+{
+	struct dm_pool_stats stats;
+	struct dm_pool *p;
+	unsigned i;
+
+	pthread_mutex_lock(&_dm_pools_mutex);
+	dm_list_iterate_items(p, &_dm_pools) {
+		dm_pool_get_stats(p, &stats);
+		log_debug_mem("Pool %s [%p]: %" PRIu64 " bytes in %" PRIu64
+			      " objects, %" PRIu64 " chunks, %" PRIu64
+			      " bytes held, %" PRIu64 " bytes max.",
+			      p->name, (void *)p, stats.alloc_bytes, stats.objects,
+			      stats.chunks, stats.chunk_bytes, stats.chunk_bytes_max);
+	}
+
+	for (i = 0; i < DM_POOLS_STATS_NAMES && _dm_pools_stats[i].name[0]; ++i)
+		log_debug_mem("Pool %s (%u destroyed): %" PRIu64 " bytes in %" PRIu64
+			      " objects, %" PRIu64 " chunks, %" PRIu64 " bytes max.",
+			      _dm_pools_stats[i].name, _dm_pools_stats[i].pools,
+			      _dm_pools_stats[i].stats.alloc_bytes,
+			      _dm_pools_stats[i].stats.objects,
+			      _dm_pools_stats[i].stats.chunks,
+			      _dm_pools_stats[i].stats.chunk_bytes_max);
+	pthread_mutex_unlock(&_dm_pools_mutex);
+}
+
 /**
  * Status of locked pool.
  *
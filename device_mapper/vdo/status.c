@@ -22,6 +22,7 @@
 #include "base/memory/zalloc.h"
 
 #include <ctype.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -251,4 +252,136 @@ bad:
 	return false;
 }
 
+#define VDO_STATS_PATH_MAX 128
+
+static const struct {
+	const char path[48];
+	size_t offset;
+} _stats_fields[] = {
+#define XX(p, f) { p, offsetof(struct dm_vdo_stats, f) }
+	XX("dataBlocksUsed", data_blocks_used),
+	XX("overheadBlocksUsed", overhead_blocks_used),
+	XX("logicalBlocksUsed", logical_blocks_used),
+	XX("physicalBlocks", physical_blocks),
+	XX("logicalBlocks", logical_blocks),
+	XX("dedupeAdviceTimeouts", dedupe_advice_timeouts),
+	XX("packer.compressedFragmentsWritten", packer.fragments_written),
+	XX("packer.compressedBlocksWritten", packer.blocks_written),
+	XX("packer.compressedFragmentsInPacker", packer.fragments_in_packer),
+	XX("journal.diskFull", journal.disk_full),
+	XX("journal.entries.committed", journal.entries_committed),
+	XX("journal.blocks.committed", journal.blocks_committed),
+	XX("hashLock.dedupeAdviceValid", hash_lock.dedupe_advice_valid),
+	XX("hashLock.dedupeAdviceStale", hash_lock.dedupe_advice_stale),
+	XX("hashLock.concurrentDataMatches", hash_lock.concurrent_data_matches),
+	XX("hashLock.concurrentHashCollisions", hash_lock.concurrent_hash_collisions),
+	XX("biosIn.write", bios_in.write),
+	XX("biosIn.discard", bios_in.discard),
+	XX("index.postsFound", index.posts_found),
+	XX("index.postsNotFound", index.posts_not_found),
+#undef XX
+};
+
+static bool _stats_delim(char c)
+{
+	return isspace(c) || c == ':' || c == ',' || c == '{' || c == '}';
+}
+
+// Appends the token to the dot separated path.
+static bool _stats_path_push(char *path, size_t *len, const char *b, const char *e)
+{
+	size_t n = e - b;
+
+	if (*len + n + 2 > VDO_STATS_PATH_MAX)
+		return false;
+
+	if (*len)
+		path[(*len)++] = '.';
+	memcpy(path + *len, b, n);
+	*len += n;
+	path[*len] = 0;
+
+	return true;
+}
+
+static void _stats_set_value(struct dm_vdo_stats *stats, const char *path,
+			     const char *b, const char *e)
+{
+	unsigned i;
+
+	for (i = 0; i < DM_ARRAY_SIZE(_stats_fields); i++)
+		if (!strcmp(path, _stats_fields[i].path)) {
+			/* Value stays unknown when it is not a number. */
+			(void) _parse_uint64(b, e, (char *) stats + _stats_fields[i].offset);
+			return;
+		}
+}
+
+/*
+ * The response is a sequence of 'name : value' pairs separated by
+ * commas, where a value may be a nested '{ ... }' group.  Nested
+ * names are matched by their dot separated path.
+ */
+bool dm_vdo_stats_parse(const char *input, struct dm_vdo_stats *stats)
+{
+	const char *b = input;
+	const char *e = input + strlen(input);
+	const char *te;
+	const char *key_b = NULL, *key_e = NULL;
+	char path[VDO_STATS_PATH_MAX] = { 0 };
+	size_t group_len[16];
+	size_t len = 0, key_len;
+	unsigned depth = 0;
+	unsigned i;
+
+	for (i = 0; i < DM_ARRAY_SIZE(_stats_fields); i++)
+		*(uint64_t *)((char *) stats + _stats_fields[i].offset) = UINT64_MAX;
+
+	while ((b = _eat_space(b, e)) != e) {
+		switch (*b) {
+		case '{':
+			if (depth == DM_ARRAY_SIZE(group_len))
+				return false;
+			group_len[depth++] = len;
+			if (key_b && !_stats_path_push(path, &len, key_b, key_e))
+				return false;
+			key_b = NULL;
+			b++;
+			continue;
+		case '}':
+			if (!depth)
+				return false;
+			len = group_len[--depth];
+			path[len] = 0;
+			key_b = NULL;
+			b++;
+			continue;
+		case ',':
+		case ':':
+			b++;
+			continue;
+		}
+
+		for (te = b; te != e && !_stats_delim(*te); te++)
+			;
+
+		if (*_eat_space(te, e) == ':') {
+			key_b = b;
+			key_e = te;
+		} else if (key_b) {
+			key_len = len;
+			if (!_stats_path_push(path, &len, key_b, key_e))
+				return false;
+			_stats_set_value(stats, path, b, te);
+			len = key_len;
+			path[len] = 0;
+			key_b = NULL;
+		}
+
+		b = te;
+	}
+
+	return !depth;
+}
+
 //----------------------------------------------------------------
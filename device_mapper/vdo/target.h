@@ -66,6 +66,45 @@ struct dm_pool;
 bool dm_vdo_status_parse(struct dm_pool *mem, const char *input,
 			 struct dm_vdo_status_parse_result *result);
 
+// Statistics reported by the 'stats' message of the kernel target.
+// Values missing from the response are left as UINT64_MAX.
+struct dm_vdo_stats {
+	uint64_t data_blocks_used;
+	uint64_t overhead_blocks_used;
+	uint64_t logical_blocks_used;
+	uint64_t physical_blocks;
+	uint64_t logical_blocks;
+	uint64_t dedupe_advice_timeouts;
+	struct {
+		uint64_t fragments_written;
+		uint64_t blocks_written;
+		uint64_t fragments_in_packer;
+	} packer;
+	struct {
+		uint64_t disk_full;
+		uint64_t entries_committed;
+		uint64_t blocks_committed;
+	} journal;
+	struct {
+		uint64_t dedupe_advice_valid;
+		uint64_t dedupe_advice_stale;
+		uint64_t concurrent_data_matches;
+		uint64_t concurrent_hash_collisions;
+	} hash_lock;
+	struct {
+		uint64_t write;
+		uint64_t discard;
+	} bios_in;
+	struct {
+		uint64_t posts_found;
+		uint64_t posts_not_found;
+	} index;
+};
+
+// Parses the response of the 'stats' message in a single pass.
+// Needs no allocation, so the same struct can be reused for each poll.
+bool dm_vdo_stats_parse(const char *input, struct dm_vdo_stats *stats);
+
 enum dm_vdo_write_policy {
 	DM_VDO_WRITE_POLICY_AUTO = 0,
 	DM_VDO_WRITE_POLICY_SYNC,
@@ -265,13 +265,9 @@ bool dm_vdo_parse_logical_size(const char *vdo_path, uint64_t *logical_blocks)
 		goto err;
 	}
 
-	if (lseek(fh, regpos, SEEK_SET) < 0) {
-		log_sys_debug("lseek", vdo_path);
-		goto err;
-	}
-
-	if (read(fh, buffer, sizeof(buffer)) < 0) {
-		log_sys_debug("read", vdo_path);
+	/* Super block is at the start of the data region, past the index */
+	if (pread(fh, buffer, sizeof(buffer), regpos) < 0) {
+		log_sys_debug("pread", vdo_path);
 		goto err;
 	}
 
@@ -1440,6 +1440,12 @@ int lv_vdo_pool_size_config(const struct logical_volume *lv,
 static int _lv_active(struct cmd_context *cmd, const struct logical_volume *lv)
 {
 	struct lvinfo info;
+	int exists;
+
+	/* New thin-pool may need its -tpool layer checked, leave that to lv_info() */
+	if (activation() && !lv_is_new_thin_pool(lv) &&
+	    dev_manager_cached_exists(cmd, lv, NULL, &exists))
+		return exists;
 
 	if (!lv_info(cmd, lv, 0, &info, 0, 0)) {
 		log_debug_activation("Cannot determine activation status of %s%s.",
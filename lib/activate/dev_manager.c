@@ -27,6 +27,7 @@
 #include "lib/misc/lvm-exec.h"
 #include "lib/datastruct/str_list.h"
 #include "lib/misc/lvm-signal.h"
+#include "lib/misc/lvm-timing.h"
 
 #include <limits.h>
 #include <dirent.h>
@@ -176,19 +177,12 @@ static int _vdo_pool_message_stats(struct dm_pool *mem,
 	const char *response;
 	const char *dlid;
 	struct dm_task *dmt = NULL;
+	struct dm_vdo_stats *stats = &status->stats;
 	int r = 0;
-	unsigned i;
-	const char *p;
-	struct vdo_msg_elem {
-		const char *name;
-		uint64_t *val;
-	} const vme[] = { /* list of properties lvm2 wants to parse */
-		{ "dataBlocksUsed", &status->data_blocks_used },
-		{ "logicalBlocksUsed", &status->logical_blocks_used }
-	};
 
-	for (i = 0; i < DM_ARRAY_SIZE(vme); ++i)
-		*vme[i].val = ULLONG_MAX;
+	status->data_blocks_used = ULLONG_MAX;
+	status->logical_blocks_used = ULLONG_MAX;
+	memset(stats, 0xff, sizeof(*stats));
 
 	if (!(dlid = build_dm_uuid(mem, lv, lv_layer(lv))))
 		return_0;
@@ -206,18 +200,22 @@ static int _vdo_pool_message_stats(struct dm_pool *mem,
 			     display_lvname(lv));
 
 	if ((response = dm_task_get_message_response(dmt))) {
-		for (i = 0; i < DM_ARRAY_SIZE(vme); ++i) {
-			errno = 0;
-			if (!(p = strstr(response,  vme[i].name)) ||
-			    !(p = strchr(p, ':')) ||
-			    ((*vme[i].val = strtoul(p + 1, NULL, 10)) == ULLONG_MAX) || errno) {
-				log_debug("Cannot parse %s in VDO DM stats message.", vme[i].name);
-				*vme[i].val = ULLONG_MAX;
-				goto out;
-			}
-			if (*vme[i].val != ULLONG_MAX)
-				log_debug("VDO property %s = " FMTu64, vme[i].name, *vme[i].val);
+		if (!dm_vdo_stats_parse(response, stats)) {
+			log_debug("Cannot parse VDO DM stats message.");
+			goto out;
+		}
+		if (stats->data_blocks_used == ULLONG_MAX) {
+			log_debug("Cannot parse dataBlocksUsed in VDO DM stats message.");
+			goto out;
+		}
+		if (stats->logical_blocks_used == ULLONG_MAX) {
+			log_debug("Cannot parse logicalBlocksUsed in VDO DM stats message.");
+			goto out;
 		}
+		status->data_blocks_used = stats->data_blocks_used;
+		status->logical_blocks_used = stats->logical_blocks_used;
+		log_debug("VDO property dataBlocksUsed = " FMTu64 " logicalBlocksUsed = " FMTu64,
+			  status->data_blocks_used, status->logical_blocks_used);
 	}
 
 	r = 1;
@@ -1113,6 +1111,34 @@ out:
 	return r;
 }
 
+/*
+ * Answer whether the LV's dm device exists from the dm devs cache alone.
+ * Returns 0 when the cache is not in use and the caller must ask the kernel.
+ */
+int dev_manager_cached_exists(struct cmd_context *cmd, const struct logical_volume *lv,
+			      const char *layer, int *exists)
+{
+	char old_style_dlid[sizeof(UUID_PREFIX) + 2 * ID_LEN];
+	char *dlid;
+
+	if (!dm_devs_cache_use())
+		return 0;
+
+	if (!(dlid = build_dm_uuid(cmd->mem, lv, layer)))
+		return_0;
+
+	dm_strncpy(old_style_dlid, dlid, sizeof(old_style_dlid));
+
+	*exists = (dm_devs_cache_get_by_uuid(cmd, dlid) ||
+		   dm_devs_cache_get_by_uuid(cmd, old_style_dlid)) ? 1 : 0;
+
+	log_debug("Cached as %s %s.", *exists ? "active" : "inactive", display_lvname(lv));
+
+	dm_pool_free(cmd->mem, dlid);
+
+	return 1;
+}
+
 static struct dm_tree_node *_cached_dm_tree_node(struct dm_pool *mem,
 						       struct dm_tree *dtree,
 						       const struct logical_volume *lv,
@@ -2590,6 +2616,94 @@ static int _check_tool_version(struct cmd_context *cmd, const char *tool,
 	return ret;
 }
 
+/*
+ * After the pool metadata passed the check on deactivation, remember its
+ * transaction id and metadata LV, so with global/pool_check_skip_clean
+ * the next activation can skip the check when nothing has changed.
+ * The file is removed whenever the pool gets activated.
+ */
+static int _pool_checked_path(char *path, size_t size,
+			      const struct logical_volume *pool_lv)
+{
+	char uuid[64] __attribute__((aligned(8)));
+
+	if (!id_write_format(&pool_lv->lvid.id[1], uuid, sizeof(uuid)) ||
+	    (dm_snprintf(path, size, "%s/%s", POOLS_CHECKED_DIR, uuid) < 0)) {
+		log_debug("Cannot create checked file path for pool %s.",
+			  display_lvname(pool_lv));
+		return 0;
+	}
+
+	return 1;
+}
+
+static int _pool_checked_state(char *buf, size_t size,
+			       const struct logical_volume *pool_lv,
+			       const struct logical_volume *mlv)
+{
+	char uuid[64] __attribute__((aligned(8)));
+
+	if (!id_write_format(mlv ? &mlv->lvid.id[1] : &pool_lv->lvid.id[1], uuid, sizeof(uuid)) ||
+	    (dm_snprintf(buf, size, "%" PRIu64 " %s\n",
+			 first_seg(pool_lv)->transaction_id, uuid) < 0))
+		return 0;
+
+	return 1;
+}
+
+static void _pool_checked_write(const struct logical_volume *pool_lv,
+				const struct logical_volume *mlv)
+{
+	char path[PATH_MAX], buf[128];
+	FILE *fp;
+
+	if (!_pool_checked_path(path, sizeof(path), pool_lv) ||
+	    !_pool_checked_state(buf, sizeof(buf), pool_lv, mlv) ||
+	    !dir_create_recursive(POOLS_CHECKED_DIR, 0755))
+		return;
+
+	if (!(fp = fopen(path, "w"))) {
+		log_sys_debug("fopen", path);
+		return;
+	}
+
+	if (fputs(buf, fp) < 0)
+		log_sys_debug("fputs", path);
+
+	if (fclose(fp)) {
+		log_sys_debug("fclose", path);
+		if (unlink(path))
+			log_sys_debug("unlink", path);
+	}
+}
+
+/* Returns 1 when the pool was checked clean and is unchanged since. */
+static int _pool_checked_take(const struct logical_volume *pool_lv,
+			      const struct logical_volume *mlv, int skip_clean)
+{
+	char path[PATH_MAX], buf[128], file_buf[128] = { 0 };
+	int r = 0;
+	FILE *fp;
+
+	if (!_pool_checked_path(path, sizeof(path), pool_lv))
+		return 0;
+
+	if (skip_clean && (fp = fopen(path, "r"))) {
+		if (fgets(file_buf, sizeof(file_buf), fp) &&
+		    _pool_checked_state(buf, sizeof(buf), pool_lv, mlv) &&
+		    !strcmp(buf, file_buf))
+			r = 1;
+		if (fclose(fp))
+			log_sys_debug("fclose", path);
+	}
+
+	/* Pool gets active, its metadata will change */
+	if (unlink(path) && (errno != ENOENT))
+		log_sys_debug("unlink", path);
+
+	return r;
+}
+
 static int _pool_callback(struct dm_tree_node *node,
 			  dm_node_callback_t type, void *cb_data)
 {
@@ -2624,6 +2738,14 @@ static int _pool_callback(struct dm_tree_node *node,
 
 	dm_devs_cache_destroy();
 
+	if ((type == DM_NODE_CALLBACK_PRELOADED) &&
+	    _pool_checked_take(pool_lv, mlv,
+			       find_config_tree_bool(cmd, global_pool_check_skip_clean_CFG, NULL))) {
+		log_debug_activation("Metadata checking skipped, %s is unchanged since its last check.",
+				     mpath);
+		return 1;
+	}
+
 	log_debug("Running check command on %s", mpath);
 
 	if (data->skip_zero) {
@@ -2689,7 +2811,8 @@ static int _pool_callback(struct dm_tree_node *node,
 		 * as pool but as error/linear and let the
 		 * dm tree resolve the issue.
 		 */
-	}
+	} else if ((type == DM_NODE_CALLBACK_DEACTIVATED) && !lv_is_cache_vol(pool_lv))
+		_pool_checked_write(pool_lv, mlv);
 
 	return ret;
 }
@@ -3975,8 +4098,8 @@ static int _clean_tree(struct dev_manager *dm, struct dm_tree_node *root, const
 	return 1;
 }
 
-static int _tree_action(struct dev_manager *dm, const struct logical_volume *lv,
-			struct lv_activate_opts *laopts, action_t action)
+static int _do_tree_action(struct dev_manager *dm, const struct logical_volume *lv,
+			   struct lv_activate_opts *laopts, action_t action)
 {
 	static const char _action_names[][24] = {
 		"PRELOAD", "ACTIVATE", "DEACTIVATE", "SUSPEND", "SUSPEND_WITH_LOCKFS", "CLEAN"
@@ -4102,6 +4225,18 @@ out_no_root:
 	return r;
 }
 
+static int _tree_action(struct dev_manager *dm, const struct logical_volume *lv,
+			struct lv_activate_opts *laopts, action_t action)
+{
+	int r;
+
+	timing_start(TIMING_ACTIVATION);
+	r = _do_tree_action(dm, lv, laopts, action);
+	timing_end(TIMING_ACTIVATION);
+
+	return r;
+}
+
 /* origin_only may only be set if we are resuming (not activating) an origin LV */
 int dev_manager_activate(struct dev_manager *dm, const struct logical_volume *lv,
 			 struct lv_activate_opts *laopts)
@@ -52,6 +52,8 @@ int dev_manager_info(struct cmd_context *cmd, const struct logical_volume *lv,
 		     int with_open_count, int with_read_ahead, int with_name_check,
 		     struct dm_info *dminfo, uint32_t *read_ahead,
 		     struct lv_seg_status *seg_status);
+int dev_manager_cached_exists(struct cmd_context *cmd, const struct logical_volume *lv,
+			      const char *layer, int *exists);
 
 int dev_manager_snapshot_percent(struct dev_manager *dm,
 				 const struct logical_volume *lv,
@@ -18,6 +18,7 @@
 #include "lib/activate/activate.h"
 #include "lib/commands/toolcontext.h"
 #include "lib/misc/lvm-string.h"
+#include "lib/misc/lvm-timing.h"
 #include "lib/misc/lvm-file.h"
 #include "lib/mm/memlock.h"
 
@@ -30,10 +31,26 @@
 /*
  * Library cookie to combine multiple fs transactions.
  * Supports to wait for udev device settle only when needed.
+ * All dm trees of a command share it, so e.g. activating every LV
+ * of a VG waits once, in sync_local_dev_names(), on a single
+ * semaphore that udev's dm rules release as they finish.
  */
 static uint32_t _fs_cookie = DM_COOKIE_AUTO_CREATE;
 static int _fs_create = 0;
 
+/*
+ * While stacked operations are popped, remember the last VG directory
+ * a link was created in, so a batch of links in one VG does not check
+ * the directory and the LVM1 group file again for every LV.
+ */
+static int _fs_batch = 0;
+static char _fs_batch_vg_path[PATH_MAX];
+
+static int _vg_path_checked(const char *vg_path)
+{
+	return _fs_batch && !strcmp(vg_path, _fs_batch_vg_path);
+}
+
 static int _mk_dir(const char *dev_dir, const char *vg_name)
 {
 	static char vg_path[PATH_MAX];
@@ -46,7 +63,7 @@ static int _mk_dir(const char *dev_dir, const char *vg_name)
 		return 0;
 	}
 
-	if (dir_exists(vg_path))
+	if (_vg_path_checked(vg_path) || dir_exists(vg_path))
 		return 1;
 
 	log_very_verbose("Creating directory %s", vg_path);
@@ -76,6 +93,8 @@ static int _rm_dir(const char *dev_dir, const char *vg_name)
 		return 0;
 	}
 
+	_fs_batch_vg_path[0] = '\0';
+
 	if (dir_exists(vg_path) && dm_is_empty_dir(vg_path)) {
 		log_very_verbose("Removing directory %s", vg_path);
 		rmdir(vg_path);
@@ -125,8 +144,9 @@ static int _mk_link(const char *dev_dir, const char *vg_name,
 		    const char *lv_name, const char *dev, int check_udev)
 {
 	static char lv_path[PATH_MAX], link_path[PATH_MAX], lvm1_group_path[PATH_MAX];
-	static char vg_path[PATH_MAX];
+	static char vg_path[PATH_MAX], target[PATH_MAX];
 	struct stat buf, buf_lp;
+	ssize_t len;
 
 	if (dm_snprintf(vg_path, sizeof(vg_path), "%s%s",
 			 dev_dir, vg_name) == -1) {
@@ -160,7 +180,7 @@ static int _mk_link(const char *dev_dir, const char *vg_name,
 	 * As locking fails if the VG is active under LVM1, it's
 	 * now safe to remove any LVM1 devices we find here
 	 * (as well as any existing LVM2 symlink). */
-	if (!lstat(lvm1_group_path, &buf)) {
+	if (!_vg_path_checked(vg_path) && !lstat(lvm1_group_path, &buf)) {
 		if (!S_ISCHR(buf.st_mode)) {
 			log_error("Non-LVM1 character device found at %s",
 				  lvm1_group_path);
@@ -180,6 +200,16 @@ static int _mk_link(const char *dev_dir, const char *vg_name,
 			return 0;
 		}
 
+		/* Keep a link that already points to the right node. */
+		if (S_ISLNK(buf.st_mode) &&
+		    ((len = readlink(lv_path, target, sizeof(target) - 1)) > 0)) {
+			target[len] = '\0';
+			if (!strcmp(target, link_path)) {
+				log_very_verbose("Keeping link %s -> %s", lv_path, link_path);
+				goto out;
+			}
+		}
+
 		if (dm_udev_get_sync_support() && udev_checking() && check_udev) {
 			/* Check udev created the correct link. */
 			if (!stat(link_path, &buf_lp) &&
@@ -218,6 +248,9 @@ static int _mk_link(const char *dev_dir, const char *vg_name,
 		return 0;
 	}
 	(void) dm_prepare_selinux_context(NULL, 0);
+out:
+	if (_fs_batch)
+		memcpy(_fs_batch_vg_path, vg_path, sizeof(vg_path));
 
 	return 1;
 }
@@ -428,6 +461,8 @@ static void _pop_fs_ops(void)
 	struct dm_list *fsph, *fspht;
 	struct fs_op_parms *fsp;
 
+	_fs_batch = 1;
+
 	dm_list_iterate_safe(fsph, fspht, &_fs_ops) {
 		fsp = dm_list_item(fsph, struct fs_op_parms);
 		_do_fs_op(fsp->type, fsp->dev_dir, fsp->vg_name, fsp->lv_name,
@@ -435,6 +470,8 @@ static void _pop_fs_ops(void)
 		_del_fs_op(fsp);
 	}
 
+	_fs_batch = 0;
+	_fs_batch_vg_path[0] = '\0';
 	_fs_create = 0;
 }
 
@@ -492,8 +529,10 @@ void fs_unlock(void)
 	if (!dm_get_suspended_counter()) {
 		log_debug_activation("Syncing device names");
 		/* Wait for all processed udev devices */
+		timing_start(TIMING_UDEV_WAIT);
 		if (!dm_udev_wait(_fs_cookie))
 			stack;
+		timing_end(TIMING_UDEV_WAIT);
 		_fs_cookie = DM_COOKIE_AUTO_CREATE; /* Reset cookie */
 		dm_lib_release();
 		_pop_fs_ops();
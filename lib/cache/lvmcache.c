@@ -52,6 +52,7 @@ struct lvmcache_info {
 /* One per VG */
 struct lvmcache_vginfo {
 	struct dm_list list;	 /* _vginfos */
+	struct dm_list name_list; /* _vgname_lists_hash entry for vgname */
 	struct dm_list infos;	/* List head for lvmcache_infos */
 	struct dm_list outdated_infos; /* vg_read moves info from infos to outdated_infos */
 	struct dm_list pvsummaries; /* pv_list taken directly from vgsummary */
@@ -75,14 +76,25 @@ struct lvmcache_vginfo {
  * Each VG found during scan gets a vginfo struct.
  * Each vginfo is in _vginfos and _vgid_hash, and
  * _vgname_hash (unless disabled due to duplicate vgnames).
+ *
+ * _vgname_lists_hash maps each vgname to a list of all vginfos
+ * with that name, in the same order as _vginfos, so lookups by
+ * name still use a hash when duplicate vgnames exist.
+ *
+ * _pvsummary_hash maps pvid to the first pvsummary for it in
+ * the vginfos, built when needed and dropped when vginfos or
+ * pvsummaries change.
  */
 
 static struct dm_hash_table *_pvid_hash = NULL;
 static struct dm_hash_table *_vgid_hash = NULL;
 static struct dm_hash_table *_vgname_hash = NULL;
+static struct dm_hash_table *_vgname_lists_hash = NULL;
+static struct dm_hash_table *_pvsummary_hash = NULL;
 static DM_LIST_INIT(_vginfos);
 static DM_LIST_INIT(_initial_duplicates);
 static DM_LIST_INIT(_unused_duplicates);
+static DM_LIST_INIT(_saved_cfts);
 static int _vgs_locked = 0;
 static int _found_duplicate_vgnames = 0;
 static int _outdated_warning = 0;
@@ -108,6 +120,9 @@ int lvmcache_init(struct cmd_context *cmd)
 	if (!(_pvid_hash = dm_hash_create(125)))
 		return 0;
 
+	if (!(_vgname_lists_hash = dm_hash_create(124)))
+		return 0;
+
 	return 1;
 }
 
@@ -285,22 +300,61 @@ static void _vginfo_detach_info(struct lvmcache_info *info)
 	info->vginfo = NULL;
 }
 
+static int _vgname_list_add(struct lvmcache_vginfo *vginfo, int at_head)
+{
+	struct dm_list *head;
+
+	if (!(head = dm_hash_lookup(_vgname_lists_hash, vginfo->vgname))) {
+		if (!(head = malloc(sizeof(*head))))
+			return_0;
+		dm_list_init(head);
+		if (!dm_hash_insert(_vgname_lists_hash, vginfo->vgname, head)) {
+			free(head);
+			return_0;
+		}
+	}
+
+	if (at_head)
+		dm_list_add_h(head, &vginfo->name_list);
+	else
+		dm_list_add(head, &vginfo->name_list);
+
+	return 1;
+}
+
+static void _vgname_list_del(struct lvmcache_vginfo *vginfo)
+{
+	struct dm_list *head;
+
+	dm_list_del(&vginfo->name_list);
+
+	if ((head = dm_hash_lookup(_vgname_lists_hash, vginfo->vgname)) &&
+	    dm_list_empty(head)) {
+		dm_hash_remove(_vgname_lists_hash, vginfo->vgname);
+		free(head);
+	}
+}
+
 static struct lvmcache_vginfo *_search_vginfos_list(const char *vgname, const char *vgid)
 {
+	char vgid_str[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
 	struct lvmcache_vginfo *vginfo;
+	struct dm_list *head;
 
 	if (vgid) {
-		dm_list_iterate_items(vginfo, &_vginfos) {
-			if (!memcmp(vgid, vginfo->vgid, ID_LEN))
-				return vginfo;
-		}
-	} else {
-		dm_list_iterate_items(vginfo, &_vginfos) {
-			if (!strcmp(vgname, vginfo->vgname))
-				return vginfo;
-		}
+		/* In case vgid is not null terminated */
+		memcpy(vgid_str, vgid, ID_LEN);
+		return dm_hash_lookup(_vgid_hash, vgid_str);
 	}
-	return NULL;
+
+	/* The first vginfo using the name, in _vginfos order. */
+	if (!(head = dm_hash_lookup(_vgname_lists_hash, vgname)) ||
+	    dm_list_empty(head))
+		return NULL;
+
+	vginfo = dm_list_item(dm_list_first(head), struct lvmcache_vginfo);
+
+	return vginfo;
 }
 
 static struct lvmcache_vginfo *_vginfo_lookup(const char *vgname, const char *vgid_arg)
@@ -476,60 +530,69 @@ const char *lvmcache_vgname_from_info(struct lvmcache_info *info)
 	return NULL;
 }
 
-static uint64_t _get_pvsummary_size(const char *pvid_arg)
+static void _pvsummary_hash_drop(void)
+{
+	if (_pvsummary_hash) {
+		dm_hash_destroy(_pvsummary_hash);
+		_pvsummary_hash = NULL;
+	}
+}
+
+static struct pv_list *_find_pvsummary(const char *pvid_arg)
 {
 	char pvid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
 	struct lvmcache_vginfo *vginfo;
 	struct pv_list *pvl;
 
-	/* In case pvid_arg is not null terminated. */
-	memcpy(pvid, pvid_arg, ID_LEN);
+	if (!_pvsummary_hash) {
+		if (!(_pvsummary_hash = dm_hash_create(123)))
+			return_NULL;
 
-	dm_list_iterate_items(vginfo, &_vginfos) {
-		dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
-			if (!memcmp(pvid, &pvl->pv->id.uuid, ID_LEN))
-				return pvl->pv->size;
+		dm_list_iterate_items(vginfo, &_vginfos) {
+			dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
+				if (dm_hash_lookup_binary(_pvsummary_hash, &pvl->pv->id.uuid, ID_LEN))
+					continue;
+				if (!dm_hash_insert_binary(_pvsummary_hash, &pvl->pv->id.uuid, ID_LEN, pvl)) {
+					_pvsummary_hash_drop();
+					return_NULL;
+				}
+			}
 		}
 	}
 
+	/* In case pvid_arg is not null terminated. */
+	memcpy(pvid, pvid_arg, ID_LEN);
+
+	return dm_hash_lookup_binary(_pvsummary_hash, pvid, ID_LEN);
+}
+
+static uint64_t _get_pvsummary_size(const char *pvid_arg)
+{
+	struct pv_list *pvl;
+
+	if ((pvl = _find_pvsummary(pvid_arg)))
+		return pvl->pv->size;
+
 	return 0;
 }
 
 static const char *_get_pvsummary_device_hint(const char *pvid_arg)
 {
-	char pvid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
-	struct lvmcache_vginfo *vginfo;
 	struct pv_list *pvl;
 
-	/* In case pvid_arg is not null terminated. */
-	memcpy(pvid, pvid_arg, ID_LEN);
-
-	dm_list_iterate_items(vginfo, &_vginfos) {
-		dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
-			if (!memcmp(pvid, &pvl->pv->id.uuid, ID_LEN))
-				return pvl->pv->device_hint;
-		}
-	}
+	if ((pvl = _find_pvsummary(pvid_arg)))
+		return pvl->pv->device_hint;
 
 	return NULL;
 }
 
 static const char *_get_pvsummary_device_id(const char *pvid_arg, const char **device_id_type)
 {
-	char pvid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
-	struct lvmcache_vginfo *vginfo;
 	struct pv_list *pvl;
 
-	/* In case pvid_arg is not null terminated. */
-	memcpy(pvid, pvid_arg, ID_LEN);
-
-	dm_list_iterate_items(vginfo, &_vginfos) {
-		dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
-			if (!memcmp(&pvid, &pvl->pv->id.uuid, ID_LEN)) {
-				*device_id_type = pvl->pv->device_id_type;
-				return pvl->pv->device_id;
-			}
-		}
+	if ((pvl = _find_pvsummary(pvid_arg))) {
+		*device_id_type = pvl->pv->device_id_type;
+		return pvl->pv->device_id;
 	}
 
 	return NULL;
@@ -545,6 +608,79 @@ int lvmcache_pvsummary_count(const char *vgname)
 	return dm_list_size(&vginfo->pvsummaries);
 }
 
+/*
+ * Return a VG holding only the values saved from the scan summary,
+ * for callers that need nothing else from the VG.  NULL is returned
+ * whenever vg_read could see the VG differently (mismatching or
+ * outdated metadata, missing PVs, duplicates, foreign or shared VGs),
+ * and the VG must be read as usual.
+ */
+struct volume_group *lvmcache_vg_from_summary(struct cmd_context *cmd,
+					      const char *vgname, const char *vgid)
+{
+	struct lvmcache_vginfo *vginfo;
+	struct lvmcache_info *info;
+	struct volume_group *vg;
+	struct pv_list *pvl;
+
+	if (!vgname || !vgid || is_orphan_vg(vgname))
+		return NULL;
+
+	if (!(vginfo = lvmcache_vginfo_from_vgid(vgid)) ||
+	    strcmp(vginfo->vgname, vgname) || !vginfo->seqno ||
+	    vginfo->scan_summary_mismatch ||
+	    vginfo->has_duplicate_local_vgname ||
+	    vginfo->has_duplicate_foreign_vgname ||
+	    !dm_list_empty(&vginfo->outdated_infos) ||
+	    dm_list_empty(&vginfo->pvsummaries) ||
+	    (vginfo->status & EXPORTED_VG) ||
+	    is_lockd_type(vginfo->lock_type) ||
+	    !is_system_id_allowed(cmd, vginfo->system_id) ||
+	    lvmcache_has_duplicate_devs())
+		return NULL;
+
+	/* PVs without metadata areas are still attached to orphans. */
+	dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
+		if (!(info = lvmcache_info_from_pv_id(&pvl->pv->id, NULL, 0)) ||
+		    !info->vginfo ||
+		    ((info->vginfo != vginfo) && !is_orphan_vg(info->vginfo->vgname)))
+			return NULL;
+	}
+
+	if (!(vg = alloc_vg("vg_summary", cmd, vgname)))
+		return_NULL;
+
+	vg->summary_only = 1;
+	memcpy(&vg->id, vginfo->vgid, ID_LEN);
+	vg->seqno = vginfo->seqno;
+	vg->status = vginfo->status;
+	vg->pv_count = dm_list_size(&vginfo->pvsummaries);
+
+	if ((vginfo->system_id && !(vg->system_id = dm_pool_strdup(vg->vgmem, vginfo->system_id))) ||
+	    (vginfo->lock_type && !(vg->lock_type = dm_pool_strdup(vg->vgmem, vginfo->lock_type)))) {
+		release_vg(vg);
+		return_NULL;
+	}
+
+	log_debug_cache("Using scan summary of VG %s seqno %u.", vgname, vg->seqno);
+
+	return vg;
+}
+
+/*
+ * Seqno of the VG metadata found by the last label scan, 0 when
+ * the VG was not seen.
+ */
+uint32_t lvmcache_seqno_from_vgid(const char *vgid)
+{
+	struct lvmcache_vginfo *vginfo;
+
+	if (!(vginfo = lvmcache_vginfo_from_vgid(vgid)))
+		return 0;
+
+	return vginfo->seqno;
+}
+
 /*
  * Check if any PVs in vg->pvs have the same PVID as any
  * entries in _unused_duplicates.
@@ -759,6 +895,92 @@ static int _all_md_components(struct cmd_context *cmd, struct lvmcache_info *inf
 	return 1;
 }
 
+/*
+ * Reorder _initial_duplicates so that all entries with the same PVID
+ * are adjacent, keeping the order in which the PVIDs and the devices
+ * for each PVID were first seen.  This lets _choose_duplicates() take
+ * each PVID's alternatives from the head of the list instead of walking
+ * the whole list once per PVID.  Returns 0 if the list was not grouped.
+ */
+static int _group_initial_duplicates(void)
+{
+	struct dm_hash_table *last_devs;
+	struct device_list *devl, *devl_safe, *devl_last;
+	struct dm_list grouped;
+	int r = 1;
+
+	/* Two entries are always grouped. */
+	if (dm_list_size(&_initial_duplicates) <= 2)
+		return 1;
+
+	if (!(last_devs = dm_hash_create(dm_list_size(&_initial_duplicates))))
+		return_0;
+
+	dm_list_init(&grouped);
+
+	dm_list_iterate_items_safe(devl, devl_safe, &_initial_duplicates) {
+		dm_list_del(&devl->list);
+
+		/* Add after the last entry seen with this PVID. */
+		if ((devl_last = dm_hash_lookup(last_devs, devl->dev->pvid)))
+			dm_list_add(devl_last->list.n, &devl->list);
+		else
+			dm_list_add(&grouped, &devl->list);
+
+		if (!dm_hash_insert(last_devs, devl->dev->pvid, devl)) {
+			log_debug_cache("Failed to group duplicate devices by PVID.");
+			dm_list_splice(&grouped, &_initial_duplicates);
+			r = 0;
+			break;
+		}
+	}
+
+	dm_list_splice(&_initial_duplicates, &grouped);
+	dm_hash_destroy(last_devs);
+
+	return r;
+}
+
+struct duplicate_dev_props {
+	uint64_t size;
+	const char *idname;
+	int same_size;
+	int same_name;
+	int same_id;
+	int has_lv;
+	int in_subsys;
+	int is_dm;
+	int has_fs;
+};
+
+/*
+ * Collect the properties of one device that are compared between
+ * duplicates, so each device is examined only once per PVID.
+ */
+static void _get_duplicate_dev_props(struct cmd_context *cmd, struct device *dev,
+				     uint64_t pvsummary_size, const char *device_hint,
+				     const char *device_id, uint16_t idtype,
+				     struct duplicate_dev_props *props)
+{
+	memset(props, 0, sizeof(*props));
+
+	if (!dev_get_size(dev, &props->size))
+		props->size = 0;
+	props->same_size = (props->size == pvsummary_size);
+
+	if (device_hint)
+		props->same_name = !strcmp(device_hint, dev_name(dev));
+
+	if (device_id && idtype &&
+	    (props->idname = device_id_system_read(cmd, dev, idtype)))
+		props->same_id = !strcmp(props->idname, device_id);
+
+	props->has_lv = dev_is_used_by_active_lv(cmd, dev, NULL, NULL, NULL, NULL);
+	props->in_subsys = dev_subsystem_part_major(cmd->dev_types, dev);
+	props->is_dm = dm_is_dm_major(MAJOR(dev->dev));
+	props->has_fs = dm_device_has_mounted_fs(MAJOR(dev->dev), MINOR(dev->dev));
+}
+
 /*
  * If we've found devices with the same PVID, decide which one
  * to use.
@@ -810,27 +1032,23 @@ static void _choose_duplicates(struct cmd_context *cmd,
 	const char *device_hint;
 	struct dm_list altdevs;
 	struct dm_list new_unused;
-	struct dev_types *dt = cmd->dev_types;
 	struct device_list *devl, *devl_safe, *devl_add, *devl_del;
 	struct lvmcache_info *info;
 	struct device *dev1, *dev2;
 	struct device *dev_mpath, *dev_md;
 	struct device *dev_drop;
+	struct duplicate_dev_props props1, props2;
 	const char *device_id = NULL, *device_id_type = NULL;
-	const char *idname1 = NULL, *idname2 = NULL;
 	uint32_t dev1_major, dev1_minor, dev2_major, dev2_minor;
-	uint64_t dev1_size, dev2_size, pvsummary_size;
-	int in_subsys1, in_subsys2;
-	int is_dm1, is_dm2;
-	int has_fs1, has_fs2;
-	int has_lv1, has_lv2;
-	int same_size1, same_size2;
-	int same_name1 = 0, same_name2 = 0;
-	int same_id1 = 0, same_id2 = 0;
+	uint64_t pvsummary_size;
+	uint16_t idtype;
+	int grouped;
 	int change;
 
 	dm_list_init(&new_unused);
 
+	grouped = _group_initial_duplicates();
+
 	/*
 	 * Create a list of all alternate devs for the same pvid: altdevs.
 	 */
@@ -847,6 +1065,8 @@ next:
 		} else {
 			if (!strcmp(pvid, devl->dev->pvid))
 				dm_list_move(&altdevs, &devl->list);
+			else if (grouped)
+				break;
 		}
 	}
 
@@ -1068,8 +1288,19 @@ next:
 
 	/*
 	 * Compare devices for the given pvid to find one that's preferred.
+	 * The pvsummary values are the same for all devices of the pvid and
+	 * the properties of each device are collected once; props1 follows
+	 * dev1 as the preferred device changes.
 	 */
 
+	pvsummary_size = _get_pvsummary_size(pvid);
+	device_hint = _get_pvsummary_device_hint(pvid);
+	idtype = 0;
+	if ((device_id = _get_pvsummary_device_id(pvid, &device_id_type)))
+		idtype = idtype_from_str(device_id_type);
+
+	_get_duplicate_dev_props(cmd, dev1, pvsummary_size, device_hint, device_id, idtype, &props1);
+
 	dm_list_iterate_items(devl, &altdevs) {
 		dev2 = devl->dev;
 
@@ -1082,136 +1313,94 @@ next:
 		dev2_major = MAJOR(dev2->dev);
 		dev2_minor = MINOR(dev2->dev);
 
-		if (!dev_get_size(dev1, &dev1_size))
-			dev1_size = 0;
-		if (!dev_get_size(dev2, &dev2_size))
-			dev2_size = 0;
-
-		pvsummary_size = _get_pvsummary_size(devl->dev->pvid);
-		same_size1 = (dev1_size == pvsummary_size);
-		same_size2 = (dev2_size == pvsummary_size);
-
-		if ((device_hint = _get_pvsummary_device_hint(devl->dev->pvid))) {
-			same_name1 = !strcmp(device_hint, dev_name(dev1));
-			same_name2 = !strcmp(device_hint, dev_name(dev2));
-		}
-
-		if ((device_id = _get_pvsummary_device_id(devl->dev->pvid, &device_id_type))) {
-			uint16_t idtype = idtype_from_str(device_id_type);
-
-			if (idtype) {
-				idname1 = device_id_system_read(cmd, dev1, idtype);
-				idname2 = device_id_system_read(cmd, dev2, idtype);
-			}
-			if (idname1)
-				same_id1 = !strcmp(idname1, device_id);
-			if (idname2)
-				same_id2 = !strcmp(idname2, device_id);
-		}
-
-		has_lv1 = dev_is_used_by_active_lv(cmd, dev1, NULL, NULL, NULL, NULL);
-		has_lv2 = dev_is_used_by_active_lv(cmd, dev2, NULL, NULL, NULL, NULL);
-
-		in_subsys1 = dev_subsystem_part_major(dt, dev1);
-		in_subsys2 = dev_subsystem_part_major(dt, dev2);
-
-		is_dm1 = dm_is_dm_major(dev1_major);
-		is_dm2 = dm_is_dm_major(dev2_major);
-
-		has_fs1 = dm_device_has_mounted_fs(dev1_major, dev1_minor);
-		has_fs2 = dm_device_has_mounted_fs(dev2_major, dev2_minor);
+		_get_duplicate_dev_props(cmd, dev2, pvsummary_size, device_hint, device_id, idtype, &props2);
 
 		log_debug_cache("PV %s compare duplicates: %s %u:%u. %s %u:%u. device_hint %s.",
-				devl->dev->pvid,
+				pvid,
 				dev_name(dev1), dev1_major, dev1_minor,
 				dev_name(dev2), dev2_major, dev2_minor,
 				device_hint ?: "none");
 
 		log_debug_cache("PV %s: device_id %s. %s is %s. %s is %s.",
-				devl->dev->pvid,
+				pvid,
 				device_id ?: ".",
-				dev_name(dev1), idname1 ?: ".",
-				dev_name(dev2), idname2 ?: ".");
+				dev_name(dev1), props1.idname ?: ".",
+				dev_name(dev2), props2.idname ?: ".");
 
 		log_debug_cache("PV %s: size %llu. %s is %llu. %s is %llu.",
-				devl->dev->pvid,
+				pvid,
 				(unsigned long long)pvsummary_size,
-				dev_name(dev1), (unsigned long long)dev1_size,
-				dev_name(dev2), (unsigned long long)dev2_size);
+				dev_name(dev1), (unsigned long long)props1.size,
+				dev_name(dev2), (unsigned long long)props2.size);
 
 		log_debug_cache("PV %s: %s %s subsystem. %s %s subsystem.",
-				devl->dev->pvid,
-				dev_name(dev1), in_subsys1 ? "is in" : "is not in",
-				dev_name(dev2), in_subsys2 ? "is in" : "is not in");
+				pvid,
+				dev_name(dev1), props1.in_subsys ? "is in" : "is not in",
+				dev_name(dev2), props2.in_subsys ? "is in" : "is not in");
 
 		log_debug_cache("PV %s: %s %s dm. %s %s dm.",
-				devl->dev->pvid,
-				dev_name(dev1), is_dm1 ? "is" : "is not",
-				dev_name(dev2), is_dm2 ? "is" : "is not");
+				pvid,
+				dev_name(dev1), props1.is_dm ? "is" : "is not",
+				dev_name(dev2), props2.is_dm ? "is" : "is not");
 
 		log_debug_cache("PV %s: %s %s mounted fs. %s %s mounted fs.",
-				devl->dev->pvid,
-				dev_name(dev1), has_fs1 ? "has" : "has no",
-				dev_name(dev2), has_fs2 ? "has" : "has no");
+				pvid,
+				dev_name(dev1), props1.has_fs ? "has" : "has no",
+				dev_name(dev2), props2.has_fs ? "has" : "has no");
 
 		log_debug_cache("PV %s: %s %s LV. %s %s LV.",
-				devl->dev->pvid,
-				dev_name(dev1), has_lv1 ? "is used for" : "is not used for",
-				dev_name(dev2), has_lv2 ? "is used for" : "is not used for");
-
-		free((void *)idname1);
-		free((void *)idname2);
-		idname1 = NULL;
-		idname2 = NULL;
+				pvid,
+				dev_name(dev1), props1.has_lv ? "is used for" : "is not used for",
+				dev_name(dev2), props2.has_lv ? "is used for" : "is not used for");
 
 		change = 0;
 
-		if (same_id1 && !same_id2) {
+		if (props1.same_id && !props2.same_id) {
 			/* keep 1 */
 			reason = "device id";
-		} else if (same_id2 && !same_id1) {
+		} else if (props2.same_id && !props1.same_id) {
 			/* change to 2 */
 			change = 1;
 			reason = "device id";
-		} else if (has_lv1 && !has_lv2) {
+		} else if (props1.has_lv && !props2.has_lv) {
 			/* keep 1 */
 			reason = "device is used by LV";
-		} else if (has_lv2 && !has_lv1) {
+		} else if (props2.has_lv && !props1.has_lv) {
 			/* change to 2 */
 			change = 1;
 			reason = "device is used by LV";
-		} else if (same_size1 && !same_size2) {
+		} else if (props1.same_size && !props2.same_size) {
 			/* keep 1 */
 			reason = "device size is correct";
-		} else if (same_size2 && !same_size1) {
+		} else if (props2.same_size && !props1.same_size) {
 			/* change to 2 */
 			change = 1;
 			reason = "device size is correct";
-		} else if (same_name1 && !same_name2) {
+		} else if (props1.same_name && !props2.same_name) {
 			/* keep 1 */
 			reason = "device name matches previous";
-		} else if (same_name2 && !same_name1) {
+		} else if (props2.same_name && !props1.same_name) {
 			/* change to 2 */
 			change = 1;
 			reason = "device name matches previous";
-		} else if (has_fs1 && !has_fs2) {
+		} else if (props1.has_fs && !props2.has_fs) {
 			/* keep 1 */
 			reason = "device has fs mounted";
-		} else if (has_fs2 && !has_fs1) {
+		} else if (props2.has_fs && !props1.has_fs) {
 			/* change to 2 */
 			change = 1;
 			reason = "device has fs mounted";
-		} else if (is_dm1 && !is_dm2) {
+		} else if (props1.is_dm && !props2.is_dm) {
 			/* keep 1 */
 			reason = "device is in dm subsystem";
-		} else if (is_dm2 && !is_dm1) {
+		} else if (props2.is_dm && !props1.is_dm) {
 			/* change to 2 */
 			change = 1;
 			reason = "device is in dm subsystem";
-		} else if (in_subsys1 && !in_subsys2) {
+		} else if (props1.in_subsys && !props2.in_subsys) {
 			/* keep 1 */
 			reason = "device is in subsystem";
-		} else if (in_subsys2 && !in_subsys1) {
+		} else if (props2.in_subsys && !props1.in_subsys) {
 			/* change to 2 */
 			change = 1;
 			reason = "device is in subsystem";
@@ -1219,12 +1408,18 @@ next:
 			reason = "device was seen first";
 		}
 
-		if (change)
+		if (change) {
 			dev1 = dev2;
+			free((void *)props1.idname);
+			props1 = props2;
+		} else
+			free((void *)props2.idname);
 
 		dev1->duplicate_prefer_reason = reason;
 	}
 
+	free((void *)props1.idname);
+
 	/*
 	 * At the end of the loop, dev1 is the device we prefer to
 	 * use.  If there's no info struct, it means there's no dev
@@ -1426,14 +1621,70 @@ int lvmcache_label_reopen_vg_rw(struct cmd_context *cmd, const char *vgname, con
  * components will be dropped.
  */
 
+/*
+ * Returns 1 if the PV gives some reason to think the dev could be an
+ * md component with the superblock at the end, see below.
+ */
+static int _need_extra_md_check(struct cmd_context *cmd, struct device *dev,
+				int md_check_start, int verbose)
+{
+	const char *device_hint = _get_pvsummary_device_hint(dev->pvid);
+	uint64_t pvsize = _get_pvsummary_size(dev->pvid);
+	uint64_t devsize = dev->size;
+	int do_check_size = 0;
+	int do_check_name = 0;
+
+	if (!devsize && !dev_get_size(dev, &devsize) && verbose)
+		log_debug("No size for %s.", dev_name(dev));
+
+	/*
+	 * PV larger than dev not common; dev larger than PV
+	 * can be common, but not as often as PV larger.
+	 */
+	if (pvsize && devsize && (pvsize != devsize))
+		do_check_size = 1;
+	if (device_hint && !strncmp(device_hint, "/dev/md", 7) &&
+	    (MAJOR(dev->dev) != cmd->dev_types->md_major))
+		do_check_name = 1;
+
+	if (!do_check_size && !do_check_name)
+		return 0;
+
+	/*
+	 * If only the size is different (which can be fairly
+	 * common for non-md-component devs) and the user has
+	 * set "start" to disable full md checks, then skip it.
+	 * If the size is different, *and* the device name hint
+	 * looks like an md device, then it seems very likely
+	 * to be an md component, so do a full check on it even
+	 * if the user has set "start".
+	 * 
+	 * In "auto" mode, do a full check if either the size
+	 * or the name indicates a possible md component.
+	 */
+	if (do_check_size && !do_check_name && md_check_start) {
+		if (verbose)
+			log_debug("extra md component check skip %llu %llu device_hint %s dev %s",
+				  (unsigned long long)pvsize, (unsigned long long)devsize,
+				  device_hint ?: "none", dev_name(dev));
+		return 0;
+	}
+
+	if (verbose)
+		log_debug("extra md component check %llu %llu device_hint %s dev %s",
+			  (unsigned long long)pvsize, (unsigned long long)devsize,
+			  device_hint ?: "none", dev_name(dev));
+
+	return 1;
+}
+
 void lvmcache_extra_md_component_checks(struct cmd_context *cmd)
 {
 	struct lvmcache_vginfo *vginfo, *vginfo2;
 	struct lvmcache_info *info, *info2;
 	struct device *dev;
 	const char *device_hint;
-	uint64_t devsize, pvsize;
-	int do_check_size, do_check_name;
+	uint64_t pvsize, tail_start, tail_len;
 	int md_check_start;
 
 	/*
@@ -1465,58 +1716,29 @@ void lvmcache_extra_md_component_checks(struct cmd_context *cmd)
 	 * If the pv/dev size mismatches are commonly occuring for
 	 * non-md-components then we'll want to stop using that as a trigger
 	 * for the full md check.
+	 *
+	 * Ends of all devs to check are prefetched first, so their reads
+	 * are in flight together rather than waited for one by one.
 	 */
 
+	dm_list_iterate_items(vginfo, &_vginfos)
+		dm_list_iterate_items(info, &vginfo->infos)
+			if (_need_extra_md_check(cmd, info->dev, md_check_start, 0) &&
+			    dev_md_tail_region(info->dev, &tail_start, &tail_len))
+				dev_prefetch_bytes(info->dev, tail_start, tail_len);
+
 	dm_list_iterate_items_safe(vginfo, vginfo2, &_vginfos) {
 		char vgid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
 		memcpy(vgid, vginfo->vgid, ID_LEN);
 
 		dm_list_iterate_items_safe(info, info2, &vginfo->infos) {
 			dev = info->dev;
-			device_hint = _get_pvsummary_device_hint(dev->pvid);
-			pvsize = _get_pvsummary_size(dev->pvid);
-			devsize = dev->size;
-			do_check_size = 0;
-			do_check_name = 0;
 
-			if (!devsize && !dev_get_size(dev, &devsize))
-				log_debug("No size for %s.", dev_name(dev));
-
-			/*
-			 * PV larger than dev not common; dev larger than PV
-			 * can be common, but not as often as PV larger.
-			 */
-			if (pvsize && devsize && (pvsize != devsize))
-				do_check_size = 1;
-			if (device_hint && !strncmp(device_hint, "/dev/md", 7) &&
-			    (MAJOR(info->dev->dev) != cmd->dev_types->md_major))
-				do_check_name = 1;
-
-			if (!do_check_size && !do_check_name)
+			if (!_need_extra_md_check(cmd, dev, md_check_start, 1))
 				continue;
 
-			/*
-			 * If only the size is different (which can be fairly
-			 * common for non-md-component devs) and the user has
-			 * set "start" to disable full md checks, then skip it.
-			 * If the size is different, *and* the device name hint
-			 * looks like an md device, then it seems very likely
-			 * to be an md component, so do a full check on it even
-			 * if the user has set "start".
-			 * 
-			 * In "auto" mode, do a full check if either the size
-			 * or the name indicates a possible md component.
-			 */
-			if (do_check_size && !do_check_name && md_check_start) {
-				log_debug("extra md component check skip %llu %llu device_hint %s dev %s",
-					  (unsigned long long)pvsize, (unsigned long long)devsize,
-					  device_hint ?: "none", dev_name(dev));
-				continue;
-			}
-
-			log_debug("extra md component check %llu %llu device_hint %s dev %s",
-				  (unsigned long long)pvsize, (unsigned long long)devsize,
-				  device_hint ?: "none", dev_name(dev));
+			device_hint = _get_pvsummary_device_hint(dev->pvid);
+			pvsize = _get_pvsummary_size(dev->pvid);
 
 			if (dev_is_md_component(cmd, dev, NULL, 1)) {
 				log_debug("Ignoring PV from md component %s with PVID %s (metadata %s %llu)",
@@ -1773,6 +1995,8 @@ static void _drop_vginfo(struct lvmcache_info *info, struct lvmcache_vginfo *vgi
 	dm_hash_remove(_vgid_hash, vginfo->vgid);
 
 	dm_list_del(&vginfo->list); /* _vginfos list */
+	_vgname_list_del(vginfo);
+	_pvsummary_hash_drop();
 
 	_free_vginfo(vginfo);
 }
@@ -1882,8 +2106,17 @@ static int _lvmcache_update_vgname(struct cmd_context *cmd,
 			return_0;
 		}
 
+		if (!_vgname_list_add(vginfo, 0)) {
+			dm_hash_remove(_vgname_hash, vgname);
+			dm_hash_remove(_vgid_hash, vginfo->vgid);
+			free(vginfo->vgname);
+			free(vginfo);
+			return_0;
+		}
+
 		/* Ensure orphans appear last on list_iterate */
 		dm_list_add(&_vginfos, &vginfo->list);
+		_pvsummary_hash_drop();
 		return 1;
 	}
 
@@ -1979,7 +2212,13 @@ static int _lvmcache_update_vgname(struct cmd_context *cmd,
 			}
 		}
 
+		if (!_vgname_list_add(vginfo, 1)) {
+			log_error("lvmcache adding vginfo to name list failed %s", vgname);
+			return 0;
+		}
+
 		dm_list_add_h(&_vginfos, &vginfo->list);
+		_pvsummary_hash_drop();
 	}
 
 	vginfo->fmt = fmt;
@@ -2072,6 +2311,8 @@ static void _lvmcache_update_pvsummaries(struct lvmcache_vginfo *vginfo, struct
 {
 	struct pv_list *pvl, *safe;
 
+	_pvsummary_hash_drop();
+
 	dm_list_init(&vginfo->pvsummaries);
 
 	dm_list_iterate_items_safe(pvl, safe, &vgsummary->pvsummaries) {
@@ -2585,6 +2826,83 @@ static void _lvmcache_destroy_info(struct lvmcache_info *info)
 	free(info);
 }
 
+/*
+ * Config trees parsed from mda text by the label scan, or by VGs that
+ * have been released.  A vg_read in the same command that finds the
+ * same text on disk (same checksum and size) imports the VG from the
+ * saved tree instead of parsing the text again.
+ */
+struct saved_cft {
+	struct dm_list list;
+	struct dm_config_tree *cft;
+	uint32_t checksum;
+	uint32_t size;
+};
+
+#define MAX_SAVED_CFTS 8
+
+static void _saved_cft_free(struct saved_cft *sc)
+{
+	dm_list_del(&sc->list);
+	config_destroy(sc->cft);
+	free(sc);
+}
+
+/* Takes over cft, which is destroyed if it is not kept. */
+void lvmcache_save_metadata_cft(struct dm_config_tree *cft, uint32_t checksum, uint32_t size)
+{
+	struct saved_cft *sc;
+
+	if (!_vgid_hash) {
+		config_destroy(cft);
+		return;
+	}
+
+	dm_list_iterate_items(sc, &_saved_cfts)
+		if ((sc->checksum == checksum) && (sc->size == size)) {
+			config_destroy(cft);
+			return;
+		}
+
+	if (!(sc = malloc(sizeof(*sc)))) {
+		config_destroy(cft);
+		return;
+	}
+
+	sc->cft = cft;
+	sc->checksum = checksum;
+	sc->size = size;
+	dm_list_add_h(&_saved_cfts, &sc->list);
+
+	if (dm_list_size(&_saved_cfts) > MAX_SAVED_CFTS)
+		_saved_cft_free(dm_list_item(dm_list_last(&_saved_cfts), struct saved_cft));
+}
+
+/* The caller owns the returned tree. */
+struct dm_config_tree *lvmcache_take_metadata_cft(uint32_t checksum, uint32_t size)
+{
+	struct dm_config_tree *cft;
+	struct saved_cft *sc;
+
+	dm_list_iterate_items(sc, &_saved_cfts)
+		if ((sc->checksum == checksum) && (sc->size == size)) {
+			cft = sc->cft;
+			dm_list_del(&sc->list);
+			free(sc);
+			return cft;
+		}
+
+	return NULL;
+}
+
+static void _saved_cfts_drop(void)
+{
+	struct saved_cft *sc, *sc2;
+
+	dm_list_iterate_items_safe(sc, sc2, &_saved_cfts)
+		_saved_cft_free(sc);
+}
+
 void lvmcache_destroy(struct cmd_context *cmd, int retain_orphans, int reset)
 {
 	struct lvmcache_vginfo *vginfo, *vginfo2;
@@ -2607,11 +2925,20 @@ void lvmcache_destroy(struct cmd_context *cmd, int retain_orphans, int reset)
 		_vgname_hash = NULL;
 	}
 
+	_pvsummary_hash_drop();
+	_saved_cfts_drop();
+
 	dm_list_iterate_items_safe(vginfo, vginfo2, &_vginfos) {
 		dm_list_del(&vginfo->list);
+		_vgname_list_del(vginfo);
 		_free_vginfo(vginfo);
 	}
 
+	if (_vgname_lists_hash) {
+		dm_hash_destroy(_vgname_lists_hash);
+		_vgname_lists_hash = NULL;
+	}
+
 	if (!dm_list_empty(&_vginfos))
 		log_error(INTERNAL_ERROR "vginfos list should be empty");
 
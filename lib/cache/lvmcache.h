@@ -66,6 +66,9 @@ int lvmcache_init(struct cmd_context *cmd);
 
 void lvmcache_destroy(struct cmd_context *cmd, int retain_orphans, int reset);
 
+void lvmcache_save_metadata_cft(struct dm_config_tree *cft, uint32_t checksum, uint32_t size);
+struct dm_config_tree *lvmcache_take_metadata_cft(uint32_t checksum, uint32_t size);
+
 int lvmcache_label_scan(struct cmd_context *cmd);
 int lvmcache_label_rescan_vg(struct cmd_context *cmd, const char *vgname, const char *vgid);
 int lvmcache_label_rescan_vg_rw(struct cmd_context *cmd, const char *vgname, const char *vgid);
@@ -228,4 +231,8 @@ unsigned int lvmcache_vg_info_count(void);
 
 int lvmcache_pvsummary_count(const char *vgname);
 
+struct volume_group *lvmcache_vg_from_summary(struct cmd_context *cmd,
+					      const char *vgname, const char *vgid);
+uint32_t lvmcache_seqno_from_vgid(const char *vgid);
+
 #endif
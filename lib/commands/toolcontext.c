@@ -38,9 +38,14 @@
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/utsname.h>
+#include <sys/vfs.h>
 #include <syslog.h>
 #include <time.h>
 
+#ifdef HAVE_LINUX_MAGIC_H
+#include <linux/magic.h> /* SYSFS_MAGIC */
+#endif
+
 #ifdef APP_MACHINEID_SUPPORT
 #include <systemd/sd-id128.h>
 #endif
@@ -223,6 +228,9 @@ static void _get_sysfs_dir(struct cmd_context *cmd, char *buf, size_t buf_size)
 	static char *split[4], buffer[PATH_MAX + 16];
 	FILE *fp;
 	char *sys_mnt = NULL;
+#ifdef SYSFS_MAGIC
+	struct statfs sfs;
+#endif
 
 	*buf = '\0';
 
@@ -231,6 +239,15 @@ static void _get_sysfs_dir(struct cmd_context *cmd, char *buf, size_t buf_size)
 		return;
 	}
 
+#ifdef SYSFS_MAGIC
+	/* Avoid reading all mounts when sysfs is where it usually is. */
+	if (!strcmp(cmd->proc_dir, DEFAULT_PROC_DIR) &&
+	    !statfs("/sys", &sfs) && (sfs.f_type == SYSFS_MAGIC)) {
+		dm_strncpy(buf, "/sys", buf_size);
+		return;
+	}
+#endif
+
 	if (dm_snprintf(proc_mounts, sizeof(proc_mounts),
 			 "%s/mounts", cmd->proc_dir) < 0) {
 		log_error("Failed to create /proc/mounts string for sysfs detection");
@@ -1602,6 +1619,19 @@ int init_run_by_dmeventd(struct cmd_context *cmd)
 	return 0;
 }
 
+/*
+ * Long lived processes empty cmd->mem after each command,
+ * keep its chunks for the next command to save malloc churn
+ * and page faults, mostly seen with large VGs.
+ */
+#define CMD_POOL_CHUNK_CACHE (8 * 1024 * 1024)
+
+void init_pool_chunk_cache(struct cmd_context *cmd)
+{
+	dm_pool_set_chunk_cache(cmd->mem, CMD_POOL_CHUNK_CACHE, DM_POOL_CACHE_HUGEPAGE);
+	dm_pool_set_chunk_cache(cmd->libmem, CMD_POOL_CHUNK_CACHE, DM_POOL_CACHE_HUGEPAGE);
+}
+
 void destroy_config_context(struct cmd_context *cmd)
 {
 	_destroy_config(cmd);
@@ -1768,6 +1798,7 @@ struct cmd_context *create_toolcontext(unsigned is_clvmd,
 		goto_out;
 
 	init_use_aio(find_config_tree_bool(cmd, global_use_aio_CFG, NULL));
+	init_use_io_uring(find_config_tree_bool(cmd, global_use_io_uring_CFG, NULL));
 
 	if (!_init_dev_cache(cmd))
 		goto_out;
@@ -2035,9 +2066,6 @@ void destroy_toolcontext(struct cmd_context *cmd)
 	if ((cft_cmdline = remove_config_tree_by_source(cmd, CONFIG_STRING)))
 		config_destroy(cft_cmdline);
 
-	if (cmd->cft_def_hash)
-		dm_hash_destroy(cmd->cft_def_hash);
-
 	if (!cmd->running_on_valgrind && cmd->linebuffer) {
 		int flags;
 		/* Reset stream buffering to defaults */
@@ -2064,6 +2092,9 @@ void destroy_toolcontext(struct cmd_context *cmd)
 
 	destroy_config_context(cmd);
 
+	/* Memory usage per pool, shown with debug class memory. */
+	dm_pools_dump_stats();
+
 	lvmpolld_disconnect();
 
 	activation_exit();
@@ -25,6 +25,14 @@
 /*
  * Config options that can be changed while commands are processed
  */
+/* VG changed by commands, named in lvmnotify notifications */
+#define NOTIFY_VGS_MAX 32
+struct notify_vg {
+	char name[NAME_LEN];
+	char uuid[64];
+	uint32_t seqno;
+};
+
 struct config_info {
 	int debug;
 	int debug_classes;
@@ -77,6 +85,8 @@ struct cmd_report {
 	struct dm_report *log_rh;
 	const char *log_name;
 	log_report_t saved_log_report_state;
+	dm_report_row_fn_t row_fn;	/* if set, rows go here instead of output */
+	void *row_fn_private;
 };
 
 /* FIXME Split into tool & library contexts */
@@ -137,7 +147,7 @@ struct cmd_context {
 	/*
 	 * Switches.
 	 */
-	unsigned is_long_lived:1;		/* optimises persistent_filter handling */
+	unsigned is_long_lived:1;		/* runs multiple commands, e.g. lvm shell */
 	unsigned is_interactive:1;
 	unsigned running_on_valgrind:1;
 	unsigned check_pv_dev_sizes:1;
@@ -176,6 +186,9 @@ struct cmd_context {
 	unsigned vg_notify:1;
 	unsigned lv_notify:1;
 	unsigned pv_notify:1;
+	unsigned notify_vg_multiple:1;		/* changes span more VGs than notify_vgs holds */
+	unsigned notify_batch:1;		/* shell or script, notify once at the end */
+	unsigned notify_dbus_pending:1;		/* batch has changes to send over D-Bus */
 	unsigned activate_component:1;		/* command activates component LV */
 	unsigned process_component_lvs:1;	/* command processes also component LVs */
 	unsigned mirror_warn_printed:1;		/* command already printed warning about non-monitored mirrors */
@@ -236,7 +249,6 @@ struct cmd_context {
 	struct dm_list config_files; 		/* master lvm config + any existing tag configs */
 	struct profile_params *profile_params;	/* profile handling params including loaded profile configs */
 	struct dm_config_tree *cft;		/* the whole cascade: CONFIG_STRING -> CONFIG_PROFILE -> CONFIG_FILE/CONFIG_MERGED_FILES */
-	struct dm_hash_table *cft_def_hash;	/* config definition hash used for validity check (item type + item recognized) */
 	struct config_info default_settings;	/* selected settings with original default/configured value which can be changed during cmd processing */
 	struct config_info current_settings; 	/* may contain changed values compared to default_settings */
 
@@ -274,6 +286,9 @@ struct cmd_context {
 	char display_buffer[NAME_LEN * 10];	/* ring buffer for upto 10 longest vg/lv names */
 	unsigned display_lvname_idx;		/* index to ring buffer */
 	char *linebuffer;
+	struct notify_vg notify_vgs[NOTIFY_VGS_MAX];	/* VGs changed for lvmnotify */
+	unsigned notify_vg_count;
+	const char *notify_socket_pending;	/* notify_socket to send batch changes to */
 
 	/*
 	 * Others - unsorted.
@@ -281,6 +296,7 @@ struct cmd_context {
 	const char *report_list_item_separator;
 	const char *time_format;
 	unsigned rand_seed;
+	unsigned vg_workers;			/* VGs processed at once in workers */
 	struct dm_list pending_delete;		/* list of LVs for removal */
 	struct dm_pool *pending_delete_mem;	/* memory pool for pending deletes */
 	struct vdo_convert_params *lvcreate_vcp;/* params for LV to VDO conversion */
@@ -306,6 +322,7 @@ int init_lvmcache_orphans(struct cmd_context *cmd);
 int init_filters(struct cmd_context *cmd, unsigned load_persistent_cache);
 int init_connections(struct cmd_context *cmd);
 int init_run_by_dmeventd(struct cmd_context *cmd);
+void init_pool_chunk_cache(struct cmd_context *cmd);
 
 /*
  * A config context is a very light weight cmd struct that
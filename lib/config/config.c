@@ -265,7 +265,7 @@ struct dm_config_tree *config_file_open_and_read(const char *config_file,
 	}
 
 	log_very_verbose("Loading config file: %s", config_file);
-	if (!config_file_read_from_file(cft)) {
+	if (!config_file_read_from_file(cft, 0)) {
 		log_error("Failed to load config file %s", config_file);
 		goto bad;
 	}
@@ -491,6 +491,7 @@ int config_file_read_fd(struct dm_config_tree *cft, struct device *dev, dev_io_r
 	char *fb, *fe;
 	int r = 0;
 	int sz, use_plain_read = 1;
+	int in_place = 0;
 	char *buf = NULL;
 	struct config_source *cs = dm_config_get_custom(cft);
 	size_t rsize;
@@ -506,9 +507,22 @@ int config_file_read_fd(struct dm_config_tree *cft, struct device *dev, dev_io_r
 	if (!(dev->flags & DEV_REGULAR) || size2)
 		use_plain_read = 0;
 
+	/*
+	 * Metadata read from a device is parsed in place, so the tree uses
+	 * strings in the buffer and the buffer lives in the tree's pool.
+	 */
+	if (!(dev->flags & DEV_REGULAR) && !checksum_only)
+		in_place = 1;
+
 	/* Ensure there is extra '\0' after end of buffer since we pass
 	 * buffer to funtions like strtoll() */
-	if (!(buf = zalloc(size + size2 + 1))) {
+	if (in_place) {
+		if ((buf = dm_pool_alloc(cft->mem, size + size2 + 1)))
+			buf[size + size2] = '\0';
+	} else
+		buf = zalloc(size + size2 + 1);
+
+	if (!buf) {
 		log_error("Failed to allocate circular buffer.");
 		return 0;
 	}
@@ -572,7 +586,10 @@ int config_file_read_fd(struct dm_config_tree *cft, struct device *dev, dev_io_r
 
 	if (!checksum_only) {
 		fe = fb + size + size2;
-		if (no_dup_node_check) {
+		if (in_place) {
+			if (!dm_config_parse_in_place(cft, fb, fe, no_dup_node_check))
+				goto_out;
+		} else if (no_dup_node_check) {
 			if (!dm_config_parse_without_dup_node_check(cft, fb, fe))
 				goto_out;
 		} else {
@@ -584,12 +601,13 @@ int config_file_read_fd(struct dm_config_tree *cft, struct device *dev, dev_io_r
 	r = 1;
 
       out:
-	free(buf);
+	if (!in_place)
+		free(buf);
 
 	return r;
 }
 
-int config_file_read_from_file(struct dm_config_tree *cft)
+int config_file_read_from_file(struct dm_config_tree *cft, int no_dup_node_check)
 {
 	const char *filename = NULL;
 	struct config_source *cs = dm_config_get_custom(cft);
@@ -635,7 +653,7 @@ int config_file_read_from_file(struct dm_config_tree *cft)
 	cf->dev = &fake_dev;
 
 	r = config_file_read_fd(cft, cf->dev, DEV_IO_MDA_CONTENT, 0, (size_t) info.st_size, 0, 0,
-				(checksum_fn_t) NULL, 0, 0, 0);
+				(checksum_fn_t) NULL, 0, 0, no_dup_node_check);
 
 	free((void*)alias->str);
 	free((void*)alias);
@@ -683,6 +701,89 @@ static int _cfg_def_make_path(char *buf, size_t buf_size, int id, const cfg_def_
 	return count + n;
 }
 
+/*
+ * Paths of config items never change, so the config tree getters
+ * resolve each one once and reuse it instead of walking the parent
+ * chain on every lookup.  Values are not cached: they depend on the
+ * current cmd->cft cascade and profile.
+ */
+static char _cfg_def_paths[CFG_COUNT + 1][CFG_PATH_MAX_LEN];
+
+static const char *_cfg_def_path(const cfg_def_item_t *item)
+{
+	char *path = _cfg_def_paths[item->id];
+
+	if (!*path)
+		_cfg_def_make_path(path, CFG_PATH_MAX_LEN, item->id, item, 0);
+
+	return path;
+}
+
+/*
+ * Child lists of config sections, for the validity check to resolve
+ * config node paths component by component.  Built once, as the paths
+ * above, and cheaper than hashing the path of every config item.
+ * Item ids are never 0 (the root) so 0 ends a list.
+ */
+static int _cfg_def_children[CFG_COUNT];
+static int _cfg_def_next_sibling[CFG_COUNT];
+static int _cfg_def_children_built;
+
+static void _cfg_def_children_build(void)
+{
+	int last[CFG_COUNT] = { 0 };
+	int id, parent;
+
+	for (id = 1; id < CFG_COUNT; id++) {
+		parent = _cfg_def_items[id].parent;
+		if (last[parent])
+			_cfg_def_next_sibling[last[parent]] = id;
+		else
+			_cfg_def_children[parent] = id;
+		last[parent] = id;
+	}
+
+	_cfg_def_children_built = 1;
+}
+
+/* Find the config item for path vp, '#' standing for a variable name. */
+static cfg_def_item_t *_cfg_def_find(const char *vp)
+{
+	const cfg_def_item_t *def = NULL;
+	const cfg_def_item_t *item;
+	const char *name = vp, *end;
+	size_t len;
+	int parent = root_CFG_SECTION;
+	int id;
+
+	if (!_cfg_def_children_built)
+		_cfg_def_children_build();
+
+	while (*name) {
+		if (!(end = strchr(name, '/')))
+			end = name + strlen(name);
+		len = end - name;
+
+		/* The last defined item wins for the same path. */
+		def = NULL;
+		for (id = _cfg_def_children[parent]; id; id = _cfg_def_next_sibling[id]) {
+			item = cfg_def_get_item_p(id);
+			if ((item->flags & CFG_NAME_VARIABLE) ?
+			    (len == 1 && *name == '#') :
+			    (!strncmp(item->name, name, len) && !item->name[len]))
+				def = item;
+		}
+
+		if (!def)
+			return NULL;
+
+		parent = def->id;
+		name = *end ? end + 1 : end;
+	}
+
+	return (cfg_def_item_t *) def;
+}
+
 int config_def_get_path(char *buf, size_t buf_size, int id)
 {
 	return _cfg_def_make_path(buf, buf_size, id, cfg_def_get_item_p(id), 0);
@@ -1060,7 +1161,7 @@ static int _config_def_check_node(struct cft_check_handle *handle,
 	}
 
 
-	if (!(def = (cfg_def_item_t *) dm_hash_lookup(handle->cmd->cft_def_hash, vp))) {
+	if (!(def = _cfg_def_find(vp))) {
 		/* If the node is not a section but a setting, fail now. */
 		if (cn->v) {
 			log_warn_suppress(handle->suppress_messages,
@@ -1073,7 +1174,7 @@ static int _config_def_check_node(struct cft_check_handle *handle,
 		/* Modify virtual path vp in situ and replace the key name with a '#'. */
 		/* The real path without '#' is still stored in rp variable. */
 		pvp[sep] = '#', pvp[sep + 1] = '\0';
-		if (!(def = (cfg_def_item_t *) dm_hash_lookup(handle->cmd->cft_def_hash, vp))) {
+		if (!(def = _cfg_def_find(vp))) {
 			log_warn_suppress(handle->suppress_messages,
 				"Configuration section \"%s\" unknown.", rp);
 			cn->id = -1;
@@ -1132,7 +1233,6 @@ static int _config_def_check_tree(struct cft_check_handle *handle,
 
 int config_def_check(struct cft_check_handle *handle)
 {
-	const cfg_def_item_t *def;
 	struct dm_config_node *cn;
 	char vp[CFG_PATH_MAX_LEN], rp[CFG_PATH_MAX_LEN];
 	size_t rplen;
@@ -1140,7 +1240,7 @@ int config_def_check(struct cft_check_handle *handle)
 
 	/*
 	 * vp = virtual path, it might contain substitutes for variable parts
-	 * 	of the path, used while working with the hash
+	 * 	of the path, used to look up the config item
 	 * rp = real path, the real path of the config element as found in the
 	 *      configuration, used for message output
 	 */
@@ -1162,32 +1262,8 @@ int config_def_check(struct cft_check_handle *handle)
 	for (id = 0; id < CFG_COUNT; id++)
 		handle->status[id] &= ~(CFG_USED | CFG_VALID | CFG_DIFF);
 
-	/*
-	 * Create a hash of all possible configuration
-	 * sections and settings with full path as a key.
-	 * If section name is variable, use '#' as a substitute.
-	 */
 	*vp = 0;
 	*rp = 0;
-	if (!handle->cmd->cft_def_hash) {
-		if (!(handle->cmd->cft_def_hash = dm_hash_create(500))) {
-			log_error("Failed to create configuration definition hash.");
-			r = 0; goto out;
-		}
-		for (id = 1; id < CFG_COUNT; id++) {
-			def = cfg_def_get_item_p(id);
-			if (!_cfg_def_make_path(vp, CFG_PATH_MAX_LEN, def->id, def, 0)) {
-				dm_hash_destroy(handle->cmd->cft_def_hash);
-				handle->cmd->cft_def_hash = NULL;
-				r = 0; goto out;
-			}
-			if (!dm_hash_insert(handle->cmd->cft_def_hash, vp, (void*)def)) {
-				log_error("Failed to insert configuration to hash.");
-				r = 0;
-				goto out;
-			}
-		}
-	}
 
 	/*
 	 * Mark this handle as used so next time we know that the check
@@ -1221,7 +1297,6 @@ int config_def_check(struct cft_check_handle *handle)
 			r = 0;
 		}
 	}
-out:
 	if (r)
 		handle->status[root_CFG_SECTION] |= CFG_VALID;
 	else
@@ -1260,10 +1335,9 @@ static int _config_disabled(struct cmd_context *cmd, const cfg_def_item_t *item,
 const struct dm_config_node *find_config_node(struct cmd_context *cmd, struct dm_config_tree *cft, int id)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	const struct dm_config_node *cn;
 
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	cn = dm_config_tree_find_node(cft, path);
 
@@ -1273,12 +1347,11 @@ const struct dm_config_node *find_config_node(struct cmd_context *cmd, struct dm
 const struct dm_config_node *find_config_tree_node(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	const struct dm_config_node *cn;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	cn = dm_config_tree_find_node(cmd->cft, path);
 
@@ -1291,12 +1364,11 @@ const struct dm_config_node *find_config_tree_node(struct cmd_context *cmd, int
 const char *find_config_tree_str(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	const char *str;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_STRING)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as string.", path);
@@ -1314,12 +1386,11 @@ const char *find_config_tree_str(struct cmd_context *cmd, int id, struct profile
 const char *find_config_tree_str_allow_empty(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	const char *str;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_STRING)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as string.", path);
@@ -1339,12 +1410,11 @@ const char *find_config_tree_str_allow_empty(struct cmd_context *cmd, int id, st
 int find_config_tree_int(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	int i;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_INT)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as integer.", path);
@@ -1362,12 +1432,11 @@ int find_config_tree_int(struct cmd_context *cmd, int id, struct profile *profil
 int64_t find_config_tree_int64(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	int i64;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_INT)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as integer.", path);
@@ -1385,12 +1454,11 @@ int64_t find_config_tree_int64(struct cmd_context *cmd, int id, struct profile *
 float find_config_tree_float(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	float f;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_FLOAT)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as float.", path);
@@ -1408,10 +1476,9 @@ float find_config_tree_float(struct cmd_context *cmd, int id, struct profile *pr
 int find_config_bool(struct cmd_context *cmd, struct dm_config_tree *cft, int id)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int b;
 
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_BOOL)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as boolean.", path);
@@ -1426,12 +1493,11 @@ int find_config_bool(struct cmd_context *cmd, struct dm_config_tree *cft, int id
 int find_config_tree_bool(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	int b;
 
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (item->type != CFG_TYPE_BOOL)
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as boolean.", path);
@@ -1520,11 +1586,10 @@ static void _log_array_value_used(struct dm_pool *mem, const struct dm_config_no
 const struct dm_config_node *find_config_tree_array(struct cmd_context *cmd, int id, struct profile *profile)
 {
 	const cfg_def_item_t *item = cfg_def_get_item_p(id);
-	char path[CFG_PATH_MAX_LEN];
+	const char *path = _cfg_def_path(item);
 	int profile_applied;
 	const struct dm_config_node *cn = NULL, *cn_def = NULL;
 	profile_applied = _apply_local_profile(cmd, profile);
-	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
 	if (!(item->type & CFG_TYPE_ARRAY))
 		log_error(INTERNAL_ERROR "%s cfg tree element not declared as array.", path);
@@ -261,6 +261,13 @@ cfg(devices_hints_CFG, "hints", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_
 	"    Use no hints.\n"
 	"#\n")
 
+cfg(devices_scan_cache_CFG, "scan_cache", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_SCAN_CACHE, vsn(2, 3, 26), NULL, 0, NULL,
+	"Use a local file to remember VG summaries read from metadata.\n"
+	"Entries are found by the metadata checksum and size in the mda\n"
+	"header, so scanning can skip reading and parsing the metadata\n"
+	"text of VGs that have not changed since the file was written.\n"
+	"The file is a cache and may be removed at any time.\n")
+
 cfg_array(devices_preferred_names_CFG, "preferred_names", devices_CFG_SECTION, CFG_ALLOW_EMPTY | CFG_DEFAULT_UNDEFINED , CFG_TYPE_STRING, NULL, vsn(1, 2, 19), NULL, 0, NULL,
 	"Select which path name to display for a block device.\n"
 	"If multiple path names exist for a block device, and LVM needs to\n"
@@ -1169,6 +1176,11 @@ cfg(global_lvmetad_update_wait_time_CFG, "lvmetad_update_wait_time", global_CFG_
 cfg(global_use_aio_CFG, "use_aio", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_USE_AIO, vsn(2, 2, 183), NULL, 0, NULL,
 	"Use async I/O when reading and writing devices.\n")
 
+cfg(global_use_io_uring_CFG, "use_io_uring", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_USE_IO_URING, vsn(2, 3, 26), NULL, 0, NULL,
+	"Use io_uring for async I/O when reading and writing devices.\n"
+	"Applicable only when use_aio is enabled. If the kernel does not\n"
+	"support io_uring, or it is disabled, libaio is used instead.\n")
+
 cfg(global_use_lvmlockd_CFG, "use_lvmlockd", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, 0, vsn(2, 2, 124), NULL, 0, NULL,
 	"Use lvmlockd for locking among hosts using LVM on shared storage.\n"
 	"Applicable only if LVM is compiled with lockd support in which\n"
@@ -1287,6 +1299,16 @@ cfg_array(global_cache_check_options_CFG, "cache_check_options", global_CFG_SECT
 	"With cache_check version 5.0 or newer you should include the option\n"
 	"--clear-needs-check-flag.\n")
 
+cfg(global_pool_check_skip_clean_CFG, "pool_check_skip_clean", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_POOL_CHECK_SKIP_CLEAN, vsn(2, 3, 26), NULL, 0, NULL,
+	"Skip thin_check and cache_check on activation of a pool whose\n"
+	"metadata passed the check at its last deactivation and has not\n"
+	"changed since, i.e. same transaction id and metadata LV.\n"
+	"The result of that check is remembered under the run directory\n"
+	"until the next activation of the pool or next reboot.\n"
+	"Do not enable when pool metadata may be modified other than\n"
+	"through activation of the pool, e.g. with thin_repair on\n"
+	"component metadata LV.\n")
+
 cfg_array(global_cache_repair_options_CFG, "cache_repair_options", global_CFG_SECTION, CFG_ALLOW_EMPTY | CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, DEFAULT_CACHE_REPAIR_OPTIONS_CONFIG, vsn(2, 2, 108), NULL, 0, NULL,
 	"List of options passed to the cache_repair command.\n")
 
@@ -1370,6 +1392,16 @@ cfg(global_notify_dbus_CFG, "notify_dbus", global_CFG_SECTION, CFG_DEFAULT_COMME
 	"When enabled, an LVM command that changes PVs, changes VG metadata,\n"
 	"or changes the activation state of an LV will send a notification.\n")
 
+cfg(global_notify_socket_CFG, "notify_socket", global_CFG_SECTION, CFG_DEFAULT_UNDEFINED, CFG_TYPE_STRING, NULL, vsn(2, 3, 26), NULL, 0, NULL,
+	"Path of a Unix datagram socket that LVM commands notify of changes.\n"
+	"Like notify_dbus, for programs not using D-Bus. Each notification\n"
+	"is one datagram of text lines: 'command <name>', then either a line\n"
+	"'vg <vg_name> <vg_uuid> <vg_seqno>' for each VG changed, or the line\n"
+	"'all' when the changes are not limited to known VGs. Nothing is sent\n"
+	"when no program is bound to the socket or its queue is full.\n"
+	"Commands run from lvm shell with input that is not a terminal, or\n"
+	"from a script, notify once when all of them have finished.\n")
+
 cfg(global_io_memory_size_CFG, "io_memory_size", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_IO_MEMORY_SIZE_KB, vsn(2, 3, 2), NULL, 0, NULL,
 	"The amount of memory in KiB that LVM allocates to perform disk io.\n"
 	"LVM performance may benefit from more io memory when there are many\n"
@@ -1392,7 +1424,11 @@ cfg(activation_udev_rules_CFG, "udev_rules", activation_CFG_SECTION, CFG_DEFAULT
 	"Use udev rules to manage LV device nodes and symlinks.\n"
 	"When disabled, LVM will manage the device nodes and symlinks for\n"
 	"active LVs itself. Manual intervention may be required if this\n"
-	"setting is changed while LVs are active.\n")
+	"setting is changed while LVs are active.\n"
+	"Disabling this together with udev_sync makes activation independent\n"
+	"of udev rule processing: LVM creates the nodes and symlinks as each\n"
+	"LV is activated and does not wait for udev, while the kernel still\n"
+	"sends uevents for other consumers of the devices.\n")
 
 cfg(activation_verify_udev_operations_CFG, "verify_udev_operations", activation_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_VERIFY_UDEV_OPERATIONS, vsn(2, 2, 86), NULL, 0, NULL,
 	"Use extra checks in LVM to verify udev operations.\n"
@@ -1781,6 +1817,12 @@ cfg(metadata_lvs_history_retention_time_CFG, "lvs_history_retention_time", metad
 	"historical logical volume is automatically destroyed.\n"
 	"A value of 0 disables this feature.\n")
 
+cfg(metadata_lvs_history_max_count_CFG, "lvs_history_max_count", metadata_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_LVS_HISTORY_MAX_COUNT, vsn(2, 3, 26), NULL, 0, NULL,
+	"Maximum number of records about historical logical volumes kept\n"
+	"in VG metadata. When there are more, the records of the LVs\n"
+	"removed first are automatically destroyed.\n"
+	"A value of 0 disables this feature.\n")
+
 cfg(metadata_pvmetadatacopies_CFG, "pvmetadatacopies", metadata_CFG_SECTION, CFG_ADVANCED | CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_PVMETADATACOPIES, vsn(1, 0, 0), NULL, 0, NULL,
 	"Number of copies of metadata to store on each PV.\n"
 	"The --pvmetadatacopies option overrides this setting.\n"
@@ -2192,7 +2234,9 @@ cfg(dmeventd_thin_command_CFG, "thin_command", dmeventd_CFG_SECTION, CFG_DEFAULT
 	"or metadata volume gets above 50%.\n"
 	"Command which starts with 'lvm ' prefix is internal lvm command.\n"
 	"You can write your own handler to customise behaviour in more details.\n"
-	"User handler is specified with the full path starting with '/'.\n")
+	"User handler is specified with the full path starting with '/'.\n"
+	"Internal lvm commands for all monitored pools run one at a time,\n"
+	"a user handler runs as a separate process for each pool.\n")
 	/* TODO: systemd service handler */
 
 cfg(dmeventd_vdo_library_CFG, "vdo_library", dmeventd_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, DEFAULT_DMEVENTD_VDO_LIB, VDO_1ST_VSN, NULL, 0, NULL,
@@ -2206,7 +2250,9 @@ cfg(dmeventd_vdo_command_CFG, "vdo_command", dmeventd_CFG_SECTION, CFG_DEFAULT_C
 	"gets above 50%.\n"
 	"Command which starts with 'lvm ' prefix is internal lvm command.\n"
 	"You can write your own handler to customise behaviour in more details.\n"
-	"User handler is specified with the full path starting with '/'.\n")
+	"User handler is specified with the full path starting with '/'.\n"
+	"Internal lvm commands for all monitored pools run one at a time,\n"
+	"a user handler runs as a separate process for each pool.\n")
 	/* TODO: systemd service handler */
 
 cfg(dmeventd_executable_CFG, "executable", dmeventd_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, DEFAULT_DMEVENTD_PATH, vsn(2, 2, 73), "@DMEVENTD_PATH@", 0, NULL,
@@ -70,6 +70,8 @@
 #define DEFAULT_LVDISPLAY_SHOWS_FULL_DEVICE_PATH 0
 #define DEFAULT_UNKNOWN_DEVICE_NAME "[unknown]"
 #define DEFAULT_USE_AIO 1
+#define DEFAULT_USE_IO_URING 1
+#define DEFAULT_POOL_CHECK_SKIP_CLEAN 0
 
 #define DEFAULT_SANLOCK_LV_EXTEND_MB 256
 
@@ -198,6 +200,7 @@
 #define DEFAULT_STRIPESIZE 64	/* KB */
 #define DEFAULT_RECORD_LVS_HISTORY 0
 #define DEFAULT_LVS_HISTORY_RETENTION_TIME 0
+#define DEFAULT_LVS_HISTORY_MAX_COUNT 0
 #define DEFAULT_PVMETADATAIGNORE 0
 #define DEFAULT_PVMETADATACOPIES 1
 #define DEFAULT_VGMETADATACOPIES 0
@@ -256,6 +259,7 @@
 #define DEFAULT_STRIPE_FILLER "error"
 #define DEFAULT_RAID_REGION_SIZE   2048	/* KB */
 #define DEFAULT_INTERVAL 15
+#define DEFAULT_FOLLOW_INTERVAL 2
 
 #define DEFAULT_MAX_HISTORY 100
 
@@ -322,6 +326,7 @@
 #define DEFAULT_SCAN_LVS 0
 
 #define DEFAULT_HINTS "all"
+#define DEFAULT_SCAN_CACHE 0
 
 #define DEFAULT_IO_MEMORY_SIZE_KB 8192
 
@@ -336,6 +341,7 @@
 #define PVS_ONLINE_DIR DEFAULT_RUN_DIR "/pvs_online"
 #define VGS_ONLINE_DIR DEFAULT_RUN_DIR "/vgs_online"
 #define PVS_LOOKUP_DIR DEFAULT_RUN_DIR "/pvs_lookup"
+#define POOLS_CHECKED_DIR DEFAULT_RUN_DIR "/pools_checked"
 
 #define DEVICES_IMPORT_PATH DEFAULT_RUN_DIR "/lvm-devices-import"
 
@@ -80,6 +80,81 @@ bool bcache_read_bytes(struct bcache *cache, int di, uint64_t start, size_t len,
 	return true;
 }
 
+// O_DIRECT alignment that covers 512 and 4096 byte logical blocks.
+#define DIRECT_ALIGN 4096
+
+static uint64_t _max(uint64_t lhs, uint64_t rhs)
+{
+	if (rhs > lhs)
+		return rhs;
+
+	return lhs;
+}
+
+bool bcache_read_bytes_direct(struct bcache *cache, int di, uint64_t start, size_t len, void *data)
+{
+	struct block *b;
+	block_address bb, be, i, first = 0, last = 0;
+	uint64_t block_size = bcache_block_sectors(cache) << SECTOR_SHIFT;
+	uint64_t rstart, rend, cstart, cend;
+	unsigned char *buf;
+	bool uncached = false;
+	bool r = false;
+
+	if (!len)
+		return true;
+
+	byte_range_to_block_range(cache, start, len, &bb, &be);
+
+	for (i = bb; i != be; i++)
+		if (!bcache_is_cached(cache, di, i)) {
+			if (!uncached)
+				first = i;
+			last = i;
+			uncached = true;
+		}
+
+	if (!uncached)
+		return bcache_read_bytes(cache, di, start, len, data);
+
+	// Only the span from the first to the last uncached block is read.
+	rstart = _max(start, first * block_size) & ~(uint64_t) (DIRECT_ALIGN - 1);
+	rend = _min(start + len, (last + 1) * block_size);
+	rend = (rend + DIRECT_ALIGN - 1) & ~(uint64_t) (DIRECT_ALIGN - 1);
+
+	if (posix_memalign((void **) &buf, DIRECT_ALIGN, rend - rstart))
+		return false;
+
+	if (!bcache_read_direct(cache, di, rstart, rend - rstart, buf))
+		goto out;
+
+	for (i = bb; i != be; i++) {
+		cstart = _max(start, i * block_size);
+		cend = _min(start + len, (i + 1) * block_size);
+
+		if (!bcache_is_cached(cache, di, i)) {
+			memcpy((unsigned char *) data + (cstart - start), buf + (cstart - rstart), cend - cstart);
+			continue;
+		}
+
+		// Cached blocks may be newer than the disk, so they are used.
+		if (!bcache_get(cache, di, i, 0, &b))
+			goto out;
+
+		memcpy((unsigned char *) data + (cstart - start),
+		       (unsigned char *) b->data + (cstart - i * block_size), cend - cstart);
+		bcache_put(b);
+	}
+
+	r = true;
+out:
+	free(buf);
+
+	return r;
+}
+
+//----------------------------------------------------------------
+
 bool bcache_invalidate_bytes(struct bcache *cache, int di, uint64_t start, size_t len)
 {
 	block_address bb, be;
@@ -15,6 +15,7 @@
 #include "lib/device/bcache.h"
 
 #include "base/data-struct/radix-tree.h"
+#include "base/memory/zalloc.h"
 #include "lib/log/lvm-logging.h"
 #include "lib/log/log.h"
 
@@ -30,12 +31,21 @@
 #include <unistd.h>
 #include <linux/fs.h>
 #include <sys/user.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#endif
 
 #define SECTOR_SHIFT 9L
 
 #define FD_TABLE_INC 1024
 static int _fd_table_size = 0;
 static int *_fd_table = NULL;
+static unsigned *_di_io_pending = NULL; /* in flight ios per di, sized as _fd_table */
 
 
 //----------------------------------------------------------------
@@ -57,10 +67,15 @@ static inline struct dm_list *_list_pop(struct dm_list *head)
 
 //----------------------------------------------------------------
 
+/* Most consecutive dirty blocks written back with one io */
+#define MAX_WRITEV_BLOCKS 8
+
 struct control_block {
 	struct dm_list list;
 	void *context;
 	struct iocb cb;
+	sector_t nbytes;	/* expected on completion */
+	struct iovec iov[MAX_WRITEV_BLOCKS];
 };
 
 struct cb_set {
@@ -131,6 +146,7 @@ struct async_engine {
 	io_context_t aio_context;
 	struct cb_set *cbs;
 	unsigned page_mask;
+	pid_t pid;		/* owner of aio_context */
 };
 
 static struct async_engine *_to_async(struct io_engine *e)
@@ -146,118 +162,186 @@ static void _async_destroy(struct io_engine *ioe)
 	_cb_set_destroy(e->cbs);
 
 	// io_destroy is really slow
-	r = io_destroy(e->aio_context);
-	if (r)
-		log_sys_warn("io_destroy");
+	// a forked child has no access to the context of its parent
+	if (e->pid == getpid()) {
+		r = io_destroy(e->aio_context);
+		if (r)
+			log_sys_warn("io_destroy");
+	}
 
 	free(e);
 }
 
-static int _last_byte_di;
-static uint64_t _last_byte_offset;
-static int _last_byte_sector_size;
+/* Where lvm wants writes to a di to end, sized as _fd_table */
+struct last_byte {
+	uint64_t offset;
+	int sector_size;
+};
+static struct last_byte *_di_last_byte = NULL;
 
-static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
-			 sector_t sb, sector_t se, void *data, void *context)
+/*
+ * If bcache block goes past where lvm wants to write, then clamp it.
+ */
+static bool _limit_write_nbytes(int di, sector_t offset, sector_t *nbytes)
 {
-	int r;
-	struct iocb *cb_array[1];
-	struct control_block *cb;
-	struct async_engine *e = _to_async(ioe);
-	sector_t offset;
-	sector_t nbytes;
 	sector_t limit_nbytes;
 	sector_t orig_nbytes;
 	sector_t extra_nbytes = 0;
 
-	if (((uintptr_t) data) & e->page_mask) {
-		log_warn("misaligned data buffer");
+	if ((di >= _fd_table_size) || !_di_last_byte[di].offset)
+		return true;
+
+	if (offset > _di_last_byte[di].offset) {
+		log_error("Limit write at %llu len %llu beyond last byte %llu",
+			  (unsigned long long)offset,
+			  (unsigned long long)*nbytes,
+			  (unsigned long long)_di_last_byte[di].offset);
 		return false;
 	}
 
-	offset = sb << SECTOR_SHIFT;
-	nbytes = (se - sb) << SECTOR_SHIFT;
-
 	/*
-	 * If bcache block goes past where lvm wants to write, then clamp it.
+	 * If the bcache block offset+len goes beyond where lvm is
+	 * intending to write, then reduce the len being written
+	 * (which is the bcache block size) so we don't write past
+	 * the limit set by lvm.  If after applying the limit, the
+	 * resulting size is not a multiple of the sector size (512
+	 * or 4096) then extend the reduced size to be a multiple of
+	 * the sector size (we don't want to write partial sectors.)
 	 */
-	if ((d == DIR_WRITE) && _last_byte_offset && (di == _last_byte_di)) {
-		if (offset > _last_byte_offset) {
-			log_error("Limit write at %llu len %llu beyond last byte %llu",
+	if (offset + *nbytes > _di_last_byte[di].offset) {
+		limit_nbytes = _di_last_byte[di].offset - offset;
+
+		if (limit_nbytes % _di_last_byte[di].sector_size) {
+			extra_nbytes = _di_last_byte[di].sector_size - (limit_nbytes % _di_last_byte[di].sector_size);
+
+			/*
+			 * adding extra_nbytes to the reduced nbytes (limit_nbytes)
+			 * should make the final write size a multiple of the
+			 * sector size.  This should never result in a final size
+			 * larger than the bcache block size (as long as the bcache
+			 * block size is a multiple of the sector size).
+			 */
+			if (limit_nbytes + extra_nbytes > *nbytes) {
+				log_warn("Skip extending write at %llu len %llu limit %llu extra %llu sector_size %llu",
+					 (unsigned long long)offset,
+					 (unsigned long long)*nbytes,
+					 (unsigned long long)limit_nbytes,
+					 (unsigned long long)extra_nbytes,
+					 (unsigned long long)_di_last_byte[di].sector_size);
+				extra_nbytes = 0;
+			}
+		}
+
+		orig_nbytes = *nbytes;
+
+		if (extra_nbytes) {
+			log_debug("Limit write at %llu len %llu to len %llu rounded to %llu",
 				  (unsigned long long)offset,
-				  (unsigned long long)nbytes,
-				  (unsigned long long)_last_byte_offset);
-			return false;
+				  (unsigned long long)*nbytes,
+				  (unsigned long long)limit_nbytes,
+				  (unsigned long long)(limit_nbytes + extra_nbytes));
+			*nbytes = limit_nbytes + extra_nbytes;
+		} else {
+			log_debug("Limit write at %llu len %llu to len %llu",
+				  (unsigned long long)offset,
+				  (unsigned long long)*nbytes,
+				  (unsigned long long)limit_nbytes);
+			*nbytes = limit_nbytes;
 		}
 
 		/*
-		 * If the bcache block offset+len goes beyond where lvm is
-		 * intending to write, then reduce the len being written
-		 * (which is the bcache block size) so we don't write past
-		 * the limit set by lvm.  If after applying the limit, the
-		 * resulting size is not a multiple of the sector size (512
-		 * or 4096) then extend the reduced size to be a multiple of
-		 * the sector size (we don't want to write partial sectors.)
+		 * This shouldn't happen, the reduced+extended
+		 * nbytes value should never be larger than the
+		 * bcache block size.
 		 */
-		if (offset + nbytes > _last_byte_offset) {
-			limit_nbytes = _last_byte_offset - offset;
-
-			if (limit_nbytes % _last_byte_sector_size) {
-				extra_nbytes = _last_byte_sector_size - (limit_nbytes % _last_byte_sector_size);
+		if (*nbytes > orig_nbytes) {
+			log_error("Invalid adjusted write at %llu len %llu adjusted %llu limit %llu extra %llu sector_size %llu",
+				  (unsigned long long)offset,
+				  (unsigned long long)orig_nbytes,
+				  (unsigned long long)*nbytes,
+				  (unsigned long long)limit_nbytes,
+				  (unsigned long long)extra_nbytes,
+				  (unsigned long long)_di_last_byte[di].sector_size);
+			return false;
+		}
+	}
 
-				/*
-				 * adding extra_nbytes to the reduced nbytes (limit_nbytes)
-				 * should make the final write size a multiple of the
-				 * sector size.  This should never result in a final size
-				 * larger than the bcache block size (as long as the bcache
-				 * block size is a multiple of the sector size).
-				 */
-				if (limit_nbytes + extra_nbytes > nbytes) {
-					log_warn("Skip extending write at %llu len %llu limit %llu extra %llu sector_size %llu",
-						 (unsigned long long)offset,
-						 (unsigned long long)nbytes,
-						 (unsigned long long)limit_nbytes,
-						 (unsigned long long)extra_nbytes,
-						 (unsigned long long)_last_byte_sector_size);
-					extra_nbytes = 0;
-				}
-			}
+	return true;
+}
 
-			orig_nbytes = nbytes;
+static bool _iov_aligned(const struct iovec *iov, unsigned nr_iov, unsigned page_mask)
+{
+	unsigned i;
 
-			if (extra_nbytes) {
-				log_debug("Limit write at %llu len %llu to len %llu rounded to %llu",
-					  (unsigned long long)offset,
-					  (unsigned long long)nbytes,
-					  (unsigned long long)limit_nbytes,
-					  (unsigned long long)(limit_nbytes + extra_nbytes));
-				nbytes = limit_nbytes + extra_nbytes;
-			} else {
-				log_debug("Limit write at %llu len %llu to len %llu",
-					  (unsigned long long)offset,
-					  (unsigned long long)nbytes,
-					  (unsigned long long)limit_nbytes);
-				nbytes = limit_nbytes;
-			}
+	if (nr_iov > MAX_WRITEV_BLOCKS) {
+		log_warn("too many buffers for a single io");
+		return false;
+	}
 
-			/*
-			 * This shouldn't happen, the reduced+extended
-			 * nbytes value should never be larger than the
-			 * bcache block size.
-			 */
-			if (nbytes > orig_nbytes) {
-				log_error("Invalid adjusted write at %llu len %llu adjusted %llu limit %llu extra %llu sector_size %llu",
-					  (unsigned long long)offset,
-					  (unsigned long long)orig_nbytes,
-					  (unsigned long long)nbytes,
-					  (unsigned long long)limit_nbytes,
-					  (unsigned long long)extra_nbytes,
-					  (unsigned long long)_last_byte_sector_size);
-				return false;
-			}
+	for (i = 0; i < nr_iov; i++)
+		if (((uintptr_t) iov[i].iov_base) & page_mask) {
+			log_warn("misaligned data buffer");
+			return false;
 		}
+
+	return true;
+}
+
+/*
+ * Copies the buffers to the control block, cut at nbytes as written
+ * with the limit applied.  Returns the number of buffers copied.
+ */
+static unsigned _copy_iov(struct iovec *dst, const struct iovec *src,
+			  unsigned nr_iov, sector_t nbytes)
+{
+	unsigned i;
+
+	for (i = 0; (i < nr_iov) && nbytes; i++) {
+		dst[i] = src[i];
+		if (dst[i].iov_len > nbytes)
+			dst[i].iov_len = nbytes;
+		nbytes -= dst[i].iov_len;
+	}
+
+	return i;
+}
+
+static bool _async_submit(struct async_engine *e, struct control_block *cb)
+{
+	int r;
+	struct iocb *cb_array[1] = { &cb->cb };
+
+	do {
+		r = io_submit(e->aio_context, 1, cb_array);
+	} while (r == -EAGAIN);
+
+	if (r < 0) {
+		_cb_free(e->cbs, cb);
+		return false;
 	}
 
+	return true;
+}
+
+static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
+			 sector_t sb, sector_t se, void *data, void *context)
+{
+	struct control_block *cb;
+	struct async_engine *e = _to_async(ioe);
+	sector_t offset;
+	sector_t nbytes;
+
+	if (((uintptr_t) data) & e->page_mask) {
+		log_warn("misaligned data buffer");
+		return false;
+	}
+
+	offset = sb << SECTOR_SHIFT;
+	nbytes = (se - sb) << SECTOR_SHIFT;
+
+	if ((d == DIR_WRITE) && !_limit_write_nbytes(di, offset, &nbytes))
+		return false;
+
 	cb = _cb_alloc(e->cbs, context);
 	if (!cb) {
 		log_warn("couldn't allocate control block");
@@ -271,6 +355,7 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 	cb->cb.u.c.offset = offset;
 	cb->cb.u.c.nbytes = nbytes;
 	cb->cb.aio_lio_opcode = (d == DIR_READ) ? IO_CMD_PREAD : IO_CMD_PWRITE;
+	cb->nbytes = nbytes;
 
 #if 0
 	if (d == DIR_READ) {
@@ -286,17 +371,36 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 	}
 #endif
 
-	cb_array[0] = &cb->cb;
-	do {
-		r = io_submit(e->aio_context, 1, cb_array);
-	} while (r == -EAGAIN);
+	return _async_submit(e, cb);
+}
 
-	if (r < 0) {
-		_cb_free(e->cbs, cb);
+static bool _async_issue_writev(struct io_engine *ioe, int di, sector_t sb, sector_t se,
+				const struct iovec *iov, unsigned nr_iov, void *context)
+{
+	struct control_block *cb;
+	struct async_engine *e = _to_async(ioe);
+	sector_t offset = sb << SECTOR_SHIFT;
+	sector_t nbytes = (se - sb) << SECTOR_SHIFT;
+
+	if (!_iov_aligned(iov, nr_iov, e->page_mask))
+		return false;
+
+	if (!_limit_write_nbytes(di, offset, &nbytes))
+		return false;
+
+	cb = _cb_alloc(e->cbs, context);
+	if (!cb) {
+		log_warn("couldn't allocate control block");
 		return false;
 	}
 
-	return true;
+	memset(&cb->cb, 0, sizeof(cb->cb));
+
+	io_prep_pwritev(&cb->cb, (int) _fd_table[di], cb->iov,
+			(int) _copy_iov(cb->iov, iov, nr_iov, nbytes), (long long) offset);
+	cb->nbytes = nbytes;
+
+	return _async_submit(e, cb);
 }
 
 /*
@@ -330,7 +434,7 @@ static bool _async_wait(struct io_engine *ioe, io_complete_fn fn)
 
 		cb = _iocb_to_cb((struct iocb *) ev->obj);
 
-		if (ev->res == cb->cb.u.c.nbytes)
+		if (ev->res == cb->nbytes)
 			fn((void *) cb->context, 0);
 
 		else if ((int) ev->res < 0)
@@ -374,8 +478,11 @@ struct io_engine *create_async_io_engine(void)
 	e->e.issue = _async_issue;
 	e->e.wait = _async_wait;
 	e->e.max_io = _async_max_io;
+	e->e.register_buffers = NULL;
+	e->e.issue_writev = _async_issue_writev;
 
 	e->aio_context = 0;
+	e->pid = getpid();
 	r = io_setup(MAX_IO, &e->aio_context);
 	if (r < 0) {
 		log_debug("io_setup failed %d", r);
@@ -398,6 +505,406 @@ struct io_engine *create_async_io_engine(void)
 
 //----------------------------------------------------------------
 
+#if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup)
+
+/*
+ * io_uring engine.
+ *
+ * Issue only queues a submission entry, the queued entries are passed
+ * to the kernel together with waiting for completions in a single
+ * io_uring_enter() call.  The bcache block pool is registered as a
+ * fixed buffer so reads and writes of cache blocks avoid mapping the
+ * pages for every io.
+ *
+ * Files are deliberately not registered, a registered file holds a
+ * reference on the device after lvm closes it, which would keep it
+ * open across deactivation.
+ */
+
+#define URING_SUBMIT_BATCH 32
+
+struct uring_engine {
+	struct io_engine e;
+	int ring_fd;
+	struct cb_set *cbs;
+	unsigned page_mask;
+	unsigned nr_unsubmitted;
+
+	void *ring;
+	size_t ring_len;
+	struct io_uring_sqe *sqes;
+	size_t sqes_len;
+
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	char *fixed_data;
+	size_t fixed_len;
+};
+
+static struct uring_engine *_to_uring(struct io_engine *e)
+{
+	return container_of(e, struct uring_engine, e);
+}
+
+static int _uring_enter(struct uring_engine *e, unsigned to_submit,
+			unsigned min_complete, unsigned flags)
+{
+	int r;
+
+	do {
+		r = (int) syscall(__NR_io_uring_enter, e->ring_fd, to_submit,
+				  min_complete, flags, NULL, 0);
+	} while ((r < 0) && (errno == EINTR));
+
+	return r;
+}
+
+static bool _uring_cq_empty(struct uring_engine *e)
+{
+	return *e->cq_head == __atomic_load_n(e->cq_tail, __ATOMIC_ACQUIRE);
+}
+
+static bool _uring_submit(struct uring_engine *e, bool wait)
+{
+	int r;
+
+	while (e->nr_unsubmitted || wait) {
+		r = _uring_enter(e, e->nr_unsubmitted, wait ? 1 : 0,
+				 wait ? IORING_ENTER_GETEVENTS : 0);
+		if (r < 0) {
+			/*
+			 * Out of kernel resources or the completion queue
+			 * is full, reap completions before resubmitting.
+			 */
+			if ((errno == EAGAIN) || (errno == EBUSY)) {
+				if (!_uring_cq_empty(e))
+					return true;
+				if (!wait) {
+					wait = true;
+					continue;
+				}
+			}
+			log_sys_warn("io_uring_enter");
+			return false;
+		}
+
+		e->nr_unsubmitted -= (unsigned) r;
+		wait = false;
+	}
+
+	return true;
+}
+
+static void _uring_destroy(struct io_engine *ioe)
+{
+	struct uring_engine *e = _to_uring(ioe);
+
+	if (e->ring_fd >= 0 && close(e->ring_fd))
+		log_sys_warn("close");
+	if (e->sqes && munmap(e->sqes, e->sqes_len))
+		log_sys_warn("munmap");
+	if (e->ring && munmap(e->ring, e->ring_len))
+		log_sys_warn("munmap");
+	if (e->cbs)
+		_cb_set_destroy(e->cbs);
+
+	free(e);
+}
+
+static bool _uring_register_buffers(struct io_engine *ioe, void *data, size_t len)
+{
+	struct uring_engine *e = _to_uring(ioe);
+	struct iovec iov = { .iov_base = data, .iov_len = len };
+
+	if (syscall(__NR_io_uring_register, e->ring_fd,
+		    IORING_REGISTER_BUFFERS, &iov, 1) < 0) {
+		/* Still usable, just without fixed buffers. */
+		log_debug("io_uring buffer registration failed %d.", errno);
+		return false;
+	}
+
+	e->fixed_data = data;
+	e->fixed_len = len;
+
+	return true;
+}
+
+static bool _uring_is_fixed(struct uring_engine *e, void *data, sector_t nbytes)
+{
+	return e->fixed_data && ((char *) data >= e->fixed_data) &&
+		((char *) data + nbytes <= e->fixed_data + e->fixed_len);
+}
+
+static bool _uring_queue(struct uring_engine *e, struct control_block *cb, int fd,
+			 uint8_t opcode, sector_t offset, void *addr, uint32_t len)
+{
+	struct io_uring_sqe *sqe;
+	unsigned tail, index;
+
+	/*
+	 * The control block set limits io in flight to the ring size,
+	 * so there is always a free submission entry.
+	 */
+	tail = *e->sq_tail;
+	index = tail & *e->sq_mask;
+	sqe = e->sqes + index;
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->off = offset;
+	sqe->addr = (uintptr_t) addr;
+	sqe->len = len;
+	sqe->user_data = (uintptr_t) cb;
+	/* buf_index 0 is the registered block pool for the fixed opcodes */
+
+	e->sq_array[index] = index;
+	__atomic_store_n(e->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	if ((++e->nr_unsubmitted >= URING_SUBMIT_BATCH) && !_uring_submit(e, false)) {
+		/* Drop the entry again, the kernel has not consumed it. */
+		__atomic_store_n(e->sq_tail, tail, __ATOMIC_RELEASE);
+		e->nr_unsubmitted--;
+		_cb_free(e->cbs, cb);
+		return false;
+	}
+
+	return true;
+}
+
+static bool _uring_issue(struct io_engine *ioe, enum dir d, int di,
+			 sector_t sb, sector_t se, void *data, void *context)
+{
+	struct control_block *cb;
+	struct uring_engine *e = _to_uring(ioe);
+	sector_t offset;
+	sector_t nbytes;
+	uint8_t opcode;
+
+	if (((uintptr_t) data) & e->page_mask) {
+		log_warn("misaligned data buffer");
+		return false;
+	}
+
+	offset = sb << SECTOR_SHIFT;
+	nbytes = (se - sb) << SECTOR_SHIFT;
+
+	if ((d == DIR_WRITE) && !_limit_write_nbytes(di, offset, &nbytes))
+		return false;
+
+	cb = _cb_alloc(e->cbs, context);
+	if (!cb) {
+		log_warn("couldn't allocate control block");
+		return false;
+	}
+
+	/* Only cb->nbytes is used, to check for short io on completion. */
+	cb->nbytes = nbytes;
+
+	if (_uring_is_fixed(e, data, nbytes))
+		opcode = (d == DIR_READ) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+	else
+		opcode = (d == DIR_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+
+	return _uring_queue(e, cb, _fd_table[di], opcode, offset, data, nbytes);
+}
+
+static bool _uring_issue_writev(struct io_engine *ioe, int di, sector_t sb, sector_t se,
+				const struct iovec *iov, unsigned nr_iov, void *context)
+{
+	struct control_block *cb;
+	struct uring_engine *e = _to_uring(ioe);
+	sector_t offset = sb << SECTOR_SHIFT;
+	sector_t nbytes = (se - sb) << SECTOR_SHIFT;
+
+	if (!_iov_aligned(iov, nr_iov, e->page_mask))
+		return false;
+
+	if (!_limit_write_nbytes(di, offset, &nbytes))
+		return false;
+
+	cb = _cb_alloc(e->cbs, context);
+	if (!cb) {
+		log_warn("couldn't allocate control block");
+		return false;
+	}
+
+	/* The kernel may read the buffer list until the io completes. */
+	cb->nbytes = nbytes;
+	nr_iov = _copy_iov(cb->iov, iov, nr_iov, nbytes);
+
+	return _uring_queue(e, cb, _fd_table[di], IORING_OP_WRITEV, offset, cb->iov, nr_iov);
+}
+
+static bool _uring_wait(struct io_engine *ioe, io_complete_fn fn)
+{
+	struct io_uring_cqe *cqe;
+	struct control_block *cb;
+	struct uring_engine *e = _to_uring(ioe);
+	unsigned head, tail;
+
+	/* Submits anything queued and waits in the same syscall. */
+	if (!_uring_submit(e, _uring_cq_empty(e)))
+		return false;
+
+	head = *e->cq_head;
+	tail = __atomic_load_n(e->cq_tail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; head++) {
+		cqe = e->cqes + (head & *e->cq_mask);
+		cb = (struct control_block *) (uintptr_t) cqe->user_data;
+
+		if ((sector_t) cqe->res == cb->nbytes)
+			fn(cb->context, 0);
+
+		else if (cqe->res < 0)
+			fn(cb->context, cqe->res);
+
+		/* Same as the async engine, a short read of at least one sector is ok. */
+		else if (cqe->res >= (1 << SECTOR_SHIFT))
+			fn(cb->context, 0);
+
+		else
+			fn(cb->context, -ENODATA);
+
+		_cb_free(e->cbs, cb);
+	}
+
+	__atomic_store_n(e->cq_head, head, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+static unsigned _uring_max_io(struct io_engine *e)
+{
+	return MAX_IO;
+}
+
+/*
+ * The engine needs IORING_OP_READ/WRITE for buffers outside of the
+ * registered pool and IORING_OP_WRITEV for merged writeback, check
+ * the kernel has them.
+ */
+static bool _uring_probe(int ring_fd)
+{
+	struct io_uring_probe *probe;
+	size_t len = sizeof(*probe) + 256 * sizeof(struct io_uring_probe_op);
+	bool r = false;
+
+	if (!(probe = zalloc(len)))
+		return false;
+
+	if ((syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, 256) >= 0) &&
+	    (probe->last_op >= IORING_OP_WRITE) &&
+	    (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+	    (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) &&
+	    (probe->ops[IORING_OP_WRITEV].flags & IO_URING_OP_SUPPORTED) &&
+	    (probe->ops[IORING_OP_READ_FIXED].flags & IO_URING_OP_SUPPORTED) &&
+	    (probe->ops[IORING_OP_WRITE_FIXED].flags & IO_URING_OP_SUPPORTED))
+		r = true;
+
+	free(probe);
+
+	return r;
+}
+
+struct io_engine *create_io_uring_io_engine(void)
+{
+	static int _pagesize = 0;
+	struct io_uring_params p = { 0 };
+	struct uring_engine *e;
+	size_t sq_len, cq_len;
+	char *ring;
+
+	if ((_pagesize <= 0) && (_pagesize = sysconf(_SC_PAGESIZE)) < 0) {
+		log_warn("_SC_PAGESIZE returns negative value.");
+		return NULL;
+	}
+
+	if (!(e = zalloc(sizeof(*e))))
+		return NULL;
+
+	e->e.destroy = _uring_destroy;
+	e->e.issue = _uring_issue;
+	e->e.wait = _uring_wait;
+	e->e.max_io = _uring_max_io;
+	e->e.register_buffers = _uring_register_buffers;
+	e->e.issue_writev = _uring_issue_writev;
+	e->page_mask = (unsigned) _pagesize - 1;
+
+	if ((e->ring_fd = (int) syscall(__NR_io_uring_setup, MAX_IO, &p)) < 0) {
+		log_debug("io_uring_setup failed %d.", errno);
+		free(e);
+		return NULL;
+	}
+
+	if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !_uring_probe(e->ring_fd)) {
+		log_debug("io_uring lacks required features.");
+		goto bad;
+	}
+
+	sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	e->ring_len = (sq_len > cq_len) ? sq_len : cq_len;
+
+	if ((e->ring = mmap(NULL, e->ring_len, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, e->ring_fd,
+			    IORING_OFF_SQ_RING)) == MAP_FAILED) {
+		log_sys_warn("mmap");
+		e->ring = NULL;
+		goto bad;
+	}
+
+	e->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+	if ((e->sqes = mmap(NULL, e->sqes_len, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, e->ring_fd,
+			    IORING_OFF_SQES)) == MAP_FAILED) {
+		log_sys_warn("mmap");
+		e->sqes = NULL;
+		goto bad;
+	}
+
+	ring = e->ring;
+	e->sq_head = (unsigned *) (ring + p.sq_off.head);
+	e->sq_tail = (unsigned *) (ring + p.sq_off.tail);
+	e->sq_mask = (unsigned *) (ring + p.sq_off.ring_mask);
+	e->sq_array = (unsigned *) (ring + p.sq_off.array);
+	e->cq_head = (unsigned *) (ring + p.cq_off.head);
+	e->cq_tail = (unsigned *) (ring + p.cq_off.tail);
+	e->cq_mask = (unsigned *) (ring + p.cq_off.ring_mask);
+	e->cqes = (struct io_uring_cqe *) (ring + p.cq_off.cqes);
+
+	if (!(e->cbs = _cb_set_create(p.sq_entries < MAX_IO ? p.sq_entries : MAX_IO))) {
+		log_warn("couldn't create control block set");
+		goto bad;
+	}
+
+	/* coverity[leaked_storage] 'e' is not leaking */
+	return &e->e;
+bad:
+	_uring_destroy(&e->e);
+	return NULL;
+}
+
+#else
+
+struct io_engine *create_io_uring_io_engine(void)
+{
+	log_debug("io_uring engine is not compiled in.");
+	return NULL;
+}
+
+#endif
+
+//----------------------------------------------------------------
+
 struct sync_io {
         struct dm_list list;
 	void *context;
@@ -450,27 +957,27 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 	/*
 	 * If bcache block goes past where lvm wants to write, then clamp it.
 	 */
-	if ((d == DIR_WRITE) && _last_byte_offset && (di == _last_byte_di)) {
+	if ((d == DIR_WRITE) && (di < _fd_table_size) && _di_last_byte[di].offset) {
 		uint64_t offset = where;
 		uint64_t nbytes = len;
 		sector_t limit_nbytes = 0;
 		sector_t extra_nbytes = 0;
 		sector_t orig_nbytes = 0;
 
-		if (offset > _last_byte_offset) {
+		if (offset > _di_last_byte[di].offset) {
 			log_error("Limit write at %llu len %llu beyond last byte %llu",
 				  (unsigned long long)offset,
 				  (unsigned long long)nbytes,
-				  (unsigned long long)_last_byte_offset);
+				  (unsigned long long)_di_last_byte[di].offset);
 			free(io);
 			return false;
 		}
 
-		if (offset + nbytes > _last_byte_offset) {
-			limit_nbytes = _last_byte_offset - offset;
+		if (offset + nbytes > _di_last_byte[di].offset) {
+			limit_nbytes = _di_last_byte[di].offset - offset;
 
-			if (limit_nbytes % _last_byte_sector_size) {
-				extra_nbytes = _last_byte_sector_size - (limit_nbytes % _last_byte_sector_size);
+			if (limit_nbytes % _di_last_byte[di].sector_size) {
+				extra_nbytes = _di_last_byte[di].sector_size - (limit_nbytes % _di_last_byte[di].sector_size);
 
 				/*
 				 * adding extra_nbytes to the reduced nbytes (limit_nbytes)
@@ -485,7 +992,7 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 						 (unsigned long long)nbytes,
 						 (unsigned long long)limit_nbytes,
 						 (unsigned long long)extra_nbytes,
-						 (unsigned long long)_last_byte_sector_size);
+						 (unsigned long long)_di_last_byte[di].sector_size);
 					extra_nbytes = 0;
 				}
 			}
@@ -519,7 +1026,7 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 					  (unsigned long long)nbytes,
 					  (unsigned long long)limit_nbytes,
 					  (unsigned long long)extra_nbytes,
-					  (unsigned long long)_last_byte_sector_size);
+					  (unsigned long long)_di_last_byte[di].sector_size);
 				free(io);
 				return false;
 			}
@@ -606,6 +1113,8 @@ struct io_engine *create_sync_io_engine(void)
         e->e.issue = _sync_issue;
         e->e.wait = _sync_wait;
         e->e.max_io = _sync_max_io;
+        e->e.register_buffers = NULL;
+        e->e.issue_writev = NULL;
 
 	dm_list_init(&e->complete);
 	/* coverity[leaked_storage] 'e' is not leaking */
@@ -617,6 +1126,7 @@ struct io_engine *create_sync_io_engine(void)
 #define MIN_BLOCKS 16
 #define WRITEBACK_LOW_THRESHOLD_PERCENT 33
 #define WRITEBACK_HIGH_THRESHOLD_PERCENT 66
+#define HOT_BLOCKS_PERCENT 75
 
 //----------------------------------------------------------------
 
@@ -652,6 +1162,8 @@ static void _clear_flags(struct block *b, unsigned bits)
 enum block_flags {
 	BF_IO_PENDING = (1 << 0),
 	BF_DIRTY = (1 << 1),
+	BF_USED = (1 << 2),	/* got since it was read */
+	BF_HOT = (1 << 3),	/* got again while cached */
 };
 
 struct bcache {
@@ -659,6 +1171,7 @@ struct bcache {
 	uint64_t nr_data_blocks;
 	uint64_t nr_cache_blocks;
 	unsigned max_io;
+	unsigned max_di_prefetches;
 
 	struct io_engine *engine;
 
@@ -671,11 +1184,21 @@ struct bcache {
 	unsigned nr_locked;
 	unsigned nr_dirty;
 	unsigned nr_io_pending;
+	unsigned nr_hot;
 
+	/*
+	 * Clean blocks got once stay on the clean list, those got again
+	 * while cached move to the hot list, which holds at most
+	 * HOT_BLOCKS_PERCENT of the cache.  Blocks are evicted from the
+	 * clean list first, so one long read, e.g. of a large metadata
+	 * area, does not push out the label and mda_header blocks every
+	 * command reads again.
+	 */
 	struct dm_list free;
 	struct dm_list errored;
 	struct dm_list dirty;
 	struct dm_list clean;
+	struct dm_list hot;
 	struct dm_list io_pending;
 
 	struct radix_tree *rtree;
@@ -685,10 +1208,17 @@ struct bcache {
 	 */
 	unsigned read_hits;
 	unsigned read_misses;
+	unsigned hot_hits;
 	unsigned write_zeroes;
 	unsigned write_hits;
 	unsigned write_misses;
 	unsigned prefetches;
+	unsigned reads;
+	unsigned writes;
+	unsigned io_errors;
+	unsigned max_io_pending;
+	unsigned waits;
+	uint64_t wait_ns;
 };
 
 //----------------------------------------------------------------
@@ -790,14 +1320,16 @@ static void _free_block(struct block *b)
 }
 
 /*----------------------------------------------------------------
- * Clean/dirty list management.
- * Always use these methods to ensure nr_dirty_ is correct.
+ * Clean/hot/dirty list management.
+ * Always use these methods to ensure nr_dirty_ and nr_hot are correct.
  *--------------------------------------------------------------*/
 
 static void _unlink_block(struct block *b)
 {
 	if (_test_flags(b, BF_DIRTY))
 		b->cache->nr_dirty--;
+	else if (_test_flags(b, BF_HOT))
+		b->cache->nr_hot--;
 
 	dm_list_del(&b->list);
 }
@@ -805,20 +1337,24 @@ static void _unlink_block(struct block *b)
 static void _link_block(struct block *b)
 {
 	struct bcache *cache = b->cache;
+	struct block *cold;
 
 	if (_test_flags(b, BF_DIRTY)) {
 		dm_list_add(&cache->dirty, &b->list);
 		cache->nr_dirty++;
+	} else if (_test_flags(b, BF_HOT)) {
+		dm_list_add(&cache->hot, &b->list);
+		if (++cache->nr_hot > HOT_BLOCKS_PERCENT * cache->nr_cache_blocks / 100) {
+			/* The least recently used hot block gets another round as clean. */
+			cold = dm_list_item(dm_list_first(&cache->hot), struct block);
+			_unlink_block(cold);
+			_clear_flags(cold, BF_HOT);
+			dm_list_add(&cache->clean, &cold->list);
+		}
 	} else
 		dm_list_add(&cache->clean, &b->list);
 }
 
-static void _relink(struct block *b)
-{
-	_unlink_block(b);
-	_link_block(b);
-}
-
 /*----------------------------------------------------------------
  * Low level IO handling
  *
@@ -834,28 +1370,53 @@ static void _relink(struct block *b)
 
 static void _complete_io(void *context, int err)
 {
-	struct block *b = context;
+	struct block *b = context, *next;
 	struct bcache *cache = b->cache;
 
-	b->error = err;
-	_clear_flags(b, BF_IO_PENDING);
-	cache->nr_io_pending--;
+	if (err)
+		cache->io_errors++;
 
-	/*
-	 * b is on the io_pending list, so we don't want to use unlink_block.
-	 * Which would incorrectly adjust nr_dirty.
-	 */
-	dm_list_del(&b->list);
+	/* A merged write completes all of its blocks. */
+	for (; b; b = next) {
+		next = b->io_next;
+		b->io_next = NULL;
 
-	if (b->error) {
-		dm_list_add(&cache->errored, &b->list);
+		b->error = err;
+		_clear_flags(b, BF_IO_PENDING);
+		cache->nr_io_pending--;
+		if (b->di < _fd_table_size)
+			_di_io_pending[b->di]--;
 
-	} else {
-		_clear_flags(b, BF_DIRTY);
-		_link_block(b);
+		/*
+		 * b is on the io_pending list, so we don't want to use unlink_block.
+		 * Which would incorrectly adjust nr_dirty.
+		 */
+		dm_list_del(&b->list);
+
+		if (b->error) {
+			dm_list_add(&cache->errored, &b->list);
+
+		} else {
+			_clear_flags(b, BF_DIRTY);
+			_link_block(b);
+		}
 	}
 }
 
+static void _set_io_pending(struct block *b, enum dir d)
+{
+	struct bcache *cache = b->cache;
+
+	b->io_dir = d;
+	_set_flags(b, BF_IO_PENDING);
+	if (++cache->nr_io_pending > cache->max_io_pending)
+		cache->max_io_pending = cache->nr_io_pending;
+	if (b->di < _fd_table_size)
+		_di_io_pending[b->di]++;
+
+	dm_list_move(&cache->io_pending, &b->list);
+}
+
 /*
  * |b->list| should be valid (either pointing to itself, on one of the other
  * lists.
@@ -869,11 +1430,11 @@ static void _issue_low_level(struct block *b, enum dir d)
 	if (_test_flags(b, BF_IO_PENDING))
 		return;
 
-	b->io_dir = d;
-	_set_flags(b, BF_IO_PENDING);
-	cache->nr_io_pending++;
-
-	dm_list_move(&cache->io_pending, &b->list);
+	_set_io_pending(b, d);
+	if (d == DIR_READ)
+		cache->reads++;
+	else
+		cache->writes++;
 
 	if (!cache->engine->issue(cache->engine, d, b->di, sb, se, b->data, b)) {
 		/* FIXME: if io_submit() set an errno, return that instead of EIO? */
@@ -887,14 +1448,97 @@ static inline void _issue_read(struct block *b)
 	_issue_low_level(b, DIR_READ);
 }
 
-static inline void _issue_write(struct block *b)
+/*
+ * Whether b can be written together with a dirty block next to it.
+ * Blocks that would fail on their own, held or past the last byte
+ * lvm wants written, are left for their own io.
+ */
+static bool _can_merge_write(struct block *b)
 {
-	_issue_low_level(b, DIR_WRITE);
+	sector_t offset = (b->index * b->cache->block_sectors) << SECTOR_SHIFT;
+
+	if (!_test_flags(b, BF_DIRTY) || _test_flags(b, BF_IO_PENDING) ||
+	    b->ref_count || b->error)
+		return false;
+
+	if ((b->di < _fd_table_size) && _di_last_byte[b->di].offset &&
+	    (offset > _di_last_byte[b->di].offset))
+		return false;
+
+	return true;
+}
+
+/*
+ * Writes dirty blocks next to b on the same device with the same io,
+ * so writing back a large metadata area takes a few large ios rather
+ * than one per block.  Returns the number of blocks written.
+ */
+static unsigned _issue_write(struct block *b)
+{
+	struct bcache *cache = b->cache;
+	struct block *first = b, *last = b, *n;
+	struct iovec iov[MAX_WRITEV_BLOCKS];
+	unsigned nr = 1;
+
+	if (cache->engine->issue_writev && !_test_flags(b, BF_IO_PENDING)) {
+		while ((nr < MAX_WRITEV_BLOCKS) && first->index &&
+		       (n = _block_lookup(cache, first->di, first->index - 1)) &&
+		       _can_merge_write(n)) {
+			n->io_next = first;
+			first = n;
+			nr++;
+		}
+
+		while ((nr < MAX_WRITEV_BLOCKS) &&
+		       (n = _block_lookup(cache, last->di, last->index + 1)) &&
+		       _can_merge_write(n)) {
+			last->io_next = n;
+			last = n;
+			nr++;
+		}
+	}
+
+	if (nr == 1) {
+		_issue_low_level(b, DIR_WRITE);
+		return 1;
+	}
+
+	cache->writes++;
+
+	for (nr = 0, n = first; n; n = n->io_next) {
+		_set_io_pending(n, DIR_WRITE);
+		iov[nr].iov_base = n->data;
+		iov[nr++].iov_len = cache->block_sectors << SECTOR_SHIFT;
+	}
+
+	if (!cache->engine->issue_writev(cache->engine, first->di,
+					 first->index * cache->block_sectors,
+					 (last->index + 1) * cache->block_sectors,
+					 iov, nr, first))
+		_complete_io(first, -EIO);
+
+	return nr;
+}
+
+static uint64_t _now_ns(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
 }
 
 static bool _wait_io(struct bcache *cache)
 {
-	return cache->engine->wait(cache->engine, _complete_io);
+	uint64_t start = _now_ns();
+	bool r = cache->engine->wait(cache->engine, _complete_io);
+
+	cache->waits++;
+	cache->wait_ns += _now_ns() - start;
+
+	return r;
 }
 
 /*----------------------------------------------------------------
@@ -916,17 +1560,24 @@ static void _wait_specific(struct block *b)
 static unsigned _writeback(struct bcache *cache, unsigned count)
 {
 	unsigned actual = 0;
-	struct block *b, *tmp;
+	struct block *b, *found;
+
+	// Merged writes take further blocks off the dirty list, so
+	// look for the next one from the start each time.
+	while (actual < count) {
+		found = NULL;
+		dm_list_iterate_items_gen (b, &cache->dirty, list) {
+			// We can't writeback anything that's still in use.
+			if (!b->ref_count) {
+				found = b;
+				break;
+			}
+		}
 
-	dm_list_iterate_items_gen_safe (b, tmp, &cache->dirty, list) {
-		if (actual == count)
+		if (!found)
 			break;
 
-		// We can't writeback anything that's still in use.
-		if (!b->ref_count) {
-			_issue_write(b);
-			actual++;
-		}
+		actual += _issue_write(found);
 	}
 
 	return actual;
@@ -948,6 +1599,14 @@ static struct block *_find_unused_clean_block(struct bcache *cache)
 		}
 	}
 
+	dm_list_iterate_items (b, &cache->hot) {
+		if (!b->ref_count) {
+			_unlink_block(b);
+			_block_remove(b);
+			return b;
+		}
+	}
+
 	return NULL;
 }
 
@@ -978,6 +1637,7 @@ static struct block *_new_block(struct bcache *cache, int di, block_address i, b
 
 	if (b) {
 		dm_list_init(&b->list);
+		b->io_next = NULL;
 		b->flags = 0;
 		b->di = di;
 		b->index = i;
@@ -1013,7 +1673,13 @@ static void _hit(struct block *b, unsigned flags)
 	else
 		cache->read_hits++;
 
-	_relink(b);
+	if (_test_flags(b, BF_HOT))
+		cache->hot_hits++;
+
+	_unlink_block(b);
+	if (_test_flags(b, BF_USED))
+		_set_flags(b, BF_HOT);
+	_link_block(b);
 }
 
 static void _miss(struct bcache *cache, unsigned flags)
@@ -1072,6 +1738,7 @@ static struct block *_lookup_or_read_block(struct bcache *cache,
 		if (flags & (GF_DIRTY | GF_ZERO))
 			_set_flags(b, BF_DIRTY);
 
+		_set_flags(b, BF_USED);
 		_link_block(b);
 		return b;
 	}
@@ -1127,15 +1794,18 @@ struct bcache *bcache_create(sector_t block_sectors, unsigned nr_cache_blocks,
 	cache->block_sectors = block_sectors;
 	cache->nr_cache_blocks = nr_cache_blocks;
 	cache->max_io = nr_cache_blocks < max_io ? nr_cache_blocks : max_io;
+	cache->max_di_prefetches = 0;
 	cache->engine = engine;
 	cache->nr_locked = 0;
 	cache->nr_dirty = 0;
 	cache->nr_io_pending = 0;
+	cache->nr_hot = 0;
 
 	dm_list_init(&cache->free);
 	dm_list_init(&cache->errored);
 	dm_list_init(&cache->dirty);
 	dm_list_init(&cache->clean);
+	dm_list_init(&cache->hot);
 	dm_list_init(&cache->io_pending);
 
         cache->rtree = radix_tree_create(NULL, NULL);
@@ -1147,10 +1817,17 @@ struct bcache *bcache_create(sector_t block_sectors, unsigned nr_cache_blocks,
 
 	cache->read_hits = 0;
 	cache->read_misses = 0;
+	cache->hot_hits = 0;
 	cache->write_zeroes = 0;
 	cache->write_hits = 0;
 	cache->write_misses = 0;
 	cache->prefetches = 0;
+	cache->reads = 0;
+	cache->writes = 0;
+	cache->io_errors = 0;
+	cache->max_io_pending = 0;
+	cache->waits = 0;
+	cache->wait_ns = 0;
 
 	if (!_init_free_list(cache, nr_cache_blocks, _pagesize)) {
 		cache->engine->destroy(cache->engine);
@@ -1159,9 +1836,19 @@ struct bcache *bcache_create(sector_t block_sectors, unsigned nr_cache_blocks,
 		return NULL;
 	}
 
+	if (engine->register_buffers)
+		(void) engine->register_buffers(engine, cache->raw_data,
+						nr_cache_blocks * (block_sectors << SECTOR_SHIFT));
+
 	_fd_table_size = FD_TABLE_INC;
 
-	if (!(_fd_table = malloc(sizeof(int) * _fd_table_size))) {
+	if (!(_fd_table = malloc(sizeof(int) * _fd_table_size)) ||
+	    !(_di_io_pending = zalloc(sizeof(unsigned) * _fd_table_size)) ||
+	    !(_di_last_byte = zalloc(sizeof(*_di_last_byte) * _fd_table_size))) {
+		free(_fd_table);
+		_fd_table = NULL;
+		free(_di_io_pending);
+		_di_io_pending = NULL;
 		cache->engine->destroy(cache->engine);
 		radix_tree_destroy(cache->rtree);
 		free(cache);
@@ -1187,6 +1874,10 @@ void bcache_destroy(struct bcache *cache)
 	free(cache);
 	free(_fd_table);
 	_fd_table = NULL;
+	free(_di_io_pending);
+	_di_io_pending = NULL;
+	free(_di_last_byte);
+	_di_last_byte = NULL;
 	_fd_table_size = 0;
 }
 
@@ -1205,11 +1896,37 @@ unsigned bcache_max_prefetches(struct bcache *cache)
 	return cache->max_io;
 }
 
+void bcache_set_max_di_prefetches(struct bcache *cache, unsigned max_di_prefetches)
+{
+	cache->max_di_prefetches = max_di_prefetches;
+}
+
+void bcache_get_stats(struct bcache *cache, struct bcache_stats *stats)
+{
+	stats->read_hits = cache->read_hits;
+	stats->read_misses = cache->read_misses;
+	stats->hot_hits = cache->hot_hits;
+	stats->write_zeroes = cache->write_zeroes;
+	stats->write_hits = cache->write_hits;
+	stats->write_misses = cache->write_misses;
+	stats->prefetches = cache->prefetches;
+	stats->reads = cache->reads;
+	stats->writes = cache->writes;
+	stats->io_errors = cache->io_errors;
+	stats->max_io_pending = cache->max_io_pending;
+	stats->waits = cache->waits;
+	stats->wait_ns = cache->wait_ns;
+}
+
 void bcache_prefetch(struct bcache *cache, int di, block_address i)
 {
 	struct block *b = _block_lookup(cache, di, i);
 
 	if (!b) {
+		if (cache->max_di_prefetches && (di >= 0) && (di < _fd_table_size) &&
+		    (_di_io_pending[di] >= cache->max_di_prefetches))
+			return;
+
 		if (cache->nr_io_pending < cache->max_io) {
 			b = _new_block(cache, di, i, false);
 			if (b) {
@@ -1220,6 +1937,44 @@ void bcache_prefetch(struct bcache *cache, int di, block_address i)
 	}
 }
 
+bool bcache_is_cached(struct bcache *cache, int di, block_address i)
+{
+	return _block_lookup(cache, di, i) ? true : false;
+}
+
+bool bcache_read_direct(struct bcache *cache, int di, uint64_t offset, size_t len, void *data)
+{
+	size_t pos = 0;
+	ssize_t rv;
+
+	if ((di < 0) || (di >= _fd_table_size) || (_fd_table[di] < 0))
+		return false;
+
+	cache->reads++;
+
+	while (pos < len) {
+		rv = pread(_fd_table[di], (char *)data + pos, len - pos, offset + pos);
+
+		if (rv == -1 && (errno == EINTR || errno == EAGAIN))
+			continue;
+
+		if (rv < 0) {
+			log_debug("Device direct read error %d offset %llu len %llu", errno,
+				  (unsigned long long)(offset + pos),
+				  (unsigned long long)(len - pos));
+			cache->io_errors++;
+			return false;
+		}
+
+		if (!rv)
+			return false;
+
+		pos += rv;
+	}
+
+	return true;
+}
+
 //----------------------------------------------------------------
 
 static void _recycle_block(struct bcache *cache, struct block *b)
@@ -1450,24 +2205,34 @@ void bcache_abort_di(struct bcache *cache, int di)
 
 void bcache_set_last_byte(struct bcache *cache, int di, uint64_t offset, int sector_size)
 {
-	_last_byte_di = di;
-	_last_byte_offset = offset;
-	_last_byte_sector_size = sector_size;
-	if (!sector_size)
-		_last_byte_sector_size = 512;
+	if ((di < 0) || (di >= _fd_table_size))
+		return;
+
+	_di_last_byte[di].offset = offset;
+	_di_last_byte[di].sector_size = sector_size ? : 512;
+}
+
+uint64_t bcache_get_last_byte(struct bcache *cache, int di)
+{
+	if ((di < 0) || (di >= _fd_table_size))
+		return 0;
+
+	return _di_last_byte[di].offset;
 }
 
 void bcache_unset_last_byte(struct bcache *cache, int di)
 {
-	if (_last_byte_di == di) {
-		_last_byte_di = 0;
-		_last_byte_offset = 0;
-		_last_byte_sector_size = 0;
-	}
+	if ((di < 0) || (di >= _fd_table_size))
+		return;
+
+	_di_last_byte[di].offset = 0;
+	_di_last_byte[di].sector_size = 0;
 }
 
 int bcache_set_fd(int fd)
 {
+	struct last_byte *new_last_byte;
+	unsigned *new_pending;
 	int *new_table = NULL;
 	int new_size = 0;
 	int i;
@@ -1496,6 +2261,28 @@ int bcache_set_fd(int fd)
 		new_table[i] = -1;
 
 	_fd_table = new_table;
+
+	new_pending = realloc(_di_io_pending, sizeof(unsigned) * new_size);
+	if (!new_pending) {
+		log_error("Cannot extend bcache fd table");
+		return -1;
+	}
+
+	for (i = _fd_table_size; i < new_size; i++)
+		new_pending[i] = 0;
+
+	_di_io_pending = new_pending;
+
+	new_last_byte = realloc(_di_last_byte, sizeof(*_di_last_byte) * new_size);
+	if (!new_last_byte) {
+		log_error("Cannot extend bcache fd table");
+		return -1;
+	}
+
+	memset(new_last_byte + _fd_table_size, 0,
+	       sizeof(*_di_last_byte) * (new_size - _fd_table_size));
+
+	_di_last_byte = new_last_byte;
 	_fd_table_size = new_size;
 
 	goto retry;
@@ -21,6 +21,7 @@
 #include <linux/fs.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <sys/uio.h>
 
 enum dir {
 	DIR_READ,
@@ -38,11 +39,30 @@ struct io_engine {
 		      sector_t sb, sector_t se, void *data, void *context);
 	bool (*wait)(struct io_engine *e, io_complete_fn fn);
 	unsigned (*max_io)(struct io_engine *e);
+
+	/*
+	 * Optional, may be NULL.  Called by bcache_create() with the block
+	 * pool so the engine can register it with the kernel.
+	 */
+	bool (*register_buffers)(struct io_engine *e, void *data, size_t len);
+
+	/*
+	 * Optional, may be NULL.  Writes the buffers of nr_iov consecutive
+	 * blocks with a single io, completed once with the context.
+	 */
+	bool (*issue_writev)(struct io_engine *e, int di, sector_t sb, sector_t se,
+			     const struct iovec *iov, unsigned nr_iov, void *context);
 };
 
 struct io_engine *create_async_io_engine(void);
 struct io_engine *create_sync_io_engine(void);
 
+/*
+ * Returns NULL if io_uring is not compiled in or not usable
+ * with the running kernel, callers fall back to the async engine.
+ */
+struct io_engine *create_io_uring_io_engine(void);
+
 /*----------------------------------------------------------------*/
 
 struct bcache;
@@ -54,6 +74,7 @@ struct block {
 
 	struct bcache *cache;
 	struct dm_list list;
+	struct block *io_next;	/* next block written by the same io */
 
 	unsigned flags;
 	unsigned ref_count;
@@ -87,6 +108,36 @@ sector_t bcache_block_sectors(struct bcache *cache);
 unsigned bcache_nr_cache_blocks(struct bcache *cache);
 unsigned bcache_max_prefetches(struct bcache *cache);
 
+/*
+ * Limits the ios in flight for a single di that bcache_prefetch() will
+ * add to, so one slow device cannot take all of the max_prefetches
+ * slots.  Prefetches over the limit are dropped, a later get reads the
+ * block.  0, the default, means no per di limit.
+ */
+void bcache_set_max_di_prefetches(struct bcache *cache, unsigned max_di_prefetches);
+
+/*
+ * Counters since bcache_create().  wait_ns is the time spent waiting
+ * for the engine to complete io, i.e. io latency not hidden by prefetch.
+ */
+struct bcache_stats {
+	unsigned read_hits;
+	unsigned read_misses;
+	unsigned hot_hits;	/* hits on blocks got more than once */
+	unsigned write_zeroes;
+	unsigned write_hits;
+	unsigned write_misses;
+	unsigned prefetches;
+	unsigned reads;		/* ios issued */
+	unsigned writes;
+	unsigned io_errors;
+	unsigned max_io_pending;
+	unsigned waits;
+	uint64_t wait_ns;
+};
+
+void bcache_get_stats(struct bcache *cache, struct bcache_stats *stats);
+
 /*
  * Use the prefetch method to take advantage of asynchronous IO.  For example,
  * if you wanted to read a block from many devices concurrently you'd do
@@ -145,6 +196,19 @@ bool bcache_invalidate_di(struct bcache *cache, int di);
  */
 void bcache_abort_di(struct bcache *cache, int di);
 
+/*
+ * Returns true if block i of di is in the cache (possibly dirty or
+ * with io in flight), without reading it or changing its lru position.
+ */
+bool bcache_is_cached(struct bcache *cache, int di, block_address i);
+
+/*
+ * Reads len bytes at offset straight from the device, without using or
+ * populating the cache.  offset, len and data must be aligned for
+ * O_DIRECT.  Returns false on error or a short read.
+ */
+bool bcache_read_direct(struct bcache *cache, int di, uint64_t offset, size_t len, void *data);
+
 //----------------------------------------------------------------
 // The next four functions are utilities written in terms of the above api.
  
@@ -153,12 +217,19 @@ void bcache_prefetch_bytes(struct bcache *cache, int di, uint64_t start, size_t
 
 // Reads, writes and zeroes bytes.  Returns false if errors occur.
 bool bcache_read_bytes(struct bcache *cache, int di, uint64_t start, size_t len, void *data);
+
+// Reads a large byte range with one direct read for the uncached part,
+// copying any cached blocks over it, and leaves the cache contents as
+// they were.  Returns false if the direct read could not be done, the
+// caller can then use bcache_read_bytes().
+bool bcache_read_bytes_direct(struct bcache *cache, int di, uint64_t start, size_t len, void *data);
 bool bcache_write_bytes(struct bcache *cache, int di, uint64_t start, size_t len, void *data);
 bool bcache_zero_bytes(struct bcache *cache, int di, uint64_t start, size_t len);
 bool bcache_set_bytes(struct bcache *cache, int di, uint64_t start, size_t len, uint8_t val);
 bool bcache_invalidate_bytes(struct bcache *cache, int di, uint64_t start, size_t len);
 
 void bcache_set_last_byte(struct bcache *cache, int di, uint64_t offset, int sector_size);
+uint64_t bcache_get_last_byte(struct bcache *cache, int di);
 void bcache_unset_last_byte(struct bcache *cache, int di);
 
 //----------------------------------------------------------------
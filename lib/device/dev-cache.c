@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <locale.h>
+#include <poll.h>
 #include <time.h>
 /* coverity[unnecessary_header] needed for MuslC */
 #include <sys/file.h>
@@ -56,6 +57,10 @@ static struct {
 	struct dm_list *dm_devs; /* dm_active_device structs with dm UUIDs from DM_DEVICE_LIST (when available) */
 	struct radix_tree *dm_uuids; /* references dm_devs entries */
 	struct radix_tree *dm_devnos; /* references dm_devs entries */
+	struct radix_tree *dm_holders; /* dm_holder lists of dm_devs entries by held devno */
+	struct dm_pool *dm_holders_mem;
+	unsigned dm_devs_count;
+	unsigned dm_holders_queries;
 	struct radix_tree *sysfs_only_devices; /* see comments in _get_device_for_sysfs_dev_name_using_devno */
 	struct radix_tree *devices;
 	struct dm_regex *preferred_names_matcher;
@@ -68,6 +73,11 @@ static struct {
 	struct dm_list dirs;
 	struct dm_list files;
 
+#ifdef UDEV_SYNC_SUPPORT
+	struct udev_monitor *udev_monitor; /* long lived cmd: block device events since last scan */
+	struct radix_tree *udev_devices; /* udev_device structs from udev db enumeration, by devno */
+	int udev_devices_enumerated;
+#endif
 } _cache;
 
 #define _zalloc(x) dm_pool_zalloc(_cache.mem, (x))
@@ -123,113 +133,84 @@ void dev_set_preferred_name(struct dm_str_list *sl, struct device *dev)
 }
 
 /*
- * Check whether path0 or path1 contains the subpath. The path that
- * *does not* contain the subpath wins (return 0 or 1). If both paths
- * contain the subpath, return -1. If none of them contains the subpath,
- * return -2.
+ * Built-in preference of a path, the higher the better:
+ *	/dev/block/ < /dev/dm-* < /dev/disk/ < /dev/mapper/ < anything else
+ * Paths outside /dev get -1 and have no built-in preference.
  */
-static int _builtin_preference(const char *path0, const char *path1,
-			       size_t skip_prefix_count, const char *subpath)
+static int _builtin_path_preference(const char *path)
 {
-	size_t subpath_len;
-	int r0, r1;
-
-	subpath_len = strlen(subpath);
-
-	r0 = !strncmp(path0 + skip_prefix_count, subpath, subpath_len);
-	r1 = !strncmp(path1 + skip_prefix_count, subpath, subpath_len);
+	size_t devdir_len = _cache.dev_dir_len;
+	const char *dmdir = dm_dir();
 
-	if (!r0 && r1)
-		/* path0 does not have the subpath - it wins */
-		return 0;
-	else if (r0 && !r1)
-		/* path1 does not have the subpath - it wins */
-		return 1;
-	else if (r0 && r1)
-		/* both of them have the subpath */
+	if (strncmp(path, _cache.dev_dir, devdir_len))
 		return -1;
 
-	/* no path has the subpath */
-	return -2;
-}
-
-static int _apply_builtin_path_preference_rules(const char *path0, const char *path1)
-{
-	size_t devdir_len = _cache.dev_dir_len;
-	int r;
+	if (!strncmp(path + devdir_len, "block/", 6))
+		return 0;
 
+	if (!strncmp(path + devdir_len, "dm-", 3))
+		return 1;
 
-	if (!strncmp(path0, _cache.dev_dir, devdir_len) &&
-	    !strncmp(path1, _cache.dev_dir, devdir_len)) {
-		/*
-		 * We're trying to achieve the ordering:
-		 *	/dev/block/ < /dev/dm-* < /dev/disk/ < /dev/mapper/ < anything else
-		 */
+	if (!strncmp(path + devdir_len, "disk/", 5))
+		return 2;
 
-		/* Prefer any other path over /dev/block/ path. */
-		if ((r = _builtin_preference(path0, path1, devdir_len, "block/")) >= -1)
-			return r;
+	if (!strncmp(path, dmdir, strlen(dmdir)))
+		return 3;
 
-		/* Prefer any other path over /dev/dm-* path. */
-		if ((r = _builtin_preference(path0, path1, devdir_len, "dm-")) >= -1)
-			return r;
+	return 4;
+}
 
-		/* Prefer any other path over /dev/disk/ path. */
-		if ((r = _builtin_preference(path0, path1, devdir_len, "disk/")) >= -1)
-			return r;
+/*
+ * Everything _compare_paths needs which depends only on the path,
+ * computed once per name instead of on every comparison.
+ */
+static void _rank_path(const char *path, struct dev_name_rank *rank)
+{
+	const char *p;
 
-		/* Prefer any other path over /dev/mapper/ path. */
-		if ((r = _builtin_preference(path0, path1, 0, dm_dir())) >= -1)
-			return r;
-	}
+	rank->name = path;
+	rank->regex = _cache.preferred_names_matcher ?
+		dm_regex_match(_cache.preferred_names_matcher, path) : -1;
+	rank->builtin = _builtin_path_preference(path);
 
-	return -1;
+	/* Count of slashes */
+	rank->slashes = 0;
+	for (p = path; p++; p = (const char *) strchr(p, '/'))
+		rank->slashes++;
 }
 
 /* Return 1 if we prefer path1 else return 0 */
-static int _compare_paths(const char *path0, const char *path1)
+static int _compare_paths(const struct dev_name_rank *rank0,
+			  const struct dev_name_rank *rank1)
 {
-	int slash0 = 0, slash1 = 0;
-	int m0, m1;
-	const char *p;
+	const char *path0 = rank0->name, *path1 = rank1->name;
 	char p0[PATH_MAX], p1[PATH_MAX];
 	char *s0, *s1;
 	struct stat stat0, stat1;
-	int r;
 
 	/*
 	 * FIXME Better to compare patterns one-at-a-time against all names.
 	 */
-	if (_cache.preferred_names_matcher) {
-		m0 = dm_regex_match(_cache.preferred_names_matcher, path0);
-		m1 = dm_regex_match(_cache.preferred_names_matcher, path1);
-
-		if (m0 != m1) {
-			if (m0 < 0)
-				return 1;
-			if (m1 < 0)
-				return 0;
-			if (m0 < m1)
-				return 1;
-			if (m1 < m0)
-				return 0;
-		}
+	if (rank0->regex != rank1->regex) {
+		if (rank0->regex < 0)
+			return 1;
+		if (rank1->regex < 0)
+			return 0;
+		if (rank0->regex < rank1->regex)
+			return 1;
+		if (rank1->regex < rank0->regex)
+			return 0;
 	}
 
 	/* Apply built-in preference rules first. */
-	if ((r = _apply_builtin_path_preference_rules(path0, path1)) >= 0)
-		return r;
+	if ((rank0->builtin >= 0) && (rank1->builtin >= 0) &&
+	    (rank0->builtin != rank1->builtin))
+		return (rank0->builtin < rank1->builtin) ? 1 : 0;
 
 	/* Return the path with fewer slashes */
-	for (p = path0; p++; p = (const char *) strchr(p, '/'))
-		slash0++;
-
-	for (p = path1; p++; p = (const char *) strchr(p, '/'))
-		slash1++;
-
-	if (slash0 < slash1)
+	if (rank0->slashes < rank1->slashes)
 		return 0;
-	if (slash1 < slash0)
+	if (rank1->slashes < rank0->slashes)
 		return 1;
 
 	dm_strncpy(p0, path0, sizeof(p0));
@@ -290,6 +271,7 @@ static int _add_alias(struct device *dev, const char *path, enum add_hash hash)
 	struct dm_str_list *sl;
 	struct dm_str_list *strl;
 	const char *oldpath;
+	struct dev_name_rank rank;
 	int prefer_old = 1;
 	size_t path_len = strlen(path);
 
@@ -303,26 +285,34 @@ static int _add_alias(struct device *dev, const char *path, enum add_hash hash)
 			goto out;
 		}
 
-	if (!(path = _strdup(path)) ||
-	    !(sl = _zalloc(sizeof(*sl)))) {
+	/* The name is stored right after its list entry, saving an allocation. */
+	if (!(sl = dm_pool_alloc(_cache.mem, sizeof(*sl) + path_len + 1))) {
 		log_error("Failed to add allias to dev cache.");
 		return 0;
 	}
 
+	path = sl->str = memcpy(sl + 1, path, path_len + 1);
+
 	if (!strncmp(path, "/dev/nvme", 9))
 		dev->flags |= DEV_IS_NVME;
 
-	sl->str = path;
+	_rank_path(path, &rank);
 
 	if (!dm_list_empty(&dev->aliases)) {
 		oldpath = dm_list_item(dev->aliases.n, struct dm_str_list)->str;
-		prefer_old = _compare_paths(path, oldpath);
+		/* The preferred name changes also by dev_set_preferred_name or drops. */
+		if (dev->name_rank.name != oldpath)
+			_rank_path(oldpath, &dev->name_rank);
+		prefer_old = _compare_paths(&rank, &dev->name_rank);
 	}
 
 	if (prefer_old)
 		dm_list_add(&dev->aliases, &sl->list);
 	else
 		dm_list_add_h(&dev->aliases, &sl->list);
+
+	if (dev->aliases.n == &sl->list)
+		dev->name_rank = rank;
 out:
 	if ((hash != NO_HASH) &&
 	    !radix_tree_insert_ptr(_cache.names, path, path_len, dev)) {
@@ -997,13 +987,90 @@ static int _dev_cache_index_devs(struct cmd_context *cmd)
 	return _dev_cache_iterate_sysfs_for_index(cmd, path);
 }
 
+static void _drop_all_aliases(struct device *dev)
+{
+	struct dm_str_list *strl, *strl2;
+
+	dm_list_iterate_items_safe(strl, strl2, &dev->aliases) {
+		log_debug("Drop alias for %u:%u %s.", MAJOR(dev->dev), MINOR(dev->dev), strl->str);
+		radix_tree_remove(_cache.names, strl->str, strlen(strl->str));
+		dm_list_del(&strl->list);
+	}
+
+	/* The devno may now be used by a different device. */
+	dev->flags &= ~DEV_PRIMARY_KNOWN;
+}
+
 #ifdef UDEV_SYNC_SUPPORT
 
+/*
+ * The udev_device of each block device from the udev db enumeration
+ * done at scan is kept in _cache.udev_devices, indexed by devno.
+ * The external device info source and the checks with udev db then use
+ * it instead of looking up every device again, and the udev db
+ * properties libudev reads on first use stay cached for the next
+ * filter passes.  Devices missing there, e.g. those udev has not yet
+ * processed at scan, are still looked up individually.
+ */
+static void _udev_device_dtr(void *context, union radix_value v)
+{
+	udev_device_unref((struct udev_device *) v.ptr);
+}
+
+static void _udev_devices_destroy(void)
+{
+	if (_cache.udev_devices) {
+		radix_tree_destroy(_cache.udev_devices);
+		_cache.udev_devices = NULL;
+	}
+
+	_cache.udev_devices_enumerated = 0;
+}
+
+static struct udev_device *_udev_devices_lookup(dev_t devno)
+{
+	uint32_t key = _shuffle_devno(devno);
+
+	if (!_cache.udev_devices)
+		return NULL;
+
+	return radix_tree_lookup_ptr(_cache.udev_devices, &key, sizeof(key));
+}
+
+static void _udev_devices_drop(dev_t devno)
+{
+	uint32_t key = _shuffle_devno(devno);
+
+	if (_cache.udev_devices)
+		(void) radix_tree_remove(_cache.udev_devices, &key, sizeof(key));
+}
+
+/* Takes over the reference to the device when it is kept. */
+static int _udev_devices_keep(struct udev_device *device)
+{
+	dev_t devno;
+
+	if (!_cache.udev_devices ||
+	    !(devno = udev_device_get_devnum(device)) ||
+	    _udev_devices_lookup(devno))
+		return 0;
+
+#ifdef HAVE_LIBUDEV_UDEV_DEVICE_GET_IS_INITIALIZED
+	if (!udev_device_get_is_initialized(device))
+		return 0;
+#endif
+
+	return _dev_cache_insert_devno(_cache.udev_devices, devno, device);
+}
+
 static int _device_in_udev_db(const dev_t d)
 {
 	struct udev *udev;
 	struct udev_device *udev_device;
 
+	if (_udev_devices_lookup(d))
+		return 1;
+
 	if (!(udev = udev_get_library_context()))
 		return_0;
 
@@ -1015,7 +1082,11 @@ static int _device_in_udev_db(const dev_t d)
 	return 0;
 }
 
-static int _insert_udev_dir(struct udev *udev, const char *dir)
+/*
+ * Enumerates block devices in udev db, keeping them in _cache.udev_devices
+ * and when dir is set, inserting their nodes and symlinks to the cache.
+ */
+static int _enumerate_udev_devices(struct udev *udev, const char *dir)
 {
 	struct udev_enumerate *udev_enum = NULL;
 	struct udev_list_entry *device_entry, *symlink_entry;
@@ -1023,6 +1094,12 @@ static int _insert_udev_dir(struct udev *udev, const char *dir)
 	struct udev_device *device;
 	int r = 1;
 
+	if (!_cache.udev_devices &&
+	    !(_cache.udev_devices = radix_tree_create(_udev_device_dtr, NULL)))
+		log_debug_devs("Failed to create udev devices table.");
+
+	_cache.udev_devices_enumerated = 1;
+
 	if (!(udev_enum = udev_enumerate_new(udev))) {
 		log_error("Failed to udev_enumerate_new.");
 		return 0;
@@ -1056,6 +1133,9 @@ static int _insert_udev_dir(struct udev *udev, const char *dir)
 			continue;
 		}
 
+		if (!dir)
+			goto keep;
+
 		if (!(node_name = udev_device_get_devnode(device)))
 			log_very_verbose("udev failed to return a device node for entry %s.",
 					 entry_name);
@@ -1069,8 +1149,9 @@ static int _insert_udev_dir(struct udev *udev, const char *dir)
 			else
 				r &= _insert(symlink_name, NULL, 0, 0);
 		}
-
-		udev_device_unref(device);
+keep:
+		if (!_udev_devices_keep(device))
+			udev_device_unref(device);
 	}
 
 out:
@@ -1079,6 +1160,21 @@ out:
 	return r;
 }
 
+void *dev_cache_get_udev_device(dev_t devno)
+{
+	struct udev *udev;
+	struct udev_device *device;
+
+	if (!_cache.udev_devices_enumerated && _cache.has_scanned &&
+	    (udev = udev_get_library_context()))
+		(void) _enumerate_udev_devices(udev, NULL);
+
+	if (!(device = _udev_devices_lookup(devno)))
+		return NULL;
+
+	return udev_device_ref(device);
+}
+
 static void _insert_dirs(struct dm_list *dirs)
 {
 	struct dir_list *dl;
@@ -1097,7 +1193,7 @@ static void _insert_dirs(struct dm_list *dirs)
 		}
 		_cache.st_dev = tinfo.st_dev;
 		if (with_udev) {
-			if (!_insert_udev_dir(udev, dl->dir))
+			if (!_enumerate_udev_devices(udev, dl->dir))
 				log_debug_devs("%s: Failed to insert devices from "
 					       "udev-managed directory to device "
 					       "cache fully", dl->dir);
@@ -1108,6 +1204,150 @@ static void _insert_dirs(struct dm_list *dirs)
 	}
 }
 
+/*
+ * A long lived command context (lvm shell, lvm2cmd library) runs
+ * dev_cache_scan for each command, and the dev cache persists between
+ * them.  Instead of enumerating all devices again, it can subscribe to
+ * udev block device events when doing the first full scan, and apply
+ * the add/change/remove events received since the previous scan.
+ * Names that become invalid without a remove event are still dropped
+ * by dev_cache_verify_aliases.
+ */
+static void _udev_monitor_destroy(void)
+{
+	if (_cache.udev_monitor) {
+		udev_monitor_unref(_cache.udev_monitor);
+		_cache.udev_monitor = NULL;
+	}
+}
+
+static void _udev_monitor_create(void)
+{
+	struct udev *udev;
+	struct udev_monitor *mon;
+
+	if (!(udev = udev_get_library_context()))
+		return;
+
+	if (!(mon = udev_monitor_new_from_netlink(udev, "udev"))) {
+		log_debug_devs("Failed to create udev monitor.");
+		return;
+	}
+
+	if (udev_monitor_filter_add_match_subsystem_devtype(mon, "block", NULL) ||
+	    udev_monitor_enable_receiving(mon)) {
+		log_debug_devs("Failed to enable udev monitor.");
+		udev_monitor_unref(mon);
+		return;
+	}
+
+	/* Overflow is detected and handled by a full scan, so this may fail. */
+	(void) udev_monitor_set_receive_buffer_size(mon, 8 * 1024 * 1024);
+
+	log_debug_devs("Monitoring udev block device events.");
+
+	_cache.udev_monitor = mon;
+}
+
+/* Non-udev device lists only include names in the scanned dirs. */
+static int _path_in_dirs(const char *path)
+{
+	struct dir_list *dl;
+	size_t len;
+
+	if (obtain_device_list_from_udev())
+		return 1;
+
+	dm_list_iterate_items(dl, &_cache.dirs) {
+		len = strlen(dl->dir);
+		if (!strncmp(path, dl->dir, len) &&
+		    ((path[len] == '/') || (len && (dl->dir[len - 1] == '/'))))
+			return 1;
+	}
+
+	return 0;
+}
+
+static void _apply_udev_event(struct udev_device *device)
+{
+	struct udev_list_entry *symlink_entry;
+	const char *action, *node_name, *symlink_name;
+	struct device *dev;
+	dev_t devno;
+
+	if (!(action = udev_device_get_action(device)) ||
+	    !(devno = udev_device_get_devnum(device)))
+		return;
+
+	dev = _dev_cache_get_dev_by_devno(_cache.devices, devno);
+
+	/* Looked up again with the updated udev db. */
+	_udev_devices_drop(devno);
+
+	if (!strcmp(action, "remove")) {
+		log_debug_devs("udev event remove %u:%u.", MAJOR(devno), MINOR(devno));
+		if (dev)
+			_drop_all_aliases(dev);
+		return;
+	}
+
+	log_debug_devs("udev event %s %u:%u.", action, MAJOR(devno), MINOR(devno));
+
+	/* A new device reusing the devno of one that went away. */
+	if (dev && !strcmp(action, "add"))
+		_drop_all_aliases(dev);
+
+	if ((node_name = udev_device_get_devnode(device)) && _path_in_dirs(node_name))
+		(void) _insert(node_name, NULL, 0, 0);
+
+	udev_list_entry_foreach(symlink_entry, udev_device_get_devlinks_list_entry(device)) {
+		if ((symlink_name = udev_list_entry_get_name(symlink_entry)) &&
+		    _path_in_dirs(symlink_name))
+			(void) _insert(symlink_name, NULL, 0, 0);
+	}
+}
+
+/*
+ * Returns 0 if the events could not all be received, in which
+ * case a full scan is needed.
+ */
+static int _apply_udev_events(void)
+{
+	struct udev_device *device;
+	struct pollfd pfd = {
+		.fd = udev_monitor_get_fd(_cache.udev_monitor),
+		.events = POLLIN,
+	};
+	unsigned count = 0;
+	int r;
+
+	while ((r = poll(&pfd, 1, 0)) > 0) {
+		if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+			return 0;
+
+		errno = 0;
+		if (!(device = udev_monitor_receive_device(_cache.udev_monitor))) {
+			/* Events were lost. */
+			if (errno == ENOBUFS)
+				return 0;
+			continue;
+		}
+
+		_apply_udev_event(device);
+		udev_device_unref(device);
+		count++;
+	}
+
+	if (r < 0) {
+		log_sys_debug("poll", "udev monitor");
+		return 0;
+	}
+
+	log_debug_devs("Updated list of system devices from %u udev events.", count);
+
+	return 1;
+}
+
 #else	/* UDEV_SYNC_SUPPORT */
 
 static int _device_in_udev_db(const dev_t d)
@@ -1115,6 +1355,11 @@ static int _device_in_udev_db(const dev_t d)
 	return 0;
 }
 
+void *dev_cache_get_udev_device(dev_t devno)
+{
+	return NULL;
+}
+
 static void _insert_dirs(struct dm_list *dirs)
 {
 	struct dir_list *dl;
@@ -1181,19 +1426,22 @@ static int _insert(const char *path, const struct stat *info,
 	return 1;
 }
 
-static void _drop_all_aliases(struct device *dev)
+void dev_cache_scan(struct cmd_context *cmd)
 {
-	struct dm_str_list *strl, *strl2;
-
-	dm_list_iterate_items_safe(strl, strl2, &dev->aliases) {
-		log_debug("Drop alias for %u:%u %s.", MAJOR(dev->dev), MINOR(dev->dev), strl->str);
-		radix_tree_remove(_cache.names, strl->str, strlen(strl->str));
-		dm_list_del(&strl->list);
+#ifdef UDEV_SYNC_SUPPORT
+	if (_cache.udev_monitor) {
+		if (_apply_udev_events())
+			goto out;
+		log_debug_devs("Missed udev events, rescanning devices.");
+		_udev_monitor_destroy();
 	}
-}
 
-void dev_cache_scan(struct cmd_context *cmd)
-{
+	/* Subscribe before scanning so no change is missed. */
+	if (cmd->is_long_lived)
+		_udev_monitor_create();
+
+	_udev_devices_destroy();
+#endif
 	log_debug_devs("Creating list of system devices.");
 
 	_cache.has_scanned = 1;
@@ -1202,6 +1450,9 @@ void dev_cache_scan(struct cmd_context *cmd)
 	_insert_dirs(&_cache.dirs);
 	setlocale(LC_COLLATE, "");
 
+#ifdef UDEV_SYNC_SUPPORT
+out:
+#endif
 	if (cmd->check_devs_used)
 		(void) _dev_cache_index_devs(cmd);
 }
@@ -1276,9 +1527,26 @@ int dm_devs_cache_use(void)
 	return _cache.use_dm_devs_cache;
 }
 
+static void _dm_holders_destroy(void)
+{
+	if (_cache.dm_holders) {
+		radix_tree_destroy(_cache.dm_holders);
+		_cache.dm_holders = NULL;
+	}
+
+	if (_cache.dm_holders_mem) {
+		dm_pool_destroy(_cache.dm_holders_mem);
+		_cache.dm_holders_mem = NULL;
+	}
+}
+
 void dm_devs_cache_destroy(void)
 {
 	_cache.use_dm_devs_cache = 0;
+	_cache.dm_devs_count = 0;
+	_cache.dm_holders_queries = 0;
+
+	_dm_holders_destroy();
 
 	if (_cache.dm_devnos) {
 		radix_tree_destroy(_cache.dm_devnos);
@@ -1330,6 +1598,8 @@ int dm_devs_cache_update(void)
 		if (dm_dev->uuid[0] &&
 		    !radix_tree_insert_ptr(_cache.dm_uuids, dm_dev->uuid, strlen(dm_dev->uuid), dm_dev))
 			return_0;
+
+		_cache.dm_devs_count++;
 	}
 
 	//radix_tree_dump(_cache.dm_devnos, stdout);
@@ -1365,6 +1635,109 @@ dm_devs_cache_get_by_devno(struct cmd_context *cmd, dev_t devno)
 	return radix_tree_lookup_ptr(_cache.dm_devnos, &d, sizeof(d));
 }
 
+static int _dm_holders_add(dev_t devno, const struct dm_active_device *dm_dev)
+{
+	uint32_t d = _shuffle_devno(devno);
+	struct dm_list *holders;
+	struct dm_holder *holder;
+
+	if (!(holders = radix_tree_lookup_ptr(_cache.dm_holders, &d, sizeof(d)))) {
+		if (!(holders = dm_pool_alloc(_cache.dm_holders_mem, sizeof(*holders))))
+			return_0;
+
+		dm_list_init(holders);
+
+		if (!radix_tree_insert_ptr(_cache.dm_holders, &d, sizeof(d), holders))
+			return_0;
+	}
+
+	if (!(holder = dm_pool_alloc(_cache.dm_holders_mem, sizeof(*holder))))
+		return_0;
+
+	holder->dm_dev = dm_dev;
+	dm_list_add(holders, &holder->list);
+
+	return 1;
+}
+
+/*
+ * Index holders of all devices using DM_DEVICE_DEPS of every dm_devs entry.
+ * A device that went away since DM_DEVICE_LIST is skipped.
+ */
+static int _dm_holders_index(void)
+{
+	struct dm_active_device *dm_dev;
+	struct dm_task *dmt;
+	struct dm_deps *deps;
+	uint32_t i;
+
+	if (!(_cache.dm_holders_mem = dm_pool_create("dm holders", 1024)) ||
+	    !(_cache.dm_holders = radix_tree_create(NULL, NULL)))
+		goto_bad;
+
+	dm_list_iterate_items(dm_dev, _cache.dm_devs) {
+		if (!(dmt = dm_task_create(DM_DEVICE_DEPS)))
+			goto_bad;
+
+		if (!dm_task_set_major_minor(dmt, MAJOR(dm_dev->devno), MINOR(dm_dev->devno), 1) ||
+		    !dm_task_no_open_count(dmt)) {
+			dm_task_destroy(dmt);
+			goto_bad;
+		}
+
+		if (!dm_task_run(dmt) || !(deps = dm_task_get_deps(dmt))) {
+			log_debug_devs("Skipping dependencies of %s.", dm_dev->name);
+			dm_task_destroy(dmt);
+			continue;
+		}
+
+		for (i = 0; i < deps->count; i++)
+			if (!_dm_holders_add((dev_t) deps->device[i], dm_dev)) {
+				dm_task_destroy(dmt);
+				goto_bad;
+			}
+
+		dm_task_destroy(dmt);
+	}
+
+	log_debug_devs("Indexed holders of devices from %u dm devices.", _cache.dm_devs_count);
+
+	return 1;
+
+bad:
+	_dm_holders_destroy();
+
+	return 0;
+}
+
+/*
+ * Holders are read from sysfs per device until the number of queries
+ * makes the single pass DM_DEVICE_DEPS over all dm devices cheaper,
+ * as each sysfs lookup takes several syscalls.
+ */
+#define DM_HOLDERS_QUERY_COST 4
+
+int dm_devs_cache_get_holders(struct cmd_context *cmd, dev_t devno,
+			      const struct dm_list **holders)
+{
+	uint32_t d = _shuffle_devno(devno);
+
+	if (!_cache.use_dm_devs_cache)
+		return 0;
+
+	if (!_cache.dm_holders) {
+		if (++_cache.dm_holders_queries * DM_HOLDERS_QUERY_COST < _cache.dm_devs_count)
+			return 0;
+
+		if (!_dm_holders_index())
+			return 0;
+	}
+
+	*holders = radix_tree_lookup_ptr(_cache.dm_holders, &d, sizeof(d));
+
+	return 1;
+}
+
 /* Find active DM device in devs array for given DM UUID */
 const struct dm_active_device *
 dm_devs_cache_get_by_uuid(struct cmd_context *cmd, const char *dm_uuid)
@@ -1501,6 +1874,10 @@ int dev_cache_exit(void)
 	if (_cache.sysfs_only_devices)
 	       radix_tree_destroy(_cache.sysfs_only_devices);
 
+#ifdef UDEV_SYNC_SUPPORT
+	_udev_monitor_destroy();
+	_udev_devices_destroy();
+#endif
 	memset(&_cache, 0, sizeof(_cache));
 
 	return (!vt.num_open);
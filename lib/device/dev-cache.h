@@ -58,6 +58,19 @@ dm_devs_cache_get_by_devno(struct cmd_context *cmd, dev_t devno);
 const struct dm_active_device *
 dm_devs_cache_get_by_uuid(struct cmd_context *cmd, const char *dm_uuid);
 
+struct dm_holder {
+	struct dm_list list;
+	const struct dm_active_device *dm_dev;
+};
+
+/*
+ * Sets holders to the list of dm_holder with active DM devices using
+ * devno, or NULL when there are none.  Returns 0 when holders are not
+ * indexed and need to be read from sysfs.
+ */
+int dm_devs_cache_get_holders(struct cmd_context *cmd, dev_t devno,
+			      const struct dm_list **holders);
+
 /*
  * The global device cache.
  */
@@ -81,6 +94,12 @@ void dev_cache_verify_aliases(struct device *dev);
 
 struct device *dev_cache_get_dev_by_name(const char *name);
 
+/*
+ * Returns a new reference to the udev_device of devno from the udev db
+ * enumeration at scan, or NULL when it needs to be looked up directly.
+ */
+void *dev_cache_get_udev_device(dev_t devno);
+
 void dev_set_preferred_name(struct dm_str_list *sl, struct device *dev);
 
 /*
@@ -14,6 +14,7 @@
 
 #include "lib/misc/lib.h"
 #include "lib/device/device.h"
+#include "lib/device/dev-cache.h"
 
 #ifdef UDEV_SYNC_SUPPORT
 #include <libudev.h>
@@ -54,6 +55,9 @@ static struct dev_ext *_dev_ext_get_udev(struct device *dev)
 	if (dev->ext.handle)
 		return &dev->ext;
 
+	if ((udev_device = dev_cache_get_udev_device(dev->dev)))
+		goto out;
+
 	if (!(udev = udev_get_library_context()))
 		return_NULL;
 
@@ -64,10 +68,11 @@ static struct dev_ext *_dev_ext_get_udev(struct device *dev)
 	if (!udev_device_get_is_initialized(udev_device)) {
 		/* Timeout or some other udev db inconsistency! */
 		log_error("Udev database has incomplete information about device %s.", dev_name(dev));
+		udev_device_unref(udev_device);
 		return NULL;
 	}
 #endif
-
+out:
 	dev->ext.handle = (void *) udev_device;
 	return &dev->ext;
 #else
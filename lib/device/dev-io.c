@@ -83,6 +83,51 @@ static int _dev_get_size_file(struct device *dev, uint64_t *size)
 	return 1;
 }
 
+/*
+ * While label_scan filters devices, the fd opened to get the size
+ * of a device is kept, and the scan then reads the device with it
+ * rather than opening the device again.
+ */
+static unsigned _keep_size_fds = 0;
+
+static void _close(struct device *dev);
+
+void dev_keep_size_fds(unsigned max)
+{
+	_keep_size_fds = max;
+}
+
+/* Returns the kept fd which the caller now owns, or -1. */
+int dev_take_size_fd(struct device *dev)
+{
+	int fd;
+
+	if (!(dev->flags & DEV_KEPT_SIZE_FD))
+		return -1;
+
+	dev->flags &= ~DEV_KEPT_SIZE_FD;
+
+	/* Closed or opened again by someone else since. */
+	if ((dev->fd < 0) || dev->open_count)
+		return -1;
+
+	fd = dev->fd;
+	dev->fd = -1;
+
+	return fd;
+}
+
+void dev_close_size_fd(struct device *dev)
+{
+	if (!(dev->flags & DEV_KEPT_SIZE_FD))
+		return;
+
+	dev->flags &= ~DEV_KEPT_SIZE_FD;
+
+	if ((dev->fd >= 0) && !dev->open_count)
+		_close(dev);
+}
+
 static int _dev_get_size_dev(struct device *dev, uint64_t *size)
 {
 	const char *name = dev_name(dev);
@@ -119,6 +164,16 @@ static int _dev_get_size_dev(struct device *dev, uint64_t *size)
 
 	log_very_verbose("%s: size is %" PRIu64 " sectors", name, *size);
 
+	/* Same open flags as label scan uses, so it can read with this fd. */
+	if (do_close && _keep_size_fds && (dev->open_count == 1) &&
+	    (dev->flags & DEV_O_DIRECT) &&
+	    !(dev->flags & (DEV_OPENED_RW | DEV_OPENED_EXCL))) {
+		_keep_size_fds--;
+		dev->open_count = 0;
+		dev->flags |= DEV_KEPT_SIZE_FD;
+		do_close = 0;
+	}
+
 	if (do_close && !dev_close_immediate(dev))
 		stack;
 
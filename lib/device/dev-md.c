@@ -146,6 +146,30 @@ static int _dev_has_ddf_magic(struct device *dev, uint64_t devsize_sectors, uint
 	return 0;
 }
 
+/*
+ * Byte range at the end of the device holding all the superblocks read
+ * by a full md component check (md 0.90 and 1.0, imsm and ddf), so the
+ * scan can prefetch it together with the start of the device.
+ */
+int dev_md_tail_region(struct device *dev, uint64_t *start, uint64_t *len)
+{
+	uint64_t size, ddf_offset;
+
+	if (!dev_get_size(dev, &size) || (size < MD_RESERVED_SECTORS * 2))
+		return 0;
+
+	*start = MD_NEW_SIZE_SECTORS(size) << SECTOR_SHIFT;
+
+	/* ddf 128KB before the end, see _dev_has_ddf_magic() */
+	if (((size << SECTOR_SHIFT) >= 0x30000) &&
+	    ((ddf_offset = (size - 257) << SECTOR_SHIFT) < *start))
+		*start = ddf_offset;
+
+	*len = (size << SECTOR_SHIFT) - *start;
+
+	return 1;
+}
+
 #ifdef UDEV_SYNC_SUPPORT
 static int _dev_is_md_component_udev(struct device *dev)
 {
@@ -528,6 +552,13 @@ int dev_is_md_component(struct cmd_context *cmd __attribute__((unused)),
 	return 0;
 }
 
+int dev_md_tail_region(struct device *dev __attribute__((unused)),
+		       uint64_t *start __attribute__((unused)),
+		       uint64_t *len __attribute__((unused)))
+{
+	return 0;
+}
+
 unsigned long dev_md_stripe_width(struct dev_types *dt __attribute__((unused)),
 				  struct device *dev __attribute__((unused)))
 {
@@ -62,24 +62,99 @@ int dev_is_lv(struct cmd_context *cmd, struct device *dev)
 	return 0;
 }
 
+struct lv_holders {
+	int want_name;
+	int want_vgid;
+	int want_lvid;
+	int count;
+	char *name;
+	char *vgid;
+	char *lvid;
+};
+
+/* Count dm device major:minor named holder_name (e.g. "dm-1") if it is an LV. */
+static void _add_lv_holder(struct cmd_context *cmd, unsigned dm_dev_major, unsigned dm_dev_minor,
+			   const char *holder_name, struct lv_holders *h)
+{
+	char dm_uuid[DM_UUID_LEN];
+	const size_t lvm_prefix_len = sizeof(UUID_PREFIX) - 1;
+	const size_t lvm_uuid_len = lvm_prefix_len + 2 * ID_LEN;
+	size_t uuid_len;
+
+	/*
+	 * if "dm-1" is a dm device, then check if it's an LVM LV
+	 * by reading DM status and seeing if the uuid begins
+	 * with UUID_PREFIX  ("LVM-")
+	 */
+	if (!devno_dm_uuid(cmd, dm_dev_major, dm_dev_minor, dm_uuid, sizeof(dm_uuid)))
+		return;
+
+	if (!strncmp(dm_uuid, UUID_PREFIX, lvm_prefix_len))
+		h->count++;
+
+	if (h->want_name && !h->name)
+		h->name = dm_pool_strdup(cmd->mem, holder_name);
+
+	if (!h->want_vgid && !h->want_lvid)
+		return;
+
+	/*
+	 * UUID for LV is either "LVM-<vg_uuid><lv_uuid>" or
+	 * "LVM-<vg_uuid><lv_uuid>-<suffix>", where vg_uuid and lv_uuid
+	 * has length of ID_LEN and suffix len is not restricted (only
+	 * restricted by whole DM UUID max len).
+	 */
+
+	uuid_len = strlen(dm_uuid);
+
+	if (((uuid_len == lvm_uuid_len) ||
+	    ((uuid_len > lvm_uuid_len) && (dm_uuid[lvm_uuid_len] == '-'))) &&
+	    !strncmp(dm_uuid, UUID_PREFIX, lvm_prefix_len)) {
+
+		if (h->want_vgid && !h->vgid)
+			h->vgid = dm_pool_strndup(cmd->mem, dm_uuid + lvm_prefix_len, ID_LEN);
+
+		if (h->want_lvid && !h->lvid)
+			h->lvid = dm_pool_strndup(cmd->mem, dm_uuid + lvm_prefix_len + ID_LEN, ID_LEN);
+	}
+}
+
 int dev_is_used_by_active_lv(struct cmd_context *cmd, struct device *dev, int *used_by_lv_count,
 			     char **used_by_dm_name, char **used_by_vg_uuid, char **used_by_lv_uuid)
 {
 	char holders_path[PATH_MAX];
 	char dm_dev_path[PATH_MAX];
-	char dm_uuid[DM_UUID_LEN];
+	char dm_dev_name[16];
 	struct stat info;
 	DIR *d;
 	struct dirent *dirent;
 	char *holder_name;
-	unsigned dm_dev_major, dm_dev_minor;
-	const size_t lvm_prefix_len = sizeof(UUID_PREFIX) - 1;
-	const size_t lvm_uuid_len = lvm_prefix_len + 2 * ID_LEN;
-	size_t uuid_len;
-	int used_count = 0;
-	char *used_name = NULL;
-	char *used_vgid = NULL;
-	char *used_lvid = NULL;
+	const struct dm_list *dm_holders;
+	const struct dm_holder *dm_holder;
+	struct lv_holders h = {
+		.want_name = used_by_dm_name ? 1 : 0,
+		.want_vgid = used_by_vg_uuid ? 1 : 0,
+		.want_lvid = used_by_lv_uuid ? 1 : 0,
+	};
+
+	/*
+	 * With the dm devs cache, holders of all devices can be
+	 * indexed from the dependencies of active dm devices.
+	 */
+	if (dm_devs_cache_get_holders(cmd, dev->dev, &dm_holders)) {
+		if (!dm_holders)
+			goto out;
+
+		dm_list_iterate_items(dm_holder, dm_holders) {
+			if (dm_snprintf(dm_dev_name, sizeof(dm_dev_name), "dm-%u",
+					MINOR(dm_holder->dm_dev->devno)) < 0)
+				continue;
+
+			_add_lv_holder(cmd, MAJOR(dm_holder->dm_dev->devno),
+				       MINOR(dm_holder->dm_dev->devno), dm_dev_name, &h);
+		}
+		goto out;
+	}
 
 	/*
 	 * An LV using this device will be listed as a "holder" in the device's
@@ -116,63 +191,25 @@ int dev_is_used_by_active_lv(struct cmd_context *cmd, struct device *dev, int *u
 		if (stat(dm_dev_path, &info))
 			continue;
 
-		dm_dev_major = MAJOR(info.st_rdev);
-		dm_dev_minor = MINOR(info.st_rdev);
-        
-		if (dm_dev_major != cmd->dev_types->device_mapper_major)
+		if (MAJOR(info.st_rdev) != cmd->dev_types->device_mapper_major)
 			continue;
 
-		/*
-		 * if "dm-1" is a dm device, then check if it's an LVM LV
-		 * by reading DM status and seeing if the uuid begins
-		 * with UUID_PREFIX  ("LVM-")
-		 */
-		if (!devno_dm_uuid(cmd, dm_dev_major, dm_dev_minor, dm_uuid, sizeof(dm_uuid)))
-			continue;
-
-		if (!strncmp(dm_uuid, UUID_PREFIX, lvm_prefix_len))
-			used_count++;
-
-		if (used_by_dm_name && !used_name)
-			used_name = dm_pool_strdup(cmd->mem, holder_name);
-
-		if (!used_by_vg_uuid && !used_by_lv_uuid)
-			continue;
-
-		/*
-		 * UUID for LV is either "LVM-<vg_uuid><lv_uuid>" or
-		 * "LVM-<vg_uuid><lv_uuid>-<suffix>", where vg_uuid and lv_uuid
-		 * has length of ID_LEN and suffix len is not restricted (only
-		 * restricted by whole DM UUID max len).
-		 */
-
-		uuid_len = strlen(dm_uuid);
-
-		if (((uuid_len == lvm_uuid_len) ||
-		    ((uuid_len > lvm_uuid_len) && (dm_uuid[lvm_uuid_len] == '-'))) &&
-		    !strncmp(dm_uuid, UUID_PREFIX, lvm_prefix_len)) {
-
-			if (used_by_vg_uuid && !used_vgid)
-				used_vgid = dm_pool_strndup(cmd->mem, dm_uuid + lvm_prefix_len, ID_LEN);
-
-			if (used_by_lv_uuid && !used_lvid)
-				used_lvid = dm_pool_strndup(cmd->mem, dm_uuid + lvm_prefix_len + ID_LEN, ID_LEN);
-		}
+		_add_lv_holder(cmd, MAJOR(info.st_rdev), MINOR(info.st_rdev), holder_name, &h);
 	}
 
 	if (closedir(d))
 		log_sys_debug("closedir", holders_path);
-
+out:
 	if (used_by_lv_count)
-		*used_by_lv_count = used_count;
+		*used_by_lv_count = h.count;
 	if (used_by_dm_name)
-		*used_by_dm_name = used_name;
+		*used_by_dm_name = h.name;
 	if (used_by_vg_uuid)
-		*used_by_vg_uuid = used_vgid;
+		*used_by_vg_uuid = h.vgid;
 	if (used_by_lv_uuid)
-		*used_by_lv_uuid = used_lvid;
+		*used_by_lv_uuid = h.lvid;
 
-	if (used_count)
+	if (h.count)
 		return 1;
 	return 0;
 }
@@ -711,6 +748,15 @@ int dev_get_primary_dev(struct dev_types *dt, struct device *dev, dev_t *result)
 	FILE *fp = NULL;
 	int parts, residue, size, ret = 0;
 
+	/*
+	 * Filters, device ids and md/mpath component checks all ask for
+	 * the primary dev, cache it to avoid repeating the sysfs lookups.
+	 */
+	if (dev->flags & DEV_PRIMARY_KNOWN) {
+		*result = dev->primary;
+		return (dev->primary == dev->dev) ? 1 : 2;
+	}
+
 	/*
 	 * /dev/nvme devs don't use the major:minor numbering like
 	 * block dev types that have their own major number, so
@@ -798,6 +844,11 @@ out:
 	if (fp && fclose(fp))
 		log_sys_debug("fclose", path);
 
+	if (ret) {
+		dev->primary = *result;
+		dev->flags |= DEV_PRIMARY_KNOWN;
+	}
+
 	return ret;
 }
 
@@ -1264,14 +1315,23 @@ out:
 	return ret;
 }
 
+/*
+ * Topology values do not change while a command runs, so each is read
+ * from sysfs once per device.  Activating or discarding many LVs on the
+ * same PVs would otherwise repeat the sysfs reads for every segment.
+ */
 static unsigned long _dev_topology_attribute(struct dev_types *dt,
 					     const char *attribute,
+					     unsigned idx,
 					     struct device *dev,
 					     unsigned long default_value)
 {
 	unsigned long result = default_value;
 	unsigned long value = 0UL;
 
+	if (dev->topology_known & (1U << idx))
+		return dev->topology[idx];
+
 	if (_dev_sysfs_block_attribute(dt, attribute, dev, &value)) {
 		log_very_verbose("Device %s: %s is %lu%s.",
 				 dev_name(dev), attribute, value, default_value ? "" : " bytes");
@@ -1285,32 +1345,46 @@ static unsigned long _dev_topology_attribute(struct dev_types *dt,
 		}
 	}
 
+	dev->topology[idx] = result;
+	dev->topology_known |= (1U << idx);
+
 	return result;
 }
 
 unsigned long dev_alignment_offset(struct dev_types *dt, struct device *dev)
 {
-	return _dev_topology_attribute(dt, "alignment_offset", dev, 0UL);
+	return _dev_topology_attribute(dt, "alignment_offset",
+				       DEV_TOPOLOGY_ALIGNMENT_OFFSET, dev, 0UL);
 }
 
 unsigned long dev_minimum_io_size(struct dev_types *dt, struct device *dev)
 {
-	return _dev_topology_attribute(dt, "queue/minimum_io_size", dev, 0UL);
+	return _dev_topology_attribute(dt, "queue/minimum_io_size",
+				       DEV_TOPOLOGY_MINIMUM_IO_SIZE, dev, 0UL);
 }
 
 unsigned long dev_optimal_io_size(struct dev_types *dt, struct device *dev)
 {
-	return _dev_topology_attribute(dt, "queue/optimal_io_size", dev, 0UL);
+	return _dev_topology_attribute(dt, "queue/optimal_io_size",
+				       DEV_TOPOLOGY_OPTIMAL_IO_SIZE, dev, 0UL);
 }
 
 unsigned long dev_discard_max_bytes(struct dev_types *dt, struct device *dev)
 {
-	return _dev_topology_attribute(dt, "queue/discard_max_bytes", dev, 0UL);
+	return _dev_topology_attribute(dt, "queue/discard_max_bytes",
+				       DEV_TOPOLOGY_DISCARD_MAX_BYTES, dev, 0UL);
 }
 
 unsigned long dev_discard_granularity(struct dev_types *dt, struct device *dev)
 {
-	return _dev_topology_attribute(dt, "queue/discard_granularity", dev, 0UL);
+	return _dev_topology_attribute(dt, "queue/discard_granularity",
+				       DEV_TOPOLOGY_DISCARD_GRANULARITY, dev, 0UL);
+}
+
+unsigned long dev_write_zeroes_max_bytes(struct dev_types *dt, struct device *dev)
+{
+	return _dev_topology_attribute(dt, "queue/write_zeroes_max_bytes",
+				       DEV_TOPOLOGY_WRITE_ZEROES_MAX_BYTES, dev, 0UL);
 }
 
 int dev_is_rotational(struct dev_types *dt, struct device *dev)
@@ -1358,6 +1432,11 @@ unsigned long dev_discard_granularity(struct dev_types *dt, struct device *dev)
 	return 0UL;
 }
 
+unsigned long dev_write_zeroes_max_bytes(struct dev_types *dt, struct device *dev)
+{
+	return 0UL;
+}
+
 int dev_is_rotational(struct dev_types *dt, struct device *dev)
 {
 	return 1;
@@ -59,6 +59,7 @@ int major_is_scsi_device(struct dev_types *dt, int major);
 
 /* Signature/superblock recognition with position returned where found. */
 int dev_is_md_component(struct cmd_context *cmd, struct device *dev, uint64_t *sb, int full);
+int dev_md_tail_region(struct device *dev, uint64_t *start, uint64_t *len);
 int dev_is_mpath_component(struct cmd_context *cmd, struct device *dev, dev_t *mpath_devno);
 int dev_is_swap(struct cmd_context *cmd, struct device *dev, uint64_t *signature, int full);
 int dev_is_luks(struct cmd_context *cmd, struct device *dev, uint64_t *signature, int full);
@@ -93,6 +94,7 @@ unsigned long dev_minimum_io_size(struct dev_types *dt, struct device *dev);
 unsigned long dev_optimal_io_size(struct dev_types *dt, struct device *dev);
 unsigned long dev_discard_max_bytes(struct dev_types *dt, struct device *dev);
 unsigned long dev_discard_granularity(struct dev_types *dt, struct device *dev);
+unsigned long dev_write_zeroes_max_bytes(struct dev_types *dt, struct device *dev);
 
 int dev_is_rotational(struct dev_types *dt, struct device *dev);
 
@@ -41,6 +41,20 @@
 #define DEV_MATCHED_USE_ID	0x00080000	/* matched an entry from cmd->use_devices */
 #define DEV_SCAN_FOUND_NOLABEL	0x00100000	/* label_scan read, passed filters, but no lvm label */
 #define DEV_SCAN_NOT_READ	0x00200000	/* label_scan not able to read dev */
+#define DEV_PRIMARY_KNOWN	0x00400000	/* dev->primary is set */
+#define DEV_KEPT_SIZE_FD	0x00800000	/* fd from dev_get_size kept for label scan */
+
+/*
+ * Sysfs queue topology values cached in dev->topology[],
+ * dev->topology_known has bit (1 << DEV_TOPOLOGY_*) set once read.
+ */
+#define DEV_TOPOLOGY_ALIGNMENT_OFFSET		0
+#define DEV_TOPOLOGY_MINIMUM_IO_SIZE		1
+#define DEV_TOPOLOGY_OPTIMAL_IO_SIZE		2
+#define DEV_TOPOLOGY_DISCARD_MAX_BYTES		3
+#define DEV_TOPOLOGY_DISCARD_GRANULARITY	4
+#define DEV_TOPOLOGY_WRITE_ZEROES_MAX_BYTES	5
+#define DEV_TOPOLOGY_COUNT			6
 
 /*
  * Support for external device info.
@@ -126,6 +140,17 @@ struct dev_use_list {
  * All devices in LVM will be represented by one of these.
  * pointer comparisons are valid.
  */
+/*
+ * Preference of a device name computed once by dev-cache,
+ * kept for the first (preferred) name in dev->aliases.
+ */
+struct dev_name_rank {
+	const char *name;	/* the ranked name */
+	int regex;		/* matched devices/preferred_names index, or -1 */
+	short builtin;		/* built-in preference under dev dir, or -1 */
+	short slashes;
+};
+
 struct device {
 	struct dm_list aliases;	/* struct dm_str_list */
 	struct dm_list wwids; /* struct dev_wwid, used for multipath component detection */
@@ -142,19 +167,23 @@ struct device {
 	int bcache_fd;
 	int bcache_di;
 	int part;		/* partition number */
+	dev_t primary;		/* from dev_get_primary_dev, if DEV_PRIMARY_KNOWN */
 	uint32_t flags;
 	uint32_t filtered_flags;
-	unsigned size_seqno;
 	uint64_t size;
 	uint64_t end;
 	struct dev_ext ext;
 	const char *duplicate_prefer_reason;
+	struct dev_name_rank name_rank;
+	unsigned long topology[DEV_TOPOLOGY_COUNT]; /* in sectors, if in topology_known */
+	uint32_t topology_known;
 
 	const char *vgid; /* if device is an LV */
 	const char *lvid; /* if device is an LV */
 
 	char pvid[ID_LEN + 1]; /* if device is a PV */
-	char _padding[7];
+	char _padding[3];
+	unsigned size_seqno;	/* placed here to fill padding */
 };
 
 /*
@@ -224,6 +253,10 @@ int dev_open_readonly_quiet(struct device *dev);
 int dev_close(struct device *dev);
 int dev_close_immediate(struct device *dev);
 
+void dev_keep_size_fds(unsigned max);
+int dev_take_size_fd(struct device *dev);
+void dev_close_size_fd(struct device *dev);
+
 int dev_fd(struct device *dev);
 const char *dev_name(const struct device *dev);
 
@@ -2413,11 +2413,25 @@ static int _match_dm_names(struct cmd_context *cmd, char *idname, struct device
  * When a match is found, set up links among du/id/dev.
  */
 
+/* Copy du->idname in the form device_id_system_read() returns (see below) */
+static void _copy_du_idname(struct dev_use *du, char *du_idname, size_t size)
+{
+	dm_strncpy(du_idname, du->idname, size);
+	if (((du->idtype == DEV_ID_TYPE_SYS_WWID) || (du->idtype == DEV_ID_TYPE_SYS_SERIAL)) &&
+	    strchr(du_idname, '_')) {
+		_remove_leading_underscores(du_idname, size);
+		_remove_trailing_underscores(du_idname, size);
+		if (du->idtype == DEV_ID_TYPE_SYS_WWID && !strncmp(du_idname, "t10", 3) && strstr(du_idname, "__"))
+			_reduce_repeating_underscores(du_idname, size);
+	}
+}
+
 static int _match_du_to_dev(struct cmd_context *cmd, struct dev_use *du, struct device *dev)
 {
 	char du_idname[PATH_MAX];
 	struct dev_id *id;
 	const char *idname;
+	int id_read = 0;
 	int part;
 
 	/*
@@ -2503,58 +2517,57 @@ static int _match_du_to_dev(struct cmd_context *cmd, struct dev_use *du, struct
 	 * string is modified to t10.123_456 so that it will match the value
 	 * returned from device_id_system_read().
 	 */
-	dm_strncpy(du_idname, du->idname, sizeof(du_idname));
-	if (((du->idtype == DEV_ID_TYPE_SYS_WWID) || (du->idtype == DEV_ID_TYPE_SYS_SERIAL)) &&
-	    strchr(du_idname, '_')) {
-		_remove_leading_underscores(du_idname, sizeof(du_idname));
-		_remove_trailing_underscores(du_idname, sizeof(du_idname));
-		if (du->idtype == DEV_ID_TYPE_SYS_WWID && !strncmp(du_idname, "t10", 3) && strstr(du_idname, "__"))
-			_reduce_repeating_underscores(du_idname, sizeof(du_idname));
-	}
+	_copy_du_idname(du, du_idname, sizeof(du_idname));
 
 	/*
 	 * Try to match du with ids that have already been read for the dev
-	 * (and saved on dev->ids to avoid rereading.)
+	 * (and saved on dev->ids to avoid rereading.)  A saved NULL idname
+	 * means the dev has no id of this type.
 	 */
 	dm_list_iterate_items(id, &dev->ids) {
-		if (!id->idname)
+		if (id->idtype != du->idtype)
 			continue;
 
-		if (id->idtype == du->idtype) {
-			if (!strcmp(id->idname, du_idname)) {
-				du->dev = dev;
-				dev->id = id;
-				dev->flags |= DEV_MATCHED_USE_ID;
-				log_debug("Match %s %s to %s",
-					  idtype_to_str(du->idtype), du_idname, dev_name(dev));
-				return 1;
-			}
-			return 0;
+		if (!id->idname) {
+			id_read = 1;
+			continue;
+		}
+
+		if (!strcmp(id->idname, du_idname)) {
+			du->dev = dev;
+			dev->id = id;
+			dev->flags |= DEV_MATCHED_USE_ID;
+			log_debug("Match %s %s to %s",
+				  idtype_to_str(du->idtype), du_idname, dev_name(dev));
+			return 1;
 		}
+		return 0;
 	}
 
-	if (!(id = zalloc(sizeof(struct dev_id))))
-		return_0;
+	if (!id_read) {
+		if (!(id = zalloc(sizeof(struct dev_id))))
+			return_0;
 
-	idname = device_id_system_read(cmd, dev, du->idtype);
+		idname = device_id_system_read(cmd, dev, du->idtype);
 
-	/*
-	 * Save this id for the dev, even if it doesn't exist (NULL)
-	 * or doesn't match du.  This avoids system_read of this idtype
-	 * repeatedly, and the saved id will be found in the loop
-	 * over dev->ids above.
-	 */
-	id->idtype = du->idtype;
-	id->idname = (char *)idname;
-	dm_list_add(&dev->ids, &id->list);
+		/*
+		 * Save this id for the dev, even if it doesn't exist (NULL)
+		 * or doesn't match du.  This avoids system_read of this idtype
+		 * repeatedly, and the saved id will be found in the loop
+		 * over dev->ids above.
+		 */
+		id->idtype = du->idtype;
+		id->idname = (char *)idname;
+		dm_list_add(&dev->ids, &id->list);
 
-	if (idname && !strcmp(idname, du_idname)) {
-		du->dev = dev;
-		dev->id = id;
-		dev->flags |= DEV_MATCHED_USE_ID;
-		log_debug("Match %s %s to %s",
-			  idtype_to_str(du->idtype), idname, dev_name(dev));
-		return 1;
+		if (idname && !strcmp(idname, du_idname)) {
+			du->dev = dev;
+			dev->id = id;
+			dev->flags |= DEV_MATCHED_USE_ID;
+			log_debug("Match %s %s to %s",
+				  idtype_to_str(du->idtype), idname, dev_name(dev));
+			return 1;
+		}
 	}
 
 	/*
@@ -2663,8 +2676,136 @@ void device_ids_match_device_list(struct cmd_context *cmd)
 	}
 }
 
+/*
+ * Index of unmatched devs by "idtype:part:idname", built once per idtype
+ * the first time an entry has to be searched for, so that entries whose
+ * devname has changed are found without comparing every entry against
+ * every dev.  The ids read here are saved in dev->ids just as
+ * _match_du_to_dev() saves them, so no sysfs value is read twice.
+ */
+static char _idname_index_ambiguous;	/* value for idnames shared by devs */
+
+static int _idname_index_key(char *key, size_t size, uint16_t idtype, int part,
+			     const char *idname)
+{
+	return dm_snprintf(key, size, "%u:%d:%s", idtype, part, idname) >= 0;
+}
+
+static const char *_dev_idname_for_type(struct cmd_context *cmd, struct device *dev,
+					uint16_t idtype)
+{
+	struct dev_id *id;
+	int found = 0;
+
+	dm_list_iterate_items(id, &dev->ids) {
+		if (id->idtype != idtype)
+			continue;
+		if (id->idname)
+			return id->idname;
+		found = 1;
+	}
+
+	if (found)
+		return NULL;
+
+	if (!(id = zalloc(sizeof(struct dev_id))))
+		return_NULL;
+
+	id->idtype = idtype;
+	id->idname = device_id_system_read(cmd, dev, idtype);
+	dm_list_add(&dev->ids, &id->list);
+
+	return id->idname;
+}
+
+static int _idname_index_add_type(struct cmd_context *cmd, struct dm_hash_table *index,
+				  uint16_t idtype)
+{
+	char key[PATH_MAX + 32];
+	struct dev_iter *iter;
+	struct device *dev;
+	const char *idname;
+	int part;
+
+	if (!(iter = dev_iter_create(NULL, 0)))
+		return_0;
+
+	while ((dev = dev_iter_get(cmd, iter))) {
+		if (dev->flags & DEV_MATCHED_USE_ID)
+			continue;
+		if (!_idtype_compatible_with_major_number(cmd, idtype, MAJOR(dev->dev)))
+			continue;
+		if (!dev_get_partition_number(dev, &part))
+			continue;
+		if (!(idname = _dev_idname_for_type(cmd, dev, idtype)))
+			continue;
+		if (!_idname_index_key(key, sizeof(key), idtype, part, idname))
+			continue;
+		if (dm_hash_lookup(index, key)) {
+			if (!dm_hash_insert(index, key, &_idname_index_ambiguous))
+				goto_bad;
+		} else if (!dm_hash_insert(index, key, dev))
+			goto_bad;
+	}
+
+	dev_iter_destroy(iter);
+	return 1;
+bad:
+	dev_iter_destroy(iter);
+	return 0;
+}
+
+/*
+ * Returns 1 if the index settled du: it is matched, or no unmatched dev
+ * can have its idname.  Returns 0 if all devs still need to be checked.
+ */
+static int _match_du_from_index(struct cmd_context *cmd, struct dm_hash_table **index,
+				unsigned *indexed_types, struct dev_use *du)
+{
+	char du_idname[PATH_MAX];
+	char key[PATH_MAX + 32];
+	struct device *dev;
+
+	if (!du->idname || !du->idtype)
+		return 1; /* cannot match any dev */
+
+	/* vpd_pg83 wwids can match a sys_wwid entry, devs must be checked */
+	if (du->idtype == DEV_ID_TYPE_SYS_WWID)
+		return 0;
+
+	if (du->idtype >= 8 * sizeof(*indexed_types))
+		return 0;
+
+	if (!*index && !(*index = dm_hash_create(1024)))
+		return_0;
+
+	if (!(*indexed_types & (1U << du->idtype))) {
+		if (!_idname_index_add_type(cmd, *index, du->idtype))
+			return_0;
+		*indexed_types |= (1U << du->idtype);
+	}
+
+	_copy_du_idname(du, du_idname, sizeof(du_idname));
+
+	if (!_idname_index_key(key, sizeof(key), du->idtype, du->part, du_idname))
+		return 0;
+
+	if (!(dev = dm_hash_lookup(*index, key)))
+		return 1; /* no dev has this idname */
+
+	if (dev == (struct device *) &_idname_index_ambiguous)
+		return 0;
+
+	if (dev->flags & DEV_MATCHED_USE_ID)
+		return 1; /* the only dev with this idname is taken */
+
+	return _match_du_to_dev(cmd, du, dev);
+}
+
 void device_ids_match(struct cmd_context *cmd)
 {
+	struct dm_hash_table *index = NULL;
+	unsigned indexed_types = 0;
 	struct dev_iter *iter;
 	struct dev_use *du;
 	struct device *dev;
@@ -2728,7 +2869,9 @@ void device_ids_match(struct cmd_context *cmd)
 		}
 
 		/*
-		 * Iterate through all devs and try to match du.
+		 * Look up the idname in the index of unmatched devs.
+		 * When that is not conclusive, iterate through all devs and
+		 * try to match du.
 		 *
 		 * If a match is made here it means the du->devname is wrong,
 		 * so the devices file should be updated with a new devname.
@@ -2736,6 +2879,17 @@ void device_ids_match(struct cmd_context *cmd)
 		 * NULL filter is used because we are just setting up the
 		 * the du/dev pairs in preparation for using the filters.
 		 */
+		if (_match_du_from_index(cmd, &index, &indexed_types, du)) {
+			if (du->dev)
+				log_debug("Match %s %s PVID %s: done %s (index)",
+					  idtype_to_str(du->idtype), du->idname ?: ".", du->pvid ?: ".",
+					  dev_name(du->dev));
+			else
+				log_debug("Match %s %s PVID %s: no device matches",
+					  idtype_to_str(du->idtype), du->idname ?: ".", du->pvid ?: ".");
+			continue;
+		}
+
 		found = 0;
 
 		if (!(iter = dev_iter_create(NULL, 0)))
@@ -2759,6 +2913,9 @@ void device_ids_match(struct cmd_context *cmd)
 				  idtype_to_str(du->idtype), du->idname ?: ".", du->pvid ?: ".");
 	}
 
+	if (index)
+		dm_hash_destroy(index);
+
 	/*
 	 * Next match entries with IDTYPE=devname, which is only
 	 * based on matching devname, so somewhat likely to be wrong
@@ -23,6 +23,7 @@
 #include <dirent.h>
 #include <mntent.h>
 #include <sys/ioctl.h>
+#include <sys/vfs.h>
 
 static const char *_lvresize_fs_helper_path;
 
@@ -574,3 +575,135 @@ int fs_extend_script(struct cmd_context *cmd, struct logical_volume *lv, struct
 
 	return 1;
 }
+
+/*
+ * Growing a mounted ext4 or xfs needs nothing but the resize ioctl
+ * which resize2fs and xfs_growfs issue, so do that directly instead
+ * of running the helper.  Everything else (unmount, fsck, crypt, or
+ * an ioctl the kernel rejects) is left to fs_extend_script().
+ * The definitions match e2fsprogs and xfsprogs headers.
+ */
+#ifndef EXT4_IOC_RESIZE_FS
+#define EXT4_IOC_RESIZE_FS		_IOW('f', 16, uint64_t)
+#endif
+
+struct xfs_fsop_geom_v1 {
+	uint32_t blocksize;
+	uint32_t rtextsize;
+	uint32_t agblocks;
+	uint32_t agcount;
+	uint32_t logblocks;
+	uint32_t sectsize;
+	uint32_t inodesize;
+	uint32_t imaxpct;
+	uint64_t datablocks;
+	uint64_t rtblocks;
+	uint64_t rtextents;
+	uint64_t logstart;
+	unsigned char uuid[16];
+	uint32_t sunit;
+	uint32_t swidth;
+	int32_t version;
+	uint32_t flags;
+	uint32_t logsectsize;
+	uint32_t rtsectsize;
+	uint32_t dirblocksize;
+};
+
+struct xfs_growfs_data {
+	uint64_t newblocks;
+	uint32_t imaxpct;
+};
+
+#ifndef XFS_IOC_FSGEOMETRY_V1
+#define XFS_IOC_FSGEOMETRY_V1		_IOR('X', 100, struct xfs_fsop_geom_v1)
+#endif
+#ifndef XFS_IOC_FSGROWFSDATA
+#define XFS_IOC_FSGROWFSDATA		_IOW('X', 110, struct xfs_growfs_data)
+#endif
+
+static int _ext4_grow(int fd, const char *mount_dir, uint64_t newsize_bytes)
+{
+	struct statfs sfs;
+	uint64_t newblocks;
+
+	if (fstatfs(fd, &sfs) < 0) {
+		log_sys_debug("fstatfs", mount_dir);
+		return 0;
+	}
+
+	newblocks = newsize_bytes / sfs.f_bsize;
+
+	if (ioctl(fd, EXT4_IOC_RESIZE_FS, &newblocks) < 0) {
+		log_sys_debug("ioctl EXT4_IOC_RESIZE_FS", mount_dir);
+		return 0;
+	}
+
+	return 1;
+}
+
+static int _xfs_grow(int fd, const char *mount_dir, uint64_t newsize_bytes)
+{
+	struct xfs_fsop_geom_v1 geo;
+	struct xfs_growfs_data grow;
+
+	if (ioctl(fd, XFS_IOC_FSGEOMETRY_V1, &geo) < 0) {
+		log_sys_debug("ioctl XFS_IOC_FSGEOMETRY", mount_dir);
+		return 0;
+	}
+
+	if (!geo.blocksize)
+		return_0;
+
+	grow.newblocks = newsize_bytes / geo.blocksize;
+	grow.imaxpct = geo.imaxpct;
+
+	if (grow.newblocks <= geo.datablocks)
+		return 1;
+
+	if (ioctl(fd, XFS_IOC_FSGROWFSDATA, &grow) < 0) {
+		log_sys_debug("ioctl XFS_IOC_FSGROWFSDATA", mount_dir);
+		return 0;
+	}
+
+	return 1;
+}
+
+int fs_extend_online(struct cmd_context *cmd, struct logical_volume *lv, struct fs_info *fsi,
+		     uint64_t newsize_bytes_fs)
+{
+	int fd, r;
+
+	if (!fsi->mounted || fsi->needs_unmount || fsi->needs_mount ||
+	    fsi->needs_fsck || fsi->needs_crypt)
+		return 0;
+
+	if (strcmp(fsi->fstype, "ext4") && strcmp(fsi->fstype, "xfs"))
+		return 0;
+
+	if ((fd = open(fsi->mount_dir, O_RDONLY | O_DIRECTORY)) < 0) {
+		log_sys_debug("open", fsi->mount_dir);
+		return 0;
+	}
+
+	log_print_unless_silent("Extending file system %s to %s (%llu bytes) on %s...",
+				fsi->fstype, display_size(cmd, newsize_bytes_fs/512),
+				(unsigned long long)newsize_bytes_fs, display_lvname(lv));
+
+	if (!strcmp(fsi->fstype, "ext4"))
+		r = _ext4_grow(fd, fsi->mount_dir, newsize_bytes_fs);
+	else
+		r = _xfs_grow(fd, fsi->mount_dir, newsize_bytes_fs);
+
+	if (close(fd))
+		log_sys_debug("close", fsi->mount_dir);
+
+	if (!r) {
+		log_debug("Resize ioctl failed for %s, using lvresize_fs_helper.", fsi->mount_dir);
+		return 0;
+	}
+
+	log_print_unless_silent("Extended file system %s on %s.", fsi->fstype, display_lvname(lv));
+
+	return 1;
+}
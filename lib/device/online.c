@@ -380,6 +380,45 @@ int online_pvid_file_exists(const char *pvid)
 	return 0;
 }
 
+/*
+ * Names of all pvid online files, so that the PVs of a large VG
+ * can be checked with one read of the directory instead of a stat
+ * of each file.
+ */
+struct dm_hash_table *online_pvids_hash(void)
+{
+	struct dm_hash_table *online_pvids;
+	DIR *dir;
+	struct dirent *de;
+
+	if (!(dir = opendir(PVS_ONLINE_DIR)))
+		return NULL;
+
+	if (!(online_pvids = dm_hash_create(1024))) {
+		(void) closedir(dir);
+		return NULL;
+	}
+
+	while ((de = readdir(dir))) {
+		if (de->d_name[0] == '.')
+			continue;
+
+		if (strlen(de->d_name) != ID_LEN)
+			continue;
+
+		if (!dm_hash_insert(online_pvids, de->d_name, (void *)1)) {
+			dm_hash_destroy(online_pvids);
+			online_pvids = NULL;
+			break;
+		}
+	}
+
+	if (closedir(dir))
+		log_sys_debug("closedir", PVS_ONLINE_DIR);
+
+	return online_pvids;
+}
+
 int get_pvs_lookup(struct dm_list *pvs_online, const char *vgname)
 {
 	char lookup_path[PATH_MAX] = { 0 };
@@ -42,6 +42,14 @@ struct pfilter {
  * times.  A device should be checked against the filter once, and then not
  * need to be checked again.  With scanning now controlled, we could probably
  * do this.
+ *
+ * Results are only kept in memory for one command.  Saving them on disk
+ * (the old /etc/lvm/cache/.cache) was dropped because a cached result can
+ * be stale while devno and name are unchanged (a new signature, md or
+ * multipath component), and revalidating that costs the same sysfs and
+ * header reads the filters do.  Skipping work across commands is left to
+ * hints (/run/lvm/hints), which are invalidated by a hash of the filter
+ * config and device list, so only the PVs listed there are read.
  */
 
 static int _good_device;
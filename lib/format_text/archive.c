@@ -193,7 +193,12 @@ static void _remove_expired(const char *dir, const char *vgname,
 	/* Convert retain_days into the time after which we must retain */
 	retain_time = time(NULL) - (time_t) retain_days *SECS_PER_DAY;
 
-	/* Assume list is ordered newest first (by index) */
+	/*
+	 * Assume list is ordered newest first (by index).  Archives are
+	 * written in index order, so once one is inside the retention
+	 * period all newer ones are too and need not be stat'ed; their
+	 * size, for the hint below, is taken to be that of the first one.
+	 */
 	dm_list_iterate_back_items(bf, archives) {
 		if (dm_snprintf(path, sizeof(path), "%s/%s", dir, bf->name) < 0)
 			continue;
@@ -204,9 +209,12 @@ static void _remove_expired(const char *dir, const char *vgname,
 			continue;
 		}
 
+		if (sb.st_mtime > retain_time) {
+			sum += (uint64_t) sb.st_size * archives_size;
+			break;
+		}
+
 		sum += sb.st_size;
-		if (sb.st_mtime > retain_time)
-			continue;
 
 		log_very_verbose("Expiring archive %s", path);
 		if (unlink(path) && (errno != ENOENT))
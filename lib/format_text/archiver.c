@@ -16,6 +16,7 @@
 #include "lib/misc/lib.h"
 #include "lib/format_text/archiver.h"
 #include "lib/format_text/format-text.h"
+#include "lib/format_text/import-export.h"
 #include "lib/misc/lvm-string.h"
 #include "lib/misc/lvm-signal.h"
 #include "lib/cache/lvmcache.h"
@@ -284,6 +285,16 @@ int backup(struct volume_group *vg)
 	if (is_orphan_vg(vg->name))
 		return 1;
 
+	/*
+	 * A committed VG is backed up once when it is unlocked
+	 * (vg_backup_if_needed), so several commits in one command
+	 * do not each rewrite the backup file.
+	 */
+	if (vg->needs_backup) {
+		log_debug("Deferring backup of volume group %s to unlock.", vg->name);
+		return 1;
+	}
+
 	return backup_locally(vg);
 }
 
@@ -487,12 +498,18 @@ int backup_restore_vg(struct cmd_context *cmd, struct volume_group *vg,
 	}
 
 	if (do_pvcreate) {
+		/*
+		 * Wiping the PVs needs no ordering among them, so the blocks
+		 * of all of them are written at once when the batch ends.
+		 */
+		dev_write_batch_begin();
 		dm_list_iterate_items(pvl, &vg->pv_write_list) {
 			struct device *dev = pv_dev(pvl->pv);
 			const char *pv_name = dev_name(dev);
 
 			if (!label_remove(dev)) {
 				log_error("Failed to wipe existing label on %s", pv_name);
+				(void) dev_write_batch_end();
 				return 0;
 			}
 
@@ -500,9 +517,14 @@ int backup_restore_vg(struct cmd_context *cmd, struct volume_group *vg,
 
 			if (!dev_write_zeros(dev, 0, 2048)) {
 				log_error("%s not wiped: aborting", pv_name);
+				(void) dev_write_batch_end();
 				return 0;
 			}
 		}
+		if (!dev_write_batch_end()) {
+			log_error("Failed to wipe physical volumes of VG %s.", vg->name);
+			return 0;
+		}
 	}
 
 	if (!vg_write(vg))
@@ -622,6 +644,7 @@ int backup_to_file(const char *file, const char *desc, struct volume_group *vg)
 void check_current_backup(struct volume_group *vg)
 {
 	char path[PATH_MAX];
+	struct lvmcache_vgsummary vgsummary = { 0 };
 	struct volume_group *vg_backup;
 	int old_suppress;
 
@@ -633,7 +656,8 @@ void check_current_backup(struct volume_group *vg)
 		return;
 	}
 
-	if (vg_is_exported(vg))
+	/* Nothing to compare or back up without the whole VG. */
+	if (vg_is_exported(vg) || vg->summary_only)
 		return;
 
 	if (dm_snprintf(path, sizeof(path), "%s/%s",
@@ -644,14 +668,19 @@ void check_current_backup(struct volume_group *vg)
 	}
 
 	old_suppress = log_suppress(1);
-	/* Up-to-date backup exists? */
-	if ((vg_backup = backup_read_vg(vg->cmd, vg->name, path)) &&
-	    (vg->seqno == vg_backup->seqno) &&
-	    (id_equal(&vg->id, &vg_backup->id))) {
+	/*
+	 * Up-to-date backup exists?  Only its summary is needed for that,
+	 * importing the whole VG is left for when the backup gets archived.
+	 */
+	dm_list_init(&vgsummary.pvsummaries);
+	if (text_read_metadata_summary_file(vg->cmd->fmt_backup, path, &vgsummary) &&
+	    !strcmp(vg->name, vgsummary.vgname) &&
+	    (vg->seqno == vgsummary.seqno) &&
+	    !memcmp(&vg->id, vgsummary.vgid, ID_LEN)) {
 		log_suppress(old_suppress);
-		release_vg(vg_backup);
 		return;
 	}
+	vg_backup = backup_read_vg(vg->cmd, vg->name, path);
 	log_suppress(old_suppress);
 
 	if (vg_backup) {
@@ -20,6 +20,7 @@
 #include "lib/metadata/metadata.h"
 #include "lib/display/display.h"
 #include "lib/misc/lvm-string.h"
+#include "lib/misc/crc.h"
 #include "lib/metadata/segtype.h"
 #include "lib/format_text/text_export.h"
 #include "lib/commands/toolcontext.h"
@@ -62,6 +63,8 @@ struct formatter {
 			char *start;
 			uint32_t size;
 			uint32_t used;
+			int checksum;	/* update crc as text is added */
+			uint32_t crc;
 		} buf;
 	} data;
 
@@ -125,18 +128,30 @@ static int _extend_buffer(struct formatter *f)
 
 	log_debug_metadata("Doubling metadata output buffer to " FMTu32,
 			   f->data.buf.size * 2);
+	/* Space after the text is zeroed once in text_vg_export_raw. */
 	if (!(newbuf = realloc(f->data.buf.start,
 				   f->data.buf.size * 2))) {
 		log_error("Buffer reallocation failed.");
 		return 0;
 	}
-	memset(newbuf + f->data.buf.size, 0, f->data.buf.size);
 	f->data.buf.start = newbuf;
 	f->data.buf.size *= 2;
 
 	return 1;
 }
 
+/*
+ * Checksum text as it is appended, while it is still in cache,
+ * instead of reading the whole buffer again after export.
+ */
+static void _update_checksum_raw(struct formatter *f, uint32_t len)
+{
+	if (f->data.buf.checksum)
+		f->data.buf.crc = calc_crc(f->data.buf.crc,
+					   (const uint8_t *)(f->data.buf.start + f->data.buf.used),
+					   len);
+}
+
 static int _nl_raw(struct formatter *f)
 {
 	/* If metadata doesn't fit, extend buffer */
@@ -145,6 +160,7 @@ static int _nl_raw(struct formatter *f)
 		return_0;
 
 	*(f->data.buf.start + f->data.buf.used) = '\n';
+	_update_checksum_raw(f, 1);
 	f->data.buf.used += 1;
 
 	*(f->data.buf.start + f->data.buf.used) = '\0';
@@ -152,6 +168,16 @@ static int _nl_raw(struct formatter *f)
 	return 1;
 }
 
+/*
+ * Blank lines only make backup files easier to read.  Metadata areas
+ * go without them, so every commit writes and every scan reads and
+ * checksums a little less.
+ */
+static int _nl_none(struct formatter *f __attribute__((unused)))
+{
+	return 1;
+}
+
 #define COMMENT_TAB 6
 __attribute__((format(printf, 3, 0)))
 static int _out_with_comment_file(struct formatter *f, const char *comment,
@@ -209,9 +235,11 @@ static int _out_with_comment_raw(struct formatter *f,
 		return -1; /* Retry */
 	}
 
+	_update_checksum_raw(f, n);
 	f->data.buf.used += n;
 
-	outnl(f);
+	if (!_nl_raw(f))
+		return_0;
 
 	return 1;
 }
@@ -823,14 +851,20 @@ static int _print_lvs(struct formatter *f, struct volume_group *vg)
 	return 1;
 }
 
-static int _alloc_printed_indirect_descendants(struct dm_list *indirect_glvs, char **buffer)
+/*
+ * Formats the live descendants into *buffer, which is reused for all
+ * historical LVs of the VG and only grows when a list does not fit.
+ * Leaves *printed unset when there is no live descendant.
+ */
+static int _print_indirect_descendants(struct dm_list *indirect_glvs, char **buffer,
+				       size_t *buffer_size, int *printed)
 {
 	struct glv_list *user_glvl;
 	size_t buf_size = 0;
 	int first = 1;
 	char *buf;
 
-	*buffer = NULL;
+	*printed = 0;
 
 	dm_list_iterate_items(user_glvl, indirect_glvs) {
 		if (user_glvl->glv->is_historical)
@@ -845,38 +879,39 @@ static int _alloc_printed_indirect_descendants(struct dm_list *indirect_glvs, ch
 	/* '[' + ']' + '\0' */
 	buf_size += 3;
 
-	if (!(*buffer = malloc(buf_size))) {
-		log_error("Could not allocate memory for ancestor list buffer.");
-		return 0;
+	if (buf_size > *buffer_size) {
+		free(*buffer);
+		*buffer_size = 0;
+		if (!(*buffer = malloc(buf_size))) {
+			log_error("Could not allocate memory for ancestor list buffer.");
+			return 0;
+		}
+		*buffer_size = buf_size;
 	}
 	buf = *buffer;
 
 	if (!emit_to_buffer(&buf, &buf_size, "["))
-		goto_bad;
+		return_0;
 
 	dm_list_iterate_items(user_glvl, indirect_glvs) {
 		if (user_glvl->glv->is_historical)
 			continue;
 		if (!first) {
 			if (!emit_to_buffer(&buf, &buf_size, ", "))
-				goto_bad;
+				return_0;
 		} else
 			first = 0;
 
 		if (!emit_to_buffer(&buf, &buf_size, "\"%s\"", user_glvl->glv->live->name))
-			goto_bad;
+			return_0;
 	}
 
 	if (!emit_to_buffer(&buf, &buf_size, "]"))
-		goto_bad;
+		return_0;
+
+	*printed = 1;
 
 	return 1;
-bad:
-	if (*buffer) {
-		free(*buffer);
-		*buffer = NULL;
-	}
-	return 0;
 }
 
 static int _print_historical_lv_with_descendants(struct formatter *f, struct historical_logical_volume *hlv,
@@ -915,22 +950,23 @@ static int _print_historical_lv_with_descendants(struct formatter *f, struct his
 	return 1;
 }
 
-static int _print_historical_lv(struct formatter *f, struct historical_logical_volume *hlv)
+static int _print_historical_lv(struct formatter *f, struct historical_logical_volume *hlv,
+				char **descendants_buffer, size_t *descendants_buffer_size)
 {
-	char *descendants_buffer = NULL;
-	int r = 0;
-
-	if (_alloc_printed_indirect_descendants(&hlv->indirect_glvs, &descendants_buffer))
-		r = _print_historical_lv_with_descendants(f, hlv, descendants_buffer);
+	int printed;
 
-	free(descendants_buffer);
+	if (!_print_indirect_descendants(&hlv->indirect_glvs, descendants_buffer,
+					 descendants_buffer_size, &printed))
+		return_0;
 
-	return r;
+	return _print_historical_lv_with_descendants(f, hlv, printed ? *descendants_buffer : NULL);
 }
 
 static int _print_historical_lvs(struct formatter *f, struct volume_group *vg)
 {
 	struct glv_list *glvl;
+	char *descendants_buffer = NULL;
+	size_t descendants_buffer_size = 0;
 
 	if (dm_list_empty(&vg->historical_lvs))
 		return 1;
@@ -939,10 +975,15 @@ static int _print_historical_lvs(struct formatter *f, struct volume_group *vg)
 	_inc_indent(f);
 
 	dm_list_iterate_items(glvl, &vg->historical_lvs) {
-		if (!_print_historical_lv(f, glvl->glv->historical))
+		if (!_print_historical_lv(f, glvl->glv->historical,
+					  &descendants_buffer, &descendants_buffer_size)) {
+			free(descendants_buffer);
 			return_0;
+		}
 	}
 
+	free(descendants_buffer);
+
 	_dec_indent(f);
 	outf(f, "}");
 
@@ -1061,24 +1102,32 @@ int text_vg_export_file(struct volume_group *vg, const char *desc, FILE *fp)
 	return r;
 }
 
-/* Returns amount of buffer used incl. terminating NUL */
-size_t text_vg_export_raw(struct volume_group *vg, const char *desc, char **buf, uint32_t *buf_size)
+/*
+ * Returns amount of buffer used incl. terminating NUL.
+ * The rest of the buffer up to buf_size is zeroed.
+ * If checksum is set, it is the crc of the returned amount of buffer.
+ */
+size_t text_vg_export_raw(struct volume_group *vg, const char *desc, char **buf,
+			  uint32_t *buf_size, uint32_t *checksum)
 {
 	size_t r;
 	struct formatter f = {
 		.indent = 0,
 		.header = 0,
 		.out_with_comment = &_out_with_comment_raw,
-		.nl = &_nl_raw,
+		.nl = &_nl_none,
 		.data.buf.size = vg->buffer_size_hint + 16384,	/* Initial metadata limit */
+		.data.buf.checksum = checksum ? 1 : 0,
+		.data.buf.crc = INITIAL_CRC,
 	};
 
 	_init();
 
-	if (!(f.data.buf.start = zalloc(f.data.buf.size))) {
+	if (!(f.data.buf.start = malloc(f.data.buf.size))) {
 		log_error("text_export buffer allocation failed");
 		return 0;
 	}
+	f.data.buf.start[0] = '\0';
 
 	if (!_text_vg_export(&f, vg, desc)) {
 		free(f.data.buf.start);
@@ -1086,17 +1135,26 @@ size_t text_vg_export_raw(struct volume_group *vg, const char *desc, char **buf,
 	}
 
 	r = f.data.buf.used + 1;
+	memset(f.data.buf.start + f.data.buf.used, 0, f.data.buf.size - f.data.buf.used);
 	*buf = f.data.buf.start;
 
 	if (buf_size)
 		*buf_size = f.data.buf.size;
 
+	if (checksum) {
+		_update_checksum_raw(&f, 1); /* terminating NUL */
+		*checksum = f.data.buf.crc;
+	}
+
+	/* Start with a large enough buffer when this VG is exported again. */
+	vg->buffer_size_hint = f.data.buf.used;
+
 	return r;
 }
 
 static size_t _export_vg_to_buffer(struct volume_group *vg, char **buf)
 {
-	return text_vg_export_raw(vg, "", buf, NULL);
+	return text_vg_export_raw(vg, "", buf, NULL, NULL);
 }
 
 struct dm_config_tree *export_vg_to_config_tree(struct volume_group *vg)
@@ -28,6 +28,7 @@
 #include "lib/mm/xlate.h"
 #include "lib/label/label.h"
 #include "lib/cache/lvmcache.h"
+#include "lib/label/scan_cache.h"
 #include "libdaemon/client/config-util.h"
 
 #include <unistd.h>
@@ -615,7 +616,7 @@ static int _vg_write_raw(struct format_instance *fid, struct volume_group *vg,
 	 * the metadata text is saved in write_buf and subsequent
 	 * mdas use that.
 	 *
-	 * write_buf_size is increased in 64K increments, so will generally
+	 * write_buf_size is doubled as the text grows, so will generally
 	 * be larger than new_size.  The extra space in write_buf (after
 	 * new_size) is zeroed.  More than new_size can be written from
 	 * write_buf to zero data on disk following the new text metadata,
@@ -632,7 +633,7 @@ static int _vg_write_raw(struct format_instance *fid, struct volume_group *vg,
 		else
 			(void) dm_snprintf(desc, sizeof(desc), "Write[%u] from %s.", vg->write_count, vg->cmd->cmd_line);
 
-		new_size = text_vg_export_raw(vg, desc, &write_buf, &write_buf_size);
+		new_size = text_vg_export_raw(vg, desc, &write_buf, &write_buf_size, &checksum);
 		if (!new_size || !write_buf) {
 			log_error("VG %s metadata writing failed", vg->name);
 			goto out;
@@ -657,7 +658,7 @@ static int _vg_write_raw(struct format_instance *fid, struct volume_group *vg,
 		if (!vg->vg_precommitted)
 			goto_out;
 
-		fidtc->checksum = checksum = calc_crc(INITIAL_CRC, (uint8_t *)write_buf, new_size);
+		fidtc->checksum = checksum;
 	}
 
 	log_debug_metadata("VG %s seqno %u metadata write to %s mda_start %llu mda_size %llu mda_last %llu",
@@ -1456,6 +1457,7 @@ int read_metadata_location_summary(const struct format_type *fmt,
 	struct raw_locn *rlocn;
 	uint32_t wrap = 0;
 	uint64_t max_size;
+	int checksum_only;
 
 	if (!mdah) {
 		log_error(INTERNAL_ERROR "read_metadata_location_summary called with NULL pointer for mda_header");
@@ -1552,11 +1554,19 @@ int read_metadata_location_summary(const struct format_type *fmt,
 		goto out;
 	}
 
+	if (scan_cache_lookup(fmt->cmd, vgsummary)) {
+		log_debug("Skipping read of VG metadata found in scan cache with matching mda checksum on %s.",
+			  dev_name(dev_area->dev));
+		goto out;
+	}
+
+	checksum_only = vgsummary->vgname ? 1 : 0;
+
 	if (!text_read_metadata_summary(fmt, dev_area->dev, MDA_CONTENT_REASON(primary_mda),
 				(off_t) (dev_area->start + rlocn->offset),
 				(uint32_t) (rlocn->size - wrap),
 				(off_t) (dev_area->start + MDA_HEADER_SIZE),
-				wrap, calc_crc, vgsummary->vgname ? 1 : 0,
+				wrap, calc_crc, checksum_only,
 				vgsummary)) {
 		log_warn("WARNING: metadata on %s at %llu has invalid summary for VG.",
 			  dev_name(dev_area->dev),
@@ -1571,6 +1581,9 @@ int read_metadata_location_summary(const struct format_type *fmt,
 			  (unsigned long long)(dev_area->start + rlocn->offset));
 		return 0;
 	}
+
+	if (!checksum_only)
+		scan_cache_add(fmt->cmd, vgsummary);
 out:
 	log_debug_metadata("Found metadata summary on %s at %llu size %llu for VG %s",
 			   dev_name(dev_area->dev),
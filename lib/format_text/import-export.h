@@ -70,7 +70,8 @@ int print_segtype_lvflags(char *buffer, size_t size, uint64_t status);
 int read_segtype_lvflags(uint64_t *status, char *segtype_str);
 
 int text_vg_export_file(struct volume_group *vg, const char *desc, FILE *fp);
-size_t text_vg_export_raw(struct volume_group *vg, const char *desc, char **buf, uint32_t *alloc_size);
+size_t text_vg_export_raw(struct volume_group *vg, const char *desc, char **buf,
+			  uint32_t *alloc_size, uint32_t *checksum);
 struct volume_group *text_read_metadata_file(struct format_instance *fid,
 					 const char *file,
 					 time_t *when, char **desc);
@@ -92,5 +93,8 @@ int text_read_metadata_summary(const struct format_type *fmt,
 		       checksum_fn_t checksum_fn,
 		       int checksum_only,
 		       struct lvmcache_vgsummary *vgsummary);
+int text_read_metadata_summary_file(const struct format_type *fmt,
+				    const char *file,
+				    struct lvmcache_vgsummary *vgsummary);
 
 #endif
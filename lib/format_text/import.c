@@ -67,7 +67,7 @@ int text_read_metadata_summary(const struct format_type *fmt,
 			goto out;
 		}
 	} else {
-		if (!config_file_read_from_file(cft)) {
+		if (!config_file_read_from_file(cft, 1)) {
 			log_warn("WARNING: invalid metadata text from file.");
 			goto out;
 		}
@@ -94,6 +94,47 @@ int text_read_metadata_summary(const struct format_type *fmt,
 		break;
 	}
 
+	/* vg_read can import the VG from this tree without parsing again */
+	if (r && dev && checksum_fn) {
+		lvmcache_save_metadata_cft(cft, vgsummary->mda_checksum, size + size2);
+		return r;
+	}
+
+      out:
+	config_destroy(cft);
+	return r;
+}
+
+/*
+ * Find out vgname, vgid and seqno stored in a metadata backup file.
+ */
+int text_read_metadata_summary_file(const struct format_type *fmt,
+				    const char *file,
+				    struct lvmcache_vgsummary *vgsummary)
+{
+	struct dm_config_tree *cft;
+	const struct text_vg_version_ops **vsn;
+	int r = 0;
+
+	_init_text_import();
+
+	if (!(cft = config_open(CONFIG_FILE_SPECIAL, file, 0)))
+		return_0;
+
+	if (!config_file_read_from_file(cft, 1))
+		goto_out;
+
+	for (vsn = &_text_vsn_list[0]; *vsn; vsn++) {
+		if (!(*vsn)->check_version(cft))
+			continue;
+
+		if (!(*vsn)->read_vgsummary(fmt, cft, vgsummary))
+			goto_out;
+
+		r = 1;
+		break;
+	}
+
       out:
 	config_destroy(cft);
 	return r;
@@ -116,7 +157,7 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 				       time_t *when, char **desc)
 {
 	struct volume_group *vg = NULL;
-	struct dm_config_tree *cft;
+	struct dm_config_tree *cft, *saved_cft = NULL;
 	const struct text_vg_version_ops **vsn;
 	int skip_parse;
 
@@ -128,6 +169,10 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 	 * we read from this device matches the size/checksum saved in
 	 * the mda_header/rlocn struct on this device, and matches the
 	 * size/checksum from the previous device.
+	 *
+	 * The text is still read and checksummed on every device, since
+	 * that is what tells a good copy from a damaged one; with the
+	 * table driven crc that costs far less than the parse it avoids.
 	 */
 	if (vg_fmtdata && !*vg_fmtdata &&
 	    !(*vg_fmtdata = dm_pool_zalloc(fid->mem, sizeof(**vg_fmtdata)))) {
@@ -149,6 +194,10 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 		     ((*vg_fmtdata)->cached_mda_size == (size + size2));
 
 
+	/* Was the same metadata parsed by an earlier read of the VG? */
+	if (dev && !skip_parse && checksum_fn)
+		saved_cft = lvmcache_take_metadata_cft(checksum, size + size2);
+
 	if (dev) {
 		log_debug_metadata("Reading metadata from %s at %llu size %d (+%d)",
 				   dev_name(dev), (unsigned long long)offset,
@@ -156,12 +205,14 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 
 		if (!config_file_read_fd(cft, dev, MDA_CONTENT_REASON(primary_mda), offset, size,
 					 offset2, size2, checksum_fn, checksum,
-					 skip_parse, 1)) {
+					 skip_parse || saved_cft, 1)) {
 			log_warn("WARNING: couldn't read volume group metadata from %s.", dev_name(dev));
+			if (saved_cft)
+				config_destroy(saved_cft);
 			goto out;
 		}
 	} else {
-		if (!config_file_read_from_file(cft)) {
+		if (!config_file_read_from_file(cft, 1)) {
 			log_warn("WARNING: couldn't read volume group metadata from file.");
 			goto out;
 		}
@@ -174,6 +225,12 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 		goto out;
 	}
 
+	if (saved_cft) {
+		log_debug_metadata("Reusing metadata parsed earlier for %s", dev_name(dev));
+		config_destroy(cft);
+		cft = saved_cft;
+	}
+
 	/*
 	 * Find a set of version functions that can read this file
 	 */
@@ -186,6 +243,10 @@ struct volume_group *text_read_metadata(struct format_instance *fid,
 
 		(*vsn)->read_desc(vg->vgmem, cft, when, desc);
 		vg->committed_cft = cft; /* Reuse CFT for recreation of committed VG */
+		if (dev && checksum_fn) {
+			vg->committed_cft_checksum = checksum;
+			vg->committed_cft_size = size + size2;
+		}
 		vg->buffer_size_hint = size + size2;
 		cft = NULL;
 		break;
@@ -825,6 +825,7 @@ static int _read_historical_lvnames(struct cmd_context *cmd,
 
 	glvl->glv = glv;
 	dm_list_add(&vg->historical_lvs, &glvl->list);
+	vg_historical_lv_index_add(vg, glvl);
 
 	return 1;
 bad:
@@ -19,6 +19,7 @@
 #include "layout.h"
 #include "lib/label/label.h"
 #include "lib/mm/xlate.h"
+#include "lib/misc/crc.h"
 #include "lib/cache/lvmcache.h"
 
 #include <sys/stat.h>
@@ -398,6 +399,73 @@ static int _read_mda_header_and_metadata(const struct format_type *fmt,
 	return 1;
 }
 
+/*
+ * Used by label_scan before _text_read() to find where the metadata text
+ * of the first mda is, when its mda_header is within the first block.
+ * Nothing is trusted that the checksums do not cover.
+ */
+static int _text_peek_metadata(struct labeller *l __attribute__((unused)),
+			       void *label_buf, const char *block_buf, size_t block_size,
+			       struct label_metadata_locn *locn)
+{
+	struct label_header *lh = (struct label_header *) label_buf;
+	const char *label_end = (const char *) label_buf + LABEL_SIZE;
+	struct pv_header *pvhdr;
+	struct disk_locn *dlocn_xl;
+	struct mda_header *mdah;
+	struct raw_locn *rlocn;
+	uint64_t mda_start, mda_size, offset, size;
+
+	if (xlate32(lh->offset_xl) >= LABEL_SIZE)
+		return 0;
+
+	pvhdr = (struct pv_header *) ((char *) label_buf + xlate32(lh->offset_xl));
+
+	/* Data areas are followed by the metadata areas */
+	dlocn_xl = pvhdr->disk_areas_xl;
+	while (((const char *) (dlocn_xl + 1) <= label_end) && xlate64(dlocn_xl->offset))
+		dlocn_xl++;
+	dlocn_xl++;
+
+	if ((const char *) (dlocn_xl + 1) > label_end)
+		return 0;
+
+	if (!(mda_start = xlate64(dlocn_xl->offset)) ||
+	    (mda_start + MDA_HEADER_SIZE > block_size))
+		return 0;
+
+	mdah = (struct mda_header *) (block_buf + mda_start);
+
+	if ((mdah->checksum_xl != xlate32(calc_crc(INITIAL_CRC, (uint8_t *)mdah->magic,
+						  MDA_HEADER_SIZE - sizeof(mdah->checksum_xl)))) ||
+	    memcmp(mdah->magic, FMTT_MAGIC, sizeof(mdah->magic)) ||
+	    (xlate64(mdah->start) != mda_start))
+		return 0;
+
+	mda_size = xlate64(mdah->size);
+	rlocn = mdah->raw_locns; /* slot0, committed metadata */
+	offset = xlate64(rlocn->offset);
+	size = xlate64(rlocn->size);
+
+	if (!offset || !size || (offset >= mda_size) || (size > mda_size) ||
+	    (xlate32(rlocn->flags) & RAW_LOCN_IGNORED))
+		return 0;
+
+	locn->offset = mda_start + offset;
+	locn->size = size;
+	locn->offset2 = 0;
+	locn->size2 = 0;
+	locn->checksum = xlate32(rlocn->checksum);
+
+	if (offset + size > mda_size) {
+		locn->size = mda_size - offset;
+		locn->offset2 = mda_start + MDA_HEADER_SIZE;
+		locn->size2 = offset + size - mda_size;
+	}
+
+	return 1;
+}
+
 /*
  * Used by label_scan to get a summary of the VG that exists on this PV.  This
  * summary is stored in lvmcache vginfo/info/info->mdas and is used later by
@@ -664,6 +732,7 @@ static const struct label_ops _text_ops = {
 	.can_handle = _text_can_handle,
 	.write = _text_write,
 	.read = _text_read,
+	.peek_metadata = _text_peek_metadata,
 	.initialise_label = _text_initialise_label,
 	.destroy_label = _text_destroy_label,
 	.destroy = _fmt_text_destroy,
@@ -146,6 +146,7 @@
 #include "lib/label/hints.h"
 #include "lib/device/dev-type.h"
 #include "lib/device/device_id.h"
+#include "base/data-struct/radix-tree.h"
 
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -382,15 +383,35 @@ void free_hints(struct dm_list *hints)
 	}
 }
 
-static struct hint *_find_hint_name(struct dm_list *hints, const char *name)
+/*
+ * Index hints by device name so that matching them against the list of
+ * devices, or the devices file entries, is not quadratic in the number
+ * of devices.  If the same name appears more than once, the first hint
+ * is indexed.
+ */
+static struct radix_tree *_index_hint_names(struct dm_list *hints)
 {
+	struct radix_tree *rt;
 	struct hint *hint;
 
+	if (!(rt = radix_tree_create(NULL, NULL)))
+		return_NULL;
+
 	dm_list_iterate_items(hint, hints) {
-		if (!strcmp(hint->name, name))
-			return hint;
+		if (radix_tree_lookup_ptr(rt, hint->name, strlen(hint->name)))
+			continue;
+		if (!radix_tree_insert_ptr(rt, hint->name, strlen(hint->name), hint)) {
+			radix_tree_destroy(rt);
+			return_NULL;
+		}
 	}
-	return NULL;
+
+	return rt;
+}
+
+static struct hint *_find_hint_name(struct radix_tree *rt, const char *name)
+{
+	return radix_tree_lookup_ptr(rt, name, strlen(name));
 }
 
 /*
@@ -466,7 +487,6 @@ static int _dev_in_hint_hash(struct cmd_context *cmd, struct device *dev)
 int validate_hints(struct cmd_context *cmd, struct dm_list *hints)
 {
 	struct hint *hint;
-	struct dev_iter *iter;
 	struct device *dev;
 	int valid_hints = 0;
 	int ret = 1;
@@ -497,18 +517,12 @@ int validate_hints(struct cmd_context *cmd, struct dm_list *hints)
 	 * Check that the PVID saved in the hint for each device matches the
 	 * PVID that the scan found on the device.  If not, then the hints
 	 * became stale somehow (e.g. manually copying devices with dd) and
-	 * need to be refreshed.
+	 * need to be refreshed.  _apply_hints saved the device matching
+	 * each chosen hint.
 	 */
-	if (!(iter = dev_iter_create(NULL, 0)))
-		return 0;
-	while ((dev = dev_iter_get(cmd, iter))) {
-		if (dm_list_empty(&dev->aliases))
-			continue;
-		if (!(hint = _find_hint_name(hints, dev_name(dev))))
-			continue;
-
+	dm_list_iterate_items(hint, hints) {
 		/* The cmd hasn't needed this hint's dev so it's not been scanned. */
-		if (!hint->chosen)
+		if (!hint->chosen || !(dev = hint->dev))
 			continue;
 
 		/* 
@@ -533,7 +547,6 @@ int validate_hints(struct cmd_context *cmd, struct dm_list *hints)
 
 		valid_hints++;
 	}
-	dev_iter_destroy(iter);
 
 	/*
 	 * Check in lvmcache to see if the scan noticed any missing PVs
@@ -614,13 +627,17 @@ static void _apply_hints(struct cmd_context *cmd, struct dm_list *hints,
 	struct device_list *devl, *devl2;
 	struct dm_list *name_list;
 	struct dm_str_list *name_sl;
+	struct radix_tree *rt;
+
+	if (!(rt = _index_hint_names(hints)))
+		return;
 
 	dm_list_iterate_items_safe(devl, devl2, devs_in) {
 		if (!(name_list = dm_list_first(&devl->dev->aliases)))
 			continue;
 		name_sl = dm_list_item(name_list, struct dm_str_list);
 
-		if (!(hint = _find_hint_name(hints, name_sl->str)))
+		if (!(hint = _find_hint_name(rt, name_sl->str)))
 			continue;
 
 		/* if vgname is set, pick hints with matching vgname */
@@ -632,7 +649,10 @@ static void _apply_hints(struct cmd_context *cmd, struct dm_list *hints,
 		dm_list_del(&devl->list);
 		dm_list_add(devs_out, &devl->list);
 		hint->chosen = 1;
+		hint->dev = devl->dev;
 	}
+
+	radix_tree_destroy(rt);
 }
 
 static void _filter_to_str(struct cmd_context *cmd, int filter_cfg, char **strp)
@@ -698,6 +718,7 @@ static int _read_hint_file(struct cmd_context *cmd, struct dm_list *hints, int *
 	struct hint hint;
 	struct hint *alloc_hint, *hp;
 	struct device *dev;
+	struct radix_tree *rt;
 	char *split[HINT_LINE_WORDS];
 	char *name, *pvid, *devn, *vgname, *p, *filter_str = NULL;
 	uint32_t read_hash = 0;
@@ -905,25 +926,47 @@ static int _read_hint_file(struct cmd_context *cmd, struct dm_list *hints, int *
 	 * devices file entry.
 	 */
 	if (cmd->enable_devices_file) {
-		dm_list_iterate_items(hp, hints) {
-			if (!(du = get_du_for_devname(cmd, hp->name))) {
-				log_debug("ignore hints: no devices file entry for %s", hp->name);
-				*needs_refresh = 1;
-				return 1;
-			}
+		if (!(rt = _index_hint_names(hints)))
+			return 0;
+
+		/* The first devices file entry using a hint's name is checked. */
+		dm_list_iterate_items(du, &cmd->use_devices) {
+			if (!du->devname)
+				continue;
+			if (!(hp = _find_hint_name(rt, du->devname)) || hp->dev)
+				continue;
 			if (!du->dev) {
 				log_debug("ignore hints: no device matches devices file entry for %s", hp->name);
 				*needs_refresh = 1;
-				return 1;
+				break;
 			}
 			if (hp->devt != du->dev->dev) {
 				log_debug("ignore hints: devno %u:%u does not match %u:%u for %s",
 					  MAJOR(hp->devt), MINOR(hp->devt),
 					  MAJOR(du->dev->dev), MINOR(du->dev->dev), hp->name);
 				*needs_refresh = 1;
-				return 1;
+				break;
 			}
+			/* Temporarily mark the hint as matched. */
+			hp->dev = du->dev;
 		}
+
+		dm_list_iterate_items(hp, hints) {
+			if (*needs_refresh)
+				break;
+			if (!_find_hint_name(rt, hp->name)->dev) {
+				log_debug("ignore hints: no devices file entry for %s", hp->name);
+				*needs_refresh = 1;
+			}
+		}
+
+		dm_list_iterate_items(hp, hints)
+			hp->dev = NULL;
+
+		radix_tree_destroy(rt);
+
+		if (*needs_refresh)
+			return 1;
 	}
 
 	log_debug("accept hints found %d", dm_list_size(hints));
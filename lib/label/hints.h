@@ -21,6 +21,7 @@ struct hint {
 	char name[PATH_MAX]   __attribute__((aligned(8)));
 	char vgname[NAME_LEN] __attribute__((aligned(8)));
 	char pvid[ID_LEN + 1] __attribute__((aligned(8)));
+	struct device *dev;   /* set for a chosen hint */
 	unsigned chosen:1; /* this hint's dev was chosen for scanning */
 };
 
@@ -23,10 +23,12 @@
 #include "lib/commands/toolcontext.h"
 #include "lib/activate/activate.h"
 #include "lib/label/hints.h"
+#include "lib/label/scan_cache.h"
 #include "lib/metadata/metadata.h"
 #include "lib/format_text/layout.h"
 #include "lib/device/device_id.h"
 #include "lib/device/online.h"
+#include "lib/misc/lvm-timing.h"
 
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -257,6 +259,7 @@ struct label *label_create(struct labeller *labeller)
 static struct bcache *scan_bcache;
 
 #define BCACHE_BLOCK_SIZE_IN_SECTORS 256 /* 256*512 = 128K */
+#define DIRECT_READ_MIN_BYTES (4 * BCACHE_BLOCK_SIZE_IN_SECTORS * 512) /* 512K */
 
 static bool _in_bcache(struct device *dev)
 {
@@ -479,6 +482,20 @@ static int _scan_dev_open(struct device *dev)
 		return 0;
 	}
 
+	/*
+	 * The usable filter opened the dev read-only with O_DIRECT
+	 * to get the size, use that fd if it was kept.
+	 */
+	if ((fd = dev_take_size_fd(dev)) >= 0) {
+		name = dev_name(dev);
+		if (!(dev->flags & (DEV_BCACHE_EXCL | DEV_BCACHE_WRITE))) {
+			modestr = "ro";
+			goto opened;
+		}
+		if (close(fd))
+			log_sys_debug("close", name);
+	}
+
  next_name:
 	/*
 	 * All the names for this device (major:minor) are kept on
@@ -553,6 +570,7 @@ static int _scan_dev_open(struct device *dev)
 		goto next_name;
 	}
 
+ opened:
 	dev->flags |= DEV_IN_BCACHE;
 	dev->bcache_fd = fd;
 
@@ -598,6 +616,103 @@ static int _scan_dev_close(struct device *dev)
 	return 1;
 }
 
+/*
+ * Like _find_lvm_header() for the first sectors of the device, but
+ * without logging, for looking at a block before it is processed.
+ */
+static struct labeller *_peek_lvm_header(const char *buf, uint64_t *label_sector)
+{
+	struct labeller_i *li;
+	struct label_header *lh;
+	uint64_t sector;
+
+	for (sector = 0; sector < LABEL_SCAN_SECTORS; sector += LABEL_SIZE >> SECTOR_SHIFT) {
+		lh = (struct label_header *) (buf + (sector << SECTOR_SHIFT));
+
+		if (memcmp(lh->id, LABEL_ID, sizeof(lh->id)) ||
+		    (xlate64(lh->sector_xl) != sector) ||
+		    (calc_crc(INITIAL_CRC, (uint8_t *)&lh->offset_xl,
+			      LABEL_SIZE - ((uint8_t *) &lh->offset_xl - (uint8_t *) lh)) != xlate32(lh->crc_xl)))
+			continue;
+
+		dm_list_iterate_items(li, &_labellers)
+			if (li->l->ops->can_handle(li->l, (char *) lh, sector)) {
+				*label_sector = sector;
+				return li->l;
+			}
+	}
+
+	return NULL;
+}
+
+/*
+ * The first block read from a PV contains the mda_header, but usually
+ * not the metadata text it points to, which _process_block() would then
+ * read from each device in turn, waiting for each read.  Look at the
+ * blocks of the submitted devices first, and prefetch the metadata text
+ * that is not already known in lvmcache (from another device with the
+ * same metadata) so those reads are all in flight together.
+ *
+ * A device that fails to read is flagged DEV_SCAN_NOT_READ here so that
+ * the read is not retried when the device is processed.
+ */
+static void _prefetch_metadata(struct dm_list *wait_devs)
+{
+	struct lvmcache_vgsummary vgsummary;
+	struct label_metadata_locn locn, *seen;
+	struct labeller *labeller;
+	struct device_list *devl;
+	struct block *bb;
+	uint64_t label_sector;
+	unsigned nr_seen = 0, i;
+
+	if (bcache_max_prefetches(scan_bcache) < 2)
+		return;	/* sync io, nothing gained */
+
+	if (!(seen = malloc(dm_list_size(wait_devs) * sizeof(*seen))))
+		return;
+
+	dm_list_iterate_items(devl, wait_devs) {
+		if (!bcache_get(scan_bcache, devl->dev->bcache_di, 0, 0, &bb)) {
+			devl->dev->flags |= DEV_SCAN_NOT_READ;
+			continue;
+		}
+
+		if (!(labeller = _peek_lvm_header(bb->data, &label_sector)) ||
+		    !labeller->ops->peek_metadata ||
+		    !labeller->ops->peek_metadata(labeller, (char *) bb->data + (label_sector << SECTOR_SHIFT),
+						  bb->data, bcache_block_sectors(scan_bcache) << SECTOR_SHIFT,
+						  &locn))
+			goto next;
+
+		for (i = 0; i < nr_seen; i++)
+			if ((seen[i].checksum == locn.checksum) &&
+			    (seen[i].size + seen[i].size2 == locn.size + locn.size2))
+				goto next;
+
+		seen[nr_seen++] = locn;
+
+		memset(&vgsummary, 0, sizeof(vgsummary));
+		vgsummary.mda_checksum = locn.checksum;
+		vgsummary.mda_size = locn.size + locn.size2;
+
+		if (lvmcache_lookup_mda(&vgsummary))
+			goto next;
+
+		log_debug_devs("Prefetching metadata text from %s at %llu size %llu (+%llu).",
+			       dev_name(devl->dev), (unsigned long long)locn.offset,
+			       (unsigned long long)locn.size, (unsigned long long)locn.size2);
+
+		bcache_prefetch_bytes(scan_bcache, devl->dev->bcache_di, locn.offset, locn.size);
+		if (locn.size2)
+			bcache_prefetch_bytes(scan_bcache, devl->dev->bcache_di, locn.offset2, locn.size2);
+ next:
+		bcache_put(bb);
+	}
+
+	free(seen);
+}
+
 // Like bcache_invalidate, only it throws any dirty data away if the
 // write fails.
 static void _invalidate_di(struct bcache *cache, int di)
@@ -634,6 +749,10 @@ static int _scan_list(struct cmd_context *cmd, struct dev_filter *f,
 	int submit_count;
 	int is_lvm_device;
 	int ret;
+	int tail_md_check = cmd->md_component_detection && cmd->use_full_md_check &&
+			    (bcache_max_prefetches(scan_bcache) > 1);
+	uint64_t block_bytes = bcache_block_sectors(scan_bcache) << SECTOR_SHIFT;
+	uint64_t tail_start, tail_len, tail_blocks;
 
 	dm_list_init(&wait_devs);
 	dm_list_init(&done_devs);
@@ -644,6 +763,10 @@ static int _scan_list(struct cmd_context *cmd, struct dev_filter *f,
 	rem_prefetches = bcache_max_prefetches(scan_bcache);
 	submit_count = 0;
 
+	/* Leave room in bcache for the metadata text prefetched by _prefetch_metadata. */
+	if ((rem_prefetches > 1) && (rem_prefetches > (int) (bcache_nr_cache_blocks(scan_bcache) / 2)))
+		rem_prefetches = bcache_nr_cache_blocks(scan_bcache) / 2;
+
 	dm_list_iterate_items_safe(devl, devl2, devs) {
 
 		devl->dev->flags &= ~DEV_SCAN_NOT_READ;
@@ -673,17 +796,35 @@ static int _scan_list(struct cmd_context *cmd, struct dev_filter *f,
 		rem_prefetches--;
 		submit_count++;
 
+		/*
+		 * The full md check of filter-md reads superblocks at the
+		 * end of each device, read them along with the start.
+		 */
+		if (tail_md_check &&
+		    dev_md_tail_region(devl->dev, &tail_start, &tail_len)) {
+			tail_blocks = (tail_start + tail_len - 1) / block_bytes -
+				      tail_start / block_bytes + 1;
+			if (rem_prefetches > (int) tail_blocks) {
+				bcache_prefetch_bytes(scan_bcache, devl->dev->bcache_di,
+						      tail_start, tail_len);
+				rem_prefetches -= tail_blocks;
+			}
+		}
+
 		dm_list_del(&devl->list);
 		dm_list_add(&wait_devs, &devl->list);
 	}
 
 	log_debug_devs("Scanning submitted %d reads", submit_count);
 
+	_prefetch_metadata(&wait_devs);
+
 	dm_list_iterate_items_safe(devl, devl2, &wait_devs) {
 		bb = NULL;
 		is_lvm_device = 0;
 
-		if (!bcache_get(scan_bcache, devl->dev->bcache_di, 0, 0, &bb)) {
+		if ((devl->dev->flags & DEV_SCAN_NOT_READ) ||
+		    !bcache_get(scan_bcache, devl->dev->bcache_di, 0, 0, &bb)) {
 			log_debug_devs("Scan failed to read %s.", dev_name(devl->dev));
 			scan_read_errors++;
 			scan_failed_count++;
@@ -764,6 +905,12 @@ static int _scan_list(struct cmd_context *cmd, struct dev_filter *f,
  * cases the user would need to set io_memory_size to be larger
  * than the max VG metadata size (lvm does not impose any limit on
  * the metadata size.)
+ *
+ * When the scan cache is loaded it remembers the largest metadata
+ * seen by previous commands, and the bcache is made large enough to
+ * hold two copies of it (the committed one being read and the new one
+ * being written) plus 1MB for labels, so large VGs don't evict their
+ * own metadata blocks or need io_memory_size raised by hand.
  */
 
 #define MIN_BCACHE_BLOCKS 32    /* 4MB (32 * 128KB) */
@@ -774,6 +921,7 @@ int label_scan_setup_bcache(void)
 	struct io_engine *ioe = NULL;
 	int iomem_kb = io_memory_size();
 	int block_size_kb = (BCACHE_BLOCK_SIZE_IN_SECTORS * 512) / 1024;
+	uint64_t mda_bytes, want_blocks;
 	int cache_blocks;
 
 	if (scan_bcache)
@@ -781,6 +929,15 @@ int label_scan_setup_bcache(void)
 
 	cache_blocks = iomem_kb / block_size_kb;
 
+	if ((mda_bytes = scan_cache_max_metadata_size())) {
+		want_blocks = (2 * mda_bytes + (1024 * 1024)) / (block_size_kb * 1024) + 1;
+		if (want_blocks > (uint64_t) cache_blocks) {
+			log_debug("Using %llu bcache blocks for metadata size %llu.",
+				  (unsigned long long) want_blocks, (unsigned long long) mda_bytes);
+			cache_blocks = (want_blocks > MAX_BCACHE_BLOCKS) ? MAX_BCACHE_BLOCKS : (int) want_blocks;
+		}
+	}
+
 	if (cache_blocks < MIN_BCACHE_BLOCKS)
 		cache_blocks = MIN_BCACHE_BLOCKS;
 
@@ -790,7 +947,10 @@ int label_scan_setup_bcache(void)
 	_current_bcache_size_bytes = cache_blocks * BCACHE_BLOCK_SIZE_IN_SECTORS * 512;
 
 	if (use_aio()) {
-		if (!(ioe = create_async_io_engine())) {
+		if (use_io_uring() && !(ioe = create_io_uring_io_engine()))
+			log_debug("Failed to set up io_uring, using async io.");
+
+		if (!ioe && !(ioe = create_async_io_engine())) {
 			log_warn("Failed to set up async io, using sync io.");
 			init_use_aio(0);
 		}
@@ -808,6 +968,14 @@ int label_scan_setup_bcache(void)
 		return 0;
 	}
 
+	/*
+	 * A device with very slow io (e.g. a failing path) may hold at most
+	 * a quarter of the prefetch slots, so it does not stall prefetching
+	 * from the other devices in the scan.
+	 */
+	if (bcache_max_prefetches(scan_bcache) > 4)
+		bcache_set_max_di_prefetches(scan_bcache, bcache_max_prefetches(scan_bcache) / 4);
+
 	return 1;
 }
 
@@ -864,6 +1032,23 @@ void prepare_open_file_limit(struct cmd_context *cmd, unsigned int num_devs)
 #endif
 }
 
+/*
+ * The number of fds from the size check during filtering which
+ * can be kept for the scan, leaving room for other open files.
+ */
+static unsigned _scan_fd_budget(void)
+{
+	struct rlimit lim;
+
+	if (getrlimit(RLIMIT_NOFILE, &lim) || (lim.rlim_cur <= 2 * BASE_FD_COUNT))
+		return 0;
+
+	if (lim.rlim_cur - 2 * BASE_FD_COUNT > UINT_MAX)
+		return UINT_MAX;
+
+	return (unsigned)(lim.rlim_cur - 2 * BASE_FD_COUNT);
+}
+
 /*
  * Currently the only caller is pvck which probably doesn't need
  * deferred filters checked after the read... it wants to know if
@@ -1234,7 +1419,7 @@ bad:
  * processing a given VG.
  */
 
-int label_scan(struct cmd_context *cmd)
+static int _label_scan(struct cmd_context *cmd)
 {
 	struct dm_list all_devs;
 	struct dm_list filtered_devs;
@@ -1247,6 +1432,8 @@ int label_scan(struct cmd_context *cmd)
 	int using_hints;
 	int create_hints = 0; /* NEWHINTS_NONE */
 
+	scan_cache_load(cmd);
+
 	log_debug_devs("Finding devices to scan");
 
 	dm_list_init(&all_devs);
@@ -1332,6 +1519,8 @@ int label_scan(struct cmd_context *cmd)
 	 */
 	log_debug_devs("Filtering devices to scan (nodata)");
 
+	dev_keep_size_fds(_scan_fd_budget());
+
 	cmd->filter_nodata_only = 1;
 	dm_list_iterate_items_safe(devl, devl2, &all_devs) {
 		dev = devl->dev;
@@ -1352,6 +1541,11 @@ int label_scan(struct cmd_context *cmd)
 
 	cmd->filter_nodata_only = 0;
 
+	dev_keep_size_fds(0);
+
+	dm_list_iterate_items(devl, &filtered_devs)
+		dev_close_size_fd(devl->dev);
+
 	dm_list_iterate_items(devl, &all_devs)
 		cmd->filter->wipe(cmd, cmd->filter, devl->dev, NULL);
 	dm_list_iterate_items(devl, &filtered_devs)
@@ -1375,9 +1569,14 @@ int label_scan(struct cmd_context *cmd)
 		dm_list_splice(&scan_devs, &all_devs);
 		dm_list_init(&hints_list);
 		using_hints = 0;
-	} else
+	} else {
 		using_hints = 1;
 
+		/* Devs not scanned for the hints don't need the fds. */
+		dm_list_iterate_items(devl, &all_devs)
+			dev_close_size_fd(devl->dev);
+	}
+
 	/*
 	 * If the total number of devices exceeds the soft open file
 	 * limit, then increase the soft limit to the hard/max limit
@@ -1494,6 +1693,17 @@ int label_scan(struct cmd_context *cmd)
 	return 1;
 }
 
+int label_scan(struct cmd_context *cmd)
+{
+	int r;
+
+	timing_start(TIMING_LABEL_SCAN);
+	r = _label_scan(cmd);
+	timing_end(TIMING_LABEL_SCAN);
+
+	return r;
+}
+
 /*
  * Read the header of the disk and if it's a PV
  * save the pvid in dev->pvid.
@@ -1706,11 +1916,20 @@ void label_scan_drop(struct cmd_context *cmd)
 
 void label_scan_destroy(struct cmd_context *cmd)
 {
+	scan_cache_exit(cmd);
+
 	if (!scan_bcache)
 		return;
 
 	label_scan_drop(cmd);
 
+	if (timing_enabled()) {
+		struct bcache_stats stats;
+
+		bcache_get_stats(scan_bcache, &stats);
+		timing_add_bcache_stats(&stats);
+	}
+
 	bcache_destroy(scan_bcache);
 	scan_bcache = NULL;
 }
@@ -1861,6 +2080,16 @@ int label_scan_reopen_rw(struct device *dev)
 	return 1;
 }
 
+/*
+ * Start reading a range that dev_read_bytes() will need later, with other
+ * reads in flight.  Only for devices already opened by the scan.
+ */
+void dev_prefetch_bytes(struct device *dev, uint64_t start, size_t len)
+{
+	if (scan_bcache && (dev->bcache_di >= 0))
+		bcache_prefetch_bytes(scan_bcache, dev->bcache_di, start, len);
+}
+
 bool dev_read_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 {
 	if (!scan_bcache) {
@@ -1878,6 +2107,15 @@ bool dev_read_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 		}
 	}
 
+	/*
+	 * Large reads (metadata text) are done with one direct read of the
+	 * uncached part instead of block by block through the cache,
+	 * falling back to the cache if that fails.
+	 */
+	if ((len >= DIRECT_READ_MIN_BYTES) &&
+	    bcache_read_bytes_direct(scan_bcache, dev->bcache_di, start, len, data))
+		return true;
+
 	if (!bcache_read_bytes(scan_bcache, dev->bcache_di, start, len, data)) {
 		log_error("Error reading device %s at %llu length %u.",
 			  dev_name(dev), (unsigned long long)start, (uint32_t)len);
@@ -1888,6 +2126,73 @@ bool dev_read_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 
 }
 
+/*
+ * Devices with dirty blocks of a write batch.  Only used for writes
+ * which need no ordering among each other, i.e. the PV headers of
+ * vg_write or of new PVs in pvcreate, so the blocks of all devices
+ * can be issued together.
+ */
+static int _write_batch;
+static struct device **_write_batch_devs;
+static unsigned _write_batch_count;
+static unsigned _write_batch_size;
+
+static bool _write_batch_add(struct device *dev)
+{
+	struct device **devs;
+	unsigned i;
+
+	for (i = 0; i < _write_batch_count; i++)
+		if (_write_batch_devs[i] == dev)
+			return true;
+
+	if (_write_batch_count == _write_batch_size) {
+		if (!(devs = realloc(_write_batch_devs, sizeof(*devs) * (_write_batch_size + 64)))) {
+			log_error("Failed to allocate write batch.");
+			return false;
+		}
+		_write_batch_devs = devs;
+		_write_batch_size += 64;
+	}
+
+	_write_batch_devs[_write_batch_count++] = dev;
+
+	return true;
+}
+
+void dev_write_batch_begin(void)
+{
+	_write_batch = 1;
+}
+
+bool dev_write_batch_end(void)
+{
+	bool r = true;
+	unsigned i;
+
+	_write_batch = 0;
+
+	if (_write_batch_count) {
+		log_debug_devs("Writing batch of %u devices.", _write_batch_count);
+		r = bcache_flush(scan_bcache);
+	}
+
+	if (!r)
+		log_error("Error writing batch of %u devices.", _write_batch_count);
+
+	for (i = 0; i < _write_batch_count; i++) {
+		dev_unset_last_byte(_write_batch_devs[i]);
+		if (!r)
+			label_scan_invalidate(_write_batch_devs[i]);
+	}
+
+	free(_write_batch_devs);
+	_write_batch_devs = NULL;
+	_write_batch_count = _write_batch_size = 0;
+
+	return r;
+}
+
 bool dev_write_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 {
 	if (test_mode())
@@ -1927,6 +2232,17 @@ bool dev_write_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 		return false;
 	}
 
+	if (_write_batch)
+		return _write_batch_add(dev);
+
+	/*
+	 * Each write is flushed before returning rather than batched with
+	 * the writes to other devices.  Callers set the device's last byte
+	 * around the write (the second mda ends at the end of the device),
+	 * rely on the text being on disk before the mda header points to it,
+	 * and mark individual mdas failed when handling missing PVs; none of
+	 * that holds if the blocks of several devices go out in one flush.
+	 */
 	if (!bcache_flush(scan_bcache)) {
 		log_error("Error writing device %s at %llu length %u.",
 			  dev_name(dev), (unsigned long long)start, (uint32_t)len);
@@ -1994,6 +2310,9 @@ bool dev_set_bytes(struct device *dev, uint64_t start, size_t len, uint8_t val)
 		goto fail;
 	}
 
+	if (_write_batch)
+		return _write_batch_add(dev);
+
 	if (!bcache_flush(scan_bcache)) {
 		log_error("Error writing device %s at %llu length %u.",
 			  dev_name(dev), (unsigned long long)start, (uint32_t)len);
@@ -2038,10 +2357,17 @@ void dev_set_last_byte(struct device *dev, uint64_t offset)
 		bs = 512;
 	}
 
+	/* Batched blocks are written later, let the limit cover all of them */
+	if (_write_batch && (bcache_get_last_byte(scan_bcache, dev->bcache_di) > offset))
+		return;
+
 	bcache_set_last_byte(scan_bcache, dev->bcache_di, offset, bs);
 }
 
 void dev_unset_last_byte(struct device *dev)
 {
+	if (_write_batch)
+		return;
+
 	bcache_unset_last_byte(scan_bcache, dev->bcache_di);
 }
@@ -48,6 +48,15 @@ struct label {
 	void *info;
 };
 
+/* Location of committed metadata text found by peek_metadata() */
+struct label_metadata_locn {
+	uint64_t offset;
+	uint64_t size;
+	uint64_t offset2;	/* Wrapped part, when size2 is set */
+	uint64_t size2;
+	uint32_t checksum;
+};
+
 struct labeller;
 
 struct label_ops {
@@ -67,6 +76,15 @@ struct label_ops {
 	int (*read) (struct cmd_context *cmd, struct labeller * l, struct device * dev,
 		     void *label_buf, uint64_t label_sector, int *is_duplicate);
 
+	/*
+	 * Optional.  Find the metadata text location using only the first
+	 * block read from the device, so that label_scan can prefetch the
+	 * text before read() is called.
+	 */
+	int (*peek_metadata) (struct labeller * l, void *label_buf,
+			      const char *block_buf, size_t block_size,
+			      struct label_metadata_locn *locn);
+
 	/*
 	 * Populate label_type etc.
 	 */
@@ -128,6 +146,7 @@ int label_scan_for_pvid(struct cmd_context *cmd, char *pvid, struct device **dev
  * (these make it easier to disable bcache and revert to direct rw if needed)
  */
 bool dev_read_bytes(struct device *dev, uint64_t start, size_t len, void *data);
+void dev_prefetch_bytes(struct device *dev, uint64_t start, size_t len);
 bool dev_write_bytes(struct device *dev, uint64_t start, size_t len, void *data);
 bool dev_write_zeros(struct device *dev, uint64_t start, size_t len);
 bool dev_set_bytes(struct device *dev, uint64_t start, size_t len, uint8_t val);
@@ -136,6 +155,14 @@ void dev_invalidate(struct device *dev);
 void dev_set_last_byte(struct device *dev, uint64_t offset);
 void dev_unset_last_byte(struct device *dev);
 
+/*
+ * Between these, dev_write_bytes() and dev_set_bytes() leave their
+ * blocks dirty and dev_write_batch_end() writes the blocks of all
+ * devices at once.
+ */
+void dev_write_batch_begin(void);
+bool dev_write_batch_end(void);
+
 void prepare_open_file_limit(struct cmd_context *cmd, unsigned int num_devs);
 
 #endif
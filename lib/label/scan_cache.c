@@ -0,0 +1,635 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Scan cache
+ *
+ * label_scan reads the mda_header from each PV, and then reads and
+ * parses the metadata text the mda_header points to, to get a summary
+ * of the VG (name, id, seqno, status, PV list) for lvmcache.  For one
+ * VG the text is only read from the first PV, other PVs with the same
+ * mda checksum and size reuse that summary (lvmcache_lookup_mda).
+ *
+ * The scan cache saves those summaries in DEFAULT_RUN_DIR/scan_cache,
+ * keyed by the mda checksum and metadata size from the mda_header, so
+ * the next command finding the same checksum/size in an mda_header can
+ * skip reading and parsing the text also for the first PV.  Entries are
+ * addressed by content, a change to the VG metadata changes the
+ * checksum in the mda_header, so entries never need invalidating; the
+ * file only holds summaries that were used or added most recently.
+ *
+ * The file is binary: a header with magic, version, entry count and
+ * crc of the entries, followed by the entries.  All integers are little
+ * endian.  Strings are stored as a 16 bit length including the nul
+ * terminator followed by the characters, length 0 means no string.
+ *
+ * The file is replaced by rename so readers never see a partial write.
+ */
+
+#include "lib/misc/lib.h"
+#include "lib/label/scan_cache.h"
+#include "lib/cache/lvmcache.h"
+#include "lib/commands/toolcontext.h"
+#include "lib/config/config.h"
+#include "lib/misc/crc.h"
+#include "lib/mm/xlate.h"
+#include "base/data-struct/radix-tree.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char _scan_cache_file[] = DEFAULT_RUN_DIR "/scan_cache";
+
+#define SCAN_CACHE_MAGIC "LVMSCAN1"
+#define SCAN_CACHE_VERSION 1
+#define SCAN_CACHE_MAX_ENTRIES 4096
+#define SCAN_CACHE_MAX_FILE_SIZE (64 * 1024 * 1024)
+
+/* On disk */
+struct scan_cache_header {
+	int8_t magic[8];
+	uint32_t version;
+	uint32_t count;
+	uint32_t data_size;
+	uint32_t data_crc;
+} __attribute__ ((packed));
+
+struct scan_cache_disk_entry {
+	uint32_t mda_checksum;
+	uint32_t seqno;
+	uint64_t mda_size;
+	uint64_t vgstatus;
+	int8_t vgid[ID_LEN];
+	uint32_t pv_count;
+	/* followed by vgname, creation_host, system_id, lock_type strings */
+} __attribute__ ((packed));
+
+struct scan_cache_disk_pv {
+	int8_t pvid[ID_LEN];
+	uint64_t dev_size;
+	/* followed by device_hint, device_id, device_id_type strings */
+} __attribute__ ((packed));
+
+/* In core */
+struct scan_cache_pv {
+	struct dm_list list;
+	struct id id;
+	uint64_t dev_size;
+	const char *device_hint;
+	const char *device_id;
+	const char *device_id_type;
+};
+
+struct scan_cache_entry {
+	struct dm_list list;
+	uint32_t mda_checksum;
+	uint32_t seqno;
+	uint64_t mda_size;
+	uint64_t vgstatus;
+	char vgid[ID_LEN + 1];
+	const char *vgname;
+	const char *creation_host;
+	const char *system_id;
+	const char *lock_type;
+	struct dm_list pvs;
+	unsigned used:1;
+};
+
+struct scan_cache_key {
+	uint32_t mda_checksum;
+	uint64_t mda_size;
+} __attribute__ ((packed));
+
+static struct dm_pool *_mem = NULL;
+static struct radix_tree *_entries_rt = NULL;
+static struct dm_list _entries;
+static int _loaded = 0;
+static int _dirty = 0;
+
+static void _set_key(struct scan_cache_key *key, uint32_t mda_checksum, uint64_t mda_size)
+{
+	key->mda_checksum = mda_checksum;
+	key->mda_size = mda_size;
+}
+
+struct buf {
+	char *data;
+	size_t len;
+	size_t alloc;
+	int error;
+};
+
+static void _put(struct buf *b, const void *data, size_t len)
+{
+	char *new_data;
+	size_t new_alloc;
+
+	if (b->error)
+		return;
+
+	if (b->len + len > b->alloc) {
+		new_alloc = b->alloc ? b->alloc * 2 : 64 * 1024;
+		while (new_alloc < b->len + len)
+			new_alloc *= 2;
+		if (!(new_data = realloc(b->data, new_alloc))) {
+			b->error = 1;
+			return;
+		}
+		b->data = new_data;
+		b->alloc = new_alloc;
+	}
+
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+}
+
+static void _put_str(struct buf *b, const char *str)
+{
+	size_t len = str ? strlen(str) + 1 : 0;
+	uint16_t len_xl = xlate16((uint16_t) len);
+
+	if (len > UINT16_MAX) {
+		b->error = 1;
+		return;
+	}
+
+	_put(b, &len_xl, sizeof(len_xl));
+	if (len)
+		_put(b, str, len);
+}
+
+struct cursor {
+	const char *pos;
+	const char *end;
+};
+
+static int _get(struct cursor *c, void *data, size_t len)
+{
+	if ((size_t) (c->end - c->pos) < len)
+		return 0;
+
+	memcpy(data, c->pos, len);
+	c->pos += len;
+
+	return 1;
+}
+
+static int _get_str(struct cursor *c, const char **str)
+{
+	uint16_t len;
+
+	if (!_get(c, &len, sizeof(len)))
+		return 0;
+
+	if (!(len = xlate16(len))) {
+		*str = NULL;
+		return 1;
+	}
+
+	if (((size_t) (c->end - c->pos) < len) || c->pos[len - 1])
+		return 0;
+
+	if (!(*str = dm_pool_strdup(_mem, c->pos)))
+		return 0;
+
+	c->pos += len;
+
+	return 1;
+}
+
+static int _create(void)
+{
+	if (!_mem && !(_mem = dm_pool_create("scan_cache", 8192)))
+		return_0;
+
+	if (!_entries_rt && !(_entries_rt = radix_tree_create(NULL, NULL)))
+		return_0;
+
+	dm_list_init(&_entries);
+
+	return 1;
+}
+
+static void _destroy(void)
+{
+	if (_entries_rt) {
+		radix_tree_destroy(_entries_rt);
+		_entries_rt = NULL;
+	}
+
+	if (_mem) {
+		dm_pool_destroy(_mem);
+		_mem = NULL;
+	}
+
+	_loaded = 0;
+	_dirty = 0;
+}
+
+static int _insert(struct scan_cache_entry *entry)
+{
+	struct scan_cache_key key;
+
+	_set_key(&key, entry->mda_checksum, entry->mda_size);
+
+	if (radix_tree_lookup_ptr(_entries_rt, &key, sizeof(key)))
+		return 1;
+
+	if (!radix_tree_insert_ptr(_entries_rt, &key, sizeof(key), entry))
+		return_0;
+
+	dm_list_add(&_entries, &entry->list);
+
+	return 1;
+}
+
+static int _import_entry(struct cursor *c)
+{
+	struct scan_cache_disk_entry de;
+	struct scan_cache_disk_pv dp;
+	struct scan_cache_entry *entry;
+	struct scan_cache_pv *pv;
+	uint32_t i, pv_count;
+
+	if (!_get(c, &de, sizeof(de)))
+		return 0;
+
+	if (!(entry = dm_pool_zalloc(_mem, sizeof(*entry))))
+		return_0;
+
+	dm_list_init(&entry->pvs);
+	entry->mda_checksum = xlate32(de.mda_checksum);
+	entry->seqno = xlate32(de.seqno);
+	entry->mda_size = xlate64(de.mda_size);
+	entry->vgstatus = xlate64(de.vgstatus);
+	memcpy(entry->vgid, de.vgid, ID_LEN);
+	pv_count = xlate32(de.pv_count);
+
+	if (!_get_str(c, &entry->vgname) || !entry->vgname ||
+	    !_get_str(c, &entry->creation_host) ||
+	    !_get_str(c, &entry->system_id) ||
+	    !_get_str(c, &entry->lock_type))
+		return 0;
+
+	for (i = 0; i < pv_count; i++) {
+		if (!_get(c, &dp, sizeof(dp)))
+			return 0;
+
+		if (!(pv = dm_pool_zalloc(_mem, sizeof(*pv))))
+			return_0;
+
+		memcpy(&pv->id, dp.pvid, ID_LEN);
+		pv->dev_size = xlate64(dp.dev_size);
+
+		if (!_get_str(c, &pv->device_hint) ||
+		    !_get_str(c, &pv->device_id) ||
+		    !_get_str(c, &pv->device_id_type))
+			return 0;
+
+		dm_list_add(&entry->pvs, &pv->list);
+	}
+
+	return _insert(entry);
+}
+
+static void _read_file(void)
+{
+	struct scan_cache_header hdr;
+	struct cursor c;
+	struct stat st;
+	char *data = NULL;
+	uint32_t i, count;
+	ssize_t len = 0, rv;
+	int fd;
+
+	if ((fd = open(_scan_cache_file, O_RDONLY)) < 0) {
+		if (errno != ENOENT)
+			log_debug("Failed to open scan cache %s: %d.", _scan_cache_file, errno);
+		return;
+	}
+
+	if (fstat(fd, &st) || (st.st_size < (off_t) sizeof(hdr)) ||
+	    (st.st_size > SCAN_CACHE_MAX_FILE_SIZE))
+		goto out;
+
+	if (!(data = malloc(st.st_size)))
+		goto out;
+
+	while (len < st.st_size) {
+		if ((rv = read(fd, data + len, st.st_size - len)) <= 0) {
+			if ((rv < 0) && (errno == EINTR))
+				continue;
+			goto out;
+		}
+		len += rv;
+	}
+
+	memcpy(&hdr, data, sizeof(hdr));
+
+	if (memcmp(hdr.magic, SCAN_CACHE_MAGIC, sizeof(hdr.magic)) ||
+	    (xlate32(hdr.version) != SCAN_CACHE_VERSION) ||
+	    (xlate32(hdr.data_size) != (uint32_t) (len - sizeof(hdr))) ||
+	    (xlate32(hdr.data_crc) != calc_crc(INITIAL_CRC, (uint8_t *) data + sizeof(hdr),
+					       len - sizeof(hdr)))) {
+		log_debug("Ignoring invalid scan cache %s.", _scan_cache_file);
+		goto out;
+	}
+
+	c.pos = data + sizeof(hdr);
+	c.end = data + len;
+	count = xlate32(hdr.count);
+
+	for (i = 0; i < count; i++)
+		if (!_import_entry(&c)) {
+			log_debug("Ignoring scan cache entries after %u of %u.", i, count);
+			break;
+		}
+
+	log_debug("Read %u scan cache entries from %s.", i, _scan_cache_file);
+out:
+	free(data);
+	if (close(fd))
+		log_sys_debug("close", _scan_cache_file);
+}
+
+void scan_cache_load(struct cmd_context *cmd)
+{
+	if (_loaded)
+		return;
+
+	if (!find_config_tree_bool(cmd, devices_scan_cache_CFG, NULL))
+		return;
+
+	if (!_create()) {
+		_destroy();
+		return;
+	}
+
+	_read_file();
+	_loaded = 1;
+}
+
+/*
+ * Fill in vgsummary for the mda_checksum and mda_size that the caller
+ * has set from the mda_header.
+ */
+int scan_cache_lookup(struct cmd_context *cmd, struct lvmcache_vgsummary *vgsummary)
+{
+	struct scan_cache_key key;
+	struct scan_cache_entry *entry;
+	struct scan_cache_pv *pv;
+	struct pv_list *pvl;
+
+	if (!_loaded || !vgsummary->mda_size || vgsummary->vgname)
+		return 0;
+
+	_set_key(&key, vgsummary->mda_checksum, vgsummary->mda_size);
+
+	if (!(entry = radix_tree_lookup_ptr(_entries_rt, &key, sizeof(key))))
+		return 0;
+
+	if (!(vgsummary->vgname = dm_pool_strdup(cmd->mem, entry->vgname)) ||
+	    (entry->creation_host && !(vgsummary->creation_host = dm_pool_strdup(cmd->mem, entry->creation_host))) ||
+	    (entry->system_id && !(vgsummary->system_id = dm_pool_strdup(cmd->mem, entry->system_id))) ||
+	    (entry->lock_type && !(vgsummary->lock_type = dm_pool_strdup(cmd->mem, entry->lock_type))))
+		return_0;
+
+	memcpy(vgsummary->vgid, entry->vgid, ID_LEN);
+	vgsummary->vgstatus = entry->vgstatus;
+	vgsummary->seqno = entry->seqno;
+
+	dm_list_iterate_items(pv, &entry->pvs) {
+		if (!(pvl = dm_pool_zalloc(cmd->mem, sizeof(*pvl))) ||
+		    !(pvl->pv = dm_pool_zalloc(cmd->mem, sizeof(*pvl->pv))))
+			return_0;
+
+		pvl->pv->id = pv->id;
+		pvl->pv->size = pv->dev_size;
+
+		if ((pv->device_hint && !(pvl->pv->device_hint = dm_pool_strdup(cmd->mem, pv->device_hint))) ||
+		    (pv->device_id && !(pvl->pv->device_id = dm_pool_strdup(cmd->mem, pv->device_id))) ||
+		    (pv->device_id_type && !(pvl->pv->device_id_type = dm_pool_strdup(cmd->mem, pv->device_id_type))))
+			return_0;
+
+		dm_list_add(&vgsummary->pvsummaries, &pvl->list);
+	}
+
+	if (!entry->used) {
+		entry->used = 1;
+		/* Move to the front so it is kept when the file is trimmed. */
+		dm_list_del(&entry->list);
+		dm_list_add_h(&_entries, &entry->list);
+	}
+
+	return 1;
+}
+
+/*
+ * Largest metadata text in the loaded entries, i.e. what the previous
+ * commands saw, used to size bcache before the scan finds it again.
+ */
+uint64_t scan_cache_max_metadata_size(void)
+{
+	struct scan_cache_entry *entry;
+	uint64_t max_size = 0;
+
+	if (!_loaded)
+		return 0;
+
+	dm_list_iterate_items(entry, &_entries)
+		if (entry->mda_size > max_size)
+			max_size = entry->mda_size;
+
+	return max_size;
+}
+
+static const char *_dup_str(const char *str)
+{
+	return str ? dm_pool_strdup(_mem, str) : NULL;
+}
+
+/*
+ * Save the summary the caller has read from metadata text.
+ */
+void scan_cache_add(struct cmd_context *cmd __attribute__((unused)),
+		    const struct lvmcache_vgsummary *vgsummary)
+{
+	struct scan_cache_key key;
+	struct scan_cache_entry *entry;
+	struct scan_cache_pv *pv;
+	struct pv_list *pvl;
+
+	if (!_loaded || !vgsummary->mda_size || !vgsummary->vgname)
+		return;
+
+	_set_key(&key, vgsummary->mda_checksum, vgsummary->mda_size);
+
+	if (radix_tree_lookup_ptr(_entries_rt, &key, sizeof(key)))
+		return;
+
+	if (!(entry = dm_pool_zalloc(_mem, sizeof(*entry))))
+		goto_bad;
+
+	dm_list_init(&entry->pvs);
+	entry->mda_checksum = vgsummary->mda_checksum;
+	entry->mda_size = vgsummary->mda_size;
+	entry->seqno = vgsummary->seqno;
+	entry->vgstatus = vgsummary->vgstatus;
+	memcpy(entry->vgid, vgsummary->vgid, ID_LEN);
+	entry->used = 1;
+
+	if (!(entry->vgname = _dup_str(vgsummary->vgname)) ||
+	    (vgsummary->creation_host && !(entry->creation_host = _dup_str(vgsummary->creation_host))) ||
+	    (vgsummary->system_id && !(entry->system_id = _dup_str(vgsummary->system_id))) ||
+	    (vgsummary->lock_type && !(entry->lock_type = _dup_str(vgsummary->lock_type))))
+		goto_bad;
+
+	dm_list_iterate_items(pvl, &vgsummary->pvsummaries) {
+		if (!(pv = dm_pool_zalloc(_mem, sizeof(*pv))))
+			goto_bad;
+
+		pv->id = pvl->pv->id;
+		pv->dev_size = pvl->pv->size;
+
+		if ((pvl->pv->device_hint && !(pv->device_hint = _dup_str(pvl->pv->device_hint))) ||
+		    (pvl->pv->device_id && !(pv->device_id = _dup_str(pvl->pv->device_id))) ||
+		    (pvl->pv->device_id_type && !(pv->device_id_type = _dup_str(pvl->pv->device_id_type))))
+			goto_bad;
+
+		dm_list_add(&entry->pvs, &pv->list);
+	}
+
+	if (!radix_tree_insert_ptr(_entries_rt, &key, sizeof(key), entry))
+		goto_bad;
+
+	dm_list_add_h(&_entries, &entry->list);
+	_dirty = 1;
+
+	return;
+bad:
+	/* Stop using the cache for this command. */
+	log_debug("Failed to add scan cache entry for VG %s.", vgsummary->vgname);
+	_destroy();
+}
+
+static void _export_entry(struct buf *b, struct scan_cache_entry *entry)
+{
+	struct scan_cache_disk_entry de;
+	struct scan_cache_disk_pv dp;
+	struct scan_cache_pv *pv;
+
+	memset(&de, 0, sizeof(de));
+	de.mda_checksum = xlate32(entry->mda_checksum);
+	de.seqno = xlate32(entry->seqno);
+	de.mda_size = xlate64(entry->mda_size);
+	de.vgstatus = xlate64(entry->vgstatus);
+	memcpy(de.vgid, entry->vgid, ID_LEN);
+	de.pv_count = xlate32(dm_list_size(&entry->pvs));
+
+	_put(b, &de, sizeof(de));
+	_put_str(b, entry->vgname);
+	_put_str(b, entry->creation_host);
+	_put_str(b, entry->system_id);
+	_put_str(b, entry->lock_type);
+
+	dm_list_iterate_items(pv, &entry->pvs) {
+		memset(&dp, 0, sizeof(dp));
+		memcpy(dp.pvid, &pv->id, ID_LEN);
+		dp.dev_size = xlate64(pv->dev_size);
+
+		_put(b, &dp, sizeof(dp));
+		_put_str(b, pv->device_hint);
+		_put_str(b, pv->device_id);
+		_put_str(b, pv->device_id_type);
+	}
+}
+
+static void _write_file(void)
+{
+	char tmp_file[PATH_MAX];
+	struct scan_cache_header hdr;
+	struct scan_cache_entry *entry;
+	struct buf b = { 0 };
+	uint32_t count = 0;
+	ssize_t rv;
+	size_t pos = 0;
+	int fd;
+
+	/* Reserve space for the header, filled in below. */
+	memset(&hdr, 0, sizeof(hdr));
+	_put(&b, &hdr, sizeof(hdr));
+
+	/* Recently used and added entries are at the front. */
+	dm_list_iterate_items(entry, &_entries) {
+		if (count >= SCAN_CACHE_MAX_ENTRIES)
+			break;
+		_export_entry(&b, entry);
+		count++;
+	}
+
+	if (b.error || (b.len > SCAN_CACHE_MAX_FILE_SIZE)) {
+		log_debug("Failed to prepare scan cache.");
+		goto out;
+	}
+
+	memcpy(hdr.magic, SCAN_CACHE_MAGIC, sizeof(hdr.magic));
+	hdr.version = xlate32(SCAN_CACHE_VERSION);
+	hdr.count = xlate32(count);
+	hdr.data_size = xlate32((uint32_t) (b.len - sizeof(hdr)));
+	hdr.data_crc = xlate32(calc_crc(INITIAL_CRC, (uint8_t *) b.data + sizeof(hdr),
+					b.len - sizeof(hdr)));
+	memcpy(b.data, &hdr, sizeof(hdr));
+
+	if (dm_snprintf(tmp_file, sizeof(tmp_file), "%s.%d", _scan_cache_file, getpid()) < 0)
+		goto_out;
+
+	if ((fd = open(tmp_file, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0) {
+		log_debug("Failed to create scan cache %s: %d.", tmp_file, errno);
+		goto out;
+	}
+
+	while (pos < b.len) {
+		if ((rv = write(fd, b.data + pos, b.len - pos)) < 0) {
+			if (errno == EINTR)
+				continue;
+			log_debug("Failed to write scan cache %s: %d.", tmp_file, errno);
+			break;
+		}
+		pos += rv;
+	}
+
+	if (close(fd))
+		log_sys_debug("close", tmp_file);
+
+	if ((pos < b.len) || rename(tmp_file, _scan_cache_file)) {
+		if (pos >= b.len)
+			log_debug("Failed to rename scan cache %s: %d.", tmp_file, errno);
+		if (unlink(tmp_file))
+			log_sys_debug("unlink", tmp_file);
+		goto out;
+	}
+
+	log_debug("Wrote %u scan cache entries to %s.", count, _scan_cache_file);
+out:
+	free(b.data);
+}
+
+void scan_cache_exit(struct cmd_context *cmd __attribute__((unused)))
+{
+	if (_loaded && _dirty && !test_mode())
+		_write_file();
+
+	_destroy();
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _LVM_SCAN_CACHE_H
+#define _LVM_SCAN_CACHE_H
+
+struct cmd_context;
+struct lvmcache_vgsummary;
+
+void scan_cache_load(struct cmd_context *cmd);
+
+int scan_cache_lookup(struct cmd_context *cmd, struct lvmcache_vgsummary *vgsummary);
+
+void scan_cache_add(struct cmd_context *cmd, const struct lvmcache_vgsummary *vgsummary);
+
+uint64_t scan_cache_max_metadata_size(void);
+
+void scan_cache_exit(struct cmd_context *cmd);
+
+#endif
@@ -288,8 +288,11 @@ out_hold:
 	 */
 	if (lck_type != LCK_UNLOCK)
 		lvmcache_lock_vgname(resource, lck_type == LCK_READ);
-	else if (lck_type == LCK_UNLOCK)
+	else if (lck_type == LCK_UNLOCK) {
 		lvmcache_unlock_vgname(resource);
+		/* Devices of an unlocked VG may be changed by others. */
+		dm_tree_node_cache_destroy();
+	}
 
 	return 1;
 
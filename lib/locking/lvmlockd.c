@@ -15,6 +15,7 @@
 #include "lib/activate/activate.h"
 #include "lib/locking/lvmlockd.h"
 #include "lib/cache/lvmcache.h"
+#include "lib/misc/lvm-timing.h"
 #include "daemons/lvmlockd/lvmlockd-client.h"
 
 #include <mntent.h>
@@ -147,6 +148,7 @@ static void _flags_str_to_lockd_flags(const char *flags_str, uint32_t *lockd_fla
 static int _lockd_result(daemon_reply reply, int *result, uint32_t *lockd_flags)
 {
 	int reply_result;
+	int64_t wait_us, lm_us;
 	const char *flags_str = NULL;
 	const char *lock_type = NULL;
 
@@ -171,6 +173,12 @@ static int _lockd_result(daemon_reply reply, int *result, uint32_t *lockd_flags)
 	/* The lock_type that lvmlockd used for locking. */
 	lock_type = daemon_reply_str(reply, "lock_type", "none");
 
+	/* Only lock replies of newer lvmlockd versions include these. */
+	if ((wait_us = daemon_reply_int(reply, "wait_us", -1)) >= 0)
+		timing_add(TIMING_LOCKD_WAIT, (uint64_t) wait_us);
+	if ((lm_us = daemon_reply_int(reply, "lm_us", -1)) >= 0)
+		timing_add(TIMING_LOCKD_LM, (uint64_t) lm_us);
+
 	*result = reply_result;
 
 	if (lockd_flags) {
@@ -216,7 +224,9 @@ static daemon_reply _lockd_send_with_pvs(const char *req_name,
 		}
 	}
 
+	timing_start(TIMING_LOCKD);
 	repl = daemon_send(_lvmlockd, req);
+	timing_end(TIMING_LOCKD);
 bad:
 	daemon_request_destroy(req);
 
@@ -2794,6 +2804,11 @@ static int _lockd_lv_vdo(struct cmd_context *cmd, struct logical_volume *lv,
  * of its own.  A cache pool LV does not have a lock of its own.
  * When the cache pool LV is linked to an origin LV, the lock of
  * the orgin LV protects the combined origin + cache pool.
+ *
+ * Each call is one request to lvmlockd, so vgchange on a shared VG
+ * makes one round trip per LV.  There is no multi-LV lock op: the
+ * per-LV result decides whether that LV is activated, and lvmlockd
+ * processes a lockspace's resources serially in any case.
  */
 
 int lockd_lv(struct cmd_context *cmd, struct logical_volume *lv,
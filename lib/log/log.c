@@ -27,10 +27,22 @@
 #include <time.h>
 
 #ifdef SYSTEMD_JOURNAL_SUPPORT
+/* Messages carry the location of their caller, not of this file. */
+#define SD_JOURNAL_SUPPRESS_LOCATION
 #include <systemd/sd-journal.h>
 #endif
 
+/*
+ * Debug lines are buffered and written out together, errors and
+ * warnings flush the buffer. Writes stay line aligned as long as lines
+ * are shorter than LOG_FILE_LINE_MAX, for others sharing the file.
+ */
+#define LOG_FILE_BUFFER_SIZE	(64 * 1024)
+#define LOG_FILE_LINE_MAX	4096
+
 static FILE *_log_file;
+static char _log_file_buffer[LOG_FILE_BUFFER_SIZE];
+static size_t _log_file_buffered;
 static char _log_file_path[PATH_MAX];
 
 static int _syslog = 0;
@@ -309,6 +321,10 @@ no_epoch:
 		return;
 	}
 
+	if (setvbuf(_log_file, _log_file_buffer, _IOFBF, sizeof(_log_file_buffer)))
+		log_sys_debug("setvbuf", log_file);
+
+	_log_file_buffered = 0;
 	_log_to_file = 1;
 }
 
@@ -683,8 +699,14 @@ static void _vprint_log(int level, const char *file, int line, int dm_errno_or_c
 			default:          prio = LOG_INFO;
 			}
 			va_copy(ap, orig_ap);
-			sd_journal_printv(prio, trformat, ap);
+			if (vsnprintf(message, sizeof(message), trformat, ap) < 0)
+				message[0] = '\0';
 			va_end(ap);
+			sd_journal_send("MESSAGE=%s", message,
+					"PRIORITY=%i", prio,
+					"CODE_FILE=%s", file,
+					"CODE_LINE=%d", line,
+					NULL);
 		}
 	}
 #endif
@@ -771,15 +793,27 @@ static void _vprint_log(int level, const char *file, int line, int dm_errno_or_c
 		else
 			command_prefix = NULL;
 
+		/* Flush before the line could get split by a full buffer. */
+		if (_log_file_buffered > sizeof(_log_file_buffer) - LOG_FILE_LINE_MAX) {
+			fflush(_log_file);
+			_log_file_buffered = 0;
+		}
+
 		if (!_debug_file_fields || (_debug_file_fields & LOG_DEBUG_FIELD_FILELINE))
-			fprintf(_log_file, "%s%s %s:%d%s", time_prefix, command_prefix ?: "", file, line, _msg_prefix);
+			n = fprintf(_log_file, "%s%s %s:%d%s", time_prefix, command_prefix ?: "", file, line, _msg_prefix);
 		else
-			fprintf(_log_file, "%s%s %s", time_prefix, command_prefix ?: "", _msg_prefix);
+			n = fprintf(_log_file, "%s%s %s", time_prefix, command_prefix ?: "", _msg_prefix);
+
+		if (n > 0)
+			_log_file_buffered += n;
 
 		va_copy(ap, orig_ap);
-		vfprintf(_log_file, trformat, ap);
+		n = vfprintf(_log_file, trformat, ap);
 		va_end(ap);
 
+		if (n > 0)
+			_log_file_buffered += n;
+
 		if (_log_file_max_lines && ++_log_file_lines >= _log_file_max_lines) {
 			fprintf(_log_file, "\n%s:%d %sAborting. Command has reached limit "
 				"for logged lines (LVM_LOG_FILE_MAX_LINES=" FMTu64 ").",
@@ -789,7 +823,12 @@ static void _vprint_log(int level, const char *file, int line, int dm_errno_or_c
 		}
 
 		fputc('\n', _log_file);
-		fflush(_log_file);
+		_log_file_buffered++;
+
+		if ((level <= _LOG_WARN) || fatal_internal_error) {
+			fflush(_log_file);
+			_log_file_buffered = 0;
+		}
 	}
 
 	if (_syslog && (_log_while_suspended || !critical_section())) {
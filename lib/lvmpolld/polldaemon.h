@@ -67,6 +67,11 @@ int poll_daemon(struct cmd_context *cmd, unsigned background,
 		uint64_t lv_type, const struct poll_functions *poll_fns,
 		const char *progress_title, struct poll_operation_id *id);
 
+int poll_daemon_lvs(struct cmd_context *cmd, unsigned background,
+		    uint64_t lv_type, const struct poll_functions *poll_fns,
+		    const char *progress_title, struct poll_operation_id **ids,
+		    unsigned count);
+
 progress_t poll_mirror_progress(struct cmd_context *cmd,
 				struct logical_volume *lv, const char *name,
 				struct daemon_parms *parms);
@@ -74,4 +79,7 @@ progress_t poll_mirror_progress(struct cmd_context *cmd,
 int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
 		       struct daemon_parms *parms);
 
+int wait_for_lvs(struct cmd_context *cmd, struct poll_operation_id **ids,
+		 unsigned count, struct daemon_parms *parms);
+
 #endif
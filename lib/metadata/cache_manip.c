@@ -30,6 +30,11 @@
 #define DM_HINT_OVERHEAD_PER_BLOCK	8  /* bytes */
 #define DM_MAX_HINT_WIDTH		(4+16)  /* bytes.  FIXME Configurable? */
 
+/* Kernel default of migration_threshold in sectors */
+#define DM_CACHE_MIGRATION_THRESHOLD	2048
+/* Least number of cached I/Os before the statistics are trusted */
+#define CACHE_TUNING_MIN_IOS		65536
+
 const char *cache_mode_num_to_str(cache_mode_t mode)
 {
 	switch (mode) {
@@ -171,6 +176,73 @@ void cache_check_for_warns(const struct lv_segment *seg)
 			 "caching of raid logical volume!");
 }
 
+static uint64_t _cache_migration_threshold(const struct dm_status_cache *c)
+{
+	int i;
+
+	for (i = 0; i + 1 < c->core_argc; i += 2)
+		if (!strcmp(c->core_argv[i], "migration_threshold"))
+			return strtoull(c->core_argv[i + 1], NULL, 10);
+
+	return DM_CACHE_MIGRATION_THRESHOLD;
+}
+
+/*
+ * Suggest a cache setting from the statistics the kernel has collected
+ * since the cache was activated.  Returns NULL when they do not point
+ * to a better setting.
+ *
+ * - metadata nearly full: double the chunk size, at next cache attach
+ * - cache full, poor hit ratio and the whole cache replaced more than
+ *   twice: the working set does not fit, halve migration_threshold to
+ *   cut the churn
+ * - cache not full with a poor hit ratio: promotion is throttled,
+ *   double migration_threshold
+ */
+const char *cache_tuning_hint(struct dm_pool *mem, const struct dm_status_cache *c)
+{
+	char buf[64];
+	uint64_t reads, ios, threshold;
+	unsigned hit_percent;
+
+	if (c->error || c->fail || !c->total_blocks || !c->metadata_total_blocks)
+		return NULL;
+
+	reads = c->read_hits + c->read_misses;
+	ios = reads + c->write_hits + c->write_misses;
+
+	if (ios < CACHE_TUNING_MIN_IOS || !reads)
+		return NULL;
+
+	if ((c->metadata_used_blocks * 100 >= c->metadata_total_blocks * 90) &&
+	    (c->block_size * 2 <= DM_CACHE_MAX_DATA_BLOCK_SIZE)) {
+		/* Twice the chunk size, sectors to KiB */
+		if (dm_snprintf(buf, sizeof(buf), "chunksize=%uk", c->block_size) < 0)
+			return_NULL;
+		return dm_pool_strdup(mem, buf);
+	}
+
+	hit_percent = (unsigned) (c->read_hits * 100 / reads);
+
+	if (hit_percent >= 50)
+		return NULL;
+
+	threshold = _cache_migration_threshold(c);
+
+	if (c->used_blocks >= c->total_blocks) {
+		if ((c->promotions <= c->total_blocks * 2) ||
+		    (threshold / 2 < c->block_size * 8))
+			return NULL;
+		threshold /= 2;
+	} else
+		threshold *= 2;
+
+	if (dm_snprintf(buf, sizeof(buf), "migration_threshold=" FMTu64, threshold) < 0)
+		return_NULL;
+
+	return dm_pool_strdup(mem, buf);
+}
+
 /*
  * Returns the minimum size of cache metadata volume for given cache data size and
  * and cache chunk size (all in/out values in sectors)
@@ -456,6 +456,37 @@ bad:
 	return 0;
 }
 
+static int _zero_integrity_metadata_lvs(struct cmd_context *cmd,
+					struct logical_volume **lvs,
+					uint32_t count)
+{
+	struct wipe_params wipe = { .do_zero = 1 };
+	uint32_t i, active = 0;
+	int r = 0;
+
+	for (; active < count; active++)
+		if (!activate_lv(cmd, lvs[active])) {
+			log_error("Failed to activate LV %s to zero", display_lvname(lvs[active]));
+			goto out;
+		}
+
+	for (i = 0; i < count; i++)
+		if (!wipe_lv(lvs[i], wipe)) {
+			log_error("Failed to zero LV for integrity metadata %s", display_lvname(lvs[i]));
+			goto out;
+		}
+
+	r = 1;
+out:
+	for (i = 0; i < active; i++)
+		if (!deactivate_lv(cmd, lvs[i])) {
+			log_error("Failed to deactivate LV %s after zero", display_lvname(lvs[i]));
+			r = 0;
+		}
+
+	return r;
+}
+
 /*
  * Add integrity to each raid image.
  *
@@ -495,6 +526,7 @@ int lv_add_integrity_to_raid(struct logical_volume *lv, struct integrity_setting
 	struct lvcreate_params lp;
 	struct dm_list allocatable_pvs;
 	struct logical_volume *imeta_lvs[DEFAULT_RAID_MAX_IMAGES];
+	struct logical_volume *zero_lvs[DEFAULT_RAID_MAX_IMAGES];
 	struct cmd_context *cmd = lv->vg->cmd;
 	struct volume_group *vg = lv->vg;
 	struct logical_volume *lv_image, *lv_imeta;
@@ -505,6 +537,7 @@ int lv_add_integrity_to_raid(struct logical_volume *lv, struct integrity_setting
 	struct dm_list *use_pvh = NULL;
 	uint32_t area_count, s;
 	uint32_t revert_meta_lvs = 0;
+	uint32_t zero_count = 0;
 	int lbs_4k = 0, lbs_512 = 0, lbs_unknown = 0;
 	int pbs_4k = 0, pbs_512 = 0, pbs_unknown = 0;
 	int is_active;
@@ -537,7 +570,6 @@ int lv_add_integrity_to_raid(struct logical_volume *lv, struct integrity_setting
 	 */
 	for (s = 0; s < area_count; s++) {
 		struct logical_volume *meta_lv;
-		struct wipe_params wipe = { .do_zero = 1 };
 
 		if (s >= DEFAULT_RAID_MAX_IMAGES)
 			goto_bad;
@@ -617,29 +649,17 @@ int lv_add_integrity_to_raid(struct logical_volume *lv, struct integrity_setting
 
 		/* Used below to set up the new integrity segment. */
 		imeta_lvs[s] = meta_lv;
-
-		/*
-		 * dm-integrity requires the metadata LV header to be zeroed.
-		 */
-
-		if (!activate_lv(cmd, meta_lv)) {
-			log_error("Failed to activate LV %s to zero", display_lvname(meta_lv));
-			goto bad;
-		}
-
-		if (!wipe_lv(meta_lv, wipe)) {
-			log_error("Failed to zero LV for integrity metadata %s", display_lvname(meta_lv));
-			if (deactivate_lv(cmd, meta_lv))
-				log_error("Failed to deactivate LV %s after zero", display_lvname(meta_lv));
-			goto bad;
-		}
-
-		if (!deactivate_lv(cmd, meta_lv)) {
-			log_error("Failed to deactivate LV %s after zero", display_lvname(meta_lv));
-			goto bad;
-		}
+		zero_lvs[zero_count++] = meta_lv;
 	}
 
+	/*
+	 * dm-integrity requires the metadata LV header to be zeroed.
+	 * Activate all new metadata LVs first so that waiting for udev
+	 * is done once for all of them and not once per image.
+	 */
+	if (!_zero_integrity_metadata_lvs(cmd, zero_lvs, zero_count))
+		goto_bad;
+
 	if (!is_active) {
 		/* checking block size of fs on the lv requires the lv to be active */
 		if (!activate_lv(cmd, lv)) {
@@ -942,20 +962,14 @@ int lv_raid_integrity_total_mismatches(struct cmd_context *cmd,
 	return 1;
 }
 
-int lv_integrity_mismatches(struct cmd_context *cmd,
-			    const struct logical_volume *lv,
-			    uint64_t *mismatches)
+static int _lv_integrity_status(struct cmd_context *cmd,
+				const struct logical_volume *lv,
+				struct dm_status_integrity *integrity)
 {
 	struct lv_with_info_and_seg_status status = {
 		.seg_status.type = SEG_STATUS_NONE,
 	};
 
-	if (lv_is_raid(lv) && lv_raid_has_integrity((struct logical_volume *)lv))
-		return lv_raid_integrity_total_mismatches(cmd, lv, mismatches);
-
-	if (!lv_is_integrity(lv))
-		return_0;
-
 	status.seg_status.seg = first_seg(lv);
 
 	/* FIXME: why reporter_pool? */
@@ -978,7 +992,7 @@ int lv_integrity_mismatches(struct cmd_context *cmd,
 		goto fail;
 	}
 
-	*mismatches = status.seg_status.integrity->number_of_mismatches;
+	*integrity = *status.seg_status.integrity;
 
 	dm_pool_destroy(status.seg_status.mem);
 	return 1;
@@ -988,6 +1002,73 @@ fail:
 	return 0;
 }
 
+int lv_integrity_mismatches(struct cmd_context *cmd,
+			    const struct logical_volume *lv,
+			    uint64_t *mismatches)
+{
+	struct dm_status_integrity integrity;
+
+	if (lv_is_raid(lv) && lv_raid_has_integrity((struct logical_volume *)lv))
+		return lv_raid_integrity_total_mismatches(cmd, lv, mismatches);
+
+	if (!lv_is_integrity(lv))
+		return_0;
+
+	if (!_lv_integrity_status(cmd, lv, &integrity))
+		return_0;
+
+	*mismatches = integrity.number_of_mismatches;
+
+	return 1;
+}
+
+/*
+ * Percentage of data the kernel has already recalculated integrity
+ * tags for.  For raid, all images are recalculated at once and the
+ * progress is summed over them.
+ */
+int lv_integrity_recalc_percent(struct cmd_context *cmd,
+				const struct logical_volume *lv,
+				dm_percent_t *percent)
+{
+	struct dm_status_integrity integrity;
+	struct lv_segment *seg;
+	uint64_t done = 0, total = 0;
+	uint32_t s;
+
+	if (lv_is_raid(lv)) {
+		if (!lv_raid_has_integrity((struct logical_volume *)lv))
+			return 0;
+
+		seg = first_seg(lv);
+
+		for (s = 0; s < seg->area_count; s++) {
+			if (!seg_is_integrity(first_seg(seg_lv(seg, s))))
+				continue;
+
+			if (!_lv_integrity_status(cmd, seg_lv(seg, s), &integrity))
+				return_0;
+
+			total += integrity.provided_data_sectors;
+			done += integrity.recalculating ? integrity.recalc_sector :
+				integrity.provided_data_sectors;
+		}
+	} else {
+		if (!lv_is_integrity(lv))
+			return 0;
+
+		if (!_lv_integrity_status(cmd, lv, &integrity))
+			return_0;
+
+		total = integrity.provided_data_sectors;
+		done = integrity.recalculating ? integrity.recalc_sector : total;
+	}
+
+	*percent = (done >= total) ? DM_PERCENT_100 : dm_make_percent(done, total);
+
+	return 1;
+}
+
 int integrity_settings_to_str_list(struct integrity_settings *settings, struct dm_list *result, struct dm_pool *mem)
 {
 	int errors = 0;
@@ -28,8 +28,8 @@ struct logical_volume {
 	struct volume_group *vg;
 
 	uint64_t status;
-	alloc_policy_t alloc;
 	struct profile *profile;
+	alloc_policy_t alloc;
 	uint32_t read_ahead;
 	int32_t major;
 	int32_t minor;
@@ -39,6 +39,8 @@ struct logical_volume {
 
 	uint32_t origin_count;
 	uint32_t external_count;
+	unsigned new_lock_args:1;
+	unsigned to_remove:1; /* set when LV is known to be removed */
 	struct dm_list snapshot_segs;
 	struct lv_segment *snapshot;
 
@@ -56,8 +58,6 @@ struct logical_volume {
 	struct generic_logical_volume *this_glv;
 
 	uint64_t timestamp;
-	unsigned new_lock_args:1;
-	unsigned to_remove:1; /* set when LV is known to be removed */
 	const char *hostname;
 	const char *lock_args;
 };
@@ -85,4 +85,39 @@ struct dm_list *build_parallel_areas_from_lv(struct logical_volume *lv,
 					     unsigned use_pvmove_parent_lv,
 					     unsigned create_single_list);
 
+/*
+ * Simulate allocations against the free space of a VG without changing it.
+ */
+struct alloc_placement {
+	struct dm_list list;
+	uint32_t area;			/* Data areas first, then log/metadata */
+	struct physical_volume *pv;
+	uint32_t pe;
+	uint32_t len;
+};
+
+struct alloc_simulation_stats {
+	uint32_t allocations;		/* Successful simulated allocations */
+	uint32_t failed;		/* Failed simulated allocations */
+	uint64_t allocated_extents;
+	uint32_t allocated_areas;	/* Contiguous ranges allocated */
+	uint64_t free_extents;
+	uint32_t free_areas;		/* Contiguous ranges left free */
+	uint32_t largest_free_area;
+	uint32_t pvs_with_free_space;
+};
+
+struct alloc_simulation;
+struct alloc_simulation *alloc_simulation_create(struct volume_group *vg,
+						 struct dm_list *allocatable_pvs);
+int alloc_simulate(struct alloc_simulation *sim, struct dm_pool *mem,
+		   const struct segment_type *segtype,
+		   uint32_t stripes, uint32_t mirrors, uint32_t log_count,
+		   uint32_t region_size, uint32_t extents,
+		   alloc_policy_t alloc, struct dm_list *pvh,
+		   struct dm_list *placement);
+void alloc_simulation_get_stats(struct alloc_simulation *sim,
+				struct alloc_simulation_stats *stats);
+void alloc_simulation_destroy(struct alloc_simulation *sim);
+
 #endif
@@ -1716,6 +1716,15 @@ static int _lv_refresh_suspend_resume(const struct logical_volume *lv)
 		return 0;
 	}
 
+	/*
+	 * Identical tables are already not reloaded: the preload inside
+	 * suspend compares each new table with the live one in the kernel
+	 * (dm_task_suppress_identical_reload) and nodes without an inactive
+	 * table are not resumed by the tree.  The suspend itself is kept
+	 * on purpose: a refresh is also used to make targets (e.g. raid)
+	 * reopen and revalidate devices that came back, even when the
+	 * metadata and thus the table did not change.
+	 */
 	if (!suspend_lv(cmd, lv)) {
 		log_error("Failed to suspend %s.", display_lvname(lv));
 		r = 0;
@@ -1825,6 +1834,7 @@ int historical_glv_remove(struct generic_logical_volume *glv)
 		}
 	}
 
+	vg_historical_lv_index_remove(hlv->vg, glvl);
 	dm_list_move(&hlv->vg->removed_historical_lvs, &glvl->list);
 	return 1;
 }
@@ -1890,6 +1900,7 @@ struct alloc_handle {
 	unsigned split_metadata_is_allocated;	/* Metadata has been allocated */
 
 	const struct dm_config_node *cling_tag_list_cn;
+	struct dm_hash_table *cling_tag_masks;	/* PV -> mask of its listed tags */
 
 	struct dm_list *parallel_areas;	/* PVs to avoid */
 
@@ -2467,20 +2478,76 @@ static int _pv_has_matching_tag(const struct dm_config_node *cling_tag_list_cn,
 	return _match_pv_tags(cling_tag_list_cn, pv1, pv1_start_pe, area_num, NULL, pv_tags, 0, NULL, 0);
 }
 
+/*
+ * Without the @* wildcard, a bit per tag in allocation/cling_tag_list
+ * is set for each of them the PV carries, so PVs without common
+ * listed tags are told apart with no string comparisons.
+ */
+#define CLING_TAG_MASK_BITS 64
+
+static struct dm_hash_table *_create_cling_tag_masks(const struct dm_config_node *cling_tag_list_cn)
+{
+	const struct dm_config_value *cv;
+	unsigned count = 0;
+
+	for (cv = cling_tag_list_cn->v; cv; cv = cv->next) {
+		if ((cv->type != DM_CFG_STRING) || (cv->v.str[0] != '@') || !cv->v.str[1])
+			continue;
+		if (!strcmp(cv->v.str + 1, "*") || (++count > CLING_TAG_MASK_BITS))
+			return NULL;
+	}
+
+	return dm_hash_create(64);
+}
+
+static const uint64_t *_cling_tag_mask(struct alloc_handle *ah, struct physical_volume *pv)
+{
+	const struct dm_config_value *cv;
+	uint64_t *mask;
+	unsigned bit = 0;
+
+	if ((mask = dm_hash_lookup_binary(ah->cling_tag_masks, &pv, sizeof(pv))))
+		return mask;
+
+	if (!(mask = dm_pool_zalloc(ah->mem, sizeof(*mask))))
+		return_NULL;
+
+	for (cv = ah->cling_tag_list_cn->v; cv; cv = cv->next) {
+		if ((cv->type != DM_CFG_STRING) || (cv->v.str[0] != '@') || !cv->v.str[1])
+			continue;
+		if (str_list_match_item(&pv->tags, cv->v.str + 1))
+			*mask |= UINT64_C(1) << bit;
+		bit++;
+	}
+
+	if (!dm_hash_insert_binary(ah->cling_tag_masks, &pv, sizeof(pv), mask))
+		return_NULL;
+
+	return mask;
+}
+
 /*
  * Does PV area have a tag listed in allocation/cling_tag_list that
  * matches a tag of the PV of the existing segment?
  */
-static int _pvs_have_matching_tag(const struct dm_config_node *cling_tag_list_cn,
+static int _pvs_have_matching_tag(struct alloc_handle *ah,
 				  struct physical_volume *pv1, struct physical_volume *pv2,
 				  unsigned parallel_pv)
 {
-	return _match_pv_tags(cling_tag_list_cn, pv1, 0, 0, pv2, NULL, 0, NULL, parallel_pv);
+	const uint64_t *mask1, *mask2;
+
+	if (ah->cling_tag_masks &&
+	    (mask1 = _cling_tag_mask(ah, pv1)) &&
+	    (mask2 = _cling_tag_mask(ah, pv2)) &&
+	    !(*mask1 & *mask2))
+		return 0;
+
+	return _match_pv_tags(ah->cling_tag_list_cn, pv1, 0, 0, pv2, NULL, 0, NULL, parallel_pv);
 }
 
 static int _has_matching_pv_tag(struct pv_match *pvmatch, struct pv_segment *pvseg, struct pv_area *pva)
 {
-	return _pvs_have_matching_tag(pvmatch->cling_tag_list_cn, pvseg->pv, pva->map->pv, 0);
+	return _pvs_have_matching_tag(pvmatch->ah, pvseg->pv, pva->map->pv, 0);
 }
 
 static int _log_parallel_areas(struct dm_pool *mem, struct dm_list *parallel_areas,
@@ -2747,7 +2814,7 @@ static int _check_cling_to_alloced(struct alloc_handle *ah, const struct dm_conf
 			continue;	/* Area already assigned */
 		dm_list_iterate_items(aa, &ah->alloced_areas[s]) {
 			if ((!cling_tag_list_cn && (pva->map->pv == aa[0].pv)) ||
-			    (cling_tag_list_cn && _pvs_have_matching_tag(cling_tag_list_cn, pva->map->pv, aa[0].pv, 0))) {
+			    (cling_tag_list_cn && _pvs_have_matching_tag(ah, pva->map->pv, aa[0].pv, 0))) {
 				if (positional &&
 				    !_reserve_required_area(ah, alloc_state, pva, pva->count, s, 0))
 					return_0;
@@ -2759,7 +2826,7 @@ static int _check_cling_to_alloced(struct alloc_handle *ah, const struct dm_conf
 	return 0;
 }
 
-static int _pv_is_parallel(struct physical_volume *pv, struct dm_list *parallel_pvs, const struct dm_config_node *cling_tag_list_cn)
+static int _pv_is_parallel(struct alloc_handle *ah, struct physical_volume *pv, struct dm_list *parallel_pvs)
 {
 	struct pv_list *pvl;
 
@@ -2769,7 +2836,7 @@ static int _pv_is_parallel(struct physical_volume *pv, struct dm_list *parallel_
 					pv_dev_name(pvl->pv));
 			return 1;
 		}
-		if (cling_tag_list_cn && _pvs_have_matching_tag(cling_tag_list_cn, pvl->pv, pv, 1))
+		if (ah->cling_tag_list_cn && _pvs_have_matching_tag(ah, pvl->pv, pv, 1))
 			return 1;
 	}
 
@@ -3061,7 +3128,7 @@ static int _find_some_parallel_space(struct alloc_handle *ah,
 				/* FIXME Split into log and non-log parallel_pvs and only check the log ones if log_iteration? */
 				/* (I've temporatily disabled the check.) */
 				/* Avoid PVs used by existing parallel areas */
-				if (!log_iteration_count && parallel_pvs && _pv_is_parallel(pvm->pv, parallel_pvs, ah->cling_tag_list_cn))
+				if (!log_iteration_count && parallel_pvs && _pv_is_parallel(ah, pvm->pv, parallel_pvs))
 					goto next_pv;
 
 				/*
@@ -3340,16 +3407,14 @@ static int _find_max_parallel_space_for_one_policy(struct alloc_handle *ah, stru
  * If mirrored_pv and mirrored_pe are supplied, it is used as
  * the first area, and additional areas are allocated parallel to it.
  */
-static int _allocate(struct alloc_handle *ah,
-		     struct volume_group *vg,
-		     struct logical_volume *lv,
-		     unsigned can_split,
-		     struct dm_list *allocatable_pvs)
+static int _allocate_from_pv_maps(struct alloc_handle *ah,
+				  struct logical_volume *lv,
+				  unsigned can_split,
+				  struct dm_list *pvms)
 {
 	uint32_t old_allocated;
 	struct lv_segment *prev_lvseg = NULL;
 	int r = 0;
-	struct dm_list *pvms;
 	alloc_policy_t alloc;
 	struct alloc_parms alloc_parms;
 	struct alloc_state alloc_state;
@@ -3376,11 +3441,6 @@ static int _allocate(struct alloc_handle *ah,
 
 	if (lv)
 		prev_lvseg = last_seg(lv);
-	/*
-	 * Build the sets of available areas on the pv's.
-	 */
-	if (!(pvms = create_pv_maps(ah->mem, vg, allocatable_pvs)))
-		return_0;
 
 	if (!_log_parallel_areas(ah->mem, ah->parallel_areas, ah->cling_tag_list_cn))
 		stack;
@@ -3490,6 +3550,23 @@ static int _allocate(struct alloc_handle *ah,
 	return r;
 }
 
+static int _allocate(struct alloc_handle *ah,
+		     struct volume_group *vg,
+		     struct logical_volume *lv,
+		     unsigned can_split,
+		     struct dm_list *allocatable_pvs)
+{
+	struct dm_list *pvms;
+
+	/*
+	 * Build the sets of available areas on the pv's.
+	 */
+	if (!(pvms = create_pv_maps(ah->mem, vg, allocatable_pvs)))
+		return_0;
+
+	return _allocate_from_pv_maps(ah, lv, can_split, pvms);
+}
+
 /*
  * FIXME: Add proper allocation function for VDO segment on top
  *        of VDO pool with virtual size.
@@ -3731,8 +3808,10 @@ static struct alloc_handle *_alloc_init(struct cmd_context *cmd,
 
 	ah->parallel_areas = parallel_areas;
 
-	if ((ah->cling_tag_list_cn = find_config_tree_array(cmd, allocation_cling_tag_list_CFG, NULL)))
+	if ((ah->cling_tag_list_cn = find_config_tree_array(cmd, allocation_cling_tag_list_CFG, NULL))) {
 		(void) _validate_tag_list(ah->cling_tag_list_cn);
+		ah->cling_tag_masks = _create_cling_tag_masks(ah->cling_tag_list_cn);
+	}
 
 	ah->maximise_cling = find_config_tree_bool(cmd, allocation_maximise_cling_CFG, NULL);
 
@@ -3743,8 +3822,11 @@ static struct alloc_handle *_alloc_init(struct cmd_context *cmd,
 
 void alloc_destroy(struct alloc_handle *ah)
 {
-	if (ah)
+	if (ah) {
+		if (ah->cling_tag_masks)
+			dm_hash_destroy(ah->cling_tag_masks);
 		dm_pool_destroy(ah->mem);
+	}
 }
 
 /*
@@ -3799,6 +3881,237 @@ struct alloc_handle *allocate_extents(struct volume_group *vg,
 	return ah;
 }
 
+/*
+ * Allocation simulation.
+ *
+ * The free space of the allocatable PVs is mapped once and each simulated
+ * allocation consumes its extents from that map with the same policies as
+ * allocate_extents(), so a sequence of hypothetical LVs can be placed
+ * without any change to the VG.
+ */
+struct alloc_simulation {
+	struct volume_group *vg;
+	struct dm_pool *mem;
+	struct dm_list *allocatable_pvs;
+	struct dm_list *pvms;
+	struct dm_list placed;		/* struct alloc_placement of all allocations */
+	struct alloc_simulation_stats stats;
+};
+
+static int _comp_placement_pe(const void *l, const void *r)
+{
+	const struct alloc_placement *ap_l = *(const struct alloc_placement * const *) l;
+	const struct alloc_placement *ap_r = *(const struct alloc_placement * const *) r;
+
+	return (ap_l->pe < ap_r->pe) ? -1 : (ap_l->pe > ap_r->pe);
+}
+
+static int _alloc_simulation_map(struct alloc_simulation *sim)
+{
+	struct alloc_placement *ap, **aps;
+	struct pv_area *pva;
+	struct pv_map *pvm;
+	unsigned i, nr = 0;
+
+	if (!(sim->pvms = create_pv_maps(sim->mem, sim->vg, sim->allocatable_pvs)))
+		return_0;
+
+	if (!(nr = dm_list_size(&sim->placed)))
+		return 1;
+
+	if (!(aps = malloc(nr * sizeof(*aps)))) {
+		log_error("Allocation simulation replay allocation failed.");
+		return 0;
+	}
+
+	nr = 0;
+	dm_list_iterate_items(ap, &sim->placed)
+		aps[nr++] = ap;
+
+	/*
+	 * Replay the allocations so far. Extents are always taken from
+	 * the start of a free area, so in ascending order each placement
+	 * starts an area again.
+	 */
+	qsort(aps, nr, sizeof(*aps), _comp_placement_pe);
+
+	for (i = 0; i < nr; i++)
+		dm_list_iterate_items(pvm, sim->pvms) {
+			if (pvm->pv != aps[i]->pv)
+				continue;
+			dm_list_iterate_items(pva, &pvm->areas)
+				if (pva->start == aps[i]->pe) {
+					consume_pv_area(pva, aps[i]->len);
+					break;
+				}
+			break;
+		}
+
+	free(aps);
+
+	return 1;
+}
+
+struct alloc_simulation *alloc_simulation_create(struct volume_group *vg,
+						 struct dm_list *allocatable_pvs)
+{
+	struct alloc_simulation *sim;
+	struct dm_pool *mem;
+
+	if (!(mem = dm_pool_create("allocation simulation", 1024))) {
+		log_error("Allocation simulation pool creation failed.");
+		return NULL;
+	}
+
+	if (!(sim = dm_pool_zalloc(mem, sizeof(*sim)))) {
+		log_error("Allocation simulation allocation failed.");
+		dm_pool_destroy(mem);
+		return NULL;
+	}
+
+	sim->vg = vg;
+	sim->mem = mem;
+	sim->allocatable_pvs = allocatable_pvs ? : &vg->pvs;
+	dm_list_init(&sim->placed);
+
+	if (!_alloc_simulation_map(sim)) {
+		dm_pool_destroy(mem);
+		return_NULL;
+	}
+
+	return sim;
+}
+
+/*
+ * Simulate the allocation of the data and log/metadata areas of a new LV.
+ * Only the PVs in pvh, if given, are used. On success the allocated areas
+ * are consumed and, if placement is given, appended to it as struct
+ * alloc_placement allocated from mem.
+ */
+int alloc_simulate(struct alloc_simulation *sim, struct dm_pool *mem,
+		   const struct segment_type *segtype,
+		   uint32_t stripes, uint32_t mirrors, uint32_t log_count,
+		   uint32_t region_size, uint32_t extents,
+		   alloc_policy_t alloc, struct dm_list *pvh,
+		   struct dm_list *placement)
+{
+	struct volume_group *vg = sim->vg;
+	struct alloc_handle *ah = NULL;
+	struct alloc_placement *ap;
+	struct alloced_area *aa;
+	struct pv_map *pvm, *tmp;
+	struct dm_list unused;
+	uint32_t s, area_count;
+	int r = 0;
+
+	dm_list_init(&unused);
+
+	if (segtype_is_virtual(segtype)) {
+		log_error("Cannot simulate allocation of virtual segments.");
+		return 0;
+	}
+
+	if (vg->fid && vg->fid->fmt->ops->segtype_supported &&
+	    !vg->fid->fmt->ops->segtype_supported(vg->fid, segtype)) {
+		log_error("Metadata format (%s) does not support required "
+			  "LV segment type (%s).", vg->fid->fmt->name,
+			  segtype->name);
+		return 0;
+	}
+
+	if (alloc >= ALLOC_INHERIT)
+		alloc = vg->alloc;
+
+	if (!(ah = _alloc_init(vg->cmd, segtype, alloc, 0, 0, extents,
+			       mirrors, stripes, log_count, vg->extent_size,
+			       region_size, NULL)))
+		goto_out;
+
+	/* Hide the maps of PVs not listed for this allocation. */
+	if (pvh)
+		dm_list_iterate_items_safe(pvm, tmp, sim->pvms)
+			if (!find_pv_in_pv_list(pvh, pvm->pv))
+				dm_list_move(&unused, &pvm->list);
+
+	r = _allocate_from_pv_maps(ah, NULL, 1, sim->pvms);
+
+	dm_list_splice(sim->pvms, &unused);
+
+	if (!r) {
+		sim->stats.failed++;
+		/* Extents of a failed attempt may be already consumed. */
+		if (!_alloc_simulation_map(sim))
+			stack;
+		goto out;
+	}
+
+	/* Same count of area lists as set up by _alloc_init(). */
+	area_count = ah->area_count + ah->parity_count;
+	if (segtype_is_raid(segtype) && log_count)
+		area_count *= 2;
+	else
+		area_count += log_count;
+
+	for (s = 0; s < area_count; s++)
+		dm_list_iterate_items(aa, &ah->alloced_areas[s]) {
+			if (!(ap = dm_pool_zalloc(sim->mem, sizeof(*ap)))) {
+				log_error("Allocation simulation placement allocation failed.");
+				r = 0;
+				goto out;
+			}
+			ap->area = s;
+			ap->pv = aa->pv;
+			ap->pe = aa->pe;
+			ap->len = aa->len;
+			dm_list_add(&sim->placed, &ap->list);
+			sim->stats.allocated_extents += aa->len;
+			sim->stats.allocated_areas++;
+
+			if (!placement)
+				continue;
+
+			if (!(ap = dm_pool_alloc(mem, sizeof(*ap)))) {
+				log_error("Allocation simulation placement allocation failed.");
+				r = 0;
+				goto out;
+			}
+			*ap = *dm_list_item(sim->placed.p, struct alloc_placement);
+			dm_list_add(placement, &ap->list);
+		}
+
+	sim->stats.allocations++;
+out:
+	alloc_destroy(ah);
+
+	return r;
+}
+
+void alloc_simulation_get_stats(struct alloc_simulation *sim,
+				struct alloc_simulation_stats *stats)
+{
+	struct pv_area *pva;
+	struct pv_map *pvm;
+
+	*stats = sim->stats;
+
+	dm_list_iterate_items(pvm, sim->pvms) {
+		if (pvm->pe_count)
+			stats->pvs_with_free_space++;
+		dm_list_iterate_items(pva, &pvm->areas) {
+			stats->free_extents += pva->count;
+			stats->free_areas++;
+			if (pva->count > stats->largest_free_area)
+				stats->largest_free_area = pva->count;
+		}
+	}
+}
+
+void alloc_simulation_destroy(struct alloc_simulation *sim)
+{
+	if (sim)
+		dm_pool_destroy(sim->mem);
+}
+
 /*
  * Add new segments to an LV from supplied list of areas.
  */
@@ -3899,7 +4212,7 @@ int lv_add_segmented_mirror_image(struct alloc_handle *ah,
 {
 	char *image_name;
 	struct alloced_area *aa;
-	struct lv_segment *seg, *new_seg;
+	struct lv_segment *seg = NULL, *new_seg;
 	uint32_t current_le = le;
 	uint32_t s;
 	struct segment_type *segtype;
@@ -3924,7 +4237,7 @@ int lv_add_segmented_mirror_image(struct alloc_handle *ah,
 	 * split up to match.
 	 */
 	dm_list_iterate_items(aa, &ah->alloced_areas[0]) {
-		if (!(seg = find_seg_by_le(lv, current_le))) {
+		if (!(seg = find_seg_by_le_from(lv, seg, current_le))) {
 			log_error("Failed to find segment for %s extent " FMTu32 ".",
 				  display_lvname(lv), current_le);
 			return 0;
@@ -3965,8 +4278,9 @@ int lv_add_segmented_mirror_image(struct alloc_handle *ah,
 	if (!(segtype = get_segtype_from_string(lv->vg->cmd, SEG_TYPE_NAME_STRIPED)))
 		return_0;
 
+	seg = NULL;
 	dm_list_iterate_items(aa, &ah->alloced_areas[0]) {
-		if (!(seg = find_seg_by_le(orig_lv, current_le))) {
+		if (!(seg = find_seg_by_le_from(orig_lv, seg, current_le))) {
 			log_error("Failed to find segment for %s extent " FMTu32 ".",
 				  display_lvname(lv), current_le);
 			return 0;
@@ -4008,12 +4322,12 @@ int lv_add_mirror_areas(struct alloc_handle *ah,
 			uint32_t region_size)
 {
 	struct alloced_area *aa;
-	struct lv_segment *seg;
+	struct lv_segment *seg = NULL;
 	uint32_t current_le = le;
 	uint32_t s, old_area_count, new_area_count;
 
 	dm_list_iterate_items(aa, &ah->alloced_areas[0]) {
-		if (!(seg = find_seg_by_le(lv, current_le))) {
+		if (!(seg = find_seg_by_le_from(lv, seg, current_le))) {
 			log_error("Failed to find segment for %s extent " FMTu32 ".",
 				  display_lvname(lv), current_le);
 			return 0;
@@ -6610,7 +6924,8 @@ static int _fs_extend(struct cmd_context *cmd, struct logical_volume *lv,
 	 */
 	unlock_vg(cmd, lv->vg, lv->vg->name);
 
-	if (!fs_extend_script(cmd, lv, &fsinfo, newsize_bytes_fs, lp->fsmode))
+	if (!fs_extend_online(cmd, lv, &fsinfo, newsize_bytes_fs) &&
+	    !fs_extend_script(cmd, lv, &fsinfo, newsize_bytes_fs, lp->fsmode))
 		goto_out;
 
 	ret = 1;
@@ -7425,7 +7740,7 @@ struct dm_list *build_parallel_areas_from_lv(struct logical_volume *lv,
 		spvs->len = lv->le_count - current_le;
 
 		if (use_pvmove_parent_lv &&
-		    !(seg = find_seg_by_le(lv, current_le))) {
+		    !(seg = find_seg_by_le_from(lv, seg, current_le))) {
 			log_error("Failed to find segment for %s extent %" PRIu32,
 				  lv->name, current_le);
 			return 0;
@@ -7742,15 +8057,22 @@ int lv_remove_single(struct cmd_context *cmd, struct logical_volume *lv,
 		return 0;
 	}
 
-	if (!pool_lv && (!strcmp(cmd->name, "lvremove") || !strcmp(cmd->name, "vgremove"))) {
-		/* With lvremove & vgremove try to postpone commit after last such LV */
+	/*
+	 * With lvremove & vgremove try to postpone commit after last such LV.
+	 * Messages of removed thin LVs then stay queued in the pool and are
+	 * sent all at once by update_thin_pools_with_messages() after that
+	 * commit, unless pool update failures are to be ignored (-ff) or
+	 * the pool is locked through lvmlockd.
+	 */
+	if ((!strcmp(cmd->name, "lvremove") || !strcmp(cmd->name, "vgremove")) &&
+	    (!pool_lv || ((force < DONT_PROMPT_OVERRIDE) && !vg_is_shared(vg)))) {
 		vg->needs_write_and_commit = 1;
 		log_debug_metadata("Postponing write and commit.");
+		pool_lv = NULL;
 	} else if (!vg_write(vg) || !vg_commit(vg))  /* store it on disks */
 		return_0;
 
 	/* Release unneeded blocks in thin pool */
-	/* TODO: defer when multiple LVs relased at once */
 	if (pool_lv && !update_thin_pool_lv(pool_lv, 1)) {
 		if (force < DONT_PROMPT_OVERRIDE) {
 			log_error("Failed to update thin pool %s.", display_lvname(pool_lv));
@@ -7979,6 +8301,12 @@ static int _lv_update_and_reload(struct logical_volume *lv, int origin_only)
 		origin_only = 0;
 	}
 
+	/*
+	 * The new metadata is already written, so I/O is only frozen for the
+	 * commit.  The lock holder's tree contains every stacked sub LV, so
+	 * one suspend and one resume cover them all (thin volumes stay live
+	 * while their pool is resized).
+	 */
 	if (!(origin_only ? suspend_lv_origin(vg->cmd, lock_lv) : suspend_lv(vg->cmd, lock_lv))) {
 		log_error("Failed to suspend logical volume %s.",
 			  display_lvname(lock_lv));
@@ -8108,7 +8436,7 @@ int remove_layers_for_segments(struct cmd_context *cmd,
 			       struct logical_volume *layer_lv,
 			       uint64_t status_mask, struct dm_list *lvs_changed)
 {
-	struct lv_segment *seg, *lseg;
+	struct lv_segment *seg, *lseg = NULL;
 	uint32_t s;
 	int lv_changed = 0;
 	struct lv_list *lvl;
@@ -8124,7 +8452,7 @@ int remove_layers_for_segments(struct cmd_context *cmd,
 				continue;
 
 			/* Find the layer segment pointed at */
-			if (!(lseg = find_seg_by_le(layer_lv, seg_le(seg, s)))) {
+			if (!(lseg = find_seg_by_le_from(layer_lv, lseg, seg_le(seg, s)))) {
 				log_error("Layer segment found: %s:%" PRIu32,
 					  layer_lv->name, seg_le(seg, s));
 				return 0;
@@ -8804,6 +9132,14 @@ int wipe_lv(struct logical_volume *lv, struct wipe_params wp)
 			/* TODO: maybe integrate with bcache_zero_set() */
 			const uint64_t end = zero_sectors << SECTOR_SHIFT;
 			uint64_t range[2] = { 0, 1024 * 1024 }; /* zeroing with 1M steps (for better ^C support) */
+			/*
+			 * Devices offloading write zeroes finish much bigger
+			 * requests in the same time, so use their limit.
+			 */
+			uint64_t wz_bytes = (uint64_t) dev_write_zeroes_max_bytes(lv->vg->cmd->dev_types, dev) << SECTOR_SHIFT;
+
+			if (wz_bytes > range[1])
+				range[1] = (wz_bytes < (UINT64_C(64) << 20)) ? wz_bytes : (UINT64_C(64) << 20);
 			for (/* empty */ ; range[0] < end; range[0] += range[1]) {
 				if ((range[0] + range[1]) > end)
 					range[1] = end - range[0];
@@ -8898,6 +9234,11 @@ int activate_and_wipe_lvlist(struct dm_list *lv_list, int commit)
 			lvl->lv->status &= ~LV_TEMPORARY;
 		}
 
+	/*
+	 * All activations above share one udev cookie, so the first
+	 * wipe_lv() waits for udev once for the whole list and the
+	 * following ones find nothing left to sync.
+	 */
 	dm_list_iterate_items(lvl, lv_list) {
 		/* Wipe any know signatures */
 		if (!wipe_lv(lvl->lv, (struct wipe_params) { .do_zero = 1 /* TODO: is_metadata = 1 */ })) {
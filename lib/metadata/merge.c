@@ -605,12 +605,101 @@ static void _check_lv_segment(struct logical_volume *lv, struct lv_segment *seg,
 	}
 }
 
+/* Lists of segments using an LV at least this long get hashed. */
+#define LV_USERS_HASH_MIN 64
+
+struct lv_user_key {
+	const struct logical_volume *lv;
+	const struct lv_segment *seg;
+};
+
 /*
- * Verify that an LV's segments are consecutive, complete and don't overlap.
+ * Each segment using an LV in an area must be listed in the LV's
+ * segs_using_this_lv, which is walked for every such area.  An LV used
+ * by many segments, e.g. the pvmove LV, makes checking all LVs of the VG
+ * quadratic, so hash those lists by LV and segment, counting the entries.
+ *
+ * Returns NULL when no list is long enough (or on failure), and the
+ * lists are then walked.
  */
+struct dm_hash_table *create_lv_users_hash(struct volume_group *vg)
+{
+	struct dm_hash_table *users = NULL;
+	struct lv_user_key key;
+	struct lv_list *lvl;
+	struct seg_list *sl;
+	unsigned len;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		len = 0;
+		dm_list_iterate_items(sl, &lvl->lv->segs_using_this_lv)
+			if (++len >= LV_USERS_HASH_MIN)
+				break;
+
+		if (len < LV_USERS_HASH_MIN)
+			continue;
+
+		if (!users && !(users = dm_hash_create(1024))) {
+			log_error("Failed to allocate LV users hash.");
+			return NULL;
+		}
+
+		memset(&key, 0, sizeof(key));
+		key.lv = lvl->lv;
+		dm_list_iterate_items(sl, &lvl->lv->segs_using_this_lv) {
+			key.seg = sl->seg;
+			if (!dm_hash_insert_binary(users, &key, sizeof(key),
+						   (char *)dm_hash_lookup_binary(users, &key, sizeof(key)) + 1)) {
+				log_error("Failed to hash LV user.");
+				dm_hash_destroy(users);
+				return NULL;
+			}
+		}
+	}
+
+	return users;
+}
+
 int check_lv_segments(struct logical_volume *lv, int complete_vg)
+{
+	return check_lv_segments_users(lv, complete_vg, NULL);
+}
+
+/*
+ * Number of entries for seg in segs_using_this_lv of lv.
+ */
+static unsigned _count_lv_user(struct logical_volume *lv, struct lv_segment *seg,
+			       struct dm_hash_table *users)
+{
+	struct lv_user_key key;
+	struct seg_list *sl;
+	unsigned count = 0;
+
+	if (users) {
+		memset(&key, 0, sizeof(key));
+		key.lv = lv;
+		key.seg = seg;
+		/* Not found also for lists not hashed, walk those. */
+		if ((count = (unsigned)(uintptr_t)dm_hash_lookup_binary(users, &key, sizeof(key))))
+			return count;
+	}
+
+	dm_list_iterate_items(sl, &lv->segs_using_this_lv)
+		if (sl->seg == seg)
+			count++;
+
+	return count;
+}
+
+/*
+ * Verify that an LV's segments are consecutive, complete and don't overlap.
+ */
+int check_lv_segments_users(struct logical_volume *lv, int complete_vg,
+			    struct dm_hash_table *users)
 {
 	struct lv_segment *seg, *seg2;
+	/* Segments of the mirror images found for the previous segment */
+	struct lv_segment *mimage_segs[DEFAULT_MIRROR_MAX_IMAGES] = { 0 };
 	uint32_t le = 0;
 	unsigned seg_count = 0, seg_found, external_lv_found = 0;
 	uint32_t data_rimage_count, s;
@@ -682,14 +771,20 @@ int check_lv_segments(struct logical_volume *lv, int complete_vg)
 				}
 
 				if (complete_vg && seg_lv(seg, s) &&
-				    lv_is_mirror_image(seg_lv(seg, s)) &&
-				    (!(seg2 = find_seg_by_le(seg_lv(seg, s),
-							    seg_le(seg, s))) ||
-				     find_mirror_seg(seg2) != seg)) {
-					log_error("LV %s: segment %u mirror "
-						  "image %u missing mirror ptr",
-						  lv->name, seg_count, s);
-					inc_error_count;
+				    lv_is_mirror_image(seg_lv(seg, s))) {
+					/* Images are walked in LE order, continue from the last segment */
+					seg2 = find_seg_by_le_from(seg_lv(seg, s),
+								   (s < DM_ARRAY_SIZE(mimage_segs)) ? mimage_segs[s] : NULL,
+								   seg_le(seg, s));
+					if (s < DM_ARRAY_SIZE(mimage_segs))
+						mimage_segs[s] = seg2;
+
+					if (!seg2 || find_mirror_seg(seg2) != seg) {
+						log_error("LV %s: segment %u mirror "
+							  "image %u missing mirror ptr",
+							  lv->name, seg_count, s);
+						inc_error_count;
+					}
 				}
 
 /* FIXME I don't think this ever holds?
@@ -701,10 +796,7 @@ int check_lv_segments(struct logical_volume *lv, int complete_vg)
 					inc_error_count;
 				}
  */
-				seg_found = 0;
-				dm_list_iterate_items(sl, &seg_lv(seg, s)->segs_using_this_lv)
-					if (sl->seg == seg)
-						seg_found++;
+				seg_found = _count_lv_user(seg_lv(seg, s), seg, users);
 
 				if (!seg_found) {
 					log_error("LV %s segment %u uses LV %s,"
@@ -193,6 +193,7 @@
 #define PROCESS_SKIP_SCAN	0x00200000U /* skip lvmcache_label_scan in process_each_pv */
 #define READ_FOR_ACTIVATE	0x00400000U /* command tells vg_read it plans to activate the vg */
 #define READ_WITHOUT_LOCK	0x00800000U /* caller responsible for vg lock */
+#define PROCESS_VG_SUMMARY	0x01000000U /* process_each_vg may use the scan summary instead of vg_read */
 
 /* vg_read returns these in error_flags */
 #define FAILED_NOT_ENABLED	0x00000001U
@@ -458,13 +459,13 @@ struct format_instance {
 /* There will be one area for each stripe */
 struct lv_segment_area {
 	area_type_t type;
+	uint32_t le;		/* For AREA_LV: first extent used in u.lv.lv */
 	union {
 		struct {
 			struct pv_segment *pvseg;
 		} pv;
 		struct {
 			struct logical_volume *lv;
-			uint32_t le;
 		} lv;
 	} u;
 };
@@ -481,51 +482,54 @@ struct lv_thin_message {
 struct segment_type;
 
 struct lv_segment {
+	/* Fields used when walking segments and their areas come first */
 	struct dm_list list;
 	struct logical_volume *lv;
 
 	const struct segment_type *segtype;
 	uint32_t le;
 	uint32_t len;
-	uint32_t reshape_len;   /* For RAID: user hidden additional out of place reshaping length off area_len and len */
 
 	uint64_t status;
 
+	uint32_t area_count;
+	uint32_t area_len;
+	struct lv_segment_area *areas;
+
 	/* FIXME Fields depend on segment type */
+	uint32_t reshape_len;   /* For RAID: user hidden additional out of place reshaping length off area_len and len */
 	uint32_t stripe_size;	/* For stripe and RAID - in sectors */
 	uint32_t writebehind;   /* For RAID (RAID1 only) */
 	uint32_t min_recovery_rate; /* For RAID */
 	uint32_t max_recovery_rate; /* For RAID */
 	uint32_t data_offset;	/* For RAID: data offset in sectors on each data component image */
-	uint32_t area_count;
-	uint32_t area_len;
 	uint32_t chunk_size;	/* For snapshots/thin_pool.  In sectors. */
 				/* For thin_pool, 128..2097152. */
+	uint32_t region_size;	/* For raids/mirrors - in sectors */
+	uint32_t data_copies;	/* For RAID: number of data copies (e.g. 3 for RAID 6 */
+	uint32_t extents_copied;/* Number of extents synced for raids/mirrors */
 	struct logical_volume *origin;	/* snap and thin */
 	struct generic_logical_volume *indirect_origin;
 	struct logical_volume *merge_lv; /* thin, merge descendent lv into this ancestor */
 	struct logical_volume *cow;
 	struct dm_list origin_list;
-	uint32_t region_size;	/* For raids/mirrors - in sectors */
-	uint32_t data_copies;	/* For RAID: number of data copies (e.g. 3 for RAID 6 */
-	uint32_t extents_copied;/* Number of extents synced for raids/mirrors */
 	struct logical_volume *log_lv;
 	struct lv_segment *pvmove_source_seg;
 	void *segtype_private;
 
 	struct dm_list tags;
 
-	struct lv_segment_area *areas;
 	struct lv_segment_area *meta_areas;	/* For RAID */
 	struct logical_volume *metadata_lv;	/* For thin_pool */
 	uint64_t transaction_id;		/* For thin_pool, thin */
 	thin_zero_t zero_new_blocks;		/* For thin_pool */
 	thin_discards_t discards;		/* For thin_pool */
 	thin_crop_metadata_t crop_metadata;	/* For thin_pool */
+	uint32_t device_id;			/* For thin, 24bit */
+	uint32_t device_id_max;			/* For thin_pool, highest used device_id, 0 unknown */
 	struct dm_list thin_messages;		/* For thin_pool */
 	struct logical_volume *external_lv;	/* For thin */
 	struct logical_volume *pool_lv;		/* For thin, cache */
-	uint32_t device_id;			/* For thin, 24bit */
 
 	uint64_t metadata_start;		/* For cache */
 	uint64_t metadata_len;			/* For cache */
@@ -540,8 +544,8 @@ struct lv_segment {
 	struct dm_config_node *policy_settings;	/* For cache_pool */
 	unsigned cleaner_policy;		/* For cache */
 
-	struct logical_volume *writecache;	/* For writecache */
 	uint32_t writecache_block_size;		/* For writecache */
+	struct logical_volume *writecache;	/* For writecache */
 	struct writecache_settings writecache_settings; /* For writecache */
 
 	uint64_t integrity_data_sectors;
@@ -549,9 +553,9 @@ struct lv_segment {
 	struct integrity_settings integrity_settings;
 	uint32_t integrity_recalculate;
 
-	struct dm_vdo_target_params vdo_params;	/* For VDO-pool */
 	uint32_t vdo_pool_header_size;		/* For VDO-pool */
 	uint32_t vdo_pool_virtual_extents;	/* For VDO-pool */
+	struct dm_vdo_target_params vdo_params;	/* For VDO-pool */
 };
 
 #define seg_type(seg, s)	(seg)->areas[(s)].type
@@ -760,6 +764,10 @@ struct volume_group *vg_read_orphans(struct cmd_context *cmd, const char *orphan
 struct physical_volume *pv_create(const struct cmd_context *cmd,
 				  struct device *dev, struct pv_create_args *pva);
 
+/*
+ * The VG of a non-orphan PV is not written: the change is left for the
+ * caller to commit with vg->needs_write_and_commit set.
+ */
 int pv_resize_single(struct cmd_context *cmd,
 			     struct volume_group *vg,
 			     struct physical_volume *pv,
@@ -888,6 +896,7 @@ int thin_pool_prepare_metadata(struct logical_volume *metadata_lv,
 			       uint64_t data_begin,
 			       uint64_t data_length);
 int update_thin_pool_lv(struct logical_volume *lv, int activate);
+int update_thin_pools_with_messages(struct volume_group *vg);
 
 int recalculate_pool_chunk_size_with_dev_hints(struct logical_volume *pool_lv,
 					       struct logical_volume *pool_data_lv,
@@ -1357,6 +1366,7 @@ int cache_vol_set_params(struct cmd_context *cmd,
                      const char *policy,
                      const struct dm_config_tree *settings);
 void cache_check_for_warns(const struct lv_segment *seg);
+const char *cache_tuning_hint(struct dm_pool *mem, const struct dm_status_cache *c);
 int update_cache_pool_params(struct cmd_context *cmd,
 			     struct profile *profile,
 			     uint32_t extent_size,
@@ -1385,6 +1395,8 @@ struct lv_status_vdo {
 	/* grabbed from DM stats message, /sys/block/dm-/vdo or /sys/kvdo */
 	uint64_t data_blocks_used;
 	uint64_t logical_blocks_used;
+	/* full DM stats message, values not reported are UINT64_MAX */
+	struct dm_vdo_stats stats;
 	dm_percent_t usage;
 	dm_percent_t saving;
 	dm_percent_t data_usage;
@@ -1511,6 +1523,7 @@ int lv_get_raid_integrity_settings(struct logical_volume *lv, struct integrity_s
 int integrity_mode_set(const char *mode, struct integrity_settings *settings);
 int lv_integrity_mismatches(struct cmd_context *cmd, const struct logical_volume *lv, uint64_t *mismatches);
 int lv_raid_integrity_total_mismatches(struct cmd_context *cmd, const struct logical_volume *lv, uint64_t *mismatches);
+int lv_integrity_recalc_percent(struct cmd_context *cmd, const struct logical_volume *lv, dm_percent_t *percent);
 
 int setting_str_list_add(const char *field, uint64_t val, char *val_str, struct dm_list *result, struct dm_pool *mem);
 
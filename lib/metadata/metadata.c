@@ -34,6 +34,7 @@
 #include "lib/config/defaults.h"
 #include "lib/locking/lvmlockd.h"
 #include "lib/notify/lvmnotify.h"
+#include "lib/misc/lvm-timing.h"
 
 #include <time.h>
 #include <math.h>
@@ -674,6 +675,10 @@ int vg_remove_direct(struct volume_group *vg)
 	lockd_vg_update(vg);
 
 	set_vg_notify(vg->cmd);
+	set_notify_vg(vg);
+
+	/* Don't recreate the backup on unlock */
+	vg->needs_backup = 0;
 
 	if (!backup_remove(vg->cmd, vg->name))
 		stack;
@@ -998,6 +1003,7 @@ static void _vg_move_cached_precommitted_to_committed(struct volume_group *vg)
 	release_vg(vg->vg_committed);
 	vg->vg_committed = vg->vg_precommitted;
 	vg->vg_precommitted = NULL;
+	vg->committed_copy_deferred = 0;
 	vg->needs_backup = 1;
 }
 
@@ -1213,6 +1219,22 @@ static dm_bitset_t _bitset_with_random_bits(struct dm_pool *mem, uint32_t num_bi
 	return bs;
 }
 
+/*
+ * Does the device of mda hold another mda of the VG that is in use?
+ */
+static int _mda_dev_has_other_used(struct volume_group *vg, struct metadata_area *mda)
+{
+	struct device *dev = mda_get_device(mda);
+	struct metadata_area *mda2;
+
+	dm_list_iterate_items(mda2, &vg->fid->metadata_areas_in_use)
+		if ((mda2 != mda) && !mda_is_ignored(mda2) &&
+		    (mda_get_device(mda2) == dev))
+			return 1;
+
+	return 0;
+}
+
 static int _vg_ignore_mdas(struct volume_group *vg, uint32_t num_to_ignore)
 {
 	struct metadata_area *mda;
@@ -1227,6 +1249,18 @@ static int _vg_ignore_mdas(struct volume_group *vg, uint32_t num_to_ignore)
 	if (!num_to_ignore)
 		return 1;
 
+	/*
+	 * Keep the remaining copies on as many PVs as possible:
+	 * first ignore second mdas of PVs that keep one in use.
+	 */
+	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use)
+		if (!mda_is_ignored(mda) && _mda_dev_has_other_used(vg, mda)) {
+			mda_set_ignored(mda, 1);
+			mda_used_count--;
+			if (!--num_to_ignore)
+				return 1;
+		}
+
 	if (!(mda_to_ignore_bs = _bitset_with_random_bits(vg->vgmem, mda_used_count,
 							  num_to_ignore, &vg->cmd->rand_seed)))
 		return_0;
@@ -1265,6 +1299,28 @@ static int _vg_unignore_mdas(struct volume_group *vg, uint32_t num_to_unignore)
 			   "but %" PRIu32 " required.  Changing %" PRIu32 " mda.",
 			   vg->name, mda_used_count, mda_count, vg_mda_copies(vg), num_to_unignore);
 
+	/*
+	 * Spread the copies over PVs: first use mdas on PVs
+	 * that have none in use.
+	 */
+	dm_list_iterate_items_safe(mda, tmda, &vg->fid->metadata_areas_ignored)
+		if (mda_is_ignored(mda) && !_mda_dev_has_other_used(vg, mda)) {
+			mda_set_ignored(mda, 0);
+			dm_list_move(&vg->fid->metadata_areas_in_use,
+				     &mda->list);
+			mda_free_count--;
+			if (!--num_to_unignore)
+				return 1;
+		}
+
+	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use)
+		if (mda_is_ignored(mda) && !_mda_dev_has_other_used(vg, mda)) {
+			mda_set_ignored(mda, 0);
+			mda_free_count--;
+			if (!--num_to_unignore)
+				return 1;
+		}
+
 	if (!(mda_to_unignore_bs = _bitset_with_random_bits(vg->vgmem, mda_free_count,
 							    num_to_unignore, &vg->cmd->rand_seed)))
 		return_0;
@@ -1638,6 +1694,7 @@ struct lv_list *find_lv_in_vg(const struct volume_group *vg,
 {
 	struct lv_list *lvl;
 	const char *ptr;
+	unsigned walked = 0;
 
 	/* Use last component */
 	if ((ptr = strrchr(lv_name, '/')))
@@ -1645,9 +1702,18 @@ struct lv_list *find_lv_in_vg(const struct volume_group *vg,
 	else
 		ptr = lv_name;
 
-	dm_list_iterate_items(lvl, &vg->lvs)
-		if (!strcmp(lvl->lv->name, ptr))
+	if ((lvl = vg_lv_index_find_name(vg, ptr)))
+		return lvl;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		walked++;
+		if (!strcmp(lvl->lv->name, ptr)) {
+			vg_lv_index_update(vg, lvl, walked);
 			return lvl;
+		}
+	}
+
+	vg_lv_index_update(vg, NULL, walked);
 
 	return NULL;
 }
@@ -1656,13 +1722,24 @@ struct logical_volume *find_lv_in_vg_by_lvid(const struct volume_group *vg,
 					     const union lvid *lvid)
 {
 	struct lv_list *lvl;
+	struct logical_volume *lv;
+	unsigned walked = 0;
 
 	if (memcmp(&lvid->id[0], &vg->id, ID_LEN))
 		return NULL; /* Check VG does not match */
 
-	dm_list_iterate_items(lvl, &vg->lvs)
-		if (!memcmp(&lvid->id[1], &lvl->lv->lvid.id[1], sizeof(lvid->id[1])))
+	if ((lv = vg_lv_index_find_id(vg, &lvid->id[1])))
+		return lv;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		walked++;
+		if (!memcmp(&lvid->id[1], &lvl->lv->lvid.id[1], sizeof(lvid->id[1]))) {
+			vg_lv_index_update(vg, lvl, walked);
 			return lvl->lv; /* LV uuid match */
+		}
+	}
+
+	vg_lv_index_update(vg, NULL, walked);
 
 	return NULL;
 }
@@ -1683,6 +1760,7 @@ struct generic_logical_volume *find_historical_glv(const struct volume_group *vg
 	const char *ptr;
 	const struct dm_list *list = check_removed_list ? &vg->removed_historical_lvs
 							: &vg->historical_lvs;
+	unsigned walked = 0;
 
 	/* Use last component */
 	if ((ptr = strrchr(historical_lv_name, '/')))
@@ -1690,17 +1768,28 @@ struct generic_logical_volume *find_historical_glv(const struct volume_group *vg
 	else
 		ptr = historical_lv_name;
 
+	if (!check_removed_list && (glvl = vg_historical_lv_index_find(vg, ptr)))
+		goto out;
+
 	dm_list_iterate_items(glvl, list) {
+		walked++;
 		if (!strcmp(glvl->glv->historical->name, ptr)) {
-			if (glvl_found)
-				*glvl_found = glvl;
-			return glvl->glv;
+			if (!check_removed_list)
+				vg_historical_lv_index_update(vg, glvl, walked);
+			goto out;
 		}
 	}
 
+	if (!check_removed_list)
+		vg_historical_lv_index_update(vg, NULL, walked);
+
 	if (glvl_found)
 		*glvl_found = NULL;
 	return NULL;
+out:
+	if (glvl_found)
+		*glvl_found = glvl;
+	return glvl->glv;
 }
 
 int lv_name_is_used_in_vg(const struct volume_group *vg, const char *name, int *historical)
@@ -1745,6 +1834,29 @@ struct lv_segment *find_seg_by_le(const struct logical_volume *lv, uint32_t le)
 	return NULL;
 }
 
+/*
+ * Callers walking an LV in LE order pass the segment found by the previous
+ * lookup so that each lookup continues from there instead of from the
+ * first segment.  seg_hint must still be in lv->segments.
+ */
+struct lv_segment *find_seg_by_le_from(const struct logical_volume *lv,
+				       const struct lv_segment *seg_hint, uint32_t le)
+{
+	const struct dm_list *segh;
+	struct lv_segment *seg;
+
+	if (!seg_hint || (seg_hint->lv != lv) || (le < seg_hint->le))
+		return find_seg_by_le(lv, le);
+
+	for (segh = &seg_hint->list; segh != &lv->segments; segh = segh->n) {
+		seg = dm_list_item(segh, struct lv_segment);
+		if (le >= seg->le && le < seg->le + seg->len)
+			return seg;
+	}
+
+	return find_seg_by_le(lv, le);
+}
+
 struct lv_segment *first_seg(const struct logical_volume *lv)
 {
 	struct lv_segment *seg;
@@ -1783,13 +1895,46 @@ int vg_remove_mdas(struct volume_group *vg)
 /*
  * Determine whether two vgs are compatible for merging.
  */
+/* Hash LV names of vg_from once instead of comparing every pair of LVs. */
+static int _lv_names_are_unique(struct volume_group *vg_from,
+				struct volume_group *vg_to)
+{
+	struct dm_hash_table *lv_names;
+	struct lv_list *lvl;
+	int r = 0;
+
+	if (!(lv_names = dm_hash_create(dm_list_size(&vg_from->lvs)))) {
+		log_error("Failed to allocate lv_name hash");
+		return 0;
+	}
+
+	dm_list_iterate_items(lvl, &vg_from->lvs)
+		if (!dm_hash_insert(lv_names, lvl->lv->name, lvl)) {
+			log_error("Failed to hash lvname.");
+			goto out;
+		}
+
+	dm_list_iterate_items(lvl, &vg_to->lvs)
+		if (dm_hash_lookup(lv_names, lvl->lv->name)) {
+			log_error("Duplicate logical volume "
+				  "name \"%s\" "
+				  "in \"%s\" and \"%s\"",
+				  lvl->lv->name, vg_to->name, vg_from->name);
+			goto out;
+		}
+
+	r = 1;
+out:
+	dm_hash_destroy(lv_names);
+
+	return r;
+}
+
 int vgs_are_compatible(struct cmd_context *cmd __attribute__((unused)),
 		       struct volume_group *vg_from,
 		       struct volume_group *vg_to)
 {
-	struct lv_list *lvl1, *lvl2;
 	struct pv_list *pvl;
-	const char *name1, *name2;
 
 	if (lvs_in_vg_activated(vg_from)) {
 		log_error("Logical volumes in \"%s\" must be inactive",
@@ -1829,21 +1974,8 @@ int vgs_are_compatible(struct cmd_context *cmd __attribute__((unused)),
 	}
 
 	/* Check no conflicts with LV names */
-	dm_list_iterate_items(lvl1, &vg_to->lvs) {
-		name1 = lvl1->lv->name;
-
-		dm_list_iterate_items(lvl2, &vg_from->lvs) {
-			name2 = lvl2->lv->name;
-
-			if (!strcmp(name1, name2)) {
-				log_error("Duplicate logical volume "
-					  "name \"%s\" "
-					  "in \"%s\" and \"%s\"",
-					  name1, vg_to->name, vg_from->name);
-				return 0;
-			}
-		}
-	}
+	if (!_lv_names_are_unique(vg_from, vg_to))
+		return_0;
 
 	/* Check no PVs are constructed from either VG */
 	dm_list_iterate_items(pvl, &vg_to->pvs) {
@@ -2122,6 +2254,7 @@ struct validate_hash {
 	struct dm_hash_table *historical_lvid;
 	struct dm_hash_table *pvid;
 	struct dm_hash_table *lv_lock_args;
+	struct dm_hash_table *lv_users;
 };
 
 /*
@@ -2348,6 +2481,8 @@ int vg_validate(struct volume_group *vg)
 		}
 	}
 
+	vhash.lv_users = create_lv_users_hash(vg);
+
 	/*
 	 * Count all non-snapshot invisible LVs
 	 */
@@ -2399,7 +2534,7 @@ int vg_validate(struct volume_group *vg)
 			}
 		}
 
-		if (!check_lv_segments(lvl->lv, 0)) {
+		if (!check_lv_segments_users(lvl->lv, 0, vhash.lv_users)) {
 			log_error(INTERNAL_ERROR "LV segments corrupted in %s.",
 				  lvl->lv->name);
 			r = 0;
@@ -2484,7 +2619,7 @@ int vg_validate(struct volume_group *vg)
 			r = 0;
 		}
 
-		if (!check_lv_segments(lvl->lv, 1)) {
+		if (!check_lv_segments_users(lvl->lv, 1, vhash.lv_users)) {
 			log_error(INTERNAL_ERROR "LV segments corrupted in %s.",
 				  lvl->lv->name);
 			r = 0;
@@ -2762,6 +2897,8 @@ out:
 		dm_hash_destroy(vhash.pvid);
 	if (vhash.lv_lock_args)
 		dm_hash_destroy(vhash.lv_lock_args);
+	if (vhash.lv_users)
+		dm_hash_destroy(vhash.lv_users);
 
 	return r;
 }
@@ -2981,6 +3118,13 @@ int vg_write(struct volume_group *vg)
 	if (vg->cmd->wipe_outdated_pvs)
 		_wipe_outdated_pvs(vg->cmd, vg);
 
+	/*
+	 * Materialize the unmodified copy here, outside any critical
+	 * section, before suspend/resume may need it via lv_committed().
+	 */
+	if (vg->committed_copy_deferred && !vg_committed_copy(vg))
+		return_0;
+
 	if (!vg_is_archived(vg) && vg->vg_committed && !archive(vg->vg_committed))
 		return_0;
 
@@ -3012,11 +3156,20 @@ int vg_write(struct volume_group *vg)
 		log_warn("WARNING: updating PV header on %s for VG %s.", pv_dev_name(pvl->pv), vg->name);
 	}
 
+	/*
+	 * PV headers do not depend on each other, so write them to all
+	 * devices at once, e.g. vgimportclone rewrites every PV here.
+	 */
+	dev_write_batch_begin();
 	dm_list_iterate_items_safe(pvl, pvl_safe, &vg->pv_write_list) {
-		if (!pv_write(vg->cmd, pvl->pv, 1))
+		if (!pv_write(vg->cmd, pvl->pv, 1)) {
+			(void) dev_write_batch_end();
 			return_0;
+		}
 		dm_list_del(&pvl->list);
 	}
+	if (!dev_write_batch_end())
+		return_0;
 
 	/* Write to each copy of the metadata area */
 	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
@@ -3140,6 +3293,7 @@ int vg_commit(struct volume_group *vg)
 	ret = _vg_commit_mdas(vg);
 
 	set_vg_notify(vg->cmd);
+	set_notify_vg(vg);
 
 	if (ret) {
 		/*
@@ -4327,6 +4481,35 @@ char *tags_format_and_copy(struct dm_pool *mem, const struct dm_list *tagsl)
 	return dm_pool_end_object(mem);
 }
 
+/*
+ * Return the unmodified committed copy of a VG read for update,
+ * importing it from committed_cft if this has not been done yet.
+ * Returns NULL when the VG has no separate committed copy.
+ */
+struct volume_group *vg_committed_copy(struct volume_group *vg)
+{
+	if (!vg->committed_copy_deferred)
+		return vg->vg_committed;
+
+	vg->committed_copy_deferred = 0;
+
+	if (!vg->committed_cft) {
+		log_error(INTERNAL_ERROR "Missing committed config tree.");
+		return NULL;
+	}
+
+	if (critical_section())
+		log_error(INTERNAL_ERROR
+			  "Importing committed VG %s in critical section.", vg->name);
+
+	log_debug_metadata("Importing committed copy of VG %s.", vg->name);
+
+	if (!(vg->vg_committed = import_vg_from_config_tree(vg->cmd, vg->fid, vg->committed_cft)))
+		log_error("Failed to import written VG.");
+
+	return vg->vg_committed;
+}
+
 const struct logical_volume *lv_committed(const struct logical_volume *lv)
 {
 	struct volume_group *vg;
@@ -4335,11 +4518,9 @@ const struct logical_volume *lv_committed(const struct logical_volume *lv)
 	if (!lv)
 		return NULL;
 
-	if (!lv->vg->vg_committed)
+	if (!(vg = vg_committed_copy(lv->vg)))
 		return lv;
 
-	vg = lv->vg->vg_committed;
-
 	if (!(found_lv = find_lv_in_vg_by_lvid(vg, &lv->lvid))) {
 		log_error(INTERNAL_ERROR "LV %s (UUID %s) not found in committed metadata.",
 			  display_lvname(lv), lv->lvid.s);
@@ -4373,13 +4554,79 @@ int vg_is_shared(const struct volume_group *vg)
 	return (vg->lock_type && is_lockd_type(vg->lock_type));
 }
 
+struct historical_glv_order {
+	struct generic_logical_volume *glv;
+	unsigned pos; /* in vg->historical_lvs, which is mostly removal order */
+};
+
+/* Records not yet written (no removal time) sort as the most recent. */
+static int _historical_glv_removed_cmp(const void *a, const void *b)
+{
+	const struct historical_glv_order *oa = a, *ob = b;
+	uint64_t ta = oa->glv->historical->timestamp_removed ? : UINT64_MAX;
+	uint64_t tb = ob->glv->historical->timestamp_removed ? : UINT64_MAX;
+
+	if (ta != tb)
+		return (ta > tb) ? 1 : -1;
+
+	return (oa->pos > ob->pos) - (oa->pos < ob->pos);
+}
+
+/*
+ * Keep at most metadata/lvs_history_max_count historical LVs,
+ * destroying the records of those removed first.
+ */
+static int _strip_excess_historical_lvs(struct volume_group *vg)
+{
+	struct historical_glv_order *order;
+	struct generic_logical_volume *glv;
+	struct glv_list *glvl;
+	uint64_t max_count = find_config_tree_int(vg->cmd, metadata_lvs_history_max_count_CFG, NULL);
+	unsigned count, i = 0;
+	int r = 0;
+
+	if (!max_count || ((count = dm_list_size(&vg->historical_lvs)) <= max_count))
+		return 1;
+
+	if (!(order = malloc(count * sizeof(*order)))) {
+		log_error("Failed to allocate historical LVs list for VG %s.", vg->name);
+		return 0;
+	}
+
+	dm_list_iterate_items(glvl, &vg->historical_lvs) {
+		order[i].glv = glvl->glv;
+		order[i].pos = i;
+		i++;
+	}
+
+	qsort(order, count, sizeof(*order), _historical_glv_removed_cmp);
+
+	for (i = 0; i < count - max_count; i++) {
+		glv = order[i].glv;
+		if (!historical_glv_remove(glv)) {
+			log_error("Failed to destroy record about historical LV %s/%s.",
+				  vg->name, glv->historical->name);
+			goto out;
+		}
+		log_verbose("Record for historical logical volume \"%s\" over the "
+			    "limit of %" PRIu64 " automatically destroyed.",
+			    glv->historical->name, max_count);
+	}
+
+	r = 1;
+out:
+	free(order);
+
+	return r;
+}
+
 int vg_strip_outdated_historical_lvs(struct volume_group *vg) {
 	struct glv_list *glvl, *tglvl;
 	time_t current_time = time(NULL);
 	uint64_t threshold = find_config_tree_int(vg->cmd, metadata_lvs_history_retention_time_CFG, NULL);
 
 	if (!threshold)
-		return 1;
+		return _strip_excess_historical_lvs(vg);
 
 	dm_list_iterate_items_safe(glvl, tglvl, &vg->historical_lvs) {
 		/*
@@ -4400,7 +4647,7 @@ int vg_strip_outdated_historical_lvs(struct volume_group *vg) {
 		}
 	}
 
-	return 1;
+	return _strip_excess_historical_lvs(vg);
 }
 
 int lv_on_pmem(struct logical_volume *lv)
@@ -4560,6 +4807,30 @@ bool scan_text_mismatch(struct cmd_context *cmd, const char *vgname, const char
 
 	lvmcache_get_mdas(cmd, vgname, vgid, &mda_list);
 
+	/*
+	 * Invalidate the mda_headers in bcache so they will be reread from
+	 * disk, and start rereading all of them together so the checks
+	 * below do not wait for each device in turn.
+	 */
+	dm_list_iterate_items(mdal, &mda_list) {
+		mda = mdal->mda;
+
+		if (!mda->scan_text_offset || (mda->mda_num != 1) ||
+		    !(dev = mda_get_device(mda)))
+			continue;
+
+		if (!dev_invalidate_bytes(dev, 4096, 512)) {
+			log_debug("Rescan for text mismatch - cannot invalidate.");
+			goto out;
+		}
+
+		mdac = mda->metadata_locn;
+		dev_prefetch_bytes(dev, mdac->area.start, MDA_HEADER_SIZE);
+
+		if (cmd->can_use_one_scan)
+			break;
+	}
+
 	dm_list_iterate_items(mdal, &mda_list) {
 		mda = mdal->mda;
 
@@ -4579,14 +4850,6 @@ bool scan_text_mismatch(struct cmd_context *cmd, const char *vgname, const char
 		mdac = mda->metadata_locn;
 		area = &mdac->area;
 
-		/*
-		 * Invalidate mda_header in bcache so it will be reread from disk.
-		 */
-		if (!dev_invalidate_bytes(dev, 4096, 512)) {
-			log_debug("Rescan for text mismatch - cannot invalidate.");
-			goto out;
-		}
-
 		if (!(mdah = raw_read_mda_header(cmd->fmt, area, 1, 0, &bad_fields))) {
 			log_debug("Rescan for text mismatch - no mda header.");
 			goto out;
@@ -4914,6 +5177,7 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 	struct volume_group *vg = NULL;
 	struct lv_list *lvl;
 	struct pv_list *pvl;
+	struct dm_hash_table *lv_users;
 	int missing_pv_dev = 0;
 	int missing_pv_flag = 0;
 	uint32_t failure = 0;
@@ -4925,9 +5189,12 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 	if (error_vg)
 		*error_vg = NULL;
 
+	timing_start(TIMING_VG_READ);
+
 	if (is_orphan_vg(vg_name)) {
 		log_very_verbose("Reading orphan VG %s.", vg_name);
 		vg = vg_read_orphans(cmd, vg_name);
+		timing_end(TIMING_VG_READ);
 		return vg;
 	}
 
@@ -5071,22 +5338,22 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 		goto bad;
 	}
 
+	/*
+	 * Import already checked each LV on its own, the complete pass
+	 * repeats those checks and adds the ones that cross-reference LVs.
+	 */
+	lv_users = create_lv_users_hash(vg);
 	dm_list_iterate_items(lvl, &vg->lvs) {
-		if (!check_lv_segments(lvl->lv, 0)) {
-			log_error(INTERNAL_ERROR "LV segments corrupted in %s.", lvl->lv->name);
-			failure |= FAILED_INTERNAL_ERROR;
-			goto bad;
-		}
-	}
-
-	dm_list_iterate_items(lvl, &vg->lvs) {
-		/* Checks that cross-reference other LVs. */
-		if (!check_lv_segments(lvl->lv, 1)) {
+		if (!check_lv_segments_users(lvl->lv, 1, lv_users)) {
 			log_error(INTERNAL_ERROR "LV segments corrupted in %s.", lvl->lv->name);
 			failure |= FAILED_INTERNAL_ERROR;
+			if (lv_users)
+				dm_hash_destroy(lv_users);
 			goto bad;
 		}
 	}
+	if (lv_users)
+		dm_hash_destroy(lv_users);
 
 	if (!check_pv_dev_sizes(vg))
 		log_warn("WARNING: One or more devices used as PVs in VG %s have changed sizes.", vg->name);
@@ -5173,10 +5440,12 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 			goto out;
 		}
 
-		if (!(vg->vg_committed = import_vg_from_config_tree(cmd, vg->fid, vg->committed_cft))) {
-			log_error("Failed to import written VG.");
-			goto out;
-		}
+		/*
+		 * The copy is imported from committed_cft on first use
+		 * (see vg_committed_copy()), so commands that read for
+		 * update but never write skip the second import.
+		 */
+		vg->committed_copy_deferred = 1;
 	} else {
 		if (vg->vg_precommitted)
 			log_error(INTERNAL_ERROR "vg_read vg %p vg_precommitted %p", (void *)vg, (void *)vg->vg_precommitted);
@@ -5185,10 +5454,12 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 	}
 out:
 	/* We return with the VG lock held when read is successful. */
+	timing_end(TIMING_VG_READ);
 
 	return vg;
 bad:
 	*error_flags = failure;
+	timing_end(TIMING_VG_READ);
 
 	/*
 	 * FIXME: get rid of this case so we don't have to return the vg when
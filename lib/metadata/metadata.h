@@ -242,8 +242,8 @@ int mdas_empty_or_ignored(struct dm_list *mdas);
 #define seg_pvseg(seg, s)	(seg)->areas[(s)].u.pv.pvseg
 #define seg_dev(seg, s)		(seg)->areas[(s)].u.pv.pvseg->pv->dev
 #define seg_pe(seg, s)		(seg)->areas[(s)].u.pv.pvseg->pe
-#define seg_le(seg, s)		(seg)->areas[(s)].u.lv.le
-#define seg_metale(seg, s)	(seg)->meta_areas[(s)].u.lv.le
+#define seg_le(seg, s)		(seg)->areas[(s)].le
+#define seg_metale(seg, s)	(seg)->meta_areas[(s)].le
 
 struct name_list {
 	struct dm_list list;
@@ -401,6 +401,9 @@ struct pv_list *find_pv_in_pv_list(const struct dm_list *pl,
 
 /* Find LV segment containing given LE */
 struct lv_segment *find_seg_by_le(const struct logical_volume *lv, uint32_t le);
+/* Same, but start looking at seg_hint, a segment still in lv->segments (or NULL) */
+struct lv_segment *find_seg_by_le_from(const struct logical_volume *lv,
+				       const struct lv_segment *seg_hint, uint32_t le);
 
 /* Find pool LV segment given a thin pool data or metadata segment. */
 struct lv_segment *find_pool_seg(const struct lv_segment *seg);
@@ -421,8 +424,12 @@ struct logical_volume *alloc_lv(struct dm_pool *mem);
 /*
  * Checks that an lv has no gaps or overlapping segments.
  * Set complete_vg to perform additional VG level checks.
+ * Pass users from create_lv_users_hash() when checking all LVs of a VG.
  */
 int check_lv_segments(struct logical_volume *lv, int complete_vg);
+int check_lv_segments_users(struct logical_volume *lv, int complete_vg,
+			    struct dm_hash_table *users);
+struct dm_hash_table *create_lv_users_hash(struct volume_group *vg);
 
 /*
  * Does every LV segment have the same number of stripes?
@@ -106,6 +106,12 @@ int attach_pool_lv(struct lv_segment *seg,
 	seg->origin = origin;
 	seg->lv->status |= seg_is_cache(seg) ? CACHE : THIN_VOLUME;
 
+	/* Keep highest device_id of the pool current once it is known */
+	if (seg_is_thin_volume(seg) && first_seg(pool_lv) &&
+	    first_seg(pool_lv)->device_id_max &&
+	    (first_seg(pool_lv)->device_id_max < seg->device_id))
+		first_seg(pool_lv)->device_id_max = seg->device_id;
+
 	if (seg_is_cache(seg)) {
 		lv_set_hidden(pool_lv); /* Used cache-pool/cachevol is hidden */
 
@@ -212,6 +218,7 @@ static struct generic_logical_volume *_create_historical_glv(struct lv_segment *
 	}
 
 	dm_list_add(&seg_to_remove->lv->vg->historical_lvs, &historical_glvl->list);
+	vg_historical_lv_index_add(seg_to_remove->lv->vg, historical_glvl);
 	return historical_glvl->glv;
 bad:
 	log_error("Failed to create historical LV representation for removed logical "
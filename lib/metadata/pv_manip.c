@@ -20,6 +20,7 @@
 #include "lib/locking/locking.h"
 #include "lib/config/defaults.h"
 #include "lib/display/display.h"
+#include "lib/datastruct/str_list.h"
 
 static struct pv_segment *_alloc_pv_segment(struct dm_pool *mem,
 					    struct physical_volume *pv,
@@ -255,10 +256,12 @@ static int _merge_free_pv_segment(struct pv_segment *peg)
 	}
 
 	/*
-	 * FIXME:
-	 * Should we free the list element once it is deleted
-	 * from the list?  I think not.  It is likely part of
-	 * a mempool.
+	 * The list element dropped by a merge is not freed or reused.
+	 * It comes from vg->vgmem, which only frees LIFO, and callers
+	 * of release_pv_segment may still hold a pointer to it (see the
+	 * warning there), so a free list of pv_segments would hand out
+	 * memory someone is still looking at.  A dropped element costs
+	 * sizeof(struct pv_segment) until the VG is released.
 	 */
 	/* Attempt to merge with Free space before */
 	if ((l = dm_list_prev(&peg->pv->segments, &peg->list))) {
@@ -621,6 +624,8 @@ int pv_resize_single(struct cmd_context *cmd,
 	const char *pv_name = pv_dev_name(pv);
 	const char *vg_name = pv->vg_name;
 	int vg_needs_pv_write = 0;
+	char msg[PATH_MAX + 64];
+	char *msg_dup;
 
 	if (!(pv->fmt->features & FMT_RESIZE_PV)) {
 		log_error("Physical volume %s format does not support resizing.",
@@ -681,14 +686,20 @@ int pv_resize_single(struct cmd_context *cmd,
 	}
 
 	if (!is_orphan_vg(vg_name)) {
-		if (!vg_write(vg) || !vg_commit(vg)) {
+		/* Commit once for all PVs of the VG changed by the caller. */
+		if ((dm_snprintf(msg, sizeof(msg), "Physical volume \"%s\" changed",
+				 pv_name) < 0) ||
+		    !(msg_dup = dm_pool_strdup(vg->vgmem, msg)) ||
+		    !str_list_add_no_dup_check(vg->vgmem, &vg->msg_list, msg_dup)) {
 			log_error("Failed to store physical volume \"%s\" in "
 				  "volume group \"%s\"", pv_name, vg_name);
 			goto out;
 		}
-	}
+		log_debug_metadata("Postponing write and commit of PV %s.", pv_name);
+		vg->needs_write_and_commit = 1;
+	} else
+		log_print_unless_silent("Physical volume \"%s\" changed", pv_name);
 
-	log_print_unless_silent("Physical volume \"%s\" changed", pv_name);
 	r = 1;
 
 out:
@@ -36,6 +36,65 @@ static void _insert_area(struct dm_list *head, struct pv_area *a, unsigned reduc
 	a->map->pe_count += a->count;
 }
 
+/*
+ * Areas of a new map are first appended in the order they are found
+ * and then sorted once.  Ties keep that order, so the result is the
+ * same as inserting each one with _insert_area but avoids quadratic
+ * insertion on PVs with many free segments.
+ */
+struct pv_area_sort {
+	struct pv_area *pva;
+	uint32_t idx;
+};
+
+static int _comp_area_sort(const void *l, const void *r)
+{
+	const struct pv_area_sort *lsort = l, *rsort = r;
+
+	if (lsort->pva->count != rsort->pva->count)
+		return (lsort->pva->count > rsort->pva->count) ? -1 : 1;
+
+	return (lsort->idx < rsort->idx) ? -1 : 1;
+}
+
+static void _append_area(struct pv_area *a)
+{
+	dm_list_add(&a->map->areas, &a->list);
+	a->map->pe_count += a->count;
+}
+
+static int _sort_areas(struct pv_map *pvm)
+{
+	struct pv_area_sort *sort;
+	struct pv_area *pva;
+	uint32_t i, count = dm_list_size(&pvm->areas);
+
+	if (count < 2)
+		return 1;
+
+	if (!(sort = malloc(count * sizeof(*sort)))) {
+		log_error("Failed to allocate PV area sort array.");
+		return 0;
+	}
+
+	i = 0;
+	dm_list_iterate_items(pva, &pvm->areas) {
+		sort[i].pva = pva;
+		sort[i].idx = i;
+		i++;
+	}
+
+	qsort(sort, count, sizeof(*sort), _comp_area_sort);
+
+	dm_list_init(&pvm->areas);
+	for (i = 0; i < count; i++)
+		dm_list_add(&pvm->areas, &sort[i].pva->list);
+
+	free(sort);
+
+	return 1;
+}
+
 static void _remove_area(struct pv_area *a)
 {
 	dm_list_del(&a->list);
@@ -56,7 +115,7 @@ static int _create_single_area(struct dm_pool *mem, struct pv_map *pvm,
 	pva->start = start;
 	pva->count = length;
 	pva->unreserved = pva->count;
-	_insert_area(&pvm->areas, pva, 0);
+	_append_area(pva);
 
 	return 1;
 }
@@ -163,6 +222,10 @@ static int _create_maps(struct dm_pool *mem, struct dm_list *pvs, struct dm_list
 			return_0;
 	}
 
+	dm_list_iterate_items(pvm, pvms)
+		if (!_sort_areas(pvm))
+			return_0;
+
 	return 1;
 }
 
@@ -535,18 +535,55 @@ struct logical_volume *find_pool_lv(const struct logical_volume *lv)
 	return seg->lv;
 }
 
+/*
+ * Find the lowest device_id not used by any thin LV of the pool and not
+ * waiting for its delete message, once ids above the highest used one
+ * are exhausted.
+ */
+static uint32_t _find_free_thin_pool_device_id_hole(struct lv_segment *thin_pool_seg)
+{
+	struct lv_thin_message *tmsg;
+	struct seg_list *sl;
+	dm_bitset_t used;
+	uint32_t id;
+
+	if (!(used = dm_bitset_create(NULL, DM_THIN_MAX_DEVICE_ID + 1))) {
+		log_error("Failed to allocate device_id bitset.");
+		return 0;
+	}
+
+	dm_list_iterate_items(sl, &thin_pool_seg->lv->segs_using_this_lv)
+		if (sl->seg->device_id <= DM_THIN_MAX_DEVICE_ID)
+			dm_bit_set(used, sl->seg->device_id);
+
+	dm_list_iterate_items(tmsg, &thin_pool_seg->thin_messages)
+		if ((tmsg->type == DM_THIN_MESSAGE_DELETE) &&
+		    (tmsg->u.delete_id <= DM_THIN_MAX_DEVICE_ID))
+			dm_bit_set(used, tmsg->u.delete_id);
+
+	for (id = 1; id <= DM_THIN_MAX_DEVICE_ID; ++id)
+		if (!dm_bit(used, id))
+			break;
+
+	dm_bitset_destroy(used);
+
+	return (id <= DM_THIN_MAX_DEVICE_ID) ? id : 0;
+}
+
 /*
  * Find a free device_id for given thin_pool segment.
  *
+ * The highest used device_id is looked up once and then kept updated
+ * in the pool segment during VG lifetime, so creating thin LVs does not
+ * scan all the thin LVs of the pool each time.
+ *
  * \return
  * Free device id, or 0 if free device_id is not found.
- *
- * FIXME: Improve naive search and keep the value cached
- * and updated during VG lifetime (so no const for lv_segment)
  */
 uint32_t get_free_thin_pool_device_id(struct lv_segment *thin_pool_seg)
 {
 	uint32_t max_id = 0;
+	uint32_t id;
 	struct seg_list *sl;
 
 	if (!seg_is_thin_pool(thin_pool_seg)) {
@@ -556,19 +593,26 @@ uint32_t get_free_thin_pool_device_id(struct lv_segment *thin_pool_seg)
 		return 0;
 	}
 
-	dm_list_iterate_items(sl, &thin_pool_seg->lv->segs_using_this_lv)
-		if (sl->seg->device_id > max_id)
-			max_id = sl->seg->device_id;
+	if (!(max_id = thin_pool_seg->device_id_max))
+		dm_list_iterate_items(sl, &thin_pool_seg->lv->segs_using_this_lv)
+			if (sl->seg->device_id > max_id)
+				max_id = sl->seg->device_id;
 
-	if (++max_id > DM_THIN_MAX_DEVICE_ID) {
-		/* FIXME Find empty holes instead of aborting! */
+	if (max_id < DM_THIN_MAX_DEVICE_ID)
+		id = max_id + 1;
+	else if (!(id = _find_free_thin_pool_device_id_hole(thin_pool_seg))) {
 		log_error("Cannot find free device_id.");
 		return 0;
 	}
 
-	log_debug_metadata("Found free pool device_id %u.", max_id);
+	if (id > max_id)
+		max_id = id;
+
+	thin_pool_seg->device_id_max = max_id;
+
+	log_debug_metadata("Found free pool device_id %u.", id);
 
-	return max_id;
+	return id;
 }
 
 static int _check_pool_create(const struct logical_volume *lv)
@@ -597,7 +641,7 @@ static int _check_pool_create(const struct logical_volume *lv)
 	return 1;
 }
 
-int update_thin_pool_lv(struct logical_volume *lv, int activate)
+static int _update_thin_pool_lv(struct logical_volume *lv, int activate, int commit)
 {
 	int monitored;
 	int ret = 1;
@@ -670,12 +714,49 @@ int update_thin_pool_lv(struct logical_volume *lv, int activate)
 
 	dm_list_init(&(first_seg(lv)->thin_messages));
 
-	if (!vg_write(lv->vg) || !vg_commit(lv->vg))
+	if (commit && (!vg_write(lv->vg) || !vg_commit(lv->vg)))
 		return_0;
 
 	return ret;
 }
 
+int update_thin_pool_lv(struct logical_volume *lv, int activate)
+{
+	return _update_thin_pool_lv(lv, activate, 1);
+}
+
+/*
+ * Send messages queued in all thin pools of the VG, e.g. after a
+ * postponed commit of many removed thin LVs.  Each pool gets one
+ * suspend/resume for all its messages and the VG is committed once.
+ * A pool failing the update keeps its messages queued in metadata.
+ */
+int update_thin_pools_with_messages(struct volume_group *vg)
+{
+	struct lv_list *lvl;
+	int updated = 0;
+	int r = 1;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		if (!lv_is_thin_pool(lvl->lv) ||
+		    dm_list_empty(&first_seg(lvl->lv)->thin_messages))
+			continue;
+
+		if (!_update_thin_pool_lv(lvl->lv, 1, 0)) {
+			log_error("Failed to update thin pool %s.", display_lvname(lvl->lv));
+			r = 0;
+			continue;
+		}
+
+		updated = 1;
+	}
+
+	if (updated && (!vg_write(vg) || !vg_commit(vg)))
+		return_0;
+
+	return r;
+}
+
 static uint64_t _estimate_size(uint32_t data_extents, uint32_t extent_size, uint64_t size)
 {
 	/*
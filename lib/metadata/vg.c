@@ -19,6 +19,7 @@
 #include "lib/activate/activate.h"
 #include "lib/commands/toolcontext.h"
 #include "lib/format_text/archiver.h"
+#include "lib/cache/lvmcache.h"
 
 struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
 			      const char *vg_name)
@@ -79,9 +80,19 @@ static void _free_vg(struct volume_group *vg)
 
 	log_debug_mem("Freeing VG %s at %p.", vg->name ? : "<no name>", (void *)vg);
 
-	if (vg->committed_cft)
+	/* Keep the parsed text for another read of this VG */
+	if (vg->committed_cft && vg->committed_cft_size)
+		lvmcache_save_metadata_cft(vg->committed_cft, vg->committed_cft_checksum,
+					   vg->committed_cft_size);
+	else if (vg->committed_cft)
 		config_destroy(vg->committed_cft);
 	dm_hash_destroy(vg->hostnames);
+	if (vg->lv_names)
+		dm_hash_destroy(vg->lv_names);
+	if (vg->lv_ids)
+		dm_hash_destroy(vg->lv_ids);
+	if (vg->historical_lv_names)
+		dm_hash_destroy(vg->historical_lv_names);
 	dm_pool_destroy(vg->vgmem);
 }
 
@@ -107,6 +118,185 @@ void free_orphan_vg(struct volume_group *vg)
 	_free_vg(vg);
 }
 
+/* A lookup walking more LVs than this builds the LV indexes. */
+#define LV_INDEX_MIN_WALK 32
+
+static int _lvl_in_vg(const struct volume_group *vg, const struct lv_list *lvl)
+{
+	return (lvl->lv->vg == vg) && !(lvl->lv->status & LV_REMOVED);
+}
+
+static void _lv_index_destroy(struct volume_group *vg)
+{
+	if (vg->lv_names) {
+		dm_hash_destroy(vg->lv_names);
+		vg->lv_names = NULL;
+	}
+
+	if (vg->lv_ids) {
+		dm_hash_destroy(vg->lv_ids);
+		vg->lv_ids = NULL;
+	}
+}
+
+static void _lv_index_build(struct volume_group *vg, unsigned walked)
+{
+	struct lv_list *lvl;
+
+	if (!(vg->lv_names = dm_hash_create(walked * 2)) ||
+	    !(vg->lv_ids = dm_hash_create(walked * 2)))
+		goto_bad;
+
+	/* The first LV in the list wins, as when walking vg->lvs. */
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		if (!dm_hash_lookup(vg->lv_names, lvl->lv->name) &&
+		    !dm_hash_insert(vg->lv_names, lvl->lv->name, lvl))
+			goto_bad;
+
+		if (!dm_hash_lookup_binary(vg->lv_ids, &lvl->lv->lvid.id[1], ID_LEN) &&
+		    !dm_hash_insert_binary(vg->lv_ids, &lvl->lv->lvid.id[1], ID_LEN, lvl))
+			goto_bad;
+	}
+
+	log_debug_metadata("Indexed %u LVs in VG %s.", dm_hash_get_num_entries(vg->lv_names), vg->name);
+
+	return;
+bad:
+	/* Lookups just keep walking vg->lvs. */
+	_lv_index_destroy(vg);
+}
+
+struct lv_list *vg_lv_index_find_name(const struct volume_group *vg, const char *lv_name)
+{
+	struct lv_list *lvl;
+
+	if (!vg->lv_names || !(lvl = dm_hash_lookup(vg->lv_names, lv_name)))
+		return NULL;
+
+	if (!_lvl_in_vg(vg, lvl) || strcmp(lvl->lv->name, lv_name))
+		return NULL;
+
+	return lvl;
+}
+
+struct logical_volume *vg_lv_index_find_id(const struct volume_group *vg, const struct id *lv_id)
+{
+	struct lv_list *lvl;
+
+	if (!vg->lv_ids || !(lvl = dm_hash_lookup_binary(vg->lv_ids, lv_id, ID_LEN)))
+		return NULL;
+
+	if (!_lvl_in_vg(vg, lvl) || memcmp(&lvl->lv->lvid.id[1], lv_id, ID_LEN))
+		return NULL;
+
+	return lvl->lv;
+}
+
+/*
+ * Called after a lookup had to walk 'walked' LVs of vg->lvs and found lvl
+ * (or nothing).  The indexes are a cache of vg so const vg is updated here.
+ */
+void vg_lv_index_update(const struct volume_group *vg, struct lv_list *lvl, unsigned walked)
+{
+	struct volume_group *vg_idx = (struct volume_group *) vg;
+
+	if (!vg->lv_names) {
+		if (walked > LV_INDEX_MIN_WALK)
+			_lv_index_build(vg_idx, walked);
+		return;
+	}
+
+	if (!lvl)
+		return;
+
+	/* Replace an entry that became stale. */
+	if (!dm_hash_insert(vg_idx->lv_names, lvl->lv->name, lvl) ||
+	    !dm_hash_insert_binary(vg_idx->lv_ids, &lvl->lv->lvid.id[1], ID_LEN, lvl)) {
+		stack;
+		_lv_index_destroy(vg_idx);
+	}
+}
+
+static void _historical_lv_index_destroy(struct volume_group *vg)
+{
+	if (vg->historical_lv_names) {
+		dm_hash_destroy(vg->historical_lv_names);
+		vg->historical_lv_names = NULL;
+	}
+}
+
+static void _historical_lv_index_build(struct volume_group *vg, unsigned walked)
+{
+	struct glv_list *glvl;
+
+	if (!(vg->historical_lv_names = dm_hash_create(walked * 2)))
+		goto_bad;
+
+	/* The first historical LV in the list wins, as when walking it. */
+	dm_list_iterate_items(glvl, &vg->historical_lvs)
+		if (!dm_hash_lookup(vg->historical_lv_names, glvl->glv->historical->name) &&
+		    !dm_hash_insert(vg->historical_lv_names, glvl->glv->historical->name, glvl))
+			goto_bad;
+
+	log_debug_metadata("Indexed %u historical LVs in VG %s.",
+			   dm_hash_get_num_entries(vg->historical_lv_names), vg->name);
+
+	return;
+bad:
+	_historical_lv_index_destroy(vg);
+}
+
+struct glv_list *vg_historical_lv_index_find(const struct volume_group *vg, const char *name)
+{
+	struct glv_list *glvl;
+
+	if (!vg->historical_lv_names || !(glvl = dm_hash_lookup(vg->historical_lv_names, name)))
+		return NULL;
+
+	if ((glvl->glv->historical->vg != vg) || strcmp(glvl->glv->historical->name, name))
+		return NULL;
+
+	return glvl;
+}
+
+/* Same as vg_lv_index_update() for a walk of vg->historical_lvs. */
+void vg_historical_lv_index_update(const struct volume_group *vg, struct glv_list *glvl, unsigned walked)
+{
+	struct volume_group *vg_idx = (struct volume_group *) vg;
+
+	if (!vg->historical_lv_names) {
+		if (walked > LV_INDEX_MIN_WALK)
+			_historical_lv_index_build(vg_idx, walked);
+		return;
+	}
+
+	if (glvl && !dm_hash_insert(vg_idx->historical_lv_names, glvl->glv->historical->name, glvl)) {
+		stack;
+		_historical_lv_index_destroy(vg_idx);
+	}
+}
+
+/* Called after glvl was added to vg->historical_lvs. */
+void vg_historical_lv_index_add(struct volume_group *vg, struct glv_list *glvl)
+{
+	if (vg->historical_lv_names && !vg_historical_lv_index_find(vg, glvl->glv->historical->name) &&
+	    !dm_hash_insert(vg->historical_lv_names, glvl->glv->historical->name, glvl)) {
+		stack;
+		_historical_lv_index_destroy(vg);
+	}
+}
+
+/*
+ * Called before glvl leaves vg->historical_lvs.  Entries are not
+ * recognisable as removed otherwise.
+ */
+void vg_historical_lv_index_remove(struct volume_group *vg, struct glv_list *glvl)
+{
+	if (vg->historical_lv_names &&
+	    (dm_hash_lookup(vg->historical_lv_names, glvl->glv->historical->name) == glvl))
+		dm_hash_remove(vg->historical_lv_names, glvl->glv->historical->name);
+}
+
 int link_lv_to_vg(struct volume_group *vg, struct logical_volume *lv)
 {
 	struct lv_list *lvl;
@@ -122,6 +312,13 @@ int link_lv_to_vg(struct volume_group *vg, struct logical_volume *lv)
 	dm_list_add(&vg->lvs, &lvl->list);
 	lv->status &= ~LV_REMOVED;
 
+	/* The LV uuid may not be set yet, so only its name is indexed now. */
+	if (vg->lv_names && lv->name && !vg_lv_index_find_name(vg, lv->name) &&
+	    !dm_hash_insert(vg->lv_names, lv->name, lvl)) {
+		stack;
+		_lv_index_destroy(vg);
+	}
+
 	return 1;
 }
 
@@ -132,6 +329,12 @@ int unlink_lv_from_vg(struct logical_volume *lv)
 	if (!(lvl = find_lv_in_vg(lv->vg, lv->name)))
 		return_0;
 
+	if (lv->vg->lv_names && (dm_hash_lookup(lv->vg->lv_names, lv->name) == lvl))
+		dm_hash_remove(lv->vg->lv_names, lv->name);
+	if (lv->vg->lv_ids &&
+	    (dm_hash_lookup_binary(lv->vg->lv_ids, &lv->lvid.id[1], ID_LEN) == lvl))
+		dm_hash_remove_binary(lv->vg->lv_ids, &lv->lvid.id[1], ID_LEN);
+
 	dm_list_move(&lv->vg->removed_lvs, &lvl->list);
 	lv->status |= LV_REMOVED;
 
@@ -762,5 +965,5 @@ void vg_backup_if_needed(struct volume_group *vg)
 		return;
 
 	vg->needs_backup = 0;
-	backup(vg->vg_committed);
+	backup(vg_committed_copy(vg));
 }
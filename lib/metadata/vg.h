@@ -45,6 +45,9 @@ struct volume_group {
 	unsigned lockd_not_started : 1;
 	unsigned needs_backup : 1;
 	unsigned needs_write_and_commit : 1;
+	unsigned write_and_commit_on_error : 1; /* postponed commit is done even when some LVs failed */
+	unsigned committed_copy_deferred : 1; /* vg_committed not yet imported from committed_cft */
+	unsigned summary_only : 1; /* only values from the scan summary, no PVs or LVs */
 	uint32_t write_count; /* count the number of vg_write calls */
 	uint32_t buffer_size_hint; /* hint with buffer size of parsed VG */
 
@@ -55,6 +58,8 @@ struct volume_group {
 	 * this will be NULL). The pointer is maintained by calls to vg_write & vg_commit
 	 */
 	struct dm_config_tree *committed_cft;
+	uint32_t committed_cft_checksum; /* of the mda text committed_cft was parsed from */
+	uint32_t committed_cft_size;	/* 0 if not parsed from an mda */
 	struct volume_group *vg_committed;
 	struct volume_group *vg_precommitted;
 
@@ -130,6 +135,15 @@ struct volume_group {
 	uint32_t mda_copies; /* target number of mdas for this VG */
 
 	struct dm_hash_table *hostnames; /* map of creation hostnames */
+	/*
+	 * Indexes of lvs by name and by LV uuid, built when a lookup had
+	 * to walk many LVs.  Entries are checked on use and repaired
+	 * from a walk of vg->lvs, so direct renames are safe.
+	 */
+	struct dm_hash_table *lv_names;
+	struct dm_hash_table *lv_ids;
+	/* Index of historical_lvs by name, kept the same way. */
+	struct dm_hash_table *historical_lv_names;
 	struct logical_volume *pool_metadata_spare_lv; /* one per VG */
 	struct logical_volume *sanlock_lv; /* one per VG */
 	struct dm_list msg_list;
@@ -138,6 +152,14 @@ struct volume_group {
 struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
 			      const char *vg_name);
 
+struct lv_list *vg_lv_index_find_name(const struct volume_group *vg, const char *lv_name);
+struct logical_volume *vg_lv_index_find_id(const struct volume_group *vg, const struct id *lv_id);
+void vg_lv_index_update(const struct volume_group *vg, struct lv_list *lvl, unsigned walked);
+struct glv_list *vg_historical_lv_index_find(const struct volume_group *vg, const char *name);
+void vg_historical_lv_index_update(const struct volume_group *vg, struct glv_list *glvl, unsigned walked);
+void vg_historical_lv_index_add(struct volume_group *vg, struct glv_list *glvl);
+void vg_historical_lv_index_remove(struct volume_group *vg, struct glv_list *glvl);
+
 /*
  * release_vg() must be called on every struct volume_group allocated
  * by vg_create() or vg_read_internal() to free it when no longer required.
@@ -173,6 +195,7 @@ uint32_t vg_mda_copies(const struct volume_group *vg);
 int vg_set_mda_copies(struct volume_group *vg, uint32_t mda_copies);
 char *vg_profile_dup(const struct volume_group *vg);
 void vg_backup_if_needed(struct volume_group *vg);
+struct volume_group *vg_committed_copy(struct volume_group *vg);
 
 /*
  * Returns visible LV count - number of LVs from user perspective
@@ -17,9 +17,11 @@
 #include "lib/device/device.h"
 #include "lib/locking/locking.h"
 #include "lib/misc/lvm-exec.h"
+#include "lib/misc/lvm-signal.h"
 #include "lib/commands/toolcontext.h"
 
 #include <unistd.h>
+#include <spawn.h>
 #include <sys/wait.h>
 
 /*
@@ -43,6 +45,44 @@ static char *_verbose_args(const char *const argv[], char *buf, size_t sz)
 	return buf;
 }
 
+/*
+ * Start external command with posix_spawnp().
+ *
+ * Unlike fork() this does not need to copy the page tables of
+ * the (possibly large and memory locked) address space, the child
+ * only runs until the exec of the command.
+ * Lock files are opened with O_CLOEXEC so they are not inherited and
+ * the child gets the signal mask in use before locks blocked signals.
+ */
+static int _spawn(const char *const argv[], const posix_spawn_file_actions_t *fa,
+		  pid_t *pid)
+{
+	posix_spawnattr_t attr;
+	sigset_t set;
+	int r;
+
+	if ((r = posix_spawnattr_init(&attr))) {
+		errno = r;
+		log_sys_error("posix_spawnattr_init", "");
+		return r;
+	}
+
+	if (signals_blocked_oldset(&set) &&
+	    ((r = posix_spawnattr_setsigmask(&attr, &set)) ||
+	     (r = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK)))) {
+		errno = r;
+		log_sys_error("posix_spawnattr_setsigmask", "");
+	} else if ((r = posix_spawnp(pid, argv[0], fa, &attr,
+				     (char **) argv, environ))) {
+		errno = r;
+		log_sys_error("posix_spawnp", argv[0]);
+	}
+
+	(void) posix_spawnattr_destroy(&attr);
+
+	return r;
+}
+
 /*
  * Execute and wait for external command
  */
@@ -51,6 +91,7 @@ int exec_cmd(struct cmd_context *cmd, const char *const argv[],
 {
 	pid_t pid;
 	int status = 0;
+	int r;
 	char buf[PATH_MAX * 2];
 
 	if (rstatus)
@@ -70,22 +111,13 @@ int exec_cmd(struct cmd_context *cmd, const char *const argv[],
 
 	log_verbose("Executing:%s", _verbose_args(argv, buf, sizeof(buf)));
 
-	if ((pid = fork()) == -1) {
-		log_sys_error("fork", "");
+	if ((r = _spawn(argv, NULL, &pid))) {
+		/* Report errno like a child failing in execvp. */
+		if (rstatus)
+			*rstatus = r;
 		return 0;
 	}
 
-	if (!pid) {
-		/* Child */
-		reset_locking();
-		/* FIXME Fix effect of reset_locking on cache then include this */
-		/* destroy_toolcontext(cmd); */
-		/* FIXME Use execve directly */
-		execvp(argv[0], (char **) argv);
-		log_sys_error("execvp", argv[0]);
-		_exit(errno);
-	}
-
 	/* Parent */
 	if (wait4(pid, &status, 0, NULL) != pid) {
 		log_error("wait4 child process %u failed: %s", pid,
@@ -113,42 +145,19 @@ int exec_cmd(struct cmd_context *cmd, const char *const argv[],
 	return 1;
 }
 
-static int _reopen_fd_to_null(int fd)
-{
-	int null_fd;
-	int r = 0;
-
-	if ((null_fd = open("/dev/null", O_RDWR)) == -1) {
-		log_sys_error("open", "/dev/null");
-		return 0;
-	}
-
-	if (close(fd)) {
-		log_sys_error("close", "");
-		goto out;
-	}
-
-	if (dup2(null_fd, fd) == -1) {
-		log_sys_error("dup2", "");
-		goto out;
-	}
-
-	r = 1;
-out:
-	if (close(null_fd)) {
-		log_sys_error("dup2", "");
-		return 0;
-	}
-
-	return r;
-}
-
 FILE *pipe_open(struct cmd_context *cmd, const char *const argv[],
 		int sync_needed, struct pipe_data *pdata)
 {
+	posix_spawn_file_actions_t fa;
 	int pipefd[2];
+	int r;
 	char buf[PATH_MAX * 2];
 
+	if (!argv[0]) {
+		log_error(INTERNAL_ERROR "Missing command.");
+		return 0;
+	}
+
 	if (sync_needed)
 		/* Flush ops and reset dm cookie */
 		if (!sync_local_dev_names(cmd)) {
@@ -163,8 +172,26 @@ FILE *pipe_open(struct cmd_context *cmd, const char *const argv[],
 
 	log_verbose("Piping:%s", _verbose_args(argv, buf, sizeof(buf)));
 
-	if ((pdata->pid = fork()) == -1) {
-		log_sys_error("fork", "");
+	/* Child -> writer, convert pipe[1] to STDOUT, STDIN from /dev/null */
+	if ((r = posix_spawn_file_actions_init(&fa))) {
+		errno = r;
+		log_sys_error("posix_spawn_file_actions_init", "");
+	} else {
+		if ((r = posix_spawn_file_actions_addopen(&fa, STDIN_FILENO, "/dev/null",
+							  O_RDWR, 0)) ||
+		    (r = posix_spawn_file_actions_addclose(&fa, pipefd[0 /*read*/])) ||
+		    (r = posix_spawn_file_actions_adddup2(&fa, pipefd[1 /*write*/],
+							  STDOUT_FILENO)) ||
+		    (r = posix_spawn_file_actions_addclose(&fa, pipefd[1]))) {
+			errno = r;
+			log_sys_error("posix_spawn_file_actions", "");
+		} else
+			r = _spawn(argv, &fa, &pdata->pid);
+
+		(void) posix_spawn_file_actions_destroy(&fa);
+	}
+
+	if (r) {
 		if (close(pipefd[0]))
 			log_sys_debug("close", "STDOUT");
 		if (close(pipefd[1]))
@@ -172,25 +199,6 @@ FILE *pipe_open(struct cmd_context *cmd, const char *const argv[],
 		return 0;
 	}
 
-	if (pdata->pid == 0) {
-		/* Child -> writer, convert pipe[0] to STDOUT */
-		if (!_reopen_fd_to_null(STDIN_FILENO))
-			stack;
-		else if (close(pipefd[0 /*read*/]))
-			log_sys_error("close", "pipe[0]");
-		else if (close(STDOUT_FILENO))
-			log_sys_error("close", "STDOUT");
-		else if (dup2(pipefd[1 /*write*/], STDOUT_FILENO) == -1)
-			log_sys_error("dup2", "STDOUT");
-		else if (close(pipefd[1]))
-			log_sys_error("close", "pipe[1]");
-		else if (argv[0]) {
-			execvp(argv[0], (char **) argv);
-			log_sys_error("execvp", argv[0]);
-		}
-		_exit(errno);
-	}
-
 	/* Parent -> reader */
 	if (close(pipefd[1 /*write*/])) {
 		log_sys_error("close", "STDOUT");
@@ -17,6 +17,7 @@
 #include "lib/config/config.h"
 #include "lib/misc/lvm-flock.h"
 #include "lib/misc/lvm-signal.h"
+#include "lib/misc/lvm-timing.h"
 #include "lib/locking/locking.h"
 
 #include <sys/file.h>
@@ -116,7 +117,7 @@ static int _do_flock(const char *file, int *fd, int operation, uint32_t nonblock
 		if ((*fd > -1) && close(*fd))
 			log_sys_debug("close", file);
 
-		if ((*fd = open(file, O_CREAT | O_APPEND | O_RDWR, 0777)) < 0) {
+		if ((*fd = open(file, O_CREAT | O_APPEND | O_RDWR | O_CLOEXEC, 0777)) < 0) {
 			log_sys_error("open", file);
 			return 0;
 		}
@@ -126,8 +127,17 @@ static int _do_flock(const char *file, int *fd, int operation, uint32_t nonblock
 		else
 			sigint_allow();
 
-		r = flock(*fd, operation);
+		/* Try without waiting first, so waits for other commands are seen. */
+		r = flock(*fd, operation | LOCK_NB);
 		old_errno = errno;
+		if (r && !nonblock && (old_errno == EWOULDBLOCK)) {
+			log_debug_locking("Waiting for lock %s held by another command.", file);
+			timing_start(TIMING_FLOCK_WAIT);
+			r = flock(*fd, operation);
+			old_errno = errno;
+			timing_end(TIMING_FLOCK_WAIT);
+		}
+
 		if (!nonblock) {
 			sigint_restore();
 			if (sigint_caught()) {
@@ -25,6 +25,7 @@ static int _verbose_level = VERBOSE_BASE_LEVEL;
 static int _silent = 0;
 static int _test = 0;
 static int _use_aio = 0;
+static int _use_io_uring = 0;
 static int _md_filtering = 0;
 static int _internal_filtering = 0;
 static int _fwraid_filtering = 0;
@@ -77,6 +78,11 @@ void init_use_aio(int useaio)
 	_use_aio = useaio;
 }
 
+void init_use_io_uring(int useiouring)
+{
+	_use_io_uring = useiouring;
+}
+
 void init_md_filtering(int level)
 {
 	_md_filtering = level;
@@ -255,6 +261,11 @@ int use_aio(void)
 	return _use_aio;
 }
 
+int use_io_uring(void)
+{
+	return _use_io_uring;
+}
+
 int md_filtering(void)
 {
 	return _md_filtering;
@@ -26,6 +26,7 @@ void init_verbose(int level);
 void init_silent(int silent);
 void init_test(int level);
 void init_use_aio(int useaio);
+void init_use_io_uring(int useiouring);
 void init_md_filtering(int level);
 void init_internal_filtering(int level);
 void init_fwraid_filtering(int level);
@@ -59,6 +60,7 @@ void set_sysfs_dir_path(const char *path);
 
 int test_mode(void);
 int use_aio(void);
+int use_io_uring(void);
 int md_filtering(void);
 int internal_filtering(void);
 int fwraid_filtering(void);
@@ -176,6 +176,17 @@ void unblock_signals(void)
 	_signals_blocked = 0;
 }
 
+/* Get signal mask from before block_signals(), returns 0 when not blocked. */
+int signals_blocked_oldset(sigset_t *set)
+{
+	if (!_signals_blocked)
+		return 0;
+
+	*set = _oldset;
+
+	return 1;
+}
+
 /* usleep with enabled signal handler.
  * Returns 1 when there was interruption */
 int interruptible_usleep(useconds_t usec)
@@ -17,6 +17,7 @@
 #define _LVM_SIGNAL_H
 
 #include <unistd.h>
+#include <signal.h>
 
 void remove_ctrl_c_handler(void);
 void install_ctrl_c_handler(void);
@@ -29,6 +30,7 @@ void sigint_clear(void);
 
 void block_signals(uint32_t flags);
 void unblock_signals(void);
+int signals_blocked_oldset(sigset_t *set);
 
 int interruptible_usleep(useconds_t usec);
 #endif
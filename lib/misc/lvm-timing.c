@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "lib/misc/lib.h"
+#include "lib/misc/lvm-timing.h"
+#include "lib/device/bcache.h"
+
+#include <time.h>
+
+struct timing_phase {
+	unsigned depth;
+	unsigned calls;
+	uint64_t start_ns;
+	uint64_t total_ns;
+};
+
+static const char * const _phase_names[TIMING_PHASES] = {
+	"label_scan",
+	"vg_read",
+	"lockd",
+	"lockd_wait",
+	"lockd_lm",
+	"activation",
+	"udev_wait",
+	"flock_wait",
+};
+
+static int _timing_enabled;
+static uint64_t _cmd_start_ns;
+static unsigned _dm_ioctls_start;
+static struct timing_phase _phases[TIMING_PHASES];
+static struct bcache_stats _io;
+
+static uint64_t _now_ns(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void timing_reset(void)
+{
+	const char *e = getenv("LVM_TIMING");
+
+	if (!(_timing_enabled = (e && *e && strcmp(e, "0")) ? 1 : 0))
+		return;
+
+	memset(_phases, 0, sizeof(_phases));
+	memset(&_io, 0, sizeof(_io));
+	_cmd_start_ns = _now_ns();
+	_dm_ioctls_start = dm_ioctl_count();
+}
+
+void timing_start(timing_phase_t phase)
+{
+	struct timing_phase *tp = &_phases[phase];
+
+	if (!_timing_enabled)
+		return;
+
+	if (!tp->depth++) {
+		tp->calls++;
+		tp->start_ns = _now_ns();
+	}
+}
+
+void timing_end(timing_phase_t phase)
+{
+	struct timing_phase *tp = &_phases[phase];
+
+	if (!_timing_enabled || !tp->depth)
+		return;
+
+	if (!--tp->depth)
+		tp->total_ns += _now_ns() - tp->start_ns;
+}
+
+void timing_add(timing_phase_t phase, uint64_t us)
+{
+	if (!_timing_enabled)
+		return;
+
+	_phases[phase].calls++;
+	_phases[phase].total_ns += us * 1000;
+}
+
+int timing_enabled(void)
+{
+	return _timing_enabled;
+}
+
+void timing_add_bcache_stats(const struct bcache_stats *stats)
+{
+	if (!_timing_enabled)
+		return;
+
+	_io.read_hits += stats->read_hits;
+	_io.read_misses += stats->read_misses;
+	_io.hot_hits += stats->hot_hits;
+	_io.write_zeroes += stats->write_zeroes;
+	_io.write_hits += stats->write_hits;
+	_io.write_misses += stats->write_misses;
+	_io.prefetches += stats->prefetches;
+	_io.reads += stats->reads;
+	_io.writes += stats->writes;
+	_io.io_errors += stats->io_errors;
+	if (_io.max_io_pending < stats->max_io_pending)
+		_io.max_io_pending = stats->max_io_pending;
+	_io.waits += stats->waits;
+	_io.wait_ns += stats->wait_ns;
+}
+
+/*
+ * One line of JSON on stderr, ret is the command's exit status.
+ */
+void timing_report(const char *cmd_name, int ret)
+{
+	char buf[1024];
+	int len, n;
+	unsigned i;
+
+	if (!_timing_enabled)
+		return;
+
+	len = dm_snprintf(buf, sizeof(buf), "{\"command\":\"%s\",\"status\":%d,\"total_us\":" FMTu64
+			  ",\"dm_ioctls\":%u",
+			  cmd_name ? : "", ret, (_now_ns() - _cmd_start_ns) / 1000,
+			  dm_ioctl_count() - _dm_ioctls_start);
+	if (len < 0)
+		return;
+
+	for (i = 0; i < TIMING_PHASES; i++) {
+		if ((n = dm_snprintf(buf + len, sizeof(buf) - len,
+				     ",\"%s_calls\":%u,\"%s_us\":" FMTu64,
+				     _phase_names[i], _phases[i].calls,
+				     _phase_names[i], _phases[i].total_ns / 1000)) < 0)
+			return;
+		len += n;
+	}
+
+	if (dm_snprintf(buf + len, sizeof(buf) - len,
+			",\"io\":{\"reads\":%u,\"writes\":%u,\"errors\":%u,"
+			"\"read_hits\":%u,\"read_misses\":%u,\"hot_hits\":%u,\"write_hits\":%u,"
+			"\"write_misses\":%u,\"write_zeroes\":%u,\"prefetches\":%u,"
+			"\"max_pending\":%u,\"waits\":%u,\"wait_us\":" FMTu64 "}}",
+			_io.reads, _io.writes, _io.io_errors,
+			_io.read_hits, _io.read_misses, _io.hot_hits, _io.write_hits,
+			_io.write_misses, _io.write_zeroes, _io.prefetches,
+			_io.max_io_pending, _io.waits, _io.wait_ns / 1000) < 0)
+		return;
+
+	log_warn("%s", buf);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _LVM_TIMING_H
+#define _LVM_TIMING_H
+
+/*
+ * Per command phase timing, enabled with LVM_TIMING=1 in the environment.
+ * Each phase records the number of calls and the wall clock time spent
+ * in them.  Nested calls of the same phase are counted once, time of a
+ * phase includes any other phase it calls (e.g. vg_read includes the
+ * label rescan it does).  The counters of the label scan bcache are
+ * added when it is destroyed.  lockd_wait and lockd_lm are reported by
+ * lvmlockd with each lock reply: the time the request spent in lvmlockd
+ * (queued, retried and locking) and the part of it in the lock manager.
+ */
+typedef enum {
+	TIMING_LABEL_SCAN,
+	TIMING_VG_READ,
+	TIMING_LOCKD,
+	TIMING_LOCKD_WAIT,
+	TIMING_LOCKD_LM,
+	TIMING_ACTIVATION,
+	TIMING_UDEV_WAIT,
+	TIMING_FLOCK_WAIT,
+	TIMING_PHASES
+} timing_phase_t;
+
+void timing_reset(void);
+void timing_start(timing_phase_t phase);
+void timing_end(timing_phase_t phase);
+/* Adds one call taking us microseconds measured elsewhere. */
+void timing_add(timing_phase_t phase, uint64_t us);
+
+struct bcache_stats;
+/* Adds the counters of a bcache about to be destroyed. */
+void timing_add_bcache_stats(const struct bcache_stats *stats);
+int timing_enabled(void);
+void timing_report(const char *cmd_name, int ret);
+
+#endif
@@ -615,6 +615,12 @@ static void _unlock_mem_if_possible(struct cmd_context *cmd)
  *
  * Memory stays locked until 'memlock_unlock()' is called so when possible
  * it may stay locked across multiple crictical section entrances.
+ * Callers do that on vg commit/revert and unlock, so a command suspending
+ * many LVs of one VG pays for _lock_mem()/_unlock_mem() (reserve, maps
+ * scan, mlock) once per commit, not once per LV.  Locking only a reserved
+ * arena is not enough: code and data of libc, libdevmapper, libudev and
+ * the lvm parsers run while devices are suspended, and the maps are read
+ * again on each lock because the heap and mappings change in between.
  */
 void critical_section_inc(struct cmd_context *cmd, const char *reason)
 {
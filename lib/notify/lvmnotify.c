@@ -10,8 +10,13 @@
 
 #include "lib/misc/lib.h"
 #include "lib/commands/toolcontext.h"
+#include "lib/metadata/metadata.h"
 #include "lib/notify/lvmnotify.h"
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
 #define LVM_DBUS_DESTINATION "com.redhat.lvmdbus1"
 #define LVM_DBUS_PATH        "/com/redhat/lvmdbus1/Manager"
 #define LVM_DBUS_INTERFACE   "com.redhat.lvmdbus1.Manager"
@@ -19,12 +24,12 @@
 #define LVM_DBUS_LOCK_FILE_ENV_KEY        "LVM_DBUSD_LOCKFILE"
 #define SD_BUS_SYSTEMD_NO_SUCH_UNIT_ERROR "org.freedesktop.systemd1.NoSuchUnit"
 #define SD_BUS_DBUS_SERVICE_UNKNOWN_ERROR "org.freedesktop.DBus.Error.ServiceUnknown"
+#define SD_BUS_DBUS_UNKNOWN_METHOD_ERROR  "org.freedesktop.DBus.Error.UnknownMethod"
 
 #ifdef NOTIFYDBUS_SUPPORT
 #include <systemd/sd-bus.h>
 #include <fcntl.h>
 #include <stdlib.h>
-#include <unistd.h>
 #include <errno.h>
 
 int lvmnotify_is_supported(void)
@@ -90,31 +95,101 @@ static int lvmdbusd_running(void)
 }
 
 
-void lvmnotify_send(struct cmd_context *cmd)
+/* ExternalEventVgs for a command that changed several VGs */
+static int _external_event_vgs(sd_bus *bus, sd_bus_error *error, sd_bus_message **m,
+			       const char *cmd_name, const struct notify_vg *vgs,
+			       unsigned vg_count)
+{
+	sd_bus_message *call = NULL;
+	unsigned i;
+	int ret;
+
+	if ((ret = sd_bus_message_new_method_call(bus, &call,
+						  LVM_DBUS_DESTINATION,
+						  LVM_DBUS_PATH,
+						  LVM_DBUS_INTERFACE,
+						  "ExternalEventVgs")) < 0 ||
+	    (ret = sd_bus_message_append(call, "s", cmd_name)) < 0 ||
+	    (ret = sd_bus_message_open_container(call, 'a', "(ssu)")) < 0)
+		goto out;
+
+	for (i = 0; i < vg_count; ++i)
+		if ((ret = sd_bus_message_append(call, "(ssu)", vgs[i].name,
+						 vgs[i].uuid, vgs[i].seqno)) < 0)
+			goto out;
+
+	if ((ret = sd_bus_message_close_container(call)) < 0)
+		goto out;
+
+	ret = sd_bus_call(bus, call, 0, error, m);
+out:
+	if (ret < 0 && !sd_bus_error_is_set(error))
+		sd_bus_error_set_errno(error, ret);
+	sd_bus_message_unref(call);
+
+	return ret;
+}
+
+static int _external_event(sd_bus *bus, sd_bus_error *error, sd_bus_message **m,
+			   const char *cmd_name, const struct notify_vg *vgs,
+			   unsigned vg_count)
+{
+	int ret;
+
+	/*
+	 * When the command changed known VGs, say which ones, so lvmdbusd
+	 * only needs to refresh the objects of these VGs.  An lvmdbusd
+	 * without ExternalEventVg(s) refreshes everything on ExternalEvent.
+	 */
+	if (vg_count == 1)
+		ret = sd_bus_call_method(bus,
+					 LVM_DBUS_DESTINATION,
+					 LVM_DBUS_PATH,
+					 LVM_DBUS_INTERFACE,
+					 "ExternalEventVg",
+					 error,
+					 m,
+					 "sssu",
+					 cmd_name, vgs[0].name, vgs[0].uuid, vgs[0].seqno);
+	else if (vg_count)
+		ret = _external_event_vgs(bus, error, m, cmd_name, vgs, vg_count);
+
+	if (vg_count) {
+		if ((ret >= 0) || !sd_bus_error_has_name(error, SD_BUS_DBUS_UNKNOWN_METHOD_ERROR))
+			return ret;
+
+		log_debug_dbus("D-Bus service has no ExternalEventVg%s, using ExternalEvent.",
+			       (vg_count > 1) ? "s" : "");
+		sd_bus_error_free(error);
+	}
+
+	return sd_bus_call_method(bus,
+				  LVM_DBUS_DESTINATION,
+				  LVM_DBUS_PATH,
+				  LVM_DBUS_INTERFACE,
+				  "ExternalEvent",
+				  error,
+				  m,
+				  "s",
+				  cmd_name);
+}
+
+static void _notify_dbus(const char *cmd_name, const struct notify_vg *vgs,
+			 unsigned vg_count)
 {
 	static const char _dbus_notification_failed_msg[] = "D-Bus notification failed";
 	sd_bus *bus = NULL;
 	sd_bus_message *m = NULL;
 	sd_bus_error error = SD_BUS_ERROR_NULL;
-	const char *cmd_name;
 	int ret;
 	int result = 0;
 
-	if (!cmd->vg_notify && !cmd->lv_notify && !cmd->pv_notify)
-		return;
-
-	cmd->vg_notify = 0;
-	cmd->lv_notify = 0;
-	cmd->pv_notify = 0;
-
 	/* If lvmdbusd isn't running, don't notify as you will start it as it will auto activate */
 	if (!lvmdbusd_running()) {
 		log_debug_dbus("dbus damon not running, not notifying");
 		return;
 	}
 
-	cmd_name = get_cmd_name();
-
 	ret = sd_bus_open_system(&bus);
 	if (ret < 0) {
 		log_debug_dbus("Failed to connect to dbus: %d", ret);
@@ -123,15 +198,7 @@ void lvmnotify_send(struct cmd_context *cmd)
 
 	log_debug_dbus("Nofify dbus at %s.", LVM_DBUS_DESTINATION);
 
-	ret = sd_bus_call_method(bus,
-				 LVM_DBUS_DESTINATION,
-				 LVM_DBUS_PATH,
-				 LVM_DBUS_INTERFACE,
-				 "ExternalEvent",
-				 &error,
-				 &m,
-				 "s",
-				 cmd_name);
+	ret = _external_event(bus, &error, &m, cmd_name, vgs, vg_count);
 
 	if (ret < 0) {
 		if (sd_bus_error_has_name(&error, SD_BUS_SYSTEMD_NO_SUCH_UNIT_ERROR) ||
@@ -153,43 +220,203 @@ out:
 	sd_bus_flush_close_unref(bus);
 }
 
-void set_vg_notify(struct cmd_context *cmd)
+#else
+
+int lvmnotify_is_supported(void)
 {
-	cmd->vg_notify = 1;
+	return 0;
 }
 
-void set_lv_notify(struct cmd_context *cmd)
+static void _notify_dbus(const char *cmd_name, const struct notify_vg *vgs,
+			 unsigned vg_count)
 {
-	cmd->lv_notify = 1;
 }
 
-void set_pv_notify(struct cmd_context *cmd)
+#endif
+
+/*
+ * Send the notification as a datagram, so the command never waits
+ * for the receiver, see global/notify_socket.
+ */
+static void _notify_socket(const char *socket_path, const char *cmd_name,
+			   const struct notify_vg *vgs, unsigned vg_count)
 {
-	cmd->pv_notify = 1;
+	struct sockaddr_un sun = { .sun_family = AF_UNIX };
+	char buf[64 + NOTIFY_VGS_MAX * (NAME_LEN + 64 + 16)];
+	int fd, len, pos;
+	unsigned i;
+
+	if (!dm_strncpy(sun.sun_path, socket_path, sizeof(sun.sun_path))) {
+		log_debug("Notify socket path %s is too long.", socket_path);
+		return;
+	}
+
+	if ((pos = dm_snprintf(buf, sizeof(buf), "command %s\n", cmd_name)) < 0)
+		goto_bad;
+
+	for (i = 0; i < vg_count; ++i, pos += len)
+		if ((len = dm_snprintf(buf + pos, sizeof(buf) - pos, "vg %s %s %u\n",
+				       vgs[i].name, vgs[i].uuid, vgs[i].seqno)) < 0)
+			goto_bad;
+
+	if (!vg_count) {
+		if ((len = dm_snprintf(buf + pos, sizeof(buf) - pos, "all\n")) < 0)
+			goto_bad;
+		pos += len;
+	}
+
+	if ((fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0)) < 0) {
+		log_sys_debug("socket", socket_path);
+		return;
+	}
+
+	if (sendto(fd, buf, pos, MSG_NOSIGNAL,
+		   (const struct sockaddr *) &sun, sizeof(sun)) < 0)
+		log_debug("Notify socket %s not notified: %s.",
+			  socket_path, strerror(errno));
+	else
+		log_debug("Notified socket %s.", socket_path);
+
+	if (close(fd))
+		log_sys_debug("close", socket_path);
+
+	return;
+bad:
+	log_debug("Notification for socket %s is too long.", socket_path);
 }
 
-#else
+static void _notify_reset(struct cmd_context *cmd)
+{
+	cmd->vg_notify = 0;
+	cmd->lv_notify = 0;
+	cmd->pv_notify = 0;
+	cmd->notify_vg_multiple = 0;
+	cmd->notify_vg_count = 0;
+	cmd->notify_dbus_pending = 0;
+	cmd->notify_socket_pending = NULL;
+}
 
-int lvmnotify_is_supported(void)
+static void _notify(struct cmd_context *cmd, const char *cmd_name,
+		    int dbus, const char *socket_path)
 {
-	return 0;
+	const struct notify_vg *vgs = NULL;
+	unsigned vg_count = 0;
+
+	/* PV changes may touch orphans, so no VGs are named then. */
+	if (!cmd->pv_notify && !cmd->notify_vg_multiple) {
+		vgs = cmd->notify_vgs;
+		vg_count = cmd->notify_vg_count;
+	}
+
+	if (socket_path && *socket_path)
+		_notify_socket(socket_path, cmd_name, vgs, vg_count);
+
+	if (dbus)
+		_notify_dbus(cmd_name, vgs, vg_count);
+
+	_notify_reset(cmd);
 }
 
+/*
+ * Called at the end of each command, with the command's configuration.
+ * Commands run in a batch only remember which channels to notify,
+ * and lvmnotify_flush() then sends one notification for all of them.
+ */
 void lvmnotify_send(struct cmd_context *cmd)
 {
+	const char *socket_path;
+	int dbus;
+
+	if (!cmd->vg_notify && !cmd->lv_notify && !cmd->pv_notify)
+		return;
+
+	dbus = lvmnotify_is_supported() &&
+		find_config_tree_bool(cmd, global_notify_dbus_CFG, NULL);
+	socket_path = find_config_tree_str(cmd, global_notify_socket_CFG, NULL);
+
+	if (cmd->notify_batch) {
+		if (dbus)
+			cmd->notify_dbus_pending = 1;
+		if (socket_path && *socket_path && !cmd->notify_socket_pending &&
+		    !(cmd->notify_socket_pending = dm_pool_strdup(cmd->libmem, socket_path)))
+			log_debug("Failed to remember notify socket %s.", socket_path);
+		return;
+	}
+
+	_notify(cmd, get_cmd_name(), dbus, socket_path);
+}
+
+void lvmnotify_batch(struct cmd_context *cmd)
+{
+	cmd->notify_batch = 1;
+}
+
+void lvmnotify_flush(struct cmd_context *cmd)
+{
+	cmd->notify_batch = 0;
+
+	if (!cmd->notify_dbus_pending && !cmd->notify_socket_pending) {
+		_notify_reset(cmd);
+		return;
+	}
+
+	_notify(cmd, "lvm", cmd->notify_dbus_pending, cmd->notify_socket_pending);
 }
 
 void set_vg_notify(struct cmd_context *cmd)
 {
+	cmd->vg_notify = 1;
 }
 
 void set_lv_notify(struct cmd_context *cmd)
 {
+	cmd->lv_notify = 1;
 }
 
 void set_pv_notify(struct cmd_context *cmd)
 {
+	cmd->pv_notify = 1;
 }
 
-#endif
+/*
+ * Remember the VGs changed since the last notification, so it can
+ * name them.
+ */
+void set_notify_vg(struct volume_group *vg)
+{
+	struct cmd_context *cmd = vg->cmd;
+	struct notify_vg *nvg;
+	char uuid[sizeof(nvg->uuid)];
+	unsigned i;
+
+	if (cmd->notify_vg_multiple)
+		return;
 
+	if (!id_write_format(&vg->id, uuid, sizeof(uuid))) {
+		cmd->notify_vg_multiple = 1;
+		return;
+	}
+
+	for (i = 0; i < cmd->notify_vg_count; ++i)
+		if (!strcmp(cmd->notify_vgs[i].uuid, uuid))
+			break;
+
+	if (i == NOTIFY_VGS_MAX) {
+		cmd->notify_vg_multiple = 1;
+		return;
+	}
+
+	nvg = &cmd->notify_vgs[i];
+
+	if (!dm_strncpy(nvg->name, vg->name, sizeof(nvg->name))) {
+		cmd->notify_vg_multiple = 1;
+		return;
+	}
+
+	if (i == cmd->notify_vg_count) {
+		memcpy(nvg->uuid, uuid, sizeof(uuid));
+		cmd->notify_vg_count++;
+	}
+
+	nvg->seqno = vg->seqno;
+}
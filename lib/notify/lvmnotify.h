@@ -13,9 +13,12 @@
 
 int lvmnotify_is_supported(void);
 void lvmnotify_send(struct cmd_context *cmd);
+void lvmnotify_batch(struct cmd_context *cmd);
+void lvmnotify_flush(struct cmd_context *cmd);
 void set_vg_notify(struct cmd_context *cmd);
 void set_lv_notify(struct cmd_context *cmd);
 void set_pv_notify(struct cmd_context *cmd);
+void set_notify_vg(struct volume_group *vg);
 
 #endif
 
@@ -133,6 +133,16 @@ static uint64_t _integritymismatches(const struct logical_volume *lv)
 	return cnt;
 }
 
+static dm_percent_t _integrity_recalc_percent(const struct logical_volume *lv)
+{
+	dm_percent_t percent;
+
+	if (!lv_integrity_recalc_percent(lv->vg->cmd, lv, &percent))
+		percent = DM_PERCENT_INVALID;
+
+	return percent;
+}
+
 static dm_percent_t _snap_percent(const struct logical_volume *lv)
 {
 	dm_percent_t percent;
@@ -351,6 +361,8 @@ GET_PV_STR_PROPERTY_FN(pv_device_id_type, pv->device_id_type)
 #define _writecache_free_blocks_get prop_not_implemented_get
 #define _writecache_writeback_blocks_set prop_not_implemented_set
 #define _writecache_writeback_blocks_get prop_not_implemented_get
+#define _writecache_dirty_blocks_set prop_not_implemented_set
+#define _writecache_dirty_blocks_get prop_not_implemented_get
 #define _writecache_error_set prop_not_implemented_set
 #define _writecache_error_get prop_not_implemented_get
 #define _writecache_block_size_set prop_not_implemented_set
@@ -474,6 +486,8 @@ GET_LV_NUM_PROPERTY_FN(raidintegrityblocksize, _raidintegrityblocksize(lv))
 #define _raidintegrityblocksize_set prop_not_implemented_set
 GET_LV_NUM_PROPERTY_FN(integritymismatches, _integritymismatches(lv))
 #define _integritymismatches_set prop_not_implemented_set
+GET_LV_NUM_PROPERTY_FN(integrity_recalc_percent, _integrity_recalc_percent(lv))
+#define _integrity_recalc_percent_set prop_not_implemented_set
 GET_LV_STR_PROPERTY_FN(move_pv, lv_move_pv_dup(lv->vg->vgmem, lv))
 #define _move_pv_set prop_not_implemented_set
 GET_LV_STR_PROPERTY_FN(move_pv_uuid, lv_move_pv_uuid_dup(lv->vg->vgmem, lv))
@@ -649,6 +663,8 @@ GET_LVSEG_STR_PROPERTY_FN(seg_monitor, lvseg_monitor_dup(lvseg->lv->vg->vgmem, l
 #define _kernel_cache_settings_set prop_not_implemented_set
 #define _kernel_cache_policy_get prop_not_implemented_get
 #define _kernel_cache_policy_set prop_not_implemented_set
+#define _cache_tuning_get prop_not_implemented_get
+#define _cache_tuning_set prop_not_implemented_set
 #define _kernel_metadata_format_get prop_not_implemented_get
 #define _kernel_metadata_format_set prop_not_implemented_set
 #define _integrity_settings_get prop_not_implemented_get
@@ -1585,6 +1585,20 @@ static int _kernel_cache_policy_disp(struct dm_report *rh, struct dm_pool *mem,
 				GET_FIELD_RESERVED_VALUE(cache_policy_undef));
 }
 
+static int _cache_tuning_disp(struct dm_report *rh, struct dm_pool *mem,
+			      struct dm_report_field *field,
+			      const void *data, void *private)
+{
+	const struct lv_with_info_and_seg_status *lvdm = (const struct lv_with_info_and_seg_status *) data;
+	const char *hint;
+
+	if ((lvdm->seg_status.type == SEG_STATUS_CACHE) &&
+	    (hint = cache_tuning_hint(mem, lvdm->seg_status.cache)))
+		return _field_string(rh, field, hint);
+
+	return _field_set_value(field, "", NULL);
+}
+
 static int _kernelmetadataformat_disp(struct dm_report *rh, struct dm_pool *mem,
 				      struct dm_report_field *field,
 				      const void *data, void *private)
@@ -3376,6 +3390,22 @@ static int _integritymismatches_disp(struct dm_report *rh __attribute__((unused)
 	return _field_set_value(field, "", &GET_TYPE_RESERVED_VALUE(num_undef_64));
 }
 
+static int _integrityrecalcpercent_disp(struct dm_report *rh,
+					struct dm_pool *mem __attribute__((unused)),
+					struct dm_report_field *field,
+					const void *data,
+					void *private __attribute__((unused)))
+{
+	const struct logical_volume *lv = (const struct logical_volume *) data;
+	dm_percent_t percent = DM_PERCENT_INVALID;
+
+	if ((lv_is_integrity(lv) || (lv_is_raid(lv) && lv_raid_has_integrity((struct logical_volume *)lv))) &&
+	    !lv_integrity_recalc_percent(lv->vg->cmd, lv, &percent))
+		percent = DM_PERCENT_INVALID;
+
+	return dm_report_field_percent(rh, field, &percent);
+}
+
 static int _integrity_settings_disp(struct dm_report *rh, struct dm_pool *mem,
 				    struct dm_report_field *field,
 				    const void *data, void *private)
@@ -4130,6 +4160,24 @@ GENERATE_WRITECACHE_STATUS_DISP_FN(free_blocks)
 GENERATE_WRITECACHE_STATUS_DISP_FN(writeback_blocks)
 GENERATE_WRITECACHE_STATUS_DISP_FN(error)
 
+static int _writecache_dirty_blocks_disp(struct dm_report *rh,
+					 struct dm_pool *mem __attribute__((unused)),
+					 struct dm_report_field *field,
+					 const void *data,
+					 void *private __attribute__((unused)))
+{
+	const struct lv_with_info_and_seg_status *lvdm = (const struct lv_with_info_and_seg_status *) data;
+	uint64_t dirty;
+
+	if (lvdm->seg_status.type != SEG_STATUS_WRITECACHE)
+		return _field_set_value(field, "", &GET_TYPE_RESERVED_VALUE(num_undef_64));
+
+	/* Same as lv_writecache_is_clean() counts them. */
+	dirty = lvdm->seg_status.writecache->total_blocks - lvdm->seg_status.writecache->free_blocks;
+
+	return dm_report_field_uint64(rh, field, &dirty);
+}
+
 /*
  * Macro to generate '_vdo_<vdo_field_name>_disp' reporting function.
  * The 'vdo_field_name' is field name from struct lv_vdo_status.
@@ -4470,6 +4518,52 @@ report_headings_t report_headings_str_to_type(const char *str)
 	return REPORT_HEADINGS_UNKNOWN;
 }
 
+/*
+ * VG fields with values that the label scan already found in the
+ * metadata summary of a VG (see lvmcache_vg_from_summary).
+ */
+static const char * const _vg_summary_fields[] = {
+	"vg_name", "vg_uuid", "vg_seqno", "vg_sysid", "vg_systemid",
+	"vg_lock_type", "vg_permissions", "vg_extendable", "vg_exported",
+	"vg_autoactivation", "vg_clustered", "vg_shared", "pv_count", NULL
+};
+
+/*
+ * Check if all fields in the comma separated list (options or sort keys)
+ * can be reported from the VG summary without reading the whole VG.
+ */
+int report_fields_from_vg_summary(const char *fields)
+{
+	const char * const *vsf;
+	const char *f, *e;
+	size_t len;
+
+	if (!fields)
+		return 1;
+
+	for (f = fields; *f; f = *e ? e + 1 : e) {
+		if (!(e = strchr(f, ',')))
+			e = f + strlen(f);
+
+		if ((*f == '+') || (*f == '-'))
+			f++;
+
+		if (!(len = e - f))
+			return 0;
+
+		for (vsf = _vg_summary_fields; *vsf; vsf++)
+			if ((strlen(*vsf) == len && !strncasecmp(*vsf, f, len)) ||
+			    (!strncmp(*vsf, "vg_", 3) && (strlen(*vsf) == len + 3) &&
+			     !strncasecmp(*vsf + 3, f, len)))
+				break;
+
+		if (!*vsf)
+			return 0;
+	}
+
+	return 1;
+}
+
 void *report_init(struct cmd_context *cmd, const char *format, const char *keys,
 		  unsigned *report_type, const char *separator,
 		  int aligned, int buffered, report_headings_t headings,
@@ -97,6 +97,7 @@ void *report_init(struct cmd_context *cmd, const char *format, const char *keys,
 		  int aligned, int buffered, report_headings_t headings,
 		  int field_prefixes, int quoted, int columns_as_rows,
 		  const char *selection, int multiple_output);
+int report_fields_from_vg_summary(const char *fields);
 int report_get_single_selection(struct cmd_context *cmd, unsigned report_type, const char **selection);
 void *report_init_for_selection(struct cmd_context *cmd, unsigned *report_type,
 				const char *selection);
@@ -438,6 +438,13 @@ static int _target_registered(struct lv_segment *seg, int *pending, int *monitor
 /* FIXME This gets run while suspended and performs banned operations. */
 static int _target_set_events(struct lv_segment *seg, int evmask, int set)
 {
+	/*
+	 * Data usage crossing thin_pool_autoextend_threshold is already
+	 * event driven: the pool's low_water_mark is set from it and the
+	 * kernel event runs the policy immediately.  The timeout is still
+	 * needed for metadata usage and the 5% step warnings, which the
+	 * kernel does not signal.
+	 */
 	/* FIXME Make timeout (10) configurable */
 	return target_register_events(seg->lv->vg->cmd,
 				      seg->segtype->dso,
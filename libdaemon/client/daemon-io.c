@@ -17,6 +17,7 @@
 #include "daemon-io.h"
 
 #include <errno.h>
+#include <sys/uio.h>
 
 /*
  * Read a single message from a (socket) filedescriptor. Messages are delimited
@@ -29,7 +30,8 @@
 int buffer_read(int fd, struct buffer *buffer) {
 	int result;
 
-	if (!buffer_realloc(buffer, 32)) /* ensure we have some space */
+	if ((buffer->allocated - buffer->used < 32) &&
+	    !buffer_realloc(buffer, 32)) /* ensure we have some space */
 		return 0;
 
 	while (1) {
@@ -64,28 +66,41 @@ int buffer_read(int fd, struct buffer *buffer) {
 /*
  * Write a buffer to a filedescriptor. Keep trying. Blocks (even on
  * SOCK_NONBLOCK) until all of the write went through.
+ * The message and its terminator go out with one writev() so the peer
+ * normally receives the whole frame in a single read.
  */
 int buffer_write(int fd, const struct buffer *buffer) {
-	static const struct buffer _terminate = { .mem = (char *) "\n##\n", .used = 4 };
-	const struct buffer *use;
-	int done, written, result;
+	static const char _terminate[] = "\n##\n";
+	struct iovec iov[2] = {
+		{ .iov_base = buffer->mem, .iov_len = buffer->used },
+		{ .iov_base = (void *) _terminate, .iov_len = sizeof(_terminate) - 1 },
+	};
+	struct iovec *use = iov;
+	int count = 2;
+	ssize_t result;
 
-	for (done = 0; done < 2; ++done) {
-		use = (done == 0) ? buffer : &_terminate;
-		for (written = 0; written < use->used;) {
-			result = write(fd, use->mem + written, use->used - written);
-			if (result > 0)
-				written += result;
-			else if (result < 0 && (errno == EAGAIN ||
-						errno == EINTR || errno == EIO)) {
-				fd_set out;
-				FD_ZERO(&out);
-				FD_SET(fd, &out);
-				/* ignore the result, this is just a glorified sleep */
-				select(FD_SETSIZE, NULL, &out, NULL, NULL);
-			} else if (result < 0)
-				return 0; /* too bad */
-		}
+	while (count) {
+		result = writev(fd, use, count);
+		if (result > 0) {
+			/* Skip fully written parts, advance into a partial one */
+			while (count && ((size_t) result >= use->iov_len)) {
+				result -= use->iov_len;
+				use++;
+				count--;
+			}
+			if (count) {
+				use->iov_base = (char *) use->iov_base + result;
+				use->iov_len -= result;
+			}
+		} else if (result < 0 && (errno == EAGAIN ||
+					  errno == EINTR || errno == EIO)) {
+			fd_set out;
+			FD_ZERO(&out);
+			FD_SET(fd, &out);
+			/* ignore the result, this is just a glorified sleep */
+			select(FD_SETSIZE, NULL, &out, NULL, NULL);
+		} else if (result < 0)
+			return 0; /* too bad */
 	}
 
 	return 1;
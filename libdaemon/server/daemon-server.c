@@ -472,7 +472,7 @@ static void *_client_thread(void *state)
 
 		if (req.cft)
 			dm_config_destroy(req.cft);
-		buffer_destroy(&req.buffer);
+		req.buffer.used = 0; /* keep memory for the next request on this connection */
 
 		daemon_log_multi(ts->s.log, DAEMON_LOG_WIRE, "-> ", res.buffer.mem);
 		buffer_write(ts->client.socket_fd, &res.buffer);
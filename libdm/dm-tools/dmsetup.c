@@ -243,6 +243,8 @@ typedef enum {
 	DR_NAME = 16,
 	DR_STATS = 32,  /* Requires populated stats handle. */
 	DR_STATS_META = 64, /* Requires listed stats handle. */
+	DR_LIST_TASK = 128, /* Name fields available from DM_DEVICE_LIST. */
+	DR_LIST_INFO = 256, /* Info fields available from DM_DEVICE_LIST. */
 } report_type_t;
 
 typedef enum {
@@ -441,6 +443,7 @@ struct dm_split_name {
 struct dmsetup_report_obj {
 	struct dm_task *task;
 	struct dm_info *info;
+	const struct dm_active_device *dev;
 	struct dm_task *deps_task;
 	struct dm_tree_node *tree_node;
 	struct dm_split_name *split_name;
@@ -861,7 +864,8 @@ out:
 	return r;
 }
 
-static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
+static int _display_info_cols(struct dm_task *dmt, struct dm_info *info,
+			      const struct dm_active_device *dev)
 {
 	struct dmsetup_report_obj obj;
 	uint64_t walk_flags = _statstype;
@@ -871,6 +875,7 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 
 	obj.task = dmt;
 	obj.info = info;
+	obj.dev = dev;
 	obj.deps_task = NULL;
 	obj.split_name = NULL;
 	obj.stats = NULL;
@@ -888,8 +893,7 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 		}
 
 	if (_report_type & DR_NAME)
-		if (!(obj.split_name = _get_split_name(dm_task_get_uuid(dmt),
-						       dm_task_get_name(dmt), '-')))
+		if (!(obj.split_name = _get_split_name(dev->uuid, dev->name, '-')))
 			goto_out;
 
 	if (!(_report_type & (DR_STATS | DR_STATS_META))) {
@@ -900,7 +904,7 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 		if (!dm_report_object_is_selected(_report, &obj, _selection_cmd ? 0 : 1, &selected))
 			goto_out;
 		if (_selection_cmd && selected) {
-			device_name = (char*) dm_task_get_name(dmt);
+			device_name = (char*) dev->name;
 			/* coverity[overrun-buffer-val] _setgeometry never called from this place */
 			if (!_selection_cmd->fn(_selection_cmd, NULL, 1, &device_name, NULL, 1))
 				goto_out;
@@ -912,6 +916,11 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 	/*
 	 * Obtain statistics for the current reporting object and set
 	 * the interval estimate used for stats rate conversion.
+	 *
+	 * The handle is not kept across intervals: dm_stats_populate()
+	 * re-lists and rebuilds the region table on every call anyway, and
+	 * @stats_print_clear leaves the interval deltas in the kernel, so
+	 * there is no history in the handle worth keeping.
 	 */
 	if (_report_type & DR_STATS) {
 		if (!(obj.stats = dm_stats_create(DM_STATS_PROGRAM_ID)))
@@ -1015,6 +1024,7 @@ static void _display_info_long(struct dm_task *dmt, struct dm_info *info)
 
 static int _display_info(struct dm_task *dmt)
 {
+	struct dm_active_device dev = { .name = NULL };
 	struct dm_info info;
 	int r = 1;
 
@@ -1028,8 +1038,13 @@ static int _display_info(struct dm_task *dmt)
 
 	if (!_switches[COLS_ARG])
 		_display_info_long(dmt, &info);
-	else
-		r = _display_info_cols(dmt, &info);
+	else {
+		dev.devno = MKDEV(info.major, info.minor);
+		dev.name = dm_task_get_name(dmt);
+		dev.uuid = dm_task_get_uuid(dmt);
+		dev.event_nr = info.event_nr;
+		r = _display_info_cols(dmt, &info, &dev);
+	}
 
 	return r;
 }
@@ -2108,6 +2123,13 @@ static int _wait(CMD_ARGS)
 		       (argc) ? (uint32_t) atoi(argv[argc - 1]) : 0, 1);
 }
 
+/*
+ * Devices are processed one by one with one task each.  The dm ioctl
+ * interface has no batched command and libdm keeps per-process state
+ * (control fd, suspended counter, udev cookies), so tasks cannot be run
+ * from a thread pool either; DM_DEVICE_LIST is the only bulk query and
+ * it is used here to avoid a lookup per device.
+ */
 static int _process_all(const struct command *cmd, const char *subcommand, int argc, char **argv, int silent,
 			int (*fn) (CMD_ARGS))
 {
@@ -2630,6 +2652,62 @@ out:
 	return r;
 }
 
+/*
+ * Report all devices straight from one DM_DEVICE_LIST when every field
+ * used by the report is available there, e.g. 'info -c -o name,uuid,events',
+ * instead of running DM_DEVICE_INFO for each device.
+ * Returns -1 when the kernel does not list event numbers and uuids.
+ */
+static int _info_from_device_list(void)
+{
+	const unsigned needed = DM_DEVICE_LIST_HAS_EVENT_NR | DM_DEVICE_LIST_HAS_UUID;
+	struct dm_list *devs = NULL;
+	struct dm_active_device *dev;
+	struct dm_task *dmt;
+	struct dm_info info;
+	unsigned devs_features;
+	int r = 0;
+
+	if (!(dmt = dm_task_create(DM_DEVICE_LIST)))
+		return_0;
+
+	if (_switches[CHECKS_ARG] && !dm_task_enable_checks(dmt))
+		goto_out;
+
+	if (!_task_run(dmt))
+		goto_out;
+
+	if (!dm_task_get_device_list(dmt, &devs, &devs_features))
+		goto_out;
+
+	if ((devs_features & needed) != needed) {
+		r = -1;
+		goto out;
+	}
+
+	if (dm_list_empty(devs))
+		printf("No devices found\n");
+
+	r = 1;
+	dm_list_iterate_items(dev, devs) {
+		memset(&info, 0, sizeof(info));
+		info.exists = 1;
+		info.major = (int) MAJOR(dev->devno);
+		info.minor = (int) MINOR(dev->devno);
+		info.event_nr = dev->event_nr;
+		info.open_count = -1;
+		info.target_count = -1;
+		if (!_display_info_cols(NULL, &info, dev))
+			r = 0;
+	}
+
+out:
+	dm_device_list_destroy(&devs);
+	dm_task_destroy(dmt);
+
+	return r;
+}
+
 static int _info(CMD_ARGS)
 {
 	int r = 0;
@@ -2640,8 +2718,13 @@ static int _info(CMD_ARGS)
 	if (names)
 		name = names->name;
 	else {
-		if (!argc && !_switches[UUID_ARG] && !_switches[MAJOR_ARG])
+		if (!argc && !_switches[UUID_ARG] && !_switches[MAJOR_ARG]) {
+			if (_switches[COLS_ARG] &&
+			    !(_report_type & ~(DR_LIST_TASK | DR_LIST_INFO)) &&
+			    ((r = _info_from_device_list()) >= 0))
+				return r;
 			return _process_all(cmd, NULL, argc, argv, 0, _info);
+		}
 		name = argv[0];
 	}
 
@@ -3174,7 +3257,7 @@ static int _dm_name_disp(struct dm_report *rh,
 			 struct dm_report_field *field, const void *data,
 			 void *private __attribute__((unused)))
 {
-	const char *name = dm_task_get_name((const struct dm_task *) data);
+	const char *name = ((const struct dm_active_device *) data)->name;
 
 	return dm_report_field_string(rh, field, &name);
 }
@@ -3216,7 +3299,7 @@ static int _dm_uuid_disp(struct dm_report *rh,
 			 struct dm_report_field *field,
 			 const void *data, void *private __attribute__((unused)))
 {
-	const char *uuid = dm_task_get_uuid((const struct dm_task *) data);
+	const char *uuid = ((const struct dm_active_device *) data)->uuid;
 
 	if (!uuid || !*uuid)
 		uuid = "";
@@ -4037,6 +4120,71 @@ static int _dm_stats_hist_percent_ranges_disp(struct dm_report *rh,
 	return _stats_hist_percent_disp(rh, field, data, DM_HISTOGRAM_BOUNDS_RANGE);
 }
 
+/* Display the bin bound holding a latency percentile, in msecs */
+static int _stats_hist_percentile_disp(struct dm_report *rh, struct dm_pool *mem,
+				       struct dm_report_field *field, const void *data,
+				       dm_percent_t percent)
+{
+	const struct dm_stats *dms = (const struct dm_stats *) data;
+	const struct dm_histogram *dmh;
+	uint64_t upper;
+	double *sortval;
+	char buf[64];
+	char *repstr;
+
+	if (!(sortval = dm_pool_zalloc(mem, sizeof(*sortval))))
+		return_0;
+
+	if (!(dmh = dm_stats_get_histogram(dms, DM_STATS_REGION_CURRENT,
+					   DM_STATS_AREA_CURRENT)) ||
+	    !dm_histogram_get_sum(dmh)) {
+		/* No histogram or no I/O. */
+		dm_report_field_set_value(field, "", sortval);
+		return 1;
+	}
+
+	upper = dm_histogram_get_percentile(dmh, percent);
+
+	if (upper == UINT64_MAX) {
+		/* Last bin: report its lower bound. */
+		*sortval = (double) dm_histogram_get_bin_lower(dmh,
+				dm_histogram_get_nr_bins(dmh) - 1) / NSEC_PER_MSEC;
+		if (dm_snprintf(buf, sizeof(buf), ">%.2f", *sortval) < 0)
+			return_0;
+	} else {
+		*sortval = (double) upper / NSEC_PER_MSEC;
+		if (dm_snprintf(buf, sizeof(buf), "%.2f", *sortval) < 0)
+			return_0;
+	}
+
+	if (!(repstr = dm_pool_strdup(mem, buf)))
+		return_0;
+
+	dm_report_field_set_value(field, repstr, sortval);
+	return 1;
+}
+
+static int _dm_stats_hist_p50_disp(struct dm_report *rh, struct dm_pool *mem,
+				   struct dm_report_field *field, const void *data,
+				   void *private __attribute__((unused)))
+{
+	return _stats_hist_percentile_disp(rh, mem, field, data, DM_PERCENT_1 * 50);
+}
+
+static int _dm_stats_hist_p99_disp(struct dm_report *rh, struct dm_pool *mem,
+				   struct dm_report_field *field, const void *data,
+				   void *private __attribute__((unused)))
+{
+	return _stats_hist_percentile_disp(rh, mem, field, data, DM_PERCENT_1 * 99);
+}
+
+static int _dm_stats_hist_p999_disp(struct dm_report *rh, struct dm_pool *mem,
+				    struct dm_report_field *field, const void *data,
+				    void *private __attribute__((unused)))
+{
+	return _stats_hist_percentile_disp(rh, mem, field, data, DM_PERCENT_1 * 999 / 10);
+}
+
 static int _stats_hist_bounds_disp(struct dm_report *rh,
 				   struct dm_report_field *field, const void *data,
 				   int bounds)
@@ -4551,6 +4699,11 @@ static void *_info_get_obj(void *obj)
 	return ((struct dmsetup_report_obj *)obj)->info;
 }
 
+static void *_dev_get_obj(void *obj)
+{
+	return (void *) ((struct dmsetup_report_obj *)obj)->dev;
+}
+
 static void *_deps_get_obj(void *obj)
 {
 	return dm_task_get_deps(((struct dmsetup_report_obj *)obj)->deps_task);
@@ -4571,9 +4724,18 @@ static void *_stats_get_obj(void *obj)
 	return ((struct dmsetup_report_obj *)obj)->stats;
 }
 
+/*
+ * Fields available from DM_DEVICE_LIST alone use their own report types
+ * but share the section and prefix with the remaining name and info fields.
+ */
+static const char _name_desc[] = "Mapped Device Name";
+static const char _info_desc[] = "Mapped Device Information";
+
 static const struct dm_report_object_type _report_types[] = {
-	{ DR_TASK, "Mapped Device Name", "name_", _task_get_obj },
-	{ DR_INFO, "Mapped Device Information", "info_", _info_get_obj },
+	{ DR_LIST_TASK, _name_desc, "name_", _dev_get_obj },
+	{ DR_TASK, _name_desc, "name_", _task_get_obj },
+	{ DR_LIST_INFO, _info_desc, "info_", _info_get_obj },
+	{ DR_INFO, _info_desc, "info_", _info_get_obj },
 	{ DR_DEPS, "Mapped Device Relationship Information", "deps_", _deps_get_obj },
 	{ DR_TREE, "Mapped Device Relationship Information", "tree_", _tree_get_obj },
 	{ DR_NAME, "Mapped Device Name Components", "splitname_", _split_name_get_obj },
@@ -4594,27 +4756,27 @@ static const struct dm_report_object_type _report_types[] = {
 
 static const struct dm_report_field_type _report_fields[] = {
 /* *INDENT-OFF* */
-FIELD_F(TASK, STR, "Name", 16, dm_name, "name", "Name of mapped device.")
+FIELD_F(LIST_TASK, STR, "Name", 16, dm_name, "name", "Name of mapped device.")
 FIELD_F(TASK, STR, "MangledName", 16, dm_mangled_name, "mangled_name", "Mangled name of mapped device.")
 FIELD_F(TASK, STR, "UnmangledName", 16, dm_unmangled_name, "unmangled_name", "Unmangled name of mapped device.")
-FIELD_F(TASK, STR, "UUID", 32, dm_uuid, "uuid", "Unique (optional) identifier for mapped device.")
+FIELD_F(LIST_TASK, STR, "UUID", 32, dm_uuid, "uuid", "Unique (optional) identifier for mapped device.")
 FIELD_F(TASK, STR, "MangledUUID", 32, dm_mangled_uuid, "mangled_uuid", "Mangled unique (optional) identifier for mapped device.")
 FIELD_F(TASK, STR, "UnmangledUUID", 32, dm_unmangled_uuid, "unmangled_uuid", "Unmangled unique (optional) identifier for mapped device.")
 
 /* FIXME Next one should be INFO */
 FIELD_F(TASK, NUM, "RAhead", 6, dm_read_ahead, "read_ahead", "Read ahead value.")
 
-FIELD_F(INFO, STR, "BlkDevName", 16, dm_blk_name, "blkdevname", "Name of block device.")
+FIELD_F(LIST_INFO, STR, "BlkDevName", 16, dm_blk_name, "blkdevname", "Name of block device.")
 FIELD_F(INFO, STR, "Stat", 4, dm_info_status, "attr", "(L)ive, (I)nactive, (s)uspended, (r)ead-only, read-(w)rite.")
 FIELD_F(INFO, STR, "Tables", 6, dm_info_table_loaded, "tables_loaded", "Which of the live and inactive table slots are filled.")
 FIELD_F(INFO, STR, "Suspended", 9, dm_info_suspended, "suspended", "Whether the device is suspended.")
 FIELD_F(INFO, STR, "Read-only", 9, dm_info_read_only, "readonly", "Whether the device is read-only or writeable.")
-FIELD_F(INFO, STR, "DevNo", 5, dm_info_devno, "devno", "Device major and minor numbers")
-FIELD_O(INFO, dm_info, NUM, "Maj", major, 3, int32, "major", "Block device major number.")
-FIELD_O(INFO, dm_info, NUM, "Min", minor, 3, int32, "minor", "Block device minor number.")
+FIELD_F(LIST_INFO, STR, "DevNo", 5, dm_info_devno, "devno", "Device major and minor numbers")
+FIELD_O(LIST_INFO, dm_info, NUM, "Maj", major, 3, int32, "major", "Block device major number.")
+FIELD_O(LIST_INFO, dm_info, NUM, "Min", minor, 3, int32, "minor", "Block device minor number.")
 FIELD_O(INFO, dm_info, NUM, "Open", open_count, 4, int32, "open", "Number of references to open device, if requested.")
 FIELD_O(INFO, dm_info, NUM, "Targ", target_count, 4, int32, "segments", "Number of segments in live table, if present.")
-FIELD_O(INFO, dm_info, NUM, "Event", event_nr, 6, uint32, "events", "Number of most recent event.")
+FIELD_O(LIST_INFO, dm_info, NUM, "Event", event_nr, 6, uint32, "events", "Number of most recent event.")
 
 FIELD_O(DEPS, dm_deps, NUM, "#Devs", count, 5, int32, "device_count", "Number of devices used by this one.")
 FIELD_F(TREE, STR, "DevNamesUsed", 16, dm_deps_names, "devs_used", "List of names of mapped devices used by this one.")
@@ -4668,6 +4830,9 @@ FIELD_F(STATS, STR, "Histogram Counts", 16, dm_stats_hist_count_ranges, "hist_co
 FIELD_F(STATS, STR, "Histogram%", 10, dm_stats_hist_percent, "hist_percent", "Relative latency histogram.")
 FIELD_F(STATS, STR, "Histogram%", 10, dm_stats_hist_percent_bounds, "hist_percent_bounds", "Relative latency histogram with bin boundaries.")
 FIELD_F(STATS, STR, "Histogram%", 10, dm_stats_hist_percent_ranges, "hist_percent_ranges", "Relative latency histogram with bin ranges.")
+FIELD_F(STATS, NUM, "P50", 3, dm_stats_hist_p50, "hist_p50", "Latency histogram bin bound holding the 50th percentile.")
+FIELD_F(STATS, NUM, "P99", 3, dm_stats_hist_p99, "hist_p99", "Latency histogram bin bound holding the 99th percentile.")
+FIELD_F(STATS, NUM, "P99.9", 5, dm_stats_hist_p999, "hist_p999", "Latency histogram bin bound holding the 99.9th percentile.")
 
 /* Stats interval duration estimates */
 FIELD_F(STATS, NUM, "IntervalNs", 10, dm_stats_sample_interval_ns, "interval_ns", "Sampling interval in nanoseconds.")
@@ -5234,9 +5399,10 @@ static int _do_stats_create_regions(struct dm_stats *dms,
 {
 	uint64_t this_start = 0, this_len = len, region_id = UINT64_C(0);
 	const char *devname = NULL, *histogram = _string_args[BOUNDS_ARG];
-	int r = 0, count = 0, precise = _switches[PRECISE_ARG];
+	int r = 0, i, count = 0, precise = _switches[PRECISE_ARG];
 	struct dm_histogram *bounds = NULL; /* histogram bounds */
 	uint64_t *region_ids = NULL; /* segments */
+	uint64_t *starts = NULL, *lens = NULL;
 	char *target_type, *params; /* unused */
 	struct dm_task *dmt;
 	struct dm_info info;
@@ -5275,13 +5441,18 @@ static int _do_stats_create_regions(struct dm_stats *dms,
 	if (!(devname = dm_task_get_name(dmt)))
 		goto_out;
 
-	if (!segments || (info.target_count == 1))
+	if (!segments || (info.target_count == 1)) {
 		region_ids = &region_id;
-	else
-		if (!(region_ids = malloc(info.target_count * sizeof(*region_ids)))) {
+		starts = &this_start;
+		lens = &this_len;
+	} else {
+		if (!(region_ids = malloc(3 * info.target_count * sizeof(*region_ids)))) {
 			log_error("Failed to allocated region IDs.");
 			goto out;
 		}
+		starts = region_ids + info.target_count;
+		lens = starts + info.target_count;
+	}
 
 	do {
 		uint64_t segment_start, segment_len;
@@ -5295,31 +5466,33 @@ static int _do_stats_create_regions(struct dm_stats *dms,
 		/* Segments or whole-device. */
 		if (segments || !next) {
 			/*
-			 * this_start and this_len hold the start and length in
-			 * sectors of the to-be-created region: this is either the
+			 * starts and lens hold the start and length in sectors
+			 * of the to-be-created regions: this is either the
 			 * segment start/len (for --segments), the value of the
 			 * --start/--length arguments, or 0/0 for a default
 			 *  whole-device region).
 			 */
-			this_start = (segments) ? segment_start : start;
-			this_len = (segments) ? segment_len : this_len;
 			/* coverity[ptr_arith] intentional */
-			if (!(r = dm_stats_create_region(dms, &region_ids[count],
-							 this_start, this_len, step,
-							 precise, bounds,
-							 program_id, user_data))) {
-				log_error("%s: Could not create statistics region.",
-					  devname);
-				goto out;
-			}
-
-			printf("%s: Created new region with "FMTu64" area(s) as "
-			       "region ID "FMTu64"\n", devname,
-			       _nr_areas_from_step(this_len, step),
-			       region_ids[count++]);
+			starts[count] = (segments) ? segment_start : start;
+			lens[count] = (segments) ? segment_len : this_len;
+			count++;
 		}
 	} while (next);
 
+	/* Create all regions with a single call. */
+	if (!(r = dm_stats_create_regions(dms, count, starts, lens, step,
+					  precise, bounds, program_id,
+					  user_data, region_ids))) {
+		log_error("%s: Could not create statistics region%s.",
+			  devname, (count > 1) ? "s" : "");
+		goto out;
+	}
+
+	for (i = 0; i < count; i++)
+		printf("%s: Created new region with "FMTu64" area(s) as "
+		       "region ID "FMTu64"\n", devname,
+		       _nr_areas_from_step(lens[i], step), region_ids[i]);
+
 	if (!_switches[NOGROUP_ARG] && segments)
 		r = _stats_group_segments(dms, region_ids, count,
 					  _string_args[ALIAS_ARG]);
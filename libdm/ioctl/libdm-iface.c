@@ -79,12 +79,13 @@ static struct dm_timestamp *_dm_ioctl_timestamp = NULL;
 static unsigned _dm_multiple_major_support = 1;
 static dm_bitset_t _dm_bitset = NULL;
 static uint32_t _dm_device_major = 0;
+/* Set when dm was not in PROC_DEVICES, until the control node is opened. */
+static int _dm_device_major_missing = 0;
 
 static int _control_fd = -1;
 static int _hold_control_fd_open = 0;
 static int _version_checked = 0;
 static int _version_ok = 1;
-static unsigned _ioctl_buffer_double_factor = 0;
 
 /* *INDENT-OFF* */
 static const struct cmd_data _cmd_data_v4[] = {
@@ -122,6 +123,12 @@ static const struct cmd_data _cmd_data_v4[] = {
 };
 /* *INDENT-ON* */
 
+/*
+ * Buffer growth remembered per task type.  A large DM_DEVICE_LIST must not
+ * make every following small INFO or DEPS ioctl allocate and copy its size.
+ */
+static unsigned _ioctl_buffer_double_factor[DM_ARRAY_SIZE(_cmd_data_v4)];
+
 #define ALIGNMENT 8
 
 /* FIXME Rejig library to record & use errno instead */
@@ -347,6 +354,10 @@ static int _create_dm_bitset(int require_module_loaded)
 	if (_dm_bitset || _dm_device_major)
 		return 1;
 
+	/* Don't reparse PROC_DEVICES for each device checked without dm-mod. */
+	if (!require_module_loaded && _dm_device_major_missing)
+		return 1;
+
 	if (!_uname())
 		return 0;
 
@@ -360,9 +371,10 @@ static int _create_dm_bitset(int require_module_loaded)
 		_dm_multiple_major_support = 0;
 
 	if (!_dm_multiple_major_support) {
-		if (!_get_proc_number(PROC_DEVICES, DM_NAME, &_dm_device_major,
-				      require_module_loaded))
+		if (!(r = _get_proc_number(PROC_DEVICES, DM_NAME, &_dm_device_major,
+					   require_module_loaded)))
 			return 0;
+		_dm_device_major_missing = (r == 2);
 		return 1;
 	}
 
@@ -374,6 +386,7 @@ static int _create_dm_bitset(int require_module_loaded)
 	if (!r || r == 2) {
 		dm_bitset_destroy(_dm_bitset);
 		_dm_bitset = NULL;
+		_dm_device_major_missing = (r == 2);
 		/*
 		 * It's not an error if we didn't find anything and we
 		 * didn't require module to be loaded at the same time.
@@ -789,6 +802,97 @@ static int _check_has_event_nr(void) {
 	return _has_event_nr;
 }
 
+int dm_task_get_device_list(struct dm_task *dmt, struct dm_list **devs_list,
+			    unsigned *devs_features)
+{
+	struct dm_names *names, *names1;
+	struct dm_active_device *dm_dev, *dm_new_dev;
+	struct dm_list *devs;
+	unsigned next = 0;
+	uint32_t *event_nr;
+	char *uuid_ptr;
+	size_t len;
+	int cnt = 0;
+
+	*devs_list = 0;
+	*devs_features = 0;
+
+	if ((names = dm_task_get_names(dmt)) && names->dev) {
+		names1 = names;
+		if (!names->name[0])
+			cnt = -1; /* -> cnt == 0 when no device is really present */
+		do {
+			names1 = (struct dm_names *)((char *) names1 + next);
+			next = names1->next;
+			++cnt;
+		} while (next);
+	}
+
+	/* buffer for devs +  sorted ptrs + dm_devs + aligned strings */
+	if (!(devs = malloc(sizeof(*devs) + cnt * (2 * sizeof(void*) + sizeof(*dm_dev)) +
+			    (cnt ? (char*)names1 - (char*)names + 256 : 0))))
+		return_0;
+
+	dm_list_init(devs);
+
+	if (!cnt) {
+		/* nothing in the list -> mark all features present */
+		*devs_features |= (DM_DEVICE_LIST_HAS_EVENT_NR | DM_DEVICE_LIST_HAS_UUID);
+		goto out; /* nothing else to do */
+	}
+
+	/* Shift position where to store individual dm_devs */
+	dm_dev = (struct dm_active_device *) ((long*) (devs + 1) + cnt);
+
+	do {
+		names = (struct dm_names *)((char *) names + next);
+
+		dm_dev->devno = (dev_t) names->dev;
+		dm_dev->name = (const char *)(dm_dev + 1);
+		dm_dev->event_nr = 0;
+		dm_dev->uuid = "";
+
+		len = strlen(names->name) + 1;
+		memcpy((char*)dm_dev->name, names->name, len);
+
+		dm_new_dev = _align_ptr((char*)(dm_dev + 1) + len);
+		if (_check_has_event_nr()) {
+
+			*devs_features |= DM_DEVICE_LIST_HAS_EVENT_NR;
+			event_nr = _align_ptr(names->name + len);
+			dm_dev->event_nr = event_nr[0];
+
+			if ((event_nr[1] & DM_NAME_LIST_FLAG_HAS_UUID)) {
+				*devs_features |= DM_DEVICE_LIST_HAS_UUID;
+				uuid_ptr = _align_ptr(event_nr + 2);
+				len = strlen(uuid_ptr) + 1;
+				memcpy(dm_new_dev, uuid_ptr, len);
+				dm_dev->uuid = (const char *) dm_new_dev;
+				dm_new_dev = _align_ptr((char*)dm_new_dev + len);
+			}
+		}
+
+		dm_list_add(devs, &dm_dev->list);
+		dm_dev = dm_new_dev;
+		next = names->next;
+	} while (next);
+
+    out:
+	*devs_list = devs;
+
+	return 1;
+}
+
+void dm_device_list_destroy(struct dm_list **devs_list)
+{
+	struct dm_device_list *devs = (struct dm_device_list *) *devs_list;
+
+	if (devs) {
+		free(devs);
+		*devs_list = NULL;
+	}
+}
+
 struct dm_names *dm_task_get_names(struct dm_task *dmt)
 {
 	return (struct dm_names *) (((char *) dmt->dmi.v4) +
@@ -2122,7 +2226,7 @@ DM_EXPORT_NEW_SYMBOL(int, dm_task_run, 1_02_197)
 
 	/* FIXME Detect and warn if cookie set but should not be. */
 repeat_ioctl:
-	if (!(dmi = _do_dm_ioctl(dmt, command, _ioctl_buffer_double_factor,
+	if (!(dmi = _do_dm_ioctl(dmt, command, _ioctl_buffer_double_factor[dmt->type],
 				 ioctl_retry, &retryable))) {
 		/*
 		 * Async udev rules that scan devices commonly cause transient
@@ -2149,7 +2253,7 @@ repeat_ioctl:
 		case DM_DEVICE_TABLE:
 		case DM_DEVICE_WAITEVENT:
 		case DM_DEVICE_TARGET_MSG:
-			_ioctl_buffer_double_factor++;
+			_ioctl_buffer_double_factor[dmt->type]++;
 			_dm_zfree_dmi(dmi);
 			goto repeat_ioctl;
 		default:
@@ -2262,6 +2366,7 @@ void dm_lib_exit(void)
 	if (_dm_bitset)
 		dm_bitset_destroy(_dm_bitset);
 	_dm_bitset = NULL;
+	_dm_device_major_missing = 0;
 	dm_pools_check_leaks();
 	dm_dump_memory();
 	_version_ok = 1;
@@ -685,6 +685,29 @@ int dm_stats_create_region(struct dm_stats *dms, uint64_t *region_id,
 			   int precise, struct dm_histogram *bounds,
 			   const char *program_id, const char *user_data);
 
+/*
+ * Create nr_regions statistics regions on the device bound to dms.
+ *
+ * The start and length of region i are given by starts[i] and lens[i]
+ * and all regions share the step, precise, bounds, program_id and
+ * user_data arguments, which have the same meaning as for
+ * dm_stats_create_region(). This avoids building the common message
+ * arguments and a new message task for every region when creating
+ * many regions at once.
+ *
+ * The region_id values of the new regions are returned in the array
+ * region_ids, which must have space for nr_regions entries.
+ *
+ * If any region cannot be created the regions already created by the
+ * call are deleted again and zero is returned.
+ */
+int dm_stats_create_regions(struct dm_stats *dms, uint64_t nr_regions,
+			    const uint64_t *starts, const uint64_t *lens,
+			    int64_t step, int precise,
+			    struct dm_histogram *bounds,
+			    const char *program_id, const char *user_data,
+			    uint64_t *region_ids);
+
 /*
  * Delete the specified statistics region. This will also mark the
  * region as not-present and discard any existing statistics data.
@@ -2588,6 +2611,28 @@ struct dm_list *dm_list_next(const struct dm_list *head, const struct dm_list *e
  */
 unsigned int dm_list_size(const struct dm_list *head);
 
+/*
+ * Retrieve the list of devices from a DM_DEVICE_LIST task and put them
+ * into easily accessible struct dm_active_device list elements.
+ * devs_features provides flag-set with used features so it's easy to check
+ * whether the kernel provides i.e. UUID info together with DM names.
+ */
+struct dm_active_device {
+	struct dm_list list;
+	dev_t devno;
+	const char *name;	/* device name */
+
+	uint32_t event_nr;	/* valid when DM_DEVICE_LIST_HAS_EVENT_NR is set */
+	const char *uuid;	/* valid uuid when DM_DEVICE_LIST_HAS_UUID is set */
+};
+
+#define DM_DEVICE_LIST_HAS_EVENT_NR	1
+#define DM_DEVICE_LIST_HAS_UUID		2
+int dm_task_get_device_list(struct dm_task *dmt, struct dm_list **devs_list,
+			    unsigned *devs_features);
+/* Release all associated memory with list of active DM devices */
+void dm_device_list_destroy(struct dm_list **devs_list);
+
 /*********
  * selinux
  *********/
@@ -3454,6 +3499,19 @@ dm_percent_t dm_histogram_get_bin_percent(const struct dm_histogram *dmh,
  */
 uint64_t dm_histogram_get_sum(const struct dm_histogram *dmh);
 
+/*
+ * Return the upper bound of the first bin at which the cumulative count
+ * of the histogram reaches percent of its sum (e.g. DM_PERCENT_1 * 99
+ * for the 99th percentile), or 0 if the histogram holds no observations.
+ * The last bin is unbounded and returns UINT64_MAX.
+ *
+ * Use a histogram returned by dm_stats_get_histogram() with
+ * DM_STATS_WALK_REGION or a group id to obtain the percentile over a
+ * whole region or group.
+ */
+uint64_t dm_histogram_get_percentile(const struct dm_histogram *dmh,
+				     dm_percent_t percent);
+
 /*
  * Histogram formatting flags.
  */
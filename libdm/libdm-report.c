@@ -27,6 +27,7 @@
 #define RH_HEADINGS_PRINTED	0x00000200
 #define RH_FIELD_CALC_NEEDED	0x00000400
 #define RH_ALREADY_REPORTED	0x00000800
+#define RH_JSON_STREAM		0x00001000
 
 struct selection {
 	struct dm_pool *mem;
@@ -77,6 +78,12 @@ struct dm_report {
 	struct dm_hash_table *value_cache;
 
 	struct report_group_item *group_item;
+
+	/*
+	 * Unbuffered JSON output prints each row as it is reported, one
+	 * row behind, so a separator can be added when the next one comes.
+	 */
+	char *json_stream_line;
 };
 
 struct dm_report_group {
@@ -1415,6 +1422,7 @@ void dm_report_free(struct dm_report *rh)
 	if (rh->value_cache)
 		dm_hash_destroy(rh->value_cache);
 	dm_pool_destroy(rh->mem);
+	dm_free(rh->json_stream_line);
 	dm_free(rh);
 }
 
@@ -4358,49 +4366,47 @@ int dm_report_column_headings(struct dm_report *rh)
 
 /*
  * Sort rows of data
+ *
+ * Rows are sorted through an array of entries holding the row and a copy
+ * of its sort values, so comparisons don't go through the row, field and
+ * field properties for every key.
  */
-static int _row_compare(const void *a, const void *b)
+#define SORT_KEY_NUMBER		0x00000001
+#define SORT_KEY_ASCENDING	0x00000002
+
+union sort_value {
+	uint64_t num;
+	const char *str;
+};
+
+struct sort_entry {
+	const uint32_t *key_flags;	/* SORT_KEY_*, shared by all entries */
+	uint32_t keys_count;
+	struct row *row;
+	union sort_value values[];	/* keys_count values */
+};
+
+static int _sort_entry_compare(const void *a, const void *b)
 {
-	const struct row *rowa = *(const struct row * const *) a;
-	const struct row *rowb = *(const struct row * const *) b;
-	const struct dm_report_field *sfa, *sfb;
+	const struct sort_entry *ea = (const struct sort_entry *) a;
+	const struct sort_entry *eb = (const struct sort_entry *) b;
 	uint32_t cnt;
+	int cmp;
 
-	for (cnt = 0; cnt < rowa->rh->keys_count; cnt++) {
-		sfa = (*rowa->sort_fields)[cnt];
-		sfb = (*rowb->sort_fields)[cnt];
-		if ((sfa->props->flags & DM_REPORT_FIELD_TYPE_NUMBER) ||
-		    (sfa->props->flags & DM_REPORT_FIELD_TYPE_SIZE) ||
-		    (sfa->props->flags & DM_REPORT_FIELD_TYPE_TIME)) {
-			const uint64_t numa =
-			    *(const uint64_t *) sfa->sort_value;
-			const uint64_t numb =
-			    *(const uint64_t *) sfb->sort_value;
-
-			if (numa == numb)
+	for (cnt = 0; cnt < ea->keys_count; cnt++) {
+		if (ea->key_flags[cnt] & SORT_KEY_NUMBER) {
+			if (ea->values[cnt].num == eb->values[cnt].num)
 				continue;
-
-			if (sfa->props->flags & FLD_ASCENDING) {
-				return (numa > numb) ? 1 : -1;
-			} else {	/* FLD_DESCENDING */
-				return (numa < numb) ? 1 : -1;
-			}
+			cmp = (ea->values[cnt].num > eb->values[cnt].num) ? 1 : -1;
 		} else {
 			/* DM_REPORT_FIELD_TYPE_STRING
 			 * DM_REPORT_FIELD_TYPE_STRING_LIST */
-			const char *stra = (const char *) sfa->sort_value;
-			const char *strb = (const char *) sfb->sort_value;
-			int cmp = strcmp(stra, strb);
-
-			if (!cmp)
+			if (!(cmp = strcmp(ea->values[cnt].str, eb->values[cnt].str)))
 				continue;
-
-			if (sfa->props->flags & FLD_ASCENDING) {
-				return (cmp > 0) ? 1 : -1;
-			} else {	/* FLD_DESCENDING */
-				return (cmp < 0) ? 1 : -1;
-			}
+			cmp = (cmp > 0) ? 1 : -1;
 		}
+
+		return (ea->key_flags[cnt] & SORT_KEY_ASCENDING) ? cmp : -cmp;	/* FLD_DESCENDING */
 	}
 
 	return 0;		/* Identical */
@@ -4408,25 +4414,59 @@ static int _row_compare(const void *a, const void *b)
 
 static int _sort_rows(struct dm_report *rh)
 {
-	struct row *(*rows)[];
-	uint32_t count = 0;
+	const size_t entry_size = sizeof(struct sort_entry) +
+				  rh->keys_count * sizeof(union sort_value);
+	const struct dm_report_field *sf;
+	struct sort_entry *entry;
+	uint32_t *key_flags;
+	uint32_t count, cnt, i;
+	char *entries;
 	struct row *row;
 
-	if (!(rows = dm_pool_alloc(rh->mem, sizeof(**rows) *
-				dm_list_size(&rh->rows)))) {
+	if (!(count = dm_list_size(&rh->rows)))
+		return 1;
+
+	if (!(key_flags = dm_pool_alloc(rh->mem, sizeof(*key_flags) * rh->keys_count)) ||
+	    !(entries = dm_pool_alloc(rh->mem, entry_size * count))) {
 		log_error("dm_report: sort array allocation failed");
 		return 0;
 	}
 
-	dm_list_iterate_items(row, &rh->rows)
-		(*rows)[count++] = row;
+	row = dm_list_item(dm_list_first(&rh->rows), struct row);
+	for (cnt = 0; cnt < rh->keys_count; cnt++) {
+		sf = (*row->sort_fields)[cnt];
+		key_flags[cnt] = 0;
+		if ((sf->props->flags & DM_REPORT_FIELD_TYPE_NUMBER) ||
+		    (sf->props->flags & DM_REPORT_FIELD_TYPE_SIZE) ||
+		    (sf->props->flags & DM_REPORT_FIELD_TYPE_TIME))
+			key_flags[cnt] |= SORT_KEY_NUMBER;
+		if (sf->props->flags & FLD_ASCENDING)
+			key_flags[cnt] |= SORT_KEY_ASCENDING;
+	}
 
-	qsort(rows, count, sizeof(**rows), _row_compare);
+	i = 0;
+	dm_list_iterate_items(row, &rh->rows) {
+		entry = (struct sort_entry *) (entries + entry_size * i++);
+		entry->key_flags = key_flags;
+		entry->keys_count = rh->keys_count;
+		entry->row = row;
+		for (cnt = 0; cnt < rh->keys_count; cnt++) {
+			sf = (*row->sort_fields)[cnt];
+			if (key_flags[cnt] & SORT_KEY_NUMBER)
+				entry->values[cnt].num = *(const uint64_t *) sf->sort_value;
+			else
+				entry->values[cnt].str = (const char *) sf->sort_value;
+		}
+	}
+
+	qsort(entries, count, entry_size, _sort_entry_compare);
 
 	dm_list_init(&rh->rows);
 
-	while (count > 0)
-		dm_list_add_h(&rh->rows, &(*rows)[--count]->list);
+	for (i = 0; i < count; i++)
+		dm_list_add(&rh->rows, &((struct sort_entry *) (entries + entry_size * i))->row->list);
+
+	dm_pool_free(rh->mem, key_flags);
 
 	return 1;
 }
@@ -4744,6 +4784,25 @@ static void _destroy_rows(struct dm_report *rh)
 	_reset_field_props(rh);
 }
 
+static int _json_stream_line(struct dm_report *rh, const char *line)
+{
+	int indent = rh->group_item->group->indent;
+
+	if (rh->json_stream_line) {
+		log_print("%*s%s", indent + (int) strlen(rh->json_stream_line),
+			  rh->json_stream_line, line ? JSON_SEPARATOR : "");
+		dm_free(rh->json_stream_line);
+		rh->json_stream_line = NULL;
+	}
+
+	if (line && !(rh->json_stream_line = dm_strdup(line))) {
+		log_error("dm_report: failed to store JSON output line");
+		return 0;
+	}
+
+	return 1;
+}
+
 static int _output_as_rows(struct dm_report *rh)
 {
 	const struct dm_report_field_type *fields;
@@ -4919,7 +4978,11 @@ static int _output_as_columns(struct dm_report *rh)
 		}
 
 		line = (char *) dm_pool_end_object(rh->mem);
-		log_print("%*s", rh->group_item ? rh->group_item->group->indent + (int) strlen(line) : 0, line);
+		if (rh->flags & RH_JSON_STREAM) {
+			if (!_json_stream_line(rh, line))
+				return_0;
+		} else
+			log_print("%*s", rh->group_item ? rh->group_item->group->indent + (int) strlen(line) : 0, line);
 		if (!(rh->flags & DM_REPORT_OUTPUT_MULTIPLE_TIMES))
 			dm_list_del(&row->list);
 	}
@@ -5003,6 +5066,10 @@ static int _prepare_json_report_output(struct dm_report *rh)
 	if (rh->group_item->output_done && dm_list_empty(&rh->rows))
 		return 1;
 
+	/* Streamed output already started the array with its first row. */
+	if ((rh->flags & RH_JSON_STREAM) && rh->group_item->needs_closing)
+		return 1;
+
 	/*
 	 * If this report is in JSON group, it must be at the
 	 * top of the stack of reports so the output from
@@ -5158,7 +5225,13 @@ static int _report_group_push_json(struct report_group_item *item, const char *n
 		item->report->flags &= ~(DM_REPORT_OUTPUT_ALIGNED |
 					 DM_REPORT_OUTPUT_HEADINGS |
 					 DM_REPORT_OUTPUT_COLUMNS_AS_ROWS);
-		item->report->flags |= DM_REPORT_OUTPUT_BUFFERED;
+		/*
+		 * JSON needs no column widths, so an unbuffered report
+		 * streams its rows instead of being switched to buffered.
+		 */
+		if (!(item->report->flags & DM_REPORT_OUTPUT_BUFFERED))
+			item->report->flags = (item->report->flags & ~DM_REPORT_OUTPUT_MULTIPLE_TIMES) |
+					      RH_JSON_STREAM;
 	} else {
 		_json_output_start(item->group);
 		if (name) {
@@ -5248,6 +5321,9 @@ static int _report_group_pop_basic(struct report_group_item *item)
 
 static int _report_group_pop_json(struct report_group_item *item)
 {
+	if (item->report && !_json_stream_line(item->report, NULL))
+		return_0;
+
 	if (item->output_done && item->needs_closing) {
 		if (item->data) {
 			item->group->indent -= JSON_INDENT_UNIT;
@@ -1277,6 +1277,54 @@ bad:
 	return 0;
 }
 
+/* Read one space separated unsigned value, not crossing end of line */
+static int _stats_read_u64(const char **p, uint64_t *val)
+{
+	char *end;
+
+	while (**p == ' ')
+		(*p)++;
+
+	if (**p < '0' || **p > '9')
+		return 0;
+
+	*val = strtoull(*p, &end, 10);
+	*p = end;
+
+	return 1;
+}
+
+/*
+ * Parse "<start>+<len>" and the 13 counters at the start of a row.
+ * Rows are parsed in place in the message response instead of going
+ * through fmemopen() and sscanf(), since populate runs every interval
+ * for every region.
+ */
+static int _stats_parse_row(const char *row, uint64_t *start, uint64_t *len,
+			    struct dm_stats_counters *cur)
+{
+	uint64_t *vals[] = {
+		&cur->reads, &cur->reads_merged, &cur->read_sectors,
+		&cur->read_nsecs,
+		&cur->writes, &cur->writes_merged, &cur->write_sectors,
+		&cur->write_nsecs,
+		&cur->io_in_progress,
+		&cur->io_nsecs, &cur->weighted_io_nsecs,
+		&cur->total_read_nsecs, &cur->total_write_nsecs
+	};
+	unsigned i;
+
+	if (!_stats_read_u64(&row, start) || (*row++ != '+') ||
+	    !_stats_read_u64(&row, len))
+		return 0;
+
+	for (i = 0; i < DM_ARRAY_SIZE(vals); i++)
+		if (!_stats_read_u64(&row, vals[i]))
+			return 0;
+
+	return 1;
+}
+
 static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 			       struct dm_stats_region *region,
 			       uint64_t timescale)
@@ -1284,10 +1332,8 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 	struct dm_histogram *hist = NULL;
 	struct dm_pool *mem = dms->mem;
 	struct dm_stats_counters cur;
-	FILE *stats_rows = NULL;
+	const char *row, *eol;
 	uint64_t start = 0, len = 0;
-	char row[STATS_ROW_BUF_LEN];
-	int r;
 
 	if (!resp) {
 		log_error("Could not parse empty @stats_print response.");
@@ -1299,15 +1345,6 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 	if (!dm_pool_begin_object(mem, 512))
 		goto_bad;
 
-	/*
-	 * dm_task_get_message_response() returns a 'const char *' but
-	 * since fmemopen also permits "w" it expects a 'char *'.
-	 */
-	/* coverity[alloc_strlen] intentional */
-	stats_rows = fmemopen((char *)resp, strlen(resp), "r");
-	if (!stats_rows)
-		goto_bad;
-
 	/*
 	 * Output format for each step-sized area of a region:
 	 *
@@ -1335,24 +1372,11 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 	 * 13. the total time spent writing in milliseconds
 	 *
 	*/
-	while (fgets(row, sizeof(row), stats_rows)) {
-		r = sscanf(row, FMTu64 "+" FMTu64 /* start+len */
-			   /* reads */
-			   FMTu64 " " FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* writes */
-			   FMTu64 " " FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* in flight & io nsecs */
-			   FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* tot read/write nsecs */
-			   FMTu64 " " FMTu64, &start, &len,
-			   &cur.reads, &cur.reads_merged, &cur.read_sectors,
-			   &cur.read_nsecs,
-			   &cur.writes, &cur.writes_merged, &cur.write_sectors,
-			   &cur.write_nsecs,
-			   &cur.io_in_progress,
-			   &cur.io_nsecs, &cur.weighted_io_nsecs,
-			   &cur.total_read_nsecs, &cur.total_write_nsecs);
-		if (r != 15) {
+	for (row = resp; *row; row = *eol ? eol + 1 : eol) {
+		if (!(eol = strchr(row, '\n')))
+			eol = row + strlen(row);
+
+		if (!_stats_parse_row(row, &start, &len, &cur)) {
 			log_error("Could not parse @stats_print row.");
 			goto bad;
 		}
@@ -1369,13 +1393,13 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 
 		if (region->bounds) {
 			/* Find first histogram separator. */
-			char *hist_str = strchr(row, ':');
+			char *hist_str = memchr(row, ':', eol - row);
 			if (!hist_str) {
 				log_error("Could not parse histogram value.");
 				goto bad;
 			}
 			/* Find space preceding histogram. */
-			while (hist_str && *(hist_str - 1) != ' ')
+			while ((hist_str > row) && *(hist_str - 1) != ' ')
 				hist_str--;
 
 			/* Use a separate pool for histogram objects since we
@@ -1408,15 +1432,9 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 	region->timescale = timescale;
 	region->counters = dm_pool_end_object(mem);
 
-	if (fclose(stats_rows))
-		stack;
-
 	return 1;
 
 bad:
-	if (stats_rows)
-		if (fclose(stats_rows))
-			stack;
 	dm_pool_abandon_object(mem);
 
 	return 0;
@@ -1997,17 +2015,27 @@ bad:
  * Two 20 digit uint64_t, '+', and NULL.
  */
 #define RANGE_LEN 42
-static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
-				uint64_t start, uint64_t len, int64_t step,
-				int precise, const char *hist_arg,
-				const char *program_id,	const char *aux_data)
+
+/*
+ * Create nr_regions regions sharing the same step and options. The
+ * arguments following the range are formatted just once, and a single
+ * message task is reused for every @stats_create. Regions already
+ * created are deleted again if one fails, so that either all or none
+ * of the regions exist on return.
+ */
+static int _stats_create_regions(struct dm_stats *dms, uint64_t nr_regions,
+				 const uint64_t *starts, const uint64_t *lens,
+				 int64_t step, int precise, const char *hist_arg,
+				 const char *program_id, const char *aux_data,
+				 uint64_t *region_ids)
 {
 	char msg[STATS_MSG_BUF_LEN], range[RANGE_LEN], *endptr = NULL;
 	const char *err = NULL;
 	const char *precise_str = PRECISE_ARG;
 	const char *resp, *opt_args = NULL;
-	char *aux_data_escaped = NULL;
+	char *aux_data_escaped = NULL, *create_args = NULL;
 	struct dm_task *dmt = NULL;
+	uint64_t i, created = 0;
 	int r = 0, nr_opt = 0;
 
 	if (!_stats_bound(dms))
@@ -2016,14 +2044,6 @@ static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
 	if (!program_id || !strlen(program_id))
 		program_id = dms->program_id;
 
-	if (start || len) {
-		if (dm_snprintf(range, sizeof(range), FMTu64 "+" FMTu64,
-				start, len) < 0) {
-			err ="range";
-			goto_bad;
-		}
-	}
-
 	if (precise < 0)
 		precise = dms->precise;
 
@@ -2052,8 +2072,7 @@ static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
 	} else
 		opt_args = dm_strdup("");
 
-	if (dm_snprintf(msg, sizeof(msg), "@stats_create %s %s" FMTu64
-			" %s %s %s", (start || len) ? range : "-",
+	if (dm_asprintf(&create_args, "%s" FMTu64 " %s %s %s",
 			(step < 0) ? "/" : "",
 			(uint64_t)llabs(step),
 			opt_args, program_id, aux_data) < 0) {
@@ -2061,20 +2080,42 @@ static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
 		goto_bad;
 	}
 
-	if (!(dmt = _stats_send_message(dms, msg)))
+	if (!(dmt = dm_task_create(DM_DEVICE_TARGET_MSG)))
 		goto_out;
 
-	resp = dm_task_get_message_response(dmt);
-	if (!resp) {
-		log_error("Could not parse empty @stats_create response.");
-		goto out;
-	}
+	if (!_set_stats_device(dms, dmt))
+		goto_out;
+
+	for (i = 0; i < nr_regions; i++) {
+		if (starts[i] || lens[i]) {
+			if (dm_snprintf(range, sizeof(range), FMTu64 "+" FMTu64,
+					starts[i], lens[i]) < 0) {
+				err = "range";
+				goto_bad;
+			}
+		}
+
+		if (dm_snprintf(msg, sizeof(msg), "@stats_create %s %s",
+				(starts[i] || lens[i]) ? range : "-",
+				create_args) < 0) {
+			err = "message";
+			goto_bad;
+		}
+
+		if (!dm_task_set_message(dmt, msg) || !dm_task_run(dmt))
+			goto_out;
+
+		resp = dm_task_get_message_response(dmt);
+		if (!resp) {
+			log_error("Could not parse empty @stats_create response.");
+			goto out;
+		}
 
-	if (region_id) {
 		errno = 0;
-		*region_id = strtoull(resp, &endptr, 10);
+		region_ids[i] = strtoull(resp, &endptr, 10);
 		if (errno || resp == endptr)
 			goto_out;
+		created++;
 	}
 
 	r = 1;
@@ -2082,14 +2123,41 @@ static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
 bad:
 	log_error("Could not prepare @stats_create %s.", err);
 out:
+	/* Delete the regions created before the failure. */
+	for (i = 0; !r && (i < created); i++) {
+		if ((dm_snprintf(msg, sizeof(msg), "@stats_delete " FMTu64,
+				 region_ids[i]) < 0) ||
+		    !dm_task_set_message(dmt, msg) || !dm_task_run(dmt))
+			log_error("Could not delete region ID " FMTu64 ".",
+				  region_ids[i]);
+	}
+
 	if (dmt)
 		dm_task_destroy(dmt);
+	dm_free(create_args);
 	dm_free((void *) opt_args);
 	dm_free(aux_data_escaped);
 
 	return r;
 }
 
+static int _stats_create_region(struct dm_stats *dms, uint64_t *region_id,
+				uint64_t start, uint64_t len, int64_t step,
+				int precise, const char *hist_arg,
+				const char *program_id,	const char *aux_data)
+{
+	uint64_t id;
+
+	if (!_stats_create_regions(dms, 1, &start, &len, step, precise,
+				   hist_arg, program_id, aux_data, &id))
+		return 0;
+
+	if (region_id)
+		*region_id = id;
+
+	return 1;
+}
+
 DM_EXPORT_NEW_SYMBOL(int, dm_stats_create_region, 1_02_107)
 	(struct dm_stats *dms, uint64_t *region_id,
 	 uint64_t start, uint64_t len, int64_t step,
@@ -2117,6 +2185,35 @@ out:
 	return r;
 }
 
+int dm_stats_create_regions(struct dm_stats *dms, uint64_t nr_regions,
+			    const uint64_t *starts, const uint64_t *lens,
+			    int64_t step, int precise,
+			    struct dm_histogram *bounds,
+			    const char *program_id, const char *user_data,
+			    uint64_t *region_ids)
+{
+	char *hist_arg = NULL;
+	int r = 0;
+
+	if (!nr_regions || !starts || !lens || !region_ids) {
+		log_error("Regions to create are not specified.");
+		return 0;
+	}
+
+	if ((precise || bounds) && !_stats_check_precise_timestamps(dms))
+		return_0;
+
+	if (bounds && !(hist_arg = _build_histogram_arg(bounds, &precise)))
+		return_0;
+
+	r = _stats_create_regions(dms, nr_regions, starts, lens, step,
+				  precise, hist_arg, program_id, user_data,
+				  region_ids);
+	dm_free(hist_arg);
+
+	return r;
+}
+
 
 static void _stats_clear_group_regions(struct dm_stats *dms, uint64_t group_id)
 {
@@ -2517,52 +2614,58 @@ for ((i) = dm_bit_get_first((dms)->groups[(gid)].regions);	\
 _foreach_group_region(dms, gid, i)				\
 	_foreach_region_area(dms, i, j)
 
-static uint64_t _stats_get_counter(const struct dm_stats *dms,
-				   const struct dm_stats_counters *area,
-				   dm_stats_counter_t counter)
-{
-	switch(counter) {
-	case DM_STATS_READS_COUNT:
-		return area->reads;
-	case DM_STATS_READS_MERGED_COUNT:
-		return area->reads_merged;
-	case DM_STATS_READ_SECTORS_COUNT:
-		return area->read_sectors;
-	case DM_STATS_READ_NSECS:
-		return area->read_nsecs;
-	case DM_STATS_WRITES_COUNT:
-		return area->writes;
-	case DM_STATS_WRITES_MERGED_COUNT:
-		return area->writes_merged;
-	case DM_STATS_WRITE_SECTORS_COUNT:
-		return area->write_sectors;
-	case DM_STATS_WRITE_NSECS:
-		return area->write_nsecs;
-	case DM_STATS_IO_IN_PROGRESS_COUNT:
-		return area->io_in_progress;
-	case DM_STATS_IO_NSECS:
-		return area->io_nsecs;
-	case DM_STATS_WEIGHTED_IO_NSECS:
-		return area->weighted_io_nsecs;
-	case DM_STATS_TOTAL_READ_NSECS:
-		return area->total_read_nsecs;
-	case DM_STATS_TOTAL_WRITE_NSECS:
-		return area->total_write_nsecs;
-	case DM_STATS_NR_COUNTERS:
-	default:
-		log_error("Attempt to read invalid counter: %d", counter);
-	}
-	return 0;
+/* Offset of each dm_stats_counter_t in struct dm_stats_counters */
+static const size_t _counter_offsets[DM_STATS_NR_COUNTERS] = {
+	[DM_STATS_READS_COUNT] = offsetof(struct dm_stats_counters, reads),
+	[DM_STATS_READS_MERGED_COUNT] = offsetof(struct dm_stats_counters, reads_merged),
+	[DM_STATS_READ_SECTORS_COUNT] = offsetof(struct dm_stats_counters, read_sectors),
+	[DM_STATS_READ_NSECS] = offsetof(struct dm_stats_counters, read_nsecs),
+	[DM_STATS_WRITES_COUNT] = offsetof(struct dm_stats_counters, writes),
+	[DM_STATS_WRITES_MERGED_COUNT] = offsetof(struct dm_stats_counters, writes_merged),
+	[DM_STATS_WRITE_SECTORS_COUNT] = offsetof(struct dm_stats_counters, write_sectors),
+	[DM_STATS_WRITE_NSECS] = offsetof(struct dm_stats_counters, write_nsecs),
+	[DM_STATS_IO_IN_PROGRESS_COUNT] = offsetof(struct dm_stats_counters, io_in_progress),
+	[DM_STATS_IO_NSECS] = offsetof(struct dm_stats_counters, io_nsecs),
+	[DM_STATS_WEIGHTED_IO_NSECS] = offsetof(struct dm_stats_counters, weighted_io_nsecs),
+	[DM_STATS_TOTAL_READ_NSECS] = offsetof(struct dm_stats_counters, total_read_nsecs),
+	[DM_STATS_TOTAL_WRITE_NSECS] = offsetof(struct dm_stats_counters, total_write_nsecs),
+};
+
+static uint64_t _stats_get_counter(const struct dm_stats_counters *area,
+				   size_t offset)
+{
+	return *(const uint64_t *)((const char *) area + offset);
+}
+
+/* Sum one counter over all areas of a region */
+static uint64_t _stats_sum_region_counter(const struct dm_stats_region *region,
+					  size_t offset)
+{
+	uint64_t j, nr_areas = _nr_areas(region->len, region->step);
+	uint64_t sum = 0;
+
+	for (j = 0; j < nr_areas; j++)
+		sum += _stats_get_counter(&region->counters[j], offset);
+
+	return sum;
 }
 
 uint64_t dm_stats_get_counter(const struct dm_stats *dms,
 			      dm_stats_counter_t counter,
 			      uint64_t region_id, uint64_t area_id)
 {
-	uint64_t i, j, sum = 0; /* aggregation */
+	uint64_t i, sum = 0; /* aggregation */
 	int sum_regions = 0;
 	struct dm_stats_region *region;
-	struct dm_stats_counters *area;
+	size_t offset;
+
+	if ((unsigned) counter >= DM_STATS_NR_COUNTERS) {
+		log_error("Attempt to read invalid counter: %d", counter);
+		return 0;
+	}
+
+	/* Resolve the counter once, not for every area summed */
+	offset = _counter_offsets[counter];
 
 	region_id = (region_id == DM_STATS_REGION_CURRENT)
 		     ? dms->cur_region : region_id ;
@@ -2588,26 +2691,18 @@ uint64_t dm_stats_get_counter(const struct dm_stats *dms,
 	if (_stats_region_is_grouped(dms, region_id) && (sum_regions)) {
 		/* group */
 		if (area_id & DM_STATS_WALK_GROUP)
-			_foreach_group_area(dms, region->group_id, i, j) {
-				area = &dms->regions[i].counters[j];
-				sum += _stats_get_counter(dms, area, counter);
-			}
+			_foreach_group_region(dms, region->group_id, i)
+				sum += _stats_sum_region_counter(&dms->regions[i], offset);
 		else
-			_foreach_group_region(dms, region->group_id, i) {
-				area = &dms->regions[i].counters[area_id];
-				sum += _stats_get_counter(dms, area, counter);
-			}
-	} else if (area_id == DM_STATS_WALK_REGION) {
+			_foreach_group_region(dms, region->group_id, i)
+				sum += _stats_get_counter(&dms->regions[i].counters[area_id],
+							  offset);
+	} else if (area_id == DM_STATS_WALK_REGION)
 		/* aggregate region */
-		_foreach_region_area(dms, region_id, j) {
-			area = &dms->regions[region_id].counters[j];
-			sum += _stats_get_counter(dms, area, counter);
-		}
-	} else {
+		sum = _stats_sum_region_counter(region, offset);
+	else
 		/* plain region / area */
-		area = &region->counters[area_id];
-		sum = _stats_get_counter(dms, area, counter);
-	}
+		sum = _stats_get_counter(&region->counters[area_id], offset);
 
 	return sum;
 }
@@ -3550,6 +3645,34 @@ uint64_t dm_histogram_get_sum(const struct dm_histogram *dmh)
 	return dmh->sum;
 }
 
+uint64_t dm_histogram_get_percentile(const struct dm_histogram *dmh,
+				     dm_percent_t percent)
+{
+	uint64_t target, count = 0;
+	int bin;
+
+	if (!dmh || !dmh->sum || !dmh->nr_bins)
+		return 0;
+
+	if (percent < DM_PERCENT_0)
+		percent = DM_PERCENT_0;
+	else if (percent > DM_PERCENT_100)
+		percent = DM_PERCENT_100;
+
+	/* Number of observations at or below the percentile, at least one */
+	if (!(target = (uint64_t) ceil((double) dmh->sum * percent / DM_PERCENT_100)))
+		target = 1;
+
+	for (bin = 0; bin < dmh->nr_bins; bin++)
+		if ((count += dmh->bins[bin].count) >= target)
+			break;
+
+	if (bin == dmh->nr_bins)
+		bin--;
+
+	return dmh->bins[bin].upper;
+}
+
 dm_percent_t dm_histogram_get_bin_percent(const struct dm_histogram *dmh,
 					  int bin)
 {
@@ -4690,7 +4813,8 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 					 uint64_t *count, int *regroup)
 {
 	struct _extent *extents = NULL, *old_extents = NULL;
-	uint64_t *regions = NULL, fail_region, i, num_bits;
+	uint64_t *regions = NULL, i, n, num_bits, nr_new = 0;
+	uint64_t *new_starts = NULL, *new_lens = NULL, *new_ids = NULL;
 	struct dm_stats_group *group = NULL;
 	struct dm_pool *extent_mem = NULL;
 	struct _extent *old_ext;
@@ -4775,13 +4899,17 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 		goto out;
 	}
 
+	if (!(new_starts = dm_malloc(3 * (1 + *count) * sizeof(*new_starts)))) {
+		log_error("Could not allocate memory for new extents.");
+		goto out;
+	}
+	new_lens = new_starts + (1 + *count);
+	new_ids = new_lens + (1 + *count);
+
 	/*
-	 * Second pass (first for non-update case): create regions for
-	 * all extents not retained from the prior mapping, and insert
-	 * retained regions into the table of region_id values.
-	 *
-	 * If a regroup is not scheduled, set group bits for newly
-	 * created regions in the group leader bitmap.
+	 * Second pass (first for non-update case): insert retained regions
+	 * into the table of region_id values and collect all extents not
+	 * retained from the prior mapping.
 	 */
 	for (i = 0; i < *count; i++) {
 		if (update) {
@@ -4793,14 +4921,34 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 				continue;
 			}
 		}
-		if (!_stats_create_region(dms, regions + i, extents[i].start,
-					  extents[i].len, -1, precise, hist_arg,
-					  dms->program_id, "")) {
-			log_error("Failed to create region " FMTu64 " of "
-				  FMTu64 " at " FMTu64 ".", i, *count,
-				  extents[i].start);
-			goto out_remove;
-		}
+		regions[i] = DM_STATS_REGION_NOT_PRESENT;
+		new_starts[nr_new] = extents[i].start;
+		new_lens[nr_new] = extents[i].len;
+		nr_new++;
+	}
+
+	/*
+	 * Create the new regions in one batch: on failure no new region
+	 * is left behind.
+	 */
+	if (nr_new && !_stats_create_regions(dms, nr_new, new_starts, new_lens,
+					     -1, precise, hist_arg,
+					     dms->program_id, "", new_ids)) {
+		log_error("Failed to create " FMTu64 " new regions of "
+			  FMTu64 ".", nr_new, *count);
+		*count = 0;
+		goto out;
+	}
+
+	/*
+	 * If a regroup is not scheduled, set group bits for newly
+	 * created regions in the group leader bitmap.
+	 */
+	for (i = 0, n = 0; i < *count; i++) {
+		if (regions[i] != DM_STATS_REGION_NOT_PRESENT)
+			continue;
+
+		regions[i] = new_ids[n++];
 
 		log_very_verbose("Created new region mapping " FMTu64 "+" FMTu64
 				 " with region ID " FMTu64, extents[i].start,
@@ -4831,6 +4979,8 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 	if (bounds)
 		dm_free(hist_arg);
 
+	dm_free(new_starts);
+
 	/* the extent table will be empty if the file has been truncated. */
 	if (extents)
 		dm_pool_free(extent_mem, extents);
@@ -4840,23 +4990,23 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 	return regions;
 
 out_remove:
-	/* New region creation may begin to fail part-way through creating
-	 * a set of file mapped regions: in this case we need to roll back
-	 * the regions that were already created and return the handle to
-	 * a consistent state. A listed handle is required for this: use a
-	 * single list operation and call _stats_delete_region() directly
-	 * to avoid a @stats_list ioctl and list parsing for each region.
+	/* Group bitmap update may fail after the new regions have been
+	 * created: in this case we need to roll back the new regions and
+	 * return the handle to a consistent state. A listed handle is
+	 * required for this: use a single list operation and call
+	 * _stats_delete_region() directly to avoid a @stats_list ioctl
+	 * and list parsing for each region.
 	 */
 	if (!dm_stats_list(dms, NULL))
 		goto out;
 
-	fail_region = i;
-	_stats_cleanup_region_ids(dms, regions, fail_region);
+	_stats_cleanup_region_ids(dms, new_ids, nr_new);
 	*count = 0;
 
 out:
 	dm_pool_destroy(extent_mem);
 	dm_free(hist_arg);
+	dm_free(new_starts);
 	dm_free(regions);
 	return NULL;
 }
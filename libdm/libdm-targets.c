@@ -365,9 +365,44 @@ bad:
 	return 0;
 }
 
+/* Read an unsigned decimal number, skipping leading spaces */
+static int _read_u64(const char **p, uint64_t *v)
+{
+	char *end;
+
+	while (**p == ' ')
+		(*p)++;
+
+	if (**p < '0' || **p > '9')
+		return 0;
+
+	*v = strtoull(*p, &end, 10);
+	*p = end;
+
+	return 1;
+}
+
+/* Is the word of length len at p equal to str? */
+static int _word_is(const char *p, size_t len, const char *str)
+{
+	return (strlen(str) == len) && !strncmp(p, str, len);
+}
+
+/*
+ * Thin pool status is parsed by hand rather than with sscanf() and
+ * a strstr() per flag: it is read for every thin pool on each lvs
+ * and each dmeventd poll.
+ *
+ * <transaction id> <used meta>/<total meta> <used data>/<total data>
+ * <held metadata root> ro|rw|out_of_data_space
+ * [no_]discard_passdown|ignore_discard
+ * error_if_no_space|queue_if_no_space
+ * needs_check|- ...
+ */
 int parse_thin_pool_status(const char *params, struct dm_status_thin_pool *s)
 {
-	int pos;
+	const char *p = params;
+	size_t len;
 
 	memset(s, 0, sizeof(*s));
 
@@ -388,36 +423,43 @@ int parse_thin_pool_status(const char *params, struct dm_status_thin_pool *s)
 	}
 
 	/* FIXME: add support for held metadata root */
-	if (sscanf(params, FMTu64 " " FMTu64 "/" FMTu64 " " FMTu64 "/" FMTu64 "%n",
-		   &s->transaction_id,
-		   &s->used_metadata_blocks,
-		   &s->total_metadata_blocks,
-		   &s->used_data_blocks,
-		   &s->total_data_blocks, &pos) < 5) {
+	if (!_read_u64(&p, &s->transaction_id) ||
+	    !_read_u64(&p, &s->used_metadata_blocks) || (*p++ != '/') ||
+	    !_read_u64(&p, &s->total_metadata_blocks) ||
+	    !_read_u64(&p, &s->used_data_blocks) || (*p++ != '/') ||
+	    !_read_u64(&p, &s->total_data_blocks)) {
 		log_error("Failed to parse thin pool params: %s.", params);
 		return 0;
 	}
 
-	/* New status flags */
-	if (strstr(params + pos, "no_discard_passdown"))
-		s->discards = DM_THIN_DISCARDS_NO_PASSDOWN;
-	else if (strstr(params + pos, "ignore_discard"))
-		s->discards = DM_THIN_DISCARDS_IGNORE;
-	else /* default discard_passdown */
-		s->discards = DM_THIN_DISCARDS_PASSDOWN;
+	/* Default discard_passdown */
+	s->discards = DM_THIN_DISCARDS_PASSDOWN;
+
+	/* New status flags, one word each */
+	for (; *p; p += len) {
+		while (*p == ' ')
+			p++;
+
+		len = strcspn(p, " ");
+
+		if (_word_is(p, len, "no_discard_passdown"))
+			s->discards = DM_THIN_DISCARDS_NO_PASSDOWN;
+		else if (_word_is(p, len, "ignore_discard"))
+			s->discards = DM_THIN_DISCARDS_IGNORE;
+		else if (_word_is(p, len, "out_of_data_space"))
+			s->out_of_data_space = 1;
+		else if (_word_is(p, len, "ro"))
+			s->read_only = 1;
+		else if (_word_is(p, len, "error_if_no_space"))
+			/* Default is 'queue_if_no_space' */
+			s->error_if_no_space = 1;
+		else if (_word_is(p, len, "needs_check"))
+			s->needs_check = 1;
+	}
 
 	/* Default is 'writable' (rw) data */
-	if (strstr(params + pos, "out_of_data_space"))
-		s->out_of_data_space = 1;
-	else if (strstr(params + pos, "ro "))
-		s->read_only = 1;
-
-	/* Default is 'queue_if_no_space' */
-	if (strstr(params + pos, "error_if_no_space"))
-		s->error_if_no_space = 1;
-
-	if (strstr(params + pos, "needs_check"))
-		s->needs_check = 1;
+	if (s->out_of_data_space)
+		s->read_only = 0;
 
 	return 1;
 }
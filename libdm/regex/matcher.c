@@ -109,7 +109,9 @@ static int _create_bitsets(struct dm_regex *m)
 			return_0;
 		if (!(n->lastpos = dm_bitset_create(m->scratch, m->num_charsets)))
 			return_0;
-		if (!(n->followpos = dm_bitset_create(m->scratch, m->num_charsets)))
+		/* followpos is only used for charset (leaf) nodes */
+		if ((n->type == CHARSET) &&
+		    !(n->followpos = dm_bitset_create(m->scratch, m->num_charsets)))
 			return_0;
 	}
 
@@ -118,7 +120,8 @@ static int _create_bitsets(struct dm_regex *m)
 
 static void _calc_functions(struct dm_regex *m)
 {
-	unsigned i, j, final = 1;
+	unsigned i, final = 1;
+	int j;
 	struct rx_node *rx, *c1, *c2;
 
 	for (i = 0; i < m->num_nodes; i++) {
@@ -182,21 +185,21 @@ static void _calc_functions(struct dm_regex *m)
 		 */
 		switch (rx->type) {
 		case CAT:
-			for (j = 0; j < m->num_charsets; j++) {
+			for (j = dm_bit_get_first(c1->lastpos); j >= 0;
+			     j = dm_bit_get_next(c1->lastpos, j)) {
                                 struct rx_node *n = m->charsets[j];
-				if (dm_bit(c1->lastpos, j))
-					dm_bit_union(n->followpos,
-                                                     n->followpos, c2->firstpos);
+				dm_bit_union(n->followpos,
+					     n->followpos, c2->firstpos);
 			}
 			break;
 
 		case PLUS:
 		case STAR:
-			for (j = 0; j < m->num_charsets; j++) {
+			for (j = dm_bit_get_first(rx->lastpos); j >= 0;
+			     j = dm_bit_get_next(rx->lastpos, j)) {
                                 struct rx_node *n = m->charsets[j];
-				if (dm_bit(rx->lastpos, j))
-					dm_bit_union(n->followpos,
-                                                     n->followpos, rx->firstpos);
+				dm_bit_union(n->followpos,
+					     n->followpos, rx->firstpos);
 			}
 			break;
 		}
@@ -258,7 +261,9 @@ static int _calc_state(struct dm_regex *m, struct dfa_state *dfa, int a)
 
                 dfa->lookup[a] = ldfa;
                 dm_bit_clear_all(m->bs);
-        }
+        } else if (a == TARGET_TRANS)
+		/* Not final: don't recalculate on every step through it. */
+		dfa->final = 0;
 
 	return 1;
 }
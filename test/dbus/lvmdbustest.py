@@ -2023,6 +2023,18 @@ class TestDbusService(unittest.TestCase):
 		cmd = ['lvcreate', '-L4M', '-n', lv_name, vg.Name]
 		self._verify_existence(cmd, cmd[0], full_name)
 
+	def test_external_lv_remove(self):
+		# Removing a LV outside of service is notified for its VG alone,
+		# make sure that refresh leaves us consistent with a full one
+		lv_p = self._create_lv()
+		vg = ClientProxy(self.bus, lv_p.LvCommon.Vg, interfaces=(VG_INT,)).Vg
+		full_name = "%s/%s" % (vg.Name, lv_p.LvCommon.Name)
+
+		ec, stdout, stderr = call_lvm(['lvremove', '-f', full_name])
+		self.assertTrue(ec == 0, "lvremove exit code = %d" % ec)
+		self.assertTrue(self._lookup(full_name) == '/')
+		self._check_consistency()
+
 	def test_external_pv_create(self):
 		# Let's create a PV outside of service and see if we correctly handle
 		# its inclusion
@@ -20,6 +20,8 @@
 #  check mirror_legs VG LV N
 #  check mirror_images_on VG LV DEV [DEV...]
 
+#  check cost counter LIMIT command [params]
+
 # ...
 
 test -z "$BASH" || set -e -o pipefail
@@ -459,6 +461,15 @@ grep_dmsetup() {
 	grep -q "${@:3}" out || die "Expected output \"" "${@:3}" "\" from dmsetup $1 not found!"
 }
 
+# Fails when the counter of the LVM_TIMING report of the command is
+# above LIMIT (see get cost).
+cost() {
+	local val
+	val=$(get cost "$1" "${@:3}")
+	echo "## ${*:3}: $1 $val (limit $2)"
+	test "$val" -le "$2" || die "${*:3} has $1 $val, expected at most $2!"
+}
+
 grep_lvmlockd_dump() {
 	lvmlockctl --dump | tee out
 	grep -q "${@:1}" out || die "Expected output \"" "${@:1}" "\" from lvmlockctl --dump not found!"
@@ -17,6 +17,8 @@
 #  get lv_field LV field [lvs params]
 #
 #  get lv_devices LV     [lvs params]
+#
+#  get cost counter command [params]
 
 test -z "$BASH" || set -e -o pipefail
 
@@ -115,6 +117,23 @@ first_extent_sector() {
 	pv_field "$@" pe_start --units s --nosuffix
 }
 
+# Runs the lvm command with LVM_TIMING and prints one counter of its
+# report, e.g. reads, dm_ioctls or label_scan_calls.
+cost() {
+	local r
+	LVM_TIMING=1 "${@:2}" 2>cost.err >/dev/null || {
+		cat cost.err >&2
+		return 1
+	}
+	r=$(sed -n "s/.*\"$1\":\([0-9]*\).*/\1/p" cost.err | tail -n 1)
+	test -n "$r" || {
+		echo "No $1 in LVM_TIMING report of ${*:2}!" >&2
+		cat cost.err >&2
+		return 1
+	}
+	trim_ "$r"
+}
+
 #set -x
 unset LVM_VALGRIND
 unset LVM_LOG_FILE_EPOCH
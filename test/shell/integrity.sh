@@ -136,6 +136,8 @@ lvs -a -o name,segtype,devices,sync_percent $vg
 aux wait_recalc $vg/${lv1}_rimage_0
 aux wait_recalc $vg/${lv1}_rimage_1
 aux wait_recalc $vg/$lv1
+check lv_field $vg/$lv1 integrity_recalc_percent "100.00"
+check lv_field $vg/${lv1}_rimage_0 integrity_recalc_percent "100.00"
 _test_fs_with_read_repair "$dev1"
 lvs -o integritymismatches $vg/${lv1}_rimage_0 |tee mismatch
 not grep 0 mismatch
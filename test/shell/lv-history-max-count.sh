@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='historical LVs are limited by metadata/lvs_history_max_count'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux have_thin 1 0 0 || skip
+aux prepare_vg 1
+
+aux lvmconf "metadata/record_lvs_history=1"
+
+lvcreate -L10M -T $vg/pool
+lvcreate -V1 -T $vg/pool -n lv0
+
+# Chain of more historical LVs than needed to index them by name.
+for i in $(seq 1 40); do
+	lvcreate -s $vg/lv$(( i - 1 )) -n lv$i
+	lvremove -f $vg/lv$(( i - 1 ))
+done
+
+check lvh_field $vg/lv40 full_ancestors "$(seq -s, -f -lv%g 39 -1 0)"
+
+# Records of the LVs removed first go over the limit.
+lvchange --addtag max --config "metadata/lvs_history_max_count=5" $vg/lv40
+check lvh_field $vg/lv40 full_ancestors "-lv39,-lv38,-lv37,-lv36,-lv35"
+not lvs -H $vg/-lv34
+
+vgremove -ff $vg
@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='lvchange commits metadata only changes once per VG'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_vg 2
+
+for i in 1 2 3 4 5; do
+	lvcreate -an -Zn -l1 -n lv$i $vg
+done
+
+SEQNO=$(get vg_field $vg vg_seqno)
+lvchange --addtag bulk $vg 2>&1 | tee out
+test "$(grep -c "changed" out)" -eq 5
+test "$(get vg_field $vg vg_seqno)" -eq $(( SEQNO + 1 ))
+test "$(lvs --noheadings -S lv_tags=bulk $vg | wc -l)" -eq 5
+
+# One LV failing does not drop the changes of the others.
+lvchange -pr $vg/lv3
+SEQNO=$(get vg_field $vg vg_seqno)
+not lvchange -pr $vg
+test "$(get vg_field $vg vg_seqno)" -eq $(( SEQNO + 1 ))
+test "$(lvs --noheadings -S lv_permissions=read-only $vg | wc -l)" -eq 5
+
+# Active LVs are still reloaded on their own.
+lvchange -ay $vg/lv1
+SEQNO=$(get vg_field $vg vg_seqno)
+lvchange -prw $vg
+test "$(get vg_field $vg vg_seqno)" -eq $(( SEQNO + 2 ))
+check lv_field $vg/lv1 lv_permissions writeable
+lvchange -an $vg/lv1
+
+vgremove -ff $vg
@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='refresh LVs in parallel workers'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_vg 2
+
+for i in 1 2 3 4 5 6; do
+	lvcreate -aey -l1 -n "lv$i" "$vg"
+done
+lvcreate -an -l1 -n inactive "$vg"
+lvcreate -aey -l1 -s -n snap "$vg/lv1"
+
+lvchange --refresh --parallel 4 "$vg"
+vgchange --refresh --parallel 3 "$vg"
+
+# Table changed behind lvm's back is put back by the workers
+dmsetup load "$vg-lv2" --table "0 $(blockdev --getsz "$DM_DEV_DIR/$vg/lv2") error"
+dmsetup resume "$vg-lv2"
+lvchange --refresh --parallel 2 "$vg/lv2" "$vg/lv3"
+dmsetup table "$vg-lv2" > table
+not grep error table
+
+for i in 1 2 3 4 5 6; do
+	check active "$vg" "lv$i"
+done
+check inactive "$vg" inactive
+check active "$vg" snap
+
+vgremove -ff "$vg"
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='remove many thin LVs with one pool transaction'
+
+SKIP_WITH_LVMPOLLD=1
+
+export LVM_TEST_THIN_REPAIR_CMD=${LVM_TEST_THIN_REPAIR_CMD-/bin/false}
+
+. lib/inittest
+
+aux have_thin 1 0 0 || skip
+
+aux prepare_vg 2
+
+lvcreate -T -L8M "$vg/pool"
+for i in 1 2 3 4 5; do
+	lvcreate -V4M -T "$vg/pool" -n "thin$i"
+done
+
+check lv_field "$vg/pool" transaction_id "5"
+
+# All deletes go to the pool in a single transaction
+lvremove -y "$vg/thin1" "$vg/thin2" "$vg/thin3" "$vg/thin4" 2>&1 | tee out
+grep "thin1\" successfully removed" out
+grep "thin4\" successfully removed" out
+check lv_field "$vg/pool" transaction_id "6"
+check lv_not_exists "$vg" thin1 thin2 thin3 thin4
+check lv_exists "$vg" thin5
+
+# Pool is consistent with the metadata after the batch
+lvchange -an "$vg"
+lvchange -ay "$vg/thin5"
+check active "$vg" thin5
+
+# With -ff each LV is still removed with its own pool update
+lvcreate -V4M -T "$vg/pool" -n thin6
+lvremove -ff "$vg/thin5" "$vg/thin6"
+check lv_field "$vg/pool" transaction_id "9"
+
+vgremove -ff "$vg"
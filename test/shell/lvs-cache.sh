@@ -70,6 +70,8 @@ lvs -o lv_name,cache_policy   | grep mq
 lvs -a -o lv_name,cache_policy -S 'cache_policy=mq' | grep corigin
 lvs -o lv_name,cache_settings | grep migration_threshold=233
 lvs -o lv_name,cache_settings | grep sequential_threshold=13
+# Too few I/Os seen yet to suggest any tuning
+check lv_field $vg/corigin cache_tuning ""
 
 lvcreate -n foo -l 1 $vg
 lvs -S 'cache_policy=mq' | grep corigin
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='lvs and vgs --follow report only changed VGs again'
+
+SKIP_WITH_LVMLOCKD=1
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 4
+vgcreate $SHARED $vg1 "$dev1" "$dev2"
+vgcreate $SHARED $vg2 "$dev3" "$dev4"
+lvcreate -an -Zn -l1 -n $lv1 $vg1
+lvcreate -an -Zn -l1 -n $lv2 $vg2
+
+wait_for_line() {
+	for i in {1..50}; do
+		grep "$1" "$2" && return 0
+		sleep .2
+	done
+	cat "$2"
+	die "Waited for \"$1\" in $2 too long!"
+}
+
+LVM_TEST_TAG="kill_me_$PREFIX" vgs --follow --interval 1 --noheadings -o vg_name,vg_tags >out &
+PID_VGS=$!
+wait_for_line $vg2 out
+
+vgchange --addtag follow1 $vg1
+wait_for_line follow1 out
+# Only the changed VG is reported again.
+test "$(grep -c $vg1 out)" -eq 2
+test "$(grep -c $vg2 out)" -eq 1
+
+kill -INT $PID_VGS
+wait $PID_VGS
+
+# Selection given on the command line stays applied.
+LVM_TEST_TAG="kill_me_$PREFIX" lvs --follow --interval 1 --noheadings -o lv_name,lv_tags -S "lv_name=$lv1" >out &
+PID_LVS=$!
+wait_for_line $lv1 out
+
+lvchange --addtag follow2 $vg1/$lv1
+lvchange --addtag follow3 $vg2/$lv2
+wait_for_line follow2 out
+not grep $lv2 out
+
+kill -INT $PID_LVS
+wait $PID_LVS
+
+vgremove -ff $vg1 $vg2
@@ -239,3 +239,21 @@ for mdacp in 1 2; do
 	check vg_field $vg1 vg_mda_used_count $(( mdacp * 2 ))
 	vgremove -f $vg1
 done
+
+echo Managed copies are spread over PVs before using a second mda on one
+pvcreate --metadatacopies 2 "$dev1" "$dev2" "$dev3"
+vgcreate $SHARED --vgmetadatacopies 3 $vg1 "$dev1" "$dev2" "$dev3"
+check pv_field "$dev1" pv_mda_used_count 1
+check pv_field "$dev2" pv_mda_used_count 1
+check pv_field "$dev3" pv_mda_used_count 1
+vgchange --vgmetadatacopies 6 $vg1
+vgchange --vgmetadatacopies 2 $vg1
+check vg_field $vg1 vg_mda_used_count 2
+not check pv_field "$dev1" pv_mda_used_count 2
+not check pv_field "$dev2" pv_mda_used_count 2
+not check pv_field "$dev3" pv_mda_used_count 2
+vgchange --vgmetadatacopies 3 $vg1
+check pv_field "$dev1" pv_mda_used_count 1
+check pv_field "$dev2" pv_mda_used_count 1
+check pv_field "$dev3" pv_mda_used_count 1
+vgremove -f $vg1
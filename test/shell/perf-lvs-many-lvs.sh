@@ -0,0 +1,64 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='Bound reads and dm ioctls of commands on a VG with many LVs'
+
+# The counters come from LVM_TIMING, so the limits do not depend on the
+# speed of the machine.  The same command on a VG with a few LVs gives
+# the cost of the test setup, on the big VG it may only add a fixed
+# number of reads and a few dm ioctls per LV.
+
+SKIP_WITH_LVMLOCKD=1
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+# On low-memory boxes let's not stress too much
+test "$(aux total_mem)" -gt 1048576 || skip
+
+N=${LVM_TEST_PERF_LVS:-1000}
+
+# One 128KiB extent per LV on two PVs, about 512 bytes of metadata per LV.
+MDA=$(( N / 1024 + 1 ))
+aux prepare_devs 4 $(( N / 16 + 2 * MDA + 8 ))
+get_devs
+
+pvcreate --metadatasize "${MDA}m" "${DEVICES[@]}"
+vgcreate $SHARED -s 128K $vg1 "$dev1" "$dev2"
+vgcreate $SHARED -s 128K $vg2 "$dev3" "$dev4"
+aux generate_lvs $vg1 10
+aux generate_lvs $vg2 "$N"
+
+# Reading metadata of N LVs from both PVs of the VG.
+SLACK=$(( N / 64 + 8 ))
+
+READS=$(get cost reads lvs $vg1)
+IOCTLS=$(get cost dm_ioctls lvs $vg1)
+check cost reads $(( READS + SLACK )) lvs $vg2
+check cost dm_ioctls $(( IOCTLS + 2 * N )) lvs $vg2
+check cost label_scan_calls 1 lvs $vg2
+
+READS=$(get cost reads vgs $vg1)
+check cost reads $(( READS + SLACK )) vgs $vg2
+
+IOCTLS=$(get cost dm_ioctls vgchange -ay $vg1)
+check cost dm_ioctls $(( IOCTLS + 16 * N )) vgchange -ay $vg2
+
+IOCTLS=$(get cost dm_ioctls lvs $vg1)
+check cost dm_ioctls $(( IOCTLS + 4 * N )) lvs $vg2
+
+IOCTLS=$(get cost dm_ioctls vgchange -an $vg1)
+check cost dm_ioctls $(( IOCTLS + 16 * N )) vgchange -an $vg2
+
+check lv_field "$vg2/lvol$(( N - 1 ))" lv_name "lvol$(( N - 1 ))"
+
+vgremove -ff $vg1 $vg2
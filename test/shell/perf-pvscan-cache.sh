@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='Bound reads of pvscan --cache'
+
+SKIP_WITH_LVMLOCKD=1
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 8
+get_devs
+
+vgcreate $SHARED $vg "$dev1" "$dev2"
+lvcreate -an -Zn -l1 -n $lv1 $vg
+pvcreate "$dev3"
+
+# Label and small metadata are in the first block read from the
+# device, other devices are not read.
+for dev in "$dev1" "$dev2" "$dev3" "$dev4"; do
+	check cost reads 2 pvscan --cache "$dev"
+	check cost label_scan_calls 0 pvscan --cache "$dev"
+done
+
+# Scanning everything reads each device about once.
+check cost reads $(( 2 * ${#DEVICES[@]} )) pvscan --cache
+
+vgremove -ff $vg
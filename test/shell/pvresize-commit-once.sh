@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='pvresize commits all PVs of a VG once'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 4 32
+get_devs
+
+vgcreate $SHARED $vg "${DEVICES[@]}"
+
+SEQNO=$(get vg_field $vg vg_seqno)
+pvresize -y --setphysicalvolumesize 16m "${DEVICES[@]}" 2>&1 | tee out
+test "$(grep -c "changed" out)" -eq 4
+test "$(get vg_field $vg vg_seqno)" -eq $(( SEQNO + 1 ))
+check pv_field "$dev1" pv_size "12.00m"
+check pv_field "$dev4" pv_size "12.00m"
+
+# A failing PV leaves the whole VG unchanged.
+SEQNO=$(get vg_field $vg vg_seqno)
+lvcreate -an -Zn -l2 -n $lv1 $vg "$dev2"
+not pvresize -y --setphysicalvolumesize 5m "${DEVICES[@]}"
+test "$(get vg_field $vg vg_seqno)" -eq $(( SEQNO + 1 ))
+check pv_field "$dev1" pv_size "12.00m"
+
+pvresize "${DEVICES[@]}"
+check pv_field "$dev1" pv_size "28.00m"
+
+vgremove -ff $vg
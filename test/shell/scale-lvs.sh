@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='Record how commands scale with the number of LVs'
+
+# Tiers are small by default to keep the suite quick, for the real
+# limits run e.g. with LVM_TEST_SCALE_LVS="1000 5000 20000".
+# Commands taking more than twice the time expected from linear growth
+# against the smallest tier are reported.
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+# On low-memory boxes let's not stress too much
+test "$(aux total_mem)" -gt 1048576 || skip
+
+TIERS=${LVM_TEST_SCALE_LVS:-250 1000}
+PVS=${LVM_TEST_SCALE_PVS:-8}
+
+MAX=0
+for n in $TIERS; do
+	test "$n" -gt "$MAX" && MAX=$n
+done
+
+# One 128KiB extent per LV plus some spare, and metadata areas with
+# 1KiB per LV, leaving room for the about 512 bytes of each LV.
+MDA=$(( MAX / 1024 + 1 ))
+aux prepare_devs "$PVS" $(( MAX / PVS / 8 + 2 * MDA + 8 ))
+get_devs
+
+pvcreate --metadatasize "${MDA}m" "${DEVICES[@]}"
+
+time_cmd() {
+	local name=$1
+	local start end
+	shift
+
+	start=$(date +%s%N)
+	"$@" >/dev/null
+	end=$(date +%s%N)
+
+	echo "$n $name $(( (end - start) / 1000000 ))" >> TIMES
+}
+
+for n in $TIERS; do
+	vgcreate $SHARED -s 128K "$vg" "${DEVICES[@]}"
+	aux generate_lvs "$vg" "$n"
+
+	time_cmd lvs lvs -a "$vg"
+	time_cmd vgchange_ay vgchange -ay "$vg"
+	time_cmd lvcreate lvcreate -an -Zn -l1 -n extra "$vg"
+	time_cmd vgchange_an vgchange -an "$vg"
+	time_cmd pvscan pvscan --cache
+
+	check lv_field "$vg/lvol$(( n - 1 ))" lv_name "lvol$(( n - 1 ))"
+
+	vgremove -ff "$vg"
+done
+
+echo "## LVs command milliseconds"
+cat TIMES
+
+# Milliseconds allowed for noise on top of linear growth.
+awk -v SLACK=1000 '
+$2 in base {
+	limit = 2 * times[$2] * $1 / base[$2] + SLACK
+	if ($3 > limit)
+		printf("%s with %d LVs took %d ms, linear growth from %d LVs allows %d ms\n",
+		       $2, $1, $3, base[$2], limit)
+	next
+}
+{ base[$2] = $1; times[$2] = $3 }
+' TIMES > SUPERLINEAR
+
+cat SUPERLINEAR
+should test ! -s SUPERLINEAR
@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='VGs not passing selection on VG name or uuid are not read'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_pvs 2
+
+vgcreate $SHARED $vg1 "$dev1"
+vgcreate $SHARED $vg2 "$dev2"
+lvcreate -an -Zn -l1 -n $lv1 $vg1
+lvcreate -an -Zn -l1 -n $lv2 $vg2
+
+lvs -vvvv --noheadings -o lv_name -S "vg_name=$vg1 && lv_size>0" > out 2> err
+grep "Skipping VG $vg2 not passing selection" err
+not grep "Reading VG $vg2" err
+grep $lv1 out
+not grep $lv2 out
+
+UUID=$(get vg_field $vg2 vg_uuid)
+vgs -vvvv --noheadings -o vg_name -S "vg_uuid=$UUID" > out 2> err
+grep "Skipping VG $vg1 not passing selection" err
+grep $vg2 out
+not grep $vg1 out
+
+lvchange -vvvv --addtag t1 -S "vg_name=$vg2" 2> err
+grep "Skipping VG $vg1 not passing selection" err
+check lv_field $vg2/$lv2 lv_tags t1
+
+# Other VGs are read when they could pass selection.
+lvs -vvvv -S "vg_name=$vg1 || lv_name=$lv2" 2> err
+not grep "Skipping VG" err
+vgs -vvvv -o+selected -S "vg_name=$vg1" 2> err
+not grep "Skipping VG" err
+
+vgremove -ff $vg1 $vg2
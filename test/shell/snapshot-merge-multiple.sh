@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='Merge snapshots of several origins with one lvconvert'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux target_at_least dm-snapshot-merge 1 0 0 || skip
+
+aux prepare_vg 2 100
+
+for i in 1 2 3; do
+	lvcreate -aey -n "origin$i" -L8 $vg
+	lvcreate -s -n "snap$i" -L4 "$vg/origin$i"
+done
+
+# All merges are polled together in foreground
+lvconvert --merge -i1 "$vg/snap1" "$vg/snap2" "$vg/snap3"
+
+for i in 1 2 3; do
+	check lv_not_exists $vg "snap$i"
+	check lv_exists $vg "origin$i"
+done
+
+vgremove -ff $vg
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='activate VGs in parallel workers'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 4
+get_devs
+
+vgcreate $SHARED "$vg1" "$dev1"
+vgcreate $SHARED "$vg2" "$dev2"
+vgcreate $SHARED "$vg3" "$dev3" "$dev4"
+
+for v in "$vg1" "$vg2" "$vg3"; do
+	lvcreate -an -l2 -n lv1 "$v"
+	lvcreate -an -l2 -n lv2 "$v"
+done
+
+vgchange -ay --parallel 2 2>&1 | tee out
+for v in "$vg1" "$vg2" "$vg3"; do
+	grep "2 logical volume(s) in volume group \"$v\" now active" out
+	check active "$v" lv1
+	check active "$v" lv2
+done
+
+vgchange -an --parallel 3 "$vg1" "$vg3"
+check inactive "$vg1" lv1
+check inactive "$vg3" lv2
+check active "$vg2" lv1
+
+# A VG failing in its worker fails the command, others are still done
+aux disable_dev "$dev4"
+not vgchange -ay --parallel 2 "$vg1" "$vg3"
+check active "$vg1" lv1
+aux enable_dev "$dev4"
+
+vgchange -an --parallel 2
+vgremove -ff "$vg1" "$vg2" "$vg3"
@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='vgs reporting only VG summary fields'
+
+SKIP_WITH_LVMLOCKD=1
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_vg 3
+lvcreate -an -Zn -l1 -n $lv1 $vg
+vgchange --addtag tag1 $vg
+
+FIELDS=vg_name,vg_uuid,vg_seqno,vg_systemid,vg_permissions,vg_extendable,pv_count
+
+# Summary fields only, no vg_read needed.
+vgs -vvvv --noheadings -o $FIELDS -O -seqno $vg > out 2> err
+grep "Using scan summary of VG $vg" err
+
+# Same values with a field that needs the whole VG.
+vgs -vvvv --noheadings -o $FIELDS,vg_tags $vg > full 2> err
+not grep "Using scan summary" err
+grep tag1 full
+sed -e 's/ *tag1 *$//' full > full_cut
+sed -e 's/ *$//' out > out_cut
+diff out_cut full_cut
+
+# Selection and sorting by other fields need the whole VG too.
+vgs -vvvv -o $FIELDS -S 'lv_count=1' $vg 2> err
+not grep "Using scan summary" err
+vgs -vvvv -o $FIELDS -O vg_free $vg 2> err
+not grep "Using scan summary" err
+
+# A VG with a missing PV is read as usual.
+aux disable_dev "$dev1"
+vgs -vvvv -o $FIELDS $vg 2> err
+not grep "Using scan summary" err
+check vg_field $vg pv_count 3
+aux enable_dev "$dev1"
+
+vgremove -ff $vg
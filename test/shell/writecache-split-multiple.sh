@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='Detach writecache from several LVs with one command'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux have_writecache 1 0 0 || skip
+
+aux prepare_devs 2 64
+
+vgcreate $SHARED $vg "$dev1" "$dev2"
+
+for i in 1 2 3; do
+	lvcreate -n "main$i" -L 8 -an $vg "$dev1"
+	lvcreate -n "fast$i" -L 4 -an $vg "$dev2"
+	lvconvert -y --type writecache --cachevol "fast$i" "$vg/main$i"
+done
+
+lvchange -ay $vg/main1 $vg/main2
+for i in 1 2; do
+	dd if=/dev/urandom of="$DM_DEV_DIR/$vg/main$i" bs=1M count=2 oflag=direct
+done
+check lv_field $vg/main1 segtype writecache
+get lv_field $vg/main1 writecache_dirty_blocks
+
+# Active, active and inactive LV detached together
+lvconvert --splitcache $vg/main1 $vg/main2 $vg/main3
+
+for i in 1 2 3; do
+	check lv_field "$vg/main$i" segtype linear
+	check lv_exists $vg "fast$i"
+done
+check active $vg main1
+check inactive $vg main3
+
+for i in 1 2 3; do
+	lvconvert -y --type writecache --cachevol "fast$i" "$vg/main$i"
+done
+
+lvconvert --uncache $vg/main1 $vg/main2 $vg/main3
+
+for i in 1 2 3; do
+	check lv_field "$vg/main$i" segtype linear
+	check lv_not_exists $vg "fast$i"
+done
+
+vgremove -ff $vg
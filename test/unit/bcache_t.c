@@ -314,6 +314,8 @@ static struct mock_engine *_mock_create(unsigned max_io, sector_t block_size)
 	m->e.issue = _mock_issue;
 	m->e.wait = _mock_wait;
 	m->e.max_io = _mock_max_io;
+	m->e.register_buffers = NULL;
+	m->e.issue_writev = NULL;
 
 	m->max_io = max_io;
 	m->block_size = block_size;
@@ -474,6 +476,31 @@ static void test_repeated_reads_are_cached(void *context)
 	}
 }
 
+static void test_stats_count_hits_and_ios(void *context)
+{
+	struct fixture *f = context;
+	struct bcache_stats stats;
+	int di = 17;   // arbitrary key
+	unsigned i;
+	struct block *b;
+
+	_expect_read(f->me, di, 0);
+	_expect(f->me, E_WAIT);
+	for (i = 0; i < 10; i++) {
+		T_ASSERT(bcache_get(f->cache, di, 0, 0, &b));
+		bcache_put(b);
+	}
+
+	bcache_get_stats(f->cache, &stats);
+	T_ASSERT_EQUAL(stats.reads, 1);
+	T_ASSERT_EQUAL(stats.writes, 0);
+	T_ASSERT_EQUAL(stats.read_misses, 1);
+	T_ASSERT_EQUAL(stats.read_hits, 9);
+	T_ASSERT_EQUAL(stats.max_io_pending, 1);
+	T_ASSERT_EQUAL(stats.waits, 1);
+	T_ASSERT_EQUAL(stats.io_errors, 0);
+}
+
 static void test_block_gets_evicted_with_many_reads(void *context)
 {
 	struct fixture *f = context;
@@ -510,6 +537,43 @@ static void test_block_gets_evicted_with_many_reads(void *context)
 	}
 }
 
+static void test_reused_block_survives_one_off_reads(void *context)
+{
+	struct fixture *f = context;
+	struct mock_engine *me = f->me;
+	struct bcache *cache = f->cache;
+	struct bcache_stats stats;
+	const unsigned nr_cache_blocks = 16;
+
+	int di = 17;   // arbitrary key
+	unsigned i;
+	struct block *b;
+
+	// Block 0 is got twice, like a label.
+	_expect_read(me, di, 0);
+	_expect(me, E_WAIT);
+	for (i = 0; i < 2; i++) {
+		T_ASSERT(bcache_get(cache, di, 0, 0, &b));
+		bcache_put(b);
+	}
+
+	// A stream of blocks got once, longer than the cache.
+	for (i = 1; i <= 4 * nr_cache_blocks; i++) {
+		_expect_read(me, di, i);
+		_expect(me, E_WAIT);
+		T_ASSERT(bcache_get(cache, di, i, 0, &b));
+		bcache_put(b);
+	}
+
+	// Block 0 is still cached.
+	T_ASSERT(bcache_get(cache, di, 0, 0, &b));
+	bcache_put(b);
+
+	bcache_get_stats(cache, &stats);
+	T_ASSERT_EQUAL(stats.read_hits, 2);
+	T_ASSERT_EQUAL(stats.hot_hits, 1);
+}
+
 static void test_prefetch_issues_a_read(void *context)
 {
 	struct fixture *f = context;
@@ -557,6 +621,32 @@ static void test_too_many_prefetches_does_not_trigger_a_wait(void *context)
 		_expect(me, E_WAIT);
 }
 
+static void test_prefetches_limited_per_di(void *context)
+{
+	struct fixture *f = context;
+	struct mock_engine *me = f->me;
+	struct bcache *cache = f->cache;
+	unsigned i;
+
+	bcache_set_max_di_prefetches(cache, 4);
+
+	for (i = 0; i < 8; i++) {
+		// prefetch should not wait
+		if (i < 4)
+			_expect_read(me, 17, i);
+		bcache_prefetch(cache, 17, i);
+	}
+
+	// Other devices still get prefetch slots.
+	_expect_read(me, 18, 0);
+	bcache_prefetch(cache, 18, 0);
+	_no_outstanding_expectations(me);
+
+	// Destroy will wait for any in flight IO triggered by prefetches.
+	for (i = 0; i < 5; i++)
+		_expect(me, E_WAIT);
+}
+
 static void test_dirty_data_gets_written_back(void *context)
 {
 	struct fixture *f = context;
@@ -986,9 +1076,12 @@ static struct test_suite *_small_tests(void)
 
 	T("get-reads", "bcache_get() triggers read", test_get_triggers_read);
 	T("reads-cached", "repeated reads are cached", test_repeated_reads_are_cached);
+	T("stats", "stats count hits, misses and ios", test_stats_count_hits_and_ios);
 	T("blocks-get-evicted", "block get evicted with many reads", test_block_gets_evicted_with_many_reads);
+	T("reused-block-stays", "block got again survives one-off reads", test_reused_block_survives_one_off_reads);
 	T("prefetch-reads", "prefetch issues a read", test_prefetch_issues_a_read);
 	T("prefetch-never-waits", "too many prefetches does not trigger a wait", test_too_many_prefetches_does_not_trigger_a_wait);
+	T("prefetch-per-di-limit", "prefetches are limited per di", test_prefetches_limited_per_di);
 	T("writeback-occurs", "dirty data gets written back", test_dirty_data_gets_written_back);
 	T("zero-flag-dirties", "zeroed data counts as dirty", test_zeroed_data_counts_as_dirty);
 	T("read-multiple-files", "read from multiple files", test_multiple_files);
@@ -107,6 +107,13 @@ static void *_async_init(void)
 	return _fix_init(e);
 }
 
+static void *_uring_init(void)
+{
+	struct io_engine *e = create_io_uring_io_engine();
+	T_ASSERT(e);
+	return _fix_init(e);
+}
+
 static void *_sync_init(void)
 {
 	struct io_engine *e = create_sync_io_engine();
@@ -307,6 +314,41 @@ static void _test_rw_many_boundaries(void *fixture)
 
 //----------------------------------------------------------------
 
+static void _verify_direct(struct fixture *f, uint64_t byte_b, uint64_t byte_e,
+			   uint64_t pat_b, uint64_t pat_e, uint8_t pat)
+{
+	unsigned i;
+	size_t len = byte_e - byte_b;
+	uint8_t *buffer = malloc(len);
+
+	T_ASSERT(buffer);
+	memset(buffer, 0, len);
+
+	T_ASSERT(bcache_read_bytes_direct(f->cache, f->di, byte_b, len, buffer));
+	for (i = 0; i < len; i++)
+		T_ASSERT_EQUAL(buffer[i], _pattern_at(((byte_b + i) >= pat_b && (byte_b + i) < pat_e) ?
+						      pat : INIT_PATTERN, byte_b + i));
+	free(buffer);
+}
+
+static void _test_read_direct(void *fixture)
+{
+	struct fixture *f = fixture;
+	uint8_t pat = _random_pattern();
+
+	// Dirty blocks in the cache are newer than the disk.
+	_do_write(f, byte(5, 0), byte(10, 0), pat);
+	_verify_direct(f, byte(3, 7), byte(20, 9), byte(5, 0), byte(10, 0), pat);
+	T_ASSERT(!bcache_is_cached(f->cache, f->di, 3));
+	T_ASSERT(!bcache_is_cached(f->cache, f->di, 15));
+
+	_reopen(f);
+	_verify_direct(f, byte(0, 0), _max_byte(), byte(5, 0), byte(10, 0), pat);
+	T_ASSERT(!bcache_is_cached(f->cache, f->di, 7));
+}
+
+//----------------------------------------------------------------
+
 static void _zero_cycle(struct fixture *f, uint64_t b, uint64_t e)
 {
 	_verify(f, b, e, INIT_PATTERN);
@@ -412,6 +454,7 @@ static struct test_suite *_async_tests(void)
         T("rw-within-single-block", "read/write/verify within single block", _test_rw_within_single_block);
         T("rw-cross-one-boundary", "read/write/verify across one boundary", _test_rw_cross_one_boundary);
         T("rw-many-boundaries", "read/write/verify many boundaries", _test_rw_many_boundaries);
+        T("read-direct", "read bytes directly around cached blocks", _test_read_direct);
 
         T("zero-first-block", "zero the first block", _test_zero_first_block);
         T("zero-last-block", "zero the last block", _test_zero_last_block);
@@ -447,6 +490,42 @@ static struct test_suite *_sync_tests(void)
         T("rw-within-single-block", "read/write/verify within single block", _test_rw_within_single_block);
         T("rw-cross-one-boundary", "read/write/verify across one boundary", _test_rw_cross_one_boundary);
         T("rw-many-boundaries", "read/write/verify many boundaries", _test_rw_many_boundaries);
+        T("read-direct", "read bytes directly around cached blocks", _test_read_direct);
+
+        T("zero-first-block", "zero the first block", _test_zero_first_block);
+        T("zero-last-block", "zero the last block", _test_zero_last_block);
+        T("zero-several-blocks", "zero several whole blocks", _test_zero_several_whole_blocks);
+        T("zero-within-single-block", "zero within single block", _test_zero_within_single_block);
+        T("zero-cross-one-boundary", "zero across one boundary", _test_zero_cross_one_boundary);
+        T("zero-many-boundaries", "zero many boundaries", _test_zero_many_boundaries);
+
+        T("set-first-block", "set the first block", _test_set_first_block);
+        T("set-last-block", "set the last block", _test_set_last_block);
+        T("set-several-blocks", "set several whole blocks", _test_set_several_whole_blocks);
+        T("set-within-single-block", "set within single block", _test_set_within_single_block);
+        T("set-cross-one-boundary", "set across one boundary", _test_set_cross_one_boundary);
+        T("set-many-boundaries", "set many boundaries", _test_set_many_boundaries);
+#undef T
+
+        return ts;
+}
+
+static struct test_suite *_uring_tests(void)
+{
+        struct test_suite *ts = test_suite_create(_uring_init, _fix_exit);
+        if (!ts) {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+        }
+
+#define T(path, desc, fn) register_test(ts, "/base/device/bcache/utils/io_uring/" path, desc, fn)
+        T("rw-first-block", "read/write/verify the first block", _test_rw_first_block);
+        T("rw-last-block", "read/write/verify the last block", _test_rw_last_block);
+        T("rw-several-blocks", "read/write/verify several whole blocks", _test_rw_several_whole_blocks);
+        T("rw-within-single-block", "read/write/verify within single block", _test_rw_within_single_block);
+        T("rw-cross-one-boundary", "read/write/verify across one boundary", _test_rw_cross_one_boundary);
+        T("rw-many-boundaries", "read/write/verify many boundaries", _test_rw_many_boundaries);
+        T("read-direct", "read bytes directly around cached blocks", _test_read_direct);
 
         T("zero-first-block", "zero the first block", _test_zero_first_block);
         T("zero-last-block", "zero the last block", _test_zero_last_block);
@@ -468,7 +547,15 @@ static struct test_suite *_sync_tests(void)
 
 void bcache_utils_tests(struct dm_list *all_tests)
 {
+	struct io_engine *e;
+
 	dm_list_add(all_tests, &_async_tests()->list);
 	dm_list_add(all_tests, &_sync_tests()->list);
+
+	/* Only when the running kernel supports it */
+	if ((e = create_io_uring_io_engine())) {
+		e->destroy(e);
+		dm_list_add(all_tests, &_uring_tests()->list);
+	}
 }
 
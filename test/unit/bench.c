@@ -0,0 +1,800 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU General Public License v.2.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Micro-benchmarks for hot paths, run with 'make bench'.
+ *
+ * Every benchmark works on generated input of a fixed size and seed, so
+ * numbers are comparable across releases on the same machine.  Results
+ * are printed as a JSON array, the best of several runs is reported.
+ */
+
+#include "units.h"
+#include "base/data-struct/radix-tree.h"
+#include "base/memory/zalloc.h"
+#include "lib/device/bcache.h"
+#include "lib/misc/lib.h"
+#include "lib/commands/toolcontext.h"
+#include "lib/metadata/lv_alloc.h"
+#include "lib/metadata/pv_alloc.h"
+#include "lib/metadata/segtype.h"
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------
+
+struct bench {
+	const char *name;
+	unsigned size;				/* items handled by one run */
+	void *(*init)(unsigned size);		/* not timed */
+	bool (*run)(void *context, unsigned size);
+	void (*exit)(void *context);
+};
+
+static unsigned _scale = 1;
+
+static uint64_t _now_ns(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// xorshift64, so the generated inputs don't depend on the libc rand()
+static uint64_t _rand(uint64_t *state)
+{
+	uint64_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+
+	return *state = x;
+}
+
+#define SEED 0x5eed1e55c0ffee11ULL
+
+//-----------------------------------------------------------------
+// Hash and radix tree, keyed like the lvmcache and device lookups.
+
+struct keys {
+	unsigned nr;
+	char (*key)[40];
+};
+
+static void *_keys_init(unsigned size)
+{
+	struct keys *k;
+	uint64_t state = SEED;
+	unsigned i;
+
+	if (!(k = malloc(sizeof(*k))) ||
+	    !(k->key = malloc(size * sizeof(*k->key)))) {
+		free(k);
+		return NULL;
+	}
+
+	k->nr = size;
+	for (i = 0; i < size; i++)
+		(void) snprintf(k->key[i], sizeof(k->key[i]), "vg%08x/lvol%016llx",
+				i % 64, (unsigned long long) _rand(&state));
+
+	return k;
+}
+
+static void _keys_exit(void *context)
+{
+	struct keys *k = context;
+
+	free(k->key);
+	free(k);
+}
+
+static bool _hash_run(void *context, unsigned size)
+{
+	struct keys *k = context;
+	struct dm_hash_table *ht;
+	unsigned i;
+	bool r = false;
+
+	if (!(ht = dm_hash_create(size)))
+		return false;
+
+	for (i = 0; i < k->nr; i++)
+		if (!dm_hash_insert(ht, k->key[i], k->key[i]))
+			goto out;
+
+	for (i = 0; i < k->nr; i++)
+		if (dm_hash_lookup(ht, k->key[i]) != k->key[i])
+			goto out;
+
+	r = true;
+out:
+	dm_hash_destroy(ht);
+
+	return r;
+}
+
+static bool _radix_tree_run(void *context, unsigned size)
+{
+	struct keys *k = context;
+	struct radix_tree *rt;
+	union radix_value v;
+	unsigned i;
+	bool r = false;
+
+	if (!(rt = radix_tree_create(NULL, NULL)))
+		return false;
+
+	for (i = 0; i < k->nr; i++) {
+		v.n = i;
+		if (!radix_tree_insert(rt, k->key[i], strlen(k->key[i]), v))
+			goto out;
+	}
+
+	for (i = 0; i < k->nr; i++)
+		if (!radix_tree_lookup(rt, k->key[i], strlen(k->key[i]), &v) || (v.n != i))
+			goto out;
+
+	for (i = 0; i < k->nr; i += 2)
+		if (!radix_tree_remove(rt, k->key[i], strlen(k->key[i])))
+			goto out;
+
+	r = true;
+out:
+	radix_tree_destroy(rt);
+
+	return r;
+}
+
+//-----------------------------------------------------------------
+// Config trees shaped like VG metadata with 'size' LVs, which is what
+// text format import parses and export writes.
+
+struct metadata {
+	char *text;
+	size_t len;
+	char *buf;			/* parsed in place */
+	char *cft_buf;			/* buffer cft was parsed in */
+	struct dm_config_tree *cft;
+	size_t written;
+};
+
+// Like reading metadata from disk, which is parsed in place without
+// duplicate node checks.
+static struct dm_config_tree *_metadata_parse(struct metadata *md)
+{
+	struct dm_config_tree *cft;
+
+	memcpy(md->buf, md->text, md->len + 1);
+
+	if (!(cft = dm_config_create()))
+		return NULL;
+
+	if (!dm_config_parse_in_place(cft, md->buf, md->buf + md->len, 1)) {
+		dm_config_destroy(cft);
+		return NULL;
+	}
+
+	return cft;
+}
+
+static char *_metadata_text(unsigned lvs)
+{
+	/* Worst case size of each LV section plus the VG header */
+	size_t len = 512 + (size_t) lvs * 512;
+	uint64_t state = SEED;
+	char *text, *p;
+	unsigned i;
+	int n;
+
+	if (!(text = malloc(len)))
+		return NULL;
+
+	p = text;
+	n = snprintf(p, len, "bench_vg {\nid = \"abcdef-ghij-klmn-opqr-stuv-wxyz-012345\"\n"
+		     "seqno = 1\nformat = \"lvm2\"\nstatus = [\"RESIZEABLE\", \"READ\", \"WRITE\"]\n"
+		     "flags = []\nextent_size = 8192\nmax_lv = 0\nmax_pv = 0\nmetadata_copies = 0\n"
+		     "logical_volumes {\n");
+	p += n;
+	len -= n;
+
+	for (i = 0; i < lvs; i++) {
+		n = snprintf(p, len, "lvol%u {\nid = \"%016llx\"\nstatus = [\"READ\", \"WRITE\", \"VISIBLE\"]\n"
+			     "flags = []\ncreation_time = %u\ncreation_host = \"bench\"\nsegment_count = 1\n"
+			     "segment1 {\nstart_extent = 0\nextent_count = %u\ntype = \"striped\"\n"
+			     "stripe_count = 1\nstripes = [\"pv%u\", %u]\n}\n}\n",
+			     i, (unsigned long long) _rand(&state), 1700000000U + i,
+			     1 + (unsigned) (_rand(&state) % 1024), i % 16, i * 16);
+		if ((n < 0) || ((size_t) n >= len)) {
+			free(text);
+			return NULL;
+		}
+		p += n;
+		len -= n;
+	}
+
+	if (len < 5) {
+		free(text);
+		return NULL;
+	}
+	strcpy(p, "}\n}\n");
+
+	return text;
+}
+
+static void *_metadata_init(unsigned size)
+{
+	struct metadata *md;
+
+	if (!(md = zalloc(sizeof(*md))))
+		return NULL;
+
+	if (!(md->text = _metadata_text(size)))
+		goto bad;
+
+	md->len = strlen(md->text);
+
+	if (!(md->buf = malloc(md->len + 1)) ||
+	    !(md->cft = _metadata_parse(md)))
+		goto bad;
+
+	/* The tree keeps its buffer, so parse runs get a new one */
+	md->cft_buf = md->buf;
+	if (!(md->buf = malloc(md->len + 1)))
+		goto bad;
+
+	return md;
+bad:
+	if (md->cft)
+		dm_config_destroy(md->cft);
+	free(md->cft_buf);
+	free(md->buf);
+	free(md->text);
+	free(md);
+
+	return NULL;
+}
+
+static void _metadata_exit(void *context)
+{
+	struct metadata *md = context;
+
+	dm_config_destroy(md->cft);
+	free(md->cft_buf);
+	free(md->buf);
+	free(md->text);
+	free(md);
+}
+
+static bool _config_parse_run(void *context, unsigned size)
+{
+	struct metadata *md = context;
+	struct dm_config_tree *cft;
+
+	if (!(cft = _metadata_parse(md)))
+		return false;
+
+	dm_config_destroy(cft);
+
+	return true;
+}
+
+static int _count_line(const char *line, void *baton)
+{
+	struct metadata *md = baton;
+
+	md->written += strlen(line) + 1;
+
+	return 1;
+}
+
+static bool _config_write_run(void *context, unsigned size)
+{
+	struct metadata *md = context;
+
+	md->written = 0;
+
+	return dm_config_write_node(md->cft->root, _count_line, md) && md->written;
+}
+
+//-----------------------------------------------------------------
+// Report engine, sorting and producing rows for 'size' objects.
+
+struct bench_obj {
+	char name[24];
+	uint64_t size;
+	uint32_t count;
+	const char *name_ptr;
+};
+
+struct report {
+	struct bench_obj *obj;
+	unsigned rows;
+};
+
+static void *_obj_get(void *obj)
+{
+	return obj;
+}
+
+static const struct dm_report_object_type _report_types[] = {
+	{ 1, "Bench", "bench_", _obj_get },
+	{ 0, "", "", NULL },
+};
+
+static int _name_disp(struct dm_report *rh, struct dm_pool *mem,
+		      struct dm_report_field *field, const void *data,
+		      void *private)
+{
+	return dm_report_field_string(rh, field, data);
+}
+
+static int _size_disp(struct dm_report *rh, struct dm_pool *mem,
+		      struct dm_report_field *field, const void *data,
+		      void *private)
+{
+	return dm_report_field_uint64(rh, field, data);
+}
+
+static int _count_disp(struct dm_report *rh, struct dm_pool *mem,
+		       struct dm_report_field *field, const void *data,
+		       void *private)
+{
+	return dm_report_field_uint32(rh, field, data);
+}
+
+#define OFFSET(f) offsetof(struct bench_obj, f)
+static const struct dm_report_field_type _report_fields[] = {
+	{ 1, DM_REPORT_FIELD_TYPE_STRING, OFFSET(name_ptr), 24, "name", "Name", _name_disp, "Name." },
+	{ 1, DM_REPORT_FIELD_TYPE_NUMBER | DM_REPORT_FIELD_ALIGN_RIGHT, OFFSET(size), 12, "size", "Size", _size_disp, "Size." },
+	{ 1, DM_REPORT_FIELD_TYPE_NUMBER | DM_REPORT_FIELD_ALIGN_RIGHT, OFFSET(count), 6, "count", "Count", _count_disp, "Count." },
+	{ 0, 0, 0, 0, "", "", NULL, NULL },
+};
+#undef OFFSET
+
+static void *_report_init(unsigned size)
+{
+	struct report *r;
+	uint64_t state = SEED;
+	unsigned i;
+
+	if (!(r = zalloc(sizeof(*r))) ||
+	    !(r->obj = malloc(size * sizeof(*r->obj)))) {
+		free(r);
+		return NULL;
+	}
+
+	for (i = 0; i < size; i++) {
+		(void) snprintf(r->obj[i].name, sizeof(r->obj[i].name), "lvol%u", i);
+		r->obj[i].name_ptr = r->obj[i].name;
+		r->obj[i].size = _rand(&state) % (1ULL << 40);
+		r->obj[i].count = (uint32_t) (_rand(&state) % 8);
+	}
+
+	return r;
+}
+
+static void _report_exit(void *context)
+{
+	struct report *r = context;
+
+	free(r->obj);
+	free(r);
+}
+
+static int _report_row(void *private, const struct dm_report_field_value *values,
+		       unsigned count)
+{
+	struct report *r = private;
+
+	r->rows++;
+
+	return 1;
+}
+
+static bool _report_run(void *context, unsigned size)
+{
+	struct report *r = context;
+	struct dm_report *rh;
+	uint32_t report_types = 1;
+	unsigned i;
+	bool ret = false;
+
+	if (!(rh = dm_report_init(&report_types, _report_types, _report_fields,
+				  "name,size,count", " ", DM_REPORT_OUTPUT_BUFFERED,
+				  "count,-size", NULL)))
+		return false;
+
+	for (i = 0; i < size; i++)
+		if (!dm_report_object(rh, r->obj + i))
+			goto out;
+
+	r->rows = 0;
+	if (!dm_report_output_rows(rh, _report_row, r) || (r->rows != size))
+		goto out;
+
+	ret = true;
+out:
+	dm_report_free(rh);
+
+	return ret;
+}
+
+//-----------------------------------------------------------------
+// Label scan reads, the first 128KiB of 'size' file backed devices
+// through bcache, prefetching them all before waiting on any.
+
+#define SCAN_BLOCK_SECTORS 256
+#define SCAN_DEV_SIZE (1024 * 1024)
+
+struct scan {
+	unsigned nr;
+	int *fd;
+	char template[32];
+};
+
+static void _scan_exit(void *context)
+{
+	struct scan *s = context;
+	char path[64];
+	unsigned i;
+
+	for (i = 0; i < s->nr; i++) {
+		(void) close(s->fd[i]);
+		(void) snprintf(path, sizeof(path), "bench-dev-%u", i);
+		(void) unlink(path);
+	}
+
+	free(s->fd);
+	free(s);
+}
+
+static void *_scan_init(unsigned size)
+{
+	struct scan *s;
+	char path[64];
+	char buf[512] = { 0 };
+
+	if (!(s = zalloc(sizeof(*s))) ||
+	    !(s->fd = malloc(size * sizeof(*s->fd)))) {
+		free(s);
+		return NULL;
+	}
+
+	for (s->nr = 0; s->nr < size; s->nr++) {
+		(void) snprintf(path, sizeof(path), "bench-dev-%u", s->nr);
+		(void) snprintf(buf, sizeof(buf), "LABELONE bench device %u", s->nr);
+		if (((s->fd[s->nr] = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)) < 0) ||
+		    (pwrite(s->fd[s->nr], buf, sizeof(buf), 512) != sizeof(buf)) ||
+		    ftruncate(s->fd[s->nr], SCAN_DEV_SIZE)) {
+			if (s->fd[s->nr] >= 0)
+				s->nr++;
+			_scan_exit(s);
+			return NULL;
+		}
+	}
+
+	return s;
+}
+
+static bool _scan_run(void *context, unsigned size)
+{
+	struct scan *s = context;
+	struct io_engine *e;
+	struct bcache *cache;
+	struct block *b;
+	int *di;
+	unsigned i;
+	bool r = false;
+
+	if (!(di = malloc(s->nr * sizeof(*di))))
+		return false;
+
+	if (!(e = create_async_io_engine()) && !(e = create_sync_io_engine())) {
+		free(di);
+		return false;
+	}
+
+	if (!(cache = bcache_create(SCAN_BLOCK_SECTORS, s->nr, e))) {
+		free(di);
+		return false;
+	}
+
+	for (i = 0; i < s->nr; i++)
+		if ((di[i] = bcache_set_fd(s->fd[i])) < 0)
+			goto out;
+
+	for (i = 0; i < s->nr; i++)
+		bcache_prefetch(cache, di[i], 0);
+
+	for (i = 0; i < s->nr; i++) {
+		if (!bcache_get(cache, di[i], 0, 0, &b))
+			goto out;
+		if (memcmp((char *) b->data + 512, "LABELONE", 8)) {
+			bcache_put(b);
+			goto out;
+		}
+		bcache_put(b);
+	}
+
+	r = true;
+out:
+	for (i = 0; i < s->nr; i++)
+		if (di[i] >= 0) {
+			(void) bcache_invalidate_di(cache, di[i]);
+			bcache_clear_fd(di[i]);
+		}
+
+	bcache_destroy(cache);
+	free(di);
+
+	return r;
+}
+
+//-----------------------------------------------------------------
+// Allocation simulation, placing 'size' linear and striped LVs of
+// random sizes on an in-memory VG of 64 PVs.
+
+#define ALLOC_PVS 64
+#define ALLOC_PV_EXTENTS 65536
+
+struct alloc_bench {
+	struct cmd_context *cmd;
+	struct volume_group *vg;
+	const struct segment_type *striped;
+};
+
+static void _alloc_exit(void *context)
+{
+	struct alloc_bench *ab = context;
+
+	if (ab->vg)
+		release_vg(ab->vg);
+	if (ab->cmd)
+		destroy_toolcontext(ab->cmd);
+	free(ab);
+}
+
+static void *_alloc_init(unsigned size)
+{
+	struct alloc_bench *ab;
+	struct physical_volume *pv;
+	struct pv_list *pvl;
+	unsigned i;
+
+	if (!(ab = zalloc(sizeof(*ab))))
+		return NULL;
+
+	if (!(ab->cmd = create_toolcontext(0, NULL, 0, 0, 0, 0)) ||
+	    !(ab->striped = get_segtype_from_string(ab->cmd, SEG_TYPE_NAME_STRIPED)) ||
+	    !(ab->vg = alloc_vg("bench", ab->cmd, "bench")))
+		goto bad;
+
+	ab->vg->extent_size = 8192;
+	ab->vg->alloc = ALLOC_NORMAL;
+
+	for (i = 0; i < ALLOC_PVS; i++) {
+		if (!(pvl = dm_pool_zalloc(ab->vg->vgmem, sizeof(*pvl))) ||
+		    !(pv = dm_pool_zalloc(ab->vg->vgmem, sizeof(*pv))) ||
+		    !(pv->dev = dm_pool_zalloc(ab->vg->vgmem, sizeof(*pv->dev))))
+			goto bad;
+
+		dm_list_init(&pv->segments);
+		dm_list_init(&pv->tags);
+		pv->status = ALLOCATABLE_PV;
+		pv->pe_count = ALLOC_PV_EXTENTS;
+		pv->vg = ab->vg;
+		if (!alloc_pv_segment_whole_pv(ab->vg->vgmem, pv))
+			goto bad;
+
+		pvl->pv = pv;
+		dm_list_add(&ab->vg->pvs, &pvl->list);
+	}
+
+	return ab;
+bad:
+	_alloc_exit(ab);
+	return NULL;
+}
+
+static bool _alloc_run(void *context, unsigned size)
+{
+	struct alloc_bench *ab = context;
+	struct alloc_simulation *sim;
+	struct alloc_simulation_stats stats;
+	uint64_t state = SEED;
+	uint32_t stripes;
+	unsigned i;
+	bool r = false;
+
+	if (!(sim = alloc_simulation_create(ab->vg, NULL)))
+		return false;
+
+	for (i = 0; i < size; i++) {
+		stripes = (i % 4) ? 1 : 4;
+		if (!alloc_simulate(sim, NULL, ab->striped, stripes, 0, 0, 0,
+				    stripes * (1 + _rand(&state) % 256),
+				    ALLOC_INHERIT, NULL, NULL))
+			goto out;
+	}
+
+	alloc_simulation_get_stats(sim, &stats);
+	r = (stats.allocations == size);
+out:
+	alloc_simulation_destroy(sim);
+
+	return r;
+}
+
+//-----------------------------------------------------------------
+// Command startup: a toolcontext created and destroyed per item.
+
+static void *_toolcontext_init(unsigned size)
+{
+	/* Nothing to prepare, but NULL means failure. */
+	return (void *) 1;
+}
+
+static bool _toolcontext_run(void *context, unsigned size)
+{
+	struct cmd_context *cmd;
+	unsigned i;
+
+	for (i = 0; i < size; i++) {
+		if (!(cmd = create_toolcontext(0, NULL, 0, 0, 0, 0)))
+			return false;
+		destroy_toolcontext(cmd);
+	}
+
+	return true;
+}
+
+static void _toolcontext_exit(void *context)
+{
+}
+
+//-----------------------------------------------------------------
+
+static const struct bench _benches[] = {
+	{ "/base/data-struct/hash/insert-lookup", 100000, _keys_init, _hash_run, _keys_exit },
+	{ "/base/data-struct/radix-tree/insert-lookup-remove", 100000, _keys_init, _radix_tree_run, _keys_exit },
+	{ "/device-mapper/config/parse-metadata", 1000, _metadata_init, _config_parse_run, _metadata_exit },
+	{ "/device-mapper/config/parse-metadata", 10000, _metadata_init, _config_parse_run, _metadata_exit },
+	{ "/device-mapper/config/parse-metadata", 100000, _metadata_init, _config_parse_run, _metadata_exit },
+	{ "/device-mapper/config/write-metadata", 1000, _metadata_init, _config_write_run, _metadata_exit },
+	{ "/device-mapper/config/write-metadata", 10000, _metadata_init, _config_write_run, _metadata_exit },
+	{ "/device-mapper/config/write-metadata", 100000, _metadata_init, _config_write_run, _metadata_exit },
+	{ "/device-mapper/report/sort-output", 10000, _report_init, _report_run, _report_exit },
+	{ "/base/device/bcache/label-scan-reads", 256, _scan_init, _scan_run, _scan_exit },
+	{ "/lib/metadata/alloc/simulate", 10000, _alloc_init, _alloc_run, _alloc_exit },
+	{ "/lib/commands/toolcontext/create-destroy", 100, _toolcontext_init, _toolcontext_run, _toolcontext_exit },
+};
+
+#define MIN_RUNS 3
+#define MAX_RUNS 1000
+#define MIN_TIME_NS 200000000ULL
+
+static bool _run_bench(const struct bench *b, bool *first)
+{
+	unsigned size = b->size * _scale;
+	uint64_t start, t, best = UINT64_MAX, total = 0;
+	unsigned runs;
+	void *context;
+
+	if (!(context = b->init(size))) {
+		fprintf(stderr, "%s: setup failed\n", b->name);
+		return false;
+	}
+
+	for (runs = 0; (runs < MIN_RUNS) || ((total < MIN_TIME_NS) && (runs < MAX_RUNS)); runs++) {
+		start = _now_ns();
+		if (!b->run(context, size)) {
+			fprintf(stderr, "%s: run failed\n", b->name);
+			b->exit(context);
+			return false;
+		}
+		t = _now_ns() - start;
+		total += t;
+		if (t < best)
+			best = t;
+	}
+
+	b->exit(context);
+
+	printf("%s\n  {\"name\": \"%s\", \"size\": %u, \"runs\": %u, "
+	       "\"best_ns\": %llu, \"mean_ns\": %llu, \"ns_per_item\": %.1f}",
+	       *first ? "" : ",", b->name, size, runs,
+	       (unsigned long long) best, (unsigned long long) (total / runs),
+	       (double) best / size);
+	*first = false;
+
+	return true;
+}
+
+static void _usage(void)
+{
+	fprintf(stderr, "Usage: unit-bench [-s|--scale <n>] [-l|--list] [<name regex>]\n");
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option _options[] = {
+		{ "list", no_argument, NULL, 'l' },
+		{ "scale", required_argument, NULL, 's' },
+		{ NULL, 0, NULL, 0 }
+	};
+	regex_t rx;
+	bool use_rx = false, list = false, first = true;
+	unsigned i;
+	int c, r = 0;
+
+	while ((c = getopt_long(argc, argv, "ls:", _options, NULL)) != -1) {
+		switch (c) {
+		case 'l':
+			list = true;
+			break;
+		case 's':
+			if ((_scale = strtoul(optarg, NULL, 10)) < 1) {
+				_usage();
+				return 1;
+			}
+			break;
+		default:
+			_usage();
+			return 1;
+		}
+	}
+
+	if (optind < argc) {
+		if (regcomp(&rx, argv[optind], REG_EXTENDED | REG_NOSUB)) {
+			fprintf(stderr, "Invalid regex '%s'\n", argv[optind]);
+			return 1;
+		}
+		use_rx = true;
+	}
+
+	if (!list)
+		printf("[");
+
+	for (i = 0; i < DM_ARRAY_SIZE(_benches); i++) {
+		if (use_rx && regexec(&rx, _benches[i].name, 0, NULL, 0))
+			continue;
+
+		if (list)
+			printf("%s %u\n", _benches[i].name, _benches[i].size * _scale);
+		else if (!_run_bench(_benches + i, &first))
+			r = 1;
+	}
+
+	if (!list)
+		printf("\n]\n");
+
+	if (use_rx)
+		regfree(&rx);
+
+	return r;
+}
+
+//-----------------------------------------------------------------
@@ -93,6 +93,84 @@ static void test_parse(void *fixture)
 	dm_config_destroy(tree);
 }
 
+static const char *in_place_conf =
+	"vg0 {\n"
+	"id=\"yada-yada\"\n"
+	"seqno = 15# comment\n"
+	"status = [\"READ\",\"WRITE\"]\n"
+	"desc = \"a \\\"quoted\\\" name\"\n"
+	"empty = \"\"\n"
+	"tags=[\"t1\"]\n"
+	"pv0{id = \"abcd-efgh\"}\n"
+	"pv0 {bare = word}\n"
+	"}\n"
+	"last = 1";
+
+static void test_parse_in_place(void *fixture)
+{
+	struct dm_config_tree *tree = dm_config_create();
+	const struct dm_config_value *value;
+	const struct dm_config_node *cn;
+	size_t len = strlen(in_place_conf);
+	char *buf = dm_pool_alloc(tree->mem, len + 1);
+
+	T_ASSERT(buf);
+	memcpy(buf, in_place_conf, len + 1);
+	T_ASSERT(dm_config_parse_in_place(tree, buf, buf + len, 0));
+
+	T_ASSERT(!strcmp(dm_config_find_str(tree->root, "vg0/id", "foo"), "yada-yada"));
+	T_ASSERT(dm_config_find_int(tree->root, "vg0/seqno", 0) == 15);
+	T_ASSERT(!strcmp(dm_config_find_str(tree->root, "vg0/desc", "foo"), "a \"quoted\" name"));
+	T_ASSERT((cn = dm_config_find_node(tree->root, "vg0/empty")));
+	T_ASSERT(cn->v->type == DM_CFG_STRING && !*cn->v->v.str);
+	T_ASSERT(!strcmp(dm_config_find_str(tree->root, "vg0/pv0/id", "foo"), "abcd-efgh"));
+	T_ASSERT(!strcmp(dm_config_find_str(tree->root, "vg0/pv0/bare", "foo"), "word"));
+	T_ASSERT(dm_config_find_int(tree->root, "last", 0) == 1);
+
+	T_ASSERT(dm_config_get_list(tree->root, "vg0/status", &value));
+	T_ASSERT(!strcmp(value->v.str, "READ"));
+	T_ASSERT(value->next && !strcmp(value->next->v.str, "WRITE"));
+	T_ASSERT(dm_config_get_list(tree->root, "vg0/tags", &value));
+	T_ASSERT(!strcmp(value->v.str, "t1") && !value->next);
+
+	/* Keys and values are taken from the buffer itself. */
+	T_ASSERT((cn = dm_config_find_node(tree->root, "vg0/id")));
+	T_ASSERT(cn->key >= buf && cn->key < buf + len);
+	T_ASSERT(cn->v->v.str >= buf && cn->v->v.str < buf + len);
+
+	dm_config_destroy(tree);
+}
+
+static void test_parse_wide(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+	struct dm_config_tree *tree;
+	const struct dm_config_node *cn;
+	char *buf;
+	unsigned i, n;
+
+	/* Enough children to get the section indexed, then duplicates. */
+	T_ASSERT((buf = dm_pool_alloc(mem, 200 * 32 + 64)));
+	i = sprintf(buf, "lvs {\n");
+	for (n = 0; n < 200; n++)
+		i += sprintf(buf + i, "lv%u { id = %u }\n", n, n);
+	sprintf(buf + i, "lv7 { extra = 1 }\nlv150 { id = 0 }\n}\nlvs/lv42/path = 2\n");
+
+	T_ASSERT((tree = dm_config_from_string(buf)));
+
+	T_ASSERT((cn = dm_config_find_node(tree->root, "lvs")));
+	for (i = 0, cn = cn->child; cn; cn = cn->sib, i++)
+		T_ASSERT(!strncmp(cn->key, "lv", 2) && (unsigned) atoi(cn->key + 2) == i);
+	T_ASSERT(i == 200);
+
+	T_ASSERT(dm_config_find_int(tree->root, "lvs/lv7/id", -1) == 7);
+	T_ASSERT(dm_config_find_int(tree->root, "lvs/lv7/extra", -1) == 1);
+	T_ASSERT(dm_config_find_int(tree->root, "lvs/lv150/id", -1) == 0);
+	T_ASSERT(dm_config_find_int(tree->root, "lvs/lv42/path", -1) == 2);
+
+	dm_config_destroy(tree);
+}
+
 static void test_clone(void *fixture)
 {
 	struct dm_config_tree *tree = dm_config_from_string(conf);
@@ -173,6 +251,8 @@ void config_tests(struct dm_list *all_tests)
 	}
 
 	T("parse", "parsing various", test_parse);
+	T("parse-in-place", "parsing a buffer in place", test_parse_in_place);
+	T("parse-wide", "parsing a section with many children", test_parse_wide);
 	T("clone", "duplicating a config tree", test_clone);
 	T("cascade", "cascade", test_cascade);
 
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU General Public License v.2.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "units.h"
+#include "lib/misc/crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BUF_SIZE 4096
+#define BENCH_SIZE (16 * 1024 * 1024)
+
+static void *_buf_init(void)
+{
+	uint8_t *buf = malloc(BUF_SIZE);
+	unsigned i, r = 1;
+
+	if (!buf) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	for (i = 0; i < BUF_SIZE; i++) {
+		r = r * 1103515245 + 12345;
+		buf[i] = r >> 16;
+	}
+
+	return buf;
+}
+
+static void _buf_exit(void *buf)
+{
+	free(buf);
+}
+
+/* Bit at a time reference for the polynomial used by calc_crc() */
+static uint32_t _crc_bitwise(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	int i;
+
+	while (size--) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	}
+
+	return crc;
+}
+
+static void test_check_value(void *fixture)
+{
+	const uint8_t check[] = "123456789";
+
+	/* Standard CRC-32 check value */
+	T_ASSERT_EQUAL(calc_crc(0xffffffff, check, 9) ^ 0xffffffff, 0xcbf43926);
+	T_ASSERT_EQUAL(calc_crc(INITIAL_CRC, check, 0), INITIAL_CRC);
+}
+
+static void test_lengths_and_offsets(void *fixture)
+{
+	const uint8_t *buf = fixture;
+	unsigned len, off;
+
+	for (off = 0; off < 16; off++)
+		for (len = 0; len <= 1100; len += (len < 300) ? 1 : 37)
+			T_ASSERT_EQUAL(calc_crc(INITIAL_CRC, buf + off, len),
+				       _crc_bitwise(INITIAL_CRC, buf + off, len));
+
+	T_ASSERT_EQUAL(calc_crc(INITIAL_CRC, buf, BUF_SIZE),
+		       _crc_bitwise(INITIAL_CRC, buf, BUF_SIZE));
+}
+
+static void test_chained(void *fixture)
+{
+	const uint8_t *buf = fixture;
+	uint32_t crc = calc_crc(INITIAL_CRC, buf, BUF_SIZE);
+	unsigned split;
+
+	/* The crc of a wrapped metadata area is computed in two parts. */
+	for (split = 0; split <= BUF_SIZE; split += 119)
+		T_ASSERT_EQUAL(calc_crc(calc_crc(INITIAL_CRC, buf, split),
+					buf + split, BUF_SIZE - split), crc);
+}
+
+static void test_bench(void *fixture)
+{
+	uint8_t *buf = malloc(BENCH_SIZE);
+	struct timespec start, end;
+	uint32_t crc = INITIAL_CRC;
+	double secs;
+	unsigned i;
+
+	T_ASSERT(buf);
+	memset(buf, 0x5a, BENCH_SIZE);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < 8; i++)
+		crc = calc_crc(crc, buf, BENCH_SIZE);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("  crc32 of %u MiB: %.3fs (%.0f MiB/s, crc %08x)\n",
+	       8 * (BENCH_SIZE >> 20), secs, (secs > 0) ? 8 * (BENCH_SIZE >> 20) / secs : 0.0, crc);
+
+	free(buf);
+}
+
+#define T(path, desc, fn) register_test(ts, "/lib/misc/crc/" path, desc, fn)
+
+void crc_tests(struct dm_list *all_tests)
+{
+	struct test_suite *ts = test_suite_create(_buf_init, _buf_exit);
+	if (!ts) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	T("check-value", "standard crc32 check value", test_check_value);
+	T("lengths", "all lengths and alignments match bitwise crc", test_lengths_and_offsets);
+	T("chained", "crc computed in two parts", test_chained);
+	T("bench", "crc32 throughput", test_bench);
+
+	dm_list_add(all_tests, &ts->list);
+}
@@ -45,6 +45,72 @@ static void test_hash_insert(void *fixture)
 	dm_hash_destroy(hash);
 }
 
+static void test_hash_grow(void *fixture)
+{
+	struct dm_hash_node *node;
+	struct dm_hash_table *hash = dm_hash_create(10);
+	unsigned i, n = 0;
+	char key[16];
+
+	T_ASSERT(hash);
+
+	for (i = 0; i < 100000; i++) {
+		snprintf(key, sizeof(key), "key%u", i);
+		T_ASSERT(dm_hash_insert(hash, key, (void *)(uintptr_t)(i + 1)));
+	}
+
+	T_ASSERT(dm_hash_get_num_entries(hash) == 100000);
+
+	for (i = 0; i < 100000; i++) {
+		snprintf(key, sizeof(key), "key%u", i);
+		T_ASSERT(dm_hash_lookup(hash, key) == (void *)(uintptr_t)(i + 1));
+	}
+
+	dm_hash_iterate(node, hash)
+		n++;
+	T_ASSERT(n == 100000);
+
+	for (i = 0; i < 100000; i += 2) {
+		snprintf(key, sizeof(key), "key%u", i);
+		dm_hash_remove(hash, key);
+	}
+
+	T_ASSERT(dm_hash_get_num_entries(hash) == 50000);
+	T_ASSERT(!dm_hash_lookup(hash, "key0"));
+	T_ASSERT(dm_hash_lookup(hash, "key1") == (void *)(uintptr_t)2);
+
+	dm_hash_destroy(hash);
+}
+
+static void test_hash_grow_multiple(void *fixture)
+{
+	static const char _vals[] = { 'a', 'b', 'c' };
+	struct dm_hash_table *hash = dm_hash_create(1);
+	unsigned i;
+	char key[16];
+	int count;
+
+	T_ASSERT(hash);
+
+	for (i = 0; i < DM_ARRAY_SIZE(_vals); i++)
+		T_ASSERT(dm_hash_insert_allow_multiple(hash, "dup", &_vals[i], 1));
+
+	/* force several resizes with the duplicates already in place */
+	for (i = 0; i < 1000; i++) {
+		snprintf(key, sizeof(key), "key%u", i);
+		T_ASSERT(dm_hash_insert(hash, key, (void *)(uintptr_t)(i + 1)));
+	}
+
+	/* most recently inserted duplicate is still found first */
+	T_ASSERT(dm_hash_lookup_with_count(hash, "dup", &count) == &_vals[2]);
+	T_ASSERT_EQUAL(count, 3);
+
+	for (i = 0; i < DM_ARRAY_SIZE(_vals); i++)
+		T_ASSERT(dm_hash_lookup_with_val(hash, "dup", &_vals[i], 1) == &_vals[i]);
+
+	dm_hash_destroy(hash);
+}
+
 #define T(path, desc, fn) register_test(ts, "/base/data-struct/hash/" path, desc, fn)
 
 void dm_hash_tests(struct dm_list *all_tests)
@@ -56,6 +122,8 @@ void dm_hash_tests(struct dm_list *all_tests)
 	}
 
 	T("insert", "inserting hash elements", test_hash_insert);
+	T("grow", "table grows past its size hint", test_hash_grow);
+	T("grow-multiple", "duplicate keys keep their order when the table grows", test_hash_grow_multiple);
 
 	dm_list_add(all_tests, &ts->list);
 }
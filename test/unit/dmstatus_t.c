@@ -104,6 +104,57 @@ static void _test_raid_status(void *fixture)
 
 }
 
+static void _test_thin_pool_status(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+	struct dm_status_thin_pool *s = NULL;
+
+	T_ASSERT(dm_get_status_thin_pool(mem,
+					 "1 253/4096 1023/81920 - rw discard_passdown queue_if_no_space - 1024",
+					 &s));
+	if (s) {
+		T_ASSERT_EQUAL(s->transaction_id, 1);
+		T_ASSERT_EQUAL(s->used_metadata_blocks, 253);
+		T_ASSERT_EQUAL(s->total_metadata_blocks, 4096);
+		T_ASSERT_EQUAL(s->used_data_blocks, 1023);
+		T_ASSERT_EQUAL(s->total_data_blocks, 81920);
+		T_ASSERT_EQUAL(s->discards, DM_THIN_DISCARDS_PASSDOWN);
+		T_ASSERT(!s->read_only);
+		T_ASSERT(!s->out_of_data_space);
+		T_ASSERT(!s->error_if_no_space);
+		T_ASSERT(!s->needs_check);
+		T_ASSERT(!s->fail);
+	}
+
+	T_ASSERT(dm_get_status_thin_pool(mem,
+					 "7 10/20 30/40 - ro no_discard_passdown error_if_no_space needs_check 1024",
+					 &s));
+	if (s) {
+		T_ASSERT_EQUAL(s->transaction_id, 7);
+		T_ASSERT_EQUAL(s->total_data_blocks, 40);
+		T_ASSERT_EQUAL(s->discards, DM_THIN_DISCARDS_NO_PASSDOWN);
+		T_ASSERT(s->read_only);
+		T_ASSERT(s->error_if_no_space);
+		T_ASSERT(s->needs_check);
+	}
+
+	T_ASSERT(dm_get_status_thin_pool(mem,
+					 "7 10/20 40/40 - out_of_data_space ignore_discard queue_if_no_space -",
+					 &s));
+	if (s) {
+		T_ASSERT_EQUAL(s->discards, DM_THIN_DISCARDS_IGNORE);
+		T_ASSERT(s->out_of_data_space);
+		T_ASSERT(!s->read_only);
+	}
+
+	T_ASSERT(dm_get_status_thin_pool(mem, "Fail", &s));
+	if (s)
+		T_ASSERT(s->fail);
+
+	T_ASSERT(!dm_get_status_thin_pool(mem, "7 10 20/30", &s));
+	T_ASSERT(!dm_get_status_thin_pool(mem, "x 10/20 30/40", &s));
+}
+
 void dm_status_tests(struct dm_list *all_tests)
 {
 	struct test_suite *ts = test_suite_create(_mem_init, _mem_exit);
@@ -114,6 +165,7 @@ void dm_status_tests(struct dm_list *all_tests)
 
 	register_test(ts, "/device-mapper/mirror/status", "parsing mirror status", _test_mirror_status);
 	register_test(ts, "/device-mapper/raid/status", "parsing raid status", _test_raid_status);
+	register_test(ts, "/device-mapper/thin-pool/status", "parsing thin pool status", _test_thin_pool_status);
 	dm_list_add(all_tests, &ts->list);
 }
 
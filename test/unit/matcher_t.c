@@ -18,6 +18,8 @@
 
 #include "matcher_data.h"
 
+#include <time.h>
+
 static void *_mem_init(void)
 {
 	struct dm_pool *mem = dm_pool_create("bitset test", 1024);
@@ -111,6 +113,47 @@ static void test_kabi_query(void *fixture)
 
 }
 
+static void test_bench(void *fixture)
+{
+	static const char * const _names[] = {
+		"/dev/sda1",
+		"/dev/disk/by-id/wwn-0x5000c500a1b2c3d4-part1",
+		"/dev/disk/by-path/pci-0000:00:1f.2-ata-1-part1",
+		"/dev/disk/by-uuid/1234-5678-9abc-def0",
+		"/dev/mapper/mpath_123abc_part1",
+	};
+	struct dm_pool *mem = fixture;
+	struct dm_regex *scanner;
+	static char buf[400][64];
+	const char *patterns[400];
+	struct timespec start, end;
+	double secs;
+	unsigned i, n;
+	int r = 0;
+
+	for (i = 0; i < DM_ARRAY_SIZE(patterns); i++) {
+		snprintf(buf[i], sizeof(buf[i]), "^/dev/mapper/mpath_%03u[a-f]+_part[0-9]*$", i);
+		patterns[i] = buf[i];
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	scanner = dm_regex_create(mem, patterns, DM_ARRAY_SIZE(patterns));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	T_ASSERT(scanner);
+	secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("  compile %u patterns: %.3fms\n", (unsigned) DM_ARRAY_SIZE(patterns), secs * 1e3);
+
+	T_ASSERT_EQUAL(dm_regex_match(scanner, _names[4]), 123);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (n = 0; n < 20000; n++)
+		for (i = 0; i < DM_ARRAY_SIZE(_names); i++)
+			r += dm_regex_match(scanner, _names[i]);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("  match: %.0fns per name (%d)\n", secs * 1e9 / (n * DM_ARRAY_SIZE(_names)), r);
+}
+
 #define T(path, desc, fn) register_test(ts, "/base/regex/" path, desc, fn)
 
 void regex_tests(struct dm_list *all_tests)
@@ -124,6 +167,7 @@ void regex_tests(struct dm_list *all_tests)
 	T("fingerprints", "not sure", test_fingerprints);
 	T("matching", "test the matcher with a variety of regexes", test_matching);
 	T("kabi-query", "test the matcher with some specific patterns", test_kabi_query);
+	T("bench", "compile and match speed with many patterns", test_bench);
 
 	dm_list_add(all_tests, &ts->list);
 }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU General Public License v.2.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "units.h"
+#include "device_mapper/all.h"
+
+static void *_mem_init(void)
+{
+	struct dm_pool *mem = dm_pool_create("pool test", 1024);
+
+	if (!mem)
+		test_fail("out of memory");
+
+	return mem;
+}
+
+static void _mem_exit(void *mem)
+{
+	dm_pool_destroy(mem);
+}
+
+static void test_stats_alloc(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+	struct dm_pool_stats stats;
+	char *p;
+	unsigned i;
+
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT_EQUAL(stats.alloc_bytes, 0);
+	T_ASSERT_EQUAL(stats.objects, 0);
+	T_ASSERT_EQUAL(stats.chunk_bytes, 0);
+
+	T_ASSERT(p = dm_pool_alloc(mem, 100));
+	for (i = 0; i < 99; i++)
+		T_ASSERT(dm_pool_alloc(mem, 100));
+
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT_EQUAL(stats.alloc_bytes, 100 * 100);
+	T_ASSERT_EQUAL(stats.objects, 100);
+	T_ASSERT(stats.chunks > 0);
+	T_ASSERT(stats.chunk_bytes >= stats.alloc_bytes);
+	T_ASSERT_EQUAL(stats.chunk_bytes, stats.chunk_bytes_max);
+
+	/* Freeing keeps counters and high-water mark */
+	dm_pool_free(mem, p);
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT_EQUAL(stats.objects, 100);
+	T_ASSERT(stats.chunk_bytes <= stats.chunk_bytes_max);
+}
+
+static void test_stats_object(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+	struct dm_pool_stats stats;
+	unsigned i;
+
+	T_ASSERT(dm_pool_begin_object(mem, 16));
+	for (i = 0; i < 1000; i++)
+		T_ASSERT(dm_pool_grow_object(mem, "0123456789", 10));
+	T_ASSERT(dm_pool_end_object(mem));
+
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT_EQUAL(stats.alloc_bytes, 10000);
+	T_ASSERT_EQUAL(stats.objects, 1);
+	T_ASSERT(stats.chunk_bytes_max >= 10000);
+}
+
+static void _alloc_chunks(struct dm_pool *mem, unsigned count)
+{
+	unsigned i;
+
+	/* Each allocation needs its own chunk */
+	for (i = 0; i < count; i++)
+		T_ASSERT(dm_pool_alloc(mem, 1500));
+}
+
+static void test_chunk_cache(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+	struct dm_pool_stats stats;
+	uint64_t chunks;
+
+	_alloc_chunks(mem, 10);
+	dm_pool_empty(mem);
+	dm_pool_get_stats(mem, &stats);
+	chunks = stats.chunks;
+
+	/* Without cache just a single spare chunk is kept */
+	_alloc_chunks(mem, 10);
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT(stats.chunks > chunks);
+
+	dm_pool_set_chunk_cache(mem, 1024 * 1024, 0);
+	dm_pool_empty(mem);
+	dm_pool_get_stats(mem, &stats);
+	chunks = stats.chunks;
+
+	_alloc_chunks(mem, 10);
+	dm_pool_empty(mem);
+	_alloc_chunks(mem, 10);
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT_EQUAL(stats.chunks, chunks);
+
+	/* Shrinking the cache releases chunks */
+	dm_pool_empty(mem);
+	dm_pool_get_stats(mem, &stats);
+	chunks = stats.chunk_bytes;
+	dm_pool_set_chunk_cache(mem, 0, 0);
+	dm_pool_get_stats(mem, &stats);
+	T_ASSERT(stats.chunk_bytes < chunks);
+}
+
+#define T(path, desc, fn) register_test(ts, "/base/memory/pool/" path, desc, fn)
+
+void pool_tests(struct dm_list *all_tests)
+{
+	struct test_suite *ts = test_suite_create(_mem_init, _mem_exit);
+	if (!ts) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	T("stats-alloc", "allocations are accounted", test_stats_alloc);
+	T("stats-object", "grown objects are accounted", test_stats_object);
+	T("chunk-cache", "released chunks are reused", test_chunk_cache);
+
+	dm_list_add(all_tests, &ts->list);
+}
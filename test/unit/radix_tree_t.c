@@ -16,6 +16,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 //----------------------------------------------------------------
 
@@ -811,6 +812,42 @@ static void test_bcache_scenario3(void *fixture)
 }
 
 //----------------------------------------------------------------
+static double _elapsed(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Device numbers as dev-cache keys them: many minors under few majors.
+static void test_bench(void *fixture)
+{
+	struct radix_tree *rt = fixture;
+	struct timespec start, end;
+	unsigned i, n = 100000, found = 0;
+	union radix_value v;
+	uint64_t k;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i++) {
+		k = ((uint64_t) (8 + i % 16) << 20) | (i / 16);
+		v.n = i;
+		T_ASSERT(radix_tree_insert(rt, &k, sizeof(k), v));
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf("  insert %u keys: %.0fns per key\n", n, _elapsed(&start, &end) * 1e9 / n);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i++) {
+		k = ((uint64_t) (8 + i % 16) << 20) | (i / 16);
+		if (radix_tree_lookup(rt, &k, sizeof(k), &v) && (v.n == i))
+			found++;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf("  lookup %u keys: %.0fns per key\n", n, _elapsed(&start, &end) * 1e9 / n);
+
+	T_ASSERT_EQUAL(found, n);
+	T_ASSERT(radix_tree_is_well_formed(rt));
+}
+
 #define T(path, desc, fn) register_test(ts, "/base/data-struct/radix-tree/" path, desc, fn)
 
 void radix_tree_tests(struct dm_list *all_tests)
@@ -846,6 +883,7 @@ void radix_tree_tests(struct dm_list *all_tests)
 	T("bcache-scenario", "A specific series of keys from a bcache scenario", test_bcache_scenario);
 	T("bcache-scenario-2", "A second series of keys from a bcache scenario", test_bcache_scenario2);
 	T("bcache-scenario-3", "A third series of keys from a bcache scenario", test_bcache_scenario3);
+	T("bench", "insert and lookup throughput for devno keys", test_bench);
 
 	dm_list_add(all_tests, &ts->list);
 }
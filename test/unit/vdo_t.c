@@ -288,6 +288,68 @@ static void _test_status_bad(void *fixture)
 	_check_bad(_bad, DM_ARRAY_SIZE(_bad));
 }
 
+static void _test_stats_good(void *fixture)
+{
+	static const char _input[] =
+		"{ version : 36, dataBlocksUsed : 1000, overheadBlocksUsed : 200, "
+		"logicalBlocksUsed : 3000, physicalBlocks : 262144, logicalBlocks : 524288, "
+		"mode : normal, "
+		"packer : { compressedFragmentsWritten : 11, compressedBlocksWritten : 4, "
+		"compressedFragmentsInPacker : 2, }, "
+		"journal : { diskFull : 0, slabJournalCommitsRequested : 5, "
+		"entries : { started : 9, written : 8, committed : 7, }, "
+		"blocks : { started : 3, written : 2, committed : 1, }, }, "
+		"hashLock : { dedupeAdviceValid : 40, dedupeAdviceStale : 1, "
+		"concurrentDataMatches : 6, concurrentHashCollisions : 0, }, "
+		"dedupeAdviceTimeouts : 12, "
+		"biosIn : { read : 100, write : 50, discard : 3, }, "
+		"index : { entriesIndexed : 80, postsFound : 30, postsNotFound : 20, }, }";
+	struct dm_vdo_stats s;
+
+	T_ASSERT(dm_vdo_stats_parse(_input, &s));
+	T_ASSERT_EQUAL(s.data_blocks_used, 1000);
+	T_ASSERT_EQUAL(s.overhead_blocks_used, 200);
+	T_ASSERT_EQUAL(s.logical_blocks_used, 3000);
+	T_ASSERT_EQUAL(s.physical_blocks, 262144);
+	T_ASSERT_EQUAL(s.logical_blocks, 524288);
+	T_ASSERT_EQUAL(s.dedupe_advice_timeouts, 12);
+	T_ASSERT_EQUAL(s.packer.fragments_written, 11);
+	T_ASSERT_EQUAL(s.packer.blocks_written, 4);
+	T_ASSERT_EQUAL(s.packer.fragments_in_packer, 2);
+	T_ASSERT_EQUAL(s.journal.disk_full, 0);
+	T_ASSERT_EQUAL(s.journal.entries_committed, 7);
+	T_ASSERT_EQUAL(s.journal.blocks_committed, 1);
+	T_ASSERT_EQUAL(s.hash_lock.dedupe_advice_valid, 40);
+	T_ASSERT_EQUAL(s.hash_lock.dedupe_advice_stale, 1);
+	T_ASSERT_EQUAL(s.hash_lock.concurrent_data_matches, 6);
+	T_ASSERT_EQUAL(s.hash_lock.concurrent_hash_collisions, 0);
+	T_ASSERT_EQUAL(s.bios_in.write, 50);
+	T_ASSERT_EQUAL(s.bios_in.discard, 3);
+	T_ASSERT_EQUAL(s.index.posts_found, 30);
+	T_ASSERT_EQUAL(s.index.posts_not_found, 20);
+}
+
+static void _test_stats_missing(void *fixture)
+{
+	struct dm_vdo_stats s;
+
+	/* Same names in other groups must not match. */
+	T_ASSERT(dm_vdo_stats_parse("dataBlocksUsed : 5, logicalBlocksUsed : x, "
+				    "foo : { write : 7, dataBlocksUsed : 9 }", &s));
+	T_ASSERT_EQUAL(s.data_blocks_used, 5);
+	T_ASSERT_EQUAL(s.logical_blocks_used, UINT64_MAX);
+	T_ASSERT_EQUAL(s.bios_in.write, UINT64_MAX);
+	T_ASSERT_EQUAL(s.index.posts_found, UINT64_MAX);
+}
+
+static void _test_stats_bad(void *fixture)
+{
+	struct dm_vdo_stats s;
+
+	T_ASSERT(!dm_vdo_stats_parse("{ dataBlocksUsed : 5, ", &s));
+	T_ASSERT(!dm_vdo_stats_parse("dataBlocksUsed : 5 } }", &s));
+}
+
 //----------------------------------------------------------------
 
 #define T(path, desc, fn) register_test(ts, "/device-mapper/vdo/status/" path, desc, fn)
@@ -314,6 +376,9 @@ static struct test_suite *_tests(void)
 	T("total-blocks-good", "total blocks, good examples", _test_total_blocks_good);
 	T("total-blocks-bad", "total blocks, bad examples", _test_total_blocks_bad);
 	T("bad", "parse various badly formed vdo status lines", _test_status_bad);
+	T("stats-good", "parse stats message", _test_stats_good);
+	T("stats-missing", "stats message with missing values", _test_stats_missing);
+	T("stats-bad", "badly formed stats messages", _test_stats_bad);
 
 	return ts;
 }
@@ -44,8 +44,9 @@ arg(addtag_ARG, '\0', "addtag", tag_VAL, ARG_GROUPABLE, 0,
     "Adds a tag to a PV, VG or LV. This option can be repeated to add\n"
     "multiple tags at once. See \\fBlvm\\fP(8) for information about tags.\n")
 
-arg(adddev_ARG, '\0', "adddev", pv_VAL, 0, 0,
-    "Add a device to the devices file.\n")
+arg(adddev_ARG, '\0', "adddev", pv_VAL, ARG_GROUPABLE, 0,
+    "Add a device to the devices file. This option can be repeated to add\n"
+    "multiple devices with a single update of the devices file.\n")
 
 arg(deldev_ARG, '\0', "deldev", string_VAL, 0, 0,
     "Remove a device from the devices file.\n"
@@ -312,6 +313,14 @@ arg(foreign_ARG, '\0', "foreign", 0, 0, 0,
     "Report/display foreign VGs that would otherwise be skipped.\n"
     "See \\fBlvmsystemid\\fP(7) for more information about foreign VGs.\n")
 
+arg(follow_ARG, '\0', "follow", 0, 0, 0,
+    "Keep running after the report and check for changes every --interval\n"
+    "seconds (default 2). The VG metadata seqno from a rescan of the\n"
+    "headers and the event numbers of active devices are compared to\n"
+    "the last check. When they change, the rows of the changed VGs are\n"
+    "reported again and replace those reported before. Rows of VGs\n"
+    "that did not change are not repeated. Stop with Ctrl-C.\n")
+
 arg(fs_ARG, '\0', "fs", string_VAL, 0, 0,
     "Control file system resizing when resizing an LV.\n"
     "\\fBchecksize\\fP: Check the fs size and reduce the LV if the fs is not\n"
@@ -602,6 +611,14 @@ arg(settings_ARG, '\0', "settings", string_VAL, ARG_GROUPABLE, 0,
     "Combine multiple settings in quotes, or repeat the settings\n"
     "option for each.\n")
 
+arg(parallel_ARG, '\0', "parallel", number_VAL, 0, 0,
+    "Process up to this many objects at once, each in its own process.\n"
+    "With --refresh these are LVs. LVs that share devices with other LVs\n"
+    "(thin, cache, snapshot, VDO, writecache, or LVs used by other LVs)\n"
+    "and LVs in shared VGs are still refreshed one by one.\n"
+    "With --activate these are VGs, each locked and read by its own\n"
+    "process. Shared VGs and use with --select are processed one by one.\n")
+
 arg(poll_ARG, '\0', "poll", bool_VAL, 0, 0,
     "When yes, start the background transformation of an LV.\n"
     "An incomplete transformation, e.g. pvmove or lvconvert interrupted\n"
@@ -1265,7 +1282,8 @@ arg(import_ARG, 'i', "import", 0, 0, 0,
     "will not be changed (nor will their associated PVs).\n")
 
 arg(interval_ARG, 'i', "interval", number_VAL, 0, 0,
-    "Report progress at regular intervals.\n")
+    "Report progress at regular intervals.\n"
+    "With --follow, the number of seconds between checks for changes.\n")
 
 /* Not used */
 arg(iop_version_ARG, 'i', "iop_version", 0, 0, 0, NULL)
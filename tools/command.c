@@ -1282,8 +1282,21 @@ static int _copy_line(const char **line, size_t max_line, int *position)
 	return len;
 }
 
+/*
+ * While skipping the defs of commands other than run_name, only lines
+ * that may begin a new command def, an ID: line or an OO_FOO: definition
+ * are used, so the others need not be copied and split.
+ */
+static int _line_used_when_skipping(const char *line)
+{
+	return islower(line[0]) ||
+		!strncmp(line, "ID:", 3) ||
+		!strncmp(line, "OO_", 3);
+}
+
 int define_commands(struct cmd_context *cmdtool, const char *run_name)
 {
+	static int _commands_defined = 0;
 	struct command *cmd = NULL;
 	const char *line_orig;
 	char line[MAX_LINE];
@@ -1300,7 +1313,14 @@ int define_commands(struct cmd_context *cmdtool, const char *run_name)
 	int i;
 	int lvm_command_enum;
 
-	memset(&commands, 0, sizeof(commands));
+	/*
+	 * The static commands[] is still zero on the first call and clearing
+	 * it would only fault in all of its pages, which costs more than
+	 * parsing the defs of the command being run.
+	 */
+	if (_commands_defined)
+		memset(&commands, 0, sizeof(commands));
+	_commands_defined = 1;
 
 	if (run_name && !strcmp(run_name, "help"))
 		run_name = NULL;
@@ -1314,6 +1334,9 @@ int define_commands(struct cmd_context *cmdtool, const char *run_name)
 		    (!line_orig[2] || (line_orig[2] == '-' && !line_orig[3])))
 			continue; /* "---"  or "--" */
 
+		if (skip && !prev_was_oo_def && !_line_used_when_skipping(line_orig))
+			continue;
+
 		memcpy(line, line_orig, line_orig_len + 1);
 		_split_line(line, &line_argc, line_argv, ' ');
 
@@ -1263,6 +1263,36 @@ static int _commit_reload(struct logical_volume *lv, uint32_t mr)
 	return 1;
 }
 
+/*
+ * Postpone the commit of metadata only changes of @lv, so that
+ * process_each_lv_in_vg() writes the VG once after all its LVs
+ * instead of once per LV.  The change message is printed with that
+ * commit.  Changes requesting a reload are postponed only for
+ * inactive LVs, where there is no table to reload.
+ * Returns 0 when the caller is to commit (or skip) it now.
+ */
+static int _postpone_commit(struct logical_volume *lv, uint32_t mr)
+{
+	struct volume_group *vg = lv->vg;
+	char msg[NAME_LEN * 2 + 32];
+	char *msg_dup;
+
+	if (!mr || ((mr & MR_RELOAD) && lv_is_active(lv_lock_holder(lv))))
+		return 0;
+
+	if ((dm_snprintf(msg, sizeof(msg), "Logical volume %s changed.",
+			 display_lvname(lv)) < 0) ||
+	    !(msg_dup = dm_pool_strdup(vg->vgmem, msg)) ||
+	    !str_list_add_no_dup_check(vg->vgmem, &vg->msg_list, msg_dup))
+		return 0;
+
+	log_debug_metadata("Postponing write and commit of %s.", display_lvname(lv));
+	vg->needs_write_and_commit = 1;
+	vg->write_and_commit_on_error = 1;
+
+	return 1;
+}
+
 /* Helper: check @opt_num is listed in @opts array */
 static int _is_option_listed(int opt_enum, const int *options)
 {
@@ -1465,10 +1495,17 @@ static int _lvchange_properties_single(struct cmd_context *cmd,
 
 		/* Display any logical volume change */
 		if (doit_total) {
-			log_print_unless_silent("Logical volume %s changed.", display_lvname(lv));
 			change_msg = 0;
 
-			/* Commit(, reload) metadata once for whole processed group of options */
+			/*
+			 * Commit(, reload) metadata once for whole processed group of options,
+			 * or once for the whole VG when nothing else needs the commit now.
+			 */
+			if (!second_group && (docmds == doit_total) && _postpone_commit(lv, mr))
+				return ECMD_PROCESSED;
+
+			log_print_unless_silent("Logical volume %s changed.", display_lvname(lv));
+
 			if (!_commit_reload(lv, mr))
 				return_ECMD_FAILED;
 		}
@@ -1744,9 +1781,9 @@ int lvchange_activate_cmd(struct cmd_context *cmd, int argc, char **argv)
 	return ret;
 }
 
-static int _lvchange_refresh_single(struct cmd_context *cmd,
-				    struct logical_volume *lv,
-				    struct processing_handle *handle)
+static int _lvchange_refresh_lv(struct cmd_context *cmd,
+				struct logical_volume *lv,
+				struct processing_handle *handle)
 {
 	log_verbose("Refreshing logical volume %s (if active).", display_lvname(lv));
 
@@ -1768,6 +1805,13 @@ static int _lvchange_refresh_single(struct cmd_context *cmd,
 	return ECMD_PROCESSED;
 }
 
+static int _lvchange_refresh_single(struct cmd_context *cmd,
+				    struct logical_volume *lv,
+				    struct processing_handle *handle)
+{
+	return process_lv_in_worker(cmd, lv, handle, &_lvchange_refresh_lv);
+}
+
 static int _lvchange_refresh_check(struct cmd_context *cmd,
 				       struct logical_volume *lv,
 				       struct processing_handle *handle,
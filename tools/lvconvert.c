@@ -90,6 +90,7 @@ struct convert_poll_id_list {
 	struct poll_operation_id *id;
 	unsigned is_merging_origin:1;
 	unsigned is_merging_origin_thin:1;
+	unsigned active_begin:1;	/* writecache LV was active before cleaning */
 };
 
 /* FIXME Temporary function until the enum replaces the separate variables */
@@ -355,6 +356,34 @@ static int _lvconvert_poll_by_id(struct cmd_context *cmd, struct poll_operation_
 			   &_lvconvert_mirror_fns, "Converted", id);
 }
 
+/*
+ * Poll all snapshot merges collected by a command together, so a
+ * foreground lvconvert finishes each merge as soon as it is complete
+ * and not only after all merges before it on the command line.
+ */
+static int _lvconvert_poll_merging_ids(struct cmd_context *cmd,
+				       struct dm_list *poll_idls,
+				       unsigned background)
+{
+	struct convert_poll_id_list *idl;
+	struct poll_operation_id **ids;
+	unsigned count = 0;
+
+	if (test_mode())
+		return ECMD_PROCESSED;
+
+	if (!(ids = dm_pool_alloc(cmd->mem, sizeof(*ids) * dm_list_size(poll_idls)))) {
+		log_error("Failed to allocate poll identifiers for lvconvert.");
+		return ECMD_FAILED;
+	}
+
+	dm_list_iterate_items(idl, poll_idls)
+		ids[count++] = idl->id;
+
+	return poll_daemon_lvs(cmd, background, (MERGING | SNAPSHOT),
+			       &_lvconvert_merge_fns, "Merged", ids, count);
+}
+
 int lvconvert_poll(struct cmd_context *cmd, struct logical_volume *lv,
 		   unsigned background)
 {
@@ -3775,7 +3804,6 @@ static struct convert_poll_id_list* _convert_poll_id_list_create(struct cmd_cont
 struct lvconvert_result {
 	unsigned need_polling:1;
 	unsigned wait_cleaner_writecache:1;
-	unsigned active_begin:1;
 	unsigned remove_cache:1;
 	struct dm_list poll_idls;
 };
@@ -4118,7 +4146,6 @@ int lvconvert_merge_snapshot_cmd(struct cmd_context *cmd, int argc, char **argv)
 {
 	struct processing_handle *handle;
 	struct lvconvert_result lr = { 0 };
-	struct convert_poll_id_list *idl;
 	int ret, poll_ret;
 
 	dm_list_init(&lr.poll_idls);
@@ -4134,12 +4161,10 @@ int lvconvert_merge_snapshot_cmd(struct cmd_context *cmd, int argc, char **argv)
 			      handle, NULL, &_lvconvert_merge_snapshot_single);
 
 	if (lr.need_polling) {
-		dm_list_iterate_items(idl, &lr.poll_idls) {
-			poll_ret = _lvconvert_poll_by_id(cmd, idl->id,
-						arg_is_set(cmd, background_ARG), 1, 0);
-			if (poll_ret > ret)
-				ret = poll_ret;
-		}
+		poll_ret = _lvconvert_poll_merging_ids(cmd, &lr.poll_idls,
+						       arg_is_set(cmd, background_ARG));
+		if (poll_ret > ret)
+			ret = poll_ret;
 	}
 
 	destroy_processing_handle(cmd, handle);
@@ -5094,11 +5119,13 @@ static int _lvconvert_split_cache_single(struct cmd_context *cmd,
 		return_ECMD_FAILED;
 
 	if (lv_is_writecache(lv_main)) {
+		struct lvconvert_result *lr = (struct lvconvert_result *) handle->custom_handle;
+		unsigned waiting = dm_list_size(&lr->poll_idls);
+
 		if (!_lvconvert_detach_writecache(cmd, handle, lv_main, lv_fast))
 			return_ECMD_FAILED;
 
 		if (cmd->command->command_enum == lvconvert_split_and_remove_cache_CMD) {
-			struct lvconvert_result *lr = (struct lvconvert_result *) handle->custom_handle;
 			/*
 			 * If detach is ongoing, then the remove needs to wait
 			 * until _lvconvert_detach_writecache_when_clean(),
@@ -5106,7 +5133,7 @@ static int _lvconvert_split_cache_single(struct cmd_context *cmd,
 			 * has been set, when_clean() knows it should remove
 			 * lv_fast at the end.
 			 */
-			if (!lr->wait_cleaner_writecache) {
+			if (dm_list_size(&lr->poll_idls) == waiting) {
 				if (lvremove_single(cmd, lv_fast, NULL) != ECMD_PROCESSED)
 					return_ECMD_FAILED;
 			}
@@ -5161,8 +5188,11 @@ int lvconvert_split_cache_cmd(struct cmd_context *cmd, int argc, char **argv)
 	}
 
 	handle->custom_handle = &lr;
+	dm_list_init(&lr.poll_idls);
 
-	ret = process_each_lv(cmd, 1, cmd->position_argv, NULL, NULL, READ_FOR_UPDATE,
+	cmd->get_vgname_from_options = 0;
+
+	ret = process_each_lv(cmd, cmd->position_argc, cmd->position_argv, NULL, NULL, READ_FOR_UPDATE,
 			       handle, NULL, &_lvconvert_split_cache_single);
 
 	destroy_processing_handle(cmd, handle);
@@ -5494,7 +5524,6 @@ int lvconvert_merge_cmd(struct cmd_context *cmd, int argc, char **argv)
 {
 	struct processing_handle *handle;
 	struct lvconvert_result lr = { 0 };
-	struct convert_poll_id_list *idl;
 	int ret, poll_ret;
 
 	dm_list_init(&lr.poll_idls);
@@ -5513,12 +5542,10 @@ int lvconvert_merge_cmd(struct cmd_context *cmd, int argc, char **argv)
 
 	/* polling is only used by merge_snapshot */
 	if (lr.need_polling) {
-		dm_list_iterate_items(idl, &lr.poll_idls) {
-			poll_ret = _lvconvert_poll_by_id(cmd, idl->id,
-						arg_is_set(cmd, background_ARG), 1, 0);
-			if (poll_ret > ret)
-				ret = poll_ret;
-		}
+		poll_ret = _lvconvert_poll_merging_ids(cmd, &lr.poll_idls,
+						       arg_is_set(cmd, background_ARG));
+		if (poll_ret > ret)
+			ret = poll_ret;
 	}
 
 	destroy_processing_handle(cmd, handle);
@@ -5631,8 +5658,6 @@ static int _lvconvert_detach_writecache(struct cmd_context *cmd,
 	int is_clean = 0;
 	int noflush = 0;
 
-	dm_list_init(&lr->poll_idls);
-
 	memset(&settings, 0, sizeof(settings));
 
 	if (!get_writecache_settings(cmd, &settings, &block_size_sectors)) {
@@ -5740,7 +5765,7 @@ static int _lvconvert_detach_writecache(struct cmd_context *cmd,
 		 * held since the writeback can take some time.
 		 */
 		lr->wait_cleaner_writecache = 1;
-		lr->active_begin = active_begin;
+		idl->active_begin = active_begin;
 
 		/* The command wants to remove the cache after detaching. */
 		if (cmd->command->command_enum == lvconvert_split_and_remove_cache_CMD)
@@ -5779,26 +5804,20 @@ static int _lvconvert_detach_writecache(struct cmd_context *cmd,
  * When the cache is clean, this does the detach (writecache is removed
  * in metadata and LV in kernel is updated.)
  */
-static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
-						   struct lvconvert_result *lr)
+static int _lvconvert_detach_writecache_if_clean(struct cmd_context *cmd,
+						 struct lvconvert_result *lr,
+						 struct convert_poll_id_list *idl,
+						 uint64_t *dirty, int *finished)
 {
-	struct convert_poll_id_list *idl;
-	struct poll_operation_id *id;
+	struct poll_operation_id *id = idl->id;
 	struct volume_group *vg;
 	struct logical_volume *lv;
 	struct logical_volume *lv_fast;
-	uint32_t lockd_state, error_flags;
-	uint64_t dirty;
+	uint32_t lockd_state = 0, error_flags = 0;
 	int is_lockd;
 	int ret = 0;
 
-	if (dm_list_empty(&lr->poll_idls)) {
-		log_error(INTERNAL_ERROR "Cannot detach writecache.");
-		return 0;
-	}
-
-	idl = dm_list_item(dm_list_first(&lr->poll_idls), struct convert_poll_id_list);
-	id = idl->id;
+	*finished = 1;
 	is_lockd = lvmcache_vg_is_lockd_type(cmd, id->vg_name, NULL);
 
 	/*
@@ -5810,10 +5829,6 @@ static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
 	 * than the LV going away here.
 	 */
 
- retry:
-	lockd_state = 0;
-	error_flags = 0;
-
 	if (is_lockd && !lockd_vg(cmd, id->vg_name, "ex", 0, &lockd_state)) {
 		log_error("Detaching writecache interrupted - locking VG failed.");
 		return 0;
@@ -5848,19 +5863,15 @@ static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
 		goto out_release;
 	}
 
-	if (!lv_writecache_is_clean(cmd, lv, &dirty)) {
-		unlock_and_release_vg(cmd, vg, vg->name);
-
-		if (is_lockd && !lockd_vg(cmd, id->vg_name, "un", 0, &lockd_state))
-			stack;
-
-		log_print_unless_silent("Detaching writecache cleaning %llu blocks", (unsigned long long)dirty);
-		log_print_unless_silent("This command can be cancelled and rerun to complete writecache detach.");
-		sleep(5);
-		goto retry;
+	if (!lv_writecache_is_clean(cmd, lv, dirty)) {
+		/* Check again after the next interval. */
+		*finished = 0;
+		ret = 1;
+		lv = NULL;
+		goto out_release;
 	}
 
-	if (!lr->active_begin) {
+	if (!idl->active_begin) {
 		/*
 		 * The LV was not active to begin so we should leave it inactive at the end.
 		 * It will remain inactive during detach since it's clean and doesn't need
@@ -5870,7 +5881,7 @@ static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
 			stack;
 	}
 
-	log_print_unless_silent("Detaching writecache completed cleaning.");
+	log_print_unless_silent("Detaching writecache completed cleaning %s.", display_lvname(lv));
 
 	lv_fast = first_seg(lv)->writecache;
 
@@ -5898,7 +5909,7 @@ static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
 	ret = 1;
 
 out_release:
-	if (ret)
+	if (ret && lv)
 		log_print_unless_silent("Logical volume %s write cache has been detached.", display_lvname(lv));
 
 	unlock_and_release_vg(cmd, vg, vg->name);
@@ -5910,6 +5921,59 @@ out_lockd:
 	return ret;
 }
 
+/*
+ * All writecaches set to cleaner by the command write back at once,
+ * so check all of them in each round and detach each one as soon
+ * as it is clean.
+ */
+static int _lvconvert_detach_writecache_when_clean(struct cmd_context *cmd,
+						   struct lvconvert_result *lr)
+{
+	struct convert_poll_id_list *idl, *idlt;
+	uint64_t dirty, total_dirty;
+	unsigned pending;
+	int finished;
+	int ret = 1;
+
+	if (dm_list_empty(&lr->poll_idls)) {
+		log_error(INTERNAL_ERROR "Cannot detach writecache.");
+		return 0;
+	}
+
+	while (1) {
+		total_dirty = 0;
+		pending = 0;
+
+		dm_list_iterate_items_safe(idl, idlt, &lr->poll_idls) {
+			dirty = 0;
+			if (!_lvconvert_detach_writecache_if_clean(cmd, lr, idl, &dirty, &finished))
+				ret = 0;
+
+			if (finished) {
+				dm_list_del(&idl->list);
+				continue;
+			}
+
+			total_dirty += dirty;
+			pending++;
+		}
+
+		if (!pending)
+			break;
+
+		if (pending == 1)
+			log_print_unless_silent("Detaching writecache cleaning %llu blocks",
+						(unsigned long long)total_dirty);
+		else
+			log_print_unless_silent("Detaching %u writecaches cleaning %llu blocks",
+						pending, (unsigned long long)total_dirty);
+		log_print_unless_silent("This command can be cancelled and rerun to complete writecache detach.");
+		sleep(5);
+	}
+
+	return ret;
+}
+
 static int _writecache_zero(struct cmd_context *cmd, struct logical_volume *lv)
 {
 	struct wipe_params wp = {
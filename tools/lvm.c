@@ -213,6 +213,13 @@ static void _discard_log_report_content(struct cmd_context *cmd)
 		dm_report_destroy_rows(cmd->cmd_report.log_rh);
 }
 
+/*
+ * Commands run here share one cmd_context: config, filters and daemon
+ * connections stay initialized between commands (lvm_run_command only
+ * refreshes them when config files change or --config is used), while
+ * lvmcache, label scan state, hints and the devices file are dropped
+ * after every command so each one sees current devices.
+ */
 int lvm_shell(struct cmd_context *cmd, struct cmdline_context *cmdline)
 {
 	log_report_t saved_log_report_state = log_get_report_state();
@@ -227,6 +234,8 @@ int lvm_shell(struct cmd_context *cmd, struct cmdline_context *cmdline)
 	_cmdline = cmdline;
 
 	cmd->is_interactive = 1;
+	cmd->is_long_lived = 1;
+	init_pool_chunk_cache(cmd);
 
 	if (!report_format_init(cmd))
 		return_ECMD_FAILED;
@@ -235,6 +244,10 @@ int lvm_shell(struct cmd_context *cmd, struct cmdline_context *cmdline)
 	log_set_report_context(LOG_REPORT_CONTEXT_SHELL);
 	log_set_report_object_type(LOG_REPORT_OBJECT_TYPE_PRE_CMD);
 
+	/* Commands fed from a pipe or file notify once when all are done. */
+	if (!isatty(STDIN_FILENO))
+		lvmnotify_batch(cmd);
+
 	while (1) {
 		/*
 		 * Note: If we need to output the log report before we get to the dm_report_group_output_and_pop_all
@@ -350,6 +363,8 @@ report_log:
 		}
 	}
 
+	lvmnotify_flush(cmd);
+
 	log_restore_report_state(saved_log_report_state);
 	cmd->is_interactive = 0;
 
@@ -83,6 +83,48 @@ void lvm2_log_level(void *handle, int level);
  */
 int lvm2_run(void *handle, const char *cmdline);
 
+/*
+ * Report field value types, see struct lvm2_report_field.
+ */
+#define LVM2_REPORT_FIELD_STRING	0x00000010
+#define LVM2_REPORT_FIELD_NUMBER	0x00000020
+#define LVM2_REPORT_FIELD_SIZE		0x00000040
+#define LVM2_REPORT_FIELD_PERCENT	0x00000080
+#define LVM2_REPORT_FIELD_STRING_LIST	0x00000100
+#define LVM2_REPORT_FIELD_TIME		0x00000200
+
+/*
+ * One field of a report row.
+ * id is the field name as used with -o, e.g. lv_name.
+ * value is the field as the command would display it.
+ * number is set for NUMBER fields, SIZE fields (in 512-byte sectors),
+ * PERCENT fields (in millionths of a percent) and TIME fields
+ * (in seconds since the Epoch), and is 0 for other fields.
+ */
+struct lvm2_report_field {
+	const char *id;
+	const char *value;
+	unsigned type;			/* LVM2_REPORT_FIELD_* */
+	unsigned long long number;
+};
+
+/*
+ * Called for each row of the report, with its fields in column order.
+ * The fields and their strings are only valid until the function
+ * returns.  Return 0 to stop receiving further rows.
+ */
+typedef int (*lvm2_report_row_fn_t) (void *private,
+				     const struct lvm2_report_field *fields,
+				     unsigned count);
+
+/*
+ * Run an LVM2 report command (e.g. "lvs -o lv_name,lv_size vg")
+ * like lvm2_run, but pass each report row to row_fn instead of
+ * formatting it for output.  Use the basic report format.
+ */
+int lvm2_run_report(void *handle, const char *cmdline,
+		    lvm2_report_row_fn_t row_fn, void *private);
+
 /* Release handle */
 void lvm2_exit(void *handle);
 
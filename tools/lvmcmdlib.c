@@ -33,6 +33,10 @@ void *cmdlib_lvm2_init(unsigned static_compile, unsigned threaded)
 	if (!(cmd = init_lvm(1, 1, threaded)))
 		return NULL;
 
+	/* The handle is kept for running multiple commands. */
+	cmd->is_long_lived = 1;
+	init_pool_chunk_cache(cmd);
+
 	if (!lvm_register_commands(cmd, NULL)) {
 		free(cmd);
 		return NULL;
@@ -59,6 +63,9 @@ int lvm2_run(void *handle, const char *cmdline)
 
 	cmd = (struct cmd_context *) handle;
 
+	if (oneoff)
+		cmd->is_long_lived = 0;
+
 	cmd->argv = argv;
 
 	if (!(cmdcopy = strdup(cmdline))) {
@@ -103,6 +110,72 @@ int lvm2_run(void *handle, const char *cmdline)
 	return ret;
 }
 
+struct report_row_baton {
+	lvm2_report_row_fn_t row_fn;
+	void *private;
+	struct lvm2_report_field *fields;
+	unsigned size;
+};
+
+static int _report_row(void *private, const struct dm_report_field_value *values,
+		       unsigned count)
+{
+	struct report_row_baton *rrb = private;
+	struct lvm2_report_field *fields;
+	unsigned i;
+
+	/* All rows of a report have the same fields, so this rarely grows. */
+	if (count > rrb->size) {
+		if (!(fields = realloc(rrb->fields, count * sizeof(*fields)))) {
+			log_error("Failed to allocate report row fields.");
+			return 0;
+		}
+		rrb->fields = fields;
+		rrb->size = count;
+	}
+
+	for (i = 0; i < count; i++) {
+		rrb->fields[i].id = values[i].id;
+		rrb->fields[i].value = values[i].value;
+		rrb->fields[i].type = values[i].type;
+		rrb->fields[i].number = values[i].number;
+	}
+
+	return rrb->row_fn(rrb->private, rrb->fields, count);
+}
+
+int lvm2_run_report(void *handle, const char *cmdline,
+		    lvm2_report_row_fn_t row_fn, void *private)
+{
+	struct report_row_baton rrb = { .row_fn = row_fn, .private = private };
+	struct cmd_context *cmd;
+	int ret, oneoff = 0;
+
+	if (!handle) {
+		oneoff = 1;
+		if (!(handle = lvm2_init())) {
+			log_error("Handle initialisation failed.");
+			return ECMD_FAILED;
+		}
+		((struct cmd_context *) handle)->is_long_lived = 0;
+	}
+
+	cmd = (struct cmd_context *) handle;
+	cmd->cmd_report.row_fn = _report_row;
+	cmd->cmd_report.row_fn_private = &rrb;
+
+	ret = lvm2_run(handle, cmdline);
+
+	cmd->cmd_report.row_fn = NULL;
+	cmd->cmd_report.row_fn_private = NULL;
+	free(rrb.fields);
+
+	if (oneoff)
+		lvm2_exit(handle);
+
+	return ret;
+}
+
 void lvm2_disable_dmeventd_monitoring(void *handle)
 {
 	init_run_by_dmeventd((struct cmd_context *) handle);
@@ -26,6 +26,7 @@
 /* coverity[unnecessary_header] */
 #include "stub.h"
 #include "lib/misc/last-path-component.h"
+#include "lib/misc/lvm-timing.h"
 
 #include <sys/stat.h>
 #include <time.h>
@@ -1630,6 +1631,8 @@ static struct command *_find_command(struct cmd_context *cmd, const char *path,
 	int best_unused_options[MAX_UNUSED_COUNT] = { 0 };
 	int best_unused_count = 0;
 	int opts_match_count, opts_unmatch_count;
+	int set_opts[ARG_COUNT];
+	int set_opts_count = 0;
 	int ro, rp;
 	int i, j;
 	int opt_enum, opt_i;
@@ -1647,6 +1650,25 @@ static struct command *_find_command(struct cmd_context *cmd, const char *path,
 	if (arg_is_set(cmd, type_ARG))
 		type_arg = arg_str_value(cmd, type_ARG, "");
 
+	/*
+	 * Collect the options that cmd has set, as standard option names,
+	 * once; each cmd def is then checked against this short list
+	 * instead of testing all ARG_COUNT options for every cmd def.
+	 */
+	for (opt_i = 0; opt_i < ARG_COUNT; opt_i++) {
+		if (!arg_is_set(cmd, opt_i))
+			continue;
+
+		if (!(opt_enum = _opt_synonym_to_standard(cmd->name, opt_i)))
+			opt_enum = opt_i;
+
+		/* extents are not used in command definitions */
+		if (opt_enum == extents_ARG)
+			continue;
+
+		set_opts[set_opts_count++] = opt_enum;
+	}
+
 	for (i = 0; i < COMMAND_COUNT; i++) {
 		if (lvm_command_enum != commands[i].lvm_command_enum)
 			continue;
@@ -1774,17 +1796,8 @@ static struct command *_find_command(struct cmd_context *cmd, const char *path,
 		/* Count how many options cmd has set that are not accepted by commands[i]. */
 		/* FIXME: also count unused positional args? */
 
-		for (opt_i = 0; opt_i < ARG_COUNT; opt_i++) {
-			if (!arg_is_set(cmd, opt_i))
-				continue;
-
-			if (!(opt_enum = _opt_synonym_to_standard(cmd->name, opt_i)))
-				opt_enum = opt_i;
-
-			/* extents are not used in command definitions */
-			if (opt_enum == extents_ARG)
-				continue;
-
+		for (opt_i = 0; opt_i < set_opts_count; opt_i++) {
+			opt_enum = set_opts[opt_i];
 			accepted = 0;
 
 			/* NB in some cases required_opt_args are optional */
@@ -3048,6 +3061,8 @@ int lvm_run_command(struct cmd_context *cmd, int argc, char **argv)
 	/* each command should start out with sigint flag cleared */
 	sigint_clear();
 
+	timing_reset();
+
 	if (!(cmd->name = dm_pool_strdup(cmd->mem, dm_basename(argv[0])))) {
 		log_error("Failed to strdup command basename.");
 		return ECMD_FAILED;
@@ -3194,6 +3209,9 @@ int lvm_run_command(struct cmd_context *cmd, int argc, char **argv)
 		goto_out;
 	init_dmeventd_monitor(monitoring);
 
+	/* Reuse discovered dm devices across the trees of this command. */
+	dm_tree_node_cache_use(1);
+
 	log_debug("Processing command: %s", cmd->cmd_line);
 	log_debug("Command pid: %d", getpid());
 	log_debug("System ID: %s", cmd->system_id ? : "");
@@ -3275,11 +3293,12 @@ int lvm_run_command(struct cmd_context *cmd, int argc, char **argv)
 	lvmlockd_disconnect();
 	fin_locking(cmd);
 
-	if (!_cmd_no_meta_proc(cmd) && find_config_tree_bool(cmd, global_notify_dbus_CFG, NULL))
+	if (!_cmd_no_meta_proc(cmd))
 		lvmnotify_send(cmd);
 
       out:
 
+	dm_tree_node_cache_use(0);
 	dev_mpath_exit();
 	hints_exit(cmd);
 	lvmcache_destroy(cmd, 1, 1);
@@ -3307,6 +3326,8 @@ int lvm_run_command(struct cmd_context *cmd, int argc, char **argv)
 
 	log_debug("Completed: %s", cmd->cmd_line);
 
+	timing_report(cmd->name, lvm_return_code(ret));
+
 	/*
 	 * Reset all settings back to the persistent defaults that
 	 * ignore everything supplied on the command line of the
@@ -3485,6 +3506,8 @@ static int _run_script(struct cmd_context *cmd, int argc, char **argv)
 	if ((script = fopen(script_file, "r")) == NULL)
 		return ENO_SUCH_CMD;
 
+	lvmnotify_batch(cmd);
+
 	while (fgets(buffer, sizeof(buffer), script) != NULL) {
 		if (!magic_number) {
 			if (buffer[0] == '#' && buffer[1] == '!')
@@ -3532,6 +3555,8 @@ static int _run_script(struct cmd_context *cmd, int argc, char **argv)
 	if (fclose(script))
 		log_sys_error("fclose", script_file);
 
+	lvmnotify_flush(cmd);
+
 	return ret;
 }
 
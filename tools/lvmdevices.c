@@ -558,6 +558,57 @@ restart4:
 	free_dus(&done_old);
 }
 
+static int _add_dev(struct cmd_context *cmd, const char *devname, const char *deviceidtype)
+{
+	struct device *dev;
+
+	/*
+	 * addev will add a device to devices_file even if that device
+	 * is excluded by filters.
+	 */
+
+	/*
+	 * No filter applied here (only the non-data filters would
+	 * be applied since we haven't read the device yet.
+	 */
+	if (!(dev = dev_cache_get(cmd, devname, NULL))) {
+		log_error("No device found for %s.", devname);
+		return 0;
+	}
+
+	/*
+	 * reads pvid from dev header, sets dev->pvid.
+	 * (it's ok if the device is not a PV and has no PVID)
+	 */
+	if (!label_read_pvid(dev, NULL)) {
+		log_error("Failed to read %s.", devname);
+		return 0;
+	}
+
+	/*
+	 * Allow filtered devices to be added to devices_file, but
+	 * check if it's excluded by filters to print a warning.
+	 * Since label_read_pvid has read the first 4K of the device,
+	 * the filters should not for the most part need to do any further
+	 * reading of the device.
+	 *
+	 * (This is the first time filters are being run, so we do
+	 * not need to wipe filters of any previous result that was
+	 * based on filter_deviceid_skip=0.)
+	 */
+	cmd->filter_deviceid_skip = 1;
+
+	if (!cmd->filter->passes_filter(cmd, cmd->filter, dev, NULL)) {
+		log_warn("WARNING: adding device %s that is excluded: %s.",
+			 dev_name(dev), dev_filtered_reason(dev));
+	}
+
+	if (!device_id_add(cmd, dev, dev->pvid, deviceidtype, NULL, 1))
+		return_0;
+
+	return 1;
+}
+
 int lvmdevices(struct cmd_context *cmd, int argc, char **argv)
 {
 	struct dm_list search_pvids;
@@ -783,58 +834,30 @@ int lvmdevices(struct cmd_context *cmd, int argc, char **argv)
 	}
 
 	if (arg_is_set(cmd, adddev_ARG)) {
+		struct arg_value_group_list *group;
 		const char *devname;
 
-		if (!(devname = arg_str_value(cmd, adddev_ARG, NULL)))
-			goto_bad;
-
-		/*
-		 * addev will add a device to devices_file even if that device
-		 * is excluded by filters.
-		 */
-
-		/*
-		 * No filter applied here (only the non-data filters would
-		 * be applied since we haven't read the device yet.
-		 */
-		if (!(dev = dev_cache_get(cmd, devname, NULL))) {
-			log_error("No device found for %s.", devname);
-			goto bad;
-		}
+		/* also allow deviceid_ARG ? */
+		deviceidtype = arg_str_value(cmd, deviceidtype_ARG, NULL);
 
-		/*
-		 * reads pvid from dev header, sets dev->pvid.
-		 * (it's ok if the device is not a PV and has no PVID)
-		 */
 		label_scan_setup_bcache();
-		if (!label_read_pvid(dev, NULL)) {
-			log_error("Failed to read %s.", devname);
-			goto bad;
-		}
 
 		/*
-		 * Allow filtered devices to be added to devices_file, but
-		 * check if it's excluded by filters to print a warning.
-		 * Since label_read_pvid has read the first 4K of the device,
-		 * the filters should not for the most part need to do any further
-		 * reading of the device.
-		 *
-		 * (This is the first time filters are being run, so we do
-		 * not need to wipe filters of any previous result that was
-		 * based on filter_deviceid_skip=0.)
+		 * --adddev can be repeated to add many devices with one
+		 * lock, one write and one backup of the devices file.
+		 * Nothing is written if any of the devices cannot be added.
 		 */
-		cmd->filter_deviceid_skip = 1;
+		dm_list_iterate_items(group, &cmd->arg_value_groups) {
+			if (!grouped_arg_is_set(group->arg_values, adddev_ARG))
+				continue;
 
-		if (!cmd->filter->passes_filter(cmd, cmd->filter, dev, NULL)) {
-			log_warn("WARNING: adding device %s that is excluded: %s.",
-				 dev_name(dev), dev_filtered_reason(dev));
-		}
+			if (!(devname = grouped_arg_str_value(group->arg_values, adddev_ARG, NULL)))
+				goto_bad;
 
-		/* also allow deviceid_ARG ? */
-		deviceidtype = arg_str_value(cmd, deviceidtype_ARG, NULL);
+			if (!_add_dev(cmd, devname, deviceidtype))
+				goto_bad;
+		}
 
-		if (!device_id_add(cmd, dev, dev->pvid, deviceidtype, NULL, 1))
-			goto_bad;
 		if (!device_ids_write(cmd))
 			goto_bad;
 		goto out;
@@ -148,17 +148,177 @@ static int _sleep_and_rescan_devices(struct cmd_context *cmd, struct daemon_parm
 	return 1;
 }
 
-int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
-		       struct daemon_parms *parms)
+/*
+ * The polled LV from the last full check, kept unlocked between intervals.
+ * While the seqno of its VG stays the same, progress is read from the kernel
+ * through it without reading the VG again.
+ */
+struct poll_lv_cache {
+	struct volume_group *vg;
+	struct logical_volume *lv;
+	char vgid[ID_LEN + 1];
+	uint32_t seqno;
+};
+
+static void _poll_lv_cache_drop(struct poll_lv_cache *cache)
+{
+	if (cache->vg) {
+		release_vg(cache->vg);
+		cache->vg = NULL;
+		cache->lv = NULL;
+	}
+}
+
+/*
+ * Returns 1 when the cached LV showed the copy is still in progress,
+ * so there is nothing more to do in this interval.  Anything else,
+ * including a failure, is left to a full check under the VG lock.
+ */
+static int _poll_cached_lv(struct cmd_context *cmd, struct poll_operation_id *id,
+			   struct daemon_parms *parms, struct poll_lv_cache *cache,
+			   int *progress_shown)
+{
+	progress_t progress;
+
+	*progress_shown = 0;
+
+	if (!cache->vg)
+		return 0;
+
+	if (parms->aborting || (lvmcache_seqno_from_vgid(cache->vgid) != cache->seqno) ||
+	    !lv_is_active(cache->lv)) {
+		log_debug("Rereading VG %s for %s.", id->vg_name, id->display_name);
+		_poll_lv_cache_drop(cache);
+		return 0;
+	}
+
+	progress = parms->poll_fns->poll_progress(cmd, cache->lv, id->display_name, parms);
+	fflush(stdout);
+
+	if (progress == PROGRESS_UNFINISHED)
+		return 1;
+
+	*progress_shown = (progress != PROGRESS_CHECK_FAILED);
+	_poll_lv_cache_drop(cache);
+
+	return 0;
+}
+
+/*
+ * Check the progress of one polled LV once, finishing it when complete.
+ * Sets finished when there is nothing more to poll for the LV.
+ */
+static int _poll_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
+			   struct daemon_parms *parms, struct poll_lv_cache *cache,
+			   int *finished)
 {
 	struct volume_group *vg = NULL;
 	struct logical_volume *lv;
-	int finished = 0;
 	uint32_t lockd_state = 0;
 	uint32_t error_flags = 0;
+	unsigned progress_display = parms->progress_display;
+	int progress_shown;
 	int is_lockd;
 	int ret;
+
+	*finished = 1;
+
+	if (_poll_cached_lv(cmd, id, parms, cache, &progress_shown)) {
+		*finished = 0;
+		return 1;
+	}
+
+	is_lockd = lvmcache_vg_is_lockd_type(cmd, id->vg_name, NULL);
+
+	/*
+	 * An ex VG lock is needed because the check can call finish_copy
+	 * which writes the VG.
+	 */
+	if (is_lockd && !lockd_vg(cmd, id->vg_name, "ex", 0, &lockd_state)) {
+		log_error("ABORTING: Can't lock VG for %s.", id->display_name);
+		return 0;
+	}
+
+	/* Locks the (possibly renamed) VG again */
+	vg = vg_read(cmd, id->vg_name, NULL, READ_FOR_UPDATE, lockd_state, &error_flags, NULL);
+	if (!vg) {
+		/* What more could we do here? */
+		if (error_flags & FAILED_NOTFOUND) {
+			log_print_unless_silent("Can't find VG %s. No longer active.", id->display_name);
+			ret = 1;
+		} else {
+			log_error("ABORTING: Can't reread VG for %s error flags %x.", id->display_name, error_flags);
+			ret = 0;
+		}
+		goto out;
+	}
+
+	lv = find_lv(vg, id->lv_name);
+
+	if (lv && id->uuid && strcmp(id->uuid, (char *)&lv->lvid))
+		lv = NULL;
+	if (lv && parms->lv_type && !(lv->status & parms->lv_type))
+		lv = NULL;
+
+	if (!lv) {
+		if (parms->lv_type == PVMOVE)
+			log_print_unless_silent("%s: No pvmove in progress - already finished or aborted.",
+						id->display_name);
+		else
+			log_print_unless_silent("Can't find LV in %s for %s.",
+						vg->name, id->display_name);
+		ret = 1;
+		goto out;
+	}
+
+	/*
+	 * If the LV is not active locally, the kernel cannot be
+	 * queried for its status.  We must exit in this case.
+	 */
+	if (!lv_is_active(lv)) {
+		log_print_unless_silent("%s: Interrupted: No longer active.", id->display_name);
+		ret = 1;
+		goto out;
+	}
+
+	/* Do not display the progress just seen from the cached LV again. */
+	if (progress_shown)
+		parms->progress_display = 0;
+
+	ret = _check_lv_status(cmd, vg, lv, id->display_name, parms, finished);
+
+	parms->progress_display = progress_display;
+
+	if (!ret)
+		goto_out;
+
+	if (!*finished && !parms->aborting) {
+		memcpy(cache->vgid, &vg->id, ID_LEN);
+		cache->vgid[ID_LEN] = '\0';
+		cache->seqno = vg->seqno;
+		cache->lv = lv;
+	}
+out:
+	if (vg) {
+		unlock_vg(cmd, vg, vg->name);
+		if (cache->lv)
+			cache->vg = vg;
+		else
+			release_vg(vg);
+	}
+	if (is_lockd && !lockd_vg(cmd, id->vg_name, "un", 0, &lockd_state))
+		stack;
+
+	return ret;
+}
+
+int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
+		       struct daemon_parms *parms)
+{
+	struct poll_lv_cache cache = { 0 };
 	unsigned wait_before_testing = parms->wait_before_testing;
+	int finished = 0;
+	int r = 0;
 
 	if (!wait_before_testing)
 		if (!lvmcache_label_scan(cmd))
@@ -169,84 +329,81 @@ int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
 		if (wait_before_testing &&
 		    !_sleep_and_rescan_devices(cmd, parms)) {
 			log_error("ABORTING: Polling interrupted for %s.", id->display_name);
-			return 0;
+			goto out;
 		}
 
-		is_lockd = lvmcache_vg_is_lockd_type(cmd, id->vg_name, NULL);
+		if (!_poll_single_lv(cmd, id, parms, &cache, &finished))
+			goto_out;
 
-		/*
-		 * An ex VG lock is needed because the check can call finish_copy
-		 * which writes the VG.
-		 */
-		if (is_lockd && !lockd_vg(cmd, id->vg_name, "ex", 0, &lockd_state)) {
-			log_error("ABORTING: Can't lock VG for %s.", id->display_name);
-			return 0;
-		}
+		wait_before_testing = 1;
+	}
 
-		/* Locks the (possibly renamed) VG again */
-		vg = vg_read(cmd, id->vg_name, NULL, READ_FOR_UPDATE, lockd_state, &error_flags, NULL);
-		if (!vg) {
-			/* What more could we do here? */
-			if (error_flags & FAILED_NOTFOUND) {
-				log_print_unless_silent("Can't find VG %s. No longer active.", id->display_name);
-				ret = 1;
-			} else {
-				log_error("ABORTING: Can't reread VG for %s error flags %x.", id->display_name, error_flags);
-				ret = 0;
-			}
-			goto out;
-		}
+	r = 1;
+out:
+	_poll_lv_cache_drop(&cache);
 
-		lv = find_lv(vg, id->lv_name);
+	return r;
+}
 
-		if (lv && id->uuid && strcmp(id->uuid, (char *)&lv->lvid))
-			lv = NULL;
-		if (lv && parms->lv_type && !(lv->status & parms->lv_type))
-			lv = NULL;
+/*
+ * Poll several LVs together, checking each of them once per interval
+ * so that one slow LV does not hold back finishing the others.
+ * Entries in ids are cleared as their LVs finish.
+ */
+int wait_for_lvs(struct cmd_context *cmd, struct poll_operation_id **ids,
+		 unsigned count, struct daemon_parms *parms)
+{
+	struct poll_lv_cache *caches;
+	unsigned wait_before_testing = parms->wait_before_testing;
+	unsigned i, done = 0;
+	int finished;
+	int r = 1;
 
-		if (!lv) {
-			if (parms->lv_type == PVMOVE)
-				log_print_unless_silent("%s: No pvmove in progress - already finished or aborted.",
-							id->display_name);
-			else
-				log_print_unless_silent("Can't find LV in %s for %s.",
-							vg->name, id->display_name);
-			ret = 1;
-			goto out;
-		}
+	if (!(caches = dm_pool_zalloc(cmd->mem, count * sizeof(*caches)))) {
+		log_error("Failed to allocate poll state for %u LVs.", count);
+		return 0;
+	}
 
-		/*
-		 * If the LV is not active locally, the kernel cannot be
-		 * queried for its status.  We must exit in this case.
-		 */
-		if (!lv_is_active(lv)) {
-			log_print_unless_silent("%s: Interrupted: No longer active.", id->display_name);
-			ret = 1;
-			goto out;
-		}
+	if (!wait_before_testing)
+		if (!lvmcache_label_scan(cmd))
+			stack;
 
-		if (!_check_lv_status(cmd, vg, lv, id->display_name, parms, &finished)) {
-			ret = 0;
-			goto_out;
+	while (done < count) {
+		if (wait_before_testing &&
+		    !_sleep_and_rescan_devices(cmd, parms)) {
+			log_error("ABORTING: Polling interrupted for %u of %u LVs.",
+				  count - done, count);
+			r = 0;
+			break;
 		}
 
-		unlock_and_release_vg(cmd, vg, vg->name);
+		for (i = 0; i < count; i++) {
+			if (!ids[i])
+				continue;
 
-		if (is_lockd && !lockd_vg(cmd, id->vg_name, "un", 0, &lockd_state))
-			stack;
+			if (!_poll_single_lv(cmd, ids[i], parms, &caches[i], &finished)) {
+				stack;
+				r = 0;
+				finished = 1;
+			}
+
+			if (finished) {
+				ids[i] = NULL;
+				done++;
+			}
+		}
+
+		if (parms->progress_display && done < count)
+			log_print_unless_silent("%s %u of %u LVs.",
+						parms->progress_title, done, count);
 
 		wait_before_testing = 1;
 	}
 
-	return 1;
-
-out:
-	if (vg)
-		unlock_and_release_vg(cmd, vg, vg->name);
-	if (is_lockd && !lockd_vg(cmd, id->vg_name, "un", 0, &lockd_state))
-		stack;
+	for (i = 0; i < count; i++)
+		_poll_lv_cache_drop(&caches[i]);
 
-	return ret;
+	return r;
 }
 
 struct poll_id_list {
@@ -643,6 +800,7 @@ static int _poll_daemon(struct cmd_context *cmd, struct poll_operation_id *id,
 		 * caller's task (that the parent already performed)
 		 */
 		/* FIXME Attempt proper cleanup */
+		(void) fflush(NULL);
 		_exit(lvm_return_code(ret));
 	}
 
@@ -705,3 +863,42 @@ int poll_daemon(struct cmd_context *cmd, unsigned background,
 	parms.lv_type &= PVMOVE;
 	return _poll_daemon(cmd, id, &parms);
 }
+
+int poll_daemon_lvs(struct cmd_context *cmd, unsigned background,
+		    uint64_t lv_type, const struct poll_functions *poll_fns,
+		    const char *progress_title, struct poll_operation_id **ids,
+		    unsigned count)
+{
+	struct daemon_parms parms;
+	unsigned i;
+	int ret = ECMD_PROCESSED, poll_ret;
+
+	/*
+	 * Background polling already runs concurrently, either in lvmpolld
+	 * or in one forked daemon per LV.
+	 */
+	if (background || lvmpolld_use() || count < 2) {
+		for (i = 0; i < count; i++) {
+			poll_ret = poll_daemon(cmd, background, lv_type, poll_fns,
+					       progress_title, ids[i]);
+			if (poll_ret > ret)
+				ret = poll_ret;
+		}
+		return ret;
+	}
+
+	if (!_daemon_parms_init(cmd, &parms, background, poll_fns, progress_title, lv_type))
+		return_EINVALID_CMD_LINE;
+
+	/* classical polling allows only PMVOVE or 0 values */
+	parms.lv_type &= PVMOVE;
+
+	/* clear lvmcache/bcache/fds from the parent */
+	lvmcache_destroy(cmd, 1, 0);
+	label_scan_destroy(cmd);
+
+	if (!wait_for_lvs(cmd, ids, count, &parms))
+		return_ECMD_FAILED;
+
+	return ECMD_PROCESSED;
+}
@@ -130,6 +130,11 @@ static char *_chars_to_hexstr(const void *in, void *out, int num, int max, const
 	return out;
 }
 
+static int _vgname_char(char c)
+{
+	return isalnum(c) || c == '.' || c == '_' || c == '-' || c == '+';
+}
+
 static int _check_vgname_start(char *buf, int *len)
 {
 	int chars = 0;
@@ -143,7 +148,7 @@ static int _check_vgname_start(char *buf, int *len)
 	for (i = 0; i <= NAME_LEN + 2; i++) {
 		c = buf[i];
 
-		if (isalnum(c) || c == '.' || c == '_' || c == '-' || c == '+') {
+		if (_vgname_char(c)) {
 			if (space)
 				return 0;
 			chars++;
@@ -175,11 +180,10 @@ static int _check_vgname_start(char *buf, int *len)
 static void _copy_out_metadata(char *buf, uint32_t start, uint32_t first_start, uint64_t mda_size, char **meta_buf, uint64_t *meta_size, int *bad_end)
 {
 	char *new_buf;
-	uint64_t i;
+	char *end;
 	uint64_t new_len;
 	uint64_t len_a = 0, len_b = 0;
 	uint32_t stop;
-	int found_end;
 
 	/*
 	 * If we wrap around the buffer searching for the
@@ -192,31 +196,15 @@ static void _copy_out_metadata(char *buf, uint32_t start, uint32_t first_start,
 	else
 		stop = first_start;
 
-	found_end = 0;
-	for (i = start; i < mda_size; i++) {
-		if (buf[i] == '\0') {
-			found_end = 1;
-			break;
-		}
-	}
-
-	if (found_end) {
-		new_len = i - start;
+	if ((end = memchr(buf + start, '\0', mda_size - start))) {
+		new_len = end - (buf + start);
 	} else {
-		len_a = i - start;
-
-		found_end = 0;
-		for (i = 512; i < stop; i++) {
-			if (buf[i] == '\0') {
-				found_end = 1;
-				break;
-			}
-		}
+		len_a = mda_size - start;
 
-		if (!found_end)
+		if ((stop <= 512) || !(end = memchr(buf + 512, '\0', stop - 512)))
 			return;
 
-		len_b = i - 512;
+		len_b = end - (buf + 512);
 		new_len = len_a + len_b;
 	}
 
@@ -386,11 +374,16 @@ static bool _read_bytes(struct device *dev, struct devicefile *def, uint64_t sta
 	if (off != (off_t)start)
 		return false;
 
-	rv = read(def->fd, data, len);
-	if (rv < 0)
-		return false;
-	if ((size_t)rv != len)
-		return false;
+	/* A single read returns at most about 2GiB */
+	while (len) {
+		rv = read(def->fd, data, len);
+		if (rv < 0 && errno == EINTR)
+			continue;
+		if (rv <= 0)
+			return false;
+		data = (char *)data + rv;
+		len -= rv;
+	}
 	return true;
 }
 
@@ -494,6 +487,16 @@ static int _dump_all_text(struct cmd_context *cmd, struct settings *set, const c
 		if (set->metadata_offset_set)
 			one_found = 1;
 
+		/*
+		 * Most offsets are in the middle of some older copy, skip
+		 * them without copying out the line when no vgname can
+		 * start here.
+		 */
+		if (!_vgname_char(*p)) {
+			count++;
+			continue;
+		}
+
 		/*
 		 * copy line of possible metadata to check for vgname
 		 */
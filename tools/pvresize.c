@@ -21,6 +21,11 @@ struct pvresize_params {
 
 	unsigned done;
 	unsigned total;
+
+	/* PVs of a VG are committed together after the last one. */
+	const char *vg_name;
+	unsigned vg_done;
+	int vg_failed;
 };
 
 static int _pvresize_single(struct cmd_context *cmd,
@@ -36,6 +41,23 @@ static int _pvresize_single(struct cmd_context *cmd,
 	}
 	params->total++;
 
+	if (!params->vg_name || strcmp(params->vg_name, vg->name)) {
+		if (!(params->vg_name = dm_pool_strdup(cmd->mem, vg->name)))
+			return_ECMD_FAILED;
+		params->vg_done = 0;
+		params->vg_failed = 0;
+	}
+
+	/*
+	 * The VG is not committed after a failure, which may have left
+	 * the failed PV half updated in the VG.
+	 */
+	if (params->vg_failed) {
+		log_error("Physical volume %s not resized, volume group %s is not updated.",
+			  pv_dev_name(pv), vg->name);
+		return ECMD_FAILED;
+	}
+
 	/*
 	 * Needed to change a property on an orphan PV.
 	 * i.e. the global lock is only needed for orphans.
@@ -46,10 +68,20 @@ static int _pvresize_single(struct cmd_context *cmd,
 			return_ECMD_FAILED;
 	}
 
-	if (!pv_resize_single(cmd, vg, pv, params->new_size, arg_is_set(cmd, yes_ARG)))
+	if (!pv_resize_single(cmd, vg, pv, params->new_size, arg_is_set(cmd, yes_ARG))) {
+		if (!is_orphan(pv)) {
+			if (params->vg_done)
+				log_error("Not updating %u other physical volume(s) in volume group %s.",
+					  params->vg_done, vg->name);
+			params->done -= params->vg_done;
+			params->vg_failed = 1;
+		}
 		return_ECMD_FAILED;
+	}
 
 	params->done++;
+	if (!is_orphan(pv))
+		params->vg_done++;
 
 	return ECMD_PROCESSED;
 }
@@ -77,6 +109,9 @@ int pvresize(struct cmd_context *cmd, int argc, char **argv)
 
 	params.done = 0;
 	params.total = 0;
+	params.vg_name = NULL;
+	params.vg_done = 0;
+	params.vg_failed = 0;
 
 	set_pv_notify(cmd);
 
@@ -338,10 +338,30 @@ static int _lookup_file_contains_pvid(FILE *fp, char *pvid)
 	return 0;
 }
 
+/*
+ * After this many PVs of a VG have been checked with a stat of their
+ * online file, read the pvs_online directory once and check the rest
+ * against the names found there.
+ */
+#define PVID_FILES_STAT_MAX 16
+
+static int _pvid_online(const char *pvid, int *checked, struct dm_hash_table **online_pvids)
+{
+	if (!*online_pvids && (++*checked > PVID_FILES_STAT_MAX))
+		*online_pvids = online_pvids_hash();
+
+	if (*online_pvids)
+		return dm_hash_lookup(*online_pvids, pvid) ? 1 : 0;
+
+	return online_pvid_file_exists(pvid);
+}
+
 static void _lookup_file_count_pvid_files(FILE *fp, const char *vgname, int *pvs_online, int *pvs_offline)
 {
 	char line[64];
 	char pvid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
+	struct dm_hash_table *online_pvids = NULL;
+	int checked = 0;
 
 	log_debug("checking all pvid files using lookup file for %s", vgname);
 
@@ -355,11 +375,14 @@ static void _lookup_file_count_pvid_files(FILE *fp, const char *vgname, int *pvs
 			continue;
 		}
 
-		if (online_pvid_file_exists((const char *)pvid))
+		if (_pvid_online((const char *)pvid, &checked, &online_pvids))
 			(*pvs_online)++;
 		else
 			(*pvs_offline)++;
 	}
+
+	if (online_pvids)
+		dm_hash_destroy(online_pvids);
 }
 
 /*
@@ -465,18 +488,23 @@ static int _count_pvid_files_from_lookup_file(struct cmd_context *cmd, struct de
 static void _count_pvid_files(struct volume_group *vg, int *pvs_online, int *pvs_offline)
 {
 	char pvid[ID_LEN + 1] __attribute__((aligned(8))) = { 0 };
+	struct dm_hash_table *online_pvids = NULL;
 	struct pv_list *pvl;
+	int checked = 0;
 
 	*pvs_online = 0;
 	*pvs_offline = 0;
 
 	dm_list_iterate_items(pvl, &vg->pvs) {
 		memcpy(pvid, &pvl->pv->id.uuid, ID_LEN);
-		if (online_pvid_file_exists(pvid))
+		if (_pvid_online(pvid, &checked, &online_pvids))
 			(*pvs_online)++;
 		else
 			(*pvs_offline)++;
 	}
+
+	if (online_pvids)
+		dm_hash_destroy(online_pvids);
 }
 
 static int _pvscan_aa_single(struct cmd_context *cmd, const char *vg_name,
@@ -172,6 +172,18 @@ static int _do_lvs_with_info_and_status_single(struct cmd_context *cmd,
 	if (lv_is_merging_origin(lv))
 		/* Status is need to know which LV should be shown */
 		do_status = 1;
+	else if ((do_info || do_status) && !sh && handle->preselect_handle) {
+		/*
+		 * The selection doesn't use info or status, so LVs it
+		 * discards are dropped before the device-mapper queries.
+		 */
+		status.lv = lv;
+		if (!report_object(handle->preselect_handle, 1,
+				   lv->vg, lv, NULL, NULL, NULL, &status, NULL))
+			goto_out;
+		if (!handle->preselect_handle->selected)
+			return ECMD_PROCESSED;
+	}
 
 	if (!_do_info_and_status(cmd, first_seg(lv), &status, do_info, do_status))
 		goto_out;
@@ -493,6 +505,17 @@ static int _pvsegs_in_vg(struct cmd_context *cmd, const char *vg_name,
 	return process_each_pv_in_vg(cmd, vg, handle, &_pvsegs_single);
 }
 
+/* Fields and keys from the VG summary need no vg_read. */
+static uint32_t _vgs_read_flags(struct single_report_args *single_args)
+{
+	if ((!single_args->selection || !*single_args->selection) &&
+	    report_fields_from_vg_summary(single_args->options) &&
+	    report_fields_from_vg_summary(single_args->keys))
+		return PROCESS_VG_SUMMARY;
+
+	return 0;
+}
+
 static int _get_final_report_type(struct report_args *args,
 				  struct single_report_args *single_args,
 				  unsigned report_type,
@@ -1082,6 +1105,45 @@ static int _set_report_prefix_and_name(struct report_args *args,
 	return 1;
 }
 
+/*
+ * If the LV selection does not use any field that needs LV info or
+ * status, set up a selection-only report so that LVs can be checked
+ * against it before the info and status are read from device-mapper.
+ * The "selected" field reports unselected rows too, so it stops this.
+ */
+static int _init_lv_preselect_handle(struct cmd_context *cmd,
+				     struct processing_handle *handle,
+				     struct single_report_args *single_args)
+{
+	struct selection_handle *sh;
+	unsigned report_type = LVS;
+
+	if (!single_args->selection || !*single_args->selection ||
+	    strstr(single_args->options, "selected"))
+		return 1;
+
+	if (!(sh = dm_pool_zalloc(cmd->mem, sizeof(*sh)))) {
+		log_error("Failed to allocate LV preselection handle.");
+		return 0;
+	}
+
+	if (!(sh->selection_rh = report_init_for_selection(cmd, &report_type, single_args->selection))) {
+		dm_pool_free(cmd->mem, sh);
+		return_0;
+	}
+
+	if (report_type & (LVSINFO | LVSSTATUS | LVSINFOSTATUS)) {
+		dm_report_free(sh->selection_rh);
+		dm_pool_free(cmd->mem, sh);
+		return 1;
+	}
+
+	sh->report_type = report_type;
+	handle->preselect_handle = sh;
+
+	return 1;
+}
+
 static int _do_report(struct cmd_context *cmd, struct processing_handle *handle,
 		      struct report_args *args, struct single_report_args *single_args)
 {
@@ -1100,11 +1162,17 @@ static int _do_report(struct cmd_context *cmd, struct processing_handle *handle,
 		goto_out;
 
 	handle->custom_handle = report_handle;
+	if (!args->full_report_vg)
+		handle->select_vgs_rh = report_handle;
 
 	if (!_get_final_report_type(args, single_args, report_type, &lv_info_needed,
 				    &lv_segment_status_needed, &report_type))
 		goto_out;
 
+	if ((report_type == LVS) && (lv_info_needed || lv_segment_status_needed) &&
+	    !_init_lv_preselect_handle(cmd, handle, single_args))
+		goto_out;
+
 	if (!(args->log_only && (single_args->report_type != CMDLOG))) {
 		if (!dm_report_group_push(cmd->cmd_report.report_group, report_handle, (void *) single_args->report_name))
 			goto_out;
@@ -1136,7 +1204,7 @@ static int _do_report(struct cmd_context *cmd, struct processing_handle *handle,
 				r = _report_all_in_vg(cmd, handle, args->full_report_vg, VGS, lv_info_needed, lv_segment_status_needed);
 			else
 				r = process_each_vg(cmd, args->argc, args->argv, NULL, NULL,
-						    0, 0, handle, &_vgs_single);
+						    _vgs_read_flags(single_args), 0, handle, &_vgs_single);
 			break;
 		case LABEL:
 			r = process_each_label(cmd, args->argc, args->argv,
@@ -1205,8 +1273,13 @@ static int _do_report(struct cmd_context *cmd, struct processing_handle *handle,
 			log_error("Failed to compact given columns in report output.");
 	}
 
-	if (!(args->log_only && (single_args->report_type != CMDLOG)))
-		dm_report_output(report_handle);
+	if (!(args->log_only && (single_args->report_type != CMDLOG))) {
+		if (cmd->cmd_report.row_fn && (single_args->report_type != CMDLOG))
+			dm_report_output_rows(report_handle, cmd->cmd_report.row_fn,
+					      cmd->cmd_report.row_fn_private);
+		else
+			dm_report_output(report_handle);
+	}
 
 out:
 	if (report_handle) {
@@ -1215,7 +1288,14 @@ out:
 		dm_report_free(report_handle);
 	}
 
+	if (handle->preselect_handle) {
+		dm_report_free(handle->preselect_handle->selection_rh);
+		dm_pool_free(cmd->mem, handle->preselect_handle);
+		handle->preselect_handle = NULL;
+	}
+
 	handle->custom_handle = orig_custom_handle;
+	handle->select_vgs_rh = NULL;
 	return r;
 }
 
@@ -1365,6 +1445,9 @@ static int _config_report(struct cmd_context *cmd, struct report_args *args, str
 		args->aligned = 1;
 	if (arg_is_set(cmd, unbuffered_ARG) && !arg_is_set(cmd, sort_ARG))
 		args->buffered = 0;
+	/* Rows passed to row_fn are taken from the buffer. */
+	if (cmd->cmd_report.row_fn)
+		args->buffered = 1;
 	if (arg_is_set(cmd, noheadings_ARG))
 		args->headings = REPORT_HEADINGS_NONE;
 	if ((str = arg_str_value(cmd, headings_ARG, NULL))) {
@@ -1385,6 +1468,261 @@ static int _config_report(struct cmd_context *cmd, struct report_args *args, str
 	return 1;
 }
 
+/*
+ * State of a VG seen by a --follow check.  dm_state sums a hash of
+ * the devno and event number of each active device of the VG, so it
+ * changes when LVs are activated, deactivated or get a DM event.
+ */
+struct follow_vg {
+	struct dm_list list;
+	const char *vgid;
+	const char *vg_name;
+	uint32_t seqno;
+	uint64_t dm_state;
+};
+
+static uint64_t _follow_dev_hash(const struct dm_active_device *dm_dev)
+{
+	uint64_t h = ((uint64_t) dm_dev->devno << 32) | dm_dev->event_nr;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+/*
+ * Rescan the headers and list the active DM devices, with the
+ * global lock held only for the scan, as polldaemon does between
+ * its checks.
+ */
+static int _follow_check(struct cmd_context *cmd, struct dm_pool *mem,
+			 int use_dm, struct dm_list *vgs)
+{
+	struct dm_list vgnameids;
+	struct vgnameid_list *vgnl;
+	struct dm_list *devs = NULL;
+	struct dm_active_device *dm_dev;
+	struct follow_vg *fvg;
+	unsigned devs_features = 0;
+	const size_t prefix_len = sizeof(UUID_PREFIX) - 1;
+	void *mark;
+	int r = 0;
+
+	dm_list_init(&vgnameids);
+	dm_list_init(vgs);
+
+	lvmcache_destroy(cmd, 1, 0);
+	label_scan_destroy(cmd);
+
+	if (!lock_global(cmd, "sh"))
+		return_0;
+
+	if (!lvmcache_label_scan(cmd))
+		goto_out;
+
+	/* Names are copied to mem, the list itself is dropped again. */
+	if (!(mark = dm_pool_alloc(cmd->mem, 1)))
+		goto_out;
+
+	if (!lvmcache_get_vgnameids(cmd, &vgnameids, NULL, 0)) {
+		dm_pool_free(cmd->mem, mark);
+		goto_out;
+	}
+
+	dm_list_iterate_items(vgnl, &vgnameids) {
+		if (!(fvg = dm_pool_zalloc(mem, sizeof(*fvg))) ||
+		    !(fvg->vgid = dm_pool_strdup(mem, vgnl->vgid)) ||
+		    !(fvg->vg_name = dm_pool_strdup(mem, vgnl->vg_name))) {
+			log_error("Failed to allocate follow state.");
+			dm_pool_free(cmd->mem, mark);
+			goto out;
+		}
+		fvg->seqno = lvmcache_seqno_from_vgid(vgnl->vgid);
+		dm_list_add(vgs, &fvg->list);
+	}
+
+	dm_pool_free(cmd->mem, mark);
+
+	if (use_dm && get_dm_active_devices(NULL, &devs, &devs_features)) {
+		if (devs_features & DM_DEVICE_LIST_HAS_UUID) {
+			dm_list_iterate_items(dm_dev, devs) {
+				if (!dm_dev->uuid || strncmp(dm_dev->uuid, UUID_PREFIX, prefix_len))
+					continue;
+				dm_list_iterate_items(fvg, vgs)
+					if (!strncmp(dm_dev->uuid + prefix_len, fvg->vgid, ID_LEN)) {
+						fvg->dm_state += _follow_dev_hash(dm_dev);
+						break;
+					}
+			}
+		}
+		dm_device_list_destroy(&devs);
+	}
+
+	r = 1;
+out:
+	if (!lock_global(cmd, "un"))
+		stack;
+
+	return r;
+}
+
+static struct follow_vg *_follow_find_vg(struct dm_list *vgs, const char *vgid)
+{
+	struct follow_vg *fvg;
+
+	dm_list_iterate_items(fvg, vgs)
+		if (!strcmp(fvg->vgid, vgid))
+			return fvg;
+
+	return NULL;
+}
+
+/*
+ * Build the selection reporting only the changed VGs, within the
+ * selection given on the command line.  Returns NULL with no change.
+ */
+static const char *_follow_selection(struct dm_pool *mem, struct dm_list *old_vgs,
+				     struct dm_list *new_vgs, const char *selection)
+{
+	char uuid[64];
+	struct follow_vg *fvg, *old;
+	struct id id;
+	int changed = 0;
+
+	dm_list_iterate_items(old, old_vgs)
+		if (!_follow_find_vg(new_vgs, old->vgid))
+			log_print_unless_silent("Volume group %s was removed.", old->vg_name);
+
+	if (!dm_pool_begin_object(mem, 256))
+		return_NULL;
+
+	if (selection && *selection &&
+	    (!dm_pool_grow_object(mem, "(", 1) ||
+	     !dm_pool_grow_object(mem, selection, 0) ||
+	     !dm_pool_grow_object(mem, ") && (", 0)))
+		goto_bad;
+
+	dm_list_iterate_items(fvg, new_vgs) {
+		if ((old = _follow_find_vg(old_vgs, fvg->vgid)) &&
+		    (old->seqno == fvg->seqno) && (old->dm_state == fvg->dm_state))
+			continue;
+
+		log_debug("Follow VG %s seqno %u changed.", fvg->vg_name, fvg->seqno);
+
+		memcpy(&id, fvg->vgid, ID_LEN);
+		if (!id_write_format(&id, uuid, sizeof(uuid)))
+			goto_bad;
+
+		if ((changed++ && !dm_pool_grow_object(mem, " || ", 0)) ||
+		    !dm_pool_grow_object(mem, "vg_uuid=\"", 0) ||
+		    !dm_pool_grow_object(mem, uuid, 0) ||
+		    !dm_pool_grow_object(mem, "\"", 1))
+			goto_bad;
+	}
+
+	if ((selection && *selection && !dm_pool_grow_object(mem, ")", 1)) ||
+	    !dm_pool_grow_object(mem, "\0", 1))
+		goto_bad;
+
+	if (!changed) {
+		dm_pool_abandon_object(mem);
+		return NULL;
+	}
+
+	return dm_pool_end_object(mem);
+bad:
+	dm_pool_abandon_object(mem);
+	return NULL;
+}
+
+/*
+ * Keep checking for changed VGs after the initial report and report
+ * the rows of those again.  Polling the headers of the label scan and
+ * one DM device list per check is all that is done while nothing
+ * changes.
+ */
+static int _follow_report(struct cmd_context *cmd, struct processing_handle *handle,
+			  struct report_args *args, struct single_report_args *single_args)
+{
+	const char *orig_selection = single_args->selection;
+	const char *selection;
+	struct dm_pool *mem[2] = { NULL };
+	struct dm_list vgs[2];
+	unsigned interval = arg_uint_value(cmd, interval_ARG, DEFAULT_FOLLOW_INTERVAL);
+	char vsn[80];
+	int use_dm = driver_version(vsn, sizeof(vsn));
+	int cur = 0, i, ret;
+	unsigned s;
+	int r = ECMD_PROCESSED;
+
+	if (args->log_only) {
+		log_error("Option --follow cannot be used with --logonly.");
+		return EINVALID_CMD_LINE;
+	}
+
+	if (!interval) {
+		log_error("Interval for --follow must be at least one second.");
+		return EINVALID_CMD_LINE;
+	}
+
+	if (!(mem[0] = dm_pool_create("follow", 1024)) ||
+	    !(mem[1] = dm_pool_create("follow", 1024))) {
+		log_error("Failed to create follow memory pools.");
+		r = ECMD_FAILED;
+		goto out;
+	}
+
+	/* Taken before the initial report, so no change is missed. */
+	if (!_follow_check(cmd, mem[cur], use_dm, &vgs[cur])) {
+		r = ECMD_FAILED;
+		goto out;
+	}
+
+	for (i = 0; ; i++) {
+		if (i) {
+			cur ^= 1;
+			dm_pool_empty(mem[cur]);
+			if (!_follow_check(cmd, mem[cur], use_dm, &vgs[cur])) {
+				r = ECMD_FAILED;
+				break;
+			}
+
+			selection = _follow_selection(mem[cur], &vgs[cur ^ 1], &vgs[cur],
+						      orig_selection);
+		} else
+			selection = orig_selection;
+
+		if (!i || selection) {
+			single_args->selection = selection;
+			ret = _do_report(cmd, handle, args, single_args);
+			single_args->selection = orig_selection;
+			if (ret > r)
+				r = ret;
+			if (!lock_global(cmd, "un"))
+				stack;
+			fflush(stdout);
+		}
+
+		for (s = 0; s < interval; s++)
+			if (interruptible_usleep(1000000))
+				break;
+
+		if (sigint_caught()) {
+			sigint_clear();
+			break;
+		}
+	}
+out:
+	if (mem[0])
+		dm_pool_destroy(mem[0]);
+	if (mem[1])
+		dm_pool_destroy(mem[1]);
+
+	return r;
+}
+
 static int _report(struct cmd_context *cmd, int argc, char **argv, unsigned report_type)
 {
 	struct report_args args = {0};
@@ -1428,7 +1766,9 @@ static int _report(struct cmd_context *cmd, int argc, char **argv, unsigned repo
 	if (single_args->report_type == FULL) {
 		handle->custom_handle = &args;
 		r = process_each_vg(cmd, argc, argv, NULL, NULL, 0, 1, handle, &_full_report_single);
-	} else
+	} else if (arg_is_set(cmd, follow_ARG))
+		r = _follow_report(cmd, handle, &args, single_args);
+	else
 		r = _do_report(cmd, handle, &args, single_args);
 
 	if (!args.log_only && !dm_report_group_pop(cmd->cmd_report.report_group)) {
@@ -67,6 +67,9 @@ int become_daemon(struct cmd_context *cmd, int skip_lvm)
 			return -1;
 		}
 
+	/* Buffered log lines must not be written out again by the child. */
+	(void) fflush(NULL);
+
 	if ((pid = fork()) == -1) {
 		log_error("fork failed: %s", strerror(errno));
 		return -1;
@@ -838,6 +841,7 @@ int lv_change_activate(struct cmd_context *cmd, struct logical_volume *lv,
 	}
 
 	set_lv_notify(lv->vg->cmd);
+	set_notify_vg(lv->vg);
 
 	return r;
 }
@@ -872,6 +876,189 @@ int lv_refresh(struct cmd_context *cmd, struct logical_volume *lv)
 	return 1;
 }
 
+/*
+ * Workers for operations on independent objects: refresh of LVs that
+ * change no metadata, or activation of whole VGs.  With --parallel N up
+ * to N objects are processed at once, each in a forked copy of the
+ * command.  LV workers inherit the VG lock held by the parent, which
+ * waits for all of them before the VG is released.  VG workers lock
+ * and read their VG on their own.
+ */
+#define WORKERS_MAX 64
+static pid_t _workers[WORKERS_MAX];
+static unsigned _workers_count;
+static struct sigaction _workers_sigchld;
+static int _workers_sigchld_saved;
+
+/*
+ * Keep LVs sharing devices with other LVs serial, so two workers
+ * never suspend the layers of one stack in an unexpected order.
+ */
+static int _lv_worker_allowed(const struct logical_volume *lv)
+{
+	if (vg_is_shared(lv->vg))
+		return 0;	/* lvmlockd connection is not shared */
+
+	if (lv_is_thin_type(lv) || lv_is_cache_type(lv) ||
+	    lv_is_vdo_type(lv) || lv_is_writecache(lv) ||
+	    lv_is_integrity(lv) || lv_is_origin(lv) || lv_is_cow(lv) ||
+	    lv_is_external_origin(lv) || lv_is_pvmove(lv) ||
+	    lv_is_locked(lv) || lv_is_converting(lv))
+		return 0;
+
+	if (!dm_list_empty(&lv->segs_using_this_lv))
+		return 0;
+
+	/* Inactive LV has nothing to refresh, not worth a fork */
+	return lv_is_active(lv);
+}
+
+/* Reap workers until no more than 'keep' are running. */
+static int _wait_workers(unsigned keep)
+{
+	int ret_max = ECMD_PROCESSED;
+	int status, ret;
+	unsigned i;
+	pid_t pid;
+
+	while (_workers_count > keep) {
+		if ((pid = waitpid(-1, &status, 0)) < 0) {
+			if (errno == EINTR)
+				continue;
+			log_sys_error("waitpid", "worker");
+			_workers_count = 0;
+			ret_max = ECMD_FAILED;
+			break;
+		}
+
+		for (i = 0; i < _workers_count; ++i)
+			if (_workers[i] == pid)
+				break;
+
+		if (i == _workers_count)
+			continue; /* i.e. background polling process */
+
+		_workers[i] = _workers[--_workers_count];
+
+		if (WIFEXITED(status))
+			ret = WEXITSTATUS(status);
+		else {
+			log_error("Worker %d terminated by signal %d.",
+				  (int) pid, WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+			ret = ECMD_FAILED;
+		}
+
+		if (ret > ret_max)
+			ret_max = ret;
+	}
+
+	if (!_workers_count && _workers_sigchld_saved) {
+		_workers_sigchld_saved = 0;
+		if (sigaction(SIGCHLD, &_workers_sigchld, NULL))
+			log_sys_debug("sigaction", "SIGCHLD");
+	}
+
+	return ret_max;
+}
+
+int wait_workers(struct cmd_context *cmd)
+{
+	return _wait_workers(0);
+}
+
+/*
+ * Fork a worker as soon as fewer than 'max' are running.
+ * Returns the pid in the parent, 0 in the worker and -1 when fork
+ * failed.  Results of workers reaped meanwhile are added to *ret_max.
+ */
+static pid_t _fork_worker(struct cmd_context *cmd, unsigned max, int *ret_max)
+{
+	static const struct sigaction _dfl = { .sa_handler = SIG_DFL };
+	pid_t pid;
+	int ret;
+
+	if (max > WORKERS_MAX)
+		max = WORKERS_MAX;
+
+	if ((ret = _wait_workers(max - 1)) > *ret_max)
+		*ret_max = ret;
+
+	/* Nothing waiting on a cookie may be inherited by the worker */
+	if (!sync_local_dev_names(cmd))
+		log_warn("WARNING: Failed to sync local dev names.");
+
+	/* Worker exit status must not get lost in the SIGCHLD handler */
+	if (!_workers_count && !_workers_sigchld_saved) {
+		if (sigaction(SIGCHLD, &_dfl, &_workers_sigchld))
+			log_sys_debug("sigaction", "SIGCHLD");
+		else
+			_workers_sigchld_saved = 1;
+	}
+
+	(void) fflush(NULL);
+
+	if ((pid = fork()) < 0) {
+		log_sys_error("fork", "worker");
+		return pid;
+	}
+
+	if (pid) {
+		_workers[_workers_count++] = pid;
+		return pid;
+	}
+
+	/* Siblings are not children of this worker */
+	_workers_count = 0;
+
+	/* Async io context stays with the parent, worker needs its own. */
+	label_scan_destroy(cmd);
+	if (!label_scan_setup_bcache())
+		_exit(ECMD_FAILED);
+
+	return 0;
+}
+
+static void __attribute__((noreturn)) _exit_worker(struct cmd_context *cmd, int ret)
+{
+	if (!sync_local_dev_names(cmd))
+		ret = ECMD_FAILED;
+
+	(void) fflush(NULL);
+	_exit(ret);
+}
+
+int process_lv_in_worker(struct cmd_context *cmd, struct logical_volume *lv,
+			 struct processing_handle *handle,
+			 process_single_lv_fn_t process_single_lv)
+{
+	unsigned max = arg_uint_value(cmd, parallel_ARG, 1);
+	int ret = ECMD_PROCESSED, r;
+	pid_t pid;
+
+	if ((max < 2) || !_lv_worker_allowed(lv))
+		return process_single_lv(cmd, lv, handle);
+
+	if (!(pid = _fork_worker(cmd, max, &ret)))
+		_exit_worker(cmd, process_single_lv(cmd, lv, handle));
+
+	if (pid > 0) {
+		log_debug_activation("Processing LV %s in worker %d.",
+				     display_lvname(lv), (int) pid);
+		return ret;
+	}
+
+	/* Fork failed, process the LV here */
+	r = process_single_lv(cmd, lv, handle);
+
+	return (r > ret) ? r : ret;
+}
+
+static int _refresh_lv_single(struct cmd_context *cmd, struct logical_volume *lv,
+			      struct processing_handle *handle __attribute__((unused)))
+{
+	return lv_refresh(cmd, lv) ? ECMD_PROCESSED : ECMD_FAILED;
+}
+
 int vg_refresh_visible(struct cmd_context *cmd, struct volume_group *vg)
 {
 	struct lv_list *lvl;
@@ -887,12 +1074,17 @@ int vg_refresh_visible(struct cmd_context *cmd, struct volume_group *vg)
 
 		if (lv_is_visible(lvl->lv) &&
 		    !(lv_is_cow(lvl->lv) && !lv_is_virtual_origin(origin_from_cow(lvl->lv))) &&
-		    !lv_refresh(cmd, lvl->lv)) {
+		    (process_lv_in_worker(cmd, lvl->lv, NULL, _refresh_lv_single) != ECMD_PROCESSED)) {
 			r = 0;
 			stack;
 		}
 	}
 
+	if (wait_workers(cmd) != ECMD_PROCESSED) {
+		r = 0;
+		stack;
+	}
+
 	sigint_restore();
 
 	return r;
@@ -2269,6 +2461,57 @@ static int _select_matches(struct processing_handle *handle)
 	return handle->selection_handle->selected;
 }
 
+/*
+ * Without any VG names or tags given, drop the VGs which cannot pass
+ * a selection requiring a certain VG name or uuid before reading them.
+ */
+static void _drop_unselectable_vgs(struct processing_handle *handle,
+				   struct dm_list *vgnameids)
+{
+	struct dm_report *rh = handle->select_vgs_rh;
+	struct vgnameid_list *vgnl, *safe;
+	const char *vg_name, *vg_uuid;
+	char uuid[64];
+
+	if (handle->selection_handle)
+		rh = handle->selection_handle->selection_rh;
+
+	if (!rh)
+		return;
+
+	vg_name = dm_report_selection_required_string(rh, "vg_name");
+	vg_uuid = dm_report_selection_required_string(rh, "vg_uuid");
+
+	if (!vg_name && !vg_uuid)
+		return;
+
+	dm_list_iterate_items_safe(vgnl, safe, vgnameids) {
+		if ((!vg_name || !strcmp(vgnl->vg_name, vg_name)) &&
+		    (!vg_uuid || !vgnl->vgid ||
+		     (id_write_format((const struct id *) vgnl->vgid, uuid, sizeof(uuid)) &&
+		      !strcmp(uuid, vg_uuid))))
+			continue;
+
+		log_debug("Skipping VG %s not passing selection.", vgnl->vg_name);
+		dm_list_del(&vgnl->list);
+	}
+}
+
+/*
+ * VGs are processed one at a time: lock, vg_read, process_single_vg,
+ * unlock.  This is also the case for read-only reporting commands, and
+ * running VGs on worker threads is not possible as things are.
+ * lvmcache, the label scan bcache, the log report state and the config
+ * path cache are process globals without locking, vg_read and the
+ * report callbacks allocate from the shared cmd->mem, and report rows
+ * are added to one dm_report in call order.  What vg_read does per VG
+ * after label_scan is small for these commands anyway: can_use_one_scan
+ * rereads only one mda_header to check the VG did not change since the
+ * scan, and the metadata is parsed from the scan's bcache blocks.  For
+ * lvs most of the time is in the per LV device-mapper status ioctls
+ * made by the report fields, which would then also need to be
+ * serialized.
+ */
 static int _process_vgnameid_list(struct cmd_context *cmd, uint32_t read_flags,
 				  struct dm_list *vgnameids_to_process,
 				  struct dm_list *arg_vgnames,
@@ -2291,8 +2534,11 @@ static int _process_vgnameid_list(struct cmd_context *cmd, uint32_t read_flags,
 	int skip;
 	int notfound;
 	int is_lockd;
+	int summary_vg;
 	int process_all = 0;
 	int do_report_ret_code = 1;
+	int in_worker = 0;
+	pid_t pid;
 
 	log_set_report_object_type(LOG_REPORT_OBJECT_TYPE_VG);
 
@@ -2310,6 +2556,7 @@ static int _process_vgnameid_list(struct cmd_context *cmd, uint32_t read_flags,
 		vg_uuid = vgnl->vgid;
 		skip = 0;
 		notfound = 0;
+		summary_vg = 0;
 		is_lockd = lvmcache_vg_is_lockd_type(cmd, vg_name, vg_uuid);
 
 		uuid[0] = '\0';
@@ -2327,12 +2574,33 @@ static int _process_vgnameid_list(struct cmd_context *cmd, uint32_t read_flags,
 			goto_out;
 		}
 
+		/* Nothing beyond the scan summary is needed from this VG. */
+		if ((read_flags & PROCESS_VG_SUMMARY) && !is_lockd && dm_list_empty(arg_tags) &&
+		    (vg = lvmcache_vg_from_summary(cmd, vg_name, vg_uuid))) {
+			summary_vg = 1;
+			goto process_vg;
+		}
+
+		/* VGs share nothing, a worker locks and reads its own one. */
+		if ((cmd->vg_workers > 1) && !is_lockd && !is_orphan_vg(vg_name) &&
+		    ((pid = _fork_worker(cmd, cmd->vg_workers, &ret_max)) >= 0)) {
+			if (pid) {
+				log_very_verbose("Processing VG %s %s in worker %d.",
+						 vg_name, uuid, (int) pid);
+				log_set_report_object_name_and_id(NULL, NULL);
+				continue;
+			}
+			in_worker = 1;
+		}
+
 		log_very_verbose("Processing VG %s %s", vg_name, uuid);
 do_lockd:
 		if (is_lockd && !lockd_vg(cmd, vg_name, NULL, 0, &lockd_state)) {
 			stack;
 			ret_max = ECMD_FAILED;
 			report_log_ret_code(ret_max);
+			if (in_worker)
+				_exit_worker(cmd, ret_max);
 			continue;
 		}
 
@@ -2359,6 +2627,7 @@ do_lockd:
 			goto do_lockd;
 		}
 
+process_vg:
 		/* Process this VG? */
 		if ((process_all ||
 		    (!dm_list_empty(arg_vgnames) && str_list_match_item(arg_vgnames, vg_name)) ||
@@ -2376,18 +2645,24 @@ do_lockd:
 				ret_max = ret;
 		}
 
-		unlock_vg(cmd, vg, vg_name);
+		if (!summary_vg)
+			unlock_vg(cmd, vg, vg_name);
 endvg:
 		release_vg(vg);
 		if (is_lockd && !lockd_vg(cmd, vg_name, "un", 0, &lockd_state))
 			stack;
 
 		log_set_report_object_name_and_id(NULL, NULL);
+
+		if (in_worker)
+			_exit_worker(cmd, ret_max);
 	}
 	/* the VG is selected if at least one LV is selected */
 	_set_final_selection_result(handle, whole_selected);
 	do_report_ret_code = 0;
 out:
+	if ((ret = wait_workers(cmd)) > ret_max)
+		ret_max = ret;
 	if (do_report_ret_code)
 		report_log_ret_code(ret_max);
 	log_restore_report_state(saved_log_report_state);
@@ -2682,6 +2957,9 @@ int process_each_vg(struct cmd_context *cmd,
 		goto_out;
 	}
 
+	if (process_all_vgs_on_system && dm_list_empty(&arg_tags))
+		_drop_unselectable_vgs(handle, &vgnameids_to_process);
+
 	ret = _process_vgnameid_list(cmd, read_flags, &vgnameids_to_process,
 				     &arg_vgnames, &arg_tags, handle, process_single_vg);
 	if (ret > ret_max)
@@ -3669,8 +3947,14 @@ int process_each_lv_in_vg(struct cmd_context *cmd, struct volume_group *vg,
 		log_set_report_object_name_and_id(NULL, NULL);
 	}
 
-	if (vg->needs_write_and_commit && (ret_max == ECMD_PROCESSED) &&
-	    (!vg_write(vg) || !vg_commit(vg)))
+	/*
+	 * Commit postponed by the LVs processed above.  Changes which keep
+	 * each LV consistent on their own (lvchange) are committed even
+	 * when some of the LVs failed, as if each LV was committed alone.
+	 */
+	if (vg->needs_write_and_commit &&
+	    ((ret_max == ECMD_PROCESSED) || vg->write_and_commit_on_error) &&
+	    (!vg_write(vg) || !vg_commit(vg) || !update_thin_pools_with_messages(vg)))
 		ret_max = ECMD_FAILED;
 
 	if (lvargs_supplied) {
@@ -3689,6 +3973,9 @@ int process_each_lv_in_vg(struct cmd_context *cmd, struct volume_group *vg,
 	}
 	do_report_ret_code = 0;
 out:
+	/* LVs handed to workers are done before the VG is released */
+	if ((ret = wait_workers(cmd)) > ret_max)
+		ret_max = ret;
 	if (do_report_ret_code)
 		report_log_ret_code(ret_max);
 	log_set_report_object_name_and_id(NULL, NULL);
@@ -4244,6 +4531,9 @@ int process_each_lv(struct cmd_context *cmd,
 	else
 		_choose_vgs_to_process(cmd, &arg_vgnames, &vgnameids_on_system, &vgnameids_to_process);
 
+	if (process_all_vgs_on_system && dm_list_empty(&arg_tags))
+		_drop_unselectable_vgs(handle, &vgnameids_to_process);
+
 	ret = _process_lv_vgnameid_list(cmd, read_flags, &vgnameids_to_process, &arg_vgnames, &arg_lvnames,
 					&arg_tags, handle, check_single_lv, process_single_lv);
 
@@ -4605,6 +4895,12 @@ static int _process_pvs_in_vg(struct cmd_context *cmd,
 		log_set_report_object_name_and_id(NULL, NULL);
 	}
 
+	/* Commit postponed by the PVs processed above (pvresize). */
+	if (vg->needs_write_and_commit &&
+	    ((ret_max == ECMD_PROCESSED) || vg->write_and_commit_on_error) &&
+	    (!vg_write(vg) || !vg_commit(vg)))
+		ret_max = ECMD_FAILED;
+
 	do_report_ret_code = 0;
 out:
 	if (do_report_ret_code)
@@ -5083,6 +5379,7 @@ struct pvcreate_device {
 	unsigned is_orphan_pv : 1;  /* device is an orphan PV */
 	unsigned is_vg_pv : 1;      /* device is a PV used in a VG */
 	unsigned is_used_unknown_pv : 1; /* device is a PV used in an unknown VG */
+	unsigned is_created : 1;    /* new PV written in the batch */
 };
 
 /*
@@ -6033,7 +6330,11 @@ do_command:
 	 * Create PVs on devices.  Either create a new PV on top of an existing
 	 * one (e.g. for pvcreate), or create a new PV on a device that is not
 	 * a PV.
+	 *
+	 * The new PVs do not depend on each other, so the headers of all of
+	 * them are written at once when the batch ends.
 	 */
+	dev_write_batch_begin();
 	dm_list_iterate_items_safe(pd, pd2, &pp->arg_create) {
 		/* Using existing orphan PVs is covered above. */
 		if (pp->preserve_existing && pd->is_orphan_pv)
@@ -6089,13 +6390,21 @@ do_command:
 			continue;
 		}
 
-		log_print_unless_silent("Physical volume \"%s\" successfully created.",
-					pv_name);
-
+		pd->is_created = 1;
 		pvl->pv = pv;
 		dm_list_add(&pp->pvs, &pvl->list);
 	}
 
+	if (!dev_write_batch_end()) {
+		log_error("Failed to write physical volumes.");
+		goto bad;
+	}
+
+	dm_list_iterate_items(pd, &pp->arg_create)
+		if (pd->is_created)
+			log_print_unless_silent("Physical volume \"%s\" successfully created.",
+						pd->name);
+
 	/*
 	 * Remove PVs from devices for pvremove.
 	 */
@@ -74,6 +74,10 @@ struct processing_handle {
 	int include_historical_lvs;
 	struct selection_handle *selection_handle;
 	void *custom_handle;
+	/* Reporting: selection checked on LVs before LV info and status are read. */
+	struct selection_handle *preselect_handle;
+	/* Reporting: report whose selection VG names and uuids are checked against. */
+	struct dm_report *select_vgs_rh;
 };
 
 typedef int (*process_single_vg_fn_t) (struct cmd_context * cmd,
@@ -192,6 +196,11 @@ int lv_change_activate(struct cmd_context *cmd, struct logical_volume *lv,
 		       activation_change_t activate);
 int lv_refresh(struct cmd_context *cmd, struct logical_volume *lv);
 int vg_refresh_visible(struct cmd_context *cmd, struct volume_group *vg);
+
+int process_lv_in_worker(struct cmd_context *cmd, struct logical_volume *lv,
+			 struct processing_handle *handle,
+			 process_single_lv_fn_t process_single_lv);
+int wait_workers(struct cmd_context *cmd);
 void lv_spawn_background_polling(struct cmd_context *cmd,
 				 struct logical_volume *lv);
 
@@ -89,6 +89,17 @@ static int _activate_lvs_in_vg(struct cmd_context *cmd, struct volume_group *vg,
 	struct logical_volume *lv;
 	int count = 0, expected_count = 0, r = 1;
 
+	/*
+	 * Each LV is activated with its own dm tree.  The udev cookie is
+	 * already shared (fs_set_cookie) and waited for once by
+	 * sync_local_dev_names() below.
+	 * TODO: a single VG-wide tree would also avoid rebuilding shared
+	 * dependencies per LV, but per-LV locking, filters, monitoring and
+	 * the CLEAN pass in dev_manager_activate() all assume one LV per tree.
+	 * The same holds for -an: lv_deactivate() checks each LV is not in use
+	 * and unmonitors it before its tree is removed, and thin LVs must be
+	 * gone before their pool.
+	 */
 	sigint_allow();
 	dm_list_iterate_items(lvl, &vg->lvs) {
 		if (sigint_caught())
@@ -1120,6 +1131,14 @@ int vgchange(struct cmd_context *cmd, int argc, char **argv)
 		init_external_device_info_source(DEV_EXT_NONE);
 	}
 
+	/*
+	 * Activation of VGs in workers, --select is evaluated in this
+	 * process and stays serial.
+	 */
+	if ((cmd->command->command_enum == vgchange_activate_CMD) &&
+	    !arg_is_set(cmd, select_ARG))
+		cmd->vg_workers = arg_uint_value(cmd, parallel_ARG, 1);
+
 	if (update)
 		flags |= READ_FOR_UPDATE;
 	else if (arg_is_set(cmd, activate_ARG) ||
@@ -25,13 +25,15 @@ static int _lv_is_in_vg(struct volume_group *vg, struct logical_volume *lv)
 
 static struct dm_list *_lvh_in_vg(struct logical_volume *lv, struct volume_group *vg)
 {
-	struct dm_list *lvh;
+	struct lv_list *lvl;
 
-	dm_list_iterate(lvh, &vg->lvs)
-		if (lv == dm_list_item(lvh, struct lv_list)->lv)
-			return lvh;
+	/* lv->vg follows the moves, the LV name index avoids walking vg->lvs */
+	if (!_lv_is_in_vg(vg, lv) ||
+	    !(lvl = find_lv_in_vg(vg, lv->name)) ||
+	    (lvl->lv != lv))
+		return NULL;
 
-	return NULL;
+	return &lvl->list;
 }
 
 static int _lv_tree_move(struct dm_list *lvh,